@@ -0,0 +1,23 @@
+#!/bin/sh
+# Run every benchmark/*.myco with --vm-stats and collect the VM statistics
+# line of each run in benchmark/results/.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+MYCO=${MYCO:-"$ROOT/bin/myco"}
+RESULTS="$ROOT/benchmark/results"
+
+if [ ! -x "$MYCO" ]; then
+    echo "myco binary not found at $MYCO (run make first)" >&2
+    exit 1
+fi
+
+mkdir -p "$RESULTS"
+: > "$RESULTS/summary.txt"
+
+for bench in "$ROOT"/benchmark/*.myco; do
+    name=$(basename "$bench" .myco)
+    "$MYCO" "$bench" --vm-stats > "$RESULTS/$name.out" 2> "$RESULTS/$name.err"
+    stats=$(grep "^\[VM STATS\]" "$RESULTS/$name.err" || true)
+    printf "%-16s %s\n" "$name" "${stats#\[VM STATS\] }" | tee -a "$RESULTS/summary.txt"
+done
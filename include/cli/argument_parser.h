@@ -17,6 +17,8 @@ typedef struct {
     int ast_only; // When 1, disable bytecode VM and use pure AST interpreter
     int bytecode_enabled; // When 1, enable bytecode VM (optional with --bc/--bytecode flag)
     int run_tests; // When 1, run the built-in test suite
+    int debug_alloc; // When 1, track every allocation with canaries (--debug-alloc)
+    int vm_stats; // When 1, report VM dispatch statistics at exit (--vm-stats)
     char* input_source;
     char* output_file;
     char* architecture;
@@ -10,10 +10,10 @@ int process_file(const char* filename, int interpret, int compile, int build, in
 int process_string(const char* source, int interpret, int compile, int build, int debug, int target, const char* architecture, const char* output_file, int optimization_level, int jit_enabled, int jit_mode);
 
 // Process source code (common implementation)
-int process_source(const char* source, const char* filename, int interpret, int compile, int build, int debug, int target, const char* architecture, const char* output_file, int optimization_level);
+int process_source(const char* source, const char* filename, int interpret, int compile, int build, int debug, int target, const char* architecture, const char* output_file, int optimization_level, int jit_enabled, int jit_mode);
 
 // Interpret source code
-int interpret_source(const char* source, const char* filename, int debug);
+int interpret_source(const char* source, const char* filename, int debug, int jit_enabled, int jit_mode);
 
 // Compile source code
 int compile_source(const char* source, int target, int debug, const char* output_file);
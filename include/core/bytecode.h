@@ -166,7 +166,19 @@ typedef enum {
     BC_PROMISE_RESOLVE, // Resolve promise: promise.resolve(value)
     BC_PROMISE_REJECT,  // Reject promise: promise.reject(error)
     BC_PROMISE_THEN,    // Promise then: promise.then(onResolve, onReject)
-    BC_RUN_ASYNC       // Run async function body: creates promise and executes async
+    BC_RUN_ASYNC,      // Run async function body: creates promise and executes async
+    // Quickened variants (rewritten in place by the VM from type feedback;
+    // each guards its operand types and falls back to the generic opcode)
+    BC_ADD_NUMBERS,    // BC_ADD on two numbers
+    BC_ADD_STRINGS,    // BC_ADD on two strings (concatenation)
+    BC_SUB_NUMBERS,    // BC_SUB on two numbers
+    BC_MUL_NUMBERS,    // BC_MUL on two numbers
+    BC_LT_NUMBERS,     // BC_LT on two numbers
+    BC_LE_NUMBERS,     // BC_LE on two numbers
+    BC_GT_NUMBERS,     // BC_GT on two numbers
+    BC_GE_NUMBERS,     // BC_GE on two numbers
+    BC_ARRAY_GET_DENSE,// BC_ARRAY_GET on an array with a numeric index
+    BC_OP_COUNT        // Number of opcodes (sizes the VM dispatch table)
 } BytecodeOp;
 
 // Legacy superinstruction enum (kept for compatibility)
@@ -184,6 +196,21 @@ typedef enum {
     BC_POP_FRAME_LEGACY                            // Legacy: use BC_POP_FRAME instead
 } BytecodeSuperOp;
 
+// Generic opcode a quickened variant was rewritten from (other opcodes map to themselves)
+static inline BytecodeOp bytecode_generic_op(BytecodeOp op) {
+    switch (op) {
+        case BC_ADD_NUMBERS: case BC_ADD_STRINGS: return BC_ADD;
+        case BC_SUB_NUMBERS: return BC_SUB;
+        case BC_MUL_NUMBERS: return BC_MUL;
+        case BC_LT_NUMBERS: return BC_LT;
+        case BC_LE_NUMBERS: return BC_LE;
+        case BC_GT_NUMBERS: return BC_GT;
+        case BC_GE_NUMBERS: return BC_GE;
+        case BC_ARRAY_GET_DENSE: return BC_ARRAY_GET;
+        default: return op;
+    }
+}
+
 typedef struct {
     BytecodeOp op;
     int a;   // Generic operand A (e.g., const/local index or jump target)
@@ -191,15 +218,23 @@ typedef struct {
     int c;   // Generic operand C (second index or jump target)
 } BytecodeInstruction;
 
+struct BytecodeProgram;
+struct BytecodeFunction;
+struct RegisterProgram;
+struct LoopTrace;
+struct TypeFeedbackSlot;
+
 typedef struct {
     size_t return_pc;           // Program counter to return to
-    size_t local_start;         // Start of local variables in locals array
+    size_t local_start;         // Frame base: first local slot on the value stack
     size_t local_count;         // Number of local variables
     size_t num_local_start;     // Start of numeric locals in num_locals array
     size_t num_local_count;     // Number of numeric locals
+    struct BytecodeFunction* function; // Function running in this frame
+    struct BytecodeProgram* owner;     // Program the function belongs to
 } BytecodeCallFrame;
 
-typedef struct {
+typedef struct BytecodeFunction {
     char* name;                 // Function name
     BytecodeInstruction* code;  // Function bytecode
     size_t code_count;          // Number of instructions
@@ -211,9 +246,47 @@ typedef struct {
     size_t local_count;         // Number of local variables for this function
     size_t num_local_start;     // Start of numeric locals for this function
     size_t num_local_count;     // Number of numeric locals for this function
+    char** local_names;         // Slot names (parameters first), compile-time only
+    size_t local_capacity;      // Capacity for local_names
+    bool uses_frame_slots;      // Parameters and lets live in frame slots, not an Environment
+    bool needs_environment;     // Body binds names at runtime, so calls create an Environment
+    struct BytecodeProgram* frame_program; // Execution view reused across calls (built by the VM)
+    uint32_t hotness;           // Calls and loop back-edges counted toward tier-up
+    bool tier_attempted;        // Lowering to the register tier has been tried
+    struct RegisterProgram* register_program; // Register-tier code (NULL = run on the stack VM)
+    struct TypeFeedbackSlot* type_feedback;   // Per-instruction type feedback (allocated by the VM)
 } BytecodeFunction;
 
+// Cached environment binding for a main-program local slot
+typedef struct {
+    Environment* env;           // Environment that owns the binding (NULL = unresolved)
+    Environment* scope;         // current_environment the binding was resolved from
+    size_t scope_count;         // scope->count at resolution time (a new define may shadow)
+    const char* bound_name;     // env->names[index] at resolution time (guards reuse)
+    size_t index;               // Index into env->values
+} BytecodeLocalBinding;
+
+// Inline cache for an object property or method-call site. Each entry maps
+// a shape seen at the site to the slot holding the property; method-call
+// entries also keep the method resolved for that shape's class.
+#define BC_INLINE_CACHE_WAYS 4
+typedef struct {
+    const struct ObjectShape* shapes[BC_INLINE_CACHE_WAYS];
+    uint32_t slots[BC_INLINE_CACHE_WAYS];       // Property slot (method sites: slot of __class_name__)
+    const void* classes[BC_INLINE_CACHE_WAYS];  // Method sites: class body the method was found in
+    Value methods[BC_INLINE_CACHE_WAYS];        // Method sites: resolved method
+    uint32_t count;             // Entries in use
+    uint32_t next;              // Entry replaced next once all are in use
+} BytecodeInlineCache;
+
+// Trace state for a main-program loop header
 typedef struct {
+    uint32_t hotness;           // Times the header was reached toward recording
+    bool blacklisted;           // Recording failed or the trace kept exiting early
+    struct LoopTrace* trace;    // Compiled trace (NULL = not recorded yet)
+} BytecodeLoopSite;
+
+typedef struct BytecodeProgram {
     // Program buffer
     BytecodeInstruction* code;
     size_t count;
@@ -239,6 +312,22 @@ typedef struct {
     size_t local_slot_count;
     size_t local_slot_capacity;
     
+    // Resolved environment bindings for locals (lazily filled by the VM)
+    BytecodeLocalBinding* local_bindings;
+    size_t local_binding_capacity;
+    
+    // Inline caches indexed by pc (entries allocated on first use by the VM)
+    BytecodeInlineCache** inline_caches;
+    size_t inline_cache_capacity;
+    
+    // Loop trace sites indexed by pc (allocated by the VM the first time a loop header runs)
+    BytecodeLoopSite* loop_sites;
+    size_t loop_site_capacity;
+    
+    // Type feedback indexed by pc (allocated by the VM the first time a quickenable opcode runs)
+    struct TypeFeedbackSlot* type_feedback;
+    size_t type_feedback_capacity;
+    
     // Numeric constants and locals for fast arithmetic
     double* num_constants;
     size_t num_const_count;
@@ -277,6 +366,12 @@ int bytecode_compile_program(BytecodeProgram* program, ASTNode* root, Interprete
 Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int debug);
 Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunction* func, Value* args, int arg_count, BytecodeProgram* program);
 
+// Dispatch statistics
+unsigned long long bytecode_vm_instruction_count(void);  // Instructions retired since startup
+const char* bytecode_vm_dispatch_mode(void);             // "computed-goto" or "switch"
+void bytecode_vm_quickening_counts(unsigned long long* quickened,  // Executions of quickened opcodes
+                                   unsigned long long* generic);   // Executions of quickenable generic opcodes
+
 #endif // BYTECODE_H
 
 
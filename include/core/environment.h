@@ -12,4 +12,9 @@ Value environment_get(Environment* env, const char* name);
 void environment_assign(Environment* env, const char* name, Value value);
 int environment_exists(Environment* env, const char* name);
 
+// Find the binding for name along the parent chain. Returns a pointer to the
+// stored value (NULL if unbound) and reports the owning environment and index,
+// which stay valid for as long as that environment lives.
+Value* environment_resolve(Environment* env, const char* name, Environment** owner, size_t* index);
+
 #endif // ENVIRONMENT_H
@@ -4,6 +4,7 @@
 #include "../ast.h"
 #include "../jit_compiler.h"
 #include "../../runtime/runtime.h"
+#include "../../runtime/scheduler.h"
 #include "../../utils/shared_utilities.h"
 #include <stddef.h>
 #include <stdint.h>
@@ -21,6 +22,8 @@ typedef struct Environment Environment;
 // The full definition is in value_operations.h which is included later
 struct Value;
 typedef struct Value Value;
+// Object layouts are defined in optimization/hidden_classes.h
+struct ObjectShape;
 // BytecodeProgram is defined in bytecode.h, which is included via ast.h
 
 // Class metadata structure (compiled from AST at definition time)
@@ -50,6 +53,14 @@ typedef struct {
 #define VALUE_FLAG_IMMUTABLE  0x02    // Value cannot be modified
 #define VALUE_FLAG_REFCOUNTED   0x04    // Value uses reference counting
 #define VALUE_FLAG_POOLED     0x08    // Value allocated from pool
+#define VALUE_FLAG_HASHED     0x10    // cache.cached_hash holds value_hash() of a string
+
+// Shared storage header for copy-on-write containers (arrays, objects, maps, sets).
+// Clones of a container share the same storage and bump ref_count; the first
+// mutation through a shared copy detaches it (see value_make_unique).
+typedef struct ValueShared {
+    uint32_t ref_count;
+} ValueShared;
 
 // Value types
 typedef enum {
@@ -85,23 +96,32 @@ typedef union {
         void** elements;
         size_t count;
         size_t capacity;
+        ValueShared* shared;  // Copy-on-write storage header (NULL = unshared)
     } array_value;
     struct {
-        char** keys;
-        void** values;
+        char** keys;          // Property names in slot order, owned by the shape
+        struct Value* values; // Dense property slots
         size_t count;
         size_t capacity;
+        ValueShared* shared;  // Copy-on-write storage header (NULL = unshared)
+        struct ObjectShape* shape;  // Layout shared by objects with the same keys
     } object_value;
     struct {
-        void** keys;
+        void** keys;          // Entries in insertion order
         void** values;
         size_t count;
         size_t capacity;
+        ValueShared* shared;  // Copy-on-write storage header (NULL = unshared)
+        uint32_t* index;      // Open-addressing slots holding entry position + 1 (0 = empty)
+        size_t index_capacity;  // Power of two, 0 when no index is built
     } hash_map_value;
     struct {
-        void** elements;
+        void** elements;      // Entries in insertion order
         size_t count;
         size_t capacity;
+        ValueShared* shared;  // Copy-on-write storage header (NULL = unshared)
+        uint32_t* index;      // Open-addressing slots holding entry position + 1 (0 = empty)
+        size_t index_capacity;  // Power of two, 0 when no index is built
     } set_value;
     struct {
         ASTNode* body;
@@ -157,6 +177,7 @@ typedef struct {
     void* cached_ptr;
     double cached_numeric;
     size_t cached_length;
+    size_t cached_hash;  // Valid when VALUE_FLAG_HASHED is set
 } ValueCache;
 
 // Value structure
@@ -234,6 +255,7 @@ typedef struct CallFrame {
 // ============================================================================
 
 typedef struct AsyncTask {
+    SchedulerTask sched;        // Scheduler link (first member: the scheduler hands this back)
     Value* promise_ptr;         // Pointer to promise associated with this task (so we can update it)
     Value promise_copy;          // Copy of promise for reference (used for cleanup)
     void* program;              // Bytecode program to execute (BytecodeProgram*)
@@ -324,25 +346,14 @@ typedef struct Interpreter {
     // Circular import detection - track import chain
     struct ImportChain* import_chain;
     
-    // Async/await support - event loop and task queue
-    struct AsyncTask** task_queue;  // Queue of pending async tasks
-    size_t task_queue_size;
-    size_t task_queue_capacity;
+    // Async/await support - event loop and task scheduler
+    struct Scheduler* scheduler;  // Queue of async tasks the event loop runs (created on first use)
     int async_enabled;  // Whether async execution is enabled
-    
-    // Concurrency support
-    pthread_t* worker_threads;  // Worker threads for concurrent task execution
-    size_t worker_thread_count;  // Number of worker threads
-    pthread_mutex_t task_queue_mutex;  // Mutex for task queue access
-    pthread_mutex_t promise_registry_mutex;  // Mutex for promise registry access
-    pthread_cond_t task_available;  // Condition variable for task availability
-    int shutdown_workers;  // Flag to signal worker threads to shutdown
+    pthread_mutex_t promise_registry_mutex;  // Guards promise state while it is settled
     
     // Promise registry - maps promise IDs to promise Values (so we can update them)
-    Value* promise_registry;  // Array of promise Values
-    size_t promise_registry_size;
-    size_t promise_registry_capacity;
-    uint64_t next_promise_id;  // Next promise ID to assign
+    struct PromiseRegistry* promise_registry;  // Sharded hash table, created on first use
+    uint64_t next_promise_id;  // Next promise ID to assign (atomic)
     
     // Capability-based security system
     CapabilityEntry* capability_registry;  // Registry of available capabilities
@@ -445,6 +456,11 @@ void interpreter_set_source(Interpreter* interpreter, const char* source, const
 // ============================================================================
 
 void async_event_loop_run(Interpreter* interpreter);
+void async_event_loop_wait(Interpreter* interpreter, int timeout_ms);
+int async_has_pending_work(Interpreter* interpreter);
+void async_runtime_free(Interpreter* interpreter);
+Value async_promise_create(Interpreter* interpreter, uint64_t* promise_id);
+void async_promise_settle(Interpreter* interpreter, uint64_t promise_id, Value* value, int rejected);
 
 // ============================================================================
 // VALUE UTILITY FUNCTIONS
@@ -51,6 +51,7 @@ int value_object_has(Value* obj, const char* key);
 void value_object_delete(Value* obj, const char* key);
 size_t value_object_size(Value* obj);
 char** value_object_keys(Value* obj, size_t* count);
+void value_object_set_slot(Value* obj, size_t slot, Value value);  // Overwrite an existing property by shape slot
 
 // Hash map operations
 Value value_create_hash_map(size_t initial_capacity);
@@ -60,6 +61,7 @@ int value_hash_map_has(Value* map, Value key);
 void value_hash_map_delete(Value* map, Value key);
 Value* value_hash_map_keys(Value* map, size_t* count);
 size_t value_hash_map_size(Value* map);
+void value_hash_index_rebuild(Value* collection);  // Rebuild the key index of a map or set
 
 // Set operations
 Value value_create_set(size_t initial_capacity);
@@ -169,7 +171,13 @@ const char* value_type_to_string(ValueType type);
 int value_matches_type(Value* value, const char* type_name, Interpreter* interpreter);
 int value_is_truthy(Value* value);
 int value_equals(Value* a, Value* b);
+size_t value_hash(Value* value);  // Consistent with value_equals; caches string hashes
 Value value_clone(Value* value);
 void value_free(Value* value);
 
+// Copy-on-write container storage
+ValueShared* value_shared_create(void);
+int value_is_shared(Value* value);
+void value_make_unique(Value* value);  // Detach shared storage before mutating in place
+
 #endif // VALUE_OPERATIONS_H
@@ -11,6 +11,13 @@
 
 #include "../interpreter/value_operations.h"
 #include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#define MYCO_THREAD_LOCAL __declspec(thread)
+#else
+#define MYCO_THREAD_LOCAL __thread
+#endif
 
 /**
  * @brief Arena allocator for fast allocation
@@ -44,6 +51,15 @@ typedef struct {
     size_t max_arena_size;        // Maximum arena size
 } ArenaManager;
 
+/**
+ * @brief Initialize an arena over caller-owned memory
+ * 
+ * @param arena Arena to initialize
+ * @param memory Backing memory (not freed by arena_allocator_free)
+ * @param size Size of the backing memory in bytes
+ */
+void arena_allocator_init(ArenaAllocator* arena, void* memory, size_t size);
+
 /**
  * @brief Create arena allocator
  * 
@@ -177,4 +193,143 @@ void arena_manager_get_stats(ArenaManager* manager,
                              size_t* total_memory,
                              size_t* peak_memory);
 
+// ============================================================================
+// SLAB ALLOCATOR
+// ============================================================================
+// Size-class allocator for the small, uniform blocks the runtime churns
+// through: Value cells of arrays, maps and sets, container backing arrays
+// and parser nodes. Each thread owns its own free lists and bump pages, so
+// the hot path takes no locks. Blocks released on a thread that does not
+// own them are abandoned rather than recycled.
+
+#define SLAB_CLASS_COUNT        6           // 16, 32, 64, 128, 256, 512
+#define SLAB_MIN_BLOCK_SIZE     16
+#define SLAB_MAX_BLOCK_SIZE     512
+#define SLAB_PAGE_SHIFT         16
+#define SLAB_PAGE_SIZE          ((size_t)1 << SLAB_PAGE_SHIFT)  // 64KB pages
+#define SLAB_PAGES_PER_CHUNK    16          // pages reserved per malloc
+
+/**
+ * @brief Free block in a slab class (stored in the block itself)
+ */
+typedef struct SlabFreeBlock {
+    struct SlabFreeBlock* next;
+} SlabFreeBlock;
+
+/**
+ * @brief One size class: a free list plus the page it is bumping through
+ */
+typedef struct {
+    size_t block_size;            // Size of every block in this class
+    SlabFreeBlock* free_list;     // Recycled blocks
+    ArenaAllocator page;          // Current page, bump-allocated
+    size_t allocation_count;      // Blocks handed out
+    size_t free_count;            // Blocks recycled
+    size_t live_blocks;           // Blocks currently in use
+    size_t page_count;            // Pages assigned to this class
+} SlabClass;
+
+/**
+ * @brief Per-thread slab allocator
+ */
+typedef struct SlabAllocator {
+    SlabClass classes[SLAB_CLASS_COUNT];
+    ArenaAllocator* chunk;        // Current chunk pages are carved from
+    size_t chunk_count;           // Chunks reserved from the system
+    size_t large_allocations;     // Requests above SLAB_MAX_BLOCK_SIZE
+    size_t foreign_frees;         // Releases of blocks this thread does not own
+    int initialized;
+} SlabAllocator;
+
+/**
+ * @brief Per-class slab statistics
+ */
+typedef struct {
+    size_t block_size;
+    size_t allocation_count;
+    size_t free_count;
+    size_t live_blocks;
+    size_t page_count;
+} SlabClassStats;
+
+/**
+ * @brief Slab statistics for the calling thread
+ */
+typedef struct {
+    SlabClassStats classes[SLAB_CLASS_COUNT];
+    size_t allocation_count;      // Blocks handed out across all classes
+    size_t free_count;            // Blocks recycled across all classes
+    size_t live_bytes;            // Bytes held by live blocks
+    size_t reserved_bytes;        // Bytes of pages assigned to classes
+    size_t large_allocations;     // Requests passed through to the system allocator
+    size_t foreign_frees;         // Releases that could not be recycled
+    double fragmentation;         // Share of reserved bytes not in live blocks (0-1)
+} SlabStats;
+
+/**
+ * @brief Allocate a block
+ * 
+ * @param size Requested size in bytes
+ * @return void* Block of at least size bytes, or NULL on failure
+ * @note Requests above SLAB_MAX_BLOCK_SIZE go to shared_malloc_safe
+ */
+void* slab_alloc(size_t size);
+
+/**
+ * @brief Release a block
+ * 
+ * Blocks owned by the calling thread are recycled; anything else is handed
+ * to shared_free_safe.
+ * 
+ * @param ptr Block to release (NULL is ignored)
+ */
+void slab_free(void* ptr);
+
+/**
+ * @brief Release a batch of blocks (e.g. the cells of a dying container)
+ * 
+ * @param ptrs Blocks to release (NULL entries are skipped)
+ * @param count Number of entries
+ */
+void slab_free_all(void** ptrs, size_t count);
+
+/**
+ * @brief Resize a block
+ * 
+ * Stays in place while the new size fits the block's class.
+ * 
+ * @param ptr Block to resize (NULL allocates)
+ * @param old_size Bytes of ptr that are in use
+ * @param new_size New size in bytes
+ * @return void* Resized block or NULL on failure (ptr is left intact)
+ */
+void* slab_realloc(void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Check whether a pointer is a slab block (of any thread)
+ * 
+ * @param ptr Pointer to check
+ * @return int 1 if the pointer lies in a slab page
+ */
+int slab_owns(const void* ptr);
+
+/**
+ * @brief Allocate an uninitialized Value cell
+ */
+static inline Value* slab_alloc_value(void) {
+    return (Value*)slab_alloc(sizeof(Value));
+}
+
+/**
+ * @brief Get slab statistics for the calling thread
+ * 
+ * @param stats Output statistics
+ */
+void slab_get_stats(SlabStats* stats);
+
+/**
+ * @brief Print slab statistics for the calling thread to stderr
+ */
+void slab_print_stats(void);
+
 #endif // MYCO_ARENA_ALLOCATOR_H
@@ -557,4 +557,67 @@ int hidden_classes_export_data(HiddenClassesContext* context, const char* filena
  */
 int hidden_classes_import_data(HiddenClassesContext* context, const char* filename);
 
+// ============================================================================
+// OBJECT SHAPES
+// ============================================================================
+
+/**
+ * @brief Object shape
+ * 
+ * Shapes describe the layout of VALUE_OBJECT storage: slot i of an object
+ * holds the property named names[i]. Objects that gain the same properties
+ * in the same order walk the same transitions and share one shape, so the
+ * key names live here once instead of in every object. Shapes are never
+ * freed and are immutable once published, so lookups need no locking.
+ */
+typedef struct ObjectShape {
+    struct ObjectShape* parent;         // Shape before the last property was added
+    char** names;                       // Property names in slot order (shared with ancestors)
+    uint32_t count;                     // Number of properties
+    uint32_t expected_count;            // Largest descendant seen (slot capacity hint)
+    uint32_t id;                        // Unique shape identifier
+    uint32_t* index;                    // Open-addressing slots holding slot + 1 (NULL for small shapes)
+    size_t index_capacity;              // Power of two, 0 when no index is built
+    struct ObjectShape** transitions;   // Child shapes, one per added property name
+    size_t transition_count;
+    size_t transition_capacity;
+} ObjectShape;
+
+/**
+ * @brief Get the empty root shape every object starts from
+ * @return Root shape
+ */
+ObjectShape* object_shape_root(void);
+
+/**
+ * @brief Get the shape reached by adding a property
+ * @param shape Current shape
+ * @param name Property name (must not already be in shape)
+ * @return Child shape, or NULL on allocation failure
+ * @note Reuses an existing transition when one exists
+ */
+ObjectShape* object_shape_add_property(ObjectShape* shape, const char* name);
+
+/**
+ * @brief Get the shape reached by removing a property
+ * @param shape Current shape
+ * @param slot Slot of the property to remove
+ * @return Shape with the remaining properties in order, or NULL on failure
+ */
+ObjectShape* object_shape_remove_property(ObjectShape* shape, size_t slot);
+
+/**
+ * @brief Find the slot of a property
+ * @param shape Shape to search
+ * @param name Property name
+ * @return Slot index, or -1 if the shape has no such property
+ */
+int object_shape_find(const ObjectShape* shape, const char* name);
+
+/**
+ * @brief Get the number of shapes created so far
+ * @return Shape count
+ */
+uint32_t object_shape_count(void);
+
 #endif // HIDDEN_CLASSES_H
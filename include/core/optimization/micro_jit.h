@@ -5,6 +5,7 @@
 #include "../ast.h"
 #include "bytecode_engine.h"
 #include "hot_spot_tracker.h"
+#include "micro_jit_baseline.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -154,7 +155,8 @@ JitCompiledFunction* micro_jit_find_function(MicroJitContext* context,
 void micro_jit_evict_cold_functions(MicroJitContext* context);
 void micro_jit_clear_cache(MicroJitContext* context);
 
-// Memory management
+// Memory management (mappings start writable; micro_jit_make_executable
+// flips them to read + execute, so code is never writable and executable)
 uint8_t* micro_jit_allocate_executable_memory(size_t size);
 void micro_jit_free_executable_memory(uint8_t* memory, size_t size);
 
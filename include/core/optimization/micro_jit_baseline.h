@@ -0,0 +1,93 @@
+/**
+ * @file micro_jit_baseline.h
+ * @brief Baseline tier of the Micro-JIT: register-tier code to native code
+ *
+ * Kept apart from micro_jit.h so the bytecode VM can use it without pulling
+ * in the legacy bytecode engine definitions.
+ */
+
+#ifndef MICRO_JIT_BASELINE_H
+#define MICRO_JIT_BASELINE_H
+
+#include "register_vm.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// BASELINE TIER
+// ============================================================================
+
+/**
+ * @brief Entry point of baseline code for one register program
+ *
+ * Runs on the register file of a register-tier frame. Returns SIZE_MAX after
+ * the code returned (the result word is stored in *result), or the index of
+ * the register instruction whose type guard failed; nothing of that
+ * instruction has executed, so the register interpreter resumes there.
+ */
+typedef size_t (*MicroJitRegisterEntry)(NanBoxedValue* regs, NanBoxedValue* result, const uint8_t* start);
+
+/**
+ * @brief Native code for one register program
+ */
+typedef struct MicroJitNativeCode {
+    uint8_t* code;                  // Executable mapping (read + execute only)
+    MicroJitRegisterEntry entry;    // The mapping's prologue, as a function
+    size_t code_size;               // Bytes of generated code
+    uint32_t* offsets;              // Register instruction index -> code offset
+    size_t offset_count;            // Number of register instructions
+    uint32_t deoptimizations;       // Guard failures so far
+    int is_valid;                   // Cleared once the code deoptimizes too often
+} MicroJitNativeCode;
+
+/**
+ * @brief Baseline tier statistics
+ */
+typedef struct {
+    size_t functions_compiled;      // Register programs compiled to native code
+    size_t functions_rejected;      // Register programs outside the native subset
+    size_t functions_invalidated;   // Native code dropped after repeated deopts
+    uint64_t native_entries;        // Calls and loop entries run natively
+    uint64_t deoptimizations;       // Guard failures resumed in the interpreter
+    size_t code_bytes;              // Native code generated
+} MicroJitTierStats;
+
+/**
+ * @brief Compile register-tier code to native code
+ *
+ * Only the numeric subset is compiled: moves, arithmetic, comparisons,
+ * fused compare-and-branch, boolean logic, jumps and returns. Every operand
+ * is guarded to hold a number (or boolean); a failed guard deoptimizes back
+ * to the register interpreter at the same instruction.
+ *
+ * @param interpreter Interpreter whose Micro-JIT context (set up by --jit)
+ *        decides whether native code is generated
+ * @param program Register program; native code is attached to it on success
+ * @return int 1 if native code was attached, 0 otherwise
+ */
+int micro_jit_compile_register_program(Interpreter* interpreter, RegisterProgram* program);
+
+/**
+ * @brief Run a register program's native code on a register file
+ *
+ * @param program Register program with valid native code
+ * @param regs Register file, laid out as for register_tier_execute
+ * @param entry Register instruction index to start at
+ * @param result Receives the returned word
+ * @return size_t SIZE_MAX when the code returned, otherwise the instruction
+ *         index to resume interpreting at
+ */
+size_t micro_jit_execute_register_program(RegisterProgram* program, NanBoxedValue* regs, size_t entry,
+                                          NanBoxedValue* result);
+
+/**
+ * @brief Release a register program's native code, if any
+ */
+void micro_jit_free_register_program(RegisterProgram* program);
+
+/**
+ * @brief Get baseline tier statistics
+ */
+void micro_jit_get_tier_stats(MicroJitTierStats* stats);
+
+#endif // MICRO_JIT_BASELINE_H
@@ -1,9 +1,15 @@
 /**
  * @file nan_boxing.h
  * @brief NaN-boxing for efficient value representation
- * 
- * Uses NaN-boxing to store tagged values in 8 bytes, eliminating pointer
- * indirection and reducing memory overhead for zero-copy optimization.
+ *
+ * Stores VM values in 8-byte words. Numbers are kept as their IEEE 754
+ * bits; null and booleans live in the unused negative quiet-NaN space; every
+ * other value is moved into a heap cell whose pointer is carried in the NaN
+ * payload, tagged with its coarse type so type checks need no dereference.
+ *
+ * Encoding (top 16 bits):
+ *   below 0xFFF9  number (real NaNs are canonicalized to 0x7FF8000000000000)
+ *   0xFFF9-0xFFFF tagged value, tag = bits 48-50, payload = bits 0-47
  */
 
 #ifndef MYCO_NAN_BOXING_H
@@ -12,6 +18,7 @@
 #include "../interpreter/value_operations.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 /**
  * @brief NaN-boxed value (8 bytes)
@@ -22,18 +29,27 @@ typedef uint64_t NanBoxedValue;
  * @brief Value type tags for NaN-boxing
  */
 typedef enum {
-    NAN_BOX_TAG_NUMBER = 0x0000,      // IEEE 754 number
-    NAN_BOX_TAG_INTEGER = 0x1000,     // 32-bit integer
-    NAN_BOX_TAG_BOOLEAN = 0x2000,     // Boolean value
-    NAN_BOX_TAG_NULL = 0x3000,        // Null value
-    NAN_BOX_TAG_UNDEFINED = 0x4000,   // Undefined value
-    NAN_BOX_TAG_STRING = 0x5000,      // String pointer
-    NAN_BOX_TAG_ARRAY = 0x6000,       // Array pointer
-    NAN_BOX_TAG_OBJECT = 0x7000,      // Object pointer
-    NAN_BOX_TAG_FUNCTION = 0x8000,    // Function pointer
-    NAN_BOX_TAG_SPECIAL = 0x9000      // Special values
+    NAN_BOX_TAG_NULL = 1,             // Null value
+    NAN_BOX_TAG_BOOLEAN = 2,          // Boolean value (payload 0 or 1)
+    NAN_BOX_TAG_STRING = 3,           // Heap cell holding a string
+    NAN_BOX_TAG_ARRAY = 4,            // Heap cell holding an array
+    NAN_BOX_TAG_OBJECT = 5,           // Heap cell holding an object
+    NAN_BOX_TAG_FUNCTION = 6,         // Heap cell holding a function
+    NAN_BOX_TAG_HEAP = 7              // Heap cell holding any other value
 } NanBoxTag;
 
+#define NAN_BOX_TAGGED_MIN      0xFFF9000000000000ULL
+#define NAN_BOX_PREFIX          0xFFF8000000000000ULL
+#define NAN_BOX_TAG_SHIFT       48
+#define NAN_BOX_TAG_BITS        0x0007000000000000ULL
+#define NAN_BOX_PAYLOAD_MASK    0x0000FFFFFFFFFFFFULL
+#define NAN_BOX_CANONICAL_NAN   0x7FF8000000000000ULL
+
+#define NAN_BOX_TAG(tag)        (NAN_BOX_PREFIX | ((uint64_t)(tag) << NAN_BOX_TAG_SHIFT))
+#define NAN_BOX_NULL_VALUE      NAN_BOX_TAG(NAN_BOX_TAG_NULL)
+#define NAN_BOX_FALSE_VALUE     NAN_BOX_TAG(NAN_BOX_TAG_BOOLEAN)
+#define NAN_BOX_TRUE_VALUE      (NAN_BOX_TAG(NAN_BOX_TAG_BOOLEAN) | 1)
+
 /**
  * @brief NaN-boxing context
  */
@@ -45,236 +61,223 @@ typedef struct {
 
 /**
  * @brief Create NaN-boxing context
- * 
+ *
  * @return NanBoxingContext* New context or NULL on failure
  */
 NanBoxingContext* nan_boxing_create(void);
 
 /**
  * @brief Free NaN-boxing context
- * 
+ *
  * @param context Context to free
  */
 void nan_boxing_free(NanBoxingContext* context);
 
 /**
  * @brief Convert Value to NaN-boxed representation
- * 
+ *
  * @param context NaN-boxing context
- * @param value Value to convert
- * @return NanBoxedValue NaN-boxed value
+ * @param value Value to convert (cloned; the caller keeps ownership)
+ * @return NanBoxedValue NaN-boxed value, owned by the caller
  */
 NanBoxedValue nan_boxing_from_value(NanBoxingContext* context, const Value* value);
 
 /**
  * @brief Convert NaN-boxed value to Value
- * 
+ *
  * @param context NaN-boxing context
- * @param nan_boxed NaN-boxed value
- * @return Value* Converted value or NULL on failure
+ * @param nan_boxed NaN-boxed value (left untouched)
+ * @return Value* Newly allocated clone or NULL on failure
  */
 Value* nan_boxing_to_value(NanBoxingContext* context, NanBoxedValue nan_boxed);
 
 /**
- * @brief Get type of NaN-boxed value
- * 
- * @param nan_boxed NaN-boxed value
- * @return ValueType Type of the value
- */
-ValueType nan_boxing_get_type(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is a number
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if number, 0 otherwise
- */
-int nan_boxing_is_number(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is an integer
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if integer, 0 otherwise
- */
-int nan_boxing_is_integer(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is a boolean
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if boolean, 0 otherwise
- */
-int nan_boxing_is_boolean(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is null
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if null, 0 otherwise
- */
-int nan_boxing_is_null(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is a string
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if string, 0 otherwise
- */
-int nan_boxing_is_string(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is an array
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if array, 0 otherwise
- */
-int nan_boxing_is_array(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is an object
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if object, 0 otherwise
- */
-int nan_boxing_is_object(NanBoxedValue nan_boxed);
-
-/**
- * @brief Check if NaN-boxed value is a function
- * 
- * @param nan_boxed NaN-boxed value
- * @return int 1 if function, 0 otherwise
- */
-int nan_boxing_is_function(NanBoxedValue nan_boxed);
-
-/**
- * @brief Get number value from NaN-boxed value
- * 
- * @param nan_boxed NaN-boxed value
- * @return double Number value
- */
-double nan_boxing_get_number(NanBoxedValue nan_boxed);
-
-/**
- * @brief Get integer value from NaN-boxed value
- * 
- * @param nan_boxed NaN-boxed value
- * @return int32_t Integer value
+ * @brief Get NaN-boxing statistics
+ *
+ * @param context NaN-boxing context
+ * @param conversion_count Number of conversions performed
+ * @param memory_saved Memory saved by NaN-boxing
  */
-int32_t nan_boxing_get_integer(NanBoxedValue nan_boxed);
+void nan_boxing_get_stats(NanBoxingContext* context,
+                          size_t* conversion_count,
+                          size_t* memory_saved);
 
-/**
- * @brief Get boolean value from NaN-boxed value
- * 
- * @param nan_boxed NaN-boxed value
- * @return int Boolean value (0 or 1)
- */
-int nan_boxing_get_boolean(NanBoxedValue nan_boxed);
+// ============================================================================
+// HEAP CELLS
+// ============================================================================
 
 /**
- * @brief Get string pointer from NaN-boxed value
- * 
- * @param nan_boxed NaN-boxed value
- * @return char* String pointer
+ * @brief Move a non-immediate value into a heap cell
+ *
+ * @param value Value to box; ownership moves into the cell
+ * @return NanBoxedValue Tagged cell pointer (null on allocation failure)
+ * @note Cells come from a free list owned by the bytecode VM and are not
+ *       thread-safe
  */
-char* nan_boxing_get_string(NanBoxedValue nan_boxed);
+NanBoxedValue nan_boxing_box_cell(Value value);
 
 /**
- * @brief Get array pointer from NaN-boxed value
- * 
- * @param nan_boxed NaN-boxed value
- * @return Value** Array pointer
+ * @brief Move the value out of a heap cell and recycle the cell
+ *
+ * @param nan_boxed Tagged cell pointer
+ * @return Value The value the cell held, owned by the caller
  */
-Value** nan_boxing_get_array(NanBoxedValue nan_boxed);
+Value nan_boxing_unbox_cell(NanBoxedValue nan_boxed);
 
 /**
- * @brief Get object pointer from NaN-boxed value
- * 
+ * @brief Clone a boxed value (immediates are copied, cells are deep-cloned)
+ *
  * @param nan_boxed NaN-boxed value
- * @return void* Object pointer
+ * @return NanBoxedValue Independent copy
  */
-void* nan_boxing_get_object(NanBoxedValue nan_boxed);
+NanBoxedValue nan_boxing_clone(NanBoxedValue nan_boxed);
 
 /**
- * @brief Get function pointer from NaN-boxed value
- * 
+ * @brief Release a boxed value, freeing its cell if it has one
+ *
  * @param nan_boxed NaN-boxed value
- * @return void* Function pointer
- */
-void* nan_boxing_get_function(NanBoxedValue nan_boxed);
-
-/**
- * @brief Create NaN-boxed number
- * 
- * @param number Number value
- * @return NanBoxedValue NaN-boxed number
- */
-NanBoxedValue nan_boxing_create_number(double number);
-
-/**
- * @brief Create NaN-boxed integer
- * 
- * @param integer Integer value
- * @return NanBoxedValue NaN-boxed integer
- */
-NanBoxedValue nan_boxing_create_integer(int32_t integer);
-
-/**
- * @brief Create NaN-boxed boolean
- * 
- * @param boolean Boolean value
- * @return NanBoxedValue NaN-boxed boolean
- */
-NanBoxedValue nan_boxing_create_boolean(int boolean);
-
-/**
- * @brief Create NaN-boxed null
- * 
- * @return NanBoxedValue NaN-boxed null
  */
-NanBoxedValue nan_boxing_create_null(void);
-
-/**
- * @brief Create NaN-boxed string
- * 
- * @param string String pointer
- * @return NanBoxedValue NaN-boxed string
- */
-NanBoxedValue nan_boxing_create_string(char* string);
-
-/**
- * @brief Create NaN-boxed array
- * 
- * @param array Array pointer
- * @return NanBoxedValue NaN-boxed array
- */
-NanBoxedValue nan_boxing_create_array(Value** array);
-
-/**
- * @brief Create NaN-boxed object
- * 
- * @param object Object pointer
- * @return NanBoxedValue NaN-boxed object
- */
-NanBoxedValue nan_boxing_create_object(void* object);
-
-/**
- * @brief Create NaN-boxed function
- * 
- * @param function Function pointer
- * @return NanBoxedValue NaN-boxed function
- */
-NanBoxedValue nan_boxing_create_function(void* function);
-
-/**
- * @brief Get NaN-boxing statistics
- * 
- * @param context NaN-boxing context
- * @param conversion_count Number of conversions performed
- * @param memory_saved Memory saved by NaN-boxing
- */
-void nan_boxing_get_stats(NanBoxingContext* context,
-                          size_t* conversion_count,
-                          size_t* memory_saved);
+void nan_boxing_release(NanBoxedValue nan_boxed);
+
+// ============================================================================
+// INLINE ACCESSORS
+// ============================================================================
+
+static inline int nan_boxing_is_number(NanBoxedValue nan_boxed) {
+    return nan_boxed < NAN_BOX_TAGGED_MIN;
+}
+
+static inline NanBoxTag nan_boxing_get_tag(NanBoxedValue nan_boxed) {
+    return (NanBoxTag)((nan_boxed & NAN_BOX_TAG_BITS) >> NAN_BOX_TAG_SHIFT);
+}
+
+static inline int nan_boxing_is_null(NanBoxedValue nan_boxed) {
+    return nan_boxed == NAN_BOX_NULL_VALUE;
+}
+
+static inline int nan_boxing_is_boolean(NanBoxedValue nan_boxed) {
+    return (nan_boxed & ~1ULL) == NAN_BOX_FALSE_VALUE;
+}
+
+static inline int nan_boxing_is_cell(NanBoxedValue nan_boxed) {
+    return !nan_boxing_is_number(nan_boxed) && nan_boxing_get_tag(nan_boxed) >= NAN_BOX_TAG_STRING;
+}
+
+static inline int nan_boxing_is_string(NanBoxedValue nan_boxed) {
+    return !nan_boxing_is_number(nan_boxed) && nan_boxing_get_tag(nan_boxed) == NAN_BOX_TAG_STRING;
+}
+
+static inline int nan_boxing_is_array(NanBoxedValue nan_boxed) {
+    return !nan_boxing_is_number(nan_boxed) && nan_boxing_get_tag(nan_boxed) == NAN_BOX_TAG_ARRAY;
+}
+
+static inline int nan_boxing_is_object(NanBoxedValue nan_boxed) {
+    return !nan_boxing_is_number(nan_boxed) && nan_boxing_get_tag(nan_boxed) == NAN_BOX_TAG_OBJECT;
+}
+
+static inline int nan_boxing_is_function(NanBoxedValue nan_boxed) {
+    return !nan_boxing_is_number(nan_boxed) && nan_boxing_get_tag(nan_boxed) == NAN_BOX_TAG_FUNCTION;
+}
+
+static inline double nan_boxing_get_number(NanBoxedValue nan_boxed) {
+    double number;
+    memcpy(&number, &nan_boxed, sizeof(number));
+    return number;
+}
+
+static inline int nan_boxing_get_boolean(NanBoxedValue nan_boxed) {
+    return (int)(nan_boxed & 1);
+}
+
+static inline Value* nan_boxing_get_cell(NanBoxedValue nan_boxed) {
+    return (Value*)(uintptr_t)(nan_boxed & NAN_BOX_PAYLOAD_MASK);
+}
+
+static inline char* nan_boxing_get_string(NanBoxedValue nan_boxed) {
+    return nan_boxing_get_cell(nan_boxed)->data.string_value;
+}
+
+static inline NanBoxedValue nan_boxing_create_number(double number) {
+    NanBoxedValue bits;
+    if (number != number) return NAN_BOX_CANONICAL_NAN;
+    memcpy(&bits, &number, sizeof(bits));
+    return bits;
+}
+
+static inline NanBoxedValue nan_boxing_create_boolean(int boolean) {
+    return boolean ? NAN_BOX_TRUE_VALUE : NAN_BOX_FALSE_VALUE;
+}
+
+static inline NanBoxedValue nan_boxing_create_null(void) {
+    return NAN_BOX_NULL_VALUE;
+}
+
+static inline ValueType nan_boxing_get_type(NanBoxedValue nan_boxed) {
+    if (nan_boxing_is_number(nan_boxed)) return VALUE_NUMBER;
+    switch (nan_boxing_get_tag(nan_boxed)) {
+        case NAN_BOX_TAG_BOOLEAN: return VALUE_BOOLEAN;
+        case NAN_BOX_TAG_NULL: return VALUE_NULL;
+        default: return nan_boxing_get_cell(nan_boxed)->type;
+    }
+}
+
+/**
+ * @brief Box a value, taking ownership of it
+ *
+ * Numbers, booleans and null are encoded inline; anything else moves into
+ * a heap cell.
+ */
+static inline NanBoxedValue nan_boxing_box(Value value) {
+    switch (value.type) {
+        case VALUE_NUMBER: return nan_boxing_create_number(value.data.number_value);
+        case VALUE_BOOLEAN: return nan_boxing_create_boolean(value.data.boolean_value);
+        case VALUE_NULL: return NAN_BOX_NULL_VALUE;
+        default: return nan_boxing_box_cell(value);
+    }
+}
+
+/**
+ * @brief Unbox a value, taking ownership of the word
+ *
+ * Immediates are rebuilt exactly as value_create_number/boolean/null would;
+ * cells are moved out and recycled.
+ */
+static inline Value nan_boxing_unbox(NanBoxedValue nan_boxed) {
+    Value v = {0};
+    v.ref_count = 1;
+    if (nan_boxing_is_number(nan_boxed)) {
+        v.type = VALUE_NUMBER;
+        v.flags = VALUE_FLAG_IMMUTABLE | VALUE_FLAG_CACHED;
+        v.data.number_value = nan_boxing_get_number(nan_boxed);
+        v.cache.cached_numeric = v.data.number_value;
+        return v;
+    }
+    switch (nan_boxing_get_tag(nan_boxed)) {
+        case NAN_BOX_TAG_BOOLEAN:
+            v.type = VALUE_BOOLEAN;
+            v.flags = VALUE_FLAG_IMMUTABLE;
+            v.data.boolean_value = nan_boxing_get_boolean(nan_boxed);
+            v.cache.cached_numeric = v.data.boolean_value ? 1.0 : 0.0;
+            return v;
+        case NAN_BOX_TAG_NULL:
+            v.type = VALUE_NULL;
+            v.flags = VALUE_FLAG_IMMUTABLE;
+            return v;
+        default:
+            return nan_boxing_unbox_cell(nan_boxed);
+    }
+}
+
+/**
+ * @brief Borrow a boxed value as a Value without taking ownership
+ *
+ * The result shares any cell storage with the word and must not be freed.
+ */
+static inline Value nan_boxing_peek(NanBoxedValue nan_boxed) {
+    if (nan_boxing_is_cell(nan_boxed)) {
+        return *nan_boxing_get_cell(nan_boxed);
+    }
+    return nan_boxing_unbox(nan_boxed);
+}
 
 #endif // MYCO_NAN_BOXING_H
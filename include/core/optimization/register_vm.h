@@ -4,6 +4,11 @@
  * 
  * 256 virtual registers per frame, 128-instruction set.
  * Direct register operations, SSA-form IR, linear scan allocation.
+ *
+ * The register tier lowers hot frame-slot BytecodeFunctions from stack
+ * bytecode into this form (see register_tier_compile) and runs them on
+ * NaN-boxed registers with number-specialized arithmetic and fused
+ * compare-and-branch instructions.
  */
 
 #ifndef REGISTER_VM_H
@@ -11,6 +16,7 @@
 
 #include "../interpreter/interpreter_core.h"
 #include "../ast.h"
+#include "nan_boxing.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -163,13 +169,28 @@ typedef enum {
     REG_AVG_RRR = 124,         // Average of three values
     REG_MED_RRR = 125,         // Median of three values
     REG_HALT = 126,            // Halt execution
-    REG_NOP = 127              // No operation
+    REG_NOP = 127,             // No operation
+    
+    // Register tier (128-143): lowered stack bytecode
+    REG_NOT_R = 128,           // Logical not (any type)
+    REG_AND_RR = 129,          // Logical and (any type)
+    REG_OR_RR = 130,           // Logical or (any type)
+    REG_RELEASE_R = 131,       // Release a temporary register
+    REG_JUMP_IF_NOT_EQ = 132,  // Jump unless src1 == src2 (fused compare + branch)
+    REG_JUMP_IF_NOT_NE = 133,  // Jump unless src1 != src2
+    REG_JUMP_IF_NOT_LT = 134,  // Jump unless src1 < src2
+    REG_JUMP_IF_NOT_LE = 135,  // Jump unless src1 <= src2
+    REG_JUMP_IF_NOT_GT = 136,  // Jump unless src1 > src2
+    REG_JUMP_IF_NOT_GE = 137,  // Jump unless src1 >= src2
+    REG_GUARD_NUMBER = 138,    // Jump unless src1 holds a number (trace type guard)
+    REG_GUARD_BOOLEAN = 139,   // Jump unless src1 holds a boolean (trace type guard)
+    REG_OPCODE_COUNT
 } RegisterOpcode;
 
 /**
  * @brief Register-based instruction structure
  * 
- * @param opcode Instruction opcode (0-127)
+ * @param opcode Instruction opcode (0-127, register tier 128-143)
  * @param dst Destination register (8-bit)
  * @param src1 First source register (8-bit)
  * @param src2 Second source register (8-bit)
@@ -178,7 +199,7 @@ typedef enum {
  * @param offset 16-bit jump offset or array index
  */
 typedef struct {
-    uint8_t opcode;            // Instruction opcode (0-127)
+    uint8_t opcode;            // Instruction opcode
     uint8_t dst;               // Destination register
     uint8_t src1;              // First source register
     uint8_t src2;              // Second source register
@@ -192,7 +213,7 @@ typedef struct {
  * 
  * Contains instructions, constants, and metadata for register VM execution.
  */
-typedef struct {
+typedef struct RegisterProgram {
     RegisterInstruction* instructions;  // Array of instructions
     size_t instruction_count;           // Number of instructions
     size_t capacity;                    // Allocated capacity
@@ -222,6 +243,12 @@ typedef struct {
     int vectorized;                     // Has this program been vectorized?
     int traceable;                      // Is this program traceable?
     double hotness_score;               // Hotness score (0.0-1.0)
+    
+    // Register tier layout: locals, then constants, then operand temporaries
+    size_t temp_base;                   // First operand temporary register
+    size_t* entry_points;               // Stack pc -> instruction index (SIZE_MAX = not enterable)
+    size_t entry_point_count;           // Number of stack pcs mapped
+    struct MicroJitNativeCode* native_code; // Baseline JIT code (micro_jit), NULL when interpreted
 } RegisterProgram;
 
 /**
@@ -462,4 +489,128 @@ void register_program_print(RegisterProgram* program);
  */
 void register_instruction_print(RegisterInstruction instr);
 
+// ============================================================================
+// REGISTER TIER
+// ============================================================================
+
+struct BytecodeFunction;
+struct BytecodeProgram;
+struct LoopTrace;
+
+/**
+ * @brief Registers available to one register-tier frame
+ *
+ * Frames live on the C stack; functions needing more registers stay on the
+ * stack VM.
+ */
+#define REG_TIER_MAX_REGISTERS 128
+
+/**
+ * @brief Register tier statistics
+ */
+typedef struct {
+    size_t functions_compiled;          // Functions lowered to register code
+    size_t functions_rejected;          // Functions the lowering gave up on
+    size_t loop_entries;                // Entries into register code at a loop header
+    uint64_t instructions;              // Register instructions executed
+} RegisterTierStats;
+
+/**
+ * @brief Lower a frame-slot function's stack bytecode into register code
+ *
+ * Parameters and lets map to registers 0..local_count-1, constants to the
+ * registers after them, and each operand stack depth to a temporary.
+ * Functions using opcodes outside the lowered subset (globals, closures,
+ * objects, try blocks, ...) are rejected.
+ *
+ * @param func Function to lower (must use frame slots without an Environment)
+ * @param owner Program whose constant pool the function indexes
+ * @return RegisterProgram* Register code, or NULL if the function cannot be lowered
+ */
+RegisterProgram* register_tier_compile(const struct BytecodeFunction* func, const struct BytecodeProgram* owner);
+
+/**
+ * @brief Run register code for one call
+ *
+ * @param program Register code from register_tier_compile
+ * @param interpreter Interpreter (error state, calls)
+ * @param owner Program calls are resolved against when no program is cached
+ * @param slots Frame slot words; ownership moves into the registers
+ * @param slot_count Number of slot words
+ * @param entry Instruction index to start at (0, or a loop entry point)
+ * @return Value The function's result
+ */
+Value register_tier_execute(RegisterProgram* program, Interpreter* interpreter, struct BytecodeProgram* owner,
+                            NanBoxedValue* slots, size_t slot_count, size_t entry);
+
+/**
+ * @brief Set up a register frame: slot words move into the local registers,
+ * constants are materialized after them and the rest are nulled
+ */
+void register_tier_load_registers(const RegisterProgram* program, NanBoxedValue* regs,
+                                  NanBoxedValue* slots, size_t slot_count);
+
+/**
+ * @brief Run register code from an instruction index
+ *
+ * @return NanBoxedValue The word REG_RETURN left with, owned by the caller
+ */
+NanBoxedValue register_tier_run(RegisterProgram* program, Interpreter* interpreter, struct BytecodeProgram* owner,
+                                NanBoxedValue* regs, size_t entry);
+
+/**
+ * @brief Release the cells still held by a register frame
+ */
+void register_tier_release_registers(const RegisterProgram* program, NanBoxedValue* regs);
+
+/**
+ * @brief Lower an optimized loop trace into register code (trace_exec.c)
+ *
+ * Trace locals map to registers 0..n-1, then constants (including one per
+ * side-exit pc) and hoisted invariants, then temporaries. The preheader runs
+ * once, the iteration and its branches loop back to the iteration's start,
+ * and a guard jumps to its exit's branch or to a stub returning the bytecode
+ * pc the side exit resumes at.
+ *
+ * @param trace Recorded and optimized trace (see trace_recorder.h)
+ * @return RegisterProgram* Register code, or NULL if the trace needs too many registers
+ */
+RegisterProgram* register_tier_compile_trace(const struct LoopTrace* trace);
+
+/**
+ * @brief Run lowered trace code until it leaves through a side exit (trace_exec.c)
+ *
+ * @param program Register code from register_tier_compile_trace
+ * @param interpreter Interpreter (error state)
+ * @param owner Program the trace was recorded from
+ * @param slots Trace local words; ownership moves into the registers and
+ *        the final register values are moved back on exit
+ * @param slot_count Number of slot words (the trace's local count)
+ * @return Value The side exit's resume pc as a number
+ */
+Value register_tier_execute_trace(RegisterProgram* program, Interpreter* interpreter, struct BytecodeProgram* owner,
+                                  NanBoxedValue* slots, size_t slot_count);
+
+/**
+ * @brief Instruction index at which execution can continue from a stack pc
+ *
+ * @return size_t Entry index, or SIZE_MAX when pc is not a loop header with
+ *         an empty operand stack
+ */
+size_t register_tier_entry_point(const RegisterProgram* program, size_t pc);
+
+/**
+ * @brief Get register tier statistics
+ */
+void register_tier_get_stats(RegisterTierStats* stats);
+
+/**
+ * @brief Call a user function from register code (implemented by the bytecode VM)
+ *
+ * @param args Argument words; ownership moves to the callee
+ * @return NanBoxedValue The result, owned by the caller
+ */
+NanBoxedValue bytecode_call_user_function_words(Interpreter* interpreter, struct BytecodeProgram* owner,
+                                                int func_id, NanBoxedValue* args, int arg_count);
+
 #endif // REGISTER_VM_H
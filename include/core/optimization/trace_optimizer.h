@@ -502,4 +502,21 @@ int trace_optimizer_export_optimized_trace(TraceOptimizerContext* context, uint3
  */
 uint32_t trace_optimizer_import_optimized_trace(TraceOptimizerContext* context, const char* filename);
 
+// ============================================================================
+// BYTECODE LOOP TRACES
+// ============================================================================
+
+/**
+ * @brief Optimize a recorded loop trace in place
+ *
+ * Folds instructions whose operands are constants, removes type guards the
+ * trace's own types prove (including across the back edge), and hoists
+ * instructions and guards that only read loop invariants into a preheader
+ * that runs once per entry. Hoisted guards exit to the loop header.
+ *
+ * @param trace Trace from loop_trace_record
+ * @return 1 on success, 0 if the trace ran out of registers
+ */
+int loop_trace_optimize(LoopTrace* trace);
+
 #endif // TRACE_OPTIMIZER_H
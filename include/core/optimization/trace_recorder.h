@@ -500,4 +500,185 @@ int trace_recorder_export_trace(TraceRecorderContext* context, uint32_t trace_id
  */
 uint32_t trace_recorder_import_trace(TraceRecorderContext* context, const char* filename);
 
+// ============================================================================
+// BYTECODE LOOP TRACES
+// ============================================================================
+
+/**
+ * @brief Loop traces for the stack VM
+ *
+ * When a main-program loop header (BC_LOOP_START) gets hot, the VM records
+ * one iteration of the loop as straight-line register code, using the
+ * register tier's instruction set. Branches the iteration took become guards
+ * and type checks become REG_GUARD_* instructions; a failing guard leaves the
+ * trace through a side exit and the stack VM resumes at the exit's pc.
+ * A side exit that keeps being taken gets a branch: the rest of the
+ * iteration recorded from the exit's pc, which the exit then jumps into.
+ * Traces cover number and boolean locals and operations without side
+ * effects; loops doing anything else stay on the stack VM.
+ */
+
+struct BytecodeProgram;
+
+#define LOOP_TRACE_MAX_LENGTH 512      // Bytecode instructions followed while recording
+#define LOOP_TRACE_MAX_DEPTH 32        // Operand stack depth a trace may use
+#define LOOP_TRACE_MAX_BRANCHES 8      // Branches attached to one trace
+
+/**
+ * @brief What a trace register stands for
+ */
+typedef enum {
+    LOOP_TRACE_LOCAL = 0,              // Main-program local slot
+    LOOP_TRACE_CONSTANT = 1,           // Number or boolean constant
+    LOOP_TRACE_INVARIANT = 2,          // Loop-invariant value computed before the loop
+    LOOP_TRACE_TEMP = 3                // Operand stack temporary
+} LoopTraceRegisterKind;
+
+/**
+ * @brief Trace register
+ */
+typedef struct {
+    LoopTraceRegisterKind kind;        // What the register stands for
+    int slot;                          // Local slot (LOOP_TRACE_LOCAL)
+    NanBoxedValue value;               // Constant value; while recording, a local's current value
+    ValueType entry_type;              // Type a live-in local must have when the trace is entered
+    bool live_in;                      // Local read before the trace writes it
+    bool written;                      // Local written by the trace
+    bool numeric_sync;                 // Live-in local updated by BC_ADD_LOCAL_IMM (num_locals must agree)
+} LoopTraceRegister;
+
+/**
+ * @brief Side exit
+ */
+typedef struct {
+    size_t pc;                         // Bytecode pc the stack VM resumes at
+    size_t target;                     // First instruction of the exit's branch (SIZE_MAX = leave the trace)
+    uint32_t hits;                     // Times the exit was taken
+    bool branch_attempted;             // A branch was recorded or could not be
+} LoopTraceExit;
+
+/**
+ * @brief Recorded loop trace
+ *
+ * Guards carry a side-exit index in their immediate; REG_JUMP marks the back
+ * edge closing the iteration and every branch.
+ */
+typedef struct LoopTrace {
+    size_t header_pc;                  // Bytecode pc of the BC_LOOP_START header
+    RegisterInstruction* code;         // Preheader, one loop iteration, then branches
+    size_t count;                      // Number of instructions
+    size_t capacity;                   // Allocated instructions
+    size_t loop_start;                 // First instruction of the iteration (the back edge's target)
+    LoopTraceRegister* registers;      // Registers referenced by code
+    size_t register_count;             // Number of registers
+    size_t loop_end;                   // Pc of the last back edge to the header
+    LoopTraceExit* exits;              // Side exits
+    size_t exit_count;                 // Number of side exits
+    size_t branch_count;               // Branches attached
+    RegisterProgram* program;          // Lowered trace (register_tier_compile_trace)
+    uint32_t early_exits;              // Entries that left before completing an iteration
+} LoopTrace;
+
+/**
+ * @brief Loop trace statistics
+ */
+typedef struct {
+    size_t traces_recorded;            // Loops with a trace
+    size_t traces_aborted;             // Loops the recorder gave up on
+    size_t traces_invalidated;         // Traces dropped after repeated early exits
+    size_t constants_folded;           // Instructions folded to constants
+    size_t guards_eliminated;          // Guards proven redundant
+    size_t instructions_hoisted;       // Instructions moved into the preheader
+    size_t branches_recorded;          // Branches attached to hot side exits
+    uint64_t entries;                  // Times a trace was entered
+    uint64_t side_exits;               // Times a trace left through a side exit
+} LoopTraceStats;
+
+/**
+ * @brief Record one iteration of a hot loop
+ *
+ * Follows the bytecode from the header with the locals' current values,
+ * taking the branches those values take, until the back edge.
+ *
+ * @param program Program the loop belongs to (main-program locals only)
+ * @param header_pc Pc of the loop's BC_LOOP_START
+ * @param locals Value each local slot would load right now (numbers and
+ *        booleans; anything else is NAN_BOX_NULL_VALUE and stops recording)
+ * @return LoopTrace* Unoptimized trace, or NULL if the iteration cannot be traced
+ */
+LoopTrace* loop_trace_record(const struct BytecodeProgram* program, size_t header_pc, const NanBoxedValue* locals);
+
+/**
+ * @brief Record a branch for a hot side exit
+ *
+ * Follows the bytecode from the exit's pc to the back edge like
+ * loop_trace_record, appending the code to the trace and pointing the exit
+ * at it. The branch may not write locals the optimized iteration treats as
+ * invariant, and it re-checks the entry types of live-in locals it writes
+ * before looping back. The caller lowers the trace again afterwards.
+ *
+ * @param trace Optimized trace
+ * @param program Program the loop belongs to
+ * @param exit Side exit index
+ * @param locals Value each local slot would load right now (as for loop_trace_record)
+ * @return true if the branch was attached (the trace is unchanged otherwise)
+ */
+bool loop_trace_record_branch(LoopTrace* trace, const struct BytecodeProgram* program, size_t exit,
+                              const NanBoxedValue* locals);
+
+/**
+ * @brief Side exit resuming the stack VM at pc (exits to the same pc are shared)
+ * @return Exit index, or -1 on allocation failure
+ */
+int loop_trace_add_exit(LoopTrace* trace, size_t pc);
+
+/**
+ * @brief Add a register to a trace
+ * @return Register index, or -1 once REG_TIER_MAX_REGISTERS are in use
+ */
+int loop_trace_add_register(LoopTrace* trace, LoopTraceRegisterKind kind);
+
+/**
+ * @brief Register holding a number or boolean constant (shared per value)
+ * @return Register index, or -1 if no register is left
+ */
+int loop_trace_constant(LoopTrace* trace, NanBoxedValue value);
+
+/**
+ * @brief Append an instruction to a trace
+ * @return 1 on success, 0 on allocation failure
+ */
+int loop_trace_emit(LoopTrace* trace, RegisterInstruction instr);
+
+/**
+ * @brief Evaluate a binary register opcode on numbers or booleans
+ *
+ * @return false for operand types traces do not carry, and for a division
+ *         by zero (whose null result traces do not carry either)
+ */
+bool loop_trace_evaluate(uint8_t opcode, NanBoxedValue a, NanBoxedValue b, NanBoxedValue* result);
+
+/**
+ * @brief Whether a REG_GUARD_* instruction lets a register word through
+ *
+ * Inline because the register tier's dispatch loop checks every guard here.
+ */
+static inline bool loop_trace_guard_holds(uint8_t opcode, NanBoxedValue word) {
+    switch (opcode) {
+        case REG_GUARD_NUMBER: return nan_boxing_is_number(word);
+        case REG_GUARD_BOOLEAN: return nan_boxing_is_boolean(word);
+        default: return false;
+    }
+}
+
+/**
+ * @brief Free a loop trace and its lowered code
+ */
+void loop_trace_free(LoopTrace* trace);
+
+/**
+ * @brief Loop trace statistics (updated by the recorder, optimizer and VM)
+ */
+LoopTraceStats* loop_trace_stats(void);
+
 #endif // TRACE_RECORDER_H
@@ -515,4 +515,75 @@ int type_predictor_export_data(TypePredictorContext* context, const char* filena
  */
 int type_predictor_import_data(TypePredictorContext* context, const char* filename);
 
+// ============================================================================
+// BYTECODE TYPE FEEDBACK
+// ============================================================================
+
+#define TYPE_FEEDBACK_WARMUP 8        // Samples before a site may be quickened
+#define TYPE_FEEDBACK_MAX_DEOPTS 4    // Failed guards before a site stays generic
+
+/**
+ * @brief Operand kinds recorded by type feedback (bit flags)
+ */
+typedef enum {
+    TYPE_FEEDBACK_NUMBER = 1 << 0,      // Number
+    TYPE_FEEDBACK_STRING = 1 << 1,      // String
+    TYPE_FEEDBACK_ARRAY = 1 << 2,       // Array
+    TYPE_FEEDBACK_OTHER = 1 << 3        // Anything else
+} TypeFeedbackKind;
+
+/**
+ * @brief Type feedback for one bytecode instruction
+ *
+ * Generic opcodes record the kinds of their two operands here until the site
+ * settles on one pair, when the VM rewrites the instruction into a quickened
+ * variant. A quickened instruction whose guard fails is rewritten back and
+ * starts collecting again.
+ */
+typedef struct TypeFeedbackSlot {
+    uint8_t left;                       // Kinds seen for the left operand
+    uint8_t right;                      // Kinds seen for the right operand
+    uint8_t samples;                    // Samples since the last (de)quickening
+    uint8_t deopts;                     // Times the site was dequickened
+    uint8_t generic;                    // Site stays generic (polymorphic or unstable)
+} TypeFeedbackSlot;
+
+/**
+ * @brief Type feedback statistics
+ */
+typedef struct {
+    size_t sites_quickened;             // Rewrites into a quickened variant
+    size_t sites_generic;               // Sites that settled on the generic opcode
+    size_t deoptimizations;             // Quickened instructions rewritten back
+} TypeFeedbackStats;
+
+/**
+ * @brief Record one execution of a generic instruction
+ *
+ * @param slot Feedback slot of the instruction
+ * @param left Kind of the left operand
+ * @param right Kind of the right operand
+ * @return 1 once the site has warmed up with a single kind per operand (the
+ *         caller quickens it), 0 otherwise; a polymorphic site is marked generic
+ */
+int type_feedback_observe(TypeFeedbackSlot* slot, TypeFeedbackKind left, TypeFeedbackKind right);
+
+/**
+ * @brief Record that a quickened instruction failed its guard
+ *
+ * Clears the samples so the site can settle again, or marks it generic after
+ * TYPE_FEEDBACK_MAX_DEOPTS failures.
+ */
+void type_feedback_deoptimize(TypeFeedbackSlot* slot);
+
+/**
+ * @brief Mark a site generic because no quickened variant fits its kinds
+ */
+void type_feedback_give_up(TypeFeedbackSlot* slot);
+
+/**
+ * @brief Type feedback statistics (updated by the functions above and the VM)
+ */
+TypeFeedbackStats* type_feedback_stats(void);
+
 #endif // TYPE_PREDICTOR_H
@@ -27,6 +27,7 @@
 #include "gateway.h"
 #include "arduino.h"
 #include "graphics.h"
+#include "isolate.h"
 
 // Register all built-in libraries
 void register_all_builtin_libraries(Interpreter* interpreter);
@@ -11,13 +11,38 @@
 typedef enum {
     COMPRESSION_NONE,    // No compression
     COMPRESSION_RLE,     // Run-Length Encoding
-    COMPRESSION_DICT     // Dictionary compression
+    COMPRESSION_DICT,    // Dictionary compression
+    COMPRESSION_DEFLATE, // Raw DEFLATE stream (RFC 1951)
+    COMPRESSION_ZLIB,    // DEFLATE with zlib framing (RFC 1950)
+    COMPRESSION_GZIP     // DEFLATE with gzip framing (RFC 1952)
 } CompressionType;
 
+// DEFLATE levels: 0 stores, 1 is fastest, 9 compresses best
+#define COMPRESSION_LEVEL_STORE 0
+#define COMPRESSION_LEVEL_FAST 1
+#define COMPRESSION_LEVEL_DEFAULT 6
+#define COMPRESSION_LEVEL_BEST 9
+
 // Core compression functions
 char* compress_data(const char* data, size_t data_size, CompressionType type, size_t* compressed_size);
+char* compress_data_level(const char* data, size_t data_size, CompressionType type, int level, size_t* compressed_size);
 char* decompress_data(const char* data, size_t data_size, CompressionType type, size_t* decompressed_size);
 
+// Streaming DEFLATE encoder
+// Feed input in any number of chunks; each call to deflate_stream_take()
+// hands back the compressed bytes produced so far. Pass finish on the last
+// write to flush the final block and the gzip/zlib trailer.
+typedef struct DeflateStream DeflateStream;
+
+DeflateStream* deflate_stream_create(CompressionType type, int level);
+bool deflate_stream_write(DeflateStream* stream, const char* data, size_t data_size, bool finish);
+char* deflate_stream_take(DeflateStream* stream, size_t* size);
+void deflate_stream_free(DeflateStream* stream);
+
+// Checksums used by the gzip and zlib framings
+unsigned long compression_crc32(unsigned long crc, const char* data, size_t data_size);
+unsigned long compression_adler32(unsigned long adler, const char* data, size_t data_size);
+
 // Utility functions
 double get_compression_ratio(size_t original_size, size_t compressed_size);
 bool is_compression_beneficial(size_t original_size, size_t compressed_size);
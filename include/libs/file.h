@@ -6,4 +6,13 @@
 // File library function declarations
 void file_library_register(Interpreter* interpreter);
 
+// Read up to size raw bytes from a handle returned by file.open(); returns
+// the number of bytes read (0 at end of file), or -1 if the handle is
+// invalid or closed
+long file_handle_read(Value handle_value, char* buffer, size_t size);
+
+// Write size raw bytes to a handle returned by file.open(); returns size, or
+// -1 if the handle is invalid or closed or the write came up short
+long file_handle_write(Value handle_value, const char* data, size_t size);
+
 #endif // FILE_H
@@ -67,6 +67,10 @@ Value builtin_http_get_json(Interpreter* interpreter, Value* args, size_t arg_co
 Value builtin_http_head(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_http_patch(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_http_options(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_http_fetch_async(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+
+// Drives http.fetchAsync() requests from the interpreter's event loop
+void http_process_async_requests(Interpreter* interpreter);
 
 // Library registration function
 void http_library_register(Interpreter* interpreter);
@@ -27,4 +27,18 @@ HttpResponse* http_delete(const char* url, const char* headers, int timeout);
 // Memory management
 void http_response_free(HttpResponse* response);
 
+// Value of a response header (case-insensitive name, not NUL-terminated).
+// A gzip or deflate body has already been decoded; Content-Encoding still
+// names the coding the server used.
+const char* http_response_header(const HttpResponse* response, const char* name, size_t* value_length);
+
+// Non-blocking requests, driven by http_client_poll() from a single thread.
+// The callback gets the response (and frees it with http_response_free) or
+// NULL and an error message.
+typedef void (*HttpAsyncCallback)(void* context, HttpResponse* response, const char* error);
+bool http_client_request_async(const char* url, const char* method, const char* headers, const char* body,
+                               int timeout_seconds, HttpAsyncCallback callback, void* context);
+size_t http_client_poll(int timeout_ms);
+size_t http_client_pending(void);
+
 #endif // HTTP_CLIENT_H
@@ -3,6 +3,8 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
 
 // Custom HTTP server to replace libmicrohttpd dependency
 // Provides lightweight, dependency-free HTTP server functionality
@@ -14,12 +16,21 @@
 #define HTTP_SERVER_ERROR_LISTEN -3
 #define HTTP_SERVER_ERROR_FCNTL -4
 #define HTTP_SERVER_ERROR_ALREADY_RUNNING -5
+#define HTTP_SERVER_ERROR_POLL -6
+
+// Defaults for the server options (server.create({workers, backlog, maxConnections}))
+#define HTTP_SERVER_DEFAULT_WORKERS 4
+#define HTTP_SERVER_DEFAULT_BACKLOG 511
+#define HTTP_SERVER_DEFAULT_MAX_CONNECTIONS 10000
 
 // Forward declarations
 typedef struct HttpRequest HttpRequest;
 typedef struct HttpResponse HttpResponse;
 typedef struct HttpServer HttpServer;
 typedef struct HttpRoute HttpRoute;
+typedef struct HttpConnection HttpConnection;
+typedef struct HttpJob HttpJob;
+struct RouteTable;
 
 // HTTP request structure
 struct HttpRequest {
@@ -28,6 +39,8 @@ struct HttpRequest {
     char* headers;
     char* body;
     char* query_string;
+    size_t body_length;      // Bytes in body (it may contain NULs)
+    bool keep_alive;         // Connection stays open after the response
 };
 
 // HTTP response structure
@@ -35,6 +48,8 @@ struct HttpResponse {
     int status_code;
     char* content_type;
     char* body;
+    size_t body_length;      // Bytes in body (0 = strlen(body))
+    bool owns_content_type;  // content_type was allocated for this response
 };
 
 // HTTP route handler function type
@@ -48,13 +63,41 @@ struct HttpRoute {
 };
 
 // HTTP server structure
+// One event loop (epoll on Linux, kqueue elsewhere) owns the listening
+// socket and every connection; complete requests are handed to a pool of
+// worker threads and their responses queued back to the loop.
 struct HttpServer {
     int port;
     int socket_fd;
-    bool running;
+    volatile bool running;
     HttpRoute* routes;
     size_t route_count;
-    int max_connections;
+    struct RouteTable* myco_routes;  // Compiled Myco routes (router.h)
+    int max_connections;     // Open connections beyond this are refused
+    int backlog;             // listen() backlog
+    int worker_count;        // Threads running request handlers
+    bool enable_gzip;        // gzip dynamic text responses the client accepts
+    
+    // Event loop
+    int poll_fd;             // epoll / kqueue descriptor
+    int wake_fds[2];         // Pipe workers write to when a response is ready
+    HttpConnection* connections;
+    size_t connection_count;
+    HttpConnection* closed_connections;  // Freed at the end of each poll batch
+    time_t last_idle_sweep;  // When idle connections were last closed
+    pthread_t loop_thread;
+    bool loop_started;       // Loop runs on loop_thread (http_server_run_in_background)
+    
+    // Worker pool
+    pthread_t* workers;
+    size_t workers_started;
+    bool stopping;
+    pthread_mutex_t queue_mutex;
+    pthread_cond_t queue_cond;
+    HttpJob* pending_head;   // Requests waiting for a worker
+    HttpJob* pending_tail;
+    HttpJob* done_head;      // Responses waiting for the event loop
+    HttpJob* done_tail;
 };
 
 // Server management
@@ -62,6 +105,7 @@ HttpServer* http_server_create(int port);
 int http_server_add_route(HttpServer* server, const char* method, const char* path, 
                          HttpRouteHandler handler);
 int http_server_start(HttpServer* server);
+int http_server_run_in_background(HttpServer* server);
 int http_server_handle_requests(HttpServer* server);
 void http_server_register_myco_routes(HttpServer* server, void* myco_routes);
 void http_server_stop(HttpServer* server);
@@ -0,0 +1,43 @@
+#ifndef MYCO_ISOLATE_H
+#define MYCO_ISOLATE_H
+
+#include <stdbool.h>
+#include "../core/interpreter.h"
+
+/**
+ * @file isolate.h
+ * @brief Isolates: interpreters with their own heap running on a thread pool
+ *
+ * isolate.spawn(path, name) loads a module into a fresh interpreter and
+ * returns a handle whose call(msg) / send(msg) deliver messages to the
+ * module's function `name`. Messages and results are deep-copied between
+ * heaps (null, booleans, numbers, strings, ranges, arrays, objects, maps
+ * and sets), so nothing is shared across threads.
+ *
+ * Isolates are meant for CPU-bound work. Sockets, timers and servers stay
+ * with the main event loop, and an isolate cannot spawn isolates.
+ */
+
+// Myco library functions
+Value builtin_isolate_spawn(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_isolate_workers(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_isolate_call(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_isolate_send(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_isolate_close(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+
+// Settle the interpreter's isolate.call() promises whose results have
+// arrived. Called from the interpreter's event loop.
+void isolate_process_replies(Interpreter* interpreter);
+
+// Close the isolates an interpreter spawned; called when it is freed
+void isolate_release_owner(Interpreter* interpreter);
+
+// Whether the calling thread is running an isolate, and the short sleep
+// the event loop takes there instead of blocking in the reactor
+bool isolate_in_worker(void);
+void isolate_wait(int timeout_ms);
+
+// Library registration function
+void isolate_library_register(Interpreter* interpreter);
+
+#endif // MYCO_ISOLATE_H
@@ -84,6 +84,39 @@ Value json_to_myco_value(const JsonValue* json_value);
 // Internal JSON parsing (silent, no error reporting)
 Value json_parse_silent(const char* json_str);
 
+// Serializer for Myco values. Output accumulates in one growable buffer;
+// with a sink, the buffer is handed to the sink whenever it passes
+// JSON_WRITER_FLUSH_BYTES, so a large document is never held in full.
+#define JSON_WRITER_FLUSH_BYTES 65536
+
+// Consumes length bytes of output; returns false to abort the write
+typedef bool (*JsonWriterSink)(void* context, const char* data, size_t length);
+
+typedef struct {
+    char* buffer;                // Pending output (shared allocator)
+    size_t length;
+    size_t capacity;
+    size_t flushed;              // Bytes already handed to the sink
+    size_t depth;
+    JsonWriterSink sink;         // NULL keeps everything in buffer
+    void* sink_context;
+    const char* error;
+} JsonWriter;
+
+void json_writer_init(JsonWriter* writer, JsonWriterSink sink, void* sink_context);
+bool json_writer_write(JsonWriter* writer, const Value* value);
+// Pass any buffered output to the sink
+bool json_writer_flush(JsonWriter* writer);
+// Detach the NUL-terminated output (release with shared_free_safe()) and
+// reset the writer
+char* json_writer_take(JsonWriter* writer, size_t* length);
+void json_writer_release(JsonWriter* writer);
+
+// Shortest text that reads back as the same double ("null" for NaN and
+// infinities); out needs JSON_NUMBER_BUFFER_SIZE bytes. Returns the length.
+#define JSON_NUMBER_BUFFER_SIZE 32
+size_t json_format_number(double number, char* out);
+
 // Myco library functions
 Value builtin_json_parse(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_json_stringify(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
@@ -95,6 +128,9 @@ Value builtin_json_get(Interpreter* interpreter, Value* args, size_t arg_count,
 Value builtin_json_set(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_json_size(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_json_is_empty(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_json_stream(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_json_events(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+Value builtin_json_write(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 
 // Library registration function
 void json_library_register(Interpreter* interpreter);
@@ -0,0 +1,43 @@
+#ifndef MYCO_JSON_READER_H
+#define MYCO_JSON_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "../core/interpreter.h"
+
+/**
+ * @file json_reader.h
+ * @brief Single-pass JSON reader and the vector scanners it shares with
+ * json.stream() and the JSON writer
+ */
+
+#define JSON_READER_MAX_DEPTH 1024
+
+// Scan [p, end) and return the first byte of interest, or end
+typedef const char* (*JsonScanFn)(const char* p, const char* end);
+
+// Widest available implementation, chosen by json_scan_init()
+extern JsonScanFn json_skip_space_run;     // First non-whitespace byte
+extern JsonScanFn json_scan_string_run;    // First '"' or '\\'
+extern JsonScanFn json_scan_escape_run;    // First byte a JSON string must escape
+
+// Select the scanners for this CPU; cheap after the first call
+void json_scan_init(void);
+
+// Escape letter for each byte a JSON string must escape ('u' for \u00XX),
+// 0 for bytes copied as-is
+extern const char json_escape_table[256];
+
+static inline bool json_is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Parse a whole NUL-terminated document of the given length into *out.
+// On failure returns false and sets *error to a static message.
+bool json_read_document(const char* text, size_t length, Value* out, const char** error);
+
+// Wrap finished, already-unescaped text (length bytes, NUL-terminated) as a
+// string Value that takes ownership of it
+Value json_adopt_string(char* text, size_t length);
+
+#endif // MYCO_JSON_READER_H
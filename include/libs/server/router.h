@@ -0,0 +1,47 @@
+#ifndef MYCO_ROUTER_H
+#define MYCO_ROUTER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Compiled route table
+// Routes are compiled into one radix tree per method when the server starts
+// listening. Each edge is a path segment: runs of static segments are merged
+// into a single node, ":name" and ":name:type" capture one segment (typed
+// segments are checked with validate_typed_parameter), and "*name" captures
+// the rest of the path. Static edges are tried before typed parameters,
+// typed before untyped and untyped before wildcards, backtracking on a miss.
+// Matching allocates nothing; captures point into the request path.
+
+#define ROUTE_MAX_PARAMS 16
+
+struct Route;
+typedef struct RouteNode RouteNode;
+typedef struct RouteTable RouteTable;
+
+// One captured parameter (not NUL-terminated)
+typedef struct {
+    const char* name;
+    size_t name_length;
+    const char* value;
+    size_t value_length;
+} RouteMatchParam;
+
+// Result of matching one request, owned by the caller
+typedef struct {
+    struct Route* route;
+    size_t param_count;
+    RouteMatchParam params[ROUTE_MAX_PARAMS];
+} RouteMatch;
+
+// Compile a Route list (first registration wins on duplicates)
+RouteTable* route_table_compile(struct Route* routes);
+void route_table_free(RouteTable* table);
+
+// Match method and path (a query string, if present, is ignored)
+bool route_table_match(const RouteTable* table, const char* method, const char* path, RouteMatch* match);
+
+// Find a captured parameter by name; returns NULL if absent
+const char* route_match_param(const RouteMatch* match, const char* name, size_t* value_length);
+
+#endif // MYCO_ROUTER_H
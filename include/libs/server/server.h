@@ -20,6 +20,9 @@ typedef struct {
     bool debug;
     bool enable_gzip;
     bool enable_cache;
+    int workers;            // Threads running route handlers (0 = default)
+    int backlog;            // listen() backlog (0 = default)
+    int max_connections;    // Open connection limit (0 = default)
 } ServerConfig;
 
 // Middleware structure
@@ -0,0 +1,62 @@
+#ifndef MYCO_STATIC_CACHE_H
+#define MYCO_STATIC_CACHE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// Hot static file cache
+// Small files served by server.static are kept in memory, keyed by path and
+// validated against the file's mtime and size. An entry is re-checked with
+// stat() at most once per STATIC_CACHE_REVALIDATE_SECONDS; the FileWatcher
+// drops entries as soon as it sees a change. The cache is bounded by total
+// bytes and evicts least recently used entries. Entries are reference
+// counted, so a response can keep sending one after it has been evicted.
+// Compressible files also keep a gzip variant, built on first request.
+
+#define STATIC_CACHE_MAX_BYTES (32 * 1024 * 1024)
+#define STATIC_CACHE_MAX_FILE_BYTES (1024 * 1024)
+#define STATIC_CACHE_REVALIDATE_SECONDS 1
+
+typedef struct StaticCacheEntry {
+    char* path;
+    time_t mtime;
+    off_t size;
+    char* data;                      // File contents (size bytes)
+    char etag[48];                   // Quoted strong validator
+    char last_modified[40];          // IMF-fixdate
+    const char* mime_type;
+    char* gzip_data;                 // gzip variant, NULL if none
+    size_t gzip_size;
+    bool gzip_built;                 // gzip variant has been attempted
+    time_t checked_at;               // Last stat() that confirmed the entry
+    int refs;                        // Cache reference plus one per response
+    bool cached;                     // Still reachable from the cache
+    struct StaticCacheEntry* hash_next;
+    struct StaticCacheEntry* lru_prev;
+    struct StaticCacheEntry* lru_next;
+} StaticCacheEntry;
+
+// Look up (or load) path. Returns a referenced entry whose size and mtime are
+// also copied into st, or NULL when the file is missing or too large to
+// cache; st then holds the stat() result (st_mode is 0 if there is no file).
+StaticCacheEntry* static_cache_acquire(const char* path, struct stat* st);
+void static_cache_release(StaticCacheEntry* entry);
+
+// Build the gzip variant of an acquired entry if needed; returns false when
+// compression doesn't make the file smaller
+bool static_cache_gzip(StaticCacheEntry* entry);
+
+// Drop every entry whose path starts with path_prefix (NULL drops all)
+void static_cache_invalidate(const char* path_prefix);
+
+// ETag and Last-Modified for a file that is served uncached
+void static_cache_validators(const struct stat* st, char* etag, size_t etag_size,
+                             char* last_modified, size_t last_modified_size);
+
+// Parse an IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT"); returns -1 if invalid
+time_t static_cache_parse_http_date(const char* value);
+
+#endif // MYCO_STATIC_CACHE_H
@@ -82,6 +82,7 @@ typedef struct WebSocketConnection {
     
     // Non-blocking I/O
     bool non_blocking;
+    bool reactor_watched;      // socket_fd is registered with the event loop's reactor
     Interpreter* interpreter;  // For async event loop integration
     
     // Receive buffer for accumulating data across multiple reads
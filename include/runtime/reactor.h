@@ -0,0 +1,45 @@
+#ifndef MYCO_REACTOR_H
+#define MYCO_REACTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file reactor.h
+ * @brief Process-wide readiness loop for the interpreter's event loop
+ *
+ * Sockets owned by the event loop thread (websocket connections, in-flight
+ * http.fetchAsync requests) are watched here, libraries ask for a wakeup at
+ * their next timer deadline (heartbeats, keepalive pings, request timeouts),
+ * and any thread can wake the loop when it finishes work (worker threads
+ * settling promises, servers shutting down). reactor_wait() blocks until one
+ * of those happens.
+ *
+ * Linux uses epoll with a timerfd for deadlines and an eventfd for wakeups;
+ * other platforms use kqueue with a wake pipe.
+ */
+
+#define REACTOR_READ  1
+#define REACTOR_WRITE 2
+
+// Current CLOCK_MONOTONIC time in milliseconds (the clock deadlines use)
+uint64_t reactor_now_ms(void);
+
+// Watch fd for the given REACTOR_* events; 0 stops watching it.
+// Unwatch a descriptor before closing it.
+bool reactor_watch(int fd, int events);
+void reactor_unwatch(int fd);
+
+// Make the next reactor_wait() return no later than deadline_ms.
+// Deadlines are one-shot: callers re-arm them on every pass.
+void reactor_schedule(uint64_t deadline_ms);
+
+// Make the current (or next) reactor_wait() return. Safe from any thread.
+void reactor_wake(void);
+
+// Block until a watched fd is ready, a scheduled deadline passes, a wakeup
+// arrives or timeout_ms elapses (-1 = no limit). Returns the number of
+// ready descriptors, 0 on a deadline/timeout/wakeup, -1 on error.
+int reactor_wait(int timeout_ms);
+
+#endif // MYCO_REACTOR_H
@@ -0,0 +1,62 @@
+#ifndef MYCO_SCHEDULER_H
+#define MYCO_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file scheduler.h
+ * @brief Work-stealing thread pool for async tasks
+ *
+ * Each worker owns a Chase-Lev deque: it pushes and pops tasks at the
+ * bottom without locking, and idle workers steal from the top. Tasks
+ * submitted from outside the pool (the main thread, server threads) go
+ * through a lock-free multi-producer injection queue that workers drain
+ * in batches into their own deques. Idle workers spin briefly, then park
+ * on a condition variable that submitters only touch when someone sleeps.
+ *
+ * Tasks embed a SchedulerTask header; the run callback receives it back.
+ */
+
+typedef struct SchedulerTask {
+    struct SchedulerTask* next;  // Injection queue link, owned by the scheduler
+} SchedulerTask;
+
+typedef void (*SchedulerRunFn)(void* context, SchedulerTask* task);
+
+// Per-worker counters (read racily; each is only written by its worker)
+typedef struct {
+    uint64_t tasks_run;
+    uint64_t steals;           // Tasks taken from another worker's deque
+    uint64_t injected;         // Tasks taken from the injection queue
+    uint64_t idle_ns;          // Time spent looking for work or parked
+} SchedulerWorkerStats;
+
+typedef struct Scheduler Scheduler;
+
+Scheduler* scheduler_create(SchedulerRunFn run, void* context);
+
+// Start the worker threads; tasks submitted before this wait in the
+// injection queue. Returns how many workers are running.
+size_t scheduler_start(Scheduler* scheduler, size_t worker_count);
+size_t scheduler_worker_count(const Scheduler* scheduler);
+
+// Queue a task; safe from any thread, including from inside a running task
+void scheduler_submit(Scheduler* scheduler, SchedulerTask* task);
+
+// Tasks submitted but not yet started (a running task is tracked by
+// whatever it will signal when done)
+size_t scheduler_pending(const Scheduler* scheduler);
+
+// Run queued tasks on the calling thread (for when no workers could be
+// started). Returns how many ran.
+size_t scheduler_run_here(Scheduler* scheduler);
+
+bool scheduler_worker_stats(const Scheduler* scheduler, size_t worker, SchedulerWorkerStats* stats);
+
+// Stop and join the workers (each finishes its current task) and free the
+// scheduler. Returns the tasks that never ran, linked through next.
+SchedulerTask* scheduler_destroy(Scheduler* scheduler);
+
+#endif // MYCO_SCHEDULER_H
@@ -33,6 +33,11 @@ void shared_memory_stats(const char* component);
 void shared_memory_cleanup(const char* component);
 void shared_memory_report_all(void);
 
+// Allocator mode: debug mode adds canaries and per-allocation tracking to
+// shared_malloc_safe/shared_realloc_safe (select before the first allocation)
+void shared_alloc_set_debug(bool enable);
+bool shared_alloc_is_debug(void);
+
 // Memory tracking control
 void shared_memory_tracking_enable(bool enable);
 bool shared_memory_tracking_is_enabled(void);
@@ -21,6 +21,8 @@ int parse_arguments(int argc, char* argv[], ArgumentConfig* config) {
     config->jit_mode = 0;
     config->bytecode_enabled = 1; // Bytecode is the only execution path
     config->run_tests = 0;
+    config->debug_alloc = 0;
+    config->vm_stats = 0;
     config->input_source = NULL;
     config->output_file = NULL;
     config->architecture = NULL;
@@ -34,9 +36,13 @@ int parse_arguments(int argc, char* argv[], ArgumentConfig* config) {
         return MYCO_SUCCESS;
     }
     
-    // Check for help, version, and test flags first (these can be anywhere)
+    // Check for help, version, test, allocator and stats flags first (these can be anywhere)
     for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+        if (strcmp(argv[i], "--debug-alloc") == 0) {
+            config->debug_alloc = 1;
+        } else if (strcmp(argv[i], "--vm-stats") == 0) {
+            config->vm_stats = 1;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             config->help = 1;
             return MYCO_SUCCESS;
         } else if (strcmp(argv[i], "--version") == 0 || strcmp(argv[i], "-v") == 0) {
@@ -48,11 +54,20 @@ int parse_arguments(int argc, char* argv[], ArgumentConfig* config) {
         }
     }
     
-    // First argument should be the input file or source
-    config->input_source = argv[1];
+    // First argument should be the input file or source (--debug-alloc/--vm-stats may precede it)
+    int input_index = 1;
+    while (input_index < argc && (strcmp(argv[input_index], "--debug-alloc") == 0 ||
+                                  strcmp(argv[input_index], "--vm-stats") == 0)) {
+        input_index++;
+    }
+    if (input_index >= argc) {
+        // Only global flags given - enter REPL mode
+        return MYCO_SUCCESS;
+    }
+    config->input_source = argv[input_index];
     
     // Parse remaining command line arguments
-    for (int i = 2; i < argc; i++) {
+    for (int i = input_index + 1; i < argc; i++) {
         if (strcmp(argv[i], "--interpret") == 0 || strcmp(argv[i], "-i") == 0) {
             config->interpret = 1;
         } else if (strcmp(argv[i], "--compile") == 0 || strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--c") == 0) {
@@ -63,6 +78,8 @@ int parse_arguments(int argc, char* argv[], ArgumentConfig* config) {
             config->emit_arduino = 1;
         } else if (strcmp(argv[i], "--debug") == 0 || strcmp(argv[i], "-d") == 0) {
             config->debug = 1;
+        } else if (strcmp(argv[i], "--debug-alloc") == 0 || strcmp(argv[i], "--vm-stats") == 0) {
+            // Handled in the first pass
         } else if (strcmp(argv[i], "--optimize") == 0 || strcmp(argv[i], "-O") == 0) {
             if (i + 1 < argc) {
                 i++;
@@ -84,20 +101,21 @@ int parse_arguments(int argc, char* argv[], ArgumentConfig* config) {
             }
         } else if (strcmp(argv[i], "--jit") == 0 || strcmp(argv[i], "-j") == 0) {
             config->jit_enabled = 1;
-            if (i + 1 < argc && argv[i + 1][0] != '-') {
-                i++;
-                if (strcmp(argv[i], "0") == 0 || strcmp(argv[i], "interpreted") == 0) {
+            config->jit_mode = 1; // Default to hybrid mode
+            // The mode is optional, so anything else (such as the script
+            // path) is left for the next iteration
+            if (i + 1 < argc) {
+                const char* mode = argv[i + 1];
+                if (strcmp(mode, "0") == 0 || strcmp(mode, "interpreted") == 0) {
                     config->jit_mode = 0;
-                } else if (strcmp(argv[i], "1") == 0 || strcmp(argv[i], "hybrid") == 0) {
+                    i++;
+                } else if (strcmp(mode, "1") == 0 || strcmp(mode, "hybrid") == 0) {
                     config->jit_mode = 1;
-                } else if (strcmp(argv[i], "2") == 0 || strcmp(argv[i], "compiled") == 0) {
+                    i++;
+                } else if (strcmp(mode, "2") == 0 || strcmp(mode, "compiled") == 0) {
                     config->jit_mode = 2;
-                } else {
-                    fprintf(stderr, "Error: Unknown JIT mode '%s'\n", argv[i]);
-                    return MYCO_ERROR_CLI;
+                    i++;
                 }
-            } else {
-                config->jit_mode = 1; // Default to hybrid mode
             }
         } else if (strcmp(argv[i], "--target") == 0 || strcmp(argv[i], "-t") == 0) {
             if (i + 1 < argc) {
@@ -167,6 +185,8 @@ void print_usage(const char* program_name) {
     printf("  -b, --build               Build executable from input\n");
     printf("      --emit-arduino        Emit Arduino .ino sketch from Myco source\n");
     printf("  -d, --debug               Enable debug mode\n");
+    printf("      --debug-alloc         Track allocations with canaries and report live blocks at exit\n");
+    printf("      --vm-stats            Report bytecode instructions executed and instructions/sec at exit\n");
    printf("   -O, --optimize <level>    Set optimization level (0/none, 1/basic, 2/aggressive, 3/maximum)\n");
    printf("   -j, --jit [mode]          Enable JIT compilation (0/interpreted, 1/hybrid, 2/compiled)\n");
    printf("       --target <target>     Set compilation target (c, x86_64, arm64, wasm, bytecode)\n");
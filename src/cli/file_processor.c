@@ -15,30 +15,11 @@
 #include <errno.h>
 #include <unistd.h>
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/micro_jit.h"
 
 // Helper function to check if there are pending async operations
 static int has_pending_async_operations(Interpreter* interp) {
-    if (!interp) return 0;
-    
-    // Check for pending async tasks
-    if (interp->task_queue && interp->task_queue_size > 0) {
-        return 1;
-    }
-    
-    // Check for unresolved promises
-    if (interp->promise_registry && interp->promise_registry_size > 0) {
-        for (size_t i = 0; i < interp->promise_registry_size; i++) {
-            if (interp->promise_registry[i].type == VALUE_PROMISE) {
-                Value* promise = &interp->promise_registry[i];
-                if (!promise->data.promise_value.is_resolved && 
-                    !promise->data.promise_value.is_rejected) {
-                    return 1;  // Found unresolved promise
-                }
-            }
-        }
-    }
-    
-    return 0;
+    return async_has_pending_work(interp);
 }
 
 // Process a file
@@ -73,7 +54,7 @@ int process_file(const char* filename, int interpret, int compile, int build, in
         printf("File size: %ld bytes\n", file_size);
     }
     
-    int result = process_source(source, filename, interpret, compile, build, debug, target, architecture, output_file, optimization_level);
+    int result = process_source(source, filename, interpret, compile, build, debug, target, architecture, output_file, optimization_level, jit_enabled, jit_mode);
     shared_free_safe(source, "file_processor", "unknown_function", 48);
     return result;
 }
@@ -87,11 +68,11 @@ int process_string(const char* source, int interpret, int compile, int build, in
         printf("Source length: %zu characters\n", strlen(source));
     }
     
-    return process_source(source, "string_input", interpret, compile, build, debug, target, architecture, output_file, optimization_level);
+    return process_source(source, "string_input", interpret, compile, build, debug, target, architecture, output_file, optimization_level, jit_enabled, jit_mode);
 }
 
 // Process source code (common implementation)
-int process_source(const char* source, const char* filename, int interpret, int compile, int build, int debug, int target, const char* architecture, const char* output_file, int optimization_level) {
+int process_source(const char* source, const char* filename, int interpret, int compile, int build, int debug, int target, const char* architecture, const char* output_file, int optimization_level, int jit_enabled, int jit_mode) {
     if (!source) return MYCO_ERROR_CLI;
     
     if (debug) {
@@ -102,7 +83,7 @@ int process_source(const char* source, const char* filename, int interpret, int
     }
     
     if (interpret) {
-        return interpret_source(source, filename, debug);
+        return interpret_source(source, filename, debug, jit_enabled, jit_mode);
     } else if (compile) {
         return compile_source(source, target, debug, output_file);
     } else if (build) {
@@ -113,7 +94,7 @@ int process_source(const char* source, const char* filename, int interpret, int
 }
 
 // Interpret source code
-int interpret_source(const char* source, const char* filename, int debug) {
+int interpret_source(const char* source, const char* filename, int debug, int jit_enabled, int jit_mode) {
     if (!source) return MYCO_ERROR_CLI;
     
     if (debug) {
@@ -198,9 +179,12 @@ int interpret_source(const char* source, const char* filename, int debug) {
     
     // Bytecode execution continues after errors
     
-    // Configure JIT if enabled
-    // TODO: Re-enable JIT integration once parameter issue is resolved
-    // JIT parameters are accepted but not used for now
+    // Configure JIT if enabled: hot register-tier functions get native code
+    if (jit_enabled) {
+        interpreter->jit_enabled = 1;
+        interpreter->jit_mode = jit_mode;
+        micro_jit_initialize_for_interpreter(interpreter);
+    }
     
     // Register built-in libraries
     register_all_builtin_libraries(interpreter);
@@ -234,52 +218,26 @@ int interpret_source(const char* source, const char* filename, int debug) {
     if (has_gateway || has_active_gateway) {
     }
     
-    // Run event loop multiple times to process any pending async tasks that might create gateway connections
-    // This ensures gateway connections created by async functions are registered before we check
-    // Keep running until either we have a gateway connection or no pending async operations
-    for (int i = 0; i < 50; i++) {
+    // Keep script alive while servers, gateway connections or pending async
+    // operations remain, like JavaScript. Each pass handles whatever is ready,
+    // then blocks in the reactor until a watched socket is readable, a timer
+    // (heartbeat, keepalive ping, request timeout) is due, or another thread
+    // settles a promise or stops a server.
+    bool keep_alive = g_servers_running || gateway_has_connections() || has_pending_async_operations(interpreter);
+    while (keep_alive) {
+        // Process async event loop to handle websocket/gateway messages and async tasks
         async_event_loop_run(interpreter);
         
-        // Check if gateway connection was created
-        if (gateway_has_connections()) {
-            break;
-        }
+        // Process WebSocket connections (reads messages, handles ping/pong)
+        websocket_process_connections(interpreter);
         
-        // If no pending async operations, we can stop early
-        if (!has_pending_async_operations(interpreter)) {
-            break;
-        }
+        // Process gateway connections (handles heartbeats, processes messages)
+        gateway_process_all_connections(interpreter);
         
-        usleep(50000); // 50ms delay between runs
-    }
-    
-    // Keep script alive if servers exist, gateway connections exist, or there are pending async operations
-    // This ensures the program stays alive while gateway connections are being established
-    // and while async tasks are being processed
-    bool has_servers = g_servers_running;
-    bool has_gateway_conns = gateway_has_connections();
-    bool has_pending_async = has_pending_async_operations(interpreter);
-    
-    if (has_servers || has_gateway_conns || has_pending_async) {
-        while (has_servers || has_gateway_conns || has_pending_async) {
-            // Process async event loop to handle websocket/gateway messages and async tasks
-            async_event_loop_run(interpreter);
-            
-            // Process WebSocket connections (reads messages, handles ping/pong)
-            websocket_process_connections(interpreter);
-            
-            // Process gateway connections (handles heartbeats, processes messages)
-            gateway_process_all_connections(interpreter);
-            
-            // Re-check conditions
-            has_servers = g_servers_running;
-            has_gateway_conns = gateway_has_connections();
-            has_pending_async = has_pending_async_operations(interpreter);
-            
-            // Small delay to prevent busy waiting, but shorter for async tasks
-            usleep(has_pending_async ? 10000 : 100000); // 10ms for async, 100ms for servers/gateway
+        keep_alive = g_servers_running || gateway_has_connections() || has_pending_async_operations(interpreter);
+        if (keep_alive) {
+            async_event_loop_wait(interpreter, -1);
         }
-    } else {
     }
     
     // Clean up (after servers have stopped)
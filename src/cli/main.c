@@ -1,26 +1,49 @@
+// Define POSIX source before including time.h so clock_gettime is available
+#define _POSIX_C_SOURCE 200809L
+
 #include "myco.h"
 #include "argument_parser.h"
 #include "file_processor.h"
 #include "repl.h"
 #include "version.h"
 #include "arduino_emitter.h"
+#include "shared_utilities.h"
+#include "optimization/arena_allocator.h"
+#include "bytecode.h"
+#include "optimization/register_vm.h"
+#include "optimization/micro_jit_baseline.h"
+#include "optimization/trace_recorder.h"
+#include "optimization/type_predictor.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 // Global variables
 MemoryTracker* g_memory_tracker = NULL;
 int g_myco_error_code = MYCO_SUCCESS;
 char* g_myco_error_message = NULL;
 
+// --vm-stats: wall-clock start of the run, or a negative value when disabled
+static double vm_stats_start = -1.0;
+
 // Function prototypes
 static void print_banner(void);
 static void cleanup(void);
+static double monotonic_seconds(void);
 
 int main(int argc, char* argv[]) {
     ArgumentConfig config;
     int result = parse_arguments(argc, argv, &config);
     
+    // Must happen before anything is allocated through shared_malloc_safe
+    if (config.debug_alloc) {
+        shared_alloc_set_debug(true);
+    }
+    if (config.vm_stats) {
+        vm_stats_start = monotonic_seconds();
+    }
+    
     if (result != MYCO_SUCCESS) {
         cleanup();
         return result;
@@ -122,7 +145,53 @@ static void print_banner(void) {
     printf("================================\n\n");
 }
 
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
 static void cleanup(void) {
+    // Report VM throughput over the whole run (parse and compile included)
+    if (vm_stats_start >= 0.0) {
+        double elapsed = monotonic_seconds() - vm_stats_start;
+        unsigned long long executed = bytecode_vm_instruction_count();
+        fprintf(stderr, "[VM STATS] dispatch: %s, instructions: %llu, time: %.3fs, rate: %.0f instructions/sec\n",
+                bytecode_vm_dispatch_mode(), executed, elapsed,
+                elapsed > 0.0 ? (double)executed / elapsed : 0.0);
+        RegisterTierStats tier;
+        register_tier_get_stats(&tier);
+        fprintf(stderr, "[VM STATS] register tier: functions: %zu (rejected %zu), loop entries: %zu, instructions: %llu\n",
+                tier.functions_compiled, tier.functions_rejected, tier.loop_entries,
+                (unsigned long long)tier.instructions);
+        MicroJitTierStats jit;
+        micro_jit_get_tier_stats(&jit);
+        fprintf(stderr, "[VM STATS] jit: functions: %zu (rejected %zu, invalidated %zu), code: %zu bytes, native entries: %llu, deopts: %llu\n",
+                jit.functions_compiled, jit.functions_rejected, jit.functions_invalidated, jit.code_bytes,
+                (unsigned long long)jit.native_entries, (unsigned long long)jit.deoptimizations);
+        const LoopTraceStats* traces = loop_trace_stats();
+        fprintf(stderr, "[VM STATS] traces: recorded %zu (aborted %zu, invalidated %zu), branches: %zu, entries: %llu, "
+                "side exits: %llu, folded: %zu, guards eliminated: %zu, hoisted: %zu\n",
+                traces->traces_recorded, traces->traces_aborted, traces->traces_invalidated, traces->branches_recorded,
+                (unsigned long long)traces->entries, (unsigned long long)traces->side_exits,
+                traces->constants_folded, traces->guards_eliminated, traces->instructions_hoisted);
+        unsigned long long quickened = 0, generic = 0;
+        bytecode_vm_quickening_counts(&quickened, &generic);
+        const TypeFeedbackStats* feedback = type_feedback_stats();
+        fprintf(stderr, "[VM STATS] quickening: sites: %zu (generic %zu, deopts %zu), quickened executions: %llu of %llu (%.1f%%)\n",
+                feedback->sites_quickened, feedback->sites_generic, feedback->deoptimizations,
+                quickened, quickened + generic,
+                quickened + generic > 0 ? 100.0 * (double)quickened / (double)(quickened + generic) : 0.0);
+    }
+    
+    // Report blocks that were never released when tracking was requested
+    if (shared_alloc_is_debug()) {
+        fprintf(stderr, "[MEMORY STATS] %zu tracked allocations live at exit\n",
+                shared_get_tracked_allocation_count());
+        shared_print_allocation_stats();
+        slab_print_stats();
+    }
+    
     // Clean up global memory tracker if it exists
     if (g_memory_tracker) {
         // TODO: Implement memory tracker cleanup
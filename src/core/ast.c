@@ -567,6 +567,8 @@ ASTNode* ast_create_class(const char* name, const char* parent, ASTNode* body, i
     node->data.class_definition.class_name = (name ? shared_strdup(name) : NULL);
     node->data.class_definition.parent_class = parent ? (parent ? shared_strdup(parent) : NULL) : NULL;
     node->data.class_definition.body = body;
+    node->data.class_definition.is_export = 0;
+    node->data.class_definition.is_private = 0;
     node->line = line;
     node->column = column;
     node->next = NULL;
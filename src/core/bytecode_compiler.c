@@ -1,5 +1,8 @@
 #include "../../include/core/bytecode.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/register_vm.h"
+#include "../../include/core/optimization/trace_recorder.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,9 +21,9 @@ typedef struct {
     size_t capacity;
 } DeadCodeTracker;
 
-// Compiler optimization globals
-static ConstantFoldingCache* const_fold_cache = NULL;
-static DeadCodeTracker* dead_code_tracker = NULL;
+// Compiler optimization globals (per thread so isolates can compile in parallel)
+static MYCO_THREAD_LOCAL ConstantFoldingCache* const_fold_cache = NULL;
+static MYCO_THREAD_LOCAL DeadCodeTracker* dead_code_tracker = NULL;
 
 // Helper function to extract original variable name from method chain
 // For arr.push(1).push(3), extracts "arr" from the nested structure
@@ -401,14 +404,14 @@ static int bc_add_ast(BytecodeProgram* p, ASTNode* n) {
 
 // Global variable to store the root AST node during compilation
 // This allows us to search the entire AST for lambda nodes
-static ASTNode* g_compilation_root = NULL;
+static MYCO_THREAD_LOCAL ASTNode* g_compilation_root = NULL;
 
 // Workaround: Track which lambda nodes should be treated as async functions
 // This is needed because the parser creates AST_NODE_LAMBDA for async function(...) in hash maps
-// NOTE: This is a global array that persists across all compilation units
-static ASTNode** g_async_lambdas = NULL;
-static size_t g_async_lambdas_count = 0;
-static size_t g_async_lambdas_capacity = 0;
+// NOTE: This is a per-thread array that persists across all compilation units
+static MYCO_THREAD_LOCAL ASTNode** g_async_lambdas = NULL;
+static MYCO_THREAD_LOCAL size_t g_async_lambdas_count = 0;
+static MYCO_THREAD_LOCAL size_t g_async_lambdas_capacity = 0;
 
 // Helper to clear the async lambdas array (call at start of each file compilation if needed)
 static void clear_async_lambdas(void) {
@@ -604,6 +607,306 @@ static void bc_emit_to_function(BytecodeFunction* func, BytecodeOp op, int a, in
     func->code_count++;
 }
 
+// ============================================================================
+// FUNCTION FRAME SLOTS
+// ============================================================================
+// Regular functions whose bodies compile entirely inline get their parameters
+// and `let` locals resolved to frame slot indices at compile time, so the VM
+// reads frame slots instead of looking names up in the call's Environment.
+// Names that are written back by name (arr[i] = v, obj.x = v) or read before
+// their declaration keep the name-based path.
+
+typedef struct {
+    const char** names;
+    size_t count;
+    size_t capacity;
+} BcNameList;
+
+static int bc_name_list_has(BcNameList* list, const char* name) {
+    for (size_t i = 0; i < list->count; i++) {
+        if (strcmp(list->names[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+static void bc_name_list_add(BcNameList* list, const char* name) {
+    if (!name || bc_name_list_has(list, name)) return;
+    if (list->count + 1 > list->capacity) {
+        size_t new_cap = list->capacity ? list->capacity * 2 : 8;
+        list->names = shared_realloc_safe(list->names, new_cap * sizeof(char*), "bytecode", "bc_name_list_add", 1);
+        list->capacity = new_cap;
+    }
+    list->names[list->count++] = name;
+}
+
+typedef struct {
+    BcNameList declared;    // Let names in declaration order
+    BcNameList seen;        // Names referenced so far (compile order)
+    BcNameList pinned;      // Names that must stay in the Environment
+} BcFrameScan;
+
+static void bc_pin_assignment_base(BcFrameScan* scan, ASTNode* base) {
+    if (base && base->type == AST_NODE_MEMBER_ACCESS) {
+        base = base->data.member_access.object;
+    }
+    if (base && base->type == AST_NODE_IDENTIFIER) {
+        bc_name_list_add(&scan->pinned, base->data.identifier_value);
+    }
+}
+
+// Walk a function body in compile order. Returns 0 if the body contains a node
+// that compiles to a nested scope or falls back to name-based execution.
+static int bc_scan_frame_body(BcFrameScan* scan, ASTNode* n) {
+    if (!n) return 1;
+    switch (n->type) {
+        case AST_NODE_NUMBER:
+        case AST_NODE_STRING:
+        case AST_NODE_BOOL:
+        case AST_NODE_NULL:
+        case AST_NODE_BREAK:
+        case AST_NODE_CONTINUE:
+            return 1;
+        case AST_NODE_IDENTIFIER:
+            bc_name_list_add(&scan->seen, n->data.identifier_value);
+            return 1;
+        case AST_NODE_BINARY_OP:
+            return bc_scan_frame_body(scan, n->data.binary.left) &&
+                   bc_scan_frame_body(scan, n->data.binary.right);
+        case AST_NODE_UNARY_OP:
+            return bc_scan_frame_body(scan, n->data.unary.operand);
+        case AST_NODE_IF_STATEMENT:
+            return bc_scan_frame_body(scan, n->data.if_statement.condition) &&
+                   bc_scan_frame_body(scan, n->data.if_statement.then_block) &&
+                   bc_scan_frame_body(scan, n->data.if_statement.else_if_chain) &&
+                   bc_scan_frame_body(scan, n->data.if_statement.else_block);
+        case AST_NODE_RETURN:
+            return bc_scan_frame_body(scan, n->data.return_statement.value);
+        case AST_NODE_BLOCK:
+            for (size_t i = 0; i < n->data.block.statement_count; i++) {
+                if (!bc_scan_frame_body(scan, n->data.block.statements[i])) return 0;
+            }
+            return 1;
+        case AST_NODE_FUNCTION_CALL:
+            bc_name_list_add(&scan->seen, n->data.function_call.function_name);
+            for (size_t i = 0; i < n->data.function_call.argument_count; i++) {
+                if (!bc_scan_frame_body(scan, n->data.function_call.arguments[i])) return 0;
+            }
+            return 1;
+        case AST_NODE_FUNCTION_CALL_EXPR: {
+            ASTNode* callee = n->data.function_call_expr.function;
+            if (!bc_scan_frame_body(scan, callee)) return 0;
+            // arr.push(v) writes the result back by name; that store is slot-aware
+            for (size_t i = 0; i < n->data.function_call_expr.argument_count; i++) {
+                if (!bc_scan_frame_body(scan, n->data.function_call_expr.arguments[i])) return 0;
+            }
+            return 1;
+        }
+        case AST_NODE_MEMBER_ACCESS:
+            return bc_scan_frame_body(scan, n->data.member_access.object);
+        case AST_NODE_ARRAY_LITERAL:
+            for (size_t i = 0; i < n->data.array_literal.element_count; i++) {
+                if (!bc_scan_frame_body(scan, n->data.array_literal.elements[i])) return 0;
+            }
+            return 1;
+        case AST_NODE_SET_LITERAL:
+            for (size_t i = 0; i < n->data.set_literal.element_count; i++) {
+                if (!bc_scan_frame_body(scan, n->data.set_literal.elements[i])) return 0;
+            }
+            return 1;
+        case AST_NODE_HASH_MAP_LITERAL:
+            for (size_t i = 0; i < n->data.hash_map_literal.pair_count; i++) {
+                if (!bc_scan_frame_body(scan, n->data.hash_map_literal.keys[i]) ||
+                    !bc_scan_frame_body(scan, n->data.hash_map_literal.values[i])) return 0;
+            }
+            return 1;
+        case AST_NODE_ARRAY_ACCESS:
+            return bc_scan_frame_body(scan, n->data.array_access.array) &&
+                   bc_scan_frame_body(scan, n->data.array_access.index);
+        case AST_NODE_ASSIGNMENT: {
+            ASTNode* target = n->data.assignment.target;
+            if (!target) {
+                if (!n->data.assignment.variable_name) return 0;
+                if (!bc_scan_frame_body(scan, n->data.assignment.value)) return 0;
+                bc_name_list_add(&scan->seen, n->data.assignment.variable_name);
+                return 1;
+            }
+            if (target->type == AST_NODE_ARRAY_ACCESS) {
+                // name[i] = v writes through name's slot; obj.prop[k] = v stores obj back by name
+                if (target->data.array_access.array &&
+                    target->data.array_access.array->type == AST_NODE_MEMBER_ACCESS) {
+                    bc_pin_assignment_base(scan, target->data.array_access.array);
+                }
+                if (!bc_scan_frame_body(scan, target)) return 0;
+            } else if (target->type == AST_NODE_MEMBER_ACCESS) {
+                bc_pin_assignment_base(scan, target);
+                if (!bc_scan_frame_body(scan, target)) return 0;
+            } else if (target->type != AST_NODE_IDENTIFIER) {
+                return 0;
+            }
+            if (!bc_scan_frame_body(scan, n->data.assignment.value)) return 0;
+            if (target->type == AST_NODE_IDENTIFIER) {
+                bc_name_list_add(&scan->seen, target->data.identifier_value);
+            }
+            return 1;
+        }
+        case AST_NODE_VARIABLE_DECLARATION: {
+            const char* name = n->data.variable_declaration.variable_name;
+            if (!bc_scan_frame_body(scan, n->data.variable_declaration.initial_value)) return 0;
+            if (!name) return 0;
+            // A name used before its declaration may refer to an outer binding
+            if (bc_name_list_has(&scan->seen, name) && !bc_name_list_has(&scan->declared, name)) {
+                bc_name_list_add(&scan->pinned, name);
+            }
+            bc_name_list_add(&scan->declared, name);
+            bc_name_list_add(&scan->seen, name);
+            return 1;
+        }
+        case AST_NODE_FOR_LOOP:
+            // Collection loops compile their body to a separate sub-program
+            if (!n->data.for_loop.is_c_style) return 0;
+            return bc_scan_frame_body(scan, n->data.for_loop.init) &&
+                   bc_scan_frame_body(scan, n->data.for_loop.condition) &&
+                   bc_scan_frame_body(scan, n->data.for_loop.body) &&
+                   bc_scan_frame_body(scan, n->data.for_loop.increment);
+        case AST_NODE_WHILE_LOOP:
+            return bc_scan_frame_body(scan, n->data.while_loop.condition) &&
+                   bc_scan_frame_body(scan, n->data.while_loop.body);
+        default:
+            return 0;
+    }
+}
+
+static int bc_function_slot(BytecodeFunction* func, const char* name) {
+    if (!func->uses_frame_slots || !name) return -1;
+    for (size_t i = 0; i < func->local_count; i++) {
+        if (func->local_names[i] && strcmp(func->local_names[i], name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+static void bc_function_add_slot(BytecodeFunction* func, const char* name) {
+    if (func->local_count + 1 > func->local_capacity) {
+        size_t new_cap = func->local_capacity ? func->local_capacity * 2 : 8;
+        func->local_names = shared_realloc_safe(func->local_names, new_cap * sizeof(char*), "bytecode", "bc_function_add_slot", 1);
+        func->local_capacity = new_cap;
+    }
+    func->local_names[func->local_count++] = shared_strdup(name ? name : "");
+}
+
+// Decide whether a regular function can keep its locals in frame slots and,
+// if so, lay them out: parameters first (in order), then every let.
+static void bc_plan_frame_slots(BytecodeFunction* func, ASTNode* body) {
+    BcFrameScan scan = {0};
+    for (size_t i = 0; i < func->param_count; i++) {
+        bc_name_list_add(&scan.declared, func->param_names[i]);
+        bc_name_list_add(&scan.seen, func->param_names[i]);
+    }
+    
+    int eligible = body && bc_scan_frame_body(&scan, body);
+    for (size_t i = 0; eligible && i < func->param_count; i++) {
+        if (!func->param_names[i] || bc_name_list_has(&scan.pinned, func->param_names[i])) {
+            eligible = 0;
+        }
+    }
+    
+    if (eligible) {
+        func->uses_frame_slots = true;
+        for (size_t i = 0; i < func->param_count; i++) {
+            bc_function_add_slot(func, func->param_names[i]);
+        }
+        for (size_t i = func->param_count; i < scan.declared.count; i++) {
+            if (!bc_name_list_has(&scan.pinned, scan.declared.names[i]) &&
+                bc_function_slot(func, scan.declared.names[i]) < 0) {
+                bc_function_add_slot(func, scan.declared.names[i]);
+            }
+        }
+    }
+    
+    shared_free_safe(scan.declared.names, "bytecode", "bc_plan_frame_slots", 1);
+    shared_free_safe(scan.seen.names, "bytecode", "bc_plan_frame_slots", 2);
+    shared_free_safe(scan.pinned.names, "bytecode", "bc_plan_frame_slots", 3);
+}
+
+// Load/store a non-parameter name from function code: frame slot if the name
+// has one, otherwise by name through the environment chain.
+static void bc_emit_load_name(BytecodeProgram* p, BytecodeFunction* func, const char* name) {
+    int slot = bc_function_slot(func, name);
+    if (slot >= 0) {
+        bc_emit_to_function(func, BC_LOAD_LOCAL, slot, 0, 0);
+    } else {
+        int name_idx = bc_add_const(p, value_create_string(name));
+        bc_emit_to_function(func, BC_LOAD_GLOBAL, name_idx, 0, 0);
+    }
+}
+
+static void bc_emit_store_name(BytecodeProgram* p, BytecodeFunction* func, const char* name) {
+    int slot = bc_function_slot(func, name);
+    if (slot >= 0) {
+        bc_emit_to_function(func, BC_STORE_LOCAL, slot, 0, 0);
+    } else {
+        int name_idx = bc_add_const(p, value_create_string(name));
+        bc_emit_to_function(func, BC_STORE_GLOBAL, name_idx, 0, 0);
+    }
+}
+
+// `let name` in function code: a frame slot, or a binding in the call's own
+// Environment (BC_STORE_GLOBAL with b = 1) so an outer name is shadowed
+// rather than assigned
+static void bc_emit_declare_name(BytecodeProgram* p, BytecodeFunction* func, const char* name) {
+    int slot = bc_function_slot(func, name);
+    if (slot >= 0) {
+        bc_emit_to_function(func, BC_STORE_LOCAL, slot, 0, 0);
+    } else {
+        int name_idx = bc_add_const(p, value_create_string(name));
+        bc_emit_to_function(func, BC_STORE_GLOBAL, name_idx, 1, 0);
+    }
+}
+
+// A frame-slot function whose code only touches its slots, the stack and
+// names it reads can run without an Environment of its own. Anything that
+// binds or writes back names at runtime keeps the per-call Environment.
+static bool bc_function_needs_environment(BytecodeFunction* func) {
+    if (!func->uses_frame_slots) return true;
+    for (size_t i = 0; i < func->code_count; i++) {
+        switch (func->code[i].op) {
+            case BC_LOAD_CONST: case BC_LOAD_LOCAL: case BC_STORE_LOCAL: case BC_LOAD_GLOBAL:
+            case BC_DUP: case BC_POP: case BC_NOT:
+            case BC_ADD: case BC_SUB: case BC_MUL: case BC_DIV: case BC_MOD:
+            case BC_EQ: case BC_NE: case BC_LT: case BC_LE: case BC_GT: case BC_GE:
+            case BC_AND: case BC_OR: case BC_LEFT_SHIFT: case BC_RIGHT_SHIFT:
+            case BC_BITWISE_AND: case BC_BITWISE_OR: case BC_BITWISE_XOR:
+            case BC_JUMP: case BC_JUMP_IF_FALSE: case BC_LOOP_START: case BC_LOOP_END:
+            case BC_BREAK: case BC_CONTINUE: case BC_PUSH_FRAME: case BC_POP_FRAME:
+            case BC_CALL_USER_FUNCTION: case BC_CALL_FUNCTION_VALUE: case BC_METHOD_CALL:
+            case BC_PROPERTY_ACCESS: case BC_ARRAY_GET: case BC_ARRAY_PUSH:
+            case BC_CREATE_ARRAY: case BC_CREATE_MAP: case BC_CREATE_SET:
+            case BC_CREATE_RANGE: case BC_CREATE_RANGE_STEP:
+            case BC_TO_STRING: case BC_GET_TYPE: case BC_PRINT_MULTIPLE:
+                break;
+            case BC_ARRAY_SET:
+                // Only the in-place frame slot form avoids the environment
+                if (func->code[i].b != 2) return true;
+                break;
+            default:
+                return true;
+        }
+    }
+    return false;
+}
+
+// Function code compiles name.push(v) to push and store the result back to
+// name, leaving nothing on the stack; an enclosing name = ... must not store again.
+static int bc_is_push_writeback(ASTNode* value, const char* name) {
+    if (!value || !name || value->type != AST_NODE_FUNCTION_CALL_EXPR) return 0;
+    ASTNode* callee = value->data.function_call_expr.function;
+    if (!callee || callee->type != AST_NODE_MEMBER_ACCESS || value->data.function_call_expr.argument_count != 1) return 0;
+    const char* method_name = callee->data.member_access.member_name;
+    ASTNode* object = callee->data.member_access.object;
+    return method_name && strcmp(method_name, "push") == 0 &&
+           object && object->type == AST_NODE_IDENTIFIER &&
+           object->data.identifier_value && strcmp(object->data.identifier_value, name) == 0;
+}
+
 // Forward declarations
 int bc_compile_ast_to_subprogram(BytecodeProgram* p, ASTNode* node, const char* name);
 static int bc_add_function(BytecodeProgram* p, ASTNode* func);
@@ -651,6 +954,13 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
             bc_emit_to_function(func, BC_LOAD_CONST, const_idx, 0, 0);
         } break;
         case AST_NODE_IDENTIFIER: {
+            // Frame slot locals (parameters and lets) resolved at compile time
+            int slot = bc_function_slot(func, n->data.identifier_value);
+            if (slot >= 0) {
+                bc_emit_to_function(func, BC_LOAD_LOCAL, slot, 0, 0);
+                break;
+            }
+            
             // Check if this is a function parameter
             int param_idx = -1;
             for (size_t i = 0; i < func->param_count; i++) {
@@ -837,14 +1147,16 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
             func->code[jmp_end_pos].a = end_pos;
         } break;
         case AST_NODE_RETURN: {
+            // Frame-slot functions return by popping their call frame
+            BytecodeOp return_op = func->uses_frame_slots ? BC_POP_FRAME : BC_RETURN;
             if (n->data.return_statement.value) {
                 // Compile the return value
                 compile_node_to_function(p, func, n->data.return_statement.value);
                 // Return value is now on the stack
-                bc_emit_to_function(func, (BytecodeOp)BC_RETURN, 1, 0, 0); // Return with value
+                bc_emit_to_function(func, return_op, 1, 0, 0); // Return with value
             } else {
                 // Return without value
-                bc_emit_to_function(func, (BytecodeOp)BC_RETURN, 0, 0, 0); // Return without value
+                bc_emit_to_function(func, return_op, 0, 0, 0); // Return without value
             }
         } break;
         case AST_NODE_BLOCK: {
@@ -922,9 +1234,8 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
                     for (size_t i = 0; i < n->data.function_call.argument_count; i++) {
                         compile_node_to_function(p, func, n->data.function_call.arguments[i]);
                     }
-                    // Load function from global environment
-                    int name_idx = bc_add_const(p, value_create_string(n->data.function_call.function_name));
-                    bc_emit_to_function(func, BC_LOAD_GLOBAL, name_idx, 0, 0);
+                    // Load function from a frame slot or the environment
+                    bc_emit_load_name(p, func, n->data.function_call.function_name);
                     // Call the function value
                     bc_emit_to_function(func, BC_CALL_FUNCTION_VALUE, (int)n->data.function_call.argument_count, 0, 0);
                 }
@@ -955,8 +1266,7 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
                     // Store result back to variable if member access is a simple identifier
                     if (member_access->data.member_access.object->type == AST_NODE_IDENTIFIER) {
                         const char* var_name = member_access->data.member_access.object->data.identifier_value;
-                        int var_name_idx = bc_add_const(p, value_create_string(var_name));
-                        bc_emit_to_function(func, BC_STORE_GLOBAL, var_name_idx, 0, 0);
+                        bc_emit_store_name(p, func, var_name);
                     }
                 } else {
                 // Compile arguments
@@ -984,9 +1294,8 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
                 }
                 // Load function from environment
                 const char* func_name = n->data.function_call_expr.function->data.identifier_value;
-                // Load function from global environment (functions are stored globally)
-                int name_idx = bc_add_const(p, value_create_string(func_name));
-                bc_emit_to_function(func, BC_LOAD_GLOBAL, name_idx, 0, 0);
+                // Load function from a frame slot or the environment (functions are stored globally)
+                bc_emit_load_name(p, func, func_name);
                 // Call the function value
                 bc_emit_to_function(func, BC_CALL_FUNCTION_VALUE, (int)n->data.function_call_expr.argument_count, 0, 0);
             } else {
@@ -1115,6 +1424,15 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
         } break;
         case AST_NODE_ASSIGNMENT: {
             // Assignment: var = value
+            if (!n->data.assignment.target && n->data.assignment.variable_name && n->data.assignment.value) {
+                // Simple assignments carry the name directly (target is NULL)
+                compile_node_to_function(p, func, n->data.assignment.value);
+                // arr = arr.push(v): the push already stored its result back to arr
+                if (!bc_is_push_writeback(n->data.assignment.value, n->data.assignment.variable_name)) {
+                    bc_emit_store_name(p, func, n->data.assignment.variable_name);
+                }
+                break;
+            }
             if (!n->data.assignment.target || !n->data.assignment.value) {
                 // Skip invalid assignments silently - these may be from malformed AST nodes
                 return;
@@ -1132,9 +1450,9 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
             if (n->data.assignment.target->type == AST_NODE_IDENTIFIER) {
                 // Simple variable assignment
                 compile_node_to_function(p, func, n->data.assignment.value);
-                if (n->data.assignment.target->data.identifier_value) {
-                int name_idx = bc_add_const(p, value_create_string(n->data.assignment.target->data.identifier_value));
-                bc_emit_to_function(func, BC_STORE_GLOBAL, name_idx, 0, 0);
+                if (n->data.assignment.target->data.identifier_value &&
+                    !bc_is_push_writeback(n->data.assignment.value, n->data.assignment.target->data.identifier_value)) {
+                    bc_emit_store_name(p, func, n->data.assignment.target->data.identifier_value);
                 }
             } else if (n->data.assignment.target->type == AST_NODE_ARRAY_ACCESS) {
                 // Array element assignment: arr[index] = value
@@ -1385,6 +1703,13 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
                         // BC_PROPERTY_SET consumes [obj, modifiedHashMap] and writes it back
                         fprintf(stderr, "[COMPILER] Emitting BC_PROPERTY_SET to write back to obj.prop in function (prop='%s')\n", prop_name);
                         bc_emit_to_function(func, BC_PROPERTY_SET, prop_name_idx, obj_var_name_idx, is_obj_simple_var ? 1 : 0);
+                    } else if (array_access->data.array_access.array->type == AST_NODE_IDENTIFIER &&
+                               bc_function_slot(func, array_access->data.array_access.array->data.identifier_value) >= 0) {
+                        // name[index] = value on a frame slot: written in place
+                        int slot = bc_function_slot(func, array_access->data.array_access.array->data.identifier_value);
+                        compile_node_to_function(p, func, array_access->data.array_access.index);
+                        compile_node_to_function(p, func, n->data.assignment.value);
+                        bc_emit_to_function(func, BC_ARRAY_SET, slot, 2, 0);
                     } else {
                         // Simple array access: array[index] = value
                 compile_node_to_function(p, func, n->data.assignment.target->data.array_access.array);
@@ -1399,6 +1724,7 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
                     var_name_idx = bc_add_const(p, value_create_string(n->data.assignment.target->data.array_access.array->data.identifier_value));
                 }
                         bc_emit_to_function(func, BC_ARRAY_SET, var_name_idx, is_simple_var ? 1 : 0, 0);
+                        bc_emit_to_function(func, BC_POP, 0, 0, 0); // Drop BC_ARRAY_SET's null
                     }
                 }
             } else if (n->data.assignment.target->type == AST_NODE_MEMBER_ACCESS) {
@@ -1455,8 +1781,7 @@ static void compile_node_to_function(BytecodeProgram* p, BytecodeFunction* func,
                 int null_idx = bc_add_const(p, value_create_null());
                 bc_emit_to_function(func, BC_LOAD_CONST, null_idx, 0, 0);
             }
-            int name_idx = bc_add_const(p, value_create_string(n->data.variable_declaration.variable_name));
-            bc_emit_to_function(func, BC_STORE_GLOBAL, name_idx, 0, 0);
+            bc_emit_declare_name(p, func, n->data.variable_declaration.variable_name);
         } break;
         case AST_NODE_FOR_LOOP: {
             if (n->data.for_loop.is_c_style) {
@@ -1926,15 +2251,31 @@ static int bc_add_function(BytecodeProgram* p, ASTNode* func) {
                 }
             }
         }
+        // Regular functions may keep parameters and lets in frame slots
+        if (func->type == AST_NODE_FUNCTION) {
+            bc_plan_frame_slots(bc_func, body);
+        }
+        
         // CRITICAL: bc_add_function compiles the body to bc_func (the function's own bytecode)
         // This is correct - the body should be compiled to its own function bytecode
         // The body should NOT be compiled to any other function's bytecode
         // The pre-storage mechanism prevents the body from being compiled to the wrong function
         // when the async function/lambda expression is compiled in a hash map literal
+        if (bc_func->uses_frame_slots) {
+            // Prologue reserves the let slots above the arguments
+            bc_emit_to_function(bc_func, BC_PUSH_FRAME, (int)bc_func->local_count, 0, 0);
+        }
         compile_node_to_function(p, bc_func, body);
+        if (bc_func->uses_frame_slots) {
+            // Falling off the end returns Null
+            bc_emit_to_function(bc_func, BC_POP_FRAME, 0, 0, 0);
+        }
         if (bc_func->name && strcmp(bc_func->name, "Client") == 0) {
         }
     }
+    // Nested definitions may have grown the function table during the body compile
+    bc_func = &p->functions[func_id];
+    bc_func->needs_environment = bc_function_needs_environment(bc_func);
     
     return func_id;
 }
@@ -1953,6 +2294,25 @@ BytecodeProgram* bytecode_program_create(void) {
     return p;
 }
 
+static void free_inline_caches(BytecodeProgram* p) {
+    for (size_t i = 0; i < p->inline_cache_capacity; i++) {
+        BytecodeInlineCache* ic = p->inline_caches[i];
+        if (!ic) continue;
+        for (uint32_t j = 0; j < ic->count; j++) {
+            value_free(&ic->methods[j]);
+        }
+        shared_free_safe(ic, "bytecode", "free", 20);
+    }
+    shared_free_safe(p->inline_caches, "bytecode", "free", 21);
+}
+
+static void free_loop_sites(BytecodeProgram* p) {
+    for (size_t i = 0; i < p->loop_site_capacity; i++) {
+        loop_trace_free(p->loop_sites[i].trace);
+    }
+    shared_free_safe(p->loop_sites, "bytecode", "free", 22);
+}
+
 void bytecode_program_free(BytecodeProgram* p) {
     if (!p) return;
     // Free constants
@@ -2005,9 +2365,28 @@ void bytecode_program_free(BytecodeProgram* p) {
                 }
                 shared_free_safe(p->functions[i].param_names, "bytecode", "free", 12);
             }
+            if (p->functions[i].local_names) {
+                for (size_t j = 0; j < p->functions[i].local_count; j++) {
+                    if (p->functions[i].local_names[j]) shared_free_safe(p->functions[i].local_names[j], "bytecode", "free", 16);
+                }
+                shared_free_safe(p->functions[i].local_names, "bytecode", "free", 17);
+            }
+            if (p->functions[i].frame_program) {
+                free_inline_caches(p->functions[i].frame_program);
+                shared_free_safe(p->functions[i].frame_program, "bytecode", "free", 19);
+            }
+            if (p->functions[i].register_program) {
+                register_program_free(p->functions[i].register_program);
+            }
+            shared_free_safe(p->functions[i].type_feedback, "bytecode", "free", 23);
         }
         shared_free_safe(p->functions, "bytecode", "free", 13);
     }
+    // Free resolved local bindings, inline caches, loop traces and type feedback
+    shared_free_safe(p->local_bindings, "bytecode", "free", 18);
+    free_inline_caches(p);
+    free_loop_sites(p);
+    shared_free_safe(p->type_feedback, "bytecode", "free", 24);
     // Free call stack
     shared_free_safe(p->call_stack, "bytecode", "free", 14);
     shared_free_safe(p, "bytecode", "free", 15);
@@ -3189,6 +3568,8 @@ static void compile_node(BytecodeProgram* p, ASTNode* n) {
                 // instr->a = variable name constant index (-1 if complex expression)
                     // instr->b = 1 if simple variable, 0 if complex
                     bc_emit_super(p, BC_ARRAY_SET, var_name_idx, is_simple_var ? 1 : 0, 0);
+                    // Drop the null BC_ARRAY_SET leaves; a loop of writes would otherwise grow the stack
+                    bc_emit(p, BC_POP, 0, 0);
                 }
             } else if (n->data.assignment.target && 
                        n->data.assignment.target->type == AST_NODE_MEMBER_ACCESS) {
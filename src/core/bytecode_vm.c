@@ -14,6 +14,15 @@
 #include "../../include/libs/sets.h"
 #include "../../include/libs/graphics.h"
 #include "../../include/core/optimization/hot_spot_tracker.h"
+#include "../../include/core/optimization/hidden_classes.h"
+#include "../../include/core/optimization/nan_boxing.h"
+#include "../../include/core/optimization/arena_allocator.h"
+#include "../../include/core/optimization/register_vm.h"
+#include "../../include/core/optimization/micro_jit_baseline.h"
+#include "../../include/core/optimization/trace_recorder.h"
+#include "../../include/core/optimization/trace_optimizer.h"
+#include "../../include/core/optimization/type_predictor.h"
+#include "../../include/runtime/reactor.h"
 #include <ctype.h>
 #include <string.h>
 #include <stdio.h>
@@ -47,13 +56,53 @@
 #define CACHE_LINE_SIZE 64
 #define ALIGN_CACHE __attribute__((aligned(CACHE_LINE_SIZE)))
 
+// Longest single sleep while `await` waits on a pending promise
+#define ASYNC_AWAIT_WAIT_MS 50
+
+// Instruction dispatch
+// With GCC/Clang the main loop is direct-threaded: every case label doubles
+// as a computed-goto target, and handlers that cannot raise an error jump
+// straight to the next handler through VM_NEXT instead of returning to the
+// loop head. Handlers that can fail fall back to `break`, which goes through
+// the loop head where pending errors and try-block unwinding are handled.
+// Define MYCO_VM_NO_COMPUTED_GOTO to force the portable switch.
+#if defined(__GNUC__) && !defined(MYCO_VM_NO_COMPUTED_GOTO)
+#define VM_COMPUTED_GOTO 1
+#define VM_CASE(op) case op: vm_op_##op:
+#define VM_DEFAULT  default: vm_op_default:
+#define VM_NEXT() \
+    if (LIKELY(!debug && pc < program->count && (unsigned)program->code[pc].op < BC_OP_COUNT)) { \
+        instr = &program->code[pc]; \
+        vm_instructions_retired++; \
+        VM_TRACE_INSTR(program, pc, instr); \
+        __extension__ ({ goto *vm_dispatch_table[instr->op]; }); \
+    } \
+    break
+#else
+#define VM_COMPUTED_GOTO 0
+#define VM_CASE(op) case op:
+#define VM_DEFAULT  default:
+#define VM_NEXT()   break
+#endif
+
+// Compile-time instruction tracing (build with -DMYCO_VM_TRACE)
+#ifdef MYCO_VM_TRACE
+#define VM_TRACE(...) fprintf(stderr, __VA_ARGS__)
+#define VM_TRACE_INSTR(program, pc, instr) \
+    fprintf(stderr, "[VM] %p pc=%zu op=%d a=%d b=%d c=%d\n", (void*)(program), (pc), \
+            (int)(instr)->op, (instr)->a, (instr)->b, (instr)->c)
+#else
+#define VM_TRACE(...) ((void)0)
+#define VM_TRACE_INSTR(program, pc, instr) ((void)0)
+#endif
+
 // Forward declarations
 Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunction* func, Value* args, int arg_count, BytecodeProgram* program);
 static int pattern_matches_value(Value* value, Value* pattern);
 
 // Async/await runtime functions
 static void async_task_queue_add(Interpreter* interpreter, AsyncTask* task);
-static AsyncTask* async_task_queue_pop(Interpreter* interpreter);
+static void async_task_run(void* context, SchedulerTask* scheduled);
 static void async_resolve_promise(Interpreter* interpreter, Value* promise, Value* value);
 static void async_reject_promise(Interpreter* interpreter, Value* promise, Value* error);
 void async_event_loop_run(Interpreter* interpreter);
@@ -83,9 +132,9 @@ typedef struct {
     size_t length;
 } StringBuffer;
 
-// Memory optimization globals
-static InlineStack* inline_stack = NULL;
-static StringBuffer* string_buffer = NULL;
+// Memory optimization globals (per thread, like the rest of the VM state)
+static MYCO_THREAD_LOCAL InlineStack* inline_stack = NULL;
+static MYCO_THREAD_LOCAL StringBuffer* string_buffer = NULL;
 
 // Memory optimization helper functions
 static void init_memory_optimizations(void) {
@@ -312,7 +361,7 @@ typedef struct {
     size_t capacity;
 } StringInternTable;
 
-static StringInternTable* string_intern_table = NULL;
+static MYCO_THREAD_LOCAL StringInternTable* string_intern_table = NULL;
 
 static const char* intern_string(const char* str) {
     if (!str) return NULL;
@@ -361,7 +410,7 @@ typedef struct {
     size_t capacity;
 } BytecodeValueCache;
 
-static BytecodeValueCache* value_cache = NULL;
+static MYCO_THREAD_LOCAL BytecodeValueCache* value_cache = NULL;
 
 static Value* get_cached_value(ValueType type, void* data) {
     if (!value_cache) {
@@ -518,29 +567,60 @@ Value interpreter_execute_bytecode(Interpreter* interpreter, BytecodeProgram* by
 // Bytecode VM implementation
 // This implements a stack-based virtual machine for executing Myco bytecode
 
-// Stack operations
-static Value* value_stack = NULL;
-size_t value_stack_size = 0;  // Made non-static for debugging
-size_t value_stack_capacity = 0;  // Made non-static for debugging
+// Stack operations. Operands and frame slots are NaN-boxed words: numbers,
+// booleans and null are stored inline and everything else lives in a heap
+// cell (see optimization/nan_boxing.h). value_stack_push/pop convert at the
+// boundary; hot opcodes work on the words directly.
+//
+// All of this is thread-local: every thread that runs bytecode (the main
+// thread, server handler threads, isolate workers) gets its own execution
+// context, so separate interpreters can run in parallel.
+static MYCO_THREAD_LOCAL NanBoxedValue* value_stack = NULL;
+MYCO_THREAD_LOCAL size_t value_stack_size = 0;  // Made non-static for debugging
+MYCO_THREAD_LOCAL size_t value_stack_capacity = 0;  // Made non-static for debugging
 
-static double* num_stack = NULL;
-static size_t num_stack_size = 0;
-static size_t num_stack_capacity = 0;
+static MYCO_THREAD_LOCAL double* num_stack = NULL;
+static MYCO_THREAD_LOCAL size_t num_stack_size = 0;
+static MYCO_THREAD_LOCAL size_t num_stack_capacity = 0;
+
+// Nesting depth of bytecode_run; only the outermost run owns the stacks
+static MYCO_THREAD_LOCAL int vm_run_depth = 0;
+
+// Instructions dispatched by bytecode_run on this thread, reported by --vm-stats
+static MYCO_THREAD_LOCAL unsigned long long vm_instructions_retired = 0;
+
+unsigned long long bytecode_vm_instruction_count(void) {
+    return vm_instructions_retired;
+}
+
+const char* bytecode_vm_dispatch_mode(void) {
+    return VM_COMPUTED_GOTO ? "computed-goto" : "switch";
+}
 
 // Forward declarations
 static Value value_stack_pop(void);
+static Value bytecode_run(BytecodeProgram* program, Interpreter* interpreter, int debug, const BytecodeCallFrame* frame);
+static Value bc_call_frame(Interpreter* interpreter, BytecodeProgram* owner, BytecodeFunction* func, int arg_count);
+static RegisterProgram* bc_tier_up(Interpreter* interpreter, BytecodeProgram* owner, BytecodeFunction* func);
+static size_t bc_loop_trace_enter(Interpreter* interpreter, BytecodeProgram* program, size_t pc);
+static Value bc_run_register_frame(Interpreter* interpreter, BytecodeProgram* owner, RegisterProgram* code,
+                                   size_t frame_base, size_t entry);
 static double num_stack_pop(void);
 
 // Stack management functions
+// Release stack entries above size
+static void value_stack_drop_to(size_t size) {
+    while (value_stack_size > size) {
+        nan_boxing_release(value_stack[--value_stack_size]);
+    }
+}
+
 static void value_stack_push(Value v) {
     // Prevent stack from growing too large (safety limit)
     if (value_stack_size > 100000) {
         // Stack too large - likely infinite loop or unbalanced push/pop
         // Pop some values to prevent memory exhaustion
-        while (value_stack_size > 50000) {
-            Value val = value_stack_pop();
-            value_free(&val);
-        }
+        value_stack_drop_to(50000);
     }
     if (value_stack_size + 1 > value_stack_capacity) {
         size_t new_cap = value_stack_capacity ? value_stack_capacity * 2 : 128;
@@ -548,10 +628,10 @@ static void value_stack_push(Value v) {
         if (new_cap > 200000) {
             new_cap = 200000;
         }
-        value_stack = shared_realloc_safe(value_stack, new_cap * sizeof(Value), "bytecode_vm", "value_stack_push", 1);
+        value_stack = shared_realloc_safe(value_stack, new_cap * sizeof(NanBoxedValue), "bytecode_vm", "value_stack_push", 1);
         value_stack_capacity = new_cap;
     }
-    value_stack[value_stack_size] = v;
+    value_stack[value_stack_size] = nan_boxing_box(v);
     value_stack_size++;
 }
 
@@ -560,14 +640,41 @@ static Value value_stack_pop(void) {
         return value_create_null();
     }
     value_stack_size--;
-    return value_stack[value_stack_size];
+    return nan_boxing_unbox(value_stack[value_stack_size]);
 }
 
+// Borrowed view of the top of the stack (do not free)
 static Value value_stack_peek(void) {
     if (value_stack_size == 0) {
         return value_create_null();
     }
-    return value_stack[value_stack_size - 1];
+    return nan_boxing_peek(value_stack[value_stack_size - 1]);
+}
+
+// Word-level access for opcodes that never need a full Value
+static inline void value_stack_push_word(NanBoxedValue w) {
+    if (LIKELY(value_stack_size < value_stack_capacity)) {
+        value_stack[value_stack_size++] = w;
+    } else {
+        value_stack_push(nan_boxing_unbox(w));
+    }
+}
+
+// Both operands of a binary opcode when they are numbers on the stack
+static inline int value_stack_numeric_pair(double* a, double* b) {
+    if (value_stack_size < 2) return 0;
+    NanBoxedValue wa = value_stack[value_stack_size - 2];
+    NanBoxedValue wb = value_stack[value_stack_size - 1];
+    if (!nan_boxing_is_number(wa) || !nan_boxing_is_number(wb)) return 0;
+    *a = nan_boxing_get_number(wa);
+    *b = nan_boxing_get_number(wb);
+    return 1;
+}
+
+// Replace the two operands of a binary opcode with its result
+static inline void value_stack_replace_pair(NanBoxedValue result) {
+    value_stack_size--;
+    value_stack[value_stack_size - 1] = result;
 }
 
 static void num_stack_push(double v) {
@@ -611,149 +718,201 @@ static double num_stack_peek(void) {
 // ASYNC/AWAIT RUNTIME FUNCTIONS
 // ============================================================================
 
-static uint64_t promise_registry_add(Interpreter* interpreter, Value promise) {
-    if (!interpreter) return 0;
-    
-    // Initialize registry if needed
-    if (!interpreter->promise_registry) {
-        interpreter->promise_registry_capacity = 16;
-        interpreter->promise_registry = (Value*)shared_malloc_safe(
-            interpreter->promise_registry_capacity * sizeof(Value),
-            "bytecode_vm", "promise_registry_add", 0);
-        interpreter->promise_registry_size = 0;
+// Promise registry: IDs hash to one of a fixed set of shards, each a chained
+// hash table under its own lock, so threads creating and settling promises
+// rarely contend. Entries never move once added, so the Value* returned by
+// promise_registry_get stays valid until the promise is removed.
+
+#define PROMISE_REGISTRY_SHARDS 16  // Power of two
+#define PROMISE_REGISTRY_INITIAL_BUCKETS 16
+
+typedef struct PromiseEntry {
+    Value promise;  // First member: lookups hand out &entry->promise
+    struct PromiseEntry* next;
+} PromiseEntry;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    PromiseEntry** buckets;
+    size_t bucket_count;  // Power of two (0 until the first add)
+    size_t count;
+} PromiseRegistryShard;
+
+struct PromiseRegistry {
+    PromiseRegistryShard shards[PROMISE_REGISTRY_SHARDS];
+};
+
+// IDs are sequential: the low bits pick the shard, the next bits the bucket
+static PromiseRegistryShard* promise_registry_shard(struct PromiseRegistry* registry, uint64_t id) {
+    return &registry->shards[id & (PROMISE_REGISTRY_SHARDS - 1)];
+}
+
+static size_t promise_registry_bucket(size_t bucket_count, uint64_t id) {
+    return (size_t)(id / PROMISE_REGISTRY_SHARDS) & (bucket_count - 1);
+}
+
+// Created on first use; any thread may get here first
+static struct PromiseRegistry* promise_registry_instance(Interpreter* interpreter) {
+    struct PromiseRegistry* registry = __atomic_load_n(&interpreter->promise_registry, __ATOMIC_ACQUIRE);
+    if (registry) return registry;
+    
+    registry = calloc(1, sizeof(struct PromiseRegistry));
+    if (!registry) return NULL;
+    for (size_t i = 0; i < PROMISE_REGISTRY_SHARDS; i++) {
+        pthread_mutex_init(&registry->shards[i].mutex, NULL);
     }
-    
-    // Expand registry if needed
-    if (interpreter->promise_registry_size >= interpreter->promise_registry_capacity) {
-        size_t new_cap = interpreter->promise_registry_capacity * 2;
-        interpreter->promise_registry = (Value*)shared_realloc_safe(
-            interpreter->promise_registry,
-            new_cap * sizeof(Value),
-            "bytecode_vm", "promise_registry_add", 1);
-        interpreter->promise_registry_capacity = new_cap;
+    struct PromiseRegistry* expected = NULL;
+    if (!__atomic_compare_exchange_n(&interpreter->promise_registry, &expected, registry, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        for (size_t i = 0; i < PROMISE_REGISTRY_SHARDS; i++) {
+            pthread_mutex_destroy(&registry->shards[i].mutex);
+        }
+        free(registry);
+        return expected;
     }
+    return registry;
+}
+
+// Double the bucket array (caller holds the shard lock)
+static bool promise_registry_grow(PromiseRegistryShard* shard) {
+    size_t new_count = shard->bucket_count ? shard->bucket_count * 2 : PROMISE_REGISTRY_INITIAL_BUCKETS;
+    PromiseEntry** buckets = calloc(new_count, sizeof(PromiseEntry*));
+    if (!buckets) return shard->bucket_count > 0;
+    
+    for (size_t i = 0; i < shard->bucket_count; i++) {
+        PromiseEntry* entry = shard->buckets[i];
+        while (entry) {
+            PromiseEntry* next = entry->next;
+            size_t bucket = promise_registry_bucket(new_count, entry->promise.data.promise_value.promise_id);
+            entry->next = buckets[bucket];
+            buckets[bucket] = entry;
+            entry = next;
+        }
+    }
+    free(shard->buckets);
+    shard->buckets = buckets;
+    shard->bucket_count = new_count;
+    return true;
+}
+
+static uint64_t promise_registry_add(Interpreter* interpreter, Value promise) {
+    if (!interpreter) return 0;
+    struct PromiseRegistry* registry = promise_registry_instance(interpreter);
+    if (!registry) return 0;
     
-    // Assign ID and add to registry
-    uint64_t id = interpreter->next_promise_id++;
+    PromiseEntry* entry = malloc(sizeof(PromiseEntry));
+    if (!entry) return 0;
+    uint64_t id = __atomic_fetch_add(&interpreter->next_promise_id, 1, __ATOMIC_RELAXED);
     promise.data.promise_value.promise_id = id;
-    interpreter->promise_registry[interpreter->promise_registry_size++] = promise;
+    entry->promise = promise;
+    
+    PromiseRegistryShard* shard = promise_registry_shard(registry, id);
+    pthread_mutex_lock(&shard->mutex);
+    if (shard->count >= shard->bucket_count && !promise_registry_grow(shard)) {
+        pthread_mutex_unlock(&shard->mutex);
+        free(entry);
+        return 0;
+    }
+    size_t bucket = promise_registry_bucket(shard->bucket_count, id);
+    entry->next = shard->buckets[bucket];
+    shard->buckets[bucket] = entry;
+    shard->count++;
+    pthread_mutex_unlock(&shard->mutex);
     
     return id;
 }
 
 static Value* promise_registry_get(Interpreter* interpreter, uint64_t promise_id) {
     if (!interpreter || promise_id == 0) return NULL;
-    if (!interpreter->promise_registry || interpreter->promise_registry_size == 0) return NULL;
+    struct PromiseRegistry* registry = __atomic_load_n(&interpreter->promise_registry, __ATOMIC_ACQUIRE);
+    if (!registry) return NULL;
     
-    // Linear search for the promise (could be optimized with a hash map)
-    for (size_t i = 0; i < interpreter->promise_registry_size; i++) {
-        if (interpreter->promise_registry[i].type == VALUE_PROMISE &&
-            interpreter->promise_registry[i].data.promise_value.promise_id == promise_id) {
-            return &interpreter->promise_registry[i];
+    PromiseRegistryShard* shard = promise_registry_shard(registry, promise_id);
+    Value* found = NULL;
+    pthread_mutex_lock(&shard->mutex);
+    if (shard->bucket_count > 0) {
+        PromiseEntry* entry = shard->buckets[promise_registry_bucket(shard->bucket_count, promise_id)];
+        for (; entry; entry = entry->next) {
+            if (entry->promise.data.promise_value.promise_id == promise_id) {
+                found = &entry->promise;
+                break;
+            }
         }
     }
-    
-    return NULL;
+    pthread_mutex_unlock(&shard->mutex);
+    return found;
 }
 
 static void promise_registry_remove(Interpreter* interpreter, uint64_t promise_id) {
     if (!interpreter || promise_id == 0) return;
-    if (!interpreter->promise_registry || interpreter->promise_registry_size == 0) return;
+    struct PromiseRegistry* registry = __atomic_load_n(&interpreter->promise_registry, __ATOMIC_ACQUIRE);
+    if (!registry) return;
     
-    // Find and remove the promise
-    for (size_t i = 0; i < interpreter->promise_registry_size; i++) {
-        if (interpreter->promise_registry[i].type == VALUE_PROMISE &&
-            interpreter->promise_registry[i].data.promise_value.promise_id == promise_id) {
-            // Free the promise
-            value_free(&interpreter->promise_registry[i]);
-            
-            // Shift remaining promises
-            for (size_t j = i + 1; j < interpreter->promise_registry_size; j++) {
-                interpreter->promise_registry[j - 1] = interpreter->promise_registry[j];
+    PromiseRegistryShard* shard = promise_registry_shard(registry, promise_id);
+    PromiseEntry* removed = NULL;
+    pthread_mutex_lock(&shard->mutex);
+    if (shard->bucket_count > 0) {
+        PromiseEntry** link = &shard->buckets[promise_registry_bucket(shard->bucket_count, promise_id)];
+        for (; *link; link = &(*link)->next) {
+            if ((*link)->promise.data.promise_value.promise_id == promise_id) {
+                removed = *link;
+                *link = removed->next;
+                shard->count--;
+                break;
             }
-            interpreter->promise_registry_size--;
-            break;
         }
     }
-}
-
-static void async_task_queue_add(Interpreter* interpreter, AsyncTask* task) {
-    if (!interpreter || !task) return;
-    
-    // Lock mutex for thread-safe access
-    if (interpreter->async_enabled && interpreter->worker_thread_count > 0) {
-        pthread_mutex_lock(&interpreter->task_queue_mutex);
-    }
+    pthread_mutex_unlock(&shard->mutex);
     
-    // Initialize queue if needed
-    if (!interpreter->task_queue) {
-        interpreter->task_queue_capacity = 16;
-        interpreter->task_queue = (AsyncTask**)shared_malloc_safe(
-            interpreter->task_queue_capacity * sizeof(AsyncTask*), 
-            "bytecode_vm", "async_task_queue_add", 0);
-        interpreter->task_queue_size = 0;
-    }
-    
-    // Expand queue if needed
-    if (interpreter->task_queue_size >= interpreter->task_queue_capacity) {
-        size_t new_cap = interpreter->task_queue_capacity * 2;
-        interpreter->task_queue = (AsyncTask**)shared_realloc_safe(
-            interpreter->task_queue,
-            new_cap * sizeof(AsyncTask*),
-            "bytecode_vm", "async_task_queue_add", 1);
-        interpreter->task_queue_capacity = new_cap;
-    }
-    
-    interpreter->task_queue[interpreter->task_queue_size++] = task;
-    
-    // Signal worker threads that a task is available
-    if (interpreter->async_enabled && interpreter->worker_thread_count > 0) {
-        pthread_cond_signal(&interpreter->task_available);
-        pthread_mutex_unlock(&interpreter->task_queue_mutex);
+    if (removed) {
+        value_free(&removed->promise);
+        free(removed);
     }
 }
 
-static AsyncTask* async_task_queue_pop(Interpreter* interpreter) {
-    if (!interpreter) return NULL;
-    
-    // Lock mutex for thread-safe access
-    if (interpreter->async_enabled && interpreter->worker_thread_count > 0) {
-        pthread_mutex_lock(&interpreter->task_queue_mutex);
+// The scheduler is created on first use. It never starts workers: tasks
+// share the interpreter's heap and environments (copy-on-write reference
+// counts, current_environment), so they run on whichever thread drives the
+// event loop. Parallel work goes to isolates (libs/isolate.c), which own
+// their heap and use a pool of their own.
+static Scheduler* async_scheduler(Interpreter* interpreter) {
+    Scheduler* scheduler = __atomic_load_n(&interpreter->scheduler, __ATOMIC_ACQUIRE);
+    if (scheduler) return scheduler;
+    
+    scheduler = scheduler_create(async_task_run, interpreter);
+    if (!scheduler) return NULL;
+    Scheduler* expected = NULL;
+    if (!__atomic_compare_exchange_n(&interpreter->scheduler, &expected, scheduler, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        scheduler_destroy(scheduler);
+        return expected;
     }
+    return scheduler;
+}
+
+static void async_task_queue_add(Interpreter* interpreter, AsyncTask* task) {
+    if (!interpreter || !task) return;
     
-    if (!interpreter->task_queue || interpreter->task_queue_size == 0) {
-        if (interpreter->async_enabled && interpreter->worker_thread_count > 0) {
-            pthread_mutex_unlock(&interpreter->task_queue_mutex);
-        }
-        return NULL;
-    }
-    
-    AsyncTask* task = interpreter->task_queue[0];
-    
-    // Shift remaining tasks
-    for (size_t i = 1; i < interpreter->task_queue_size; i++) {
-        interpreter->task_queue[i - 1] = interpreter->task_queue[i];
-    }
-    interpreter->task_queue_size--;
-    
-    if (interpreter->async_enabled && interpreter->worker_thread_count > 0) {
-        pthread_mutex_unlock(&interpreter->task_queue_mutex);
+    Scheduler* scheduler = async_scheduler(interpreter);
+    if (!scheduler) {
+        // No pool to queue on: run it now
+        async_task_run(interpreter, &task->sched);
+        return;
     }
+    scheduler_submit(scheduler, &task->sched);
     
-    return task;
+    // Submitted from a server thread, the event loop may be parked
+    reactor_wake();
 }
 
 static void async_resolve_promise(Interpreter* interpreter, Value* promise, Value* value) {
     if (!promise || promise->type != VALUE_PROMISE) return;
     
     // Lock promise registry mutex for thread-safe access
-    if (interpreter && interpreter->async_enabled && interpreter->worker_thread_count > 0) {
+    if (interpreter) {
         pthread_mutex_lock(&interpreter->promise_registry_mutex);
     }
     
-    promise->data.promise_value.is_resolved = 1;
-    promise->data.promise_value.is_rejected = 0;
-    
     // Free old resolved value if it exists
     if (promise->data.promise_value.resolved_value) {
         value_free(promise->data.promise_value.resolved_value);
@@ -777,10 +936,17 @@ static void async_resolve_promise(Interpreter* interpreter, Value* promise, Valu
         promise->data.promise_value.resolved_value = NULL;
     }
     
-    if (interpreter && interpreter->async_enabled && interpreter->worker_thread_count > 0) {
+    // Publish the state last: awaiting threads poll it without the mutex
+    __atomic_store_n(&promise->data.promise_value.is_rejected, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&promise->data.promise_value.is_resolved, 1, __ATOMIC_RELEASE);
+    
+    if (interpreter) {
         pthread_mutex_unlock(&interpreter->promise_registry_mutex);
     }
     
+    // Let an event loop blocked in the reactor see the settled promise
+    reactor_wake();
+    
     // Execute then callbacks (simplified - just process immediately)
     // TODO: Add proper callback execution
 }
@@ -789,13 +955,10 @@ static void async_reject_promise(Interpreter* interpreter, Value* promise, Value
     if (!promise || promise->type != VALUE_PROMISE) return;
     
     // Lock promise registry mutex for thread-safe access
-    if (interpreter && interpreter->async_enabled && interpreter->worker_thread_count > 0) {
+    if (interpreter) {
         pthread_mutex_lock(&interpreter->promise_registry_mutex);
     }
     
-    promise->data.promise_value.is_resolved = 0;
-    promise->data.promise_value.is_rejected = 1;
-    
     if (promise->data.promise_value.rejected_value) {
         value_free(promise->data.promise_value.rejected_value);
         shared_free_safe(promise->data.promise_value.rejected_value, "bytecode_vm", "async_reject_promise", 0);
@@ -806,399 +969,324 @@ static void async_reject_promise(Interpreter* interpreter, Value* promise, Value
         *promise->data.promise_value.rejected_value = value_clone(error);
     }
     
-    if (interpreter && interpreter->async_enabled && interpreter->worker_thread_count > 0) {
+    __atomic_store_n(&promise->data.promise_value.is_resolved, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&promise->data.promise_value.is_rejected, 1, __ATOMIC_RELEASE);
+    
+    if (interpreter) {
         pthread_mutex_unlock(&interpreter->promise_registry_mutex);
     }
     
+    reactor_wake();
+    
     // Execute catch callbacks (simplified - just process immediately)
     // TODO: Add proper callback execution
 }
 
-// Worker thread function for concurrent task execution
-static void* async_worker_thread(void* arg) {
-    Interpreter* interpreter = (Interpreter*)arg;
-    if (!interpreter) return NULL;
-    
-    while (!interpreter->shutdown_workers) {
-        AsyncTask* task = NULL;
-        
-        // Lock mutex and wait for tasks
-        pthread_mutex_lock(&interpreter->task_queue_mutex);
-        
-        // Wait for tasks or shutdown signal
-        while (interpreter->task_queue_size == 0 && !interpreter->shutdown_workers) {
-            pthread_cond_wait(&interpreter->task_available, &interpreter->task_queue_mutex);
-        }
-        
-        // Check if we should shutdown
-        if (interpreter->shutdown_workers) {
-            pthread_mutex_unlock(&interpreter->task_queue_mutex);
-            break;
+// Promises settled by library code rather than by a VM task, e.g. network
+// I/O that the event loop drives to completion
+Value async_promise_create(Interpreter* interpreter, uint64_t* promise_id) {
+    *promise_id = 0;
+    uint64_t id = promise_registry_add(interpreter, value_create_pending_promise());
+    Value* registry_promise = promise_registry_get(interpreter, id);
+    if (!registry_promise) {
+        return value_create_null();
+    }
+    *promise_id = id;
+    Value result = *registry_promise;
+    result.data.promise_value.promise_id = id;
+    return result;
+}
+
+void async_promise_settle(Interpreter* interpreter, uint64_t promise_id, Value* value, int rejected) {
+    Value* promise = promise_registry_get(interpreter, promise_id);
+    if (!promise) return;
+    if (rejected) {
+        async_reject_promise(interpreter, promise, value);
+    } else {
+        async_resolve_promise(interpreter, promise, value);
+    }
+}
+
+// Free a task once it has run (or will never run)
+static void async_task_free(AsyncTask* task) {
+    if (task->args) {
+        for (size_t i = 0; i < task->arg_count; i++) {
+            value_free(&task->args[i]);
         }
-        
-        // Pop a task
-        if (interpreter->task_queue && interpreter->task_queue_size > 0) {
-            task = interpreter->task_queue[0];
-            // Shift remaining tasks
-            for (size_t i = 1; i < interpreter->task_queue_size; i++) {
-                interpreter->task_queue[i - 1] = interpreter->task_queue[i];
-            }
-            interpreter->task_queue_size--;
+        shared_free_safe(task->args, "bytecode_vm", "async_task_free", 0);
+    }
+    value_free(&task->promise_copy);
+    value_free(&task->result);
+    shared_free_safe(task, "bytecode_vm", "async_task_free", 1);
+}
+
+// Run one async task and settle its promise. Called by the scheduler on the
+// thread running the event loop.
+static void async_task_run(void* context, SchedulerTask* scheduled) {
+    Interpreter* interpreter = (Interpreter*)context;
+    AsyncTask* task = (AsyncTask*)scheduled;
+    
+    if (task->is_resolved) {
+        // Task already completed - resolve promise
+        if (task->promise_ptr && task->promise_ptr->type == VALUE_PROMISE) {
+            async_resolve_promise(interpreter, task->promise_ptr, &task->result);
         }
-        
-        pthread_mutex_unlock(&interpreter->task_queue_mutex);
-        
-        if (!task) continue;
-        
-        // Execute task (outside of mutex lock)
-        if (task->is_resolved) {
-            // Task already completed - resolve promise
-            if (task->promise_ptr && task->promise_ptr->type == VALUE_PROMISE) {
-                async_resolve_promise(interpreter, task->promise_ptr, &task->result);
-            }
-        } else {
-            // Execute task
-            BytecodeProgram* program = (BytecodeProgram*)task->program;
-            if (program && task->function_id >= 0 && task->function_id < (int)program->function_count && program->functions) {
-                BytecodeFunction* func = &program->functions[task->function_id];
-                
-                // Create a local interpreter context for this thread
-                // Note: We need to be careful about shared state
-                Environment* old_env = interpreter->current_environment;
-                // Use task->environment if available, otherwise create an environment that inherits from global
-                // This ensures async functions have access to global modules like 'gateway'
-                Environment* async_env = task->environment;
-                if (!async_env) {
-                    // Create environment that inherits from global to access modules
-                    async_env = environment_create(interpreter->global_environment);
-                } else {
-                    // Check if the captured environment has __module_path__ to access module environment
-                    // If so, we need to ensure the module environment is in the parent chain
-                    // Also check if the async function itself has __module_path__ in its captured environment
-                    Value module_path_val = environment_get(async_env, "__module_path__");
-                    // If not found in async_env, check the function's captured environment
-                    if (module_path_val.type != VALUE_STRING && func && program) {
-                        // Try to get module path from the function's captured environment
-                        // For bytecode functions, we need to check if there's a way to get the captured environment
-                        // For now, try to find the module by checking the program's file path or module cache
-                        // The program might be from a module - check module cache for matching bytecode program
-                        if (interpreter && interpreter->module_cache) {
-                            for (size_t i = 0; i < interpreter->module_cache_count; i++) {
-                                if (interpreter->module_cache[i].is_valid && 
-                                    interpreter->module_cache[i].module_bytecode_program == program) {
-                                    // Found the module - use its environment
-                                    if (interpreter->module_cache[i].module_env) {
-                                        // Check if module environment is already in the chain
-                                        Environment* check_env = async_env;
-                                        bool has_module_in_chain = false;
-                                        while (check_env) {
-                                            if (check_env == interpreter->module_cache[i].module_env) {
-                                                has_module_in_chain = true;
-                                                break;
-                                            }
-                                            check_env = check_env->parent;
+    } else {
+        // Execute task
+        BytecodeProgram* program = (BytecodeProgram*)task->program;
+        if (program && task->function_id >= 0 && task->function_id < (int)program->function_count && program->functions) {
+            BytecodeFunction* func = &program->functions[task->function_id];
+            
+            // Create a local interpreter context for this thread
+            // Note: We need to be careful about shared state
+            Environment* old_env = interpreter->current_environment;
+            // Use task->environment if available, otherwise create an environment that inherits from global
+            // This ensures async functions have access to global modules like 'gateway'
+            Environment* async_env = task->environment;
+            if (!async_env) {
+                // Create environment that inherits from global to access modules
+                async_env = environment_create(interpreter->global_environment);
+            } else {
+                // Check if the captured environment has __module_path__ to access module environment
+                // If so, we need to ensure the module environment is in the parent chain
+                // Also check if the async function itself has __module_path__ in its captured environment
+                Value module_path_val = environment_get(async_env, "__module_path__");
+                // If not found in async_env, check the function's captured environment
+                if (module_path_val.type != VALUE_STRING && func && program) {
+                    // Try to get module path from the function's captured environment
+                    // For bytecode functions, we need to check if there's a way to get the captured environment
+                    // For now, try to find the module by checking the program's file path or module cache
+                    // The program might be from a module - check module cache for matching bytecode program
+                    if (interpreter && interpreter->module_cache) {
+                        for (size_t i = 0; i < interpreter->module_cache_count; i++) {
+                            if (interpreter->module_cache[i].is_valid && 
+                                interpreter->module_cache[i].module_bytecode_program == program) {
+                                // Found the module - use its environment
+                                if (interpreter->module_cache[i].module_env) {
+                                    // Check if module environment is already in the chain
+                                    Environment* check_env = async_env;
+                                    bool has_module_in_chain = false;
+                                    while (check_env) {
+                                        if (check_env == interpreter->module_cache[i].module_env) {
+                                            has_module_in_chain = true;
+                                            break;
                                         }
-                                        // If module environment is not in chain, create new environment with module as parent
-                                        if (!has_module_in_chain) {
-                                            Environment* new_async_env = environment_create(interpreter->module_cache[i].module_env);
-                                            // Copy values from old async_env to new_async_env (like "self")
-                                            if (new_async_env && async_env) {
-                                                for (size_t j = 0; j < async_env->count; j++) {
-                                                    if (async_env->names[j]) {
-                                                        Value val = environment_get(async_env, async_env->names[j]);
-                                                        if (val.type != VALUE_NULL) {
-                                                            environment_define(new_async_env, async_env->names[j], value_clone(&val));
-                                                            value_free(&val);
-                                                        }
+                                        check_env = check_env->parent;
+                                    }
+                                    // If module environment is not in chain, create new environment with module as parent
+                                    if (!has_module_in_chain) {
+                                        Environment* new_async_env = environment_create(interpreter->module_cache[i].module_env);
+                                        // Copy values from old async_env to new_async_env (like "self")
+                                        if (new_async_env && async_env) {
+                                            for (size_t j = 0; j < async_env->count; j++) {
+                                                if (async_env->names[j]) {
+                                                    Value val = environment_get(async_env, async_env->names[j]);
+                                                    if (val.type != VALUE_NULL) {
+                                                        environment_define(new_async_env, async_env->names[j], value_clone(&val));
+                                                        value_free(&val);
                                                     }
                                                 }
                                             }
-                                            async_env = new_async_env;
                                         }
+                                        async_env = new_async_env;
                                     }
-                                    break;
                                 }
+                                break;
                             }
                         }
-                    } else if (module_path_val.type == VALUE_STRING && module_path_val.data.string_value && interpreter && interpreter->module_cache) {
-                        // Find module in cache to get module environment
-                        ModuleCacheEntry* module_entry = find_cached_module(interpreter, module_path_val.data.string_value);
-                        if (module_entry && module_entry->is_valid && module_entry->module_env) {
-                            // Ensure the async environment has the module environment in its parent chain
-                            // Check if module environment is already in the chain
-                            Environment* check_env = async_env;
-                            bool has_module_in_chain = false;
-                            while (check_env) {
-                                if (check_env == module_entry->module_env) {
-                                    has_module_in_chain = true;
-                                    break;
-                                }
-                                check_env = check_env->parent;
+                    }
+                } else if (module_path_val.type == VALUE_STRING && module_path_val.data.string_value && interpreter && interpreter->module_cache) {
+                    // Find module in cache to get module environment
+                    ModuleCacheEntry* module_entry = find_cached_module(interpreter, module_path_val.data.string_value);
+                    if (module_entry && module_entry->is_valid && module_entry->module_env) {
+                        // Ensure the async environment has the module environment in its parent chain
+                        // Check if module environment is already in the chain
+                        Environment* check_env = async_env;
+                        bool has_module_in_chain = false;
+                        while (check_env) {
+                            if (check_env == module_entry->module_env) {
+                                has_module_in_chain = true;
+                                break;
                             }
-                            // If module environment is not in chain, we need to add it
-                            // For now, create a new environment that inherits from module environment
-                            // and has the async environment's values
-                            if (!has_module_in_chain) {
-                                // Create new environment with module environment as parent
-                                Environment* new_async_env = environment_create(module_entry->module_env);
-                                // Copy values from old async_env to new_async_env (like "self")
-                                if (new_async_env && async_env) {
-                                    for (size_t i = 0; i < async_env->count; i++) {
-                                        if (async_env->names[i]) {
-                                            Value val = environment_get(async_env, async_env->names[i]);
-                                            if (val.type != VALUE_NULL) {
-                                                environment_define(new_async_env, async_env->names[i], value_clone(&val));
-                                                value_free(&val);
-                                            }
+                            check_env = check_env->parent;
+                        }
+                        // If module environment is not in chain, we need to add it
+                        // For now, create a new environment that inherits from module environment
+                        // and has the async environment's values
+                        if (!has_module_in_chain) {
+                            // Create new environment with module environment as parent
+                            Environment* new_async_env = environment_create(module_entry->module_env);
+                            // Copy values from old async_env to new_async_env (like "self")
+                            if (new_async_env && async_env) {
+                                for (size_t i = 0; i < async_env->count; i++) {
+                                    if (async_env->names[i]) {
+                                        Value val = environment_get(async_env, async_env->names[i]);
+                                        if (val.type != VALUE_NULL) {
+                                            environment_define(new_async_env, async_env->names[i], value_clone(&val));
+                                            value_free(&val);
                                         }
                                     }
                                 }
-                                async_env = new_async_env;
                             }
+                            async_env = new_async_env;
                         }
                     }
-                    value_free(&module_path_val);
-                }
-                interpreter->current_environment = async_env;
-                
-                // Execute function
-                Value result = bytecode_execute_function_bytecode(
-                    interpreter, func, task->args, (int)task->arg_count, program);
-                
-                // Handle return value
-                if (result.type == VALUE_NULL) {
-                    if (interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
-                        result = value_clone(&interpreter->return_value);
-                        interpreter->has_return = 0;
-                        value_free(&interpreter->return_value);
-                        interpreter->return_value = value_create_null();
-                    }
                 }
-                
-                // Restore environment
-                interpreter->current_environment = old_env;
-                
-                // Resolve promise
-                Value result_to_resolve = value_clone(&result);
-                task->result = value_clone(&result);
-                task->is_resolved = 1;
-                if (task->promise_ptr && task->promise_ptr->type == VALUE_PROMISE) {
-                    async_resolve_promise(interpreter, task->promise_ptr, &result_to_resolve);
-                }
-                value_free(&result);
-                value_free(&result_to_resolve);
-            } else {
-                // Invalid task - reject promise
-                Value error = value_create_string("Invalid async task");
-                if (task->promise_ptr) {
-                    async_reject_promise(interpreter, task->promise_ptr, &error);
+                value_free(&module_path_val);
+            }
+            interpreter->current_environment = async_env;
+            
+            // Execute function
+            Value result = bytecode_execute_function_bytecode(
+                interpreter, func, task->args, (int)task->arg_count, program);
+            
+            // Handle return value
+            if (result.type == VALUE_NULL) {
+                if (interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
+                    result = value_clone(&interpreter->return_value);
+                    interpreter->has_return = 0;
+                    value_free(&interpreter->return_value);
+                    interpreter->return_value = value_create_null();
                 }
-                value_free(&error);
             }
-        }
-        
-        // Free task
-        if (task->args) {
-            for (size_t i = 0; i < task->arg_count; i++) {
-                value_free(&task->args[i]);
+            
+            // Restore environment
+            interpreter->current_environment = old_env;
+            
+            // Resolve promise
+            Value result_to_resolve = value_clone(&result);
+            task->result = value_clone(&result);
+            task->is_resolved = 1;
+            if (task->promise_ptr && task->promise_ptr->type == VALUE_PROMISE) {
+                async_resolve_promise(interpreter, task->promise_ptr, &result_to_resolve);
+            }
+            value_free(&result);
+            value_free(&result_to_resolve);
+        } else {
+            // Invalid task - reject promise
+            Value error = value_create_string("Invalid async task");
+            if (task->promise_ptr) {
+                async_reject_promise(interpreter, task->promise_ptr, &error);
             }
-            shared_free_safe(task->args, "bytecode_vm", "worker_thread", 0);
+            value_free(&error);
         }
-        value_free(&task->promise_copy);
-        value_free(&task->result);
-        shared_free_safe(task, "bytecode_vm", "worker_thread", 1);
     }
     
-    return NULL;
+    async_task_free(task);
 }
 
-// Initialize async concurrency system
-static void async_init_concurrency(Interpreter* interpreter) {
+void async_event_loop_run(Interpreter* interpreter) {
     if (!interpreter || !interpreter->async_enabled) return;
     
-    // Initialize mutexes and condition variable
-    pthread_mutex_init(&interpreter->task_queue_mutex, NULL);
-    pthread_mutex_init(&interpreter->promise_registry_mutex, NULL);
-    pthread_cond_init(&interpreter->task_available, NULL);
-    interpreter->shutdown_workers = 0;
-    
-    // Determine number of worker threads (use CPU count or default to 4)
-    #ifdef _SC_NPROCESSORS_ONLN
-    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
-    interpreter->worker_thread_count = (cpu_count > 0) ? (size_t)cpu_count : 4;
-    #else
-    interpreter->worker_thread_count = 4;  // Default to 4 threads
-    #endif
-    
-    // Limit to reasonable number
-    if (interpreter->worker_thread_count > 16) {
-        interpreter->worker_thread_count = 16;
+    // Sockets and timers belong to the main event loop; inside an isolate
+    // only the isolate's own tasks run
+    extern bool isolate_in_worker(void);
+    if (!isolate_in_worker()) {
+        // Process WebSocket connections (non-blocking I/O)
+        // This handles message receiving, ping/pong, reconnection, etc.
+        extern void websocket_process_connections(Interpreter* interpreter);
+        websocket_process_connections(interpreter);
+        
+        // Process Gateway connections (heartbeat, message parsing, etc.)
+        extern void gateway_process_all_connections(Interpreter* interpreter);
+        gateway_process_all_connections(interpreter);
+        
+        // Advance outbound requests started with http.fetchAsync()
+        extern void http_process_async_requests(Interpreter* interpreter);
+        http_process_async_requests(interpreter);
+        
+        // Settle isolate.call() promises whose replies have arrived
+        extern void isolate_process_replies(Interpreter* interpreter);
+        isolate_process_replies(interpreter);
     }
     
-    // Allocate worker threads
-    interpreter->worker_threads = (pthread_t*)shared_malloc_safe(
-        interpreter->worker_thread_count * sizeof(pthread_t),
-        "bytecode_vm", "async_init_concurrency", 0);
-    
-    if (!interpreter->worker_threads) {
-        interpreter->worker_thread_count = 0;
-        return;
-    }
-    
-    // Start worker threads
-    for (size_t i = 0; i < interpreter->worker_thread_count; i++) {
-        if (pthread_create(&interpreter->worker_threads[i], NULL, async_worker_thread, interpreter) != 0) {
-            // Failed to create thread - reduce count
-            interpreter->worker_thread_count = i;
-            break;
-        }
+    // Run the queued async tasks
+    if (interpreter->scheduler) {
+        scheduler_run_here(interpreter->scheduler);
     }
 }
 
-// Shutdown async concurrency system
-static void async_shutdown_concurrency(Interpreter* interpreter) {
-    if (!interpreter || interpreter->worker_thread_count == 0) return;
-    
-    // Signal shutdown
-    pthread_mutex_lock(&interpreter->task_queue_mutex);
-    interpreter->shutdown_workers = 1;
-    pthread_cond_broadcast(&interpreter->task_available);
-    pthread_mutex_unlock(&interpreter->task_queue_mutex);
-    
-    // Wait for all threads to finish
-    for (size_t i = 0; i < interpreter->worker_thread_count; i++) {
-        pthread_join(interpreter->worker_threads[i], NULL);
+// Block until the event loop has work: a socket registered with the reactor
+// is ready, a library timer (heartbeat, ping, request timeout) is due, or
+// another thread settled a promise. timeout_ms < 0 waits without limit.
+void async_event_loop_wait(Interpreter* interpreter, int timeout_ms) {
+    // Queued tasks are already waiting to run
+    if (interpreter && scheduler_pending(interpreter->scheduler) > 0) {
+        timeout_ms = 0;
     }
-    
-    // Cleanup
-    if (interpreter->worker_threads) {
-        shared_free_safe(interpreter->worker_threads, "bytecode_vm", "async_shutdown_concurrency", 0);
-        interpreter->worker_threads = NULL;
+    // The reactor's wakeups belong to the main event loop
+    extern bool isolate_in_worker(void);
+    extern void isolate_wait(int timeout_ms);
+    if (isolate_in_worker()) {
+        isolate_wait(timeout_ms);
+        return;
     }
-    
-    interpreter->worker_thread_count = 0;
-    pthread_mutex_destroy(&interpreter->task_queue_mutex);
-    pthread_mutex_destroy(&interpreter->promise_registry_mutex);
-    pthread_cond_destroy(&interpreter->task_available);
+    reactor_wait(timeout_ms);
 }
 
-void async_event_loop_run(Interpreter* interpreter) {
-    if (!interpreter || !interpreter->async_enabled) return;
-    
-    // Initialize concurrency system if not already initialized
-    if (interpreter->worker_thread_count == 0 && interpreter->async_enabled) {
-        async_init_concurrency(interpreter);
-    }
-    
-    // Process WebSocket connections (non-blocking I/O)
-    // This handles message receiving, ping/pong, reconnection, etc.
-    extern void websocket_process_connections(Interpreter* interpreter);
-    websocket_process_connections(interpreter);
-    
-    // Process Gateway connections (heartbeat, message parsing, etc.)
-    extern void gateway_process_all_connections(Interpreter* interpreter);
-    gateway_process_all_connections(interpreter);
-    
-    // If using worker threads, tasks are processed concurrently by workers
-    // Otherwise, fall back to synchronous processing
-    if (interpreter->worker_thread_count == 0) {
-        // Fallback: synchronous processing (for compatibility)
-        if (!interpreter->task_queue || interpreter->task_queue_size == 0) {
-            return;
-        }
-        
-        while (interpreter->task_queue && interpreter->task_queue_size > 0) {
-            AsyncTask* task = async_task_queue_pop(interpreter);
-            if (!task) break;
-            
-            if (task->is_resolved) {
-                // Task already completed - resolve promise
-                if (task->promise_ptr && task->promise_ptr->type == VALUE_PROMISE) {
-                    async_resolve_promise(interpreter, task->promise_ptr, &task->result);
-                }
-            } else {
-                // Execute task
-                BytecodeProgram* program = (BytecodeProgram*)task->program;
-                if (program && task->function_id >= 0 && task->function_id < (int)program->function_count && program->functions) {
-                    BytecodeFunction* func = &program->functions[task->function_id];
-                    
-                    // Save current environment
-                    Environment* old_env = interpreter->current_environment;
-                    interpreter->current_environment = task->environment ? task->environment : interpreter->global_environment;
-                    
-                    // Execute function - this should return the function's return value
-                    Value result = bytecode_execute_function_bytecode(
-                        interpreter, func, task->args, (int)task->arg_count, program);
-                    
-                    // bytecode_execute_function_bytecode should have already captured the return value
-                    // and set it in the result. However, if interpreter->has_return is still set,
-                    // that means the return value is in interpreter->return_value and wasn't
-                    // captured in result. Use interpreter->return_value as the authoritative source.
-                    // This can happen if bytecode_execute_function_bytecode didn't properly capture it.
-                    // Also check if result is NULL - this shouldn't happen if the function returned a value
-                    if (result.type == VALUE_NULL) {
-                        // Result is NULL - check if interpreter->has_return is still set
-                        // This means bytecode_execute_function_bytecode didn't capture the return value
-                        if (interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
-                            // The return value is still in interpreter->return_value
-                            // Use it as the result
-                            result = value_clone(&interpreter->return_value);
-                            interpreter->has_return = 0;
-                            value_free(&interpreter->return_value);
-                            interpreter->return_value = value_create_null();
-                        }
-                        // If result is still NULL and has_return is not set, the function didn't return a value
-                        // This is fine - we'll resolve the promise with NULL
-                    }
-                    
-                    // At this point, result should contain the function's return value
-                    // (or VALUE_NULL if the function didn't return anything)
-                    // If result is still NULL, that means the function didn't return a value,
-                    // which is fine - we'll resolve the promise with NULL
-                    
-                    // Restore environment
-                    interpreter->current_environment = old_env;
-                    
-                    // Resolve promise with result - resolve the promise pointer so it updates the original
-                    // Make sure we have a valid result (even if it's null)
-                    // Clone the result before resolving to ensure we have our own copy
-                    Value result_to_resolve = value_clone(&result);
-                    task->result = value_clone(&result);  // Clone result for task
-                    task->is_resolved = 1;
-                    if (task->promise_ptr && task->promise_ptr->type == VALUE_PROMISE) {
-                        // Always resolve, even if result is null (that's a valid return value)
-                        async_resolve_promise(interpreter, task->promise_ptr, &result_to_resolve);
-                    } else {
-                        // Promise pointer is invalid - this shouldn't happen
-                        // But handle it gracefully
-                    }
-                    value_free(&result);  // Free the original result
-                    value_free(&result_to_resolve);  // Free the cloned result
-                } else {
-                    // Invalid task - reject promise
-                    Value error = value_create_string("Invalid async task");
-                    if (task->promise_ptr) {
-                        async_reject_promise(interpreter, task->promise_ptr, &error);
-                    }
-                    value_free(&error);
-                }
-            }
-            
-            // Free task
-            if (task->args) {
-                for (size_t i = 0; i < task->arg_count; i++) {
-                    value_free(&task->args[i]);
+// Whether async tasks are queued or a promise is still unsettled (a running
+// task's promise settles, and wakes the event loop, when it finishes)
+int async_has_pending_work(Interpreter* interpreter) {
+    if (!interpreter) return 0;
+    if (scheduler_pending(interpreter->scheduler) > 0) return 1;
+    
+    struct PromiseRegistry* registry = __atomic_load_n(&interpreter->promise_registry, __ATOMIC_ACQUIRE);
+    if (!registry) return 0;
+    int pending = 0;
+    for (size_t i = 0; i < PROMISE_REGISTRY_SHARDS && !pending; i++) {
+        PromiseRegistryShard* shard = &registry->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        for (size_t b = 0; b < shard->bucket_count && !pending; b++) {
+            for (PromiseEntry* entry = shard->buckets[b]; entry; entry = entry->next) {
+                if (!entry->promise.data.promise_value.is_resolved &&
+                    !entry->promise.data.promise_value.is_rejected) {
+                    pending = 1;
+                    break;
                 }
-                shared_free_safe(task->args, "bytecode_vm", "async_event_loop_run", 0);
             }
-            value_free(&task->promise_copy);
-            value_free(&task->result);
-            // Don't free promise_ptr here - it's owned by the caller who received the promise
-            // The promise_ptr will be freed when the promise Value is freed
-            shared_free_safe(task, "bytecode_vm", "async_event_loop_run", 0);
         }
+        pthread_mutex_unlock(&shard->mutex);
     }
-    // Worker threads handle task execution concurrently
+    return pending;
+}
+
+// Close this interpreter's isolates and free queued tasks and registered promises
+void async_runtime_free(Interpreter* interpreter) {
+    if (!interpreter) return;
+    
+    extern void isolate_release_owner(Interpreter* interpreter);
+    isolate_release_owner(interpreter);
+    
+    if (interpreter->scheduler) {
+        SchedulerTask* leftover = scheduler_destroy(interpreter->scheduler);
+        interpreter->scheduler = NULL;
+        while (leftover) {
+            AsyncTask* task = (AsyncTask*)leftover;
+            leftover = leftover->next;
+            async_task_free(task);
+        }
+    }
+    
+    struct PromiseRegistry* registry = interpreter->promise_registry;
+    if (registry) {
+        for (size_t i = 0; i < PROMISE_REGISTRY_SHARDS; i++) {
+            PromiseRegistryShard* shard = &registry->shards[i];
+            for (size_t b = 0; b < shard->bucket_count; b++) {
+                PromiseEntry* entry = shard->buckets[b];
+                while (entry) {
+                    PromiseEntry* next = entry->next;
+                    value_free(&entry->promise);
+                    free(entry);
+                    entry = next;
+                }
+            }
+            free(shard->buckets);
+            pthread_mutex_destroy(&shard->mutex);
+        }
+        free(registry);
+        interpreter->promise_registry = NULL;
+    }
+    pthread_mutex_destroy(&interpreter->promise_registry_mutex);
 }
 
 // These functions are implemented in bytecode_compiler.c
@@ -1240,22 +1328,542 @@ static Value bytecode_execute_no_reset(BytecodeProgram* program, Interpreter* in
     return result;
 }
 
+// Resolve the environment binding mirrored by a main-program local slot.
+// Bindings are cached per slot and revalidated against the scope they were
+// resolved from, so steady-state loads and stores skip the name walk. With
+// define set, a missing binding is created in the current scope.
+static Value* bc_local_binding(Interpreter* interpreter, BytecodeProgram* program, int slot, int define) {
+    if (!interpreter || !program || !program->local_names || slot < 0 ||
+        (size_t)slot >= program->local_count || !program->local_names[slot]) {
+        return NULL;
+    }
+    Environment* scope = interpreter->current_environment;
+    if (!scope) return NULL;
+    
+    if ((size_t)slot >= program->local_binding_capacity) {
+        size_t new_capacity = program->local_count > 8 ? program->local_count : 8;
+        BytecodeLocalBinding* grown = shared_realloc_safe(program->local_bindings,
+            new_capacity * sizeof(BytecodeLocalBinding), "bytecode_vm", "bc_local_binding", 0);
+        if (!grown) return NULL;
+        memset(grown + program->local_binding_capacity, 0,
+               (new_capacity - program->local_binding_capacity) * sizeof(BytecodeLocalBinding));
+        program->local_bindings = grown;
+        program->local_binding_capacity = new_capacity;
+    }
+    
+    BytecodeLocalBinding* b = &program->local_bindings[slot];
+    if (LIKELY(b->env == scope && b->scope == scope && b->scope_count == scope->count &&
+               b->index < scope->count && scope->names[b->index] == b->bound_name)) {
+        return &scope->values[b->index];
+    }
+    
+    const char* name = program->local_names[slot];
+    Environment* owner = NULL;
+    size_t index = 0;
+    Value* found = environment_resolve(scope, name, &owner, &index);
+    if (!found && define) {
+        Value null_val = value_create_null();
+        environment_define(scope, name, null_val);
+        found = environment_resolve(scope, name, &owner, &index);
+    }
+    if (!found) {
+        b->env = NULL;
+        return NULL;
+    }
+    
+    // Only bindings owned by the current scope are cached: a later define in
+    // an intermediate parent could otherwise shadow them unnoticed.
+    b->env = owner;
+    b->scope = scope;
+    b->scope_count = scope->count;
+    b->bound_name = owner->names[index];
+    b->index = index;
+    return found;
+}
+
+// Read a main-program local. Locals are mirrored into the environment
+// (bc_main_local_store) and may be updated there by name-based code, so the
+// bound value wins over the slot.
+static Value bc_main_local_load(Interpreter* interpreter, BytecodeProgram* program, int index) {
+    if (UNLIKELY(index < 0 || (size_t)index >= program->local_slot_count)) {
+        return value_create_null();
+    }
+    Value* slot = &program->locals[index];
+    
+    Value* bound = bc_local_binding(interpreter, program, index, 0);
+    Value env_val = value_create_null();
+    if (bound && bound->type != VALUE_NULL) {
+        env_val = value_clone(bound);
+    } else if (interpreter && interpreter->global_environment) {
+        // Also check global environment for modules
+        env_val = environment_get(interpreter->global_environment, program->local_names[index]);
+    }
+    
+    if (env_val.type != VALUE_NULL) {
+        // Update local slot to match environment if local is Null or different
+        if (slot->type == VALUE_NULL || 
+            (slot->type == VALUE_OBJECT && env_val.type == VALUE_OBJECT && 
+             slot->data.object_value.count != env_val.data.object_value.count)) {
+            value_free(slot);
+            *slot = value_clone(&env_val);
+        }
+        return env_val;
+    }
+    return slot->type != VALUE_NULL ? value_clone(slot) : value_create_null();
+}
+
+// Write a main-program local, taking ownership of val. name_const is the
+// constant holding the variable's name, used when there is no slot name table.
+static void bc_main_local_store(Interpreter* interpreter, BytecodeProgram* program, int index, int name_const, Value val) {
+    if (UNLIKELY(index < 0 || (size_t)index >= program->local_slot_count)) {
+        value_free(&val);
+        return;
+    }
+    value_free(&program->locals[index]);
+    
+    // Also update numeric locals if this is a number
+    if (val.type == VALUE_NUMBER && (size_t)index < program->num_local_count) {
+        program->num_locals[index] = val.data.number_value;
+    }
+    
+    // For complex types (objects, arrays, hash maps, sets), clone to ensure internal pointers are valid
+    // For simple types (numbers, booleans, null), store directly
+    Value stored_val;
+    if (val.type == VALUE_OBJECT || val.type == VALUE_ARRAY || val.type == VALUE_FUNCTION || 
+        val.type == VALUE_ASYNC_FUNCTION || val.type == VALUE_HASH_MAP || val.type == VALUE_SET) {
+        stored_val = value_clone(&val);
+        value_free(&val);
+    } else {
+        // Store the value directly (don't clone) - the value on stack is already a clone from BC_LOAD_LOCAL
+        stored_val = val;
+    }
+    program->locals[index] = stored_val;
+    
+    // Also store in environment so AST-interpreted code (like for loop bodies) can access it
+    // This ensures variables are accessible via BC_LOAD_GLOBAL even if program->local_count is 0
+    if (interpreter && !interpreter->current_environment) {
+        interpreter->current_environment = environment_create(NULL);
+    }
+    Value* bound = bc_local_binding(interpreter, program, index, 1);
+    if (bound) {
+        Value mirrored = value_clone(&stored_val);
+        value_free(bound);
+        *bound = mirrored;
+    } else if (interpreter && interpreter->current_environment && name_const > 0 &&
+               name_const < (int)program->const_count && 
+               program->constants[name_const].type == VALUE_STRING) {
+        // No slot name table: name_const holds the variable name in the constants pool
+        const char* var_name = program->constants[name_const].data.string_value;
+        if (environment_exists(interpreter->current_environment, var_name)) {
+            environment_assign(interpreter->current_environment, var_name, stored_val);
+        } else {
+            environment_define(interpreter->current_environment, var_name, stored_val);
+        }
+    }
+}
+
+// slot[index] = value on a frame slot, in place. Copy-on-write keeps other
+// references to the container unchanged; the slot's own reference is the
+// only one in the common case, so nothing is copied.
+static void bc_frame_slot_set_element(Interpreter* interpreter, NanBoxedValue* slot, Value index, Value value) {
+    Value* container = nan_boxing_is_cell(*slot) ? nan_boxing_get_cell(*slot) : NULL;
+    if (container && container->type == VALUE_ARRAY && index.type == VALUE_NUMBER) {
+        int idx = (int)index.data.number_value;
+        if (idx >= 0 && idx < (int)container->data.array_value.count) {
+            value_array_set(container, (size_t)idx, value);
+        } else if (interpreter) {
+            interpreter_set_error(interpreter, "Array index out of bounds", 0, 0);
+        }
+    } else if (container && container->type == VALUE_HASH_MAP) {
+        value_hash_map_set(container, index, value);
+    } else if (interpreter) {
+        if (container && container->type == VALUE_ARRAY) {
+            interpreter_set_error(interpreter, "Array index must be a number", 0, 0);
+        } else {
+            interpreter_set_error(interpreter, "Cannot assign to non-array/non-map element", 0, 0);
+        }
+    }
+}
+
+// `x = x + n` on a main-program local that does not hold a number (string
+// concatenation and the like): goes through value_add like BC_ADD_LLL.
+// Returns false when the local holds a number and the numeric path applies.
+static bool bc_main_local_add_generic(Interpreter* interpreter, BytecodeProgram* program, int index, double addend) {
+    if (index < 0 || (size_t)index >= program->local_slot_count ||
+        program->locals[index].type == VALUE_NUMBER) {
+        return false;
+    }
+    Value left = bc_main_local_load(interpreter, program, index);
+    if (left.type == VALUE_NUMBER) {
+        value_free(&left);
+        return false;
+    }
+    Value right = value_create_number(addend);
+    Value sum = value_add(&left, &right);
+    value_free(&left);
+    bc_main_local_store(interpreter, program, index, 0, sum);
+    return true;
+}
+
+static int bc_same_storage(Value* a, Value* b) {
+    if (a->type != b->type) return 0;
+    switch (a->type) {
+        case VALUE_ARRAY:
+            return a->data.array_value.shared && a->data.array_value.shared == b->data.array_value.shared;
+        case VALUE_HASH_MAP:
+            return a->data.hash_map_value.shared && a->data.hash_map_value.shared == b->data.hash_map_value.shared;
+        case VALUE_OBJECT:
+            return a->data.object_value.shared && a->data.object_value.shared == b->data.object_value.shared;
+        default:
+            return 0;
+    }
+}
+
+// Before writing into a container popped off the stack for `name[i] = v`
+// or `name.prop = v`,
+// drop the variable's own references to the same storage (its environment
+// binding and main-program local slot) so the write happens in place instead
+// of detaching a full copy. The caller stores the result back by name.
+static void bc_release_for_write(Interpreter* interpreter, BytecodeProgram* program, const char* name, Value* container) {
+    if (!interpreter || !name || !value_is_shared(container)) return;
+    
+    Value* bound = environment_resolve(interpreter->current_environment, name, NULL, NULL);
+    if (bound && bc_same_storage(bound, container)) {
+        value_free(bound);
+    }
+    if (program && program->local_names && program->locals) {
+        for (size_t i = 0; i < program->local_slot_count && i < program->local_count; i++) {
+            if (program->local_names[i] && strcmp(program->local_names[i], name) == 0 &&
+                bc_same_storage(&program->locals[i], container)) {
+                value_free(&program->locals[i]);
+                break;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// INLINE CACHES
+// ============================================================================
+// Property and method-call sites remember the object shapes they have seen
+// (up to BC_INLINE_CACHE_WAYS, then entries are replaced round-robin), so a
+// repeated access is a shape compare plus an indexed slot load.
+
+static BytecodeInlineCache* bc_inline_cache(BytecodeProgram* program, size_t pc) {
+    if (pc >= program->inline_cache_capacity) {
+        size_t new_capacity = program->count > pc ? program->count : pc + 1;
+        BytecodeInlineCache** grown = shared_realloc_safe(program->inline_caches,
+            new_capacity * sizeof(BytecodeInlineCache*), "bytecode_vm", "bc_inline_cache", 0);
+        if (!grown) return NULL;
+        memset(grown + program->inline_cache_capacity, 0,
+               (new_capacity - program->inline_cache_capacity) * sizeof(BytecodeInlineCache*));
+        program->inline_caches = grown;
+        program->inline_cache_capacity = new_capacity;
+    }
+    if (!program->inline_caches[pc]) {
+        BytecodeInlineCache* ic = shared_malloc_safe(sizeof(BytecodeInlineCache), "bytecode_vm", "bc_inline_cache", 1);
+        if (!ic) return NULL;
+        memset(ic, 0, sizeof(BytecodeInlineCache));
+        program->inline_caches[pc] = ic;
+    }
+    return program->inline_caches[pc];
+}
+
+// Claim an entry for shape, evicting round-robin once the cache is full
+static uint32_t bc_inline_cache_claim(BytecodeInlineCache* ic, const ObjectShape* shape, uint32_t slot) {
+    uint32_t way;
+    if (ic->count < BC_INLINE_CACHE_WAYS) {
+        way = ic->count++;
+    } else {
+        way = ic->next;
+        ic->next = (ic->next + 1) % BC_INLINE_CACHE_WAYS;
+        value_free(&ic->methods[way]);
+    }
+    ic->shapes[way] = shape;
+    ic->slots[way] = slot;
+    ic->classes[way] = NULL;
+    ic->methods[way] = value_create_null();
+    return way;
+}
+
+// Slot of property name in object, or -1
+static int bc_object_slot(BytecodeProgram* program, size_t pc, Value* object, const char* name) {
+    const ObjectShape* shape = object->data.object_value.shape;
+    BytecodeInlineCache* ic = bc_inline_cache(program, pc);
+    if (ic) {
+        for (uint32_t i = 0; i < ic->count; i++) {
+            if (ic->shapes[i] == shape) return (int)ic->slots[i];
+        }
+    }
+    int slot = object_shape_find(shape, name);
+    if (ic && slot >= 0) {
+        bc_inline_cache_claim(ic, shape, (uint32_t)slot);
+    }
+    return slot;
+}
+
+// obj.name = value through the site's cache; new properties take the
+// shape transition in value_object_set
+static void bc_object_store(BytecodeProgram* program, size_t pc, Value* object, const char* name, Value value) {
+    int slot = bc_object_slot(program, pc, object, name);
+    if (slot >= 0) {
+        value_object_set_slot(object, (size_t)slot, value);
+    } else {
+        value_object_set(object, name, value);
+    }
+}
+
+// Method resolved earlier at this site for object's class, or NULL. A hit
+// needs the same shape, a __class_name__ still naming a class, and that
+// name still bound to the class the method was found in.
+static Value* bc_cached_method(Interpreter* interpreter, BytecodeProgram* program, size_t pc, Value* object) {
+    if (!interpreter || pc >= program->inline_cache_capacity || !program->inline_caches[pc]) return NULL;
+    BytecodeInlineCache* ic = program->inline_caches[pc];
+    const ObjectShape* shape = object->data.object_value.shape;
+    for (uint32_t i = 0; i < ic->count; i++) {
+        if (ic->shapes[i] != shape || !ic->classes[i]) continue;
+        Value* class_name = &object->data.object_value.values[ic->slots[i]];
+        if (class_name->type != VALUE_STRING || !class_name->data.string_value) return NULL;
+        Value* class_def = environment_resolve(interpreter->global_environment, class_name->data.string_value, NULL, NULL);
+        if (class_def && class_def->type == VALUE_CLASS &&
+            (const void*)class_def->data.class_value.class_body == ic->classes[i]) {
+            return &ic->methods[i];
+        }
+        return NULL;
+    }
+    return NULL;
+}
+
+// Remember method as the resolution for object's class at this site
+static void bc_cache_method(BytecodeProgram* program, size_t pc, Value* object, Value* class_def, Value* method) {
+    const ObjectShape* shape = object->data.object_value.shape;
+    if (!class_def->data.class_value.class_body) return;
+    // Objects carrying __type__ dispatch as modules/libraries first
+    if (object_shape_find(shape, "__type__") >= 0) return;
+    int slot = object_shape_find(shape, "__class_name__");
+    if (slot < 0) return;
+    
+    BytecodeInlineCache* ic = bc_inline_cache(program, pc);
+    if (!ic) return;
+    for (uint32_t i = 0; i < ic->count; i++) {
+        if (ic->shapes[i] == shape) {
+            // Replaces a property entry or a stale class binding
+            value_free(&ic->methods[i]);
+            ic->slots[i] = (uint32_t)slot;
+            ic->classes[i] = class_def->data.class_value.class_body;
+            ic->methods[i] = value_clone(method);
+            return;
+        }
+    }
+    uint32_t way = bc_inline_cache_claim(ic, shape, (uint32_t)slot);
+    ic->classes[way] = class_def->data.class_value.class_body;
+    ic->methods[way] = value_clone(method);
+}
+
+// Call user function func_id with the top arg_count values on the stack as
+// its arguments and push the result. stack_base is the lowest stack index
+// the caller's operands may be taken from.
+static void bc_call_user_function(Interpreter* interpreter, BytecodeProgram* func_program, int func_id, int arg_count, size_t stack_base) {
+    if (func_id >= 0 && func_id < (int)func_program->function_count && func_program->functions) {
+        BytecodeFunction* func = &func_program->functions[func_id];
+        
+        // Frame-slot functions take their arguments in place as slots
+        if (func->uses_frame_slots && !func->needs_environment && arg_count >= 0 &&
+            value_stack_size >= stack_base + (size_t)arg_count) {
+            value_stack_push(bc_call_frame(interpreter, func_program, func, arg_count));
+            return;
+        }
+        
+        // Get arguments from stack
+        Value* args = NULL;
+        if (arg_count > 0) {
+            args = shared_malloc_safe(arg_count * sizeof(Value), "bytecode_vm", "BC_CALL_USER_FUNCTION", 1);
+            if (!args) {
+                // Allocation failed - return null
+                value_stack_push(value_create_null());
+                return;
+            }
+            for (int i = 0; i < arg_count; i++) {
+                args[arg_count - 1 - i] = value_stack_pop();
+            }
+        }
+        
+        // Save stack size before function call
+        size_t stack_size_before = value_stack_size;
+        
+        // Execute function bytecode using the main program
+        Value result = bytecode_execute_function_bytecode(interpreter, func, args, arg_count, func_program);
+        
+        // Clean up arguments
+        if (args) {
+            for (int i = 0; i < arg_count; i++) {
+                value_free(&args[i]);
+            }
+            shared_free_safe(args, "bytecode_vm", "BC_CALL_USER_FUNCTION", 2);
+        }
+        
+        // Check if return value was already pushed onto stack by bytecode_execute_function_bytecode
+        // (it pushes the return value onto the restored stack)
+        if (value_stack_size > stack_size_before) {
+            // Return value was already pushed, just free the result
+            value_free(&result);
+        } else {
+            // Return value was not pushed, push it now
+            value_stack_push(result);
+        }
+    } else {
+        value_stack_push(value_create_null());
+    }
+}
+
+// ============================================================================
+// TYPE FEEDBACK
+// ============================================================================
+// Generic arithmetic, comparison and indexing opcodes sample the kinds of
+// their two operands (see optimization/type_predictor.c). Once a site has
+// settled, its instruction is rewritten in place into the quickened variant,
+// whose handler only checks the tags it was specialized for. When that check
+// fails the instruction is rewritten back and re-dispatched as the generic
+// opcode. Function code is shared by all of its calls and loop-body runs, so
+// its feedback lives on the BytecodeFunction. Define MYCO_VM_NO_QUICKENING to
+// keep every instruction generic.
+
+// Executions of quickened / quickenable generic opcodes, reported by --vm-stats
+static MYCO_THREAD_LOCAL unsigned long long vm_quickened_executions = 0;
+static MYCO_THREAD_LOCAL unsigned long long vm_generic_executions = 0;
+
+void bytecode_vm_quickening_counts(unsigned long long* quickened, unsigned long long* generic) {
+    if (quickened) *quickened = vm_quickened_executions;
+    if (generic) *generic = vm_generic_executions;
+}
+
+// Point a view or loop-body program at the feedback of the function it runs
+static void bc_share_function_feedback(BytecodeProgram* view, BytecodeFunction* func) {
+    if (!func->type_feedback && func->code_count > 0) {
+        func->type_feedback = shared_malloc_safe(func->code_count * sizeof(TypeFeedbackSlot),
+                                                 "bytecode_vm", "bc_share_function_feedback", 0);
+        if (func->type_feedback) {
+            memset(func->type_feedback, 0, func->code_count * sizeof(TypeFeedbackSlot));
+        }
+    }
+    view->type_feedback = func->type_feedback;
+    view->type_feedback_capacity = func->type_feedback ? func->code_count : 0;
+}
+
+// Feedback slot for pc; main programs grow their table on demand
+static TypeFeedbackSlot* bc_type_feedback(BytecodeProgram* program, size_t pc) {
+    if (pc >= program->type_feedback_capacity) {
+        size_t new_capacity = program->count > pc ? program->count : pc + 1;
+        TypeFeedbackSlot* grown = shared_realloc_safe(program->type_feedback,
+            new_capacity * sizeof(TypeFeedbackSlot), "bytecode_vm", "bc_type_feedback", 0);
+        if (!grown) return NULL;
+        memset(grown + program->type_feedback_capacity, 0,
+               (new_capacity - program->type_feedback_capacity) * sizeof(TypeFeedbackSlot));
+        program->type_feedback = grown;
+        program->type_feedback_capacity = new_capacity;
+    }
+    return &program->type_feedback[pc];
+}
+
+static inline TypeFeedbackKind bc_feedback_kind(NanBoxedValue word) {
+    if (nan_boxing_is_number(word)) return TYPE_FEEDBACK_NUMBER;
+    switch (nan_boxing_get_tag(word)) {
+        case NAN_BOX_TAG_STRING: return TYPE_FEEDBACK_STRING;
+        case NAN_BOX_TAG_ARRAY: return TYPE_FEEDBACK_ARRAY;
+        default: return TYPE_FEEDBACK_OTHER;
+    }
+}
+
+// Quickened variant of op for the operand kinds a site settled on (op if none fits)
+static BytecodeOp bc_quickened_op(BytecodeOp op, uint8_t left, uint8_t right) {
+    if (op == BC_ARRAY_GET) {
+        return left == TYPE_FEEDBACK_ARRAY && right == TYPE_FEEDBACK_NUMBER ? BC_ARRAY_GET_DENSE : op;
+    }
+    if (op == BC_ADD && left == TYPE_FEEDBACK_STRING && right == TYPE_FEEDBACK_STRING) {
+        return BC_ADD_STRINGS;
+    }
+    if (left != TYPE_FEEDBACK_NUMBER || right != TYPE_FEEDBACK_NUMBER) return op;
+    switch (op) {
+        case BC_ADD: return BC_ADD_NUMBERS;
+        case BC_SUB: return BC_SUB_NUMBERS;
+        case BC_MUL: return BC_MUL_NUMBERS;
+        case BC_LT: return BC_LT_NUMBERS;
+        case BC_LE: return BC_LE_NUMBERS;
+        case BC_GT: return BC_GT_NUMBERS;
+        case BC_GE: return BC_GE_NUMBERS;
+        default: return op;
+    }
+}
+
+static void bc_quicken_sample(BytecodeProgram* program, size_t pc) {
+    TypeFeedbackSlot* slot = bc_type_feedback(program, pc);
+    if (!slot || value_stack_size < 2) return;
+    TypeFeedbackKind left = bc_feedback_kind(value_stack[value_stack_size - 2]);
+    TypeFeedbackKind right = bc_feedback_kind(value_stack[value_stack_size - 1]);
+    if (!type_feedback_observe(slot, left, right)) return;
+    BytecodeInstruction* instr = &program->code[pc];
+    BytecodeOp quickened = bc_quickened_op(instr->op, slot->left, slot->right);
+    if (quickened == instr->op) {
+        type_feedback_give_up(slot);
+        return;
+    }
+    instr->op = quickened;
+    type_feedback_stats()->sites_quickened++;
+}
+
+// Sample the operands of the generic opcode at pc (on top of the value stack)
+static inline void bc_quicken(BytecodeProgram* program, size_t pc) {
+    vm_generic_executions++;
+#ifdef MYCO_VM_NO_QUICKENING
+    (void)program;
+    (void)pc;
+#else
+    if (LIKELY(pc < program->type_feedback_capacity && program->type_feedback[pc].generic)) return;
+    bc_quicken_sample(program, pc);
+#endif
+}
+
+// A quickened instruction's guard failed: restore the generic opcode at pc
+static void bc_dequicken(BytecodeProgram* program, size_t pc) {
+    BytecodeInstruction* instr = &program->code[pc];
+    instr->op = bytecode_generic_op(instr->op);
+    type_feedback_deoptimize(bc_type_feedback(program, pc));
+}
+
 // Main execution function
 Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int debug) {
+    return bytecode_run(program, interpreter, debug, NULL);
+}
+
+// Execute a program. frame is non-NULL when running a function body: its
+// local slots then live on the value stack starting at frame->local_start.
+static Value bytecode_run(BytecodeProgram* program, Interpreter* interpreter, int debug, const BytecodeCallFrame* frame) {
     if (!program || !interpreter) {
         return value_create_null();
     }
     
-    // Debug: Log when executing module bytecode
-    if (program->count > 100) {
-    }
     
     // Initialize memory optimizations
     init_memory_optimizations();
     
-    // Initialize stacks
-    value_stack_size = 0;
-    num_stack_size = 0;
+    // Initialize stacks. Nested runs (function frames, loop bodies, imports)
+    // keep the caller's operands and unwind back to them on exit.
+    int outermost = (vm_run_depth++ == 0);
+    if (outermost) {
+        // A function called from C (server handlers, callbacks) arrives with
+        // its parameters already pushed as frame slots
+        if (!frame) value_stack_size = 0;
+        num_stack_size = 0;
+    }
+    size_t stack_base = value_stack_size;
+    size_t num_stack_base = num_stack_size;
+    size_t frame_base = frame ? frame->local_start : 0;
+    size_t frame_local_count = frame ? frame->local_count : 0;
+    // Lowest stack index owned by this run's operands (above any frame slots)
+    size_t operand_base = stack_base;
+    if (frame && frame_base + frame_local_count > operand_base) {
+        operand_base = frame_base + frame_local_count;
+    }
     
     // Initialize value pool for performance
     value_pool_reset(program);
@@ -1272,71 +1880,197 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
     size_t pc = 0;
     Value result = value_create_null();
     
-    if (debug) {
+#if VM_COMPUTED_GOTO
+    // Indexed by opcode; opcodes without a handler land on the default case
+    __extension__ static const void* vm_dispatch_table[BC_OP_COUNT] = {
+        [0] = &&vm_op_default,
+        [BC_LOAD_CONST] = &&vm_op_BC_LOAD_CONST,
+        [BC_LOAD_LOCAL] = &&vm_op_BC_LOAD_LOCAL,
+        [BC_LOAD_VAR] = &&vm_op_BC_LOAD_VAR,
+        [BC_STORE_LOCAL] = &&vm_op_BC_STORE_LOCAL,
+        [BC_LOAD_GLOBAL] = &&vm_op_BC_LOAD_GLOBAL,
+        [BC_STORE_GLOBAL] = &&vm_op_BC_STORE_GLOBAL,
+        [BC_DUP] = &&vm_op_BC_DUP,
+        [BC_ADD] = &&vm_op_BC_ADD,
+        [BC_SUB] = &&vm_op_BC_SUB,
+        [BC_MUL] = &&vm_op_BC_MUL,
+        [BC_DIV] = &&vm_op_BC_DIV,
+        [BC_MOD] = &&vm_op_BC_MOD,
+        [BC_EQ] = &&vm_op_BC_EQ,
+        [BC_NE] = &&vm_op_BC_NE,
+        [BC_LT] = &&vm_op_BC_LT,
+        [BC_LE] = &&vm_op_BC_LE,
+        [BC_GT] = &&vm_op_BC_GT,
+        [BC_GE] = &&vm_op_BC_GE,
+        [BC_AND] = &&vm_op_BC_AND,
+        [BC_OR] = &&vm_op_BC_OR,
+        [BC_JUMP] = &&vm_op_BC_JUMP,
+        [BC_JUMP_IF_FALSE] = &&vm_op_BC_JUMP_IF_FALSE,
+        [BC_LOOP_START] = &&vm_op_BC_LOOP_START,
+        [BC_LOOP_END] = &&vm_op_BC_LOOP_END,
+        [BC_FOR_LOOP_START] = &&vm_op_default,
+        [BC_FOR_LOOP_END] = &&vm_op_default,
+        [BC_PRINT] = &&vm_op_BC_PRINT,
+        [BC_PRINT_MULTIPLE] = &&vm_op_BC_PRINT_MULTIPLE,
+        [BC_METHOD_CALL] = &&vm_op_BC_METHOD_CALL,
+        [BC_PROPERTY_ACCESS] = &&vm_op_BC_PROPERTY_ACCESS,
+        [BC_PROPERTY_SET] = &&vm_op_BC_PROPERTY_SET,
+        [BC_CALL_BUILTIN] = &&vm_op_BC_CALL_BUILTIN,
+        [BC_CALL_USER_FUNCTION] = &&vm_op_BC_CALL_USER_FUNCTION,
+        [BC_CALL_FUNCTION_VALUE] = &&vm_op_BC_CALL_FUNCTION_VALUE,
+        [BC_DEFINE_FUNCTION] = &&vm_op_BC_DEFINE_FUNCTION,
+        [BC_TO_STRING] = &&vm_op_BC_TO_STRING,
+        [BC_GET_TYPE] = &&vm_op_BC_GET_TYPE,
+        [BC_GET_LENGTH] = &&vm_op_BC_GET_LENGTH,
+        [BC_IS_STRING] = &&vm_op_BC_IS_STRING,
+        [BC_IS_NUMBER] = &&vm_op_BC_IS_NUMBER,
+        [BC_IS_INT] = &&vm_op_BC_IS_INT,
+        [BC_IS_FLOAT] = &&vm_op_BC_IS_FLOAT,
+        [BC_IS_BOOL] = &&vm_op_BC_IS_BOOL,
+        [BC_IS_ARRAY] = &&vm_op_BC_IS_ARRAY,
+        [BC_IS_NULL] = &&vm_op_BC_IS_NULL,
+        [BC_IS_OBJECT] = &&vm_op_BC_IS_OBJECT,
+        [BC_IS_FUNCTION] = &&vm_op_BC_IS_FUNCTION,
+        [BC_ARRAY_GET] = &&vm_op_BC_ARRAY_GET,
+        [BC_ARRAY_SET] = &&vm_op_BC_ARRAY_SET,
+        [BC_ARRAY_PUSH] = &&vm_op_BC_ARRAY_PUSH,
+        [BC_ARRAY_POP] = &&vm_op_BC_ARRAY_POP,
+        [BC_ARRAY_CONTAINS] = &&vm_op_BC_ARRAY_CONTAINS,
+        [BC_ARRAY_INDEX_OF] = &&vm_op_BC_ARRAY_INDEX_OF,
+        [BC_ARRAY_JOIN] = &&vm_op_BC_ARRAY_JOIN,
+        [BC_ARRAY_UNIQUE] = &&vm_op_BC_ARRAY_UNIQUE,
+        [BC_ARRAY_SLICE] = &&vm_op_BC_ARRAY_SLICE,
+        [BC_ARRAY_CONCAT_METHOD] = &&vm_op_BC_ARRAY_CONCAT_METHOD,
+        [BC_CREATE_ARRAY] = &&vm_op_BC_CREATE_ARRAY,
+        [BC_ARRAY_CONCAT] = &&vm_op_BC_ARRAY_CONCAT,
+        [BC_CREATE_RANGE] = &&vm_op_BC_CREATE_RANGE,
+        [BC_CREATE_RANGE_STEP] = &&vm_op_BC_CREATE_RANGE_STEP,
+        [BC_CREATE_OBJECT] = &&vm_op_BC_CREATE_OBJECT,
+        [BC_CREATE_MAP] = &&vm_op_BC_CREATE_MAP,
+        [BC_CREATE_SET] = &&vm_op_BC_CREATE_SET,
+        [BC_IMPORT_LIB] = &&vm_op_BC_IMPORT_LIB,
+        [BC_SET_SYMBOL_FLAGS] = &&vm_op_BC_SET_SYMBOL_FLAGS,
+        [BC_STRING_UPPER] = &&vm_op_BC_STRING_UPPER,
+        [BC_STRING_LOWER] = &&vm_op_BC_STRING_LOWER,
+        [BC_STRING_TRIM] = &&vm_op_BC_STRING_TRIM,
+        [BC_STRING_SPLIT] = &&vm_op_default,
+        [BC_STRING_REPLACE] = &&vm_op_default,
+        [BC_MATH_ABS] = &&vm_op_BC_MATH_ABS,
+        [BC_MATH_SQRT] = &&vm_op_BC_MATH_SQRT,
+        [BC_MATH_POW] = &&vm_op_BC_MATH_POW,
+        [BC_MATH_SIN] = &&vm_op_BC_MATH_SIN,
+        [BC_MATH_COS] = &&vm_op_BC_MATH_COS,
+        [BC_MATH_TAN] = &&vm_op_BC_MATH_TAN,
+        [BC_MATH_FLOOR] = &&vm_op_BC_MATH_FLOOR,
+        [BC_MATH_CEIL] = &&vm_op_BC_MATH_CEIL,
+        [BC_MATH_ROUND] = &&vm_op_BC_MATH_ROUND,
+        [BC_MAP_HAS] = &&vm_op_BC_MAP_HAS,
+        [BC_MAP_SIZE] = &&vm_op_BC_MAP_SIZE,
+        [BC_MAP_KEYS] = &&vm_op_BC_MAP_KEYS,
+        [BC_MAP_DELETE] = &&vm_op_BC_MAP_DELETE,
+        [BC_MAP_CLEAR] = &&vm_op_BC_MAP_CLEAR,
+        [BC_MAP_UPDATE] = &&vm_op_BC_MAP_UPDATE,
+        [BC_SET_ADD] = &&vm_op_BC_SET_ADD,
+        [BC_SET_HAS] = &&vm_op_BC_SET_HAS,
+        [BC_SET_REMOVE] = &&vm_op_BC_SET_REMOVE,
+        [BC_SET_SIZE] = &&vm_op_BC_SET_SIZE,
+        [BC_SET_CLEAR] = &&vm_op_BC_SET_CLEAR,
+        [BC_SET_TO_ARRAY] = &&vm_op_BC_SET_TO_ARRAY,
+        [BC_SET_UNION] = &&vm_op_BC_SET_UNION,
+        [BC_SET_INTERSECTION] = &&vm_op_BC_SET_INTERSECTION,
+        [BC_EVAL_AST] = &&vm_op_BC_EVAL_AST,
+        [BC_MATCH] = &&vm_op_BC_MATCH,
+        [BC_MATCH_CASE] = &&vm_op_BC_MATCH_CASE,
+        [BC_MATCH_PATTERN] = &&vm_op_BC_MATCH_PATTERN,
+        [BC_MATCH_END] = &&vm_op_BC_MATCH_END,
+        [BC_PATTERN_LITERAL] = &&vm_op_BC_PATTERN_LITERAL,
+        [BC_PATTERN_WILDCARD] = &&vm_op_BC_PATTERN_WILDCARD,
+        [BC_PATTERN_TYPE] = &&vm_op_BC_PATTERN_TYPE,
+        [BC_CREATE_CLASS] = &&vm_op_BC_CREATE_CLASS,
+        [BC_INSTANTIATE_CLASS] = &&vm_op_BC_INSTANTIATE_CLASS,
+        [BC_FOR_LOOP] = &&vm_op_BC_FOR_LOOP,
+        [BC_BREAK] = &&vm_op_BC_BREAK,
+        [BC_CONTINUE] = &&vm_op_BC_CONTINUE,
+        [BC_THROW] = &&vm_op_BC_THROW,
+        [BC_TRY_START] = &&vm_op_BC_TRY_START,
+        [BC_TRY_END] = &&vm_op_BC_TRY_END,
+        [BC_CATCH] = &&vm_op_BC_CATCH,
+        [BC_SWITCH] = &&vm_op_BC_SWITCH,
+        [BC_SWITCH_CASE] = &&vm_op_BC_SWITCH_CASE,
+        [BC_SWITCH_DEFAULT] = &&vm_op_BC_SWITCH_DEFAULT,
+        [BC_CREATE_LAMBDA] = &&vm_op_BC_CREATE_LAMBDA,
+        [BC_POP] = &&vm_op_BC_POP,
+        [BC_HALT] = &&vm_op_BC_HALT,
+        [BC_LOAD_NUM] = &&vm_op_BC_LOAD_NUM,
+        [BC_LOAD_NUM_LOCAL] = &&vm_op_BC_LOAD_NUM_LOCAL,
+        [BC_STORE_NUM_LOCAL] = &&vm_op_BC_STORE_NUM_LOCAL,
+        [BC_ADD_NUM] = &&vm_op_BC_ADD_NUM,
+        [BC_SUB_NUM] = &&vm_op_BC_SUB_NUM,
+        [BC_MUL_NUM] = &&vm_op_BC_MUL_NUM,
+        [BC_DIV_NUM] = &&vm_op_BC_DIV_NUM,
+        [BC_MOD_NUM] = &&vm_op_BC_MOD_NUM,
+        [BC_LT_NUM] = &&vm_op_BC_LT_NUM,
+        [BC_LE_NUM] = &&vm_op_BC_LE_NUM,
+        [BC_GT_NUM] = &&vm_op_BC_GT_NUM,
+        [BC_GE_NUM] = &&vm_op_BC_GE_NUM,
+        [BC_EQ_NUM] = &&vm_op_BC_EQ_NUM,
+        [BC_NE_NUM] = &&vm_op_BC_NE_NUM,
+        [BC_VALUE_TO_NUM] = &&vm_op_BC_VALUE_TO_NUM,
+        [BC_NOT] = &&vm_op_BC_NOT,
+        [BC_LEFT_SHIFT] = &&vm_op_BC_LEFT_SHIFT,
+        [BC_RIGHT_SHIFT] = &&vm_op_BC_RIGHT_SHIFT,
+        [BC_BITWISE_AND] = &&vm_op_BC_BITWISE_AND,
+        [BC_BITWISE_OR] = &&vm_op_BC_BITWISE_OR,
+        [BC_BITWISE_XOR] = &&vm_op_BC_BITWISE_XOR,
+        [BC_INC_LOCAL] = &&vm_op_BC_INC_LOCAL,
+        [BC_ADD_LLL] = &&vm_op_BC_ADD_LLL,
+        [BC_ADD_LOCAL_IMM] = &&vm_op_BC_ADD_LOCAL_IMM,
+        [BC_CMP_LOCAL_IMM_JUMP_FALSE] = &&vm_op_default,
+        [BC_MUL_LOCAL_IMM] = &&vm_op_default,
+        [BC_NUM_TO_VALUE] = &&vm_op_BC_NUM_TO_VALUE,
+        [BC_CALL_FUNCTION] = &&vm_op_default,
+        [BC_RETURN] = &&vm_op_BC_RETURN,
+        [BC_PUSH_FRAME] = &&vm_op_BC_PUSH_FRAME,
+        [BC_POP_FRAME] = &&vm_op_BC_POP_FRAME,
+        [BC_ASYNC_CALL] = &&vm_op_BC_ASYNC_CALL,
+        [BC_AWAIT] = &&vm_op_BC_AWAIT,
+        [BC_PROMISE_CREATE] = &&vm_op_BC_PROMISE_CREATE,
+        [BC_PROMISE_RESOLVE] = &&vm_op_default,
+        [BC_PROMISE_REJECT] = &&vm_op_default,
+        [BC_PROMISE_THEN] = &&vm_op_default,
+        [BC_RUN_ASYNC] = &&vm_op_default,
+        [BC_ADD_NUMBERS] = &&vm_op_BC_ADD_NUMBERS,
+        [BC_ADD_STRINGS] = &&vm_op_BC_ADD_STRINGS,
+        [BC_SUB_NUMBERS] = &&vm_op_BC_SUB_NUMBERS,
+        [BC_MUL_NUMBERS] = &&vm_op_BC_MUL_NUMBERS,
+        [BC_LT_NUMBERS] = &&vm_op_BC_LT_NUMBERS,
+        [BC_LE_NUMBERS] = &&vm_op_BC_LE_NUMBERS,
+        [BC_GT_NUMBERS] = &&vm_op_BC_GT_NUMBERS,
+        [BC_GE_NUMBERS] = &&vm_op_BC_GE_NUMBERS,
+        [BC_ARRAY_GET_DENSE] = &&vm_op_BC_ARRAY_GET_DENSE,
+    };
+#endif
+    
+    if (UNLIKELY(!program->code)) {
+        interpreter_set_error(interpreter, "Bytecode program code is NULL", 0, 0);
+        goto cleanup;
     }
     
     while (pc < program->count) {
-        // Check for errors before executing next instruction (like AST interpreter)
-        // But allow execution to continue if we're inside a try block (try_depth > 0)
-        // This allows BC_TRY_END and BC_CATCH to handle the error
-        if (!program->code) {
-            if (interpreter) {
-                interpreter_set_error(interpreter, "Bytecode program code is NULL", 0, 0);
-            }
-            break;
-        }
         BytecodeInstruction* instr = &program->code[pc];
+        vm_instructions_retired++;
         
-        // Debug: Log when we're about to execute BC_DEFINE_FUNCTION
-        if (instr->op == BC_DEFINE_FUNCTION) {
-            int name_idx = instr->a;
-            if (name_idx >= 0 && name_idx < (int)program->const_count && 
-                program->constants && program->constants[name_idx].type == VALUE_STRING) {
-                const char* func_name = program->constants[name_idx].data.string_value;
-                if (func_name && (strcmp(func_name, "Client") == 0 || strcmp(func_name, "Intents") == 0)) {
-                    // Debug output removed
-                }
-            }
-        }
-        
-        // Debug: Log execution progress for module bytecode
-        if (program->count > 100) {
-            // Log every instruction from PC=30 to PC=110 to see where execution stops
-            if (pc >= 30 && pc <= 110) {
-                const char* op_name = "UNKNOWN";
-                if (instr->op == BC_STORE_LOCAL) op_name = "BC_STORE_LOCAL";
-                else if (instr->op == BC_CALL_USER_FUNCTION) op_name = "BC_CALL_USER_FUNCTION";
-                else if (instr->op == BC_CALL_FUNCTION_VALUE) op_name = "BC_CALL_FUNCTION_VALUE";
-                else if (instr->op == BC_DEFINE_FUNCTION) op_name = "BC_DEFINE_FUNCTION";
-                else if (instr->op == BC_HALT) op_name = "BC_HALT";
-                else if (instr->op == BC_POP) op_name = "BC_POP";
-                else if (instr->op == BC_LOAD_CONST) op_name = "BC_LOAD_CONST";
-                else if (instr->op == BC_IMPORT_LIB) op_name = "BC_IMPORT_LIB";
-                else if (instr->op == BC_PROPERTY_ACCESS) op_name = "BC_PROPERTY_ACCESS";
-                else if (instr->op == BC_PROPERTY_SET) op_name = "BC_PROPERTY_SET";
-                else if (instr->op == BC_METHOD_CALL) op_name = "BC_METHOD_CALL";
-                else if (instr->op == BC_CREATE_OBJECT) op_name = "BC_CREATE_OBJECT";
-                else if (instr->op == BC_CREATE_MAP) op_name = "BC_CREATE_MAP";
-                else if (instr->op == BC_CREATE_LAMBDA) op_name = "BC_CREATE_LAMBDA";
-                else if (instr->op == BC_LOAD_LOCAL) op_name = "BC_LOAD_LOCAL";
-            } else if (pc == 0 || pc == program->count - 1) {
-            }
-        }
-        
-        // If we have an error and we're not in a try block, clear error and continue execution
-        // Error was already reported by interpreter_set_error
-        if (interpreter && interpreter_has_error(interpreter) && interpreter->try_depth == 0) {
-            interpreter_clear_error(interpreter);
-        }
-        
-        // If we have an error and we're in a try block, skip instructions until BC_TRY_END or BC_CATCH
-        if (interpreter && interpreter_has_error(interpreter) && interpreter->try_depth > 0) {
-            // Skip instructions until we find BC_TRY_END or BC_CATCH
-            if (instr->op != BC_TRY_END && instr->op != BC_CATCH) {
+        // Handlers that can fail return here. An error outside a try block
+        // has already been reported, so it is cleared and execution resumes;
+        // inside a try block, instructions are skipped until BC_TRY_END or
+        // BC_CATCH picks the error up.
+        if (UNLIKELY(interpreter->has_error)) {
+            if (interpreter->try_depth == 0) {
+                interpreter_clear_error(interpreter);
+            } else if (instr->op != BC_TRY_END && instr->op != BC_CATCH) {
                 pc++;
                 continue;
             }
-            // Found BC_TRY_END or BC_CATCH - continue normal execution to handle the error
         }
         
         // Prefetch next instruction for better cache performance
@@ -1344,23 +2078,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
             PREFETCH_READ(&program->code[pc + 1]);
         }
         
-        // Track hot spots for JIT compilation (disabled for now due to crashes)
-        // if (interpreter && interpreter->hot_spot_tracker) {
-        //     HotSpotTracker* tracker = (HotSpotTracker*)interpreter->hot_spot_tracker;
-        //     
-        //     // Only track if tracker is valid
-        //     if (tracker) {
-        //         // Track execution frequency for this instruction (simplified tracking)
-        //         hot_spot_tracker_record_execution(tracker, NULL, 1000); // 1 microsecond per instruction
-        //         
-        //         // Check if this is a hot spot that should be JIT compiled
-        //         if (hot_spot_tracker_is_hot(tracker, NULL)) {
-        //             // Mark this instruction as hot for potential JIT compilation
-        //             hot_spot_tracker_mark_hot(tracker, NULL, HOT_SPOT_FUNCTION);
-        //         }
-        //     }
-        // }
-        
+        VM_TRACE_INSTR(program, pc, instr);
         if (debug) {
             printf("PC: %zu, Op: %d, A: %d, B: %d\n", pc, instr->op, instr->a, instr->b);
         }
@@ -1385,21 +2103,13 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
             }
         } else {
             // Handle regular bytecode operations
-            // Debug: Log BC_DEFINE_FUNCTION instructions
-            if (instr->op == BC_DEFINE_FUNCTION && interpreter && interpreter->current_environment) {
-                int name_idx = instr->a;
-                if (name_idx >= 0 && name_idx < (int)program->const_count && 
-                    program->constants && program->constants[name_idx].type == VALUE_STRING) {
-                    const char* func_name = program->constants[name_idx].data.string_value;
-                    if (func_name && (strcmp(func_name, "Client") == 0 || strcmp(func_name, "Intents") == 0)) {
-                    }
-                }
-            }
-            // Debug: Log before switch for BC_GE_NUM
-            if (program->count > 100 && pc == 80 && instr->op == BC_GE_NUM) {
+#if VM_COMPUTED_GOTO
+            if (LIKELY((unsigned)instr->op < BC_OP_COUNT)) {
+                __extension__ ({ goto *vm_dispatch_table[instr->op]; });
             }
+#endif
             switch (instr->op) {
-            case BC_LOAD_CONST: {
+            VM_CASE(BC_LOAD_CONST) {
                 if (LIKELY(instr->a < program->const_count)) {
                     Value const_val = program->constants[instr->a];
                     // String constants are already processed during compilation, so just clone them
@@ -1407,11 +2117,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     if (LIKELY(const_val.type == VALUE_STRING)) {
                         value_stack_push(value_clone(&const_val));
                     } else if (LIKELY(const_val.type == VALUE_NUMBER)) {
-                        value_stack_push(fast_create_number(program, const_val.data.number_value));
+                        value_stack_push_word(nan_boxing_create_number(const_val.data.number_value));
                     } else if (const_val.type == VALUE_BOOLEAN) {
-                        value_stack_push(fast_create_boolean(program, const_val.data.boolean_value));
+                        value_stack_push_word(nan_boxing_create_boolean(const_val.data.boolean_value));
                     } else if (const_val.type == VALUE_NULL) {
-                        value_stack_push(fast_create_null(program));
+                        value_stack_push_word(NAN_BOX_NULL_VALUE);
                     } else {
                         value_stack_push(value_clone(&const_val));
                     }
@@ -1419,169 +2129,60 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     value_stack_push(fast_create_null(program));
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_LOAD_LOCAL: {
-                if (LIKELY(instr->a < program->local_slot_count)) {
-                    // Check if variable exists in environment (may have been updated by AST interpreter)
-                    // If so, use the environment value; otherwise use local slot
-                    Value local_val = program->locals[instr->a];
-                    const char* var_name = NULL;
-                    if (program->local_names && instr->a >= 0 && (size_t)instr->a < program->local_count) {
-                        var_name = program->local_names[instr->a];
-                    }
-                    
-                    // Always check environment first (BC_STORE_LOCAL stores values in environment)
-                    // This ensures we get the latest value even if local slot is stale
-                    Value env_val = value_create_null();
-                    if (interpreter && interpreter->current_environment && var_name) {
-                        if (environment_exists(interpreter->current_environment, var_name)) {
-                            env_val = environment_get(interpreter->current_environment, var_name);
-                        }
-                    }
-                    
-                    // Also check global environment for modules
-                    if (env_val.type == VALUE_NULL && interpreter && interpreter->global_environment && var_name) {
-                        env_val = environment_get(interpreter->global_environment, var_name);
-                    }
-                    
-                    if (env_val.type != VALUE_NULL) {
-                        // Variable exists in environment - use that (may be newer)
-                        // Update local slot to match environment if local is Null or different
-                        if (local_val.type == VALUE_NULL || 
-                            (local_val.type == VALUE_OBJECT && env_val.type == VALUE_OBJECT && 
-                             local_val.data.object_value.count != env_val.data.object_value.count)) {
-                            value_free(&program->locals[instr->a]);
-                            program->locals[instr->a] = value_clone(&env_val);
-                            local_val = program->locals[instr->a];
-                        }
-                        // Push the environment value (clone it since value_stack_push does shallow copy)
-                        Value cloned_env_val = value_clone(&env_val);
-                        value_free(&env_val);
-                        value_stack_push(cloned_env_val);
-                } else {
-                        // Variable not in environment - use local slot
-                        // But if local is null, also check program locals (for variables defined earlier in same program)
-                        if (local_val.type == VALUE_NULL && var_name && program->local_names && program->locals) {
-                            for (int i = 0; i < (int)program->local_count; i++) {
-                                if (program->local_names[i] && strcmp(program->local_names[i], var_name) == 0 && i != instr->a) {
-                                    Value found_val = program->locals[i];
-                                    if (found_val.type != VALUE_NULL) {
-                                        local_val = value_clone(&found_val);
-                                        // Update the current local slot too
-                                        value_free(&program->locals[instr->a]);
-                                        program->locals[instr->a] = value_clone(&found_val);
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        value_stack_push(local_val.type != VALUE_NULL ? value_clone(&local_val) : value_create_null());
+            VM_CASE(BC_LOAD_LOCAL) {
+                if (frame) {
+                    // Function frame: slots are base-pointer relative on the value stack
+                    if (LIKELY(instr->a >= 0 && (size_t)instr->a < frame_local_count)) {
+                        value_stack_push_word(nan_boxing_clone(value_stack[frame_base + instr->a]));
+                    } else {
+                        value_stack_push(value_create_null());
                     }
-                } else {
-                    // Invalid local index - push null
-                    value_stack_push(value_create_null());
+                    pc++;
+                    VM_NEXT();
                 }
+                value_stack_push(bc_main_local_load(interpreter, program, instr->a));
                 pc++;
                 break;
             }
             
-            case BC_LOAD_VAR: {
+            VM_CASE(BC_LOAD_VAR) {
                 // Load variable from environment
                 if (LIKELY(instr->a < program->const_count)) {
                     Value var_name = program->constants[instr->a];
                     if (LIKELY(var_name.type == VALUE_STRING)) {
                         Value var_val = environment_get(interpreter->current_environment, var_name.data.string_value);
                         value_stack_push(var_val);
-                    } else {
-                        value_stack_push(value_create_null());
-                    }
-                } else {
-                    value_stack_push(value_create_null());
-                }
-                pc++;
-                break;
-            }
-            
-            case BC_STORE_LOCAL: {
-                if (instr->a < program->local_slot_count) {
-                    Value val = value_stack_pop();
-                    
-                    // Get variable name from local_names array (if available)
-                    const char* var_name = NULL;
-                    if (program->local_names && instr->a >= 0 && (size_t)instr->a < program->local_count) {
-                        var_name = program->local_names[instr->a];
-                    }
-                    
-                    // If name not found in local_names, try to get it from constants pool (instr->b)
-                    // This allows BC_STORE_LOCAL to store in environment even if program->local_count is 0
-                    // instr->b contains the variable name index in the constants pool (added by compiler)
-                    if (!var_name && instr->b > 0 && instr->b < (int)program->const_count && 
-                        program->constants[instr->b].type == VALUE_STRING) {
-                        var_name = program->constants[instr->b].data.string_value;
-                    }
-                    
-                    // Debug: Always log BC_STORE_LOCAL at PC=75 to see what's being stored
-                    if (program->count > 100 && pc == 75) {
-                        if (instr->b > 0 && instr->b < (int)program->const_count && program->constants[instr->b].type == VALUE_STRING) {
-                        }
-                    }
-                    if (var_name && (strcmp(var_name, "client") == 0 || strcmp(var_name, "Intents") == 0)) {
-                    }
-                    
-                    value_free(&program->locals[instr->a]);
-                    
-                    // Also update numeric locals if this is a number
-                    if (val.type == VALUE_NUMBER && instr->a < program->num_local_count) {
-                        program->num_locals[instr->a] = val.data.number_value;
-                    }
-                    
-                    // For complex types (objects, arrays, hash maps, sets), clone to ensure internal pointers are valid
-                    // For simple types (numbers, booleans, null), store directly
-                    Value stored_val;
-                    if (val.type == VALUE_OBJECT || val.type == VALUE_ARRAY || val.type == VALUE_FUNCTION || 
-                        val.type == VALUE_ASYNC_FUNCTION || val.type == VALUE_HASH_MAP || val.type == VALUE_SET) {
-                        stored_val = value_clone(&val);
-                        value_free(&val);
-                    } else {
-                        // Store the value directly (don't clone) - the value on stack is already a clone from BC_LOAD_LOCAL
-                        stored_val = val;
-                    }
-                    program->locals[instr->a] = stored_val;
-                    
-                    // Also store in environment so AST-interpreted code (like for loop bodies) can access it
-                    // This ensures variables are accessible via BC_LOAD_GLOBAL even if program->local_count is 0
-                    if (interpreter && var_name) {
-                        // Always store in current environment (or create it if needed)
-                        // This ensures variables are accessible via BC_LOAD_GLOBAL
-                        if (!interpreter->current_environment) {
-                            interpreter->current_environment = environment_create(NULL);
-                        }
-                        if (interpreter->current_environment) {
-                            // Store in environment (clones the value)
-                            // Use stored_val which is already cloned for complex types
-                            if (environment_exists(interpreter->current_environment, var_name)) {
-                                environment_assign(interpreter->current_environment, var_name, stored_val);
-                            } else {
-                                environment_define(interpreter->current_environment, var_name, stored_val);
-                            }
-                            if (strcmp(var_name, "client") == 0) {
-                                Value check = environment_get(interpreter->current_environment, var_name);
-                            }
-                        }
-                    } else if (strcmp(var_name ? var_name : "", "client") == 0) {
+                    } else {
+                        value_stack_push(value_create_null());
                     }
                 } else {
-                    // Invalid local index - pop value from stack but don't store it
-                    Value val = value_stack_pop();
-                    value_free(&val);
+                    value_stack_push(value_create_null());
+                }
+                pc++;
+                break;
+            }
+            
+            VM_CASE(BC_STORE_LOCAL) {
+                if (frame) {
+                    NanBoxedValue val = value_stack_size > 0 ? value_stack[--value_stack_size] : NAN_BOX_NULL_VALUE;
+                    if (LIKELY(instr->a >= 0 && (size_t)instr->a < frame_local_count)) {
+                        nan_boxing_release(value_stack[frame_base + instr->a]);
+                        value_stack[frame_base + instr->a] = val;
+                    } else {
+                        nan_boxing_release(val);
+                    }
+                    pc++;
+                    VM_NEXT();
                 }
+                bc_main_local_store(interpreter, program, instr->a, instr->b, value_stack_pop());
                 pc++;
                 break;
             }
             
-            case BC_LOAD_GLOBAL: {
+            VM_CASE(BC_LOAD_GLOBAL) {
                 // Load global variable by name
                 // Check program locals first (for variables defined in the same program),
                 // then current environment (for loop variables, local scope), then global
@@ -1590,8 +2191,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     if (program->constants[instr->a].type == VALUE_STRING) {
                     const char* var_name = program->constants[instr->a].data.string_value;
                         
-                        if (strcmp(var_name, "client") == 0 || strcmp(var_name, "Client") == 0) {
-                        }
                         
                         // First check program locals (for variables defined in the same program)
                         if (var_name && program->local_names && program->locals) {
@@ -1627,15 +2226,9 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         
                         // If not found in current, try global environment (where modules are stored)
                         if (loaded_val.type == VALUE_NULL && var_name && interpreter && interpreter->global_environment) {
-                            if (strcmp(var_name, "DISCORD_GATEWAY_URL") == 0 || strcmp(var_name, "gateway") == 0) {
-                            }
                             loaded_val = environment_get(interpreter->global_environment, var_name);
-                            if (strcmp(var_name, "DISCORD_GATEWAY_URL") == 0 || strcmp(var_name, "gateway") == 0) {
-                            }
                         }
                         
-                        if (strcmp(var_name, "client") == 0 || strcmp(var_name, "Client") == 0) {
-                        }
                     }
                 }
                 value_stack_push(loaded_val);
@@ -1643,9 +2236,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_STORE_GLOBAL: {
+            VM_CASE(BC_STORE_GLOBAL) {
                 // Store global variable by name
                 // Store in current environment if available, otherwise global environment
+                // instr->b = 1 for a `let`: always bind in that environment
                 if (instr->a < program->const_count && program->constants[instr->a].type == VALUE_STRING) {
                     const char* var_name = program->constants[instr->a].data.string_value;
                     Value val = value_stack_pop();
@@ -1653,7 +2247,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     
                     // Use environment_assign to update existing variable, or environment_define if it doesn't exist
                     // environment_assign/define will clone the value internally
-                    if (environment_exists(target_env, var_name)) {
+                    if (instr->b != 1 && environment_exists(target_env, var_name)) {
                         environment_assign(target_env, var_name, val);
                     } else {
                         environment_define(target_env, var_name, val);
@@ -1670,7 +2264,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ADD: {
+            VM_CASE(BC_ADD) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_number(na + nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 
@@ -1690,7 +2291,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SUB: {
+            VM_CASE(BC_SUB) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_number(na - nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_subtract(&a, &b);
@@ -1701,7 +2309,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MUL: {
+            VM_CASE(BC_MUL) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_number(na * nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_multiply(&a, &b);
@@ -1712,7 +2327,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_DIV: {
+            VM_CASE(BC_DIV) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_divide(&a, &b);
@@ -1723,7 +2338,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MOD: {
+            VM_CASE(BC_MOD) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_modulo(&a, &b);
@@ -1734,7 +2349,13 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_EQ: {
+            VM_CASE(BC_EQ) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_boolean(na == nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_equal(&a, &b);
@@ -1745,7 +2366,13 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_NE: {
+            VM_CASE(BC_NE) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_boolean(na != nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value eq = value_equal(&a, &b);
@@ -1758,7 +2385,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_LT: {
+            VM_CASE(BC_LT) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_boolean(na < nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_less_than(&a, &b);
@@ -1769,7 +2403,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_LE: {
+            VM_CASE(BC_LE) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_boolean(na <= nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value lt = value_less_than(&a, &b);
@@ -1784,7 +2425,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_GT: {
+            VM_CASE(BC_GT) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_boolean(na > nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value result = value_greater_than(&a, &b);
@@ -1795,7 +2443,14 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_GE: {
+            VM_CASE(BC_GE) {
+                bc_quicken(program, pc);
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    value_stack_replace_pair(nan_boxing_create_boolean(na >= nb));
+                    pc++;
+                    VM_NEXT();
+                }
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 Value gt = value_greater_than(&a, &b);
@@ -1810,7 +2465,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_AND: {
+            VM_CASE(BC_AND) {
                 // Logical AND: a && b (short-circuit evaluation)
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
@@ -1834,7 +2489,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_OR: {
+            VM_CASE(BC_OR) {
                 // Logical OR: a || b (short-circuit evaluation)
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
@@ -1858,10 +2513,22 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_JUMP: {
+            VM_CASE(BC_JUMP) {
                 // Validate jump target to prevent jumping out of bounds
                 // Jump targets are absolute addresses within the function's bytecode
                 if (instr->a >= 0 && instr->a < (int)program->count) {
+                    // A back-edge in a hot function continues the loop in
+                    // register code when no operands are pending
+                    if ((size_t)instr->a <= pc && frame && frame->function) {
+                        RegisterProgram* register_code = bc_tier_up(interpreter, frame->owner, frame->function);
+                        if (register_code && value_stack_size == operand_base) {
+                            size_t entry = register_tier_entry_point(register_code, (size_t)instr->a);
+                            if (entry != SIZE_MAX) {
+                                result = bc_run_register_frame(interpreter, frame->owner, register_code, frame_base, entry);
+                                goto cleanup;
+                            }
+                        }
+                    }
                     // Jump to target - even if it's BC_HALT, let the VM loop handle it naturally
                     pc = instr->a;
                 } else {
@@ -1884,23 +2551,32 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         pc++;
                     }
                 }
-                break;
+                VM_NEXT();
             }
             
-            case BC_JUMP_IF_FALSE: {
+            VM_CASE(BC_JUMP_IF_FALSE) {
                 // Check if stack is empty (shouldn't happen, but handle gracefully)
-                if (value_stack_size == 0) {
+                if (value_stack_size <= operand_base) {
                     if (interpreter) {
                         interpreter_set_error(interpreter, "Stack underflow in BC_JUMP_IF_FALSE - condition not on stack", 0, 0);
                     }
                     goto cleanup;
                 }
                 
-                Value condition = value_stack_pop();
-                // Convert to boolean if needed
-                Value bool_condition = value_to_boolean(&condition);
-                bool should_jump = (bool_condition.type == VALUE_BOOLEAN && !bool_condition.data.boolean_value);
-                value_free(&bool_condition);
+                NanBoxedValue condition_word = value_stack[value_stack_size - 1];
+                bool should_jump;
+                if (LIKELY(nan_boxing_is_boolean(condition_word))) {
+                    // Comparison results never leave the word encoding
+                    value_stack_size--;
+                    should_jump = !nan_boxing_get_boolean(condition_word);
+                } else {
+                    Value condition = value_stack_pop();
+                    // Convert to boolean if needed
+                    Value bool_condition = value_to_boolean(&condition);
+                    should_jump = (bool_condition.type == VALUE_BOOLEAN && !bool_condition.data.boolean_value);
+                    value_free(&bool_condition);
+                    value_free(&condition);
+                }
                 
                 if (should_jump) {
                     // Validate jump target to prevent jumping out of bounds
@@ -1920,7 +2596,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             } else {
                                 // Way out of bounds - report as error
                                 interpreter_set_error(interpreter, "Invalid jump target in BC_JUMP_IF_FALSE", 0, 0);
-                                value_free(&condition);
                                 goto cleanup;
                             }
                         } else {
@@ -1931,11 +2606,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 } else {
                     pc++;
                 }
-                value_free(&condition);
-                break;
+                VM_NEXT();
             }
             
-            case BC_NOT: {
+            VM_CASE(BC_NOT) {
                 // Logical NOT: convert value to boolean and negate
                 Value operand = value_stack_pop();
                 Value bool_val = value_to_boolean(&operand);
@@ -1947,24 +2621,27 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 value_free(&bool_val);
                 value_stack_push(result);
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_LOOP_START: {
-                // Mark the start of a loop for potential optimization
-                // For now, just continue execution
-                pc++;
-                break;
+            VM_CASE(BC_LOOP_START) {
+                // Main-program loop headers may run a recorded trace (see LOOP TRACES)
+                if (!frame && !debug && program->local_names) {
+                    pc = bc_loop_trace_enter(interpreter, program, pc);
+                } else {
+                    pc++;
+                }
+                VM_NEXT();
             }
             
-            case BC_LOOP_END: {
+            VM_CASE(BC_LOOP_END) {
                 // Mark the end of a loop iteration
                 // For now, just continue execution
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_PRINT: {
+            VM_CASE(BC_PRINT) {
                 Value val = value_stack_pop();
                 value_print(&val);
                 value_free(&val);
@@ -1972,7 +2649,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_PRINT_MULTIPLE: {
+            VM_CASE(BC_PRINT_MULTIPLE) {
                 // Print multiple values on one line
                 int count = instr->a;
                 for (int i = 0; i < count; i++) {
@@ -1988,13 +2665,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_METHOD_CALL: {
-                // Debug: log method calls for connect, send_message, close
-                if (instr->a < program->const_count && program->constants[instr->a].type == VALUE_STRING) {
-                    const char* method_name = program->constants[instr->a].data.string_value;
-                    if (method_name && (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0)) {
-                    }
-                }
+            VM_CASE(BC_METHOD_CALL) {
                 // Declare variables outside the if block
                 int arg_count = instr->b;
                 Value* args = NULL;
@@ -2048,9 +2719,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     // We'll check this after getting the method from the object
                     int should_reverse_args = 1;  // Default: reverse for regular functions
                     
-                    // Debug: log object immediately after popping
-                    if (method_name && (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0)) {
-                    }
                     
                     // Handle null object case
                     if (object.type == VALUE_NULL) {
@@ -2067,9 +2735,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         break;
                     }
                     
-                    // Debug: log object type for connect method
-                    if (method_name && (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0)) {
-                    }
                     
                     // Handle different object types
                     if (object.type == VALUE_ARRAY) {
@@ -2105,13 +2770,13 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         pc++;
                         break;
                     } else if (object.type == VALUE_HASH_MAP) {
-                        // Debug: log hash map method calls
-                        if (method_name && (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0)) {
-                        }
                         // Handle map methods
                         if (strcmp(method_name, "set") == 0) {
                             Value result = builtin_map_set(NULL, (Value[]){object, args[0], args[1]}, 3, 0, 0);
                             value_stack_push(result);
+                        } else if (strcmp(method_name, "get") == 0 && arg_count == 1) {
+                            Value result = builtin_map_get(NULL, (Value[]){object, args[0]}, 2, 0, 0);
+                            value_stack_push(result);
                         } else if (strcmp(method_name, "has") == 0) {
                             Value result = builtin_map_has(NULL, (Value[]){object, args[0]}, 2, 0, 0);
                             value_stack_push(result);
@@ -2158,17 +2823,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             
                             
                             if (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0) {
-                                if (method.type == VALUE_NULL) {
-                                }
                             }
                             
-                            if (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0) {
-                            }
                             
                             if (method.type == VALUE_FUNCTION || method.type == VALUE_ASYNC_FUNCTION) {
                                 if (method.type == VALUE_ASYNC_FUNCTION) {
-                                    if (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0) {
-                                    }
                                     // Async function - handle via async execution path
                                     ASTNode* body_ptr = (ASTNode*)method.data.async_function_value.body;
                                     uintptr_t body_addr = (uintptr_t)body_ptr;
@@ -2232,8 +2891,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                                     }
                                                 }
                                             }
-                                            if (func_program) {
-                                            }
                                         }
                                         
                                         if (func_program && func_id >= 0 && func_id < (int)func_program->function_count) {
@@ -2364,8 +3021,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 // Method not found in hash map or not a function
                                 if (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0) {
                                     // If method is null, this explains why await resolves immediately
-                                    if (method.type == VALUE_NULL) {
-                                    }
                                 }
                                 value_free(&method);
                                 value_stack_push(value_create_null());
@@ -2401,12 +3056,21 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             value_stack_push(value_create_null());
                         }
                     } else if (object.type == VALUE_OBJECT) {
-                        // Debug: log object method calls
-                        if (method_name && (strcmp(method_name, "connect") == 0 || strcmp(method_name, "send_message") == 0 || strcmp(method_name, "close") == 0)) {
+                        // Class instances whose method this site already resolved
+                        bool method_handled = false;
+                        Value* cached_method = bc_cached_method(interpreter, program, pc, &object);
+                        if (cached_method) {
+                            Value method = value_clone(cached_method);
+                            interpreter_set_self_context(interpreter, &object);
+                            Value result = value_function_call_with_self(&method, args, arg_count, interpreter, &object, 0, 0);
+                            interpreter_set_self_context(interpreter, NULL);
+                            value_stack_push(result);
+                            value_free(&method);
+                            method_handled = true;
                         }
+                        
                         // Check if it's a module object first
-                        Value object_type = value_object_get(&object, "__type__");
-                        bool method_handled = false;
+                        Value object_type = method_handled ? value_create_null() : value_object_get(&object, "__type__");
                         BytecodeProgram* saved_cache_for_module = NULL;
                         
                         if (object_type.type == VALUE_STRING && strcmp(object_type.data.string_value, "Module") == 0) {
@@ -2473,7 +3137,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 for (size_t i = 0; i < object.data.object_value.count; i++) {
                                     if (object.data.object_value.keys[i] && 
                                         strcmp(object.data.object_value.keys[i], "__class_name__") == 0) {
-                                        Value* class_name_val = (Value*)object.data.object_value.values[i];
+                                        Value* class_name_val = &object.data.object_value.values[i];
                                         if (class_name_val && class_name_val->type == VALUE_STRING &&
                                             strcmp(class_name_val->data.string_value, "Window") == 0) {
                                             is_window = true;
@@ -2502,10 +3166,12 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             // Check if it's a library instance (has __class_name__ but not a VALUE_CLASS)
                             Value class_name = value_object_get(&object, "__class_name__");
                         if (class_name.type == VALUE_STRING) {
-                            // Check if it's a Server or Window instance (needs special handling - pass object as first arg)
+                            // Check if it's a Server, Request, Response or Window instance (needs special handling - pass object as first arg)
                             if (strcmp(class_name.data.string_value, "Server") == 0 ||
+                                strcmp(class_name.data.string_value, "Request") == 0 ||
+                                strcmp(class_name.data.string_value, "Response") == 0 ||
                                 strcmp(class_name.data.string_value, "Window") == 0) {
-                                // Server and Window methods need object as first argument
+                                // Server, Request, Response and Window methods need object as first argument
                                 Value method = {0};
                                 bool method_found = false;
                                 bool is_builtin = false;
@@ -2622,6 +3288,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 if (class_def.type == VALUE_CLASS) {
                                     Value method = find_method_in_inheritance_chain(interpreter, &class_def, method_name);
                                     if (method.type == VALUE_FUNCTION) {
+                                        if (strcmp(class_name.data.string_value, "Server") != 0 &&
+                                            strcmp(class_name.data.string_value, "Window") != 0) {
+                                            bc_cache_method(program, pc, &object, &class_def, &method);
+                                        }
+                                        
                                         // Set self context and call method
                                         interpreter_set_self_context(interpreter, &object);
                                         
@@ -2644,10 +3315,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             // It's a regular object - get method directly
                             Value method = value_object_get(&object, method_name);
                             if (strcmp(method_name, "on") == 0) {
-                                if (arg_count > 0) {
-                                }
-                                if (arg_count > 1) {
-                                }
                             }
                             if (method.type == VALUE_FUNCTION || method.type == VALUE_ASYNC_FUNCTION) {
                                 if (method.type == VALUE_ASYNC_FUNCTION) {
@@ -2802,7 +3469,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_PROPERTY_ACCESS: {
+            VM_CASE(BC_PROPERTY_ACCESS) {
                 // Get property name from constant pool
                 if (instr->a < program->const_count && program->constants[instr->a].type == VALUE_STRING) {
                     const char* prop_name = program->constants[instr->a].data.string_value;
@@ -2933,7 +3600,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     
                     // Default: try object property access
                     if (object.type == VALUE_OBJECT) {
-                        Value prop = value_object_get(&object, prop_name);
+                        int slot = bc_object_slot(program, pc, &object, prop_name);
+                        Value prop = value_create_null();
+                        if (slot >= 0 && !value_is_shared(&object)) {
+                            // Last holder of the object: move the property out
+                            prop = object.data.object_value.values[slot];
+                            object.data.object_value.values[slot] = value_create_null();
+                        } else if (slot >= 0) {
+                            prop = value_clone(&object.data.object_value.values[slot]);
+                        }
                         value_stack_push(prop);
                         value_free(&object);
                         pc++;
@@ -2952,7 +3627,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_PROPERTY_SET: {
+            VM_CASE(BC_PROPERTY_SET) {
                 // Set object property: obj.property = value
                 // Stack: [object, value] -> []
                 // instr->a = property name constant index
@@ -2960,20 +3635,20 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 // instr->c = 1 if simple variable, 0 if complex
                 if (instr->a < program->const_count && program->constants[instr->a].type == VALUE_STRING) {
                     const char* prop_name = program->constants[instr->a].data.string_value;
-                    fprintf(stderr, "[BC_PROPERTY_SET] Stack size before pop: %zu\n", value_stack_size);
+                    VM_TRACE("[BC_PROPERTY_SET] Stack size before pop: %zu\n", value_stack_size);
                     Value value = value_stack_pop();
-                    fprintf(stderr, "[BC_PROPERTY_SET] Popped value, type=%d, stack size now: %zu\n", value.type, value_stack_size);
+                    VM_TRACE("[BC_PROPERTY_SET] Popped value, type=%d, stack size now: %zu\n", value.type, value_stack_size);
                     Value object = value_stack_pop();
-                    fprintf(stderr, "[BC_PROPERTY_SET] Popped object, type=%d, stack size now: %zu\n", object.type, value_stack_size);
+                    VM_TRACE("[BC_PROPERTY_SET] Popped object, type=%d, stack size now: %zu\n", object.type, value_stack_size);
                     
                     // Debug: log property set
-                    fprintf(stderr, "[BC_PROPERTY_SET] Setting property '%s' on object type=%d, value type=%d\n", 
+                    VM_TRACE("[BC_PROPERTY_SET] Setting property '%s' on object type=%d, value type=%d\n", 
                             prop_name, object.type, value.type);
                     if (value.type == VALUE_HASH_MAP) {
-                        fprintf(stderr, "[BC_PROPERTY_SET] Value is HashMap with %zu entries\n", 
+                        VM_TRACE("[BC_PROPERTY_SET] Value is HashMap with %zu entries\n", 
                                 value.data.hash_map_value.count);
                     } else if (value.type == VALUE_NULL) {
-                        fprintf(stderr, "[BC_PROPERTY_SET] ERROR: Value is NULL! This should not happen.\n");
+                        VM_TRACE("[BC_PROPERTY_SET] ERROR: Value is NULL! This should not happen.\n");
                     }
                     
                     // Check if object is null before property set
@@ -2998,6 +3673,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             const char* var_name = var_name_val.data.string_value;
                             
                             // First, modify the object in place
+                            bc_release_for_write(interpreter, program, var_name, &object);
                             if (object.type == VALUE_HASH_MAP) {
                                 Value key = value_create_string(prop_name);
                                 value_hash_map_set(&object, key, value);
@@ -3005,7 +3681,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             }
                             // Object property set (modifies object in place)
                             else if (object.type == VALUE_OBJECT) {
-                                value_object_set(&object, prop_name, value);
+                                bc_object_store(program, pc, &object, prop_name, value);
                             }
                             // For other types, silently ignore (similar to how property access returns null)
                             
@@ -3146,7 +3822,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         }
                         // Object property set (modifies object in place)
                         else if (object.type == VALUE_OBJECT) {
-                            value_object_set(&object, prop_name, value);
+                            bc_object_store(program, pc, &object, prop_name, value);
                         }
                         // For other types, silently ignore (similar to how property access returns null)
                     }
@@ -3157,7 +3833,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     value_free(&object);
                 } else {
                     // Invalid property name - pop and discard
-                    if (value_stack_size >= 2) {
+                    if (value_stack_size >= operand_base + 2) {
                         Value value = value_stack_pop();
                         Value object = value_stack_pop();
                         value_free(&value);
@@ -3168,7 +3844,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CALL_BUILTIN: {
+            VM_CASE(BC_CALL_BUILTIN) {
                 // Call built-in function by name
                 // instr->a = function name constant index, instr->b = argument count
                 if (instr->a < program->const_count && program->constants[instr->a].type == VALUE_STRING) {
@@ -3256,12 +3932,12 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_RETURN: {
+            VM_CASE(BC_RETURN) {
                 // IMPORTANT: Check if we're executing module-level bytecode (not function bytecode)
                 // Module-level bytecode has program->count > 100 and we're not in a function execution context
                 // Function bytecode is executed via bytecode_execute_function_bytecode, which creates a temp_program
                 // We can detect function bytecode execution by checking if program->code points to function->code
-                if (program->count > 100) {
+                if (!frame && program->count > 100) {
                     // Check if this is function bytecode by seeing if the program structure matches a function
                     // Function bytecode programs have code pointing to func->code, not the main program code
                     // For now, check if we're in a function context AND the program is large (module bytecode)
@@ -3292,13 +3968,12 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 // This workaround should NOT apply during async function execution or module-level code
                 bool is_function_context_for_workaround = interpreter && interpreter->current_environment && interpreter->global_environment && 
                                                          (interpreter->current_environment != interpreter->global_environment);
-                if (program->count > 100 && pc >= 80 && pc <= 200 && instr->a == 0 && 
-                    value_stack_size >= 2 && !interpreter->has_return && is_function_context_for_workaround) {
+                if (!frame && program->count > 100 && pc >= 80 && pc <= 200 && instr->a == 0 && 
+                    value_stack_size >= operand_base + 2 && !interpreter->has_return && is_function_context_for_workaround) {
                     // Check if both stack values are numbers (bit shift operation)
                     // Peek at the top two values without popping
-                    Value* top = value_stack_size >= 2 ? &value_stack[value_stack_size - 1] : NULL;
-                    Value* second = value_stack_size >= 2 ? &value_stack[value_stack_size - 2] : NULL;
-                    if (top && second && top->type == VALUE_NUMBER && second->type == VALUE_NUMBER) {
+                    double top_num, second_num;
+                    if (value_stack_numeric_pair(&second_num, &top_num)) {
                         Value b = value_stack_pop();
                         Value a = value_stack_pop();
                         int64_t a_int = (int64_t)a.data.number_value;
@@ -3328,71 +4003,41 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 goto cleanup;
             }
             
-            case BC_CALL_USER_FUNCTION: {
+            VM_CASE(BC_PUSH_FRAME) {
+                // Function prologue: reserve the frame's let slots above its arguments
+                if (frame) {
+                    while (value_stack_size < frame_base + (size_t)instr->a) {
+                        value_stack_push(value_create_null());
+                    }
+                }
+                pc++;
+                break;
+            }
+            
+            VM_CASE(BC_POP_FRAME) {
+                // Return from a frame-slot function (a = return value count);
+                // the caller unwinds the frame's slots
+                if (instr->a > 0 && value_stack_size > stack_base &&
+                    value_stack_size > frame_base + frame_local_count) {
+                    result = value_stack_pop();
+                }
+                goto cleanup;
+            }
+            
+            VM_CASE(BC_CALL_USER_FUNCTION) {
                 // Call user-defined function: func(args...)
                 // instr->a = function index, instr->b = argument count
-                int func_id = instr->a;
-                int arg_count = instr->b;
-                
-                // Debug: Log function call
-                if (program->count > 100) {
-                }
-                
                 // Get the function from the main program (cache) to ensure recursive calls work
                 BytecodeProgram* func_program = program;
                 if (interpreter && interpreter->bytecode_program_cache) {
                     func_program = interpreter->bytecode_program_cache;
                 }
-                
-                if (func_id >= 0 && func_id < (int)func_program->function_count && func_program->functions) {
-                    BytecodeFunction* func = &func_program->functions[func_id];
-                    
-                    // Get arguments from stack
-                    Value* args = NULL;
-                    if (arg_count > 0) {
-                        args = shared_malloc_safe(arg_count * sizeof(Value), "bytecode_vm", "BC_CALL_USER_FUNCTION", 1);
-                        if (!args) {
-                            // Allocation failed - return null
-                            value_stack_push(value_create_null());
-                            pc++;
-                            break;
-                        }
-                        for (int i = 0; i < arg_count; i++) {
-                            args[arg_count - 1 - i] = value_stack_pop();
-                        }
-                    }
-                    
-                    // Save stack size before function call
-                    size_t stack_size_before = value_stack_size;
-                    
-                    // Execute function bytecode using the main program
-                    Value result = bytecode_execute_function_bytecode(interpreter, func, args, arg_count, func_program);
-                    
-                    // Clean up arguments
-                    if (args) {
-                        for (int i = 0; i < arg_count; i++) {
-                            value_free(&args[i]);
-                        }
-                        shared_free_safe(args, "bytecode_vm", "BC_CALL_USER_FUNCTION", 2);
-                    }
-                    
-                    // Check if return value was already pushed onto stack by bytecode_execute_function_bytecode
-                    // (it pushes the return value onto the restored stack)
-                    if (value_stack_size > stack_size_before) {
-                        // Return value was already pushed, just free the result
-                        value_free(&result);
-                    } else {
-                        // Return value was not pushed, push it now
-                    value_stack_push(result);
-                    }
-                } else {
-                    value_stack_push(value_create_null());
-                }
+                bc_call_user_function(interpreter, func_program, instr->a, instr->b, stack_base);
                 pc++;
                 break;
             }
             
-            case BC_CALL_FUNCTION_VALUE: {
+            VM_CASE(BC_CALL_FUNCTION_VALUE) {
                 // Call function value from stack: func(args...)
                 // instr->a = argument count
                 // This can also be a class instantiation if the value is a class
@@ -3400,8 +4045,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 // Get function/value from stack (should be on top, after arguments)
                 Value func_value = value_stack_pop();
                 
-                if (func_value.type == VALUE_FUNCTION || func_value.type == VALUE_NULL) {
-                }
                 
                 // Get arguments from stack (in reverse order)
                 Value* args = NULL;
@@ -3424,14 +4067,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     // This is a class instantiation - instantiate it
                     Value class_value = func_value;
                     
-                    // Create class instance
-                    Value instance = value_create_object(16);
-                    
-                    // Set class name
-                    Value class_name_val = value_create_string(class_value.data.class_value.class_name);
-                    value_object_set(&instance, "__class_name__", class_name_val);
-                    value_free(&class_name_val);
-                    
                     // Collect all fields from inheritance chain
                     ASTNode** all_fields = NULL;
                     size_t field_count = 0;
@@ -3439,6 +4074,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     
                     collect_class_fields_for_bytecode(interpreter, &class_value, &all_fields, &field_count, &field_capacity);
                     
+                    // Create class instance with a slot for __class_name__ and each field;
+                    // instances of a class add them in the same order and so share a shape
+                    Value instance = value_create_object(field_count + 1);
+                    
+                    // Set class name
+                    Value class_name_val = value_create_string(class_value.data.class_value.class_name);
+                    value_object_set(&instance, "__class_name__", class_name_val);
+                    value_free(&class_name_val);
+                    
                     // Initialize fields
                     size_t field_index = 0;
                     for (size_t i = 0; i < field_count; i++) {
@@ -3683,11 +4327,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         if (found_program && func_id >= 0 && func_id < (int)found_program->function_count) {
                             // Found bytecode function in correct program - execute it directly
                             BytecodeFunction* bc_func = &found_program->functions[func_id];
-                            if (bc_func->name && strcmp(bc_func->name, "Client") == 0) {
-                            }
                             result = bytecode_execute_function_bytecode(interpreter, bc_func, args, arg_count, found_program);
-                            if (bc_func->name && strcmp(bc_func->name, "Client") == 0) {
-                            }
                         } else {
                             // No valid program or invalid function ID - fall through to value_function_call
                             // But first, ensure the program cache is set if we have a program
@@ -3707,21 +4347,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                 }
                 
-                // Debug: log result for all function calls
-                if (func_value.type == VALUE_FUNCTION) {
-                    ASTNode* body_ptr = (ASTNode*)func_value.data.function_value.body;
-                    uintptr_t body_addr = (uintptr_t)body_ptr;
-                    if (body_addr < 100000) {
-                        int func_id = (int)body_addr;
-                        BytecodeProgram* target_program = interpreter ? interpreter->bytecode_program_cache : program;
-                        if (target_program && func_id >= 0 && func_id < (int)target_program->function_count) {
-                            BytecodeFunction* bc_func = &target_program->functions[func_id];
-                            if (bc_func->name) {
-                            }
-                        }
-                    }
-                }
-                
                 // Clean up
                 value_free(&func_value);
                 if (args) {
@@ -3736,23 +4361,12 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_DEFINE_FUNCTION: {
+            VM_CASE(BC_DEFINE_FUNCTION) {
                 // Define function in environment: func_name -> function_value
                 // instr->a = function name constant index, instr->b = function id
                 int name_idx = instr->a;
                 int func_id = instr->b;
                 
-                // Debug: Check if this is Client or Intents
-                const char* func_name_debug = NULL;
-                if (name_idx >= 0 && name_idx < (int)program->const_count && 
-                    program->constants && program->constants[name_idx].type == VALUE_STRING) {
-                    func_name_debug = program->constants[name_idx].data.string_value;
-                    if (func_name_debug && (strcmp(func_name_debug, "Client") == 0 || strcmp(func_name_debug, "Intents") == 0 || strcmp(func_name_debug, "EmbedBuilder") == 0)) {
-                    }
-                } else if (name_idx == 125 || func_id == 8) {
-                    // Client should have name_idx=125, func_id=8
-                }
-                
                 if (name_idx >= 0 && name_idx < (int)program->const_count && 
                     program->constants && program->constants[name_idx].type == VALUE_STRING &&
                     func_id >= 0 && func_id < (int)program->function_count &&
@@ -3760,13 +4374,9 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     
                     const char* func_name = program->constants[name_idx].data.string_value;
                     if (!func_name) {
-                        if (func_name_debug) {
-                        }
                         pc++;
                         break;
                     }
-                    if (func_name_debug && strcmp(func_name, func_name_debug) != 0) {
-                    }
                     
                     BytecodeFunction* func = &program->functions[func_id];
                     if (!func) {
@@ -3822,8 +4432,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             char export_key[256];
                             snprintf(export_key, sizeof(export_key), "__export__%s", func_name);
                             environment_define(target_env, export_key, value_create_boolean(1));
-                            if (strcmp(func_name, "Client") == 0 || strcmp(func_name, "Intents") == 0) {
-                            }
                         }
                         if (flags & 2) { // is_private
                             char private_key[256];
@@ -3836,7 +4444,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_SYMBOL_FLAGS: {
+            VM_CASE(BC_SET_SYMBOL_FLAGS) {
                 // Set export/private flags for a symbol: a = name_idx, b = flags
                 if (instr->a >= 0 && instr->a < (int)program->const_count && 
                     program->constants[instr->a].type == VALUE_STRING) {
@@ -3844,15 +4452,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     int flags = instr->b;
                     Environment* target_env = interpreter->current_environment ? interpreter->current_environment : interpreter->global_environment;
                     
-                    if (strcmp(symbol_name, "Client") == 0 || strcmp(symbol_name, "Intents") == 0) {
-                    }
                     
                     if (flags & 1) { // is_export
                         char export_key[256];
                         snprintf(export_key, sizeof(export_key), "__export__%s", symbol_name);
                         environment_define(target_env, export_key, value_create_boolean(1));
-                        if (strcmp(symbol_name, "Client") == 0 || strcmp(symbol_name, "Intents") == 0) {
-                        }
                     }
                     if (flags & 2) { // is_private
                         char private_key[256];
@@ -3864,9 +4468,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_LEFT_SHIFT: {
-                if (program->count > 100 && pc == 80) {
-                }
+            VM_CASE(BC_LEFT_SHIFT) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 if (a.type == VALUE_NUMBER && b.type == VALUE_NUMBER) {
@@ -3882,7 +4484,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_RIGHT_SHIFT: {
+            VM_CASE(BC_RIGHT_SHIFT) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 if (a.type == VALUE_NUMBER && b.type == VALUE_NUMBER) {
@@ -3898,7 +4500,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_BITWISE_AND: {
+            VM_CASE(BC_BITWISE_AND) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 if (a.type == VALUE_NUMBER && b.type == VALUE_NUMBER) {
@@ -3914,7 +4516,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_BITWISE_OR: {
+            VM_CASE(BC_BITWISE_OR) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 if (a.type == VALUE_NUMBER && b.type == VALUE_NUMBER) {
@@ -3930,7 +4532,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_BITWISE_XOR: {
+            VM_CASE(BC_BITWISE_XOR) {
                 Value b = value_stack_pop();
                 Value a = value_stack_pop();
                 if (a.type == VALUE_NUMBER && b.type == VALUE_NUMBER) {
@@ -3946,7 +4548,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_TO_STRING: {
+            VM_CASE(BC_TO_STRING) {
                 // Convert value to string
                 Value val = value_stack_pop();
                 Value result = value_to_string(&val);
@@ -3963,7 +4565,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_GET_TYPE: {
+            VM_CASE(BC_GET_TYPE) {
                 // Get value type as string (matches AST interpreter logic)
                 Value val = value_stack_pop();
                 Value result;
@@ -4038,7 +4640,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_GET_LENGTH: {
+            VM_CASE(BC_GET_LENGTH) {
                 // Get value length
                 Value val = value_stack_pop();
                 Value result;
@@ -4055,7 +4657,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_STRING: {
+            VM_CASE(BC_IS_STRING) {
                 // Check if value is string
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_STRING);
@@ -4065,7 +4667,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_NUMBER: {
+            VM_CASE(BC_IS_NUMBER) {
                 // Check if value is number
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_NUMBER);
@@ -4075,7 +4677,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_INT: {
+            VM_CASE(BC_IS_INT) {
                 // Check if value is int
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_NUMBER && val.data.number_value == (int)val.data.number_value);
@@ -4085,7 +4687,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_FLOAT: {
+            VM_CASE(BC_IS_FLOAT) {
                 // Check if value is float (has decimal places)
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_NUMBER && val.data.number_value != (long long)val.data.number_value);
@@ -4095,7 +4697,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_BOOL: {
+            VM_CASE(BC_IS_BOOL) {
                 // Check if value is bool
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_BOOLEAN);
@@ -4105,7 +4707,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_ARRAY: {
+            VM_CASE(BC_IS_ARRAY) {
                 // Check if value is array
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_ARRAY);
@@ -4115,7 +4717,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_NULL: {
+            VM_CASE(BC_IS_NULL) {
                 // Check if value is null
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_NULL);
@@ -4125,7 +4727,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_OBJECT: {
+            VM_CASE(BC_IS_OBJECT) {
                 // Check if value is object
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_OBJECT);
@@ -4135,7 +4737,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IS_FUNCTION: {
+            VM_CASE(BC_IS_FUNCTION) {
                 // Check if value is function
                 Value val = value_stack_pop();
                 Value result = value_create_boolean(val.type == VALUE_FUNCTION);
@@ -4145,7 +4747,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_PUSH: {
+            VM_CASE(BC_ARRAY_PUSH) {
                 // BC_ARRAY_PUSH expects stack: [arr, val] with val on top
                 // Pop val first (top), then arr (below)
                 Value val = value_stack_pop();
@@ -4167,7 +4769,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_POP: {
+            VM_CASE(BC_ARRAY_POP) {
                 // Pop value from array
                 // Stack: [arr, index] or [arr] (if no index provided)
                 // The compiler puts index on top if provided, then array below it
@@ -4206,7 +4808,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_CONTAINS: {
+            VM_CASE(BC_ARRAY_CONTAINS) {
                 // Check if array contains value
                 Value search_val = value_stack_pop();
                 Value arr = value_stack_pop();
@@ -4224,7 +4826,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_INDEX_OF: {
+            VM_CASE(BC_ARRAY_INDEX_OF) {
                 // Get index of value in array
                 Value search_val = value_stack_pop();
                 Value arr = value_stack_pop();
@@ -4242,7 +4844,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_JOIN: {
+            VM_CASE(BC_ARRAY_JOIN) {
                 // Array join: arr.join(separator)
                 Value separator = value_stack_pop();
                 Value array = value_stack_pop();
@@ -4260,7 +4862,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_UNIQUE: {
+            VM_CASE(BC_ARRAY_UNIQUE) {
                 // Array unique: arr.unique()
                 Value array = value_stack_pop();
                 
@@ -4276,7 +4878,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_SLICE: {
+            VM_CASE(BC_ARRAY_SLICE) {
                 // Array slice: arr.slice(start, end)
                 Value end = value_stack_pop();
                 Value start = value_stack_pop();
@@ -4296,7 +4898,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_CONCAT_METHOD: {
+            VM_CASE(BC_ARRAY_CONCAT_METHOD) {
                 // Array concat method: arr.concat(other)
                 Value other = value_stack_pop();
                 Value array = value_stack_pop();
@@ -4314,7 +4916,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_ARRAY: {
+            VM_CASE(BC_CREATE_ARRAY) {
                 // Create array from stack elements
                 size_t element_count = instr->a;
                 
@@ -4349,7 +4951,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_RANGE: {
+            VM_CASE(BC_CREATE_RANGE) {
                 // Create range: start..end (step = 1.0)
                 // Stack: end (top), start
                 Value end_val = value_stack_pop();
@@ -4373,7 +4975,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_RANGE_STEP: {
+            VM_CASE(BC_CREATE_RANGE_STEP) {
                 // Create range with step: start..end..step
                 // Stack: step (top), end, start
                 Value step_val = value_stack_pop();
@@ -4401,7 +5003,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_CONCAT: {
+            VM_CASE(BC_ARRAY_CONCAT) {
                 // Array concatenation: arr1 + arr2
                 Value arr2 = value_stack_pop();
                 Value arr1 = value_stack_pop();
@@ -4443,7 +5045,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_OBJECT: {
+            VM_CASE(BC_CREATE_OBJECT) {
                 // Create object from key-value pairs on stack
                 size_t pair_count = instr->a;
                 Value object_val = value_create_object(pair_count > 0 ? pair_count : 4);
@@ -4466,7 +5068,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_SET: {
+            VM_CASE(BC_CREATE_SET) {
                 // Create set from elements on stack
                 size_t element_count = instr->a;
                 Value set_val = value_create_set(element_count > 0 ? element_count : 4);
@@ -4483,7 +5085,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_MAP: {
+            VM_CASE(BC_CREATE_MAP) {
                 // Create hash map from key-value pairs on stack
                 // Pairs are pushed as (value, key) so we pop as (key, value)
                 size_t pair_count = instr->a;
@@ -4498,9 +5100,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     
                     // Add key-value pair to hash map (only if key is string)
                     if (key.type == VALUE_STRING) {
-                        const char* key_str = key.data.string_value;
                         value_hash_map_set(&map_val, key, value);
-                    } else {
                     }
                     
                     value_free(&key);
@@ -4512,7 +5112,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_IMPORT_LIB: {
+            VM_CASE(BC_IMPORT_LIB) {
                 // Import library or file module: use library_name [as alias]
                 if (instr->a < program->const_count && program->constants[instr->a].type == VALUE_STRING) {
                     const char* library_name = program->constants[instr->a].data.string_value;
@@ -4678,12 +5278,8 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                                 
                                                 // Store in both current environment AND global environment
                                                 // This ensures BC_LOAD_GLOBAL can find imported items
-                                                if (strcmp(import_name, "Client") == 0) {
-                                                }
                                                 environment_define(interpreter->current_environment, import_name, cloned_item);
                                                 if (interpreter->global_environment && interpreter->current_environment != interpreter->global_environment) {
-                                                    if (strcmp(import_name, "Client") == 0) {
-                                                    }
                                                     environment_define(interpreter->global_environment, import_name, value_clone(&cloned_item));
                                                 }
                                             }
@@ -4850,8 +5446,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                     
                                     // Debug: List all symbols in module environment
                                     for (size_t i = 0; i < module_env->count; i++) {
-                                        if (module_env->names[i] && strncmp(module_env->names[i], "__", 2) != 0) {
-                                        }
                                     }
                                     
                                     // Restore the main program cache
@@ -4919,8 +5513,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 const char* symbol_name = module_env->names[i];
                                 // Skip internal symbols starting with __ (including metadata)
                                 if (strncmp(symbol_name, "__", 2) != 0) {
-                                    if (strcmp(symbol_name, "Client") == 0 || strcmp(symbol_name, "Intents") == 0 || strcmp(symbol_name, "EmbedBuilder") == 0) {
-                                    }
                                     
                                     // Check for private flag
                                     char private_key[256];
@@ -4970,8 +5562,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                     if (should_export) {
                                         Value cloned = value_clone(&module_env->values[i]);
                                         value_object_set(&module_value, symbol_name, cloned);
-                                        if (strcmp(symbol_name, "Client") == 0 || strcmp(symbol_name, "Intents") == 0 || strcmp(symbol_name, "EmbedBuilder") == 0) {
-                                        }
                                         export_count++;
                                     } else if (strcmp(symbol_name, "Client") == 0 || strcmp(symbol_name, "Intents") == 0 || strcmp(symbol_name, "EmbedBuilder") == 0) {
                                     }
@@ -5101,12 +5691,8 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                             
                                             // Store in both current environment AND global environment
                                             // This ensures BC_LOAD_GLOBAL can find imported items
-                                            if (strcmp(import_name, "Client") == 0) {
-                                            }
                                             environment_define(interpreter->current_environment, import_name, cloned_item);
                                             if (interpreter->global_environment && interpreter->current_environment != interpreter->global_environment) {
-                                                if (strcmp(import_name, "Client") == 0) {
-                                                }
                                                 environment_define(interpreter->global_environment, import_name, value_clone(&cloned_item));
                                             }
                                         }
@@ -5152,6 +5738,9 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 capability_name = "net";
                             } else if (strcmp(library_name, "database") == 0) {
                                 capability_name = "database";
+                            } else if (strcmp(library_name, "isolate") == 0) {
+                                // Isolates load code with every library available
+                                capability_name = "isolate";
                             }
                             
                             // If this is a dangerous library, check for capability
@@ -5213,7 +5802,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
             }
             
             
-            case BC_STRING_UPPER: {
+            VM_CASE(BC_STRING_UPPER) {
                 // Convert string to uppercase
                 Value val = value_stack_pop();
                 if (val.type == VALUE_STRING) {
@@ -5232,7 +5821,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_STRING_LOWER: {
+            VM_CASE(BC_STRING_LOWER) {
                 // Convert string to lowercase
                 Value val = value_stack_pop();
                 if (val.type == VALUE_STRING) {
@@ -5251,7 +5840,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_STRING_TRIM: {
+            VM_CASE(BC_STRING_TRIM) {
                 // Trim string whitespace
                 Value val = value_stack_pop();
                 if (val.type == VALUE_STRING) {
@@ -5282,7 +5871,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_ABS: {
+            VM_CASE(BC_MATH_ABS) {
                 // Math abs: math.abs(value)
                 Value value = value_stack_pop();
                 
@@ -5298,7 +5887,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_SQRT: {
+            VM_CASE(BC_MATH_SQRT) {
                 // Math sqrt: math.sqrt(value)
                 Value value = value_stack_pop();
                 
@@ -5314,7 +5903,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_POW: {
+            VM_CASE(BC_MATH_POW) {
                 // Math pow: math.pow(base, exponent)
                 Value exponent = value_stack_pop();
                 Value base = value_stack_pop();
@@ -5332,7 +5921,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_SIN: {
+            VM_CASE(BC_MATH_SIN) {
                 // Math sin: math.sin(value)
                 Value value = value_stack_pop();
                 
@@ -5348,7 +5937,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_COS: {
+            VM_CASE(BC_MATH_COS) {
                 // Math cos: math.cos(value)
                 Value value = value_stack_pop();
                 
@@ -5364,7 +5953,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_TAN: {
+            VM_CASE(BC_MATH_TAN) {
                 // Math tan: math.tan(value)
                 Value value = value_stack_pop();
                 
@@ -5380,7 +5969,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_FLOOR: {
+            VM_CASE(BC_MATH_FLOOR) {
                 // Math floor: math.floor(value)
                 Value value = value_stack_pop();
                 
@@ -5396,7 +5985,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_CEIL: {
+            VM_CASE(BC_MATH_CEIL) {
                 // Math ceil: math.ceil(value)
                 Value value = value_stack_pop();
                 
@@ -5412,7 +6001,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATH_ROUND: {
+            VM_CASE(BC_MATH_ROUND) {
                 // Math round: math.round(value)
                 Value value = value_stack_pop();
                 
@@ -5428,7 +6017,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MAP_HAS: {
+            VM_CASE(BC_MAP_HAS) {
                 // Map has key check: map.has(key)
                 Value key = value_stack_pop();
                 Value map = value_stack_pop();
@@ -5446,7 +6035,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MAP_SIZE: {
+            VM_CASE(BC_MAP_SIZE) {
                 // Map size property: map.size
                 Value map = value_stack_pop();
                 
@@ -5462,7 +6051,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MAP_KEYS: {
+            VM_CASE(BC_MAP_KEYS) {
                 // Map keys method: map.keys()
                 Value map = value_stack_pop();
                 
@@ -5478,7 +6067,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MAP_DELETE: {
+            VM_CASE(BC_MAP_DELETE) {
                 // Map delete method: map.delete(key)
                 Value key = value_stack_pop();
                 Value map = value_stack_pop();
@@ -5496,7 +6085,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MAP_CLEAR: {
+            VM_CASE(BC_MAP_CLEAR) {
                 // Map clear method: map.clear()
                 Value map = value_stack_pop();
                 
@@ -5512,7 +6101,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MAP_UPDATE: {
+            VM_CASE(BC_MAP_UPDATE) {
                 // Map update method: map.update(other_map)
                 Value other_map = value_stack_pop();
                 Value map = value_stack_pop();
@@ -5530,7 +6119,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_ADD: {
+            VM_CASE(BC_SET_ADD) {
                 // Set add method: set.add(element)
                 Value element = value_stack_pop();
                 Value set = value_stack_pop();
@@ -5548,7 +6137,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_HAS: {
+            VM_CASE(BC_SET_HAS) {
                 // Set has element check: set.has(element)
                 Value element = value_stack_pop();
                 Value set = value_stack_pop();
@@ -5566,7 +6155,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_REMOVE: {
+            VM_CASE(BC_SET_REMOVE) {
                 // Set remove method: set.remove(element)
                 Value element = value_stack_pop();
                 Value set = value_stack_pop();
@@ -5584,7 +6173,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_SIZE: {
+            VM_CASE(BC_SET_SIZE) {
                 // Set size property: set.size
                 Value set = value_stack_pop();
                 
@@ -5600,7 +6189,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_CLEAR: {
+            VM_CASE(BC_SET_CLEAR) {
                 // Set clear method: set.clear()
                 Value set = value_stack_pop();
                 
@@ -5616,7 +6205,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_TO_ARRAY: {
+            VM_CASE(BC_SET_TO_ARRAY) {
                 // Set toArray method: set.toArray()
                 Value set = value_stack_pop();
                 
@@ -5632,7 +6221,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_UNION: {
+            VM_CASE(BC_SET_UNION) {
                 // Set union method: set.union(other_set)
                 Value other_set = value_stack_pop();
                 Value set = value_stack_pop();
@@ -5650,7 +6239,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SET_INTERSECTION: {
+            VM_CASE(BC_SET_INTERSECTION) {
                 // Set intersection method: set.intersection(other_set)
                 Value other_set = value_stack_pop();
                 Value set = value_stack_pop();
@@ -5668,7 +6257,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_EVAL_AST: {
+            VM_CASE(BC_EVAL_AST) {
                 // AST fallback removed - this should never be reached in bytecode-only mode
                 // If we encounter this, it means bytecode compilation failed to handle something
                 if (interpreter) {
@@ -5680,7 +6269,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
             }
             
             
-            case BC_MATCH: {
+            VM_CASE(BC_MATCH) {
                 // Pattern matching: match expr with cases
                 // instr->a = number of cases
                 int case_count = instr->a;
@@ -5740,13 +6329,13 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATCH_CASE: {
+            VM_CASE(BC_MATCH_CASE) {
                 // This instruction is handled within BC_MATCH
                 pc++;
                 break;
             }
             
-            case BC_PATTERN_LITERAL: {
+            VM_CASE(BC_PATTERN_LITERAL) {
                 // Pattern: literal pattern (string, number, etc.)
                 // The literal value is already on the stack from compilation
                 // This instruction just marks it as a pattern
@@ -5754,7 +6343,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_PATTERN_WILDCARD: {
+            VM_CASE(BC_PATTERN_WILDCARD) {
                 // Pattern: wildcard pattern (_) - matches anything
                 // Push a special wildcard marker
                 value_stack_push(value_create_string("__WILDCARD__"));
@@ -5762,7 +6351,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_PATTERN_TYPE: {
+            VM_CASE(BC_PATTERN_TYPE) {
                 // Pattern: type pattern (e.g., String, Int)
                 // instr->a = type name constant index
                 if (instr->a < program->const_count) {
@@ -5779,7 +6368,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_CLASS: {
+            VM_CASE(BC_CREATE_CLASS) {
                 // Create class definition
                 // instr->a = class name constant index, instr->b = parent class name constant index, instr->c = body AST index
                 if (instr->a < program->const_count) {
@@ -5824,7 +6413,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_INSTANTIATE_CLASS: {
+            VM_CASE(BC_INSTANTIATE_CLASS) {
                 // Instantiate class: ClassName(args...)
                 // instr->a = class name constant index, instr->b = argument count
                 if (instr->a < program->const_count) {
@@ -5845,14 +6434,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                     args[i] = value_stack_pop();
                                 }
                                 
-                                // Create class instance
-                                Value instance = value_create_object(16);
-                                
-                                // Set class name
-                                Value class_name_val = value_create_string(class_value.data.class_value.class_name);
-                                value_object_set(&instance, "__class_name__", class_name_val);
-                                value_free(&class_name_val);
-                                
                                 // Collect all fields from inheritance chain
                                 ASTNode** all_fields = NULL;
                                 size_t field_count = 0;
@@ -5860,6 +6441,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 collect_class_fields_for_bytecode(interpreter, &class_value, &all_fields, &field_count, &field_capacity);
                                 
+                                // Create class instance with a slot for __class_name__ and each field;
+                                // instances of a class add them in the same order and so share a shape
+                                Value instance = value_create_object(field_count + 1);
+                                
+                                // Set class name
+                                Value class_name_val = value_create_string(class_value.data.class_value.class_name);
+                                value_object_set(&instance, "__class_name__", class_name_val);
+                                value_free(&class_name_val);
+                                
                                 // Initialize fields
                                 size_t field_index = 0;
                                 for (size_t i = 0; i < field_count; i++) {
@@ -5939,7 +6529,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_FOR_LOOP: {
+            VM_CASE(BC_FOR_LOOP) {
                 // For loop: for i in collection body
                 // instr->a = variable name constant index, instr->b = body AST index
                 if (instr->a < program->const_count && instr->b >= 0 && instr->b < (int)program->function_count) {
@@ -5982,6 +6572,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         BytecodeProgram temp_program = {0};
                                         temp_program.code = body_func->code;
                                         temp_program.count = body_func->code_count;
+                                        bc_share_function_feedback(&temp_program, body_func);
                                         temp_program.capacity = body_func->code_capacity;
                                         temp_program.const_count = program ? program->const_count : 0;
                                         temp_program.constants = program ? program->constants : NULL;
@@ -6001,15 +6592,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         
                                         // Save stack state before sub-program execution
                                         size_t saved_stack_size = value_stack_size;
-                                        Value* saved_stack = NULL;
-                                        if (saved_stack_size > 0) {
-                                            saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_FOR_LOOP", 1);
-                                            if (saved_stack) {
-                                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                                    saved_stack[i] = value_clone(&value_stack[i]);
-                                                }
-                                            }
-                                        }
                                         
                                         // Execute sub-program in current environment (no new environment created)
                                         // bytecode_execute will reset the stack, so we need to restore it after
@@ -6017,22 +6599,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         
                                         // Restore stack state after sub-program execution
                                         // Clear any values left by sub-program
-                                        while (value_stack_size > 0) {
-                                            Value val = value_stack_pop();
-                                            value_free(&val);
-                                        }
-                                        
-                                        // Restore saved stack
-                                        if (saved_stack && saved_stack_size > 0) {
-                                            for (size_t i = 0; i < saved_stack_size; i++) {
-                                                value_stack_push(saved_stack[i]);
-                                            }
-                                            // Free saved stack copies
-                                            for (size_t i = 0; i < saved_stack_size; i++) {
-                                                value_free(&saved_stack[i]);
-                                            }
-                                            shared_free_safe(saved_stack, "bytecode_vm", "BC_FOR_LOOP", 2);
-                                        }
+                                        value_stack_drop_to(saved_stack_size);
                                         
                                     if (interpreter_has_error(interpreter)) {
                                         value_free(&body_result);
@@ -6087,6 +6654,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         BytecodeProgram temp_program = {0};
                                         temp_program.code = body_func->code;
                                         temp_program.count = body_func->code_count;
+                                        bc_share_function_feedback(&temp_program, body_func);
                                         temp_program.capacity = body_func->code_capacity;
                                         temp_program.const_count = program ? program->const_count : 0;
                                         temp_program.constants = program ? program->constants : NULL;
@@ -6106,15 +6674,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         
                                         // Save stack state before sub-program execution
                                         size_t saved_stack_size = value_stack_size;
-                                        Value* saved_stack = NULL;
-                                        if (saved_stack_size > 0) {
-                                            saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_FOR_LOOP", 5);
-                                            if (saved_stack) {
-                                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                                    saved_stack[i] = value_clone(&value_stack[i]);
-                                                }
-                                            }
-                                        }
                                         
                                         // Execute sub-program in current environment (no new environment created)
                                         // bytecode_execute will reset the stack, so we need to restore it after
@@ -6122,22 +6681,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         
                                         // Restore stack state after sub-program execution
                                         // Clear any values left by sub-program
-                                        while (value_stack_size > 0) {
-                                            Value val = value_stack_pop();
-                                            value_free(&val);
-                                        }
-                                        
-                                        // Restore saved stack
-                                        if (saved_stack && saved_stack_size > 0) {
-                                            for (size_t i = 0; i < saved_stack_size; i++) {
-                                                value_stack_push(saved_stack[i]);
-                                            }
-                                            // Free saved stack copies
-                                            for (size_t i = 0; i < saved_stack_size; i++) {
-                                                value_free(&saved_stack[i]);
-                                            }
-                                            shared_free_safe(saved_stack, "bytecode_vm", "BC_FOR_LOOP", 6);
-                                        }
+                                        value_stack_drop_to(saved_stack_size);
                                         
                                     if (interpreter_has_error(interpreter)) {
                                         value_free(&body_result);
@@ -6192,6 +6736,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         BytecodeProgram temp_program = {0};
                                         temp_program.code = body_func->code;
                                         temp_program.count = body_func->code_count;
+                                        bc_share_function_feedback(&temp_program, body_func);
                                         temp_program.capacity = body_func->code_capacity;
                                         temp_program.const_count = program ? program->const_count : 0;
                                         temp_program.constants = program ? program->constants : NULL;
@@ -6216,10 +6761,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                         Value body_result = bytecode_execute(&temp_program, interpreter, 0);
                                         
                                         // Restore stack size (sub-program may have left values on stack)
-                                        while (value_stack_size > saved_stack_size) {
-                                            Value val = value_stack_pop();
-                                            value_free(&val);
-                                        }
+                                        value_stack_drop_to(saved_stack_size);
                                         
                                     if (interpreter_has_error(interpreter)) {
                                         value_free(&body_result);
@@ -6293,7 +6835,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_BREAK: {
+            VM_CASE(BC_BREAK) {
                 // Break statement - set break_depth flag
                 if (interpreter) {
                     interpreter->break_depth++;
@@ -6304,7 +6846,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CONTINUE: {
+            VM_CASE(BC_CONTINUE) {
                 // Continue statement - set continue_depth flag
                 if (interpreter) {
                     interpreter->continue_depth++;
@@ -6315,17 +6857,150 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_GET: {
+            // Quickened variants (see TYPE FEEDBACK): each checks the operand
+            // tags its site settled on and otherwise restores the generic
+            // opcode, which the loop head then dispatches at the same pc
+            VM_CASE(BC_ADD_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_number(na + nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_ADD_STRINGS) {
+                if (LIKELY(value_stack_size >= 2 &&
+                           nan_boxing_is_string(value_stack[value_stack_size - 2]) &&
+                           nan_boxing_is_string(value_stack[value_stack_size - 1]))) {
+                    vm_quickened_executions++;
+                    // The result reuses the left operand's cell
+                    Value* left = nan_boxing_get_cell(value_stack[value_stack_size - 2]);
+                    NanBoxedValue right = value_stack[value_stack_size - 1];
+                    Value result = fast_string_concat(left->data.string_value, nan_boxing_get_string(right));
+                    value_free(left);
+                    *left = result;
+                    nan_boxing_release(right);
+                    value_stack_size--;
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_SUB_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_number(na - nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_MUL_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_number(na * nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_LT_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_boolean(na < nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_LE_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_boolean(na <= nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_GT_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_boolean(na > nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_GE_NUMBERS) {
+                double na, nb;
+                if (LIKELY(value_stack_numeric_pair(&na, &nb))) {
+                    vm_quickened_executions++;
+                    value_stack_replace_pair(nan_boxing_create_boolean(na >= nb));
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_ARRAY_GET_DENSE) {
+                if (LIKELY(value_stack_size >= 2 &&
+                           nan_boxing_is_array(value_stack[value_stack_size - 2]) &&
+                           nan_boxing_is_number(value_stack[value_stack_size - 1]))) {
+                    vm_quickened_executions++;
+                    NanBoxedValue array_word = value_stack[value_stack_size - 2];
+                    Value* arr = nan_boxing_get_cell(array_word);
+                    double index = nan_boxing_get_number(value_stack[value_stack_size - 1]);
+                    NanBoxedValue result = NAN_BOX_NULL_VALUE;
+                    if (index >= 0 && index < (double)arr->data.array_value.count) {
+                        Value* elem = (Value*)arr->data.array_value.elements[(size_t)index];
+                        if (elem) {
+                            result = nan_boxing_box(value_clone(elem));
+                        }
+                    }
+                    nan_boxing_release(array_word);
+                    value_stack_replace_pair(result);
+                    pc++;
+                    VM_NEXT();
+                }
+                bc_dequicken(program, pc);
+                break;
+            }
+            
+            VM_CASE(BC_ARRAY_GET) {
                 // Array/HashMap access: arr[index] or map[key]
                 // Stack: [arr/map, index/key]
+                bc_quicken(program, pc);
                 Value index = value_stack_pop();
                 Value arr = value_stack_pop();
                 
-                // Debug: log what we're accessing
+#ifdef MYCO_VM_TRACE
                 const char* key_str = (index.type == VALUE_STRING && index.data.string_value) ? index.data.string_value : NULL;
                 const char* arr_type_str = (arr.type == VALUE_HASH_MAP) ? "HashMap" : (arr.type == VALUE_ARRAY) ? "Array" : "Other";
-                fprintf(stderr, "[BC_ARRAY_GET] Accessing %s with key/index: type=%d, value='%s'\n", 
+                VM_TRACE("[BC_ARRAY_GET] Accessing %s with key/index: type=%d, value='%s'\n", 
                         arr_type_str, index.type, key_str ? key_str : (index.type == VALUE_NUMBER) ? "number" : "null");
+#endif
                 
                 Value result = value_create_null();
                 
@@ -6341,15 +7016,8 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 }
                 // Handle HashMap access: map[key]
                 else if (arr.type == VALUE_HASH_MAP) {
-                    // Debug: log HashMap access
-                    if (key_str) {
-                        fprintf(stderr, "[BC_ARRAY_GET] HashMap access: key='%s', map has %zu entries\n", 
-                                key_str, arr.data.hash_map_value.count);
-                    }
                     result = value_hash_map_get(&arr, index);
-                    if (key_str) {
-                        fprintf(stderr, "[BC_ARRAY_GET] HashMap get result: type=%d\n", result.type);
-                    }
+                    VM_TRACE("[BC_ARRAY_GET] HashMap get result: type=%d\n", result.type);
                 }
                 
                 value_free(&arr);
@@ -6359,11 +7027,24 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ARRAY_SET: {
+            VM_CASE(BC_ARRAY_SET) {
                 // Array/HashMap assignment: arr[index] = value or map[key] = value
                 // Stack: [arr/map, index/key, value]
                 // instr->a = variable name constant index (-1 if complex expression)
                 // instr->b = 1 if simple variable, 0 if complex
+                // instr->b = 2: the container is frame slot instr->a, written in
+                // place (stack: [index, value]); nothing is pushed
+                if (instr->b == 2) {
+                    Value value = value_stack_pop();
+                    Value index = value_stack_pop();
+                    if (LIKELY(frame && instr->a >= 0 && (size_t)instr->a < frame_local_count)) {
+                        bc_frame_slot_set_element(interpreter, &value_stack[frame_base + instr->a], index, value);
+                    }
+                    value_free(&value);
+                    value_free(&index);
+                    pc++;
+                    VM_NEXT();
+                }
                 Value value = value_stack_pop();
                 Value index = value_stack_pop();
                 Value arr = value_stack_pop();
@@ -6372,6 +7053,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 if (arr.type == VALUE_ARRAY && index.type == VALUE_NUMBER) {
                     int idx = (int)index.data.number_value;
                     if (idx >= 0 && idx < (int)arr.data.array_value.count) {
+                        if (instr->b == 1 && instr->a >= 0 && instr->a < program->const_count &&
+                            program->constants[instr->a].type == VALUE_STRING) {
+                            bc_release_for_write(interpreter, program, program->constants[instr->a].data.string_value, &arr);
+                        }
                         // Set the array element using value_array_set
                         value_array_set(&arr, idx, value);
                         
@@ -6410,14 +7095,18 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     // Debug: log HashMap assignment
                     const char* key_str = (index.type == VALUE_STRING && index.data.string_value) ? index.data.string_value : NULL;
                     if (key_str) {
-                        fprintf(stderr, "[BC_ARRAY_SET] HashMap assignment: key='%s', value type=%d, map has %zu entries before\n", 
+                        VM_TRACE("[BC_ARRAY_SET] HashMap assignment: key='%s', value type=%d, map has %zu entries before\n", 
                                 key_str, value.type, arr.data.hash_map_value.count);
                     }
                     
+                    if (instr->b == 1 && instr->a >= 0 && instr->a < program->const_count &&
+                        program->constants[instr->a].type == VALUE_STRING) {
+                        bc_release_for_write(interpreter, program, program->constants[instr->a].data.string_value, &arr);
+                    }
                     value_hash_map_set(&arr, index, value);
                     
                     if (key_str) {
-                        fprintf(stderr, "[BC_ARRAY_SET] HashMap assignment: map has %zu entries after\n", 
+                        VM_TRACE("[BC_ARRAY_SET] HashMap assignment: map has %zu entries after\n", 
                                 arr.data.hash_map_value.count);
                     }
                     
@@ -6426,7 +7115,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         Value var_name_val = program->constants[instr->a];
                         if (var_name_val.type == VALUE_STRING && var_name_val.data.string_value) {
                             const char* var_name = var_name_val.data.string_value;
-                            fprintf(stderr, "[BC_ARRAY_SET] Updating simple variable '%s' in environment\n", var_name);
+                            VM_TRACE("[BC_ARRAY_SET] Updating simple variable '%s' in environment\n", var_name);
                             // Try to update in current environment first
                             if (interpreter && interpreter->current_environment) {
                                 if (environment_exists(interpreter->current_environment, var_name)) {
@@ -6454,16 +7143,21 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         // For now, we'll need to rely on the fact that HashMaps are stored by reference
                         // in objects, so modifications should persist. But if the HashMap was cloned
                         // during property access, we need to write it back.
-                        fprintf(stderr, "[BC_ARRAY_SET] WARNING: HashMap assignment to non-simple variable (instr->b=%d, instr->a=%d). Property may not be updated!\n", 
+                        VM_TRACE("[BC_ARRAY_SET] WARNING: HashMap assignment to non-simple variable (instr->b=%d, instr->a=%d). Property may not be updated!\n", 
                                 instr->b, instr->a);
                     }
                     
-                    // For HashMap assignments, leave the modified HashMap on the stack
-                    // so it can be written back to properties (e.g., obj.prop[key] = value)
-                    fprintf(stderr, "[BC_ARRAY_SET] Pushing modified HashMap onto stack (type=%d, entries=%zu)\n", 
-                            arr.type, arr.data.hash_map_value.count);
-                    value_stack_push(arr); // Push the modified HashMap back
-                    fprintf(stderr, "[BC_ARRAY_SET] Stack size after push: %zu\n", value_stack_size);
+                    // For HashMap assignments through a property, leave the modified HashMap
+                    // on the stack so it can be written back (e.g., obj.prop[key] = value).
+                    // Simple variables were already written back by name above.
+                    if (instr->b == 1) {
+                        value_free(&arr);
+                    } else {
+                        VM_TRACE("[BC_ARRAY_SET] Pushing modified HashMap onto stack (type=%d, entries=%zu)\n", 
+                                arr.type, arr.data.hash_map_value.count);
+                        value_stack_push(arr); // Push the modified HashMap back
+                        VM_TRACE("[BC_ARRAY_SET] Stack size after push: %zu\n", value_stack_size);
+                    }
                     value_free(&value); // Free the value we assigned
                     value_free(&index);
                 } else {
@@ -6486,7 +7180,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_THROW: {
+            VM_CASE(BC_THROW) {
                 // Throw statement: throw expression
                 // Stack: [exception_value]
                 Value throw_value = value_stack_pop();
@@ -6512,7 +7206,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_TRY_START: {
+            VM_CASE(BC_TRY_START) {
                 // Start try block - increment try depth
                 if (interpreter) {
                     interpreter->try_depth++;
@@ -6523,7 +7217,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_TRY_END: {
+            VM_CASE(BC_TRY_END) {
                 // End try block - check if error occurred
                 // If no error, decrement try depth and continue
                 // If error, keep try_depth set so BC_CATCH can handle it
@@ -6541,7 +7235,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CATCH: {
+            VM_CASE(BC_CATCH) {
                 // Catch block handler
                 // instr->a = catch variable name constant index (empty string means no variable)
                 // instr->b = catch block function ID (bytecode sub-program)
@@ -6585,6 +7279,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 BytecodeProgram temp_program = {0};
                                 temp_program.code = catch_block_func->code;
                                 temp_program.count = catch_block_func->code_count;
+                                bc_share_function_feedback(&temp_program, catch_block_func);
                                 temp_program.capacity = catch_block_func->code_capacity;
                                 temp_program.const_count = program ? program->const_count : 0;
                                 temp_program.constants = program ? program->constants : NULL;
@@ -6604,15 +7299,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 // Save stack state before sub-program execution
                                 size_t saved_stack_size = value_stack_size;
-                                Value* saved_stack = NULL;
-                                if (saved_stack_size > 0) {
-                                    saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_CATCH", 1);
-                                    if (saved_stack) {
-                                        for (size_t i = 0; i < saved_stack_size; i++) {
-                                            saved_stack[i] = value_clone(&value_stack[i]);
-                                        }
-                                    }
-                                }
                                 
                                 // Execute sub-program in current environment (no new environment created)
                                 // bytecode_execute will reset the stack, so we need to restore it after
@@ -6620,22 +7306,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 // Restore stack state after sub-program execution
                                 // Clear any values left by sub-program
-                                while (value_stack_size > 0) {
-                                    Value val = value_stack_pop();
-                                    value_free(&val);
-                                }
-                                
-                                // Restore saved stack
-                                if (saved_stack && saved_stack_size > 0) {
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        value_stack_push(saved_stack[i]);
-                                    }
-                                    // Free saved stack copies
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        value_free(&saved_stack[i]);
-                                    }
-                                    shared_free_safe(saved_stack, "bytecode_vm", "BC_CATCH", 2);
-                                }
+                                value_stack_drop_to(saved_stack_size);
                             }
                         }
                         
@@ -6665,7 +7336,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SWITCH_CASE: {
+            VM_CASE(BC_SWITCH_CASE) {
                 // Switch case: compare expression with case value, jump if not equal
                 // Stack: [expression_value]
                 // instr->a = case value function ID (bytecode sub-program)
@@ -6684,6 +7355,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             BytecodeProgram temp_program = {0};
                             temp_program.code = case_value_func->code;
                             temp_program.count = case_value_func->code_count;
+                            bc_share_function_feedback(&temp_program, case_value_func);
                             temp_program.capacity = case_value_func->code_capacity;
                             temp_program.const_count = program ? program->const_count : 0;
                             temp_program.constants = program ? program->constants : NULL;
@@ -6703,37 +7375,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             
                             // Save stack state
                             size_t saved_stack_size = value_stack_size;
-                            Value* saved_stack = NULL;
-                            if (saved_stack_size > 0) {
-                                saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_SWITCH_CASE", 1);
-                                if (saved_stack) {
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        saved_stack[i] = value_clone(&value_stack[i]);
-                                    }
-                                }
-                            }
                             
                             // Execute case value sub-program
                             case_value = bytecode_execute(&temp_program, interpreter, 0);
                             
                             // Restore stack state
-                            while (value_stack_size > 0) {
-                                Value val = value_stack_pop();
-                                value_free(&val);
-                            }
-                            
-                            if (saved_stack && saved_stack_size > 0) {
-                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                    value_stack_push(saved_stack[i]);
-                                }
-                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                    value_free(&saved_stack[i]);
-                                }
-                                shared_free_safe(saved_stack, "bytecode_vm", "BC_SWITCH_CASE", 2);
-                            }
+                            value_stack_drop_to(saved_stack_size);
                             
                             // Get case value from stack if not returned directly
-                            if (value_stack_size > 0 && case_value.type == VALUE_NULL) {
+                            if (value_stack_size > saved_stack_size && case_value.type == VALUE_NULL) {
                                 Value stack_val = value_stack_pop();
                                 value_free(&case_value);
                                 case_value = stack_val;
@@ -6770,6 +7420,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 BytecodeProgram temp_program = {0};
                                 temp_program.code = case_body_func->code;
                                 temp_program.count = case_body_func->code_count;
+                                bc_share_function_feedback(&temp_program, case_body_func);
                                 temp_program.capacity = case_body_func->code_capacity;
                                 temp_program.const_count = program ? program->const_count : 0;
                                 temp_program.constants = program ? program->constants : NULL;
@@ -6789,15 +7440,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 // Save stack state before sub-program execution
                                 size_t saved_stack_size = value_stack_size;
-                                Value* saved_stack = NULL;
-                                if (saved_stack_size > 0) {
-                                    saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_SWITCH_CASE", 1);
-                                    if (saved_stack) {
-                                        for (size_t i = 0; i < saved_stack_size; i++) {
-                                            saved_stack[i] = value_clone(&value_stack[i]);
-                                        }
-                                    }
-                                }
                                 
                                 // Execute sub-program in current environment (no new environment created)
                                 // bytecode_execute will reset the stack, so we need to restore it after
@@ -6805,22 +7447,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 // Restore stack state after sub-program execution
                                 // Clear any values left by sub-program
-                                while (value_stack_size > 0) {
-                                    Value val = value_stack_pop();
-                                    value_free(&val);
-                                }
-                                
-                                // Restore saved stack
-                                if (saved_stack && saved_stack_size > 0) {
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        value_stack_push(saved_stack[i]);
-                                    }
-                                    // Free saved stack copies
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        value_free(&saved_stack[i]);
-                                    }
-                                    shared_free_safe(saved_stack, "bytecode_vm", "BC_SWITCH_CASE", 2);
-                                }
+                                value_stack_drop_to(saved_stack_size);
                             }
                         }
                         
@@ -6849,7 +7476,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SWITCH_DEFAULT: {
+            VM_CASE(BC_SWITCH_DEFAULT) {
                 // Switch default case: execute if no case matched
                 // Stack: [expression_value, matched_flag]
                 // instr->a = default body function ID (bytecode sub-program)
@@ -6871,6 +7498,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 BytecodeProgram temp_program = {0};
                                 temp_program.code = default_body_func->code;
                                 temp_program.count = default_body_func->code_count;
+                                bc_share_function_feedback(&temp_program, default_body_func);
                                 temp_program.capacity = default_body_func->code_capacity;
                                 temp_program.const_count = program ? program->const_count : 0;
                                 temp_program.constants = program ? program->constants : NULL;
@@ -6890,15 +7518,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 // Save stack state before sub-program execution
                                 size_t saved_stack_size = value_stack_size;
-                                Value* saved_stack = NULL;
-                                if (saved_stack_size > 0) {
-                                    saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_SWITCH_DEFAULT", 1);
-                                    if (saved_stack) {
-                                        for (size_t i = 0; i < saved_stack_size; i++) {
-                                            saved_stack[i] = value_clone(&value_stack[i]);
-                                        }
-                                    }
-                                }
                                 
                                 // Execute sub-program in current environment (no new environment created)
                                 // bytecode_execute will reset the stack, so we need to restore it after
@@ -6906,22 +7525,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                                 
                                 // Restore stack state after sub-program execution
                                 // Clear any values left by sub-program
-                                while (value_stack_size > 0) {
-                                    Value val = value_stack_pop();
-                                    value_free(&val);
-                                }
-                                
-                                // Restore saved stack
-                                if (saved_stack && saved_stack_size > 0) {
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        value_stack_push(saved_stack[i]);
-                                    }
-                                    // Free saved stack copies
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        value_free(&saved_stack[i]);
-                                    }
-                                    shared_free_safe(saved_stack, "bytecode_vm", "BC_SWITCH_DEFAULT", 2);
-                                }
+                                value_stack_drop_to(saved_stack_size);
                             }
                         }
                         value_stack_push(default_result);
@@ -6943,28 +7547,17 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_SWITCH: {
+            VM_CASE(BC_SWITCH) {
                 // Switch statement end: clean up and return result
                 // Stack should have the result from the matched case or default
                 // If there are extra values (flags), clean them up
                 // The result should be on top of the stack
-                if (value_stack_size > 1) {
+                if (value_stack_size > operand_base + 1) {
                     // Multiple values - keep the last one (result), free the rest
-                    Value* values = (Value*)shared_malloc_safe(value_stack_size * sizeof(Value), "bytecode_vm", "BC_SWITCH", 0);
-                    if (values) {
-                        // Pop all values
-                        for (size_t i = 0; i < value_stack_size; i++) {
-                            values[i] = value_stack_pop();
-                        }
-                        // Push the last value (result)
-                        value_stack_push(values[value_stack_size - 1]);
-                        // Free the rest
-                        for (size_t i = 0; i < value_stack_size - 1; i++) {
-                            value_free(&values[i]);
-                        }
-                        shared_free_safe(values, "bytecode_vm", "BC_SWITCH", 1);
-                    }
-                } else if (value_stack_size == 0) {
+                    Value switch_result = value_stack_pop();
+                    value_stack_drop_to(operand_base);
+                    value_stack_push(switch_result);
+                } else if (value_stack_size <= operand_base) {
                     // No result - push null
                     value_stack_push(value_create_null());
                 }
@@ -6973,7 +7566,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATCH_PATTERN: {
+            VM_CASE(BC_MATCH_PATTERN) {
                 // Match pattern: check if pattern matches expression
                 // instr->a = pattern function ID (bytecode sub-program)
                 // instr->b = match expression function ID (bytecode sub-program)
@@ -6991,6 +7584,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             BytecodeProgram temp_program = {0};
                             temp_program.code = expr_func->code;
                             temp_program.count = expr_func->code_count;
+                            bc_share_function_feedback(&temp_program, expr_func);
                             temp_program.capacity = expr_func->code_capacity;
                             temp_program.const_count = program ? program->const_count : 0;
                             temp_program.constants = program ? program->constants : NULL;
@@ -7010,37 +7604,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             
                             // Save stack state
                             size_t saved_stack_size = value_stack_size;
-                            Value* saved_stack = NULL;
-                            if (saved_stack_size > 0) {
-                                saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_MATCH_PATTERN", 1);
-                                if (saved_stack) {
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        saved_stack[i] = value_clone(&value_stack[i]);
-                                    }
-                                }
-                            }
                             
                             // Execute expression sub-program
                             match_value = bytecode_execute(&temp_program, interpreter, 0);
                             
                             // Restore stack state
-                            while (value_stack_size > 0) {
-                                Value val = value_stack_pop();
-                                value_free(&val);
-                            }
-                            
-                            if (saved_stack && saved_stack_size > 0) {
-                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                    value_stack_push(saved_stack[i]);
-                                }
-                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                    value_free(&saved_stack[i]);
-                                }
-                                shared_free_safe(saved_stack, "bytecode_vm", "BC_MATCH_PATTERN", 2);
-                            }
+                            value_stack_drop_to(saved_stack_size);
                             
                             // Get match value from stack if not returned directly
-                            if (value_stack_size > 0 && match_value.type == VALUE_NULL) {
+                            if (value_stack_size > saved_stack_size && match_value.type == VALUE_NULL) {
                                 Value stack_val = value_stack_pop();
                                 value_free(&match_value);
                                 match_value = stack_val;
@@ -7049,7 +7621,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                     
                     // If match_value is still null and stack has a value, use it
-                    if (match_value.type == VALUE_NULL && value_stack_size > 0) {
+                    if (match_value.type == VALUE_NULL && value_stack_size > operand_base) {
                         match_value = value_stack_pop();
                     }
                     
@@ -7063,6 +7635,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             BytecodeProgram temp_program = {0};
                             temp_program.code = pattern_func->code;
                             temp_program.count = pattern_func->code_count;
+                            bc_share_function_feedback(&temp_program, pattern_func);
                             temp_program.capacity = pattern_func->code_capacity;
                             temp_program.const_count = program ? program->const_count : 0;
                             temp_program.constants = program ? program->constants : NULL;
@@ -7082,37 +7655,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             
                             // Save stack state
                             size_t saved_stack_size = value_stack_size;
-                            Value* saved_stack = NULL;
-                            if (saved_stack_size > 0) {
-                                saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "BC_MATCH_PATTERN", 3);
-                                if (saved_stack) {
-                                    for (size_t i = 0; i < saved_stack_size; i++) {
-                                        saved_stack[i] = value_clone(&value_stack[i]);
-                                    }
-                                }
-                            }
                             
                             // Execute pattern sub-program
                             pattern_val = bytecode_execute(&temp_program, interpreter, 0);
                             
                             // Restore stack state
-                            while (value_stack_size > 0) {
-                                Value val = value_stack_pop();
-                                value_free(&val);
-                            }
-                            
-                            if (saved_stack && saved_stack_size > 0) {
-                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                    value_stack_push(saved_stack[i]);
-                                }
-                                for (size_t i = 0; i < saved_stack_size; i++) {
-                                    value_free(&saved_stack[i]);
-                                }
-                                shared_free_safe(saved_stack, "bytecode_vm", "BC_MATCH_PATTERN", 4);
-                            }
+                            value_stack_drop_to(saved_stack_size);
                             
                             // Get pattern value from stack if not returned directly
-                            if (value_stack_size > 0 && pattern_val.type == VALUE_NULL) {
+                            if (value_stack_size > saved_stack_size && pattern_val.type == VALUE_NULL) {
                                 Value stack_val = value_stack_pop();
                         value_free(&pattern_val);
                                 pattern_val = stack_val;
@@ -7135,7 +7686,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                 } else {
                     // Invalid pattern instruction
-                    if (value_stack_size > 0) {
+                    if (value_stack_size > operand_base) {
                         Value match_value = value_stack_pop();
                         value_free(&match_value);
                     }
@@ -7146,7 +7697,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_MATCH_END: {
+            VM_CASE(BC_MATCH_END) {
                 // Match expression end: clean up and return result
                 // Stack should have: [pattern_result, matched_flag] or [match_value, matched_flag]
                 // If matched, return pattern_result; otherwise return null
@@ -7156,25 +7707,22 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 // We need to find the first one where matched_flag is true
                 // For now, simplify: if we have at least 2 values, check the flag
                 
-                if (value_stack_size >= 2) {
+                if (value_stack_size >= operand_base + 2) {
                     // Pop the last matched flag
                     Value matched_flag = value_stack_pop();
                     int matched = (matched_flag.type == VALUE_BOOLEAN && matched_flag.data.boolean_value);
                     value_free(&matched_flag);
                     
-                    if (matched && value_stack_size > 0) {
+                    if (matched && value_stack_size > operand_base) {
                         // Pattern matched - result is on stack, keep it
                         // Result is already on top of stack, just leave it
                     } else {
                         // No pattern matched - clean up stack and return null
                         // Pop all remaining values (they're from unmatched patterns)
-                        while (value_stack_size > 0) {
-                            Value val = value_stack_pop();
-                            value_free(&val);
-                        }
+                        value_stack_drop_to(operand_base);
                         value_stack_push(value_create_null());
                     }
-                } else if (value_stack_size == 1) {
+                } else if (value_stack_size == operand_base + 1) {
                     // Only one value - might be a result or match_value
                     // Check if it's a boolean (flag) or result
                     Value top = value_stack_pop();
@@ -7194,7 +7742,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_CREATE_LAMBDA: {
+            VM_CASE(BC_CREATE_LAMBDA) {
                 // Create lambda function: (params) => body
                 // instr->a = lambda body AST index
                 // instr->b = function ID (for bytecode execution)
@@ -7263,6 +7811,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         // should be valid in the main program.
                         // ALWAYS prefer the main program if the function ID exists there, even if
                         // it also exists in the current program (module), to avoid function ID collisions.
+#ifdef MYCO_VM_TRACE
                         BytecodeProgram* target_program = program;
                         BytecodeProgram* main_program = NULL;
                         
@@ -7280,11 +7829,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         
                         // If we found a main program and the function ID is valid there, use it
                         if (main_program && instr->b >= 0 && instr->b < (int)main_program->function_count) {
-                            fprintf(stderr, "[BC_CREATE_LAMBDA] Switching to main_program for func_id=%d (main has %zu functions, current has %zu)\n",
+                            VM_TRACE("[BC_CREATE_LAMBDA] Switching to main_program for func_id=%d (main has %zu functions, current has %zu)\n",
                                     instr->b, main_program->function_count, program->function_count);
                             target_program = main_program;
                         } else {
-                            fprintf(stderr, "[BC_CREATE_LAMBDA] NOT switching: func_id=%d, main_program=%p, main_count=%zu, current_count=%zu\n",
+                            VM_TRACE("[BC_CREATE_LAMBDA] NOT switching: func_id=%d, main_program=%p, main_count=%zu, current_count=%zu\n",
                                     instr->b, main_program, main_program ? main_program->function_count : 0, program->function_count);
                         }
                         
@@ -7293,25 +7842,26 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                             const char* func_name = target_program->functions[instr->b].name ? 
                                 target_program->functions[instr->b].name : "<unnamed>";
                             int is_main = (interpreter && interpreter->main_program == target_program) ? 1 : 0;
-                            fprintf(stderr, "[BC_CREATE_LAMBDA] Creating lambda function: func_id=%d, name='%s', param_count=%zu (stored=%zu), code_count=%d, is_main_program=%d, current_program_is_main=%d\n", 
+                            VM_TRACE("[BC_CREATE_LAMBDA] Creating lambda function: func_id=%d, name='%s', param_count=%zu (stored=%zu), code_count=%d, is_main_program=%d, current_program_is_main=%d\n", 
                                     instr->b, func_name, target_program->functions[instr->b].param_count, lambda_param_count, target_program->functions[instr->b].code_count, is_main,
                                     (interpreter && interpreter->main_program == program) ? 1 : 0);
                             
                             // Verify param_count matches
                             if (target_program->functions[instr->b].param_count != lambda_param_count) {
-                                fprintf(stderr, "[BC_CREATE_LAMBDA] WARNING: param_count mismatch! Function has param_count=%zu, but lambda has param_count=%zu\n",
+                                VM_TRACE("[BC_CREATE_LAMBDA] WARNING: param_count mismatch! Function has param_count=%zu, but lambda has param_count=%zu\n",
                                         target_program->functions[instr->b].param_count, lambda_param_count);
                             }
                             
                             // If this is a handler lambda (param_count=1, code_count in reasonable range), log it specially
                             if (lambda_param_count == 1 && target_program->functions[instr->b].code_count >= 30 && target_program->functions[instr->b].code_count <= 100) {
-                                fprintf(stderr, "[BC_CREATE_LAMBDA] POTENTIAL HANDLER: func_id=%d, code_count=%d, is_main=%d\n",
+                                VM_TRACE("[BC_CREATE_LAMBDA] POTENTIAL HANDLER: func_id=%d, code_count=%d, is_main=%d\n",
                                         instr->b, target_program->functions[instr->b].code_count, is_main);
                             }
                         } else {
-                            fprintf(stderr, "[BC_CREATE_LAMBDA] WARNING: Invalid function ID %d (function_count=%zu in target_program, %zu in current_program)\n", 
+                            VM_TRACE("[BC_CREATE_LAMBDA] WARNING: Invalid function ID %d (function_count=%zu in target_program, %zu in current_program)\n", 
                                     instr->b, target_program->function_count, program->function_count);
                         }
+#endif
                         lambda_value = value_create_function(
                             (ASTNode*)(uintptr_t)instr->b, // Pass function ID as body (will be detected as bytecode function)
                             lambda_params,
@@ -7326,7 +7876,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         if (stored_addr < 10000) {
                             int stored_func_id = (int)stored_addr;
                             if (stored_func_id != instr->b) {
-                                fprintf(stderr, "[BC_CREATE_LAMBDA] ERROR: Function ID mismatch! Instruction has func_id=%d, but stored func_id=%d\n", 
+                                VM_TRACE("[BC_CREATE_LAMBDA] ERROR: Function ID mismatch! Instruction has func_id=%d, but stored func_id=%d\n", 
                                         instr->b, stored_func_id);
                             }
                         }
@@ -7340,7 +7890,7 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         if (stored_addr < 10000) {
                             int stored_func_id = (int)stored_addr;
                             if (stored_func_id != instr->b) {
-                                fprintf(stderr, "[BC_CREATE_LAMBDA] WARNING: Function ID mismatch! Instruction has func_id=%d, but stored func_id=%d\n", 
+                                VM_TRACE("[BC_CREATE_LAMBDA] WARNING: Function ID mismatch! Instruction has func_id=%d, but stored func_id=%d\n", 
                                         instr->b, stored_func_id);
                             }
                         }
@@ -7355,16 +7905,17 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_POP: {
-                Value val = value_stack_pop();
-                value_free(&val);
+            VM_CASE(BC_POP) {
+                if (value_stack_size > 0) {
+                    nan_boxing_release(value_stack[--value_stack_size]);
+                }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_DUP: {
+            VM_CASE(BC_DUP) {
                 // Duplicate top of stack
-                if (value_stack_size == 0) {
+                if (value_stack_size <= operand_base) {
                     if (interpreter) {
                         interpreter_set_error(interpreter, "Stack underflow in BC_DUP", 0, 0);
                     }
@@ -7373,10 +7924,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 Value top = value_stack_peek();
                 value_stack_push(value_clone(&top));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_PROMISE_CREATE: {
+            VM_CASE(BC_PROMISE_CREATE) {
                 // Create a pending promise
                 // Stack: [executor] -> [promise]
                 // For now, create a simple pending promise
@@ -7387,11 +7938,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_AWAIT: {
+            VM_CASE(BC_AWAIT) {
                 // Await promise: await promise -> value
                 // Stack: [promise] -> [value]
                 // Process event loop until promise is resolved
-                if (value_stack_size == 0) {
+                if (value_stack_size <= operand_base) {
                     if (interpreter) {
                         interpreter_set_error(interpreter, "Stack underflow in BC_AWAIT", 0, 0);
                     }
@@ -7436,7 +7987,8 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                         break;
                     }
                     
-                    // Run event loop again to process more tasks
+                    // Sleep until something could have settled it, then run the loop again
+                    async_event_loop_wait(interpreter, ASYNC_AWAIT_WAIT_MS);
                     async_event_loop_run(interpreter);
                     iterations++;
                 }
@@ -7492,11 +8044,11 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_ASYNC_CALL: {
+            VM_CASE(BC_ASYNC_CALL) {
                 // Call async function: async_func(args...) -> Promise
                 // Stack: [func, arg1, arg2, ...] -> [promise]
                 // Create async task and add to queue
-                if (value_stack_size == 0) {
+                if (value_stack_size <= operand_base) {
                     if (interpreter) {
                         interpreter_set_error(interpreter, "Stack underflow in BC_ASYNC_CALL", 0, 0);
                     }
@@ -7590,9 +8142,9 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 break;
             }
             
-            case BC_HALT: {
+            VM_CASE(BC_HALT) {
                 // Pop result if stack has value, otherwise return null
-                if (value_stack_size > 0) {
+                if (value_stack_size > stack_base) {
                     result = value_stack_pop();
                 } else {
                     result = value_create_null();
@@ -7601,35 +8153,35 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
             }
             
             // Numeric operations
-            case BC_LOAD_NUM: {
+            VM_CASE(BC_LOAD_NUM) {
                 if (instr->a < program->num_const_count) {
                     num_stack_push(program->num_constants[instr->a]);
                 } else {
                     num_stack_push(0.0);
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_LOAD_NUM_LOCAL: {
+            VM_CASE(BC_LOAD_NUM_LOCAL) {
                 if (instr->a < program->num_local_count) {
                     num_stack_push(program->num_locals[instr->a]);
                 } else {
                     num_stack_push(0.0);
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_STORE_NUM_LOCAL: {
+            VM_CASE(BC_STORE_NUM_LOCAL) {
                 if (instr->a < program->num_local_count) {
                     program->num_locals[instr->a] = num_stack_pop();
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_ADD_NUM: {
+            VM_CASE(BC_ADD_NUM) {
                 // Fast path: direct stack access without function calls
                 if (LIKELY(num_stack_size >= 2)) {
                     // Pop right operand first (top of stack)
@@ -7646,10 +8198,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     num_stack_push(a + b);
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_SUB_NUM: {
+            VM_CASE(BC_SUB_NUM) {
                 // Fast path: direct stack access without function calls
                 if (num_stack_size >= 2) {
                     double b = num_stack[--num_stack_size];
@@ -7663,10 +8215,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     num_stack_push(a - b);
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_MUL_NUM: {
+            VM_CASE(BC_MUL_NUM) {
                 // Fast path: direct stack access without function calls
                 if (num_stack_size >= 2) {
                     double b = num_stack[--num_stack_size];
@@ -7680,10 +8232,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     num_stack_push(a * b);
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_DIV_NUM: {
+            VM_CASE(BC_DIV_NUM) {
                 // Fast path: direct stack access without function calls
                 if (num_stack_size >= 2) {
                     double b = num_stack[--num_stack_size];
@@ -7705,10 +8257,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_MOD_NUM: {
+            VM_CASE(BC_MOD_NUM) {
                 // Fast path: direct stack access without function calls
                 if (num_stack_size >= 2) {
                     double b = num_stack[--num_stack_size];
@@ -7730,60 +8282,58 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_LT_NUM: {
+            VM_CASE(BC_LT_NUM) {
                 double b = num_stack_pop();
                 double a = num_stack_pop();
                 value_stack_push(value_create_boolean(a < b));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_LE_NUM: {
+            VM_CASE(BC_LE_NUM) {
                 double b = num_stack_pop();
                 double a = num_stack_pop();
                 value_stack_push(value_create_boolean(a <= b));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_GT_NUM: {
+            VM_CASE(BC_GT_NUM) {
                 double b = num_stack_pop();
                 double a = num_stack_pop();
                 value_stack_push(value_create_boolean(a > b));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_GE_NUM: {
-                if (program->count > 100) {
-                }
+            VM_CASE(BC_GE_NUM) {
                 double b = num_stack_pop();
                 double a = num_stack_pop();
                 value_stack_push(value_create_boolean(a >= b));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_EQ_NUM: {
+            VM_CASE(BC_EQ_NUM) {
                 double b = num_stack_pop();
                 double a = num_stack_pop();
                 value_stack_push(value_create_boolean(a == b));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_NE_NUM: {
+            VM_CASE(BC_NE_NUM) {
                 double b = num_stack_pop();
                 double a = num_stack_pop();
                 value_stack_push(value_create_boolean(a != b));
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_VALUE_TO_NUM: {
+            VM_CASE(BC_VALUE_TO_NUM) {
                 Value val = value_stack_pop();
                 if (val.type == VALUE_NUMBER) {
                     num_stack_push(val.data.number_value);
@@ -7792,10 +8342,10 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                 }
                 value_free(&val);
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_NUM_TO_VALUE: {
+            VM_CASE(BC_NUM_TO_VALUE) {
                 // CRITICAL: Ensure numeric stack is not empty before popping
                 // If stack is empty, this means there's a bug in compilation
                 if (num_stack_size == 0) {
@@ -7811,11 +8361,15 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     value_stack_push(value_create_number(num));
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
             
-            case BC_INC_LOCAL: {
+            VM_CASE(BC_INC_LOCAL) {
+                if (UNLIKELY(bc_main_local_add_generic(interpreter, program, instr->a, 1.0))) {
+                    pc++;
+                    VM_NEXT();
+                }
                 if (instr->a < program->num_local_count) {
                     program->num_locals[instr->a] += 1.0;
                     
@@ -7826,25 +8380,22 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                     
                     // Also update environment so AST-interpreted code can access it
-                    if (interpreter && interpreter->current_environment && program->local_names && 
-                        instr->a >= 0 && (size_t)instr->a < program->local_count) {
-                        const char* var_name = program->local_names[instr->a];
-                        if (var_name) {
-                            Value updated_val = value_create_number(program->num_locals[instr->a]);
-                            if (environment_exists(interpreter->current_environment, var_name)) {
-                                environment_assign(interpreter->current_environment, var_name, updated_val);
-                            } else {
-                                environment_define(interpreter->current_environment, var_name, updated_val);
-                            }
-                            value_free(&updated_val);
-                        }
+                    Value* bound = bc_local_binding(interpreter, program, instr->a, 1);
+                    if (bound) {
+                        value_free(bound);
+                        *bound = value_create_number(program->num_locals[instr->a]);
                     }
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_ADD_LOCAL_IMM: {
+            VM_CASE(BC_ADD_LOCAL_IMM) {
+                if (UNLIKELY(instr->b < program->num_const_count &&
+                             bc_main_local_add_generic(interpreter, program, instr->a, program->num_constants[instr->b]))) {
+                    pc++;
+                    VM_NEXT();
+                }
                 if (instr->a < program->num_local_count && instr->b < program->num_const_count) {
                     program->num_locals[instr->a] += program->num_constants[instr->b];
                     
@@ -7855,34 +8406,54 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
                     }
                     
                     // Also update environment so AST-interpreted code can access it
-                    if (interpreter && interpreter->current_environment && program->local_names && 
-                        instr->a >= 0 && (size_t)instr->a < program->local_count) {
-                        const char* var_name = program->local_names[instr->a];
-                        if (var_name) {
-                            Value updated_val = value_create_number(program->num_locals[instr->a]);
-                            if (environment_exists(interpreter->current_environment, var_name)) {
-                                environment_assign(interpreter->current_environment, var_name, updated_val);
-                            } else {
-                                environment_define(interpreter->current_environment, var_name, updated_val);
-                            }
-                            value_free(&updated_val);
-                        }
+                    Value* bound = bc_local_binding(interpreter, program, instr->a, 1);
+                    if (bound) {
+                        value_free(bound);
+                        *bound = value_create_number(program->num_locals[instr->a]);
                     }
                 }
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            case BC_ADD_LLL: {
-                double c = num_stack_pop();
-                double b = num_stack_pop();
-                double a = num_stack_pop();
-                num_stack_push(a + b + c);
+            VM_CASE(BC_ADD_LLL) {
+                // a = b + c on locals, emitted for `x = x + y`
+                if (frame) {
+                    if (LIKELY(instr->a >= 0 && instr->b >= 0 && instr->c >= 0 &&
+                               (size_t)instr->a < frame_local_count && (size_t)instr->b < frame_local_count &&
+                               (size_t)instr->c < frame_local_count)) {
+                        NanBoxedValue left = value_stack[frame_base + instr->b];
+                        NanBoxedValue right = value_stack[frame_base + instr->c];
+                        NanBoxedValue sum;
+                        if (LIKELY(nan_boxing_is_number(left) && nan_boxing_is_number(right))) {
+                            sum = nan_boxing_create_number(nan_boxing_get_number(left) + nan_boxing_get_number(right));
+                        } else {
+                            Value l = nan_boxing_peek(left);
+                            Value r = nan_boxing_peek(right);
+                            sum = nan_boxing_box(value_add(&l, &r));
+                        }
+                        nan_boxing_release(value_stack[frame_base + instr->a]);
+                        value_stack[frame_base + instr->a] = sum;
+                    }
+                    pc++;
+                    VM_NEXT();
+                }
+                Value left = bc_main_local_load(interpreter, program, instr->b);
+                Value right = bc_main_local_load(interpreter, program, instr->c);
+                Value sum;
+                if (LIKELY(left.type == VALUE_NUMBER && right.type == VALUE_NUMBER)) {
+                    sum = value_create_number(left.data.number_value + right.data.number_value);
+                } else {
+                    sum = value_add(&left, &right);
+                }
+                value_free(&left);
+                value_free(&right);
+                bc_main_local_store(interpreter, program, instr->a, 0, sum);
                 pc++;
-                break;
+                VM_NEXT();
             }
             
-            default: {
+            VM_DEFAULT {
                 // Unknown opcode - report error but continue execution for now to debug
                 // Log the opcode value for debugging
                 if (interpreter) {
@@ -7902,9 +8473,6 @@ Value bytecode_execute(BytecodeProgram* program, Interpreter* interpreter, int d
     }
     
 cleanup:
-    // Debug: Log when cleanup is reached
-    if (program && program->count > 100) {
-    }
     
     // Process any remaining async tasks before cleanup
     // Temporarily disabled to debug segfault
@@ -7913,14 +8481,16 @@ cleanup:
     // }
     
     // Clean up any remaining stack values
-    while (value_stack_size > 0) {
-        Value val = value_stack_pop();
-        value_free(&val);
-    }
+    value_stack_drop_to(stack_base);
     
     // CRITICAL: Clear numeric stack to prevent leftover values from affecting next execution
     // Leftover values on numeric stack can cause arithmetic bugs
-    num_stack_size = 0;
+    num_stack_size = num_stack_base;
+    
+    vm_run_depth--;
+    if (!outermost) {
+        return result;
+    }
     
     // Free stack memory if it grew too large (prevent memory bloat)
     // Keep a reasonable capacity (128 entries) to avoid constant reallocation
@@ -7932,7 +8502,7 @@ cleanup:
         value_stack_size = 0;
     } else if (value_stack_capacity > 128) {
         // If capacity is between 128 and 1024, shrink it back to 128 to prevent bloat
-        Value* new_stack = shared_realloc_safe(value_stack, 128 * sizeof(Value), "bytecode_vm", "shrink_stack", 1);
+        NanBoxedValue* new_stack = shared_realloc_safe(value_stack, 128 * sizeof(NanBoxedValue), "bytecode_vm", "shrink_stack", 1);
         if (new_stack) {
             value_stack = new_stack;
             value_stack_capacity = 128;
@@ -7951,6 +8521,191 @@ cleanup:
     return result;
 }
 
+// ============================================================================
+// CALL FRAMES
+// ============================================================================
+// A call reserves a frame on the shared value stack: parameters and lets of
+// frame-slot functions occupy value_stack[local_start ...], operands sit above
+// them, and returning unwinds the stack back to local_start. Each function
+// keeps one execution view of its code, reused across calls.
+
+static BytecodeProgram* bc_function_program(BytecodeProgram* owner, BytecodeFunction* func) {
+    BytecodeProgram* view = func->frame_program;
+    if (!view) {
+        view = shared_malloc_safe(sizeof(BytecodeProgram), "bytecode_vm", "bc_function_program", 0);
+        if (!view) return NULL;
+        memset(view, 0, sizeof(BytecodeProgram));
+        func->frame_program = view;
+    }
+    // The owner's tables may grow between calls, so refresh them every time
+    view->code = func->code;
+    view->count = func->code_count;
+    view->capacity = func->code_capacity;
+    view->const_count = owner ? owner->const_count : 0;
+    view->constants = owner ? owner->constants : NULL;
+    view->num_const_count = owner ? owner->num_const_count : 0;
+    view->num_constants = owner ? owner->num_constants : NULL;
+    view->ast_count = owner ? owner->ast_count : 0;
+    view->ast_nodes = owner ? owner->ast_nodes : NULL;
+    view->function_count = owner ? owner->function_count : 0;
+    view->functions = owner ? owner->functions : NULL;
+    view->local_slot_count = func->uses_frame_slots ? func->local_count : 0;
+    bc_share_function_feedback(view, func);
+    return view;
+}
+
+// ============================================================================
+// REGISTER TIER
+// ============================================================================
+// Frame-slot functions count their calls and loop back-edges. Once a function
+// reaches MYCO_VM_TIER_UP_THRESHOLD it is lowered to register code (see
+// optimization/register_vm.c): later calls run the register code, and a frame
+// already in a hot loop switches over at its next back-edge. Functions the
+// lowering rejects stay on the stack VM. Define MYCO_VM_NO_REGISTER_TIER to
+// disable the tier.
+
+#ifndef MYCO_VM_TIER_UP_THRESHOLD
+#define MYCO_VM_TIER_UP_THRESHOLD 1000
+#endif
+
+// Count one call or back-edge of func; returns its register code once hot
+static RegisterProgram* bc_tier_up(Interpreter* interpreter, BytecodeProgram* owner, BytecodeFunction* func) {
+#ifdef MYCO_VM_NO_REGISTER_TIER
+    (void)interpreter;
+    (void)owner;
+    (void)func;
+    return NULL;
+#else
+    if (LIKELY(func->register_program != NULL) || func->tier_attempted) {
+        return func->register_program;
+    }
+    if (++func->hotness < MYCO_VM_TIER_UP_THRESHOLD) {
+        return NULL;
+    }
+    func->tier_attempted = true;
+    if (func->uses_frame_slots && !func->needs_environment && owner) {
+        func->register_program = register_tier_compile(func, owner);
+    }
+    // --jit: numeric register code also gets baseline native code
+    if (func->register_program && interpreter->jit_enabled) {
+        micro_jit_compile_register_program(interpreter, func->register_program);
+    }
+    return func->register_program;
+#endif
+}
+
+// Run register code on the frame whose slots start at frame_base. The slots
+// move into registers, so the value stack is unwound to frame_base.
+static Value bc_run_register_frame(Interpreter* interpreter, BytecodeProgram* owner, RegisterProgram* code,
+                                   size_t frame_base, size_t entry) {
+    size_t slot_count = value_stack_size > frame_base ? value_stack_size - frame_base : 0;
+    value_stack_size = frame_base;
+    vm_run_depth++;
+    Value result = register_tier_execute(code, interpreter, owner, value_stack + frame_base, slot_count, entry);
+    vm_run_depth--;
+    return result;
+}
+
+NanBoxedValue bytecode_call_user_function_words(Interpreter* interpreter, BytecodeProgram* owner,
+                                                int func_id, NanBoxedValue* args, int arg_count) {
+    BytecodeProgram* func_program = interpreter->bytecode_program_cache ? interpreter->bytecode_program_cache : owner;
+    if (func_id >= 0 && (size_t)func_id < func_program->function_count && func_program->functions) {
+        // Register code calling register code hands its argument words over
+        // directly, without a trip through the value stack
+        BytecodeFunction* func = &func_program->functions[func_id];
+        RegisterProgram* register_code = func->register_program;
+        if (register_code && (size_t)arg_count == func->param_count) {
+            vm_run_depth++;
+            Value result = register_tier_execute(register_code, interpreter, func_program, args, (size_t)arg_count, 0);
+            vm_run_depth--;
+            return nan_boxing_box(result);
+        }
+    }
+    
+    size_t base = value_stack_size;
+    for (int i = 0; i < arg_count; i++) {
+        value_stack_push_word(args[i]);
+    }
+    bc_call_user_function(interpreter, func_program, func_id, arg_count, base);
+    NanBoxedValue result = value_stack_size > base ? value_stack[--value_stack_size] : NAN_BOX_NULL_VALUE;
+    value_stack_drop_to(base);
+    return result;
+}
+
+// Run func's body in a frame whose slots start at frame_base on the value
+// stack. Unwinds the stack to frame_base and returns the function's result.
+static Value bc_run_frame(Interpreter* interpreter, BytecodeProgram* owner, BytecodeFunction* func, size_t frame_base) {
+    Value result = value_create_null();
+    BytecodeProgram* view = bc_function_program(owner, func);
+    
+    BytecodeCallFrame frame = {0};
+    frame.local_start = frame_base;
+    frame.local_count = func->uses_frame_slots ? func->local_count : 0;
+    frame.function = func;
+    frame.owner = owner;
+    RegisterProgram* register_code = bc_tier_up(interpreter, owner, func);
+    
+    if (view && func->code_count > 0) {
+        // Record the frame on the owner's call stack for introspection
+        if (owner) {
+            if (owner->call_stack_size >= owner->call_stack_capacity) {
+                size_t new_capacity = owner->call_stack_capacity ? owner->call_stack_capacity * 2 : 16;
+                BytecodeCallFrame* grown = shared_realloc_safe(owner->call_stack, new_capacity * sizeof(BytecodeCallFrame),
+                                                               "bytecode_vm", "bc_run_frame", 0);
+                if (grown) {
+                    owner->call_stack = grown;
+                    owner->call_stack_capacity = new_capacity;
+                }
+            }
+            if (owner->call_stack_size < owner->call_stack_capacity) {
+                owner->call_stack[owner->call_stack_size] = frame;
+            }
+            owner->call_stack_size++;
+        }
+        
+        interpreter->has_return = 0;
+        if (register_code) {
+            result = bc_run_register_frame(interpreter, owner, register_code, frame_base, 0);
+        } else {
+            result = bytecode_run(view, interpreter, 0, &frame);
+        }
+        
+        // BC_RETURN leaves the value in interpreter->return_value; BC_POP_FRAME
+        // hands it back directly
+        if (interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
+            value_free(&result);
+            result = interpreter->return_value;
+            interpreter->return_value = value_create_null();
+        }
+        interpreter->has_return = 0;
+        
+        if (owner && owner->call_stack_size > 0) {
+            owner->call_stack_size--;
+        }
+    }
+    
+    // Release the frame's slots
+    value_stack_drop_to(frame_base);
+    
+    return result;
+}
+
+// Call a frame-slot function whose arguments are the top arg_count values on
+// the stack. The arguments become its parameter slots in place.
+static Value bc_call_frame(Interpreter* interpreter, BytecodeProgram* owner, BytecodeFunction* func, int arg_count) {
+    int param_count = (int)func->param_count;
+    while (arg_count > param_count) {
+        Value extra = value_stack_pop();
+        value_free(&extra);
+        arg_count--;
+    }
+    while (arg_count < param_count) {
+        value_stack_push(value_create_null());
+        arg_count++;
+    }
+    return bc_run_frame(interpreter, owner, func, value_stack_size - (size_t)param_count);
+}
+
 // Execute a user-defined function's bytecode
 Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunction* func, Value* args, int arg_count, BytecodeProgram* program) {
     if (!func || !interpreter) {
@@ -7958,9 +8713,18 @@ Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunct
         return value_create_null();
     }
     
-    // Debug: Log function execution
-    fprintf(stderr, "[BYTECODE_EXEC] Executing function: code_count=%zu, param_count=%zu, arg_count=%d\n", 
-            func->code_count, func->param_count, arg_count);
+    size_t frame_base = value_stack_size;
+    size_t param_count = func->param_count;
+    
+    if (func->uses_frame_slots) {
+        // Parameters become the first frame slots
+        for (size_t i = 0; i < param_count; i++) {
+            value_stack_push(args && i < (size_t)arg_count ? value_clone(&args[i]) : value_create_null());
+        }
+        if (!func->needs_environment) {
+            return bc_run_frame(interpreter, program, func, frame_base);
+        }
+    }
     
     // Create new environment for function execution
     // IMPORTANT: For async functions, the captured environment should have access to module-level constants
@@ -7983,15 +8747,16 @@ Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunct
     }
     Environment* func_env = environment_create(base_env);
     if (!func_env) {
+        value_stack_drop_to(frame_base);
         return value_create_null();
     }
     
-    // Bind parameters to arguments
-    size_t param_count = func->param_count;
-    for (size_t i = 0; i < param_count && i < (size_t)arg_count; i++) {
-        if (func->param_names && func->param_names[i]) {
-            const char* param_name = func->param_names[i];
-            environment_define(func_env, param_name, value_clone(&args[i]));
+    // Bind parameters to arguments (frame-slot functions already hold them in slots)
+    if (!func->uses_frame_slots) {
+        for (size_t i = 0; i < param_count && i < (size_t)arg_count; i++) {
+            if (func->param_names && func->param_names[i]) {
+                environment_define(func_env, func->param_names[i], args[i]);
+            }
         }
     }
     
@@ -7999,148 +8764,7 @@ Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunct
     Environment* old_env = interpreter->current_environment;
     interpreter->current_environment = func_env;
     
-    // Execute the function's bytecode
-    Value result = value_create_null();
-    
-    // Debug: Check if function has code
-    if (func->code_count == 0) {
-        fprintf(stderr, "[BYTECODE_EXEC] WARNING: Function has no bytecode (code_count=0)\n");
-    }
-    
-    if (func->code_count > 0) {
-        // Debug: Log function execution
-        // Create a temporary program with just this function's code
-        // We need to pass the constants AND functions from the main program
-        // so recursive calls can find themselves
-        BytecodeProgram temp_program = {0};
-        temp_program.code = func->code;
-        temp_program.count = func->code_count;
-        temp_program.const_count = program ? program->const_count : 0;
-        temp_program.constants = program ? program->constants : NULL;
-        temp_program.num_const_count = program ? program->num_const_count : 0;
-        temp_program.num_constants = program ? program->num_constants : NULL;
-        temp_program.ast_count = program ? program->ast_count : 0;
-        temp_program.ast_nodes = program ? program->ast_nodes : NULL;
-        temp_program.function_count = program ? program->function_count : 0;
-        temp_program.functions = program ? program->functions : NULL;
-        temp_program.interpreter = interpreter;
-        // Set local_slot_count to match code_count to ensure jump targets are valid
-        temp_program.local_slot_count = func->code_count;
-        
-        
-        // Execute the function's bytecode
-        // Save stack state before recursive call
-        // The stack may contain operands from the calling expression
-        size_t saved_stack_size = value_stack_size;
-        Value* saved_stack = NULL;
-        if (saved_stack_size > 0) {
-            saved_stack = shared_malloc_safe(saved_stack_size * sizeof(Value), "bytecode_vm", "bytecode_execute_function_bytecode", 1);
-            if (saved_stack) {
-                for (size_t i = 0; i < saved_stack_size; i++) {
-                    saved_stack[i] = value_clone(&value_stack[i]);
-                }
-            }
-        }
-        
-        // Reset return flag before execution
-        // IMPORTANT: Don't clear interpreter->return_value here - it might contain a value
-        // from a previous call. We'll check interpreter->has_return after execution.
-        interpreter->has_return = 0;
-        
-        // Check for errors before execution
-        extern int interpreter_has_error(Interpreter* interpreter);
-        int had_error_before = interpreter_has_error(interpreter);
-        if (had_error_before) {
-            fprintf(stderr, "[BYTECODE_EXEC] WARNING: Interpreter has error before function execution\n");
-        }
-        
-        fprintf(stderr, "[BYTECODE_EXEC] About to execute function bytecode (code_count=%zu)\n", func->code_count);
-        result = bytecode_execute(&temp_program, interpreter, 0);
-        fprintf(stderr, "[BYTECODE_EXEC] Function bytecode execution completed\n");
-        
-        // Check for errors after execution
-        int has_error_after = interpreter_has_error(interpreter);
-        if (has_error_after) {
-            fprintf(stderr, "[BYTECODE_EXEC] ERROR: Interpreter has error after function execution\n");
-        }
-        
-        // Save the function's return value (if any) before restoring stack
-        // Check has_return first - if set, the return value is in interpreter->return_value
-        // This is the authoritative source when BC_RETURN is used
-        Value function_return_value = value_create_null();
-        int has_function_return = 0;
-        if (interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
-            // Function used BC_RETURN - the return value is in interpreter->return_value
-            function_return_value = value_clone(&interpreter->return_value);
-            has_function_return = 1;
-            // DON'T clear the flag or free return_value yet - keep them around
-            // until after we've updated result, so callers can check if needed
-            // We'll clear them after updating result (see below)
-        } else if (result.type != VALUE_NULL) {
-            // If bytecode_execute returned a non-null result, use that
-            // This handles cases where BC_RETURN set result but interpreter->has_return wasn't set
-            function_return_value = value_clone(&result);
-            has_function_return = 1;
-        } else if (value_stack_size > saved_stack_size) {
-            // If function didn't use BC_RETURN, the result might be on the stack
-            // Only pop if there are more values on the stack than we saved
-            // (This means the function left a value on the stack)
-            function_return_value = value_stack_pop();
-            has_function_return = 1;
-        }
-        
-        // Restore stack state after recursive call
-        if (saved_stack && saved_stack_size > 0) {
-            // Clear any remaining values left on stack by function execution
-            while (value_stack_size > 0) {
-                Value val = value_stack_pop();
-                value_free(&val);
-            }
-            // Restore saved stack
-            for (size_t i = 0; i < saved_stack_size; i++) {
-                value_stack_push(saved_stack[i]);
-            }
-            // Free saved stack copies
-            for (size_t i = 0; i < saved_stack_size; i++) {
-                value_free(&saved_stack[i]);
-            }
-            shared_free_safe(saved_stack, "bytecode_vm", "bytecode_execute_function_bytecode", 2);
-        }
-        
-        // Push the function's return value onto the stack after restoring the saved stack
-        if (has_function_return) {
-            value_stack_push(function_return_value);
-        }
-        
-        // Update result to match the return value
-        // This is critical - result must contain the function's return value
-        if (has_function_return) {
-            value_free(&result);
-            result = value_clone(&function_return_value);
-        }
-        
-        // Free interpreter->return_value and clear has_return now that we've captured it
-        // Do this AFTER we've updated result, so callers can check interpreter->has_return if needed
-        // IMPORTANT: Only clear if has_function_return is true AND we got it from interpreter->return_value
-        // If has_function_return is false, we didn't capture it, so leave interpreter->has_return set
-        // so the caller can check it (the safety net at the end will handle it)
-        if (has_function_return) {
-            // We captured a return value - check if it was from interpreter->return_value
-            if (interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
-                // We captured the return value from interpreter->return_value
-                // Now we can free it and clear the flag
-                value_free(&interpreter->return_value);
-                interpreter->return_value = value_create_null();
-                interpreter->has_return = 0;
-            }
-        }
-        // If has_function_return is false, we didn't capture a return value
-        // Leave interpreter->has_return and interpreter->return_value alone
-        // so the caller can check them (the safety net at the end will handle it)
-        
-        // Note: The return value is pushed onto the stack at line 4159 above
-        // so it's available for the caller (BC_CALL_USER_FUNCTION or BC_CALL_FUNCTION_VALUE)
-    }
+    Value result = bc_run_frame(interpreter, program, func, frame_base);
     
     // Restore old environment
     interpreter->current_environment = old_env;
@@ -8148,17 +8772,6 @@ Value bytecode_execute_function_bytecode(Interpreter* interpreter, BytecodeFunct
     // Clean up function environment
     environment_free(func_env);
     
-    // Final check: if result is NULL but interpreter->has_return is still set,
-    // use interpreter->return_value as the return value
-    // This shouldn't happen if everything worked correctly, but it's a safety net
-    if (result.type == VALUE_NULL && interpreter->has_return && interpreter->return_value.type != VALUE_NULL) {
-        value_free(&result);
-        result = value_clone(&interpreter->return_value);
-        interpreter->has_return = 0;
-        value_free(&interpreter->return_value);
-        interpreter->return_value = value_create_null();
-    }
-    
     return result;
 }
 
@@ -8190,6 +8803,183 @@ static int pattern_matches_value(Value* value, Value* pattern) {
     return 0;
 }
 
+// ============================================================================
+// LOOP TRACES
+// ============================================================================
+// Main-program loop headers count their iterations. Once a header reaches
+// MYCO_VM_TRACE_THRESHOLD, one iteration is recorded over the locals'
+// current values (see optimization/trace_recorder.c), optimized, and lowered
+// to register code that the header enters from then on; a side exit hands
+// the loop back to the stack VM at the pc it names. Headers whose recording
+// fails, or whose trace keeps leaving before it finishes an iteration, are
+// blacklisted. Define MYCO_VM_NO_LOOP_TRACES to disable tracing.
+
+#ifndef MYCO_VM_TRACE_THRESHOLD
+#define MYCO_VM_TRACE_THRESHOLD 1000
+#endif
+#define BC_LOOP_TRACE_MAX_EARLY_EXITS 64
+#define BC_LOOP_TRACE_BRANCH_THRESHOLD 16
+
+static BytecodeLoopSite* bc_loop_site(BytecodeProgram* program, size_t pc) {
+    if (pc >= program->loop_site_capacity) {
+        size_t new_capacity = program->count > pc ? program->count : pc + 1;
+        BytecodeLoopSite* grown = shared_realloc_safe(program->loop_sites,
+            new_capacity * sizeof(BytecodeLoopSite), "bytecode_vm", "bc_loop_site", 0);
+        if (!grown) return NULL;
+        memset(grown + program->loop_site_capacity, 0,
+               (new_capacity - program->loop_site_capacity) * sizeof(BytecodeLoopSite));
+        program->loop_sites = grown;
+        program->loop_site_capacity = new_capacity;
+    }
+    return &program->loop_sites[pc];
+}
+
+// Number and boolean locals as the recorder sees them (anything else is null)
+static NanBoxedValue* bc_loop_trace_locals(Interpreter* interpreter, BytecodeProgram* program) {
+    size_t slot_count = program->local_slot_count < program->local_count ? program->local_slot_count : program->local_count;
+    NanBoxedValue* locals = shared_malloc_safe((program->local_slot_count + 1) * sizeof(NanBoxedValue),
+                                               "bytecode_vm", "bc_loop_trace_locals", 0);
+    if (!locals) return NULL;
+    for (size_t i = 0; i < program->local_slot_count; i++) {
+        locals[i] = NAN_BOX_NULL_VALUE;
+        if (i >= slot_count) continue;
+        Value value = bc_main_local_load(interpreter, program, (int)i);
+        if (value.type == VALUE_NUMBER || value.type == VALUE_BOOLEAN) {
+            locals[i] = nan_boxing_box(value);
+        } else {
+            value_free(&value);
+        }
+    }
+    return locals;
+}
+
+static LoopTrace* bc_loop_trace_build(Interpreter* interpreter, BytecodeProgram* program, size_t pc) {
+    NanBoxedValue* locals = bc_loop_trace_locals(interpreter, program);
+    if (!locals) return NULL;
+    LoopTrace* trace = loop_trace_record(program, pc, locals);
+    shared_free_safe(locals, "bytecode_vm", "bc_loop_trace_build", 0);
+    
+    if (trace && loop_trace_optimize(trace)) {
+        trace->program = register_tier_compile_trace(trace);
+    }
+    if (trace && !trace->program) {
+        loop_trace_free(trace);
+        return NULL;
+    }
+    if (trace && interpreter->jit_enabled) {
+        micro_jit_compile_register_program(interpreter, trace->program);
+    }
+    return trace;
+}
+
+// The trace left before finishing an iteration; give up on it if that keeps happening
+static void bc_loop_trace_early_exit(BytecodeLoopSite* site) {
+    if (++site->trace->early_exits < BC_LOOP_TRACE_MAX_EARLY_EXITS) return;
+    loop_trace_free(site->trace);
+    site->trace = NULL;
+    site->blacklisted = true;
+    loop_trace_stats()->traces_invalidated++;
+}
+
+// A side exit that keeps being taken gets a branch, recorded from the state
+// the stack VM resumes in, and the trace is lowered again
+static void bc_loop_trace_extend(Interpreter* interpreter, BytecodeProgram* program, BytecodeLoopSite* site,
+                                 size_t exit_pc) {
+    LoopTrace* trace = site->trace;
+    size_t exit = 0;
+    while (exit < trace->exit_count && trace->exits[exit].pc != exit_pc) exit++;
+    if (exit == trace->exit_count || trace->exits[exit].branch_attempted ||
+        ++trace->exits[exit].hits < BC_LOOP_TRACE_BRANCH_THRESHOLD) {
+        return;
+    }
+    NanBoxedValue* locals = bc_loop_trace_locals(interpreter, program);
+    bool attached = locals && loop_trace_record_branch(trace, program, exit, locals);
+    shared_free_safe(locals, "bytecode_vm", "bc_loop_trace_extend", 0);
+    if (!attached) return;
+    
+    RegisterProgram* code = register_tier_compile_trace(trace);
+    if (!code) {
+        loop_trace_free(trace);
+        site->trace = NULL;
+        site->blacklisted = true;
+        return;
+    }
+    register_program_free(trace->program);
+    trace->program = code;
+    if (interpreter->jit_enabled) {
+        micro_jit_compile_register_program(interpreter, code);
+    }
+}
+
+// Reach the loop header at pc; returns the pc to continue at
+static size_t bc_loop_trace_enter(Interpreter* interpreter, BytecodeProgram* program, size_t pc) {
+#ifdef MYCO_VM_NO_LOOP_TRACES
+    (void)interpreter;
+    (void)program;
+    return pc + 1;
+#else
+    BytecodeLoopSite* site = bc_loop_site(program, pc);
+    if (!site || site->blacklisted) return pc + 1;
+    if (!site->trace) {
+        if (++site->hotness < MYCO_VM_TRACE_THRESHOLD) return pc + 1;
+        site->trace = bc_loop_trace_build(interpreter, program, pc);
+        if (!site->trace) {
+            site->blacklisted = true;
+            return pc + 1;
+        }
+    }
+    
+    // Locals the trace reads before writing must still have the recorded
+    // types, and counters it bumps must agree with their numeric shadow
+    LoopTrace* trace = site->trace;
+    NanBoxedValue words[REG_TIER_MAX_REGISTERS];
+    size_t count = 0;
+    for (size_t r = 0; r < trace->register_count; r++) {
+        const LoopTraceRegister* reg = &trace->registers[r];
+        if (reg->kind != LOOP_TRACE_LOCAL) continue;
+        NanBoxedValue word = NAN_BOX_NULL_VALUE;
+        if (reg->live_in) {
+            Value value = bc_main_local_load(interpreter, program, reg->slot);
+            if (value.type != reg->entry_type ||
+                (reg->numeric_sync && program->num_locals[reg->slot] != value.data.number_value)) {
+                value_free(&value);
+                bc_loop_trace_early_exit(site);
+                return pc + 1;
+            }
+            word = nan_boxing_box(value);
+        }
+        words[count++] = word;
+    }
+    
+    LoopTraceStats* stats = loop_trace_stats();
+    stats->entries++;
+    Value exit = register_tier_execute_trace(trace->program, interpreter, program, words, count);
+    size_t exit_pc = exit.type == VALUE_NUMBER ? (size_t)exit.data.number_value : pc;
+    value_free(&exit);
+    
+    // Registers of locals the trace never reached still hold null
+    count = 0;
+    for (size_t r = 0; r < trace->register_count; r++) {
+        const LoopTraceRegister* reg = &trace->registers[r];
+        if (reg->kind != LOOP_TRACE_LOCAL) continue;
+        NanBoxedValue word = words[count++];
+        if (reg->written && word != NAN_BOX_NULL_VALUE) {
+            bc_main_local_store(interpreter, program, reg->slot, 0, nan_boxing_unbox(word));
+        } else {
+            nan_boxing_release(word);
+        }
+    }
+    
+    if (exit_pc == pc) {
+        bc_loop_trace_early_exit(site);
+        return pc + 1;
+    }
+    stats->side_exits++;
+    bc_loop_trace_extend(interpreter, program, site, exit_pc);
+    return exit_pc;
+#endif
+}
+
 // ============================================================================
 // Phase 4: Module Cache Helper Functions
 // ============================================================================
@@ -140,6 +140,21 @@ void environment_assign(Environment* env, const char* name, Value value) {
     }
 }
 
+Value* environment_resolve(Environment* env, const char* name, Environment** owner, size_t* index) {
+    if (!name) return NULL;
+    
+    for (Environment* scope = env; scope; scope = scope->parent) {
+        int found = environment_find_index(scope, name);
+        if (found >= 0) {
+            if (owner) *owner = scope;
+            if (index) *index = (size_t)found;
+            return &scope->values[found];
+        }
+    }
+    
+    return NULL;
+}
+
 int environment_exists(Environment* env, const char* name) {
     if (!env || !name) return 0;
     
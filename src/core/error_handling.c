@@ -871,7 +871,7 @@ Value safe_object_access(Value* object, const char* property, Interpreter* inter
     for (size_t i = 0; i < object->data.object_value.count; i++) {
         if (object->data.object_value.keys[i] && 
             strcmp(object->data.object_value.keys[i], property) == 0) {
-            return *((Value*)object->data.object_value.values[i]);
+            return object->data.object_value.values[i];
         }
     }
     
@@ -12,6 +12,7 @@
 // eval_engine.h removed - AST execution no longer used
 #include "optimization/hot_spot_tracker.h"
 #include "optimization/bytecode_engine.h"
+#include "optimization/micro_jit.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -101,21 +102,12 @@ Interpreter* interpreter_create(void) {
     interpreter->import_chain = NULL;
     
     // Async/await support initialization
-    interpreter->task_queue = NULL;
-    interpreter->task_queue_size = 0;
-    interpreter->task_queue_capacity = 0;
+    interpreter->scheduler = NULL;  // Created with the first async call
     interpreter->async_enabled = 1;  // Enable async by default
-    
-    // Concurrency support initialization
-    interpreter->worker_threads = NULL;
-    interpreter->worker_thread_count = 0;
-    interpreter->shutdown_workers = 0;
-    // Mutexes and condition variable will be initialized when concurrency is enabled
+    pthread_mutex_init(&interpreter->promise_registry_mutex, NULL);
     
     // Promise registry initialization
     interpreter->promise_registry = NULL;
-    interpreter->promise_registry_size = 0;
-    interpreter->promise_registry_capacity = 0;
     interpreter->next_promise_id = 1;  // Start at 1 (0 means no ID)
     
     // Capability-based security initialization
@@ -216,6 +208,9 @@ void interpreter_free(Interpreter* interpreter) {
             hot_spot_tracker_free(interpreter->hot_spot_tracker);
         }
         
+        // Clean up Micro-JIT context
+        micro_jit_cleanup_for_interpreter(interpreter);
+        
         // Clean up macro expander
         if (interpreter->macro_expander) {
             macro_expander_free(interpreter->macro_expander);
@@ -226,56 +221,8 @@ void interpreter_free(Interpreter* interpreter) {
         //     compile_time_evaluator_free(interpreter->compile_time_evaluator);
         // }
         
-        // Shutdown async concurrency system
-        // Note: async_shutdown_concurrency is static in bytecode_vm.c, so we clean up manually
-        if (interpreter->worker_thread_count > 0 && interpreter->worker_threads) {
-            // Signal shutdown
-            pthread_mutex_lock(&interpreter->task_queue_mutex);
-            interpreter->shutdown_workers = 1;
-            pthread_cond_broadcast(&interpreter->task_available);
-            pthread_mutex_unlock(&interpreter->task_queue_mutex);
-            
-            // Wait for all threads to finish
-            for (size_t i = 0; i < interpreter->worker_thread_count; i++) {
-                pthread_join(interpreter->worker_threads[i], NULL);
-            }
-            
-            // Cleanup
-            shared_free_safe(interpreter->worker_threads, "interpreter", "interpreter_free", 0);
-            interpreter->worker_threads = NULL;
-            interpreter->worker_thread_count = 0;
-            pthread_mutex_destroy(&interpreter->task_queue_mutex);
-            pthread_mutex_destroy(&interpreter->promise_registry_mutex);
-            pthread_cond_destroy(&interpreter->task_available);
-        }
-        
-        // Clean up async task queue
-        if (interpreter->task_queue) {
-            // Free any remaining tasks
-            for (size_t i = 0; i < interpreter->task_queue_size; i++) {
-                AsyncTask* task = interpreter->task_queue[i];
-                if (task) {
-                    if (task->args) {
-                        for (size_t j = 0; j < task->arg_count; j++) {
-                            value_free(&task->args[j]);
-                        }
-                        shared_free_safe(task->args, "interpreter", "interpreter_free", 0);
-                    }
-                    value_free(&task->promise_copy);
-                    value_free(&task->result);
-                    shared_free_safe(task, "interpreter", "interpreter_free", 0);
-                }
-            }
-            shared_free_safe(interpreter->task_queue, "interpreter", "interpreter_free", 0);
-        }
-        
-        // Clean up promise registry
-        if (interpreter->promise_registry) {
-            for (size_t i = 0; i < interpreter->promise_registry_size; i++) {
-                value_free(&interpreter->promise_registry[i]);
-            }
-            shared_free_safe(interpreter->promise_registry, "interpreter", "interpreter_free", 0);
-        }
+        // Stop async workers, free queued tasks and the promise registry
+        async_runtime_free(interpreter);
         
         // Clean up capability registry
         if (interpreter->capability_registry) {
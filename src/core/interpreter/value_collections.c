@@ -1,6 +1,8 @@
 #include "interpreter/value_operations.h"
 #include "../../include/core/interpreter.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/hidden_classes.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -10,15 +12,16 @@
 // ============================================================================
 
 Value value_create_array(size_t initial_capacity) { 
-    Value v; 
+    Value v = {0}; 
     v.type = VALUE_ARRAY; 
     v.data.array_value.elements = NULL; 
     v.data.array_value.count = 0; 
     v.data.array_value.capacity = initial_capacity; 
+    v.data.array_value.shared = value_shared_create();
     
     // Allocate memory if capacity is specified
     if (initial_capacity > 0) {
-        v.data.array_value.elements = (void**)shared_malloc_safe(initial_capacity * sizeof(void*), "interpreter", "value_create_array", 0);
+        v.data.array_value.elements = (void**)slab_alloc(initial_capacity * sizeof(void*));
         if (!v.data.array_value.elements) {
             v.data.array_value.capacity = 0;
         } else {
@@ -32,11 +35,12 @@ Value value_create_array(size_t initial_capacity) {
 
 void value_array_push(Value* array, Value element) {
     if (!array || array->type != VALUE_ARRAY) return;
+    value_make_unique(array);
     
     // Ensure array has valid elements pointer
     if (!array->data.array_value.elements || array->data.array_value.capacity == 0) {
         size_t new_capacity = 4;
-        array->data.array_value.elements = (void**)shared_malloc_safe(new_capacity * sizeof(void*), "interpreter", "unknown_function", 2849);
+        array->data.array_value.elements = (void**)slab_alloc(new_capacity * sizeof(void*));
         if (!array->data.array_value.elements) {
             return;
         }
@@ -47,7 +51,9 @@ void value_array_push(Value* array, Value element) {
     // Check if we need to resize
     if (array->data.array_value.count >= array->data.array_value.capacity) {
         size_t new_capacity = array->data.array_value.capacity * 2;
-        void** new_elements = shared_realloc_safe(array->data.array_value.elements, new_capacity * sizeof(void*), "interpreter", "unknown_function", 2850);
+        void** new_elements = slab_realloc(array->data.array_value.elements,
+                                           array->data.array_value.capacity * sizeof(void*),
+                                           new_capacity * sizeof(void*));
         if (!new_elements) {
             return;
         }
@@ -61,7 +67,7 @@ void value_array_push(Value* array, Value element) {
     }
     
     // Add the element
-    Value* stored_element = shared_malloc_safe(sizeof(Value), "interpreter", "unknown_function", 2860);
+    Value* stored_element = slab_alloc_value();
     if (stored_element) {
         Value cloned_element = value_clone(&element);
         *stored_element = cloned_element;
@@ -74,6 +80,7 @@ Value value_array_pop(Value* array, int index) {
     if (!array || array->type != VALUE_ARRAY || array->data.array_value.count == 0) {
         return value_create_null();
     }
+    value_make_unique(array);
     
     size_t array_len = array->data.array_value.count;
     size_t pop_index;
@@ -103,7 +110,7 @@ Value value_array_pop(Value* array, int index) {
     }
     
     // Free the last element (which was moved)
-    shared_free_safe(element, "interpreter", "value_array_pop", 2872);
+    slab_free(element);
     array->data.array_value.count--;
     
     return result;
@@ -123,6 +130,7 @@ Value value_array_get(Value* array, size_t index) {
 
 void value_array_set(Value* array, size_t index, Value element) {
     if (!array || array->type != VALUE_ARRAY || index >= array->data.array_value.count) return;
+    value_make_unique(array);
     
     Value* stored_element = (Value*)array->data.array_value.elements[index];
     if (stored_element) {
@@ -139,114 +147,86 @@ size_t value_array_length(Value* array) {
 // ============================================================================
 // OBJECT OPERATIONS
 // ============================================================================
+// Objects keep their property values in a dense slot array; the names live
+// in a shared ObjectShape (see optimization/hidden_classes.h), and keys
+// points at the shape's name table.
 
 Value value_create_object(size_t initial_capacity) {
     Value v = {0};
     v.type = VALUE_OBJECT;
     v.data.object_value.count = 0;
-    v.data.object_value.capacity = initial_capacity > 0 ? initial_capacity : 4;
+    v.data.object_value.capacity = initial_capacity;
+    v.data.object_value.shared = value_shared_create();
+    v.data.object_value.shape = object_shape_root();
+    v.data.object_value.keys = v.data.object_value.shape->names;
     
-    // Allocate memory with proper error handling using shared_malloc_safe for consistency
-    v.data.object_value.keys = shared_malloc_safe(v.data.object_value.capacity * sizeof(char*), "interpreter", "value_create_object", 401);
-    v.data.object_value.values = shared_malloc_safe(v.data.object_value.capacity * sizeof(void*), "interpreter", "value_create_object", 402);
-    
-    // If allocation fails, return a NULL value instead of a broken object
-    if (!v.data.object_value.keys || !v.data.object_value.values) {
-        if (v.data.object_value.keys) {
-            shared_free_safe(v.data.object_value.keys, "interpreter", "value_create_object", 407);
-        }
-        if (v.data.object_value.values) {
-            shared_free_safe(v.data.object_value.values, "interpreter", "value_create_object", 410);
+    if (initial_capacity > 0) {
+        v.data.object_value.values = slab_alloc(initial_capacity * sizeof(Value));
+        // If allocation fails, return a NULL value instead of a broken object
+        if (!v.data.object_value.values) {
+            shared_free_safe(v.data.object_value.shared, "interpreter", "value_create_object", 407);
+            return value_create_null();
         }
-        return value_create_null();  // Return NULL value instead of broken object
     }
     
-    // Initialize allocated memory to zero
-    memset(v.data.object_value.keys, 0, v.data.object_value.capacity * sizeof(char*));
-    memset(v.data.object_value.values, 0, v.data.object_value.capacity * sizeof(void*));
-    
     return v;
 }
 
-void value_object_set_member(Value* object, const char* member_name, Value member_value) {
-    if (!object || object->type != VALUE_OBJECT || !member_name) return;
-    
-    // Check if member already exists
-    for (size_t i = 0; i < object->data.object_value.count; i++) {
-        if (object->data.object_value.keys[i] && 
-            strcmp(object->data.object_value.keys[i], member_name) == 0) {
-            // Update existing member
-            Value* existing_value = (Value*)object->data.object_value.values[i];
-            if (existing_value) {
-                value_free(existing_value);
-                *existing_value = value_clone(&member_value);
-            }
+// Slot of key in obj, or -1
+static int object_slot(Value* obj, const char* key) {
+    return object_shape_find(obj->data.object_value.shape, key);
+}
+
+// Append a property that is not yet in obj's shape
+static void object_append(Value* obj, const char* key, Value* value) {
+    ObjectShape* next = object_shape_add_property(obj->data.object_value.shape, key);
+    if (!next) return;
+    
+    if (obj->data.object_value.count >= obj->data.object_value.capacity) {
+        size_t new_capacity = obj->data.object_value.capacity > 0 ? obj->data.object_value.capacity * 2 : 4;
+        Value* grown = slab_realloc(obj->data.object_value.values,
+                                     obj->data.object_value.capacity * sizeof(Value),
+                                     new_capacity * sizeof(Value));
+        if (!grown) {
+            // Resize failed - cannot add new member
             return;
         }
+        obj->data.object_value.values = grown;
+        obj->data.object_value.capacity = new_capacity;
     }
     
-    // Add new member if there's space
-    if (object->data.object_value.count < object->data.object_value.capacity) {
-        object->data.object_value.keys[object->data.object_value.count] = shared_strdup(member_name);
-        object->data.object_value.values[object->data.object_value.count] = shared_malloc_safe(sizeof(Value), "interpreter", "unknown_function", 420);
-        if (object->data.object_value.values[object->data.object_value.count]) {
-            Value* stored_value = (Value*)object->data.object_value.values[object->data.object_value.count];
-            *stored_value = value_clone(&member_value);
-            object->data.object_value.count++;
-        }
-    }
+    obj->data.object_value.values[obj->data.object_value.count] = value_clone(value);
+    obj->data.object_value.count++;
+    obj->data.object_value.shape = next;
+    obj->data.object_value.keys = next->names;
+}
+
+void value_object_set_member(Value* object, const char* member_name, Value member_value) {
+    value_object_set(object, member_name, member_value);
 }
 
 void value_object_set(Value* obj, const char* key, Value value) {
     if (!obj || obj->type != VALUE_OBJECT || !key) return;
+    value_make_unique(obj);
     
     // Check if key already exists - overwrite it
-    for (size_t i = 0; i < obj->data.object_value.count; i++) {
-        if (obj->data.object_value.keys[i] && 
-            strcmp(obj->data.object_value.keys[i], key) == 0) {
-            // Update existing member
-            Value* existing_value = (Value*)obj->data.object_value.values[i];
-            if (existing_value) {
-                value_free(existing_value);
-                *existing_value = value_clone(&value);
-            }
-            return;
-        }
-    }
-    
-    // Add new member - resize if needed
-    if (obj->data.object_value.count >= obj->data.object_value.capacity) {
-        // Resize the object to accommodate more keys
-        size_t new_capacity = obj->data.object_value.capacity * 2;
-        if (new_capacity < obj->data.object_value.capacity + 1) {
-            new_capacity = obj->data.object_value.capacity + 1; // Handle overflow
-        }
-        char** new_keys = shared_realloc_safe(obj->data.object_value.keys, new_capacity * sizeof(char*), "interpreter", "value_object_set", 0);
-        void** new_values = shared_realloc_safe(obj->data.object_value.values, new_capacity * sizeof(void*), "interpreter", "value_object_set", 1);
-        if (new_keys && new_values) {
-            obj->data.object_value.keys = new_keys;
-            obj->data.object_value.values = new_values;
-            obj->data.object_value.capacity = new_capacity;
-        } else {
-            // Resize failed - cannot add new member
-            return;
-        }
+    int slot = object_slot(obj, key);
+    if (slot >= 0) {
+        value_object_set_slot(obj, (size_t)slot, value);
+        return;
     }
     
-    // Add new member now that we have space
-    obj->data.object_value.keys[obj->data.object_value.count] = key ? shared_strdup(key) : NULL;
-    Value* new_value = shared_malloc_safe(sizeof(Value), "interpreter", "unknown_function", 2912);
-    if (new_value) {
-        *new_value = value_clone(&value);
-        obj->data.object_value.values[obj->data.object_value.count] = new_value;
-        obj->data.object_value.count++;
-    } else {
-        // If value allocation failed, free the key to prevent memory leak
-        if (obj->data.object_value.keys[obj->data.object_value.count]) {
-            shared_free_safe(obj->data.object_value.keys[obj->data.object_value.count], "interpreter", "value_object_set", 0);
-            obj->data.object_value.keys[obj->data.object_value.count] = NULL;
-        }
-    }
+    object_append(obj, key, &value);
+}
+
+void value_object_set_slot(Value* obj, size_t slot, Value value) {
+    if (!obj || obj->type != VALUE_OBJECT || slot >= obj->data.object_value.count) return;
+    value_make_unique(obj);
+    
+    Value* existing_value = &obj->data.object_value.values[slot];
+    Value replacement = value_clone(&value);
+    value_free(existing_value);
+    *existing_value = replacement;
 }
 
 Value value_object_get(Value* obj, const char* key) { 
@@ -254,14 +234,9 @@ Value value_object_get(Value* obj, const char* key) {
         return value_create_null();
     }
     
-    for (size_t i = 0; i < obj->data.object_value.count; i++) {
-        if (obj->data.object_value.keys[i] && 
-            strcmp(obj->data.object_value.keys[i], key) == 0) {
-            Value* member_value = (Value*)obj->data.object_value.values[i];
-            if (member_value) {
-                return value_clone(member_value);
-            }
-        }
+    int slot = object_slot(obj, key);
+    if (slot >= 0) {
+        return value_clone(&obj->data.object_value.values[slot]);
     }
     
     return value_create_null();
@@ -272,14 +247,7 @@ int value_object_has(Value* obj, const char* key) {
         return 0;
     }
     
-    for (size_t i = 0; i < obj->data.object_value.count; i++) {
-        if (obj->data.object_value.keys[i] && 
-            strcmp(obj->data.object_value.keys[i], key) == 0) {
-            return 1;
-        }
-    }
-    
-    return 0;
+    return object_slot(obj, key) >= 0;
 }
 
 void value_object_delete(Value* obj, const char* key) {
@@ -287,31 +255,25 @@ void value_object_delete(Value* obj, const char* key) {
         return;
     }
     
-    for (size_t i = 0; i < obj->data.object_value.count; i++) {
-        if (obj->data.object_value.keys[i] && 
-            strcmp(obj->data.object_value.keys[i], key) == 0) {
-            // Free the key
-            shared_free_safe(obj->data.object_value.keys[i], "interpreter", "unknown_function", 2920);
-            obj->data.object_value.keys[i] = NULL;
-            
-            // Free the value
-            Value* value = (Value*)obj->data.object_value.values[i];
-            if (value) {
-                value_free(value);
-                shared_free_safe(value, "interpreter", "unknown_function", 2927);
-                obj->data.object_value.values[i] = NULL;
-            }
-            
-            // Shift remaining elements
-            for (size_t j = i; j < obj->data.object_value.count - 1; j++) {
-                obj->data.object_value.keys[j] = obj->data.object_value.keys[j + 1];
-                obj->data.object_value.values[j] = obj->data.object_value.values[j + 1];
-            }
-            
-            obj->data.object_value.count--;
-            break;
-        }
+    int slot = object_slot(obj, key);
+    if (slot < 0) {
+        return;
     }
+    ObjectShape* next = object_shape_remove_property(obj->data.object_value.shape, (size_t)slot);
+    if (!next) {
+        return;
+    }
+    value_make_unique(obj);
+    
+    // Free the value and shift remaining slots down
+    value_free(&obj->data.object_value.values[slot]);
+    for (size_t j = (size_t)slot; j + 1 < obj->data.object_value.count; j++) {
+        obj->data.object_value.values[j] = obj->data.object_value.values[j + 1];
+    }
+    
+    obj->data.object_value.count--;
+    obj->data.object_value.shape = next;
+    obj->data.object_value.keys = next->names;
 }
 
 size_t value_object_size(Value* obj) {
@@ -337,25 +299,132 @@ char** value_object_keys(Value* obj, size_t* count) {
     }
     
     for (size_t i = 0; i < *count; i++) {
-        if (obj->data.object_value.keys[i]) {
-            keys[i] = obj->data.object_value.keys[i] ? shared_strdup(obj->data.object_value.keys[i]) : NULL;
-            if (!keys[i]) {
-                // Clean up on failure
-                for (size_t j = 0; j < i; j++) {
-                    shared_free_safe(keys[j], "interpreter", "unknown_function", 3004);
-                }
-                shared_free_safe(keys, "interpreter", "unknown_function", 3006);
-                *count = 0;
-                return NULL;
+        keys[i] = shared_strdup(obj->data.object_value.keys[i]);
+        if (!keys[i]) {
+            // Clean up on failure
+            for (size_t j = 0; j < i; j++) {
+                shared_free_safe(keys[j], "interpreter", "unknown_function", 3004);
             }
-        } else {
-            keys[i] = NULL;
+            shared_free_safe(keys, "interpreter", "unknown_function", 3006);
+            *count = 0;
+            return NULL;
         }
     }
     
     return keys;
 }
 
+// ============================================================================
+// HASH INDEX (shared by maps and sets)
+// ============================================================================
+
+// Entries live in a dense array in insertion order, which is what iteration
+// and keys() walk. The index is an open-addressing table (linear probing)
+// over that array, keyed by value_hash(), so lookups no longer scan.
+
+typedef struct {
+    void** keys;
+    size_t count;
+    uint32_t** index;
+    size_t* index_capacity;
+} HashIndexView;
+
+static int hash_index_view(Value* collection, HashIndexView* view) {
+    if (collection->type == VALUE_HASH_MAP) {
+        view->keys = collection->data.hash_map_value.keys;
+        view->count = collection->data.hash_map_value.count;
+        view->index = &collection->data.hash_map_value.index;
+        view->index_capacity = &collection->data.hash_map_value.index_capacity;
+        return 1;
+    }
+    if (collection->type == VALUE_SET) {
+        view->keys = collection->data.set_value.elements;
+        view->count = collection->data.set_value.count;
+        view->index = &collection->data.set_value.index;
+        view->index_capacity = &collection->data.set_value.index_capacity;
+        return 1;
+    }
+    return 0;
+}
+
+static void hash_index_insert(uint32_t* index, size_t capacity, size_t hash, size_t position) {
+    size_t mask = capacity - 1;
+    size_t slot = hash & mask;
+    while (index[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    index[slot] = (uint32_t)(position + 1);
+}
+
+void value_hash_index_rebuild(Value* collection) {
+    HashIndexView view;
+    if (!collection || !hash_index_view(collection, &view)) return;
+    
+    // Keep the load factor at or below 1/2
+    size_t capacity = 8;
+    while (capacity < view.count * 2) {
+        capacity <<= 1;
+    }
+    
+    if (!*view.index || *view.index_capacity != capacity) {
+        slab_free(*view.index);
+        *view.index = slab_alloc(capacity * sizeof(uint32_t));
+        *view.index_capacity = *view.index ? capacity : 0;
+        if (!*view.index) return;
+    }
+    memset(*view.index, 0, capacity * sizeof(uint32_t));
+    
+    for (size_t i = 0; i < view.count; i++) {
+        Value* key = (Value*)view.keys[i];
+        if (key) {
+            hash_index_insert(*view.index, capacity, value_hash(key), i);
+        }
+    }
+}
+
+// Position of key in the entry array, or -1 if absent
+static long hash_index_find(Value* collection, Value* key) {
+    HashIndexView view;
+    if (!hash_index_view(collection, &view) || !view.keys) return -1;
+    
+    if (!*view.index) {
+        // No index yet (e.g. allocation failed) - fall back to a scan
+        for (size_t i = 0; i < view.count; i++) {
+            Value* existing = (Value*)view.keys[i];
+            if (existing && value_equals(existing, key)) return (long)i;
+        }
+        return -1;
+    }
+    
+    size_t hash = value_hash(key);
+    size_t mask = *view.index_capacity - 1;
+    size_t slot = hash & mask;
+    uint32_t entry;
+    while ((entry = (*view.index)[slot]) != 0) {
+        Value* existing = (Value*)view.keys[entry - 1];
+        if (existing && value_hash(existing) == hash && value_equals(existing, key)) {
+            return (long)(entry - 1);
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// Index the entry just appended at position count - 1
+static void hash_index_append(Value* collection) {
+    HashIndexView view;
+    if (!hash_index_view(collection, &view) || view.count == 0) return;
+    
+    if (!*view.index || view.count * 2 > *view.index_capacity) {
+        value_hash_index_rebuild(collection);
+        return;
+    }
+    Value* key = (Value*)view.keys[view.count - 1];
+    if (key) {
+        hash_index_insert(*view.index, *view.index_capacity, value_hash(key), view.count - 1);
+    }
+}
+
 // ============================================================================
 // HASH MAP OPERATIONS
 // ============================================================================
@@ -367,8 +436,9 @@ Value value_create_hash_map(size_t initial_capacity) {
     v.ref_count = 1;
     v.data.hash_map_value.count = 0;
     v.data.hash_map_value.capacity = initial_capacity > 0 ? initial_capacity : 8;
-    v.data.hash_map_value.keys = shared_malloc_safe(v.data.hash_map_value.capacity * sizeof(void*), "interpreter", "value_create_hash_map", 0);
-    v.data.hash_map_value.values = shared_malloc_safe(v.data.hash_map_value.capacity * sizeof(void*), "interpreter", "value_create_hash_map", 1);
+    v.data.hash_map_value.shared = value_shared_create();
+    v.data.hash_map_value.keys = slab_alloc(v.data.hash_map_value.capacity * sizeof(void*));
+    v.data.hash_map_value.values = slab_alloc(v.data.hash_map_value.capacity * sizeof(void*));
     
     // Initialize to NULL
     if (v.data.hash_map_value.keys) {
@@ -388,6 +458,7 @@ Value value_create_hash_map(size_t initial_capacity) {
 
 void value_hash_map_set(Value* map, Value key, Value value) {
     if (!map || map->type != VALUE_HASH_MAP) return;
+    value_make_unique(map);
     
     // Debug: log function values being stored
     if (value.type == VALUE_FUNCTION) {
@@ -404,61 +475,61 @@ void value_hash_map_set(Value* map, Value key, Value value) {
     }
     
     // Check if key already exists
-    for (size_t i = 0; i < map->data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map->data.hash_map_value.keys[i];
-        if (existing_key && value_equals(existing_key, &key)) {
-            // Update existing value
-            Value* existing_value = (Value*)map->data.hash_map_value.values[i];
-            if (existing_value) {
-                value_free(existing_value);
-                shared_free_safe(existing_value, "interpreter", "value_hash_map_set", 0);
-                map->data.hash_map_value.values[i] = shared_malloc_safe(sizeof(Value), "interpreter", "value_hash_map_set", 1);
-                Value cloned = value_clone(&value);
-                // Debug: verify cloned function ID
-                if (value.type == VALUE_FUNCTION && cloned.type == VALUE_FUNCTION) {
-                    ASTNode* orig_body = (ASTNode*)value.data.function_value.body;
-                    ASTNode* cloned_body = (ASTNode*)cloned.data.function_value.body;
-                    uintptr_t orig_addr = (uintptr_t)orig_body;
-                    uintptr_t cloned_addr = (uintptr_t)cloned_body;
-                    if (orig_addr < 10000 && cloned_addr < 10000) {
-                        int orig_id = (int)orig_addr;
-                        int cloned_id = (int)cloned_addr;
-                        if (orig_id != cloned_id) {
-                            fprintf(stderr, "[HASHMAP_SET] WARNING: Function ID mismatch! Original func_id=%d, Cloned func_id=%d\n", 
-                                    orig_id, cloned_id);
-                        }
+    long found = hash_index_find(map, &key);
+    if (found >= 0) {
+        size_t i = (size_t)found;
+        // Update existing value
+        Value* existing_value = (Value*)map->data.hash_map_value.values[i];
+        if (existing_value) {
+            // Reuse the cell for the new value
+            value_free(existing_value);
+            Value cloned = value_clone(&value);
+            // Debug: verify cloned function ID
+            if (value.type == VALUE_FUNCTION && cloned.type == VALUE_FUNCTION) {
+                ASTNode* orig_body = (ASTNode*)value.data.function_value.body;
+                ASTNode* cloned_body = (ASTNode*)cloned.data.function_value.body;
+                uintptr_t orig_addr = (uintptr_t)orig_body;
+                uintptr_t cloned_addr = (uintptr_t)cloned_body;
+                if (orig_addr < 10000 && cloned_addr < 10000) {
+                    int orig_id = (int)orig_addr;
+                    int cloned_id = (int)cloned_addr;
+                    if (orig_id != cloned_id) {
+                        fprintf(stderr, "[HASHMAP_SET] WARNING: Function ID mismatch! Original func_id=%d, Cloned func_id=%d\n", 
+                                orig_id, cloned_id);
                     }
                 }
-                *(Value*)map->data.hash_map_value.values[i] = cloned;
             }
-            return;
+            *(Value*)map->data.hash_map_value.values[i] = cloned;
         }
+        return;
     }
     
     // Add new key-value pair
     if (map->data.hash_map_value.count >= map->data.hash_map_value.capacity) {
         // Resize
         size_t new_capacity = map->data.hash_map_value.capacity * 2;
-        void** new_keys = shared_realloc_safe(map->data.hash_map_value.keys, new_capacity * sizeof(void*), "interpreter", "unknown_function", 3051);
-        void** new_values = shared_realloc_safe(map->data.hash_map_value.values, new_capacity * sizeof(void*), "interpreter", "unknown_function", 3052);
-        if (!new_keys || !new_values) return;
-        
+        size_t old_bytes = map->data.hash_map_value.capacity * sizeof(void*);
+        void** new_keys = slab_realloc(map->data.hash_map_value.keys, old_bytes, new_capacity * sizeof(void*));
+        if (!new_keys) return;
         map->data.hash_map_value.keys = new_keys;
+        void** new_values = slab_realloc(map->data.hash_map_value.values, old_bytes, new_capacity * sizeof(void*));
+        if (!new_values) return;
+        
         map->data.hash_map_value.values = new_values;
         map->data.hash_map_value.capacity = new_capacity;
     }
     
     // Add new entry
-    Value* new_key = shared_malloc_safe(sizeof(Value), "interpreter", "unknown_function", 3061);
+    Value* new_key = slab_alloc_value();
     if (!new_key) return;  // Safety check
     *new_key = value_clone(&key);
     map->data.hash_map_value.keys[map->data.hash_map_value.count] = new_key;
     
-    Value* new_value = shared_malloc_safe(sizeof(Value), "interpreter", "unknown_function", 3063);
+    Value* new_value = slab_alloc_value();
     if (!new_value) {
         // Clean up the key we just allocated
         value_free(new_key);
-        shared_free_safe(new_key, "interpreter", "value_hash_map_set", 0);
+        slab_free(new_key);
         return;
     }
     Value cloned = value_clone(&value);
@@ -480,6 +551,7 @@ void value_hash_map_set(Value* map, Value key, Value value) {
     *new_value = cloned;
     map->data.hash_map_value.values[map->data.hash_map_value.count] = new_value;
     map->data.hash_map_value.count++;
+    hash_index_append(map);
 }
 
 Value value_hash_map_get(Value* map, Value key) {
@@ -487,71 +559,52 @@ Value value_hash_map_get(Value* map, Value key) {
         return value_create_null();
     }
     
-    for (size_t i = 0; i < map->data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map->data.hash_map_value.keys[i];
-        if (existing_key) {
-            // Compare keys - check both string comparison and value_equals
-            int keys_match = 0;
-            if (existing_key->type == VALUE_STRING && key.type == VALUE_STRING) {
-                int cmp = strcmp(existing_key->data.string_value, key.data.string_value);
-                keys_match = (cmp == 0);
-            }
-            if (!keys_match) {
-                keys_match = value_equals(existing_key, &key);
-            }
-            
-            if (keys_match) {
-                Value* value = (Value*)map->data.hash_map_value.values[i];
-                return value ? value_clone(value) : value_create_null();
-            }
-        }
+    long found = hash_index_find(map, &key);
+    if (found < 0) {
+        return value_create_null();
     }
-    
-    return value_create_null();
+    Value* value = (Value*)map->data.hash_map_value.values[found];
+    return value ? value_clone(value) : value_create_null();
 }
 
 int value_hash_map_has(Value* map, Value key) {
     if (!map || map->type != VALUE_HASH_MAP) return 0;
-    
-    for (size_t i = 0; i < map->data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map->data.hash_map_value.keys[i];
-        if (existing_key && value_equals(existing_key, &key)) {
-            return 1;
-        }
-    }
-    
-    return 0;
+    return hash_index_find(map, &key) >= 0;
 }
 
 void value_hash_map_delete(Value* map, Value key) {
     if (!map || map->type != VALUE_HASH_MAP) return;
+    if (hash_index_find(map, &key) < 0) return;
+    value_make_unique(map);
     
-    for (size_t i = 0; i < map->data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map->data.hash_map_value.keys[i];
-        if (existing_key && value_equals(existing_key, &key)) {
-            // Free the key
-            value_free(existing_key);
-            shared_free_safe(existing_key, "interpreter", "unknown_function", 3106);
-            map->data.hash_map_value.keys[i] = NULL;
-            
-            // Free the value
-            Value* value = (Value*)map->data.hash_map_value.values[i];
-            if (value) {
-                value_free(value);
-                shared_free_safe(value, "interpreter", "unknown_function", 3113);
-                map->data.hash_map_value.values[i] = NULL;
-            }
-            
-            // Shift remaining elements
-            for (size_t j = i; j < map->data.hash_map_value.count - 1; j++) {
-                map->data.hash_map_value.keys[j] = map->data.hash_map_value.keys[j + 1];
-                map->data.hash_map_value.values[j] = map->data.hash_map_value.values[j + 1];
-            }
-            
-            map->data.hash_map_value.count--;
-            break;
-        }
+    long found = hash_index_find(map, &key);
+    if (found < 0) return;
+    size_t i = (size_t)found;
+    
+    // Free the key
+    Value* existing_key = (Value*)map->data.hash_map_value.keys[i];
+    if (existing_key) {
+        value_free(existing_key);
+        slab_free(existing_key);
+        map->data.hash_map_value.keys[i] = NULL;
+    }
+    
+    // Free the value
+    Value* value = (Value*)map->data.hash_map_value.values[i];
+    if (value) {
+        value_free(value);
+        slab_free(value);
+        map->data.hash_map_value.values[i] = NULL;
+    }
+    
+    // Shift remaining elements to keep insertion order, then reindex
+    for (size_t j = i; j < map->data.hash_map_value.count - 1; j++) {
+        map->data.hash_map_value.keys[j] = map->data.hash_map_value.keys[j + 1];
+        map->data.hash_map_value.values[j] = map->data.hash_map_value.values[j + 1];
     }
+    
+    map->data.hash_map_value.count--;
+    value_hash_index_rebuild(map);
 }
 
 Value* value_hash_map_keys(Value* map, size_t* count) {
@@ -599,11 +652,12 @@ size_t value_hash_map_size(Value* map) {
 // ============================================================================
 
 Value value_create_set(size_t initial_capacity) {
-    Value v;
+    Value v = {0};
     v.type = VALUE_SET;
     v.data.set_value.count = 0;
     v.data.set_value.capacity = initial_capacity > 0 ? initial_capacity : 8;
-    v.data.set_value.elements = shared_malloc_safe(v.data.set_value.capacity * sizeof(void*), "interpreter", "value_create_set", 0);
+    v.data.set_value.shared = value_shared_create();
+    v.data.set_value.elements = slab_alloc(v.data.set_value.capacity * sizeof(void*));
     
     // Initialize to NULL
     if (v.data.set_value.elements) {
@@ -617,17 +671,18 @@ void value_set_add(Value* set, Value element) {
     if (!set || set->type != VALUE_SET) return;
     
     // Check if element already exists
-    for (size_t i = 0; i < set->data.set_value.count; i++) {
-        Value* existing = (Value*)set->data.set_value.elements[i];
-        if (existing && value_equals(existing, &element)) {
-            return; // Element already exists
-        }
+    if (hash_index_find(set, &element) >= 0) {
+        return;
     }
     
+    value_make_unique(set);
+    
     // Resize if needed
     if (set->data.set_value.count >= set->data.set_value.capacity) {
         size_t new_capacity = set->data.set_value.capacity > 0 ? set->data.set_value.capacity * 2 : 8;
-        void** new_elements = shared_realloc_safe(set->data.set_value.elements, new_capacity * sizeof(void*), "interpreter", "value_set_add", 0);
+        void** new_elements = slab_realloc(set->data.set_value.elements,
+                                           set->data.set_value.capacity * sizeof(void*),
+                                           new_capacity * sizeof(void*));
         if (!new_elements) return;
         
         set->data.set_value.elements = new_elements;
@@ -635,49 +690,44 @@ void value_set_add(Value* set, Value element) {
     }
     
     // Add new element
-    Value* new_element = shared_malloc_safe(sizeof(Value), "interpreter", "unknown_function", 3186);
+    Value* new_element = slab_alloc_value();
     if (new_element) {
         *new_element = value_clone(&element);
         set->data.set_value.elements[set->data.set_value.count] = new_element;
         set->data.set_value.count++;
+        hash_index_append(set);
     }
 }
 
 int value_set_has(Value* set, Value element) {
     if (!set || set->type != VALUE_SET) return 0;
-    
-    for (size_t i = 0; i < set->data.set_value.count; i++) {
-        Value* existing = (Value*)set->data.set_value.elements[i];
-        if (existing && value_equals(existing, &element)) {
-            return 1;
-        }
-    }
-    
-    return 0;
+    return hash_index_find(set, &element) >= 0;
 }
 
 void value_set_remove(Value* set, Value element) {
-    if (!set || set->type != VALUE_SET) return;
+    if (!set || set->type != VALUE_SET || !value_set_has(set, element)) return;
+    value_make_unique(set);
     
-    for (size_t i = 0; i < set->data.set_value.count; i++) {
-        Value* existing = (Value*)set->data.set_value.elements[i];
-        if (existing && value_equals(existing, &element)) {
-            // Free the element
-            value_free(existing);
-            shared_free_safe(existing, "interpreter", "unknown_function", 3214);
-            set->data.set_value.elements[i] = NULL;
-            
-            // Shift remaining elements
-            for (size_t j = i; j < set->data.set_value.count - 1; j++) {
-                set->data.set_value.elements[j] = set->data.set_value.elements[j + 1];
-            }
-            
-            // Clear the last element after shift
-            set->data.set_value.elements[set->data.set_value.count - 1] = NULL;
-            set->data.set_value.count--;
-            break;
-        }
+    long found = hash_index_find(set, &element);
+    if (found < 0) return;
+    size_t i = (size_t)found;
+    
+    // Free the element
+    Value* existing = (Value*)set->data.set_value.elements[i];
+    if (existing) {
+        value_free(existing);
+        slab_free(existing);
+    }
+    
+    // Shift remaining elements to keep insertion order, then reindex
+    for (size_t j = i; j < set->data.set_value.count - 1; j++) {
+        set->data.set_value.elements[j] = set->data.set_value.elements[j + 1];
     }
+    
+    // Clear the last element after shift
+    set->data.set_value.elements[set->data.set_value.count - 1] = NULL;
+    set->data.set_value.count--;
+    value_hash_index_rebuild(set);
 }
 
 size_t value_set_size(Value* set) {
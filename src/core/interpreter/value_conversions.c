@@ -1,6 +1,7 @@
 #include "interpreter/value_operations.h"
 #include "../../include/core/interpreter.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -483,6 +484,181 @@ int value_equals(Value* a, Value* b) {
     }
 }
 
+// 64-bit finalizer (MurmurHash3 fmix64) to spread numeric bit patterns
+static size_t value_hash_mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+static size_t value_hash_number(double number) {
+    if (number == 0.0) number = 0.0;  // -0.0 == 0.0 under value_equals
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    return value_hash_mix(bits);
+}
+
+size_t value_hash(Value* value) {
+    if (!value) return 0;
+    
+    switch (value->type) {
+        case VALUE_NULL:
+            return 0x9e3779b97f4a7c15ULL;
+        case VALUE_BOOLEAN:
+            return value->data.boolean_value ? 0x2545f4914f6cdd1dULL : 0x4f1bbcdcbfa53e0bULL;
+        case VALUE_NUMBER:
+            return value_hash_number(value->data.number_value);
+        case VALUE_STRING: {
+            if (value->flags & VALUE_FLAG_HASHED) {
+                return value->cache.cached_hash;
+            }
+            // FNV-1a; cached on the value so stored keys are hashed only once
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            const unsigned char* p = (const unsigned char*)value->data.string_value;
+            if (p) {
+                while (*p) {
+                    hash ^= *p++;
+                    hash *= 0x100000001b3ULL;
+                }
+            }
+            value->cache.cached_hash = (size_t)hash;
+            value->flags |= VALUE_FLAG_HASHED;
+            return (size_t)hash;
+        }
+        case VALUE_RANGE:
+            return value_hash_number(value->data.range_value.start) * 31 +
+                   value_hash_number(value->data.range_value.end);
+        default:
+            // value_equals never matches other types, so any spread will do
+            return value_hash_mix((uint64_t)value->type);
+    }
+}
+
+// ============================================================================
+// COPY-ON-WRITE CONTAINER STORAGE
+// ============================================================================
+
+static ValueShared** value_shared_slot(Value* value) {
+    switch (value->type) {
+        case VALUE_ARRAY: return &value->data.array_value.shared;
+        case VALUE_OBJECT: return &value->data.object_value.shared;
+        case VALUE_HASH_MAP: return &value->data.hash_map_value.shared;
+        case VALUE_SET: return &value->data.set_value.shared;
+        default: return NULL;
+    }
+}
+
+ValueShared* value_shared_create(void) {
+    ValueShared* shared = shared_malloc_safe(sizeof(ValueShared), "interpreter", "value_shared_create", 0);
+    if (shared) {
+        shared->ref_count = 1;
+    }
+    return shared;
+}
+
+int value_is_shared(Value* value) {
+    if (!value) return 0;
+    ValueShared** slot = value_shared_slot(value);
+    return slot && *slot && (*slot)->ref_count > 1;
+}
+
+// Clone each cell of a pointer array into freshly allocated cells
+static void** value_copy_cells(void** cells, size_t count, size_t capacity) {
+    void** copy = slab_alloc(capacity * sizeof(void*));
+    if (!copy) return NULL;
+    memset(copy, 0, capacity * sizeof(void*));
+    for (size_t i = 0; i < count; i++) {
+        Value* cell = (Value*)cells[i];
+        if (!cell) continue;
+        Value* stored = slab_alloc_value();
+        if (stored) {
+            *stored = value_clone(cell);
+            copy[i] = stored;
+        }
+    }
+    return copy;
+}
+
+// Copy a container's storage one level deep. Nested containers are cloned
+// with value_clone, so they stay shared until they are written themselves.
+static Value value_copy_storage(Value* value) {
+    Value v = {0};
+    v.type = value->type;
+    switch (value->type) {
+        case VALUE_ARRAY: {
+            size_t count = value->data.array_value.count;
+            size_t capacity = count > 0 ? count : 4;
+            v.data.array_value.elements = value_copy_cells(value->data.array_value.elements, count, capacity);
+            v.data.array_value.count = v.data.array_value.elements ? count : 0;
+            v.data.array_value.capacity = v.data.array_value.elements ? capacity : 0;
+            v.data.array_value.shared = value_shared_create();
+            return v;
+        }
+        case VALUE_OBJECT: {
+            // The copy keeps the shape, so only the slots need cloning
+            size_t count = value->data.object_value.count;
+            size_t capacity = count > 0 ? count : 4;
+            Value* values = slab_alloc(capacity * sizeof(Value));
+            if (!values) {
+                return value_create_null();
+            }
+            for (size_t i = 0; i < count; i++) {
+                values[i] = value_clone(&value->data.object_value.values[i]);
+            }
+            v.data.object_value.keys = value->data.object_value.keys;
+            v.data.object_value.values = values;
+            v.data.object_value.count = count;
+            v.data.object_value.capacity = capacity;
+            v.data.object_value.shape = value->data.object_value.shape;
+            v.data.object_value.shared = value_shared_create();
+            return v;
+        }
+        case VALUE_HASH_MAP: {
+            size_t count = value->data.hash_map_value.count;
+            size_t capacity = count > 0 ? count : 8;
+            void** keys = value_copy_cells(value->data.hash_map_value.keys, count, capacity);
+            void** values = value_copy_cells(value->data.hash_map_value.values, count, capacity);
+            if (!keys || !values) {
+                return value_create_null();
+            }
+            v.ref_count = 1;
+            v.data.hash_map_value.keys = keys;
+            v.data.hash_map_value.values = values;
+            v.data.hash_map_value.count = count;
+            v.data.hash_map_value.capacity = capacity;
+            v.data.hash_map_value.shared = value_shared_create();
+            value_hash_index_rebuild(&v);
+            return v;
+        }
+        case VALUE_SET: {
+            size_t count = value->data.set_value.count;
+            size_t capacity = value->data.set_value.capacity > count ? value->data.set_value.capacity : (count > 0 ? count : 8);
+            v.data.set_value.elements = value_copy_cells(value->data.set_value.elements, count, capacity);
+            v.data.set_value.count = v.data.set_value.elements ? count : 0;
+            v.data.set_value.capacity = v.data.set_value.elements ? capacity : 0;
+            v.data.set_value.shared = value_shared_create();
+            value_hash_index_rebuild(&v);
+            return v;
+        }
+        default:
+            return value_create_null();
+    }
+}
+
+void value_make_unique(Value* value) {
+    if (!value) return;
+    ValueShared** slot = value_shared_slot(value);
+    if (!slot || !*slot || (*slot)->ref_count <= 1) return;
+    
+    Value copy = value_copy_storage(value);
+    (*slot)->ref_count--;
+    copy.flags = value->flags;
+    *value = copy;
+}
+
 Value value_clone(Value* value) { 
     if (!value) { Value v = {0}; return v; } 
     switch (value->type) { 
@@ -500,70 +676,28 @@ Value value_clone(Value* value) {
                 v.data.string_value = value->data.string_value;  // Reuse pointer for immutable strings
                 v.cache.cached_length = value->cache.cached_length;
                 v.cache.cached_ptr = NULL;
+                if (value->flags & VALUE_FLAG_HASHED) {
+                    v.flags |= VALUE_FLAG_HASHED;
+                    v.cache.cached_hash = value->cache.cached_hash;
+                }
                 return v;
             } else {
                 return value_create_string("");
             }
         } 
         case VALUE_RANGE: return value_create_range(value->data.range_value.start, value->data.range_value.end, value->data.range_value.step, value->data.range_value.inclusive); 
-        case VALUE_ARRAY: {
-            size_t element_count = value->data.array_value.count;
-            size_t source_capacity = value->data.array_value.capacity;
-            size_t new_capacity = element_count > 0 ? element_count : (source_capacity > 0 ? source_capacity : 4);
-            if (new_capacity < element_count) {
-                new_capacity = element_count;
-            }
-            Value v = value_create_array(new_capacity);
-            v.data.array_value.count = element_count;
-            
-            if (value->data.array_value.elements && element_count > 0) {
-            for (size_t i = 0; i < element_count; i++) {
-                Value* element = (Value*)value->data.array_value.elements[i];
-                if (element) {
-                    Value cloned_element = value_clone(element);
-                        if (i < v.data.array_value.capacity) {
-                        Value* stored_element = shared_malloc_safe(sizeof(Value), "interpreter", "value_clone", 0);
-                        if (stored_element) {
-                            *stored_element = cloned_element;
-                                v.data.array_value.elements[i] = stored_element;
-                            } else {
-                                value_free(&cloned_element);
-                            }
-                        } else {
-                            value_free(&cloned_element);
-                        }
-                    }
-                }
-            }
-            v.data.array_value.count = element_count;
-            return v;
-        }
-        case VALUE_OBJECT: {
-            // Deep copy object with all members
-            // Check if object creation succeeds - if it returns NULL, there's a memory issue
-            Value v = value_create_object(value->data.object_value.count > 0 ? value->data.object_value.count : 4);
-            if (v.type == VALUE_NULL) {
-                // Object creation failed - return NULL to indicate error
-                return value_create_null();
-            }
-            for (size_t i = 0; i < value->data.object_value.count; i++) {
-                const char* key = value->data.object_value.keys[i];
-                Value* member_value = (Value*)value->data.object_value.values[i];
-                if (key && member_value) {
-                    Value cloned_member = value_clone(member_value);
-                    // Store the member directly to avoid memory sharing issues
-                    if (v.data.object_value.count < v.data.object_value.capacity) {
-                        v.data.object_value.keys[v.data.object_value.count] = shared_strdup(key);
-                        v.data.object_value.values[v.data.object_value.count] = shared_malloc_safe(sizeof(Value), "interpreter", "value_clone", 0);
-                        if (v.data.object_value.values[v.data.object_value.count]) {
-                            Value* stored_value = (Value*)v.data.object_value.values[v.data.object_value.count];
-                            *stored_value = cloned_member;
-                            v.data.object_value.count++;
-                        }
-                    }
-                }
-            }
-            return v;
+        case VALUE_ARRAY:
+        case VALUE_OBJECT:
+        case VALUE_HASH_MAP:
+        case VALUE_SET: {
+            // Containers share storage copy-on-write; the deep copy is deferred
+            // until one of the holders mutates it (value_make_unique)
+            ValueShared* shared = *value_shared_slot(value);
+            if (shared) {
+                shared->ref_count++;
+                return *value;
+            }
+            return value_copy_storage(value);
         }
         case VALUE_FUNCTION: {
             // Check if this is a built-in function
@@ -636,33 +770,6 @@ Value value_clone(Value* value) {
             );
             return v;
         }
-        case VALUE_HASH_MAP: {
-            // Deep copy hash map with all key-value pairs
-            Value v = value_create_hash_map(value->data.hash_map_value.count);
-            for (size_t i = 0; i < value->data.hash_map_value.count; i++) {
-                Value* key = (Value*)value->data.hash_map_value.keys[i];
-                Value* map_value = (Value*)value->data.hash_map_value.values[i];
-                if (key && map_value) {
-                    Value cloned_key = value_clone(key);
-                    Value cloned_value = value_clone(map_value);
-                    value_hash_map_set(&v, cloned_key, cloned_value);
-                }
-            }
-            return v;
-        }
-        case VALUE_SET: {
-            // Deep copy set with all elements
-            // Use the original capacity, not count, to preserve space for new elements
-            Value v = value_create_set(value->data.set_value.capacity);
-            for (size_t i = 0; i < value->data.set_value.count; i++) {
-                Value* element = (Value*)value->data.set_value.elements[i];
-                if (element) {
-                    Value cloned_element = value_clone(element);
-                    value_set_add(&v, cloned_element);
-                }
-            }
-            return v;
-        }
         default: return value_create_null(); 
     } 
 }
@@ -670,6 +777,20 @@ Value value_clone(Value* value) {
 void value_free(Value* value) { 
     if (!value) return; 
     
+    // Shared container storage is only torn down by its last holder
+    ValueShared** shared_slot = value_shared_slot(value);
+    if (shared_slot && *shared_slot) {
+        ValueShared* shared = *shared_slot;
+        if (shared->ref_count > 1) {
+            shared->ref_count--;
+            value->type = VALUE_NULL;
+            memset(&value->data, 0, sizeof(value->data));
+            return;
+        }
+        shared_free_safe(shared, "interpreter", "value_free", 0);
+        *shared_slot = NULL;
+    }
+    
     switch (value->type) {
         case VALUE_STRING:
             if (value->data.string_value) {
@@ -683,30 +804,25 @@ void value_free(Value* value) {
                     Value* element = (Value*)value->data.array_value.elements[i];
                     if (element) {
                         value_free(element);
-                        shared_free_safe(element, "interpreter", "value_free", 0);
                     }
                 }
-                shared_free_safe(value->data.array_value.elements, "interpreter", "value_free", 0);
+                // Cells and backing array go back to the slab together
+                slab_free_all(value->data.array_value.elements, value->data.array_value.count);
+                slab_free(value->data.array_value.elements);
                 value->data.array_value.elements = NULL;
             }
             break;
         case VALUE_OBJECT:
-            if (value->data.object_value.keys) {
+            // Key names belong to the shape; only the slots are owned here
+            if (value->data.object_value.values) {
                 for (size_t i = 0; i < value->data.object_value.count; i++) {
-                    if (value->data.object_value.keys[i]) {
-                        shared_free_safe(value->data.object_value.keys[i], "interpreter", "value_free", 0);
-                    }
-                    Value* member_value = (Value*)value->data.object_value.values[i];
-                    if (member_value) {
-                        value_free(member_value);
-                        shared_free_safe(member_value, "interpreter", "value_free", 0);
-                    }
+                    value_free(&value->data.object_value.values[i]);
                 }
-                shared_free_safe(value->data.object_value.keys, "interpreter", "value_free", 0);
-                shared_free_safe(value->data.object_value.values, "interpreter", "value_free", 0);
-                value->data.object_value.keys = NULL;
+                slab_free(value->data.object_value.values);
                 value->data.object_value.values = NULL;
             }
+            value->data.object_value.keys = NULL;
+            value->data.object_value.count = 0;
             break;
         case VALUE_FUNCTION:
             if (value->data.function_value.return_type) {
@@ -787,19 +903,21 @@ void value_free(Value* value) {
                     Value* key = (Value*)value->data.hash_map_value.keys[i];
                     if (key) {
                         value_free(key);
-                        shared_free_safe(key, "interpreter", "value_free", 0);
                     }
                     Value* map_value = (Value*)value->data.hash_map_value.values[i];
                     if (map_value) {
                         value_free(map_value);
-                        shared_free_safe(map_value, "interpreter", "value_free", 0);
                     }
                 }
-                shared_free_safe(value->data.hash_map_value.keys, "interpreter", "value_free", 0);
-                shared_free_safe(value->data.hash_map_value.values, "interpreter", "value_free", 0);
+                slab_free_all(value->data.hash_map_value.keys, value->data.hash_map_value.count);
+                slab_free_all(value->data.hash_map_value.values, value->data.hash_map_value.count);
+                slab_free(value->data.hash_map_value.keys);
+                slab_free(value->data.hash_map_value.values);
                 value->data.hash_map_value.keys = NULL;
                 value->data.hash_map_value.values = NULL;
             }
+            slab_free(value->data.hash_map_value.index);
+            value->data.hash_map_value.index = NULL;
             break;
         case VALUE_SET:
             if (value->data.set_value.elements) {
@@ -807,12 +925,14 @@ void value_free(Value* value) {
                     Value* element = (Value*)value->data.set_value.elements[i];
                     if (element) {
                         value_free(element);
-                        shared_free_safe(element, "interpreter", "value_free", 0);
                     }
                 }
-                shared_free_safe(value->data.set_value.elements, "interpreter", "value_free", 0);
+                slab_free_all(value->data.set_value.elements, value->data.set_value.count);
+                slab_free(value->data.set_value.elements);
                 value->data.set_value.elements = NULL;
             }
+            slab_free(value->data.set_value.index);
+            value->data.set_value.index = NULL;
             break;
         default:
             // For other types, no special cleanup needed
@@ -821,6 +941,7 @@ void value_free(Value* value) {
     
     // Reset the value to null
     value->type = VALUE_NULL;
+    value->flags &= ~VALUE_FLAG_HASHED;
     memset(&value->data, 0, sizeof(value->data));
 }
 
@@ -440,14 +440,6 @@ static Value create_class_instance_from_args(Interpreter* interpreter, Value* cl
         return value_create_null();
     }
     
-    // Create an instance object to store instance variables
-    Value instance = value_create_object(16);
-    
-    // Store the class name as a string for method lookup (safer than storing the full class)
-    Value class_name_value = value_create_string(class_value->data.class_value.class_name);
-    value_object_set(&instance, "__class_name__", class_name_value);
-    value_free(&class_name_value);
-    
     // Collect all fields from the inheritance chain
     ASTNode** all_fields = NULL;
     size_t field_count = 0;
@@ -455,6 +447,14 @@ static Value create_class_instance_from_args(Interpreter* interpreter, Value* cl
     
     collect_inherited_fields(interpreter, class_value, &all_fields, &field_count, &field_capacity);
     
+    // Create an instance object to store instance variables (one slot per field plus the class name)
+    Value instance = value_create_object(field_count + 1);
+    
+    // Store the class name as a string for method lookup (safer than storing the full class)
+    Value class_name_value = value_create_string(class_value->data.class_value.class_name);
+    value_object_set(&instance, "__class_name__", class_name_value);
+    value_free(&class_name_value);
+    
     // Initialize fields from constructor arguments
     size_t field_index = 0;
     for (size_t i = 0; i < field_count; i++) {
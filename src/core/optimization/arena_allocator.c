@@ -5,9 +5,12 @@
 
 #include "../../include/core/optimization/arena_allocator.h"
 #include "../../include/core/interpreter/value_operations.h"
+#include "../../include/utils/shared_utilities.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
 
 // ============================================================================
 // ARENA ALLOCATOR IMPLEMENTATION
@@ -37,12 +40,24 @@ ArenaAllocator* arena_allocator_create(size_t size) {
     return arena;
 }
 
+void arena_allocator_init(ArenaAllocator* arena, void* memory, size_t size) {
+    if (!arena) {
+        return;
+    }
+    
+    arena->memory = memory;
+    arena->size = memory ? size : 0;
+    arena->offset = 0;
+    arena->peak_usage = 0;
+    arena->is_allocated = 0;
+}
+
 void arena_allocator_free(ArenaAllocator* arena) {
     if (!arena) {
         return;
     }
     
-    if (arena->memory) {
+    if (arena->memory && arena->is_allocated) {
         free(arena->memory);
     }
     
@@ -338,3 +353,272 @@ void arena_manager_get_stats(ArenaManager* manager,
         }
     }
 }
+
+// ============================================================================
+// SLAB ALLOCATOR IMPLEMENTATION
+// ============================================================================
+
+// Page map: a two-level radix table from 64KB page number to the page's size
+// class and owning allocator, covering 48-bit addresses. Entries are written
+// under a lock before any block of the page is handed out and never cleared,
+// so lookups read it without locking.
+#define SLAB_MAP_LEAF_BITS 16
+#define SLAB_MAP_LEAF_SIZE ((size_t)1 << SLAB_MAP_LEAF_BITS)
+#define SLAB_MAP_ROOT_SIZE ((size_t)1 << (48 - SLAB_PAGE_SHIFT - SLAB_MAP_LEAF_BITS))
+
+typedef struct {
+    uint8_t size_class[SLAB_MAP_LEAF_SIZE];       // Class index + 1, 0 if not a slab page
+    SlabAllocator* owner[SLAB_MAP_LEAF_SIZE];     // Allocator whose free lists take the page
+} SlabPageMapLeaf;
+
+static SlabPageMapLeaf* volatile slab_page_map[SLAB_MAP_ROOT_SIZE];
+static pthread_mutex_t slab_page_map_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static MYCO_THREAD_LOCAL SlabAllocator slab_thread_allocator;
+
+static int slab_page_register(void* page, int size_class, SlabAllocator* owner) {
+    uintptr_t page_number = (uintptr_t)page >> SLAB_PAGE_SHIFT;
+    uintptr_t root = page_number >> SLAB_MAP_LEAF_BITS;
+    if (root >= SLAB_MAP_ROOT_SIZE) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&slab_page_map_lock);
+    SlabPageMapLeaf* leaf = slab_page_map[root];
+    if (!leaf) {
+        leaf = calloc(1, sizeof(SlabPageMapLeaf));
+        if (!leaf) {
+            pthread_mutex_unlock(&slab_page_map_lock);
+            return 0;
+        }
+        slab_page_map[root] = leaf;
+    }
+    size_t index = page_number & (SLAB_MAP_LEAF_SIZE - 1);
+    leaf->owner[index] = owner;
+    leaf->size_class[index] = (uint8_t)(size_class + 1);
+    pthread_mutex_unlock(&slab_page_map_lock);
+    return 1;
+}
+
+static int slab_page_lookup(const void* ptr, int* size_class, SlabAllocator** owner) {
+    uintptr_t page_number = (uintptr_t)ptr >> SLAB_PAGE_SHIFT;
+    uintptr_t root = page_number >> SLAB_MAP_LEAF_BITS;
+    if (root >= SLAB_MAP_ROOT_SIZE) {
+        return 0;
+    }
+    
+    SlabPageMapLeaf* leaf = slab_page_map[root];
+    if (!leaf) {
+        return 0;
+    }
+    size_t index = page_number & (SLAB_MAP_LEAF_SIZE - 1);
+    uint8_t entry = leaf->size_class[index];
+    if (entry == 0) {
+        return 0;
+    }
+    *size_class = entry - 1;
+    *owner = leaf->owner[index];
+    return 1;
+}
+
+static SlabAllocator* slab_current(void) {
+    SlabAllocator* slab = &slab_thread_allocator;
+    if (!slab->initialized) {
+        for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+            slab->classes[i].block_size = (size_t)SLAB_MIN_BLOCK_SIZE << i;
+            arena_allocator_init(&slab->classes[i].page, NULL, 0);
+        }
+        slab->initialized = 1;
+    }
+    return slab;
+}
+
+static int slab_class_for(size_t size) {
+    int size_class = 0;
+    size_t block_size = SLAB_MIN_BLOCK_SIZE;
+    while (block_size < size) {
+        block_size <<= 1;
+        size_class++;
+    }
+    return size_class;
+}
+
+// Carve a fresh page-aligned page out of the current chunk, reserving a new
+// chunk (over-allocated by one page so it can be aligned) when it runs out
+static void* slab_take_page(SlabAllocator* slab) {
+    ArenaAllocator* chunk = slab->chunk;
+    if (!chunk || chunk->offset + SLAB_PAGE_SIZE > chunk->size) {
+        chunk = arena_allocator_create(SLAB_PAGE_SIZE * (SLAB_PAGES_PER_CHUNK + 1));
+        if (!chunk) {
+            return NULL;
+        }
+        uintptr_t base = (uintptr_t)chunk->memory;
+        uintptr_t aligned = (base + SLAB_PAGE_SIZE - 1) & ~((uintptr_t)SLAB_PAGE_SIZE - 1);
+        chunk->offset = (size_t)(aligned - base);
+        // Chunks stay reserved for the life of the process
+        slab->chunk = chunk;
+        slab->chunk_count++;
+    }
+    return arena_allocator_alloc(chunk, SLAB_PAGE_SIZE, 1);
+}
+
+void* slab_alloc(size_t size) {
+    if (size > SLAB_MAX_BLOCK_SIZE) {
+        SlabAllocator* slab = slab_current();
+        slab->large_allocations++;
+        return shared_malloc_safe(size, "slab", "slab_alloc", 0);
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    
+    SlabAllocator* slab = slab_current();
+    int size_class = slab_class_for(size);
+    SlabClass* cls = &slab->classes[size_class];
+    
+    void* block = cls->free_list;
+    if (block) {
+        cls->free_list = cls->free_list->next;
+    } else {
+        block = arena_allocator_alloc(&cls->page, cls->block_size, SLAB_MIN_BLOCK_SIZE);
+        if (!block) {
+            void* page = slab_take_page(slab);
+            if (!page || !slab_page_register(page, size_class, slab)) {
+                // No page (or an address the map cannot describe): fall back
+                slab->large_allocations++;
+                return shared_malloc_safe(size, "slab", "slab_alloc", 1);
+            }
+            arena_allocator_init(&cls->page, page, SLAB_PAGE_SIZE);
+            cls->page_count++;
+            block = arena_allocator_alloc(&cls->page, cls->block_size, SLAB_MIN_BLOCK_SIZE);
+        }
+    }
+    
+    cls->allocation_count++;
+    cls->live_blocks++;
+    return block;
+}
+
+void slab_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    
+    SlabAllocator* slab = slab_current();
+    int size_class;
+    SlabAllocator* owner;
+    if (!slab_page_lookup(ptr, &size_class, &owner)) {
+        shared_free_safe(ptr, "slab", "slab_free", 0);
+        return;
+    }
+    if (owner != slab) {
+        // Another thread's free lists cannot be touched without a lock
+        slab->foreign_frees++;
+        return;
+    }
+    
+    SlabClass* cls = &slab->classes[size_class];
+    SlabFreeBlock* block = (SlabFreeBlock*)ptr;
+    block->next = cls->free_list;
+    cls->free_list = block;
+    cls->free_count++;
+    if (cls->live_blocks > 0) {
+        cls->live_blocks--;
+    }
+}
+
+void slab_free_all(void** ptrs, size_t count) {
+    if (!ptrs) {
+        return;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (ptrs[i]) {
+            slab_free(ptrs[i]);
+        }
+    }
+}
+
+void* slab_realloc(void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) {
+        return slab_alloc(new_size);
+    }
+    if (new_size == 0) {
+        slab_free(ptr);
+        return NULL;
+    }
+    
+    int size_class;
+    SlabAllocator* owner;
+    if (slab_page_lookup(ptr, &size_class, &owner)) {
+        size_t block_size = (size_t)SLAB_MIN_BLOCK_SIZE << size_class;
+        if (new_size <= block_size) {
+            return ptr;
+        }
+        if (old_size > block_size) {
+            old_size = block_size;
+        }
+    } else if (new_size > SLAB_MAX_BLOCK_SIZE) {
+        // Large blocks live in the system allocator and can grow in place
+        return shared_realloc_safe(ptr, new_size, "slab", "slab_realloc", 0);
+    }
+    
+    void* grown = slab_alloc(new_size);
+    if (!grown) {
+        return NULL;
+    }
+    memcpy(grown, ptr, old_size < new_size ? old_size : new_size);
+    slab_free(ptr);
+    return grown;
+}
+
+int slab_owns(const void* ptr) {
+    int size_class;
+    SlabAllocator* owner;
+    return ptr && slab_page_lookup(ptr, &size_class, &owner);
+}
+
+void slab_get_stats(SlabStats* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(SlabStats));
+    SlabAllocator* slab = slab_current();
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        SlabClass* cls = &slab->classes[i];
+        SlabClassStats* out = &stats->classes[i];
+        out->block_size = cls->block_size;
+        out->allocation_count = cls->allocation_count;
+        out->free_count = cls->free_count;
+        out->live_blocks = cls->live_blocks;
+        out->page_count = cls->page_count;
+        
+        stats->allocation_count += cls->allocation_count;
+        stats->free_count += cls->free_count;
+        stats->live_bytes += cls->live_blocks * cls->block_size;
+        stats->reserved_bytes += cls->page_count * SLAB_PAGE_SIZE;
+    }
+    stats->large_allocations = slab->large_allocations;
+    stats->foreign_frees = slab->foreign_frees;
+    stats->fragmentation = stats->reserved_bytes > 0
+        ? 1.0 - (double)stats->live_bytes / (double)stats->reserved_bytes
+        : 0.0;
+}
+
+void slab_print_stats(void) {
+    SlabStats stats;
+    slab_get_stats(&stats);
+    
+    fprintf(stderr, "[SLAB STATS] %zu allocations, %zu recycled, %zu live bytes in %zu reserved (%.1f%% fragmentation), %zu large, %zu foreign frees\n",
+            stats.allocation_count, stats.free_count, stats.live_bytes, stats.reserved_bytes,
+            stats.fragmentation * 100.0, stats.large_allocations, stats.foreign_frees);
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        SlabClassStats* cls = &stats.classes[i];
+        if (cls->allocation_count == 0) {
+            continue;
+        }
+        fprintf(stderr, "  %4zu B: %zu allocations, %zu recycled, %zu live, %zu pages\n",
+                cls->block_size, cls->allocation_count, cls->free_count, cls->live_blocks, cls->page_count);
+    }
+}
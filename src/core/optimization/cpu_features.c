@@ -54,6 +54,7 @@ static int detect_x86_64_features(CPUFeatureContext* context) {
     
     // Get CPU vendor string
     __cpuid(0, eax, ebx, ecx, edx);
+    unsigned int max_leaf = eax;
     memcpy(context->features.vendor_string, &ebx, 4);
     memcpy(context->features.vendor_string + 4, &edx, 4);
     memcpy(context->features.vendor_string + 8, &ecx, 4);
@@ -100,8 +101,25 @@ static int detect_x86_64_features(CPUFeatureContext* context) {
     // if (ecx & (1 << 3)) features |= CPU_FEATURE_MONITOR;
     if (ecx & (1 << 23)) features |= CPU_FEATURE_POPCNT;
     
-    // Extended features
-    __cpuid(7, eax, ebx, ecx, edx);
+    // AVX state is only usable when the OS saves YMM (and ZMM) registers
+    unsigned long long xcr0 = 0;
+    if (ecx & (1 << 27)) {
+        unsigned int xcr0_low, xcr0_high;
+        __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+        xcr0 = ((unsigned long long)xcr0_high << 32) | xcr0_low;
+    }
+    int os_avx = (xcr0 & 0x6) == 0x6;
+    int os_avx512 = os_avx && (xcr0 & 0xE0) == 0xE0;
+    if (!os_avx) features &= ~(uint64_t)(CPU_FEATURE_AVX | CPU_FEATURE_FMA);
+    
+    // Extended features (leaf 7, subleaf 0)
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    } else {
+        eax = ebx = ecx = edx = 0;
+    }
+    if (!os_avx) ebx &= ~(1u << 5);
+    if (!os_avx512) ebx &= ~((1u << 16) | (1u << 17) | (1u << 30) | (1u << 31));
     if (ebx & (1 << 5)) features |= CPU_FEATURE_AVX2;
     if (ebx & (1 << 16)) features |= CPU_FEATURE_AVX512F;
     if (ebx & (1 << 30)) features |= CPU_FEATURE_AVX512BW;
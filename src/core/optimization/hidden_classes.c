@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <pthread.h>
 
 // ============================================================================
 // HIDDEN CLASSES IMPLEMENTATION
@@ -790,3 +791,168 @@ int hidden_classes_import_data(HiddenClassesContext* context, const char* filena
     
     return 1;
 }
+
+// ============================================================================
+// OBJECT SHAPES
+// ============================================================================
+// The shape tree is process-wide and grows only by appending transitions.
+// Writers serialize on object_shape_lock; a published shape never changes
+// apart from its transition list and slot capacity hint, so readers that
+// only look up names do not take the lock.
+
+#define OBJECT_SHAPE_LINEAR_LIMIT 8
+
+static ObjectShape object_shape_root_shape = {0};
+static uint32_t object_shape_next_id = 1;
+static pthread_mutex_t object_shape_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t object_shape_hash(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int object_shape_build_index(ObjectShape* shape) {
+    size_t capacity = 16;
+    while (capacity < (size_t)shape->count * 2) capacity *= 2;
+    
+    uint32_t* index = (uint32_t*)shared_malloc_safe(
+        sizeof(uint32_t) * capacity, "hidden_classes", "object_shape_build_index", 0);
+    if (!index) return 0;
+    memset(index, 0, sizeof(uint32_t) * capacity);
+    
+    size_t mask = capacity - 1;
+    for (uint32_t slot = 0; slot < shape->count; slot++) {
+        size_t i = object_shape_hash(shape->names[slot]) & mask;
+        while (index[i]) i = (i + 1) & mask;
+        index[i] = slot + 1;
+    }
+    
+    shape->index = index;
+    shape->index_capacity = capacity;
+    return 1;
+}
+
+ObjectShape* object_shape_root(void) {
+    return &object_shape_root_shape;
+}
+
+uint32_t object_shape_count(void) {
+    return object_shape_next_id;
+}
+
+int object_shape_find(const ObjectShape* shape, const char* name) {
+    if (!shape || !name) return -1;
+    
+    if (!shape->index) {
+        for (uint32_t slot = 0; slot < shape->count; slot++) {
+            if (shape->names[slot] == name || strcmp(shape->names[slot], name) == 0) {
+                return (int)slot;
+            }
+        }
+        return -1;
+    }
+    
+    size_t mask = shape->index_capacity - 1;
+    for (size_t i = object_shape_hash(name) & mask; shape->index[i]; i = (i + 1) & mask) {
+        uint32_t slot = shape->index[i] - 1;
+        if (strcmp(shape->names[slot], name) == 0) {
+            return (int)slot;
+        }
+    }
+    return -1;
+}
+
+static ObjectShape* object_shape_create_child(ObjectShape* parent, const char* name) {
+    ObjectShape* child = (ObjectShape*)shared_malloc_safe(
+        sizeof(ObjectShape), "hidden_classes", "object_shape_add_property", 0);
+    if (!child) return NULL;
+    memset(child, 0, sizeof(ObjectShape));
+    
+    child->names = (char**)shared_malloc_safe(
+        sizeof(char*) * (parent->count + 1), "hidden_classes", "object_shape_add_property", 1);
+    char* own_name = shared_strdup(name);
+    if (!child->names || !own_name) {
+        shared_free_safe(child->names, "hidden_classes", "object_shape_add_property", 2);
+        shared_free_safe(own_name, "hidden_classes", "object_shape_add_property", 3);
+        shared_free_safe(child, "hidden_classes", "object_shape_add_property", 4);
+        return NULL;
+    }
+    if (parent->count > 0) {
+        memcpy(child->names, parent->names, sizeof(char*) * parent->count);
+    }
+    child->names[parent->count] = own_name;
+    child->parent = parent;
+    child->count = parent->count + 1;
+    child->expected_count = child->count;
+    child->id = object_shape_next_id++;
+    
+    // Small shapes are scanned linearly; larger ones get a hash index
+    if (child->count > OBJECT_SHAPE_LINEAR_LIMIT && !object_shape_build_index(child)) {
+        shared_free_safe(own_name, "hidden_classes", "object_shape_add_property", 5);
+        shared_free_safe(child->names, "hidden_classes", "object_shape_add_property", 6);
+        shared_free_safe(child, "hidden_classes", "object_shape_add_property", 7);
+        return NULL;
+    }
+    
+    // Publish the transition
+    if (parent->transition_count >= parent->transition_capacity) {
+        size_t new_capacity = parent->transition_capacity == 0 ? 2 : parent->transition_capacity * 2;
+        ObjectShape** grown = (ObjectShape**)shared_realloc_safe(
+            parent->transitions, sizeof(ObjectShape*) * new_capacity,
+            "hidden_classes", "object_shape_add_property", 8);
+        if (!grown) {
+            shared_free_safe(child->index, "hidden_classes", "object_shape_add_property", 9);
+            shared_free_safe(own_name, "hidden_classes", "object_shape_add_property", 10);
+            shared_free_safe(child->names, "hidden_classes", "object_shape_add_property", 11);
+            shared_free_safe(child, "hidden_classes", "object_shape_add_property", 12);
+            return NULL;
+        }
+        parent->transitions = grown;
+        parent->transition_capacity = new_capacity;
+    }
+    parent->transitions[parent->transition_count++] = child;
+    
+    // Let objects still on the path size their slots for the full layout
+    for (ObjectShape* s = parent; s; s = s->parent) {
+        if (s->expected_count >= child->count) break;
+        s->expected_count = child->count;
+    }
+    
+    return child;
+}
+
+ObjectShape* object_shape_add_property(ObjectShape* shape, const char* name) {
+    if (!shape || !name) return NULL;
+    
+    pthread_mutex_lock(&object_shape_lock);
+    ObjectShape* child = NULL;
+    for (size_t i = 0; i < shape->transition_count; i++) {
+        if (strcmp(shape->transitions[i]->names[shape->count], name) == 0) {
+            child = shape->transitions[i];
+            break;
+        }
+    }
+    if (!child) {
+        child = object_shape_create_child(shape, name);
+    }
+    pthread_mutex_unlock(&object_shape_lock);
+    
+    return child;
+}
+
+ObjectShape* object_shape_remove_property(ObjectShape* shape, size_t slot) {
+    if (!shape || slot >= shape->count) return NULL;
+    
+    // Replay the surviving properties from the root so objects that end up
+    // with the same keys still share a shape
+    ObjectShape* result = object_shape_root();
+    for (uint32_t i = 0; i < shape->count && result; i++) {
+        if (i == slot) continue;
+        result = object_shape_add_property(result, shape->names[i]);
+    }
+    return result;
+}
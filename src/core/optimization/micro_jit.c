@@ -5,9 +5,11 @@
 #include "../../include/core/optimization/hot_spot_tracker.h"
 #include "../../include/core/interpreter/value_operations.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <time.h>
@@ -35,14 +37,15 @@ int micro_jit_is_x86_64(void) {
 }
 
 int micro_jit_has_executable_memory_support(void) {
-    // Check if we can allocate executable memory
-    void* test_mem = mmap(NULL, 4096, PROT_READ | PROT_WRITE | PROT_EXEC, 
+    // Check if we can map memory and flip it from writable to executable
+    void* test_mem = mmap(NULL, 4096, PROT_READ | PROT_WRITE, 
                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (test_mem == MAP_FAILED) {
         return 0;
     }
+    int supported = micro_jit_make_executable(test_mem, 4096);
     munmap(test_mem, 4096);
-    return 1;
+    return supported;
 }
 
 // ============================================================================
@@ -185,9 +188,10 @@ uint8_t* micro_jit_allocate_executable_memory(size_t size) {
     size_t page_size = micro_jit_get_page_size();
     size_t aligned_size = (size + page_size - 1) & ~(page_size - 1);
     
-    // Allocate executable memory
+    // Map writable only; micro_jit_make_executable() later swaps write for
+    // execute so no page is ever writable and executable at once (W^X)
     void* memory = mmap(NULL, aligned_size, 
-                       PROT_READ | PROT_WRITE | PROT_EXEC,
+                       PROT_READ | PROT_WRITE,
                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     
     if (memory == MAP_FAILED) {
@@ -373,6 +377,11 @@ JitStatus micro_jit_generate_arm64(BytecodeProgram* bytecode,
     // Generate epilogue
     micro_jit_emit_ret(code, &offset);
     
+    if (!micro_jit_make_executable(code, estimated_size)) {
+        micro_jit_free_executable_memory(code, estimated_size);
+        return JIT_STATUS_FAILED;
+    }
+    
     *native_code = code;
     *code_size = offset;
     
@@ -405,6 +414,11 @@ JitStatus micro_jit_generate_x86_64(BytecodeProgram* bytecode,
     // Generate epilogue
     micro_jit_emit_ret(code, &offset);
     
+    if (!micro_jit_make_executable(code, estimated_size)) {
+        micro_jit_free_executable_memory(code, estimated_size);
+        return JIT_STATUS_FAILED;
+    }
+    
     *native_code = code;
     *code_size = offset;
     
@@ -666,30 +680,644 @@ uint64_t micro_jit_get_total_compilation_time(MicroJitContext* context) {
     return context ? context->total_compilation_time_ns : 0;
 }
 
+// ============================================================================
+// BASELINE TIER
+// ============================================================================
+// A template compiler from register-tier code to x86-64. Every register
+// instruction becomes a fixed instruction sequence working directly on the
+// NaN-boxed register file, so native and interpreted execution share one
+// frame layout and can hand over at any instruction boundary. While native
+// code runs, a few registers are pinned:
+//
+//   rbx  register file            r13  lowest tagged word (numbers sort below)
+//   r12  result word              r14  lowest cell word (cells sort above)
+//   r15  boxed false
+//
+// Before an instruction changes anything it checks its operands: numbers for
+// arithmetic and comparisons, booleans for logic and conditional jumps, and
+// that the destination holds no cell that would need releasing. A failed
+// check jumps to a stub returning the instruction's index, and the register
+// interpreter continues from there on its generic paths.
+
+// Guard failures tolerated before a program goes back to being interpreted
+#define MICRO_JIT_DEOPT_LIMIT 64
+
+#define MICRO_JIT_CELL_MIN NAN_BOX_TAG(NAN_BOX_TAG_STRING)
+
+// Counted per thread, like the rest of the VM state
+static MYCO_THREAD_LOCAL MicroJitTierStats micro_jit_tier_stats = {0};
+
+void micro_jit_get_tier_stats(MicroJitTierStats* stats) {
+    if (stats) {
+        *stats = micro_jit_tier_stats;
+    }
+}
+
+void micro_jit_free_register_program(RegisterProgram* program) {
+    if (!program || !program->native_code) return;
+    
+    MicroJitNativeCode* native = program->native_code;
+    if (native->code) {
+        micro_jit_free_executable_memory(native->code, native->code_size);
+    }
+    if (native->offsets) {
+        shared_free_safe(native->offsets, "micro_jit", "free_register_program", 0);
+    }
+    shared_free_safe(native, "micro_jit", "free_register_program", 0);
+    program->native_code = NULL;
+}
+
+size_t micro_jit_execute_register_program(RegisterProgram* program, NanBoxedValue* regs, size_t entry,
+                                          NanBoxedValue* result) {
+    MicroJitNativeCode* native = program ? program->native_code : NULL;
+    if (!native || !native->is_valid || entry >= native->offset_count) {
+        return entry;
+    }
+    
+    micro_jit_tier_stats.native_entries++;
+    size_t resume = native->entry(regs, result, native->code + native->offsets[entry]);
+    if (resume != SIZE_MAX) {
+        micro_jit_tier_stats.deoptimizations++;
+        if (++native->deoptimizations >= MICRO_JIT_DEOPT_LIMIT) {
+            // Operands keep failing the guards; stop entering the code
+            native->is_valid = 0;
+            micro_jit_tier_stats.functions_invalidated++;
+        }
+    }
+    return resume;
+}
+
+#if defined(__x86_64__)
+
+// Machine registers used as scratch by the templates
+#define JIT_RAX 0
+#define JIT_RCX 1
+#define JIT_RDX 2
+
+// Condition codes (second byte of the 0F 8x near jump)
+#define JIT_CC_B   0x82
+#define JIT_CC_AE  0x83
+#define JIT_CC_E   0x84
+#define JIT_CC_NE  0x85
+#define JIT_CC_BE  0x86
+#define JIT_CC_P   0x8A
+
+// A rel32 field to patch once the target's position is known
+typedef struct {
+    size_t site;
+    uint32_t target;
+} MicroJitFixup;
+
+typedef struct {
+    MicroJitFixup* items;
+    size_t count;
+    size_t capacity;
+} MicroJitFixupList;
+
+typedef struct {
+    uint8_t* bytes;
+    size_t size;
+    size_t capacity;
+    MicroJitFixupList jumps;        // Sites jumping to a register instruction
+    MicroJitFixupList deopts;       // Sites jumping to an instruction's deopt stub
+    int failed;
+} MicroJitAssembler;
+
+static void jit_emit(MicroJitAssembler* as, const uint8_t* bytes, size_t count) {
+    if (as->failed) return;
+    if (as->size + count > as->capacity) {
+        size_t capacity = as->capacity ? as->capacity * 2 : 1024;
+        while (capacity < as->size + count) capacity *= 2;
+        uint8_t* grown = shared_realloc_safe(as->bytes, capacity, "micro_jit", "jit_emit", 0);
+        if (!grown) {
+            as->failed = 1;
+            return;
+        }
+        as->bytes = grown;
+        as->capacity = capacity;
+    }
+    memcpy(as->bytes + as->size, bytes, count);
+    as->size += count;
+}
+
+static void jit_u32(MicroJitAssembler* as, uint32_t value) {
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    jit_emit(as, bytes, sizeof(bytes));
+}
+
+static void jit_u64(MicroJitAssembler* as, uint64_t value) {
+    jit_u32(as, (uint32_t)value);
+    jit_u32(as, (uint32_t)(value >> 32));
+}
+
+static void jit_patch32(MicroJitAssembler* as, size_t site, size_t target) {
+    uint32_t rel = (uint32_t)(target - (site + 4));
+    as->bytes[site] = (uint8_t)rel;
+    as->bytes[site + 1] = (uint8_t)(rel >> 8);
+    as->bytes[site + 2] = (uint8_t)(rel >> 16);
+    as->bytes[site + 3] = (uint8_t)(rel >> 24);
+}
+
+static void jit_add_fixup(MicroJitAssembler* as, MicroJitFixupList* list, uint32_t target) {
+    if (as->failed) return;
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 32;
+        MicroJitFixup* grown = shared_realloc_safe(list->items, capacity * sizeof(MicroJitFixup),
+                                                   "micro_jit", "jit_add_fixup", 0);
+        if (!grown) {
+            as->failed = 1;
+            return;
+        }
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count].site = as->size - 4;
+    list->items[list->count].target = target;
+    list->count++;
+}
+
+// Near jump (cc = 0 for an unconditional jmp) with a rel32 to fill in later
+static void jit_jump_rel32(MicroJitAssembler* as, uint8_t cc) {
+    if (cc) {
+        uint8_t op[2] = {0x0F, cc};
+        jit_emit(as, op, sizeof(op));
+    } else {
+        uint8_t op = 0xE9;
+        jit_emit(as, &op, 1);
+    }
+    jit_u32(as, 0);
+}
+
+static void jit_jump_to(MicroJitAssembler* as, uint8_t cc, uint32_t target) {
+    jit_jump_rel32(as, cc);
+    jit_add_fixup(as, &as->jumps, target);
+}
+
+static void jit_deopt_if(MicroJitAssembler* as, uint8_t cc, uint32_t pc) {
+    jit_jump_rel32(as, cc);
+    jit_add_fixup(as, &as->deopts, pc);
+}
+
+// Short jump over code emitted next; returns the rel8 site for jit_land()
+static size_t jit_skip(MicroJitAssembler* as, uint8_t opcode) {
+    uint8_t op[2] = {opcode, 0};
+    jit_emit(as, op, sizeof(op));
+    return as->size - 1;
+}
+
+static void jit_land(MicroJitAssembler* as, size_t site) {
+    if (!as->failed) {
+        as->bytes[site] = (uint8_t)(as->size - (site + 1));
+    }
+}
+
+// mov r, [rbx + reg*8]
+static void jit_load(MicroJitAssembler* as, int r, uint8_t reg) {
+    uint8_t op[3] = {0x48, 0x8B, (uint8_t)(0x83 | (r << 3))};
+    jit_emit(as, op, sizeof(op));
+    jit_u32(as, (uint32_t)reg * 8);
+}
+
+// mov [rbx + reg*8], r
+static void jit_store(MicroJitAssembler* as, int r, uint8_t reg) {
+    uint8_t op[3] = {0x48, 0x89, (uint8_t)(0x83 | (r << 3))};
+    jit_emit(as, op, sizeof(op));
+    jit_u32(as, (uint32_t)reg * 8);
+}
+
+// mov r, imm64
+static void jit_mov_imm64(MicroJitAssembler* as, int r, uint64_t imm) {
+    uint8_t op[2] = {0x48, (uint8_t)(0xB8 + r)};
+    jit_emit(as, op, sizeof(op));
+    jit_u64(as, imm);
+}
+
+static void jit_store_null(MicroJitAssembler* as, uint8_t reg) {
+    jit_mov_imm64(as, JIT_RCX, NAN_BOX_NULL_VALUE);
+    jit_store(as, JIT_RCX, reg);
+}
+
+// cmp r, r13 (below = number)
+static void jit_test_number(MicroJitAssembler* as, int r) {
+    uint8_t op[3] = {0x4C, 0x39, (uint8_t)(0xE8 | r)};
+    jit_emit(as, op, sizeof(op));
+}
+
+// jae deopt
+static void jit_guard_number(MicroJitAssembler* as, int r, uint32_t pc) {
+    jit_test_number(as, r);
+    jit_deopt_if(as, JIT_CC_AE, pc);
+}
+
+// cmp r, r14; jae deopt
+static void jit_guard_not_cell(MicroJitAssembler* as, int r, uint32_t pc) {
+    uint8_t op[3] = {0x4C, 0x39, (uint8_t)(0xF0 | r)};
+    jit_emit(as, op, sizeof(op));
+    jit_deopt_if(as, JIT_CC_AE, pc);
+}
+
+// mov r11, r; and r11, ~1; cmp r11, r15 (equal = boolean)
+static void jit_test_boolean(MicroJitAssembler* as, int r) {
+    uint8_t op[10] = {0x49, 0x89, (uint8_t)(0xC3 | (r << 3)),
+                      0x49, 0x83, 0xE3, 0xFE,
+                      0x4D, 0x39, 0xFB};
+    jit_emit(as, op, sizeof(op));
+}
+
+// jne deopt
+static void jit_guard_boolean(MicroJitAssembler* as, int r, uint32_t pc) {
+    jit_test_boolean(as, r);
+    jit_deopt_if(as, JIT_CC_NE, pc);
+}
+
+// The destination may be overwritten without releasing anything
+static void jit_guard_destination(MicroJitAssembler* as, uint8_t dst, uint32_t pc) {
+    jit_load(as, JIT_RDX, dst);
+    jit_guard_not_cell(as, JIT_RDX, pc);
+}
+
+// xmm0 = src1, xmm1 = src2, both guarded to be numbers
+static void jit_load_numbers(MicroJitAssembler* as, const RegisterInstruction* ip, uint32_t pc) {
+    static const uint8_t to_xmm[10] = {0x66, 0x48, 0x0F, 0x6E, 0xC0,    // movq xmm0, rax
+                                       0x66, 0x48, 0x0F, 0x6E, 0xC9};   // movq xmm1, rcx
+    jit_load(as, JIT_RAX, ip->src1);
+    jit_guard_number(as, JIT_RAX, pc);
+    jit_load(as, JIT_RCX, ip->src2);
+    jit_guard_number(as, JIT_RCX, pc);
+    jit_emit(as, to_xmm, sizeof(to_xmm));
+}
+
+// dst = xmm0, with NaN canonicalized as nan_boxing_create_number does
+static void jit_store_number(MicroJitAssembler* as, uint8_t dst) {
+    static const uint8_t box[11] = {0x66, 0x48, 0x0F, 0x7E, 0xC0,       // movq rax, xmm0
+                                    0x66, 0x0F, 0x2E, 0xC0,             // ucomisd xmm0, xmm0
+                                    0x7B, 0x0A};                        // jnp over the mov
+    jit_emit(as, box, sizeof(box));
+    jit_mov_imm64(as, JIT_RAX, NAN_BOX_CANONICAL_NAN);
+    jit_store(as, JIT_RAX, dst);
+}
+
+// ucomisd for a comparison: a < b and a <= b are tested as b > a, b >= a
+static void jit_compare(MicroJitAssembler* as, int swapped) {
+    uint8_t op[4] = {0x66, 0x0F, 0x2E, (uint8_t)(swapped ? 0xC8 : 0xC1)};
+    jit_emit(as, op, sizeof(op));
+}
+
+// x / y and fmod(x, y) give null when y is zero, like the register interpreter
+static void jit_divide(MicroJitAssembler* as, const RegisterInstruction* ip, uint32_t pc) {
+    static const uint8_t test_zero[8] = {0x66, 0x0F, 0x57, 0xD2,        // xorpd xmm2, xmm2
+                                         0x66, 0x0F, 0x2E, 0xCA};       // ucomisd xmm1, xmm2
+    jit_load_numbers(as, ip, pc);
+    jit_guard_destination(as, ip->dst, pc);
+    jit_emit(as, test_zero, sizeof(test_zero));
+    size_t unordered = jit_skip(as, 0x7A);                              // jp
+    size_t nonzero = jit_skip(as, 0x75);                                // jne
+    jit_store_null(as, ip->dst);
+    size_t done = jit_skip(as, 0xEB);                                   // jmp
+    jit_land(as, unordered);
+    jit_land(as, nonzero);
+    if (ip->opcode == REG_DIVF_RR) {
+        static const uint8_t divsd[4] = {0xF2, 0x0F, 0x5E, 0xC1};
+        jit_emit(as, divsd, sizeof(divsd));
+    } else {
+        static const uint8_t call_rax[2] = {0xFF, 0xD0};
+        double (*fmod_fn)(double, double) = fmod;
+        jit_mov_imm64(as, JIT_RAX, (uint64_t)(uintptr_t)fmod_fn);
+        jit_emit(as, call_rax, sizeof(call_rax));
+    }
+    jit_store_number(as, ip->dst);
+    jit_land(as, done);
+}
+
+// Emit one register instruction; returns 0 if it is outside the native subset
+static int jit_emit_instruction(MicroJitAssembler* as, const RegisterInstruction* ip, uint32_t pc) {
+    switch (ip->opcode) {
+        case REG_MOV_RR:
+            jit_load(as, JIT_RAX, ip->src1);
+            if (ip->dst != ip->src1) {
+                jit_guard_destination(as, ip->dst, pc);
+            }
+            jit_store(as, JIT_RAX, ip->dst);
+            jit_store_null(as, ip->src1);
+            return 1;
+            
+        case REG_COPY_RR:
+            jit_load(as, JIT_RAX, ip->src1);
+            jit_guard_not_cell(as, JIT_RAX, pc);
+            jit_guard_destination(as, ip->dst, pc);
+            jit_store(as, JIT_RAX, ip->dst);
+            return 1;
+            
+        case REG_ADDF_RR:
+        case REG_SUBF_RR:
+        case REG_MULF_RR: {
+            uint8_t sse = ip->opcode == REG_ADDF_RR ? 0x58 : ip->opcode == REG_SUBF_RR ? 0x5C : 0x59;
+            uint8_t op[4] = {0xF2, 0x0F, sse, 0xC1};                    // op xmm0, xmm1
+            jit_load_numbers(as, ip, pc);
+            jit_guard_destination(as, ip->dst, pc);
+            jit_emit(as, op, sizeof(op));
+            jit_store_number(as, ip->dst);
+            return 1;
+        }
+            
+        case REG_DIVF_RR:
+        case REG_MODF_RR:
+            jit_divide(as, ip, pc);
+            return 1;
+            
+        case REG_EQ_RR:
+        case REG_NE_RR:
+        case REG_LT_RR:
+        case REG_LE_RR:
+        case REG_GT_RR:
+        case REG_GE_RR: {
+            static const uint8_t box[6] = {0x0F, 0xB6, 0xC0,            // movzx eax, al
+                                           0x4C, 0x09, 0xF8};           // or rax, r15
+            uint8_t setcc[3] = {0x0F, 0x97, 0xC0};                      // seta al
+            int swapped = ip->opcode == REG_LT_RR || ip->opcode == REG_LE_RR;
+            if (ip->opcode == REG_LE_RR || ip->opcode == REG_GE_RR) setcc[1] = 0x93;   // setae
+            if (ip->opcode == REG_EQ_RR) setcc[1] = 0x94;                               // sete
+            if (ip->opcode == REG_NE_RR) setcc[1] = 0x95;                               // setne
+            jit_load_numbers(as, ip, pc);
+            jit_guard_destination(as, ip->dst, pc);
+            jit_compare(as, swapped);
+            jit_emit(as, setcc, sizeof(setcc));
+            if (ip->opcode == REG_EQ_RR) {
+                static const uint8_t ordered[5] = {0x0F, 0x9B, 0xC1, 0x20, 0xC8};   // setnp cl; and al, cl
+                jit_emit(as, ordered, sizeof(ordered));
+            } else if (ip->opcode == REG_NE_RR) {
+                static const uint8_t unordered[5] = {0x0F, 0x9A, 0xC1, 0x08, 0xC8}; // setp cl; or al, cl
+                jit_emit(as, unordered, sizeof(unordered));
+            }
+            jit_emit(as, box, sizeof(box));
+            jit_store(as, JIT_RAX, ip->dst);
+            return 1;
+        }
+            
+        case REG_JUMP_IF_NOT_EQ:
+            jit_load_numbers(as, ip, pc);
+            jit_compare(as, 0);
+            jit_jump_to(as, JIT_CC_P, ip->immediate);
+            jit_jump_to(as, JIT_CC_NE, ip->immediate);
+            return 1;
+            
+        case REG_JUMP_IF_NOT_NE: {
+            jit_load_numbers(as, ip, pc);
+            jit_compare(as, 0);
+            size_t unordered = jit_skip(as, 0x7A);                      // jp: NaN != anything
+            jit_jump_to(as, JIT_CC_E, ip->immediate);
+            jit_land(as, unordered);
+            return 1;
+        }
+            
+        case REG_JUMP_IF_NOT_LT:
+        case REG_JUMP_IF_NOT_LE:
+        case REG_JUMP_IF_NOT_GT:
+        case REG_JUMP_IF_NOT_GE: {
+            int swapped = ip->opcode == REG_JUMP_IF_NOT_LT || ip->opcode == REG_JUMP_IF_NOT_LE;
+            int strict = ip->opcode == REG_JUMP_IF_NOT_LT || ip->opcode == REG_JUMP_IF_NOT_GT;
+            jit_load_numbers(as, ip, pc);
+            jit_compare(as, swapped);
+            jit_jump_to(as, strict ? JIT_CC_BE : JIT_CC_B, ip->immediate);
+            return 1;
+        }
+            
+        case REG_NOT_R: {
+            static const uint8_t flip[4] = {0x48, 0x83, 0xF0, 0x01};    // xor rax, 1
+            jit_load(as, JIT_RAX, ip->src1);
+            jit_guard_boolean(as, JIT_RAX, pc);
+            jit_guard_destination(as, ip->dst, pc);
+            jit_emit(as, flip, sizeof(flip));
+            jit_store(as, JIT_RAX, ip->dst);
+            return 1;
+        }
+            
+        case REG_AND_RR:
+        case REG_OR_RR: {
+            uint8_t op[3] = {0x48, (uint8_t)(ip->opcode == REG_AND_RR ? 0x21 : 0x09), 0xC8};   // and/or rax, rcx
+            jit_load(as, JIT_RAX, ip->src1);
+            jit_guard_boolean(as, JIT_RAX, pc);
+            jit_load(as, JIT_RCX, ip->src2);
+            jit_guard_boolean(as, JIT_RCX, pc);
+            jit_guard_destination(as, ip->dst, pc);
+            jit_emit(as, op, sizeof(op));
+            jit_store(as, JIT_RAX, ip->dst);
+            return 1;
+        }
+            
+        case REG_RELEASE_R:
+            jit_load(as, JIT_RAX, ip->dst);
+            jit_guard_not_cell(as, JIT_RAX, pc);
+            jit_store_null(as, ip->dst);
+            return 1;
+            
+        case REG_JUMP:
+            jit_jump_to(as, 0, ip->immediate);
+            return 1;
+            
+        case REG_JUMP_IF_FALSE: {
+            static const uint8_t test_bit[2] = {0xA8, 0x01};             // test al, 1
+            jit_load(as, JIT_RAX, ip->src1);
+            jit_guard_boolean(as, JIT_RAX, pc);
+            jit_emit(as, test_bit, sizeof(test_bit));
+            jit_jump_to(as, JIT_CC_E, ip->immediate);
+            return 1;
+        }
+            
+        case REG_GUARD_NUMBER:
+            jit_load(as, JIT_RAX, ip->src1);
+            jit_test_number(as, JIT_RAX);
+            jit_jump_to(as, JIT_CC_AE, ip->immediate);
+            return 1;
+            
+        case REG_GUARD_BOOLEAN:
+            jit_load(as, JIT_RAX, ip->src1);
+            jit_test_boolean(as, JIT_RAX);
+            jit_jump_to(as, JIT_CC_NE, ip->immediate);
+            return 1;
+            
+        case REG_RETURN:
+        case REG_RETURN_NULL: {
+            static const uint8_t ret[11] = {0x49, 0x89, 0x04, 0x24,      // mov [r12], rax
+                                            0x48, 0xC7, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF};  // mov rax, -1
+            if (ip->opcode == REG_RETURN) {
+                jit_load(as, JIT_RAX, ip->src1);
+                jit_store_null(as, ip->src1);
+            } else {
+                jit_mov_imm64(as, JIT_RAX, NAN_BOX_NULL_VALUE);
+            }
+            jit_emit(as, ret, sizeof(ret));
+            return 2;                                                   // Ends in a jump to the epilogue
+        }
+            
+        default:
+            // Calls and anything else stay in the register interpreter
+            return 0;
+    }
+}
+
+static MicroJitNativeCode* jit_assemble(const RegisterProgram* program) {
+    static const uint8_t prologue[9] = {
+        0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57                // push rbx, r12-r15
+    };
+    static const uint8_t epilogue[10] = {
+        0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3          // pop r15-r12, rbx; ret
+    };
+    size_t count = program->instruction_count;
+    MicroJitAssembler as = {0};
+    uint32_t* offsets = shared_malloc_safe((count + 1) * sizeof(uint32_t), "micro_jit", "jit_assemble", 0);
+    uint32_t* stubs = shared_malloc_safe((count + 1) * sizeof(uint32_t), "micro_jit", "jit_assemble", 0);
+    MicroJitNativeCode* native = NULL;
+    if (!offsets || !stubs) goto out;
+    
+    // Prologue: save callee-saved registers (which also realigns the stack
+    // for fmod), pin the frame registers, then jump to the entry instruction
+    jit_emit(&as, prologue, sizeof(prologue));
+    {
+        static const uint8_t pin[6] = {0x48, 0x89, 0xFB,                // mov rbx, rdi
+                                       0x49, 0x89, 0xF4};               // mov r12, rsi
+        static const uint8_t enter[2] = {0xFF, 0xE2};                   // jmp rdx
+        uint8_t r13[2] = {0x49, 0xBD}, r14[2] = {0x49, 0xBE}, r15[2] = {0x49, 0xBF};
+        jit_emit(&as, pin, sizeof(pin));
+        jit_emit(&as, r13, 2);
+        jit_u64(&as, NAN_BOX_TAGGED_MIN);
+        jit_emit(&as, r14, 2);
+        jit_u64(&as, MICRO_JIT_CELL_MIN);
+        jit_emit(&as, r15, 2);
+        jit_u64(&as, NAN_BOX_FALSE_VALUE);
+        jit_emit(&as, enter, sizeof(enter));
+    }
+    size_t epilogue_at = as.size;
+    jit_emit(&as, epilogue, sizeof(epilogue));
+    
+    // Running off the end returns null, like the interpreter's default case
+    RegisterInstruction end = {REG_RETURN_NULL, 0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i <= count; i++) {
+        offsets[i] = (uint32_t)as.size;
+        stubs[i] = UINT32_MAX;
+        const RegisterInstruction* ip = i < count ? &program->instructions[i] : &end;
+        int emitted = jit_emit_instruction(&as, ip, (uint32_t)i);
+        if (!emitted) goto out;
+        if (emitted == 2) {
+            jit_jump_rel32(&as, 0);
+            if (!as.failed) jit_patch32(&as, as.size - 4, epilogue_at);
+        }
+    }
+    
+    // One deopt stub per guarded instruction: mov eax, index; jmp epilogue
+    for (size_t i = 0; i < as.deopts.count && !as.failed; i++) {
+        uint32_t pc = as.deopts.items[i].target;
+        if (stubs[pc] == UINT32_MAX) {
+            uint8_t mov = 0xB8;
+            stubs[pc] = (uint32_t)as.size;
+            jit_emit(&as, &mov, 1);
+            jit_u32(&as, pc);
+            jit_jump_rel32(&as, 0);
+            if (!as.failed) jit_patch32(&as, as.size - 4, epilogue_at);
+        }
+        if (!as.failed) jit_patch32(&as, as.deopts.items[i].site, stubs[pc]);
+    }
+    for (size_t i = 0; i < as.jumps.count && !as.failed; i++) {
+        if (as.jumps.items[i].target > count) goto out;
+        jit_patch32(&as, as.jumps.items[i].site, offsets[as.jumps.items[i].target]);
+    }
+    if (as.failed) goto out;
+    
+    // Copy into a fresh mapping and seal it before anything runs
+    uint8_t* code = micro_jit_allocate_executable_memory(as.size);
+    if (!code) goto out;
+    memcpy(code, as.bytes, as.size);
+    if (!micro_jit_make_executable(code, as.size)) {
+        micro_jit_free_executable_memory(code, as.size);
+        goto out;
+    }
+    native = shared_malloc_safe(sizeof(MicroJitNativeCode), "micro_jit", "jit_assemble", 0);
+    if (!native) {
+        micro_jit_free_executable_memory(code, as.size);
+        goto out;
+    }
+    native->code = code;
+    // POSIX guarantees data and function pointers share a representation
+    memcpy(&native->entry, &code, sizeof(native->entry));
+    native->code_size = as.size;
+    native->offsets = offsets;
+    native->offset_count = count;
+    native->deoptimizations = 0;
+    native->is_valid = 1;
+    offsets = NULL;
+    
+out:
+    if (offsets) shared_free_safe(offsets, "micro_jit", "jit_assemble", 0);
+    if (stubs) shared_free_safe(stubs, "micro_jit", "jit_assemble", 0);
+    if (as.bytes) shared_free_safe(as.bytes, "micro_jit", "jit_assemble", 0);
+    if (as.jumps.items) shared_free_safe(as.jumps.items, "micro_jit", "jit_assemble", 0);
+    if (as.deopts.items) shared_free_safe(as.deopts.items, "micro_jit", "jit_assemble", 0);
+    return native;
+}
+
+#endif // __x86_64__
+
+int micro_jit_compile_register_program(Interpreter* interpreter, RegisterProgram* program) {
+    MicroJitContext* context = micro_jit_get_from_interpreter(interpreter);
+    if (!context || !program || program->native_code) {
+        return 0;
+    }
+    if (context->mode < MICRO_JIT_MODE_MICRO || !context->has_executable_memory || !context->is_x86_64) {
+        return 0;
+    }
+    
+#if defined(__x86_64__)
+    uint64_t start_time = get_current_time_ns();
+    if (context->code_cache) {
+        context->code_cache->compilation_count++;
+    }
+    
+    MicroJitNativeCode* native = jit_assemble(program);
+    if (!native) {
+        micro_jit_tier_stats.functions_rejected++;
+        return 0;
+    }
+    program->native_code = native;
+    
+    micro_jit_tier_stats.functions_compiled++;
+    micro_jit_tier_stats.code_bytes += native->code_size;
+    context->total_compilation_time_ns += get_current_time_ns() - start_time;
+    if (context->code_cache) {
+        context->code_cache->success_count++;
+        context->code_cache->total_code_size += native->code_size;
+    }
+    return 1;
+#else
+    micro_jit_tier_stats.functions_rejected++;
+    return 0;
+#endif
+}
+
 // ============================================================================
 // INTERPRETER INTEGRATION
 // ============================================================================
 
 void micro_jit_initialize_for_interpreter(Interpreter* interpreter) {
-    if (!interpreter) return;
+    if (!interpreter || interpreter->micro_jit_context) return;
     
-    // Initialize Micro-JIT context
-    // This will be implemented when we modify the Interpreter struct
+    // jit_mode 0 keeps everything interpreted; hybrid and compiled both
+    // compile hot register-tier functions to native code
+    MicroJitMode mode = interpreter->jit_mode == 0 ? MICRO_JIT_MODE_BYTECODE : MICRO_JIT_MODE_MICRO;
+    interpreter->micro_jit_context = micro_jit_create(JIT_TARGET_AUTO, mode);
 }
 
 void micro_jit_cleanup_for_interpreter(Interpreter* interpreter) {
-    if (!interpreter) return;
+    if (!interpreter || !interpreter->micro_jit_context) return;
     
-    // Cleanup Micro-JIT context
-    // This will be implemented when we modify the Interpreter struct
+    // Native code belongs to the register programs it was compiled from
+    micro_jit_free((MicroJitContext*)interpreter->micro_jit_context);
+    interpreter->micro_jit_context = NULL;
 }
 
 MicroJitContext* micro_jit_get_from_interpreter(Interpreter* interpreter) {
     if (!interpreter) return NULL;
     
-    // Return Micro-JIT context from interpreter
-    // This will be implemented when we modify the Interpreter struct
-    return NULL;
+    return (MicroJitContext*)interpreter->micro_jit_context;
 }
 
 // ============================================================================
@@ -1,12 +1,18 @@
 #include "../../include/core/optimization/register_vm.h"
+#include "../../include/core/bytecode.h"
+#include "../../include/core/optimization/micro_jit_baseline.h"
+#include "../../include/core/optimization/trace_recorder.h"
 #include "../../include/core/interpreter/value_operations.h"
 #include "../../include/core/interpreter/eval_engine.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 #include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 // ============================================================================
 // REGISTER VM IMPLEMENTATION
@@ -50,6 +56,12 @@ RegisterProgram* register_program_create(void) {
     program->traceable = 0;
     program->hotness_score = 0.0;
     
+    // Initialize register tier layout
+    program->temp_base = 0;
+    program->entry_points = NULL;
+    program->entry_point_count = 0;
+    program->native_code = NULL;
+    
     return program;
 }
 
@@ -89,6 +101,14 @@ void register_program_free(RegisterProgram* program) {
         shared_free_safe(program->function_name, "register_vm", "program_free", 0);
     }
     
+    // Free register tier entry points
+    if (program->entry_points) {
+        shared_free_safe(program->entry_points, "register_vm", "program_free", 0);
+    }
+    
+    // Free baseline JIT code
+    micro_jit_free_register_program(program);
+    
     shared_free_safe(program, "register_vm", "program_free", 0);
 }
 
@@ -1074,3 +1094,890 @@ void register_instruction_print(RegisterInstruction instr) {
            instr.opcode, instr.dst, instr.src1, instr.src2, instr.src3, 
            instr.immediate, instr.offset);
 }
+
+// ============================================================================
+// REGISTER TIER
+// ============================================================================
+// Hot frame-slot functions are lowered from stack bytecode into three-address
+// register code. Registers hold NaN-boxed words and are laid out as
+//
+//   [0, local_count)            parameters and lets (the frame slots)
+//   [local_count, temp_base)    constants used by the function
+//   [temp_base, ...)            operand stack depth 0, 1, 2, ...
+//
+// Lowering simulates the operand stack: loads of locals and constants are
+// kept pending and become direct register operands, a STORE_LOCAL retargets
+// the instruction that produced the stored value, and a comparison feeding
+// JUMP_IF_FALSE is fused into one compare-and-branch. At jump targets every
+// pending operand is materialized in its temporary, so control flow always
+// joins in the same register state.
+//
+// Ownership: every register owns its word. Temporaries are consumed by the
+// instruction that reads them (released, or moved out and cleared), locals
+// and constants are only ever borrowed or cloned.
+
+#ifndef LIKELY
+#ifdef __GNUC__
+#define LIKELY(x)   __builtin_expect(!!(x), 1)
+#define UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define LIKELY(x)   (x)
+#define UNLIKELY(x) (x)
+#endif
+#endif
+
+#define REG_TIER_NO_REGISTER 0xFF
+
+static MYCO_THREAD_LOCAL RegisterTierStats reg_tier_stats = {0};  // Per thread
+
+void register_tier_get_stats(RegisterTierStats* stats) {
+    if (stats) {
+        *stats = reg_tier_stats;
+    }
+}
+
+size_t register_tier_entry_point(const RegisterProgram* program, size_t pc) {
+    if (!program || pc >= program->entry_point_count) {
+        return SIZE_MAX;
+    }
+    return program->entry_points[pc];
+}
+
+// Pending operand on the simulated stack
+typedef struct {
+    uint8_t reg;                // Register holding the value
+    bool borrowed;              // reg is a local or constant, not this depth's temporary
+} RegTierOperand;
+
+typedef struct {
+    RegisterProgram* program;
+    const BytecodeFunction* func;
+    const BytecodeProgram* owner;
+    int* depth;                 // Operand stack depth before each pc (-1 = unreachable)
+    bool* leader;               // pc is a jump target
+    int* const_source;          // Owner constant index held by each constant register
+    RegTierOperand stack[REG_TIER_MAX_REGISTERS];
+    int stack_size;
+    long last_def;              // Instruction that wrote the top temporary, if still last
+    bool failed;
+} RegTierCompiler;
+
+static bool reg_tier_is_compare(uint8_t opcode) {
+    return opcode >= REG_EQ_RR && opcode <= REG_GE_RR;
+}
+
+static void reg_tier_emit(RegTierCompiler* c, uint8_t opcode, uint8_t dst, uint8_t src1, uint8_t src2, uint32_t immediate) {
+    RegisterInstruction instr = {0};
+    instr.opcode = opcode;
+    instr.dst = dst;
+    instr.src1 = src1;
+    instr.src2 = src2;
+    instr.immediate = immediate;
+    if (!register_program_add_instruction(c->program, instr)) {
+        c->failed = true;
+    }
+}
+
+static uint8_t reg_tier_temp(RegTierCompiler* c, int depth) {
+    return (uint8_t)(c->program->temp_base + (size_t)depth);
+}
+
+// Copy a pending operand into its temporary
+static void reg_tier_materialize(RegTierCompiler* c, int index) {
+    RegTierOperand* operand = &c->stack[index];
+    if (!operand->borrowed) return;
+    reg_tier_emit(c, REG_COPY_RR, reg_tier_temp(c, index), operand->reg, 0, 0);
+    operand->reg = reg_tier_temp(c, index);
+    operand->borrowed = false;
+    c->last_def = -1;
+}
+
+static void reg_tier_materialize_all(RegTierCompiler* c) {
+    for (int i = 0; i < c->stack_size; i++) {
+        reg_tier_materialize(c, i);
+    }
+}
+
+static void reg_tier_push_temp(RegTierCompiler* c) {
+    c->stack[c->stack_size].reg = reg_tier_temp(c, c->stack_size);
+    c->stack[c->stack_size].borrowed = false;
+    c->stack_size++;
+}
+
+static uint8_t reg_tier_constant(RegTierCompiler* c, int index) {
+    RegisterProgram* program = c->program;
+    for (size_t i = 0; i < program->constant_count; i++) {
+        if (c->const_source[i] == index) {
+            return (uint8_t)(program->local_count + i);
+        }
+    }
+    c->const_source[program->constant_count] = index;
+    register_program_add_constant(program, c->owner->constants[index]);
+    return (uint8_t)(program->local_count + program->constant_count - 1);
+}
+
+// Stack effect of a lowerable instruction; returns false for anything else
+static bool reg_tier_stack_effect(const BytecodeFunction* func, const BytecodeProgram* owner,
+                                  size_t pc, int* pops, int* pushes) {
+    const BytecodeInstruction* instr = &func->code[pc];
+    *pops = 0;
+    *pushes = 0;
+    // Quickened instructions lower like the generic opcode they were rewritten from
+    switch (bytecode_generic_op(instr->op)) {
+        case BC_PUSH_FRAME:
+            return pc == 0 && instr->a >= 0 && (size_t)instr->a == func->local_count;
+        case BC_LOAD_CONST:
+            *pushes = 1;
+            return instr->a >= 0 && (size_t)instr->a < owner->const_count;
+        case BC_LOAD_LOCAL:
+            *pushes = 1;
+            return instr->a >= 0 && (size_t)instr->a < func->local_count;
+        case BC_STORE_LOCAL:
+            *pops = 1;
+            return instr->a >= 0 && (size_t)instr->a < func->local_count;
+        case BC_ADD: case BC_SUB: case BC_MUL: case BC_DIV: case BC_MOD:
+        case BC_EQ: case BC_NE: case BC_LT: case BC_LE: case BC_GT: case BC_GE:
+        case BC_AND: case BC_OR:
+            *pops = 2;
+            *pushes = 1;
+            return true;
+        case BC_NOT:
+            *pops = 1;
+            *pushes = 1;
+            return true;
+        case BC_DUP:
+            *pops = 1;
+            *pushes = 2;
+            return true;
+        case BC_POP:
+        case BC_JUMP_IF_FALSE:
+            *pops = 1;
+            return true;
+        case BC_JUMP:
+        case BC_LOOP_START:
+        case BC_LOOP_END:
+            return true;
+        case BC_CALL_USER_FUNCTION:
+            *pops = instr->b;
+            *pushes = 1;
+            return instr->b >= 0;
+        case BC_RETURN:
+        case BC_POP_FRAME:
+            *pops = instr->a > 0 ? 1 : 0;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Compute the operand stack depth at every reachable pc. Fails when depths
+// disagree at a join, the stack underflows, or a jump leaves the function.
+static bool reg_tier_analyze(RegTierCompiler* c, int* max_depth) {
+    const BytecodeFunction* func = c->func;
+    size_t count = func->code_count;
+    size_t* worklist = shared_malloc_safe((count + 1) * sizeof(size_t), "register_vm", "reg_tier_analyze", 0);
+    if (!worklist) return false;
+    size_t pending = 0;
+    bool ok = true;
+    
+    c->depth[0] = 0;
+    worklist[pending++] = 0;
+    *max_depth = 0;
+    while (ok && pending > 0) {
+        size_t pc = worklist[--pending];
+        int pops, pushes;
+        const BytecodeInstruction* instr = &func->code[pc];
+        if (!reg_tier_stack_effect(func, c->owner, pc, &pops, &pushes)) {
+            ok = false;
+            break;
+        }
+        if (instr->op == BC_POP_FRAME && c->depth[pc] == 0) {
+            pops = 0;  // Returns null when there is no value to return
+        }
+        if (c->depth[pc] < pops) {
+            ok = false;
+            break;
+        }
+        int after = c->depth[pc] - pops + pushes;
+        if (after > *max_depth) *max_depth = after;
+        
+        size_t successors[2];
+        int successor_count = 0;
+        if (instr->op == BC_JUMP || instr->op == BC_JUMP_IF_FALSE) {
+            if (instr->a < 0 || (size_t)instr->a >= count) {
+                ok = false;
+                break;
+            }
+            successors[successor_count++] = (size_t)instr->a;
+            c->leader[instr->a] = true;
+        }
+        if (instr->op != BC_JUMP && instr->op != BC_RETURN && instr->op != BC_POP_FRAME && pc + 1 < count) {
+            successors[successor_count++] = pc + 1;
+        }
+        for (int i = 0; i < successor_count; i++) {
+            size_t next = successors[i];
+            if (c->depth[next] < 0) {
+                c->depth[next] = after;
+                worklist[pending++] = next;
+            } else if (c->depth[next] != after) {
+                ok = false;
+            }
+        }
+    }
+    
+    shared_free_safe(worklist, "register_vm", "reg_tier_analyze", 0);
+    return ok;
+}
+
+static uint8_t reg_tier_binary_opcode(BytecodeOp op) {
+    switch (op) {
+        case BC_ADD: return REG_ADDF_RR;
+        case BC_SUB: return REG_SUBF_RR;
+        case BC_MUL: return REG_MULF_RR;
+        case BC_DIV: return REG_DIVF_RR;
+        case BC_MOD: return REG_MODF_RR;
+        case BC_EQ: return REG_EQ_RR;
+        case BC_NE: return REG_NE_RR;
+        case BC_LT: return REG_LT_RR;
+        case BC_LE: return REG_LE_RR;
+        case BC_GT: return REG_GT_RR;
+        case BC_GE: return REG_GE_RR;
+        case BC_AND: return REG_AND_RR;
+        default: return REG_OR_RR;
+    }
+}
+
+// Lower one reachable instruction
+static void reg_tier_lower(RegTierCompiler* c, size_t pc, bool* live) {
+    const BytecodeInstruction* instr = &c->func->code[pc];
+    RegisterProgram* program = c->program;
+    
+    switch (bytecode_generic_op(instr->op)) {
+        case BC_PUSH_FRAME:
+        case BC_LOOP_START:
+        case BC_LOOP_END:
+            break;
+            
+        case BC_LOAD_CONST:
+            c->stack[c->stack_size].reg = reg_tier_constant(c, instr->a);
+            c->stack[c->stack_size].borrowed = true;
+            c->stack_size++;
+            c->last_def = -1;
+            break;
+            
+        case BC_LOAD_LOCAL:
+            c->stack[c->stack_size].reg = (uint8_t)instr->a;
+            c->stack[c->stack_size].borrowed = true;
+            c->stack_size++;
+            c->last_def = -1;
+            break;
+            
+        case BC_STORE_LOCAL: {
+            uint8_t local = (uint8_t)instr->a;
+            RegTierOperand value = c->stack[--c->stack_size];
+            // Pending reads of the old value must happen before it is overwritten
+            for (int i = 0; i < c->stack_size; i++) {
+                if (c->stack[i].borrowed && c->stack[i].reg == local) {
+                    reg_tier_materialize(c, i);
+                }
+            }
+            if (value.borrowed) {
+                if (value.reg != local) {
+                    reg_tier_emit(c, REG_COPY_RR, local, value.reg, 0, 0);
+                }
+            } else if (c->last_def >= 0 && (size_t)c->last_def + 1 == program->instruction_count) {
+                program->instructions[c->last_def].dst = local;
+            } else {
+                reg_tier_emit(c, REG_MOV_RR, local, value.reg, 0, 0);
+            }
+            c->last_def = -1;
+            break;
+        }
+            
+        case BC_ADD: case BC_SUB: case BC_MUL: case BC_DIV: case BC_MOD:
+        case BC_EQ: case BC_NE: case BC_LT: case BC_LE: case BC_GT: case BC_GE:
+        case BC_AND: case BC_OR: {
+            RegTierOperand b = c->stack[--c->stack_size];
+            RegTierOperand a = c->stack[--c->stack_size];
+            reg_tier_emit(c, reg_tier_binary_opcode(bytecode_generic_op(instr->op)), reg_tier_temp(c, c->stack_size), a.reg, b.reg, 0);
+            reg_tier_push_temp(c);
+            c->last_def = (long)program->instruction_count - 1;
+            break;
+        }
+            
+        case BC_NOT: {
+            RegTierOperand a = c->stack[--c->stack_size];
+            reg_tier_emit(c, REG_NOT_R, reg_tier_temp(c, c->stack_size), a.reg, 0, 0);
+            reg_tier_push_temp(c);
+            c->last_def = (long)program->instruction_count - 1;
+            break;
+        }
+            
+        case BC_DUP: {
+            RegTierOperand top = c->stack[c->stack_size - 1];
+            if (top.borrowed) {
+                c->stack[c->stack_size++] = top;
+            } else {
+                reg_tier_emit(c, REG_COPY_RR, reg_tier_temp(c, c->stack_size), top.reg, 0, 0);
+                reg_tier_push_temp(c);
+            }
+            c->last_def = -1;
+            break;
+        }
+            
+        case BC_POP: {
+            RegTierOperand top = c->stack[--c->stack_size];
+            if (!top.borrowed) {
+                reg_tier_emit(c, REG_RELEASE_R, top.reg, 0, 0, 0);
+            }
+            c->last_def = -1;
+            break;
+        }
+            
+        case BC_JUMP:
+            reg_tier_materialize_all(c);
+            reg_tier_emit(c, REG_JUMP, 0, 0, 0, (uint32_t)instr->a);
+            *live = false;
+            break;
+            
+        case BC_JUMP_IF_FALSE: {
+            RegTierOperand condition = c->stack[--c->stack_size];
+            bool fused = !condition.borrowed && c->last_def >= 0 &&
+                         (size_t)c->last_def + 1 == program->instruction_count &&
+                         reg_tier_is_compare(program->instructions[c->last_def].opcode);
+            RegisterInstruction compare = {0};
+            if (fused) {
+                // The comparison's operands sit at the top two depths, which
+                // materializing the rest of the stack never writes
+                compare = program->instructions[--program->instruction_count];
+            }
+            reg_tier_materialize_all(c);
+            if (fused) {
+                uint8_t opcode = (uint8_t)(REG_JUMP_IF_NOT_EQ + (compare.opcode - REG_EQ_RR));
+                reg_tier_emit(c, opcode, 0, compare.src1, compare.src2, (uint32_t)instr->a);
+            } else {
+                reg_tier_emit(c, REG_JUMP_IF_FALSE, 0, condition.reg, 0, (uint32_t)instr->a);
+            }
+            c->last_def = -1;
+            break;
+        }
+            
+        case BC_CALL_USER_FUNCTION: {
+            int arg_count = instr->b;
+            int arg_base = c->stack_size - arg_count;
+            for (int i = arg_base; i < c->stack_size; i++) {
+                reg_tier_materialize(c, i);
+            }
+            RegisterInstruction call = {0};
+            call.opcode = REG_CALL;
+            call.dst = reg_tier_temp(c, arg_base);
+            call.src1 = reg_tier_temp(c, arg_base);
+            call.immediate = (uint32_t)instr->a;
+            call.offset = (uint16_t)arg_count;
+            if (!register_program_add_instruction(program, call)) {
+                c->failed = true;
+            }
+            c->stack_size = arg_base;
+            reg_tier_push_temp(c);
+            c->last_def = (long)program->instruction_count - 1;
+            break;
+        }
+            
+        case BC_RETURN:
+        case BC_POP_FRAME:
+            if (instr->a > 0 && c->stack_size > 0) {
+                RegTierOperand value = c->stack[--c->stack_size];
+                reg_tier_emit(c, REG_RETURN, 0, value.reg, 0, 0);
+            } else {
+                reg_tier_emit(c, REG_RETURN_NULL, 0, 0, 0, 0);
+            }
+            *live = false;
+            break;
+            
+        default:
+            c->failed = true;
+            break;
+    }
+}
+
+RegisterProgram* register_tier_compile(const BytecodeFunction* func, const BytecodeProgram* owner) {
+    if (!func || !owner || !func->code || func->code_count == 0 ||
+        !func->uses_frame_slots || func->needs_environment ||
+        func->local_count >= REG_TIER_MAX_REGISTERS) {
+        reg_tier_stats.functions_rejected++;
+        return NULL;
+    }
+    
+    size_t count = func->code_count;
+    RegTierCompiler c;
+    memset(&c, 0, sizeof(c));
+    c.func = func;
+    c.owner = owner;
+    c.last_def = -1;
+    c.depth = shared_malloc_safe(count * sizeof(int), "register_vm", "register_tier_compile", 0);
+    c.leader = shared_malloc_safe(count * sizeof(bool), "register_vm", "register_tier_compile", 0);
+    c.const_source = shared_malloc_safe(REG_TIER_MAX_REGISTERS * sizeof(int), "register_vm", "register_tier_compile", 0);
+    size_t* pc_map = shared_malloc_safe(count * sizeof(size_t), "register_vm", "register_tier_compile", 0);
+    c.program = register_program_create();
+    
+    int max_depth = 0;
+    bool ok = c.depth && c.leader && c.const_source && pc_map && c.program;
+    if (ok) {
+        for (size_t pc = 0; pc < count; pc++) {
+            c.depth[pc] = -1;
+            c.leader[pc] = false;
+            pc_map[pc] = SIZE_MAX;
+        }
+        ok = reg_tier_analyze(&c, &max_depth);
+    }
+    
+    if (ok) {
+        // Constant registers are allocated while lowering; reserve room for
+        // every distinct LOAD_CONST before placing the temporaries
+        size_t load_consts = 0;
+        for (size_t pc = 0; pc < count; pc++) {
+            if (c.depth[pc] >= 0 && func->code[pc].op == BC_LOAD_CONST) load_consts++;
+        }
+        RegisterProgram* program = c.program;
+        program->is_function = 1;
+        program->parameter_count = func->param_count;
+        program->local_count = func->local_count;
+        program->temp_base = func->local_count + (load_consts < REG_TIER_MAX_REGISTERS ? load_consts : REG_TIER_MAX_REGISTERS);
+        ok = program->temp_base + (size_t)max_depth <= REG_TIER_MAX_REGISTERS;
+    }
+    
+    if (ok) {
+        bool live = true;
+        for (size_t pc = 0; pc < count && !c.failed; pc++) {
+            if (c.depth[pc] < 0) continue;
+            if (c.leader[pc] || !live) {
+                if (live) {
+                    reg_tier_materialize_all(&c);
+                } else {
+                    // Reached only by jumps, which arrive with every operand in its temporary
+                    c.stack_size = 0;
+                    for (int i = 0; i < c.depth[pc]; i++) reg_tier_push_temp(&c);
+                }
+                c.last_def = -1;
+                live = true;
+            }
+            pc_map[pc] = c.program->instruction_count;
+            reg_tier_lower(&c, pc, &live);
+        }
+        if (live) {
+            reg_tier_emit(&c, REG_RETURN_NULL, 0, 0, 0, 0);
+        }
+        ok = !c.failed;
+    }
+    
+    if (ok) {
+        // Patch jump targets from stack pcs to instruction indices
+        RegisterProgram* program = c.program;
+        for (size_t i = 0; i < program->instruction_count; i++) {
+            RegisterInstruction* instr = &program->instructions[i];
+            if (instr->opcode == REG_JUMP || instr->opcode == REG_JUMP_IF_FALSE ||
+                (instr->opcode >= REG_JUMP_IF_NOT_EQ && instr->opcode <= REG_JUMP_IF_NOT_GE)) {
+                instr->immediate = (uint32_t)pc_map[instr->immediate];
+            }
+        }
+        // Loop headers with an empty operand stack can be entered mid-call
+        for (size_t pc = 0; pc < count; pc++) {
+            if (!(c.leader[pc] && c.depth[pc] == 0)) pc_map[pc] = SIZE_MAX;
+        }
+        program->entry_points = pc_map;
+        program->entry_point_count = count;
+        program->register_count = program->temp_base + (size_t)max_depth;
+        program->max_registers = program->register_count;
+        pc_map = NULL;
+        reg_tier_stats.functions_compiled++;
+    } else {
+        register_program_free(c.program);
+        c.program = NULL;
+        reg_tier_stats.functions_rejected++;
+    }
+    
+    shared_free_safe(c.depth, "register_vm", "register_tier_compile", 0);
+    shared_free_safe(c.leader, "register_vm", "register_tier_compile", 0);
+    shared_free_safe(c.const_source, "register_vm", "register_tier_compile", 0);
+    shared_free_safe(pc_map, "register_vm", "register_tier_compile", 0);
+    return c.program;
+}
+
+// ----------------------------------------------------------------------------
+// Register tier execution
+// ----------------------------------------------------------------------------
+
+static inline void reg_tier_set(NanBoxedValue* reg, NanBoxedValue word) {
+    if (UNLIKELY(nan_boxing_is_cell(*reg))) {
+        nan_boxing_release(*reg);
+    }
+    *reg = word;
+}
+
+// A temporary read by an instruction is consumed unless it is also written
+static inline void reg_tier_consume(NanBoxedValue* regs, size_t temp_base, uint8_t src, uint8_t dst) {
+    if (src >= temp_base && src != dst) {
+        nan_boxing_release(regs[src]);
+        regs[src] = NAN_BOX_NULL_VALUE;
+    }
+}
+
+static bool reg_tier_truthy(Value* value) {
+    if (value->type == VALUE_BOOLEAN) {
+        return value->data.boolean_value;
+    }
+    Value as_boolean = value_to_boolean(value);
+    bool truthy = as_boolean.type == VALUE_BOOLEAN && as_boolean.data.boolean_value;
+    value_free(&as_boolean);
+    return truthy;
+}
+
+// JUMP_IF_FALSE only jumps on a value that converts to false
+static bool reg_tier_falsy(Value* value) {
+    if (value->type == VALUE_BOOLEAN) {
+        return !value->data.boolean_value;
+    }
+    Value as_boolean = value_to_boolean(value);
+    bool falsy = as_boolean.type == VALUE_BOOLEAN && !as_boolean.data.boolean_value;
+    value_free(&as_boolean);
+    return falsy;
+}
+
+// Generic operations with the stack VM's semantics for non-numbers
+static Value reg_tier_not_equal(Value* a, Value* b) {
+    Value eq = value_equal(a, b);
+    Value result = value_logical_not(&eq);
+    value_free(&eq);
+    return result;
+}
+
+static Value reg_tier_less_equal(Value* a, Value* b) {
+    Value lt = value_less_than(a, b);
+    Value eq = value_equal(a, b);
+    Value result = value_logical_or(&lt, &eq);
+    value_free(&lt);
+    value_free(&eq);
+    return result;
+}
+
+static Value reg_tier_greater_equal(Value* a, Value* b) {
+    Value gt = value_greater_than(a, b);
+    Value eq = value_equal(a, b);
+    Value result = value_logical_or(&gt, &eq);
+    value_free(&gt);
+    value_free(&eq);
+    return result;
+}
+
+static Value reg_tier_and(Value* a, Value* b) {
+    return value_create_boolean(reg_tier_truthy(a) && reg_tier_truthy(b));
+}
+
+static Value reg_tier_or(Value* a, Value* b) {
+    return value_create_boolean(reg_tier_truthy(a) || reg_tier_truthy(b));
+}
+
+typedef Value (*RegTierBinaryOp)(Value* a, Value* b);
+
+static RegTierBinaryOp reg_tier_generic_op(uint8_t opcode) {
+    switch (opcode) {
+        case REG_ADDF_RR: return value_add;
+        case REG_SUBF_RR: return value_subtract;
+        case REG_MULF_RR: return value_multiply;
+        case REG_DIVF_RR: return value_divide;
+        case REG_MODF_RR: return value_modulo;
+        case REG_EQ_RR: case REG_JUMP_IF_NOT_EQ: return value_equal;
+        case REG_NE_RR: case REG_JUMP_IF_NOT_NE: return reg_tier_not_equal;
+        case REG_LT_RR: case REG_JUMP_IF_NOT_LT: return value_less_than;
+        case REG_LE_RR: case REG_JUMP_IF_NOT_LE: return reg_tier_less_equal;
+        case REG_GT_RR: case REG_JUMP_IF_NOT_GT: return value_greater_than;
+        case REG_GE_RR: case REG_JUMP_IF_NOT_GE: return reg_tier_greater_equal;
+        case REG_AND_RR: return reg_tier_and;
+        default: return reg_tier_or;
+    }
+}
+
+// Slow path of a binary instruction: operands that are not both numbers
+static Value reg_tier_binary_generic(NanBoxedValue* regs, size_t temp_base, const RegisterInstruction* instr, uint8_t dst) {
+    Value a = nan_boxing_peek(regs[instr->src1]);
+    Value b = nan_boxing_peek(regs[instr->src2]);
+    Value result = reg_tier_generic_op(instr->opcode)(&a, &b);
+    reg_tier_consume(regs, temp_base, instr->src1, dst);
+    reg_tier_consume(regs, temp_base, instr->src2, dst);
+    return result;
+}
+
+#if defined(__GNUC__) && !defined(MYCO_VM_NO_COMPUTED_GOTO)
+#define REG_TIER_COMPUTED_GOTO 1
+#define REG_TIER_CASE(op) case op: reg_op_##op:
+#define REG_TIER_DISPATCH() __extension__ ({ goto *reg_tier_dispatch_table[ip->opcode]; })
+#else
+#define REG_TIER_COMPUTED_GOTO 0
+#define REG_TIER_CASE(op) case op:
+#define REG_TIER_DISPATCH() goto dispatch
+#endif
+#define REG_TIER_NEXT() do { ip++; executed++; REG_TIER_DISPATCH(); } while (0)
+#define REG_TIER_JUMP(target) do { ip = code + (target); executed++; REG_TIER_DISPATCH(); } while (0)
+
+#define REG_TIER_ARITH(op, expr) \
+    REG_TIER_CASE(op) { \
+        NanBoxedValue a = regs[ip->src1]; \
+        NanBoxedValue b = regs[ip->src2]; \
+        if (LIKELY(nan_boxing_is_number(a) && nan_boxing_is_number(b))) { \
+            double x = nan_boxing_get_number(a); \
+            double y = nan_boxing_get_number(b); \
+            reg_tier_set(&regs[ip->dst], expr); \
+        } else { \
+            Value result = reg_tier_binary_generic(regs, temp_base, ip, ip->dst); \
+            reg_tier_set(&regs[ip->dst], nan_boxing_box(result)); \
+        } \
+        REG_TIER_NEXT(); \
+    }
+
+#define REG_TIER_BRANCH(op, cmp) \
+    REG_TIER_CASE(op) { \
+        NanBoxedValue a = regs[ip->src1]; \
+        NanBoxedValue b = regs[ip->src2]; \
+        bool holds; \
+        if (LIKELY(nan_boxing_is_number(a) && nan_boxing_is_number(b))) { \
+            holds = nan_boxing_get_number(a) cmp nan_boxing_get_number(b); \
+        } else { \
+            Value result = reg_tier_binary_generic(regs, temp_base, ip, REG_TIER_NO_REGISTER); \
+            holds = !reg_tier_falsy(&result); \
+            value_free(&result); \
+        } \
+        if (!holds) REG_TIER_JUMP(ip->immediate); \
+        REG_TIER_NEXT(); \
+    }
+
+// Move slot words into the local registers and materialize the constants
+void register_tier_load_registers(const RegisterProgram* program, NanBoxedValue* regs,
+                                   NanBoxedValue* slots, size_t slot_count) {
+    size_t local_count = program->local_count;
+    size_t register_count = program->register_count;
+    
+    for (size_t i = 0; i < local_count; i++) {
+        regs[i] = i < slot_count ? slots[i] : NAN_BOX_NULL_VALUE;
+    }
+    for (size_t i = local_count; i < slot_count; i++) {
+        nan_boxing_release(slots[i]);
+    }
+    for (size_t i = 0; i < program->constant_count; i++) {
+        Value* constant = &program->constants[i];
+        switch (constant->type) {
+            case VALUE_NUMBER: regs[local_count + i] = nan_boxing_create_number(constant->data.number_value); break;
+            case VALUE_BOOLEAN: regs[local_count + i] = nan_boxing_create_boolean(constant->data.boolean_value); break;
+            case VALUE_NULL: regs[local_count + i] = NAN_BOX_NULL_VALUE; break;
+            default: regs[local_count + i] = nan_boxing_box(value_clone(constant)); break;
+        }
+    }
+    for (size_t i = local_count + program->constant_count; i < register_count; i++) {
+        regs[i] = NAN_BOX_NULL_VALUE;
+    }
+}
+
+void register_tier_release_registers(const RegisterProgram* program, NanBoxedValue* regs) {
+    for (size_t i = 0; i < program->register_count; i++) {
+        if (nan_boxing_is_cell(regs[i])) {
+            nan_boxing_release(regs[i]);
+        }
+    }
+}
+
+// Run register code from an instruction index; returns the result word
+NanBoxedValue register_tier_run(RegisterProgram* program, Interpreter* interpreter, struct BytecodeProgram* owner,
+                                NanBoxedValue* regs, size_t entry) {
+    size_t temp_base = program->temp_base;
+    const RegisterInstruction* code = program->instructions;
+    const RegisterInstruction* ip = code + entry;
+    uint64_t executed = 1;
+    NanBoxedValue result = NAN_BOX_NULL_VALUE;
+    
+    // Baseline JIT code runs first; a failed type guard hands the frame back
+    // at the instruction that could not run natively
+    if (program->native_code) {
+        size_t resume = micro_jit_execute_register_program(program, regs, entry, &result);
+        if (resume == SIZE_MAX) {
+            executed = 0;
+            goto done;
+        }
+        ip = code + resume;
+    }
+    
+#if REG_TIER_COMPUTED_GOTO
+    // Only opcodes emitted by register_tier_compile and register_tier_compile_trace appear here
+    __extension__ static const void* reg_tier_dispatch_table[REG_OPCODE_COUNT] = {
+        [REG_MOV_RR] = &&reg_op_REG_MOV_RR,
+        [REG_COPY_RR] = &&reg_op_REG_COPY_RR,
+        [REG_ADDF_RR] = &&reg_op_REG_ADDF_RR,
+        [REG_SUBF_RR] = &&reg_op_REG_SUBF_RR,
+        [REG_MULF_RR] = &&reg_op_REG_MULF_RR,
+        [REG_DIVF_RR] = &&reg_op_REG_DIVF_RR,
+        [REG_MODF_RR] = &&reg_op_REG_MODF_RR,
+        [REG_EQ_RR] = &&reg_op_REG_EQ_RR,
+        [REG_NE_RR] = &&reg_op_REG_NE_RR,
+        [REG_LT_RR] = &&reg_op_REG_LT_RR,
+        [REG_LE_RR] = &&reg_op_REG_LE_RR,
+        [REG_GT_RR] = &&reg_op_REG_GT_RR,
+        [REG_GE_RR] = &&reg_op_REG_GE_RR,
+        [REG_JUMP] = &&reg_op_REG_JUMP,
+        [REG_JUMP_IF_FALSE] = &&reg_op_REG_JUMP_IF_FALSE,
+        [REG_CALL] = &&reg_op_REG_CALL,
+        [REG_RETURN] = &&reg_op_REG_RETURN,
+        [REG_RETURN_NULL] = &&reg_op_REG_RETURN_NULL,
+        [REG_NOT_R] = &&reg_op_REG_NOT_R,
+        [REG_AND_RR] = &&reg_op_REG_AND_RR,
+        [REG_OR_RR] = &&reg_op_REG_OR_RR,
+        [REG_RELEASE_R] = &&reg_op_REG_RELEASE_R,
+        [REG_JUMP_IF_NOT_EQ] = &&reg_op_REG_JUMP_IF_NOT_EQ,
+        [REG_JUMP_IF_NOT_NE] = &&reg_op_REG_JUMP_IF_NOT_NE,
+        [REG_JUMP_IF_NOT_LT] = &&reg_op_REG_JUMP_IF_NOT_LT,
+        [REG_JUMP_IF_NOT_LE] = &&reg_op_REG_JUMP_IF_NOT_LE,
+        [REG_JUMP_IF_NOT_GT] = &&reg_op_REG_JUMP_IF_NOT_GT,
+        [REG_JUMP_IF_NOT_GE] = &&reg_op_REG_JUMP_IF_NOT_GE,
+        [REG_GUARD_NUMBER] = &&reg_op_REG_GUARD_NUMBER,
+        [REG_GUARD_BOOLEAN] = &&reg_op_REG_GUARD_BOOLEAN,
+    };
+#else
+dispatch:
+#endif
+    switch (ip->opcode) {
+        REG_TIER_CASE(REG_MOV_RR) {
+            reg_tier_set(&regs[ip->dst], regs[ip->src1]);
+            regs[ip->src1] = NAN_BOX_NULL_VALUE;
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_CASE(REG_COPY_RR) {
+            reg_tier_set(&regs[ip->dst], nan_boxing_clone(regs[ip->src1]));
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_ARITH(REG_ADDF_RR, nan_boxing_create_number(x + y))
+        REG_TIER_ARITH(REG_SUBF_RR, nan_boxing_create_number(x - y))
+        REG_TIER_ARITH(REG_MULF_RR, nan_boxing_create_number(x * y))
+        REG_TIER_ARITH(REG_DIVF_RR, y == 0.0 ? NAN_BOX_NULL_VALUE : nan_boxing_create_number(x / y))
+        REG_TIER_ARITH(REG_MODF_RR, y == 0.0 ? NAN_BOX_NULL_VALUE : nan_boxing_create_number(fmod(x, y)))
+        REG_TIER_ARITH(REG_EQ_RR, nan_boxing_create_boolean(x == y))
+        REG_TIER_ARITH(REG_NE_RR, nan_boxing_create_boolean(x != y))
+        REG_TIER_ARITH(REG_LT_RR, nan_boxing_create_boolean(x < y))
+        REG_TIER_ARITH(REG_LE_RR, nan_boxing_create_boolean(x <= y))
+        REG_TIER_ARITH(REG_GT_RR, nan_boxing_create_boolean(x > y))
+        REG_TIER_ARITH(REG_GE_RR, nan_boxing_create_boolean(x >= y))
+        
+        REG_TIER_BRANCH(REG_JUMP_IF_NOT_EQ, ==)
+        REG_TIER_BRANCH(REG_JUMP_IF_NOT_NE, !=)
+        REG_TIER_BRANCH(REG_JUMP_IF_NOT_LT, <)
+        REG_TIER_BRANCH(REG_JUMP_IF_NOT_LE, <=)
+        REG_TIER_BRANCH(REG_JUMP_IF_NOT_GT, >)
+        REG_TIER_BRANCH(REG_JUMP_IF_NOT_GE, >=)
+        
+        REG_TIER_CASE(REG_AND_RR)
+        REG_TIER_CASE(REG_OR_RR) {
+            NanBoxedValue a = regs[ip->src1];
+            NanBoxedValue b = regs[ip->src2];
+            if (LIKELY(nan_boxing_is_boolean(a) && nan_boxing_is_boolean(b))) {
+                int x = nan_boxing_get_boolean(a);
+                int y = nan_boxing_get_boolean(b);
+                reg_tier_set(&regs[ip->dst], nan_boxing_create_boolean(ip->opcode == REG_AND_RR ? (x && y) : (x || y)));
+            } else {
+                Value value = reg_tier_binary_generic(regs, temp_base, ip, ip->dst);
+                reg_tier_set(&regs[ip->dst], nan_boxing_box(value));
+            }
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_CASE(REG_NOT_R) {
+            NanBoxedValue a = regs[ip->src1];
+            bool truthy;
+            if (LIKELY(nan_boxing_is_boolean(a))) {
+                truthy = nan_boxing_get_boolean(a);
+            } else {
+                Value operand = nan_boxing_peek(a);
+                truthy = reg_tier_truthy(&operand);
+                reg_tier_consume(regs, temp_base, ip->src1, ip->dst);
+            }
+            reg_tier_set(&regs[ip->dst], nan_boxing_create_boolean(!truthy));
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_CASE(REG_RELEASE_R) {
+            nan_boxing_release(regs[ip->dst]);
+            regs[ip->dst] = NAN_BOX_NULL_VALUE;
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_CASE(REG_JUMP) {
+            REG_TIER_JUMP(ip->immediate);
+        }
+        
+        REG_TIER_CASE(REG_JUMP_IF_FALSE) {
+            NanBoxedValue condition = regs[ip->src1];
+            bool falsy;
+            if (LIKELY(nan_boxing_is_boolean(condition))) {
+                falsy = !nan_boxing_get_boolean(condition);
+            } else {
+                Value value = nan_boxing_peek(condition);
+                falsy = reg_tier_falsy(&value);
+                reg_tier_consume(regs, temp_base, ip->src1, REG_TIER_NO_REGISTER);
+            }
+            if (falsy) REG_TIER_JUMP(ip->immediate);
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_CASE(REG_CALL) {
+            int arg_count = ip->offset;
+            NanBoxedValue word = bytecode_call_user_function_words(interpreter, owner, (int)ip->immediate,
+                                                                   &regs[ip->src1], arg_count);
+            for (int i = 0; i < arg_count; i++) {
+                regs[ip->src1 + i] = NAN_BOX_NULL_VALUE;
+            }
+            reg_tier_set(&regs[ip->dst], word);
+            if (UNLIKELY(interpreter->has_error)) {
+                // Outside a try block the error has been reported and
+                // execution continues; inside one the stack VM skips the
+                // rest of the body, so the call returns null
+                if (interpreter->try_depth != 0) {
+                    goto done;
+                }
+                interpreter_clear_error(interpreter);
+            }
+            REG_TIER_NEXT();
+        }
+        
+        REG_TIER_CASE(REG_RETURN) {
+            result = regs[ip->src1];
+            regs[ip->src1] = NAN_BOX_NULL_VALUE;
+            goto done;
+        }
+        
+        REG_TIER_CASE(REG_RETURN_NULL) {
+            goto done;
+        }
+        
+        REG_TIER_CASE(REG_GUARD_NUMBER)
+        REG_TIER_CASE(REG_GUARD_BOOLEAN) {
+            if (UNLIKELY(!loop_trace_guard_holds(ip->opcode, regs[ip->src1]))) REG_TIER_JUMP(ip->immediate);
+            REG_TIER_NEXT();
+        }
+        
+        default:
+            goto done;
+    }
+    
+done:
+    reg_tier_stats.instructions += executed;
+    return result;
+}
+
+Value register_tier_execute(RegisterProgram* program, Interpreter* interpreter, struct BytecodeProgram* owner,
+                            NanBoxedValue* slots, size_t slot_count, size_t entry) {
+    NanBoxedValue regs[REG_TIER_MAX_REGISTERS];
+    register_tier_load_registers(program, regs, slots, slot_count);
+    if (entry != 0) {
+        reg_tier_stats.loop_entries++;
+    }
+    NanBoxedValue result = register_tier_run(program, interpreter, owner, regs, entry);
+    register_tier_release_registers(program, regs);
+    return nan_boxing_unbox(result);
+}
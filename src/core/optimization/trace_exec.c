@@ -0,0 +1,104 @@
+#include "../../include/core/optimization/register_vm.h"
+#include "../../include/core/optimization/trace_recorder.h"
+#include "../../include/utils/shared_utilities.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// LOOP TRACE LOWERING AND EXECUTION
+// ============================================================================
+
+// Loop traces keep their own register numbering (see trace_recorder.h);
+// lowering renumbers it into the tier's layout, with hoisted invariants
+// below temp_base so generic paths never consume them.
+RegisterProgram* register_tier_compile_trace(const LoopTrace* trace) {
+    if (!trace || trace->count == 0 || trace->loop_start > trace->count) {
+        return NULL;
+    }
+    
+    int map[REG_TIER_MAX_REGISTERS];
+    size_t next = 0;
+    size_t constants = 0;
+    for (int kind = LOOP_TRACE_LOCAL; kind <= LOOP_TRACE_TEMP; kind++) {
+        if (kind == LOOP_TRACE_INVARIANT) next += trace->exit_count;  // Exit pcs follow the constants
+        for (size_t r = 0; r < trace->register_count; r++) {
+            if ((int)trace->registers[r].kind != kind) continue;
+            map[r] = (int)next++;
+            if (kind == LOOP_TRACE_CONSTANT) constants++;
+        }
+    }
+    size_t local_count = 0;
+    for (size_t r = 0; r < trace->register_count; r++) {
+        if (trace->registers[r].kind == LOOP_TRACE_LOCAL) local_count++;
+    }
+    size_t temps = 0;
+    for (size_t r = 0; r < trace->register_count; r++) {
+        if (trace->registers[r].kind == LOOP_TRACE_TEMP) temps++;
+    }
+    if (next > REG_TIER_MAX_REGISTERS) {
+        return NULL;
+    }
+    
+    RegisterProgram* program = register_program_create();
+    if (!program) return NULL;
+    program->local_count = local_count;
+    program->temp_base = next - temps;
+    program->register_count = next;
+    program->max_registers = next;
+    program->traceable = 1;
+    
+    // Constant registers in order, then one per side exit
+    bool ok = true;
+    for (size_t r = 0; r < trace->register_count && ok; r++) {
+        if (trace->registers[r].kind != LOOP_TRACE_CONSTANT) continue;
+        Value constant = nan_boxing_unbox(trace->registers[r].value);
+        ok = register_program_add_constant(program, constant) >= 0;
+    }
+    for (size_t i = 0; i < trace->exit_count && ok; i++) {
+        ok = register_program_add_constant(program, value_create_number((double)trace->exits[i].pc)) >= 0;
+    }
+    
+    // Trace instructions keep their indices; exits without a branch get a
+    // stub after the code
+    size_t stubs = trace->count;
+    for (size_t i = 0; i < trace->count && ok; i++) {
+        RegisterInstruction instr = trace->code[i];
+        instr.dst = (uint8_t)map[instr.dst < trace->register_count ? instr.dst : 0];
+        instr.src1 = (uint8_t)map[instr.src1 < trace->register_count ? instr.src1 : 0];
+        instr.src2 = (uint8_t)map[instr.src2 < trace->register_count ? instr.src2 : 0];
+        if (instr.opcode == REG_JUMP_IF_FALSE || instr.opcode == REG_GUARD_NUMBER ||
+            instr.opcode == REG_GUARD_BOOLEAN ||
+            (instr.opcode >= REG_JUMP_IF_NOT_EQ && instr.opcode <= REG_JUMP_IF_NOT_GE)) {
+            const LoopTraceExit* exit = &trace->exits[instr.immediate];
+            instr.immediate = (uint32_t)(exit->target != SIZE_MAX ? exit->target : stubs + instr.immediate);
+        } else if (instr.opcode == REG_JUMP) {
+            instr.immediate = (uint32_t)trace->loop_start;
+        }
+        ok = register_program_add_instruction(program, instr) != 0;
+    }
+    for (size_t i = 0; i < trace->exit_count && ok; i++) {
+        RegisterInstruction exit = {0};
+        exit.opcode = REG_RETURN;
+        exit.src1 = (uint8_t)(local_count + constants + i);
+        ok = register_program_add_instruction(program, exit) != 0;
+    }
+    
+    if (!ok) {
+        register_program_free(program);
+        return NULL;
+    }
+    return program;
+}
+
+Value register_tier_execute_trace(RegisterProgram* program, Interpreter* interpreter, struct BytecodeProgram* owner,
+                                  NanBoxedValue* slots, size_t slot_count) {
+    NanBoxedValue regs[REG_TIER_MAX_REGISTERS];
+    register_tier_load_registers(program, regs, slots, slot_count);
+    NanBoxedValue result = register_tier_run(program, interpreter, owner, regs, 0);
+    for (size_t i = 0; i < slot_count && i < program->local_count; i++) {
+        slots[i] = regs[i];
+        regs[i] = NAN_BOX_NULL_VALUE;
+    }
+    register_tier_release_registers(program, regs);
+    return nan_boxing_unbox(result);
+}
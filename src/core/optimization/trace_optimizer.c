@@ -916,3 +916,245 @@ uint32_t trace_optimizer_import_optimized_trace(TraceOptimizerContext* context,
     
     return 0;
 }
+
+// ============================================================================
+// BYTECODE LOOP TRACES
+// ============================================================================
+// Three passes over a recorded iteration:
+//   1. Constant folding: operations on constant registers become constants.
+//   2. Guard elimination: types flow forward from the entry types the VM
+//      checks; a local keeps its entry type across the back edge when the
+//      iteration ends with the same type, so guards on it become redundant.
+//   3. LICM: operations and guards reading only constants, invariants and
+//      locals the trace never writes move into a preheader.
+// Folding and hoisting replace a temporary by another register until the
+// temporary is written again.
+
+static bool loop_trace_is_binary(uint8_t opcode) {
+    switch (opcode) {
+        case REG_ADDF_RR: case REG_SUBF_RR: case REG_MULF_RR: case REG_DIVF_RR: case REG_MODF_RR:
+        case REG_EQ_RR: case REG_NE_RR: case REG_LT_RR: case REG_LE_RR: case REG_GT_RR: case REG_GE_RR:
+        case REG_AND_RR: case REG_OR_RR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool loop_trace_is_compare_branch(uint8_t opcode) {
+    return opcode >= REG_JUMP_IF_NOT_EQ && opcode <= REG_JUMP_IF_NOT_GE;
+}
+
+static bool loop_trace_is_guard(uint8_t opcode) {
+    return opcode == REG_JUMP_IF_FALSE || opcode == REG_GUARD_NUMBER || opcode == REG_GUARD_BOOLEAN ||
+           loop_trace_is_compare_branch(opcode);
+}
+
+static bool loop_trace_defines(uint8_t opcode) {
+    return loop_trace_is_binary(opcode) || opcode == REG_NOT_R || opcode == REG_COPY_RR || opcode == REG_MOV_RR;
+}
+
+// Point an instruction's operands at the registers replacing them
+static void loop_trace_substitute(const LoopTrace* trace, RegisterInstruction* instr, const int* rename) {
+    bool two = loop_trace_is_binary(instr->opcode) || loop_trace_is_compare_branch(instr->opcode);
+    bool one = two || instr->opcode == REG_NOT_R || instr->opcode == REG_COPY_RR ||
+               instr->opcode == REG_MOV_RR || loop_trace_is_guard(instr->opcode);
+    if (one && rename[instr->src1] >= 0) instr->src1 = (uint8_t)rename[instr->src1];
+    if (two && rename[instr->src2] >= 0) instr->src2 = (uint8_t)rename[instr->src2];
+    // A move clears its source, which must stay a temporary
+    if (instr->opcode == REG_MOV_RR && trace->registers[instr->src1].kind != LOOP_TRACE_TEMP) {
+        instr->opcode = REG_COPY_RR;
+    }
+}
+
+static bool loop_trace_reads_only(const RegisterInstruction* instr, const bool* invariant) {
+    bool two = loop_trace_is_binary(instr->opcode) || loop_trace_is_compare_branch(instr->opcode);
+    return invariant[instr->src1] && (!two || invariant[instr->src2]);
+}
+
+static void loop_trace_fold(LoopTrace* trace, LoopTraceStats* stats) {
+    int rename[REG_TIER_MAX_REGISTERS];
+    for (size_t i = 0; i < REG_TIER_MAX_REGISTERS; i++) rename[i] = -1;
+    
+    size_t out = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        RegisterInstruction instr = trace->code[i];
+        loop_trace_substitute(trace, &instr, rename);
+        const LoopTraceRegister* a = &trace->registers[instr.src1];
+        const LoopTraceRegister* b = &trace->registers[instr.src2];
+        
+        NanBoxedValue value;
+        bool folded = false;
+        if (loop_trace_is_binary(instr.opcode) || loop_trace_is_compare_branch(instr.opcode)) {
+            uint8_t opcode = loop_trace_is_compare_branch(instr.opcode)
+                ? (uint8_t)(REG_EQ_RR + (instr.opcode - REG_JUMP_IF_NOT_EQ)) : instr.opcode;
+            folded = a->kind == LOOP_TRACE_CONSTANT && b->kind == LOOP_TRACE_CONSTANT &&
+                     loop_trace_evaluate(opcode, a->value, b->value, &value);
+        } else if (instr.opcode == REG_NOT_R || instr.opcode == REG_JUMP_IF_FALSE) {
+            folded = a->kind == LOOP_TRACE_CONSTANT && nan_boxing_is_boolean(a->value);
+            value = nan_boxing_create_boolean(instr.opcode == REG_NOT_R ? !nan_boxing_get_boolean(a->value)
+                                                                        : nan_boxing_get_boolean(a->value));
+        }
+        
+        if (folded && loop_trace_is_guard(instr.opcode)) {
+            // A guard that always holds goes; one that always fails stays
+            if (nan_boxing_get_boolean(value)) {
+                stats->guards_eliminated++;
+                continue;
+            }
+        } else if (folded) {
+            int constant = loop_trace_constant(trace, value);
+            if (constant >= 0) {
+                stats->constants_folded++;
+                if (trace->registers[instr.dst].kind == LOOP_TRACE_TEMP) {
+                    rename[instr.dst] = constant;
+                    continue;
+                }
+                instr.opcode = REG_COPY_RR;
+                instr.src1 = (uint8_t)constant;
+                instr.src2 = 0;
+            }
+        }
+        if (loop_trace_defines(instr.opcode)) rename[instr.dst] = -1;
+        trace->code[out++] = instr;
+    }
+    trace->count = out;
+}
+
+// Type an instruction leaves in its destination (VALUE_NULL = unknown)
+static ValueType loop_trace_result_type(const RegisterInstruction* instr, const ValueType* types) {
+    ValueType a = types[instr->src1];
+    ValueType b = types[instr->src2];
+    switch (instr->opcode) {
+        case REG_ADDF_RR: case REG_SUBF_RR: case REG_MULF_RR:
+            return a == VALUE_NUMBER && b == VALUE_NUMBER ? VALUE_NUMBER : VALUE_NULL;
+        case REG_EQ_RR: case REG_NE_RR: case REG_LT_RR: case REG_LE_RR: case REG_GT_RR: case REG_GE_RR:
+            return a != VALUE_NULL && a == b ? VALUE_BOOLEAN : VALUE_NULL;
+        case REG_AND_RR: case REG_OR_RR:
+            return a == VALUE_BOOLEAN && b == VALUE_BOOLEAN ? VALUE_BOOLEAN : VALUE_NULL;
+        case REG_NOT_R:
+            return VALUE_BOOLEAN;
+        case REG_COPY_RR: case REG_MOV_RR:
+            return a;
+        default:
+            return VALUE_NULL;  // Division and modulo yield null for a zero divisor
+    }
+}
+
+static void loop_trace_transfer(const RegisterInstruction* instr, ValueType* types) {
+    if (loop_trace_defines(instr->opcode)) {
+        ValueType type = loop_trace_result_type(instr, types);
+        if (instr->opcode == REG_MOV_RR) types[instr->src1] = VALUE_NULL;
+        types[instr->dst] = type;
+    } else if (instr->opcode == REG_GUARD_NUMBER) {
+        types[instr->src1] = VALUE_NUMBER;
+    } else if (instr->opcode == REG_GUARD_BOOLEAN) {
+        types[instr->src1] = VALUE_BOOLEAN;
+    }
+}
+
+static void loop_trace_eliminate_guards(LoopTrace* trace, LoopTraceStats* stats) {
+    ValueType entry[REG_TIER_MAX_REGISTERS];
+    ValueType types[REG_TIER_MAX_REGISTERS];
+    for (size_t r = 0; r < trace->register_count; r++) {
+        const LoopTraceRegister* reg = &trace->registers[r];
+        entry[r] = VALUE_NULL;
+        if (reg->kind == LOOP_TRACE_CONSTANT) entry[r] = nan_boxing_get_type(reg->value);
+        if (reg->kind == LOOP_TRACE_LOCAL && reg->live_in) entry[r] = reg->entry_type;
+    }
+    
+    // Iterate to a fixed point over the back edge
+    bool changed = true;
+    while (changed) {
+        memcpy(types, entry, trace->register_count * sizeof(ValueType));
+        for (size_t i = 0; i < trace->count; i++) {
+            loop_trace_transfer(&trace->code[i], types);
+        }
+        changed = false;
+        for (size_t r = 0; r < trace->register_count; r++) {
+            if (trace->registers[r].kind == LOOP_TRACE_LOCAL && entry[r] != VALUE_NULL && types[r] != entry[r]) {
+                entry[r] = VALUE_NULL;
+                changed = true;
+            }
+        }
+    }
+    
+    memcpy(types, entry, trace->register_count * sizeof(ValueType));
+    size_t out = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        RegisterInstruction instr = trace->code[i];
+        if ((instr.opcode == REG_GUARD_NUMBER && types[instr.src1] == VALUE_NUMBER) ||
+            (instr.opcode == REG_GUARD_BOOLEAN && types[instr.src1] == VALUE_BOOLEAN)) {
+            stats->guards_eliminated++;
+            continue;
+        }
+        loop_trace_transfer(&instr, types);
+        trace->code[out++] = instr;
+    }
+    trace->count = out;
+}
+
+static int loop_trace_hoist(LoopTrace* trace, LoopTraceStats* stats) {
+    bool invariant[REG_TIER_MAX_REGISTERS];
+    int rename[REG_TIER_MAX_REGISTERS];
+    for (size_t r = 0; r < REG_TIER_MAX_REGISTERS; r++) {
+        const LoopTraceRegister* reg = &trace->registers[r];
+        invariant[r] = r < trace->register_count &&
+                       (reg->kind == LOOP_TRACE_CONSTANT || reg->kind == LOOP_TRACE_INVARIANT ||
+                        (reg->kind == LOOP_TRACE_LOCAL && !reg->written));
+        rename[r] = -1;
+    }
+    
+    // Hoisted guards leave before the iteration starts, back at the header
+    int header_exit = -1;
+    
+    RegisterInstruction* preheader = shared_malloc_safe((trace->count + 1) * sizeof(RegisterInstruction),
+                                                        "trace_optimizer", "loop_trace_hoist", 0);
+    if (!preheader) return 0;
+    size_t hoisted = 0;
+    size_t out = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        RegisterInstruction instr = trace->code[i];
+        loop_trace_substitute(trace, &instr, rename);
+        
+        if (loop_trace_defines(instr.opcode) && instr.opcode != REG_MOV_RR &&
+            trace->registers[instr.dst].kind == LOOP_TRACE_TEMP && loop_trace_reads_only(&instr, invariant)) {
+            int reg = loop_trace_add_register(trace, LOOP_TRACE_INVARIANT);
+            if (reg >= 0) {
+                rename[instr.dst] = reg;
+                invariant[reg] = true;
+                instr.dst = (uint8_t)reg;
+                preheader[hoisted++] = instr;
+                continue;
+            }
+        } else if (loop_trace_is_guard(instr.opcode) && loop_trace_reads_only(&instr, invariant)) {
+            if (header_exit < 0) header_exit = loop_trace_add_exit(trace, trace->header_pc);
+            if (header_exit < 0) {
+                shared_free_safe(preheader, "trace_optimizer", "loop_trace_hoist", 0);
+                return 0;
+            }
+            instr.immediate = (uint32_t)header_exit;
+            preheader[hoisted++] = instr;
+            continue;
+        }
+        if (loop_trace_defines(instr.opcode)) rename[instr.dst] = -1;
+        trace->code[out++] = instr;
+    }
+    
+    // Preheader first, then the iteration
+    memmove(trace->code + hoisted, trace->code, out * sizeof(RegisterInstruction));
+    memcpy(trace->code, preheader, hoisted * sizeof(RegisterInstruction));
+    trace->count = hoisted + out;
+    trace->loop_start = hoisted;
+    stats->instructions_hoisted += hoisted;
+    shared_free_safe(preheader, "trace_optimizer", "loop_trace_hoist", 0);
+    return 1;
+}
+
+int loop_trace_optimize(LoopTrace* trace) {
+    if (!trace || trace->loop_start != 0) return 0;
+    LoopTraceStats* stats = loop_trace_stats();
+    loop_trace_fold(trace, stats);
+    loop_trace_eliminate_guards(trace, stats);
+    return loop_trace_hoist(trace, stats);
+}
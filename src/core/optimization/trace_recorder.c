@@ -1,9 +1,12 @@
 #include "../../include/core/optimization/trace_recorder.h"
+#include "../../include/core/bytecode.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <math.h>
 
 // ============================================================================
 // TRACE RECORDER IMPLEMENTATION
@@ -624,3 +627,672 @@ uint32_t trace_recorder_import_trace(TraceRecorderContext* context, const char*
     
     return 0;
 }
+
+// ============================================================================
+// BYTECODE LOOP TRACES
+// ============================================================================
+// The recorder replays one iteration of a loop over the locals' current
+// values. Each operand carries the value it has in this iteration, which
+// decides the branches the trace follows, and the register holding it in the
+// trace. Lowering mirrors register_tier_compile: loads borrow the local or
+// constant register, results go to one temporary per stack depth, and a
+// store retargets the instruction that computed its value. Locals are only
+// written with empty operand stacks, so a borrowed operand never outlives
+// the value it reads.
+
+static MYCO_THREAD_LOCAL LoopTraceStats loop_trace_statistics;  // Per thread
+
+LoopTraceStats* loop_trace_stats(void) {
+    return &loop_trace_statistics;
+}
+
+typedef struct {
+    uint8_t reg;                   // Register holding the operand
+    bool borrowed;                 // reg is a local or constant read in place
+    NanBoxedValue value;           // Value in the recorded iteration
+} LoopTraceOperand;
+
+typedef struct {
+    LoopTrace* trace;
+    const BytecodeProgram* program;
+    const NanBoxedValue* locals;
+    int* local_registers;          // Slot -> register (-1 = not referenced yet)
+    int temp_registers[2][LOOP_TRACE_MAX_DEPTH]; // Value / numeric stack depth -> register
+    LoopTraceOperand stack[LOOP_TRACE_MAX_DEPTH];
+    int stack_size;
+    LoopTraceOperand num_stack[LOOP_TRACE_MAX_DEPTH];
+    int num_stack_size;
+    long last_def;                 // Instruction whose result is on top of the stack
+    size_t statement_pc;           // Pc where the current statement began
+    bool failed;
+} LoopTraceRecorder;
+
+int loop_trace_add_register(LoopTrace* trace, LoopTraceRegisterKind kind) {
+    if (trace->register_count >= REG_TIER_MAX_REGISTERS) return -1;
+    LoopTraceRegister* reg = &trace->registers[trace->register_count];
+    memset(reg, 0, sizeof(*reg));
+    reg->kind = kind;
+    reg->slot = -1;
+    reg->value = NAN_BOX_NULL_VALUE;
+    reg->entry_type = VALUE_NULL;
+    return (int)trace->register_count++;
+}
+
+int loop_trace_constant(LoopTrace* trace, NanBoxedValue value) {
+    for (size_t i = 0; i < trace->register_count; i++) {
+        if (trace->registers[i].kind == LOOP_TRACE_CONSTANT && trace->registers[i].value == value) {
+            return (int)i;
+        }
+    }
+    int reg = loop_trace_add_register(trace, LOOP_TRACE_CONSTANT);
+    if (reg >= 0) trace->registers[reg].value = value;
+    return reg;
+}
+
+int loop_trace_emit(LoopTrace* trace, RegisterInstruction instr) {
+    if (trace->count == trace->capacity) {
+        size_t capacity = trace->capacity ? trace->capacity * 2 : 64;
+        RegisterInstruction* grown = shared_realloc_safe(trace->code, capacity * sizeof(RegisterInstruction),
+                                                         "trace_recorder", "loop_trace_emit", 0);
+        if (!grown) return 0;
+        trace->code = grown;
+        trace->capacity = capacity;
+    }
+    trace->code[trace->count++] = instr;
+    return 1;
+}
+
+bool loop_trace_evaluate(uint8_t opcode, NanBoxedValue a, NanBoxedValue b, NanBoxedValue* result) {
+    if (nan_boxing_is_number(a) && nan_boxing_is_number(b)) {
+        double x = nan_boxing_get_number(a);
+        double y = nan_boxing_get_number(b);
+        switch (opcode) {
+            case REG_ADDF_RR: *result = nan_boxing_create_number(x + y); return true;
+            case REG_SUBF_RR: *result = nan_boxing_create_number(x - y); return true;
+            case REG_MULF_RR: *result = nan_boxing_create_number(x * y); return true;
+            case REG_DIVF_RR: *result = nan_boxing_create_number(x / y); return y != 0.0;
+            case REG_MODF_RR: *result = nan_boxing_create_number(fmod(x, y)); return y != 0.0;
+            case REG_EQ_RR: *result = nan_boxing_create_boolean(x == y); return true;
+            case REG_NE_RR: *result = nan_boxing_create_boolean(x != y); return true;
+            case REG_LT_RR: *result = nan_boxing_create_boolean(x < y); return true;
+            case REG_LE_RR: *result = nan_boxing_create_boolean(x <= y); return true;
+            case REG_GT_RR: *result = nan_boxing_create_boolean(x > y); return true;
+            case REG_GE_RR: *result = nan_boxing_create_boolean(x >= y); return true;
+            default: return false;
+        }
+    }
+    if (nan_boxing_is_boolean(a) && nan_boxing_is_boolean(b)) {
+        int x = nan_boxing_get_boolean(a);
+        int y = nan_boxing_get_boolean(b);
+        switch (opcode) {
+            case REG_EQ_RR: *result = nan_boxing_create_boolean(x == y); return true;
+            case REG_NE_RR: *result = nan_boxing_create_boolean(x != y); return true;
+            case REG_AND_RR: *result = nan_boxing_create_boolean(x && y); return true;
+            case REG_OR_RR: *result = nan_boxing_create_boolean(x || y); return true;
+            default: return false;
+        }
+    }
+    return false;
+}
+
+void loop_trace_free(LoopTrace* trace) {
+    if (!trace) return;
+    if (trace->program) {
+        register_program_free(trace->program);
+    }
+    shared_free_safe(trace->code, "trace_recorder", "loop_trace_free", 0);
+    shared_free_safe(trace->registers, "trace_recorder", "loop_trace_free", 0);
+    shared_free_safe(trace->exits, "trace_recorder", "loop_trace_free", 0);
+    shared_free_safe(trace, "trace_recorder", "loop_trace_free", 0);
+}
+
+static void loop_trace_emit_op(LoopTraceRecorder* r, uint8_t opcode, uint8_t dst, uint8_t src1, uint8_t src2, uint32_t immediate) {
+    RegisterInstruction instr = {0};
+    instr.opcode = opcode;
+    instr.dst = dst;
+    instr.src1 = src1;
+    instr.src2 = src2;
+    instr.immediate = immediate;
+    if (!loop_trace_emit(r->trace, instr)) r->failed = true;
+}
+
+int loop_trace_add_exit(LoopTrace* trace, size_t pc) {
+    for (size_t i = 0; i < trace->exit_count; i++) {
+        if (trace->exits[i].pc == pc) return (int)i;
+    }
+    LoopTraceExit* grown = shared_realloc_safe(trace->exits, (trace->exit_count + 1) * sizeof(LoopTraceExit),
+                                               "trace_recorder", "loop_trace_add_exit", 0);
+    if (!grown) return -1;
+    trace->exits = grown;
+    LoopTraceExit* exit = &trace->exits[trace->exit_count];
+    memset(exit, 0, sizeof(*exit));
+    exit->pc = pc;
+    exit->target = SIZE_MAX;
+    return (int)trace->exit_count++;
+}
+
+static uint32_t loop_trace_exit(LoopTraceRecorder* r, size_t pc) {
+    int exit = loop_trace_add_exit(r->trace, pc);
+    if (exit < 0) {
+        r->failed = true;
+        return 0;
+    }
+    return (uint32_t)exit;
+}
+
+static int loop_trace_local(LoopTraceRecorder* r, int slot) {
+    if (slot < 0 || (size_t)slot >= r->program->local_slot_count) {
+        r->failed = true;
+        return -1;
+    }
+    if (r->local_registers[slot] >= 0) return r->local_registers[slot];
+    int reg = loop_trace_add_register(r->trace, LOOP_TRACE_LOCAL);
+    if (reg < 0) {
+        r->failed = true;
+        return -1;
+    }
+    r->trace->registers[reg].slot = slot;
+    r->trace->registers[reg].value = r->locals[slot];
+    r->local_registers[slot] = reg;
+    return reg;
+}
+
+// Read a local; the first read before any write fixes the type the trace
+// must be entered with
+static int loop_trace_read_local(LoopTraceRecorder* r, int slot) {
+    int reg = loop_trace_local(r, slot);
+    if (reg < 0) return -1;
+    LoopTraceRegister* local = &r->trace->registers[reg];
+    if (!nan_boxing_is_number(local->value) && !nan_boxing_is_boolean(local->value)) {
+        r->failed = true;
+        return -1;
+    }
+    if (!local->written && !local->live_in) {
+        local->live_in = true;
+        local->entry_type = nan_boxing_get_type(local->value);
+    }
+    return reg;
+}
+
+static void loop_trace_write_local(LoopTraceRecorder* r, int reg, NanBoxedValue value) {
+    r->trace->registers[reg].written = true;
+    r->trace->registers[reg].value = value;
+}
+
+static void loop_trace_guard_type(LoopTraceRecorder* r, int reg, NanBoxedValue value, size_t exit_pc) {
+    uint8_t opcode = nan_boxing_is_number(value) ? REG_GUARD_NUMBER : REG_GUARD_BOOLEAN;
+    loop_trace_emit_op(r, opcode, 0, (uint8_t)reg, 0, loop_trace_exit(r, exit_pc));
+}
+
+static int loop_trace_temp(LoopTraceRecorder* r, int stack, int depth) {
+    if (depth >= LOOP_TRACE_MAX_DEPTH) {
+        r->failed = true;
+        return -1;
+    }
+    if (r->temp_registers[stack][depth] < 0) {
+        r->temp_registers[stack][depth] = loop_trace_add_register(r->trace, LOOP_TRACE_TEMP);
+        if (r->temp_registers[stack][depth] < 0) r->failed = true;
+    }
+    return r->temp_registers[stack][depth];
+}
+
+static void loop_trace_push(LoopTraceRecorder* r, int stack, int reg, bool borrowed, NanBoxedValue value) {
+    LoopTraceOperand* operands = stack ? r->num_stack : r->stack;
+    int* size = stack ? &r->num_stack_size : &r->stack_size;
+    if (reg < 0 || *size >= LOOP_TRACE_MAX_DEPTH) {
+        r->failed = true;
+        return;
+    }
+    operands[*size].reg = (uint8_t)reg;
+    operands[*size].borrowed = borrowed;
+    operands[*size].value = value;
+    (*size)++;
+}
+
+static bool loop_trace_pop(LoopTraceRecorder* r, int stack, LoopTraceOperand* operand) {
+    LoopTraceOperand* operands = stack ? r->num_stack : r->stack;
+    int* size = stack ? &r->num_stack_size : &r->stack_size;
+    if (*size == 0) {
+        r->failed = true;
+        return false;
+    }
+    *operand = operands[--(*size)];
+    return true;
+}
+
+static uint8_t loop_trace_binary_opcode(BytecodeOp op) {
+    switch (op) {
+        case BC_ADD: case BC_ADD_NUM: return REG_ADDF_RR;
+        case BC_SUB: case BC_SUB_NUM: return REG_SUBF_RR;
+        case BC_MUL: case BC_MUL_NUM: return REG_MULF_RR;
+        case BC_DIV: return REG_DIVF_RR;
+        case BC_MOD: return REG_MODF_RR;
+        case BC_EQ: case BC_EQ_NUM: return REG_EQ_RR;
+        case BC_NE: case BC_NE_NUM: return REG_NE_RR;
+        case BC_LT: case BC_LT_NUM: return REG_LT_RR;
+        case BC_LE: case BC_LE_NUM: return REG_LE_RR;
+        case BC_GT: case BC_GT_NUM: return REG_GT_RR;
+        case BC_GE: case BC_GE_NUM: return REG_GE_RR;
+        case BC_AND: return REG_AND_RR;
+        default: return REG_OR_RR;
+    }
+}
+
+// Binary operation popping from one stack and pushing onto another
+static void loop_trace_binary(LoopTraceRecorder* r, BytecodeOp op, int from, int to) {
+    LoopTraceOperand a, b;
+    if (!loop_trace_pop(r, from, &b) || !loop_trace_pop(r, from, &a)) return;
+    uint8_t opcode = loop_trace_binary_opcode(op);
+    NanBoxedValue result;
+    if (!loop_trace_evaluate(opcode, a.value, b.value, &result)) {
+        r->failed = true;
+        return;
+    }
+    int dst = loop_trace_temp(r, to, to ? r->num_stack_size : r->stack_size);
+    if (dst < 0) return;
+    loop_trace_emit_op(r, opcode, (uint8_t)dst, a.reg, b.reg, 0);
+    r->last_def = (long)r->trace->count - 1;
+    if (opcode == REG_DIVF_RR || opcode == REG_MODF_RR) {
+        // Division by zero yields null, which traces do not carry
+        loop_trace_guard_type(r, dst, result, r->statement_pc);
+        r->last_def = -1;
+    }
+    loop_trace_push(r, to, dst, false, result);
+}
+
+// Guard that the recorded branch is taken again. When both operand stacks
+// are empty the exit resumes at the other branch target, otherwise at the
+// start of the statement, whose operands have no side effects to repeat.
+static void loop_trace_branch(LoopTraceRecorder* r, const BytecodeInstruction* instr, size_t pc, size_t* next_pc) {
+    LoopTraceOperand condition;
+    if (!loop_trace_pop(r, 0, &condition)) return;
+    if (!nan_boxing_is_boolean(condition.value) || instr->a < 0 || (size_t)instr->a <= pc) {
+        r->failed = true;
+        return;
+    }
+    bool taken = !nan_boxing_get_boolean(condition.value);
+    bool at_statement = r->stack_size == 0 && r->num_stack_size == 0;
+    size_t exit_pc = at_statement ? (taken ? pc + 1 : (size_t)instr->a) : r->statement_pc;
+    uint32_t exit = loop_trace_exit(r, exit_pc);
+    
+    LoopTrace* trace = r->trace;
+    RegisterInstruction* last = r->last_def >= 0 && (size_t)r->last_def + 1 == trace->count ? &trace->code[r->last_def] : NULL;
+    if (last && !condition.borrowed && last->dst == condition.reg &&
+        last->opcode >= REG_EQ_RR && last->opcode <= REG_GE_RR) {
+        // Fuse with the comparison. Leaving when the inverted comparison
+        // fails also leaves on NaN operands, where the stack VM re-decides.
+        static const uint8_t stay[2][6] = {
+            {REG_JUMP_IF_NOT_EQ, REG_JUMP_IF_NOT_NE, REG_JUMP_IF_NOT_LT,
+             REG_JUMP_IF_NOT_LE, REG_JUMP_IF_NOT_GT, REG_JUMP_IF_NOT_GE},
+            {REG_JUMP_IF_NOT_NE, REG_JUMP_IF_NOT_EQ, REG_JUMP_IF_NOT_GE,
+             REG_JUMP_IF_NOT_GT, REG_JUMP_IF_NOT_LE, REG_JUMP_IF_NOT_LT}
+        };
+        last->opcode = stay[taken][last->opcode - REG_EQ_RR];
+        last->dst = 0;
+        last->immediate = exit;
+    } else if (!taken) {
+        loop_trace_emit_op(r, REG_JUMP_IF_FALSE, 0, condition.reg, 0, exit);
+    } else {
+        int inverted = loop_trace_temp(r, 0, r->stack_size);
+        if (inverted < 0) return;
+        loop_trace_emit_op(r, REG_NOT_R, (uint8_t)inverted, condition.reg, 0, 0);
+        loop_trace_emit_op(r, REG_JUMP_IF_FALSE, 0, (uint8_t)inverted, 0, exit);
+    }
+    r->last_def = -1;
+    *next_pc = taken ? (size_t)instr->a : pc + 1;
+    if (*next_pc > r->trace->loop_end) r->failed = true;  // The recorded iteration leaves the loop
+}
+
+// Record one bytecode instruction; returns false once the back edge is reached
+static bool loop_trace_step(LoopTraceRecorder* r, size_t* pc_io) {
+    const BytecodeProgram* program = r->program;
+    size_t pc = *pc_io;
+    const BytecodeInstruction* instr = &program->code[pc];
+    bool at_statement = r->stack_size == 0 && r->num_stack_size == 0;
+    if (at_statement) r->statement_pc = pc;
+    size_t next_pc = pc + 1;
+    // Quickened instructions record like the generic opcode they were rewritten from
+    BytecodeOp op = bytecode_generic_op(instr->op);
+    
+    switch (op) {
+        case BC_LOOP_END:
+            break;
+            
+        case BC_LOAD_CONST: {
+            if (instr->a < 0 || (size_t)instr->a >= program->const_count) {
+                r->failed = true;
+                break;
+            }
+            Value* constant = &program->constants[instr->a];
+            NanBoxedValue value;
+            if (constant->type == VALUE_NUMBER) {
+                value = nan_boxing_create_number(constant->data.number_value);
+            } else if (constant->type == VALUE_BOOLEAN) {
+                value = nan_boxing_create_boolean(constant->data.boolean_value);
+            } else {
+                r->failed = true;
+                break;
+            }
+            loop_trace_push(r, 0, loop_trace_constant(r->trace, value), true, value);
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_LOAD_NUM: {
+            if (instr->a < 0 || (size_t)instr->a >= program->num_const_count) {
+                r->failed = true;
+                break;
+            }
+            NanBoxedValue value = nan_boxing_create_number(program->num_constants[instr->a]);
+            loop_trace_push(r, 1, loop_trace_constant(r->trace, value), true, value);
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_LOAD_LOCAL: {
+            int reg = loop_trace_read_local(r, instr->a);
+            if (reg < 0) break;
+            NanBoxedValue value = r->trace->registers[reg].value;
+            loop_trace_guard_type(r, reg, value, r->statement_pc);
+            loop_trace_push(r, 0, reg, true, value);
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_STORE_LOCAL: {
+            LoopTraceOperand value;
+            if (r->stack_size != 1 || r->num_stack_size != 0 || !loop_trace_pop(r, 0, &value)) {
+                r->failed = true;
+                break;
+            }
+            int local = loop_trace_local(r, instr->a);
+            if (local < 0) break;
+            LoopTrace* trace = r->trace;
+            if (value.borrowed) {
+                if (value.reg != local) {
+                    loop_trace_emit_op(r, REG_COPY_RR, (uint8_t)local, value.reg, 0, 0);
+                }
+            } else if (r->last_def >= 0 && (size_t)r->last_def + 1 == trace->count) {
+                trace->code[r->last_def].dst = (uint8_t)local;
+            } else {
+                loop_trace_emit_op(r, REG_MOV_RR, (uint8_t)local, value.reg, 0, 0);
+            }
+            loop_trace_write_local(r, local, value.value);
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_ADD: case BC_SUB: case BC_MUL: case BC_DIV: case BC_MOD:
+        case BC_EQ: case BC_NE: case BC_LT: case BC_LE: case BC_GT: case BC_GE:
+        case BC_AND: case BC_OR:
+            loop_trace_binary(r, op, 0, 0);
+            break;
+            
+        case BC_ADD_NUM: case BC_SUB_NUM: case BC_MUL_NUM:
+            loop_trace_binary(r, instr->op, 1, 1);
+            break;
+            
+        case BC_EQ_NUM: case BC_NE_NUM: case BC_LT_NUM: case BC_LE_NUM: case BC_GT_NUM: case BC_GE_NUM:
+            loop_trace_binary(r, instr->op, 1, 0);
+            break;
+            
+        case BC_NUM_TO_VALUE: {
+            // Moves the top numeric operand and clears the numeric stack
+            LoopTraceOperand top;
+            if (!loop_trace_pop(r, 1, &top)) break;
+            r->num_stack_size = 0;
+            if (top.borrowed) {
+                loop_trace_push(r, 0, top.reg, true, top.value);
+                break;
+            }
+            int dst = loop_trace_temp(r, 0, r->stack_size);
+            if (dst < 0) break;
+            loop_trace_emit_op(r, REG_MOV_RR, (uint8_t)dst, top.reg, 0, 0);
+            loop_trace_push(r, 0, dst, false, top.value);
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_NOT: {
+            LoopTraceOperand operand;
+            if (!loop_trace_pop(r, 0, &operand)) break;
+            if (!nan_boxing_is_boolean(operand.value)) {
+                r->failed = true;
+                break;
+            }
+            int dst = loop_trace_temp(r, 0, r->stack_size);
+            if (dst < 0) break;
+            loop_trace_emit_op(r, REG_NOT_R, (uint8_t)dst, operand.reg, 0, 0);
+            loop_trace_push(r, 0, dst, false, nan_boxing_create_boolean(!nan_boxing_get_boolean(operand.value)));
+            r->last_def = (long)r->trace->count - 1;
+            break;
+        }
+            
+        case BC_DUP: {
+            LoopTraceOperand top;
+            if (!loop_trace_pop(r, 0, &top)) break;
+            loop_trace_push(r, 0, top.reg, top.borrowed, top.value);
+            if (top.borrowed) {
+                loop_trace_push(r, 0, top.reg, true, top.value);
+            } else {
+                int copy = loop_trace_temp(r, 0, r->stack_size);
+                if (copy < 0) break;
+                loop_trace_emit_op(r, REG_COPY_RR, (uint8_t)copy, top.reg, 0, 0);
+                loop_trace_push(r, 0, copy, false, top.value);
+            }
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_POP: {
+            // Numbers and booleans hold nothing to release
+            LoopTraceOperand top;
+            loop_trace_pop(r, 0, &top);
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_JUMP_IF_FALSE:
+            loop_trace_branch(r, instr, pc, &next_pc);
+            break;
+            
+        case BC_JUMP:
+            if (instr->a >= 0 && (size_t)instr->a == r->trace->header_pc && at_statement) {
+                return false;
+            }
+            if (instr->a < 0 || (size_t)instr->a <= pc || (size_t)instr->a > r->trace->loop_end) {
+                r->failed = true;  // Inner loop, a jump back into the body, or a break
+                break;
+            }
+            next_pc = (size_t)instr->a;
+            break;
+            
+        case BC_INC_LOCAL:
+        case BC_ADD_LOCAL_IMM: {
+            // The stack VM adds to num_locals; the trace keeps the local's
+            // number in its register and checks the two agree on entry
+            double imm = 1.0;
+            if (instr->op == BC_ADD_LOCAL_IMM) {
+                if (instr->b < 0 || (size_t)instr->b >= program->num_const_count) {
+                    r->failed = true;
+                    break;
+                }
+                imm = program->num_constants[instr->b];
+            }
+            int local = loop_trace_read_local(r, instr->a);
+            if (local < 0 || !at_statement) {
+                r->failed = true;
+                break;
+            }
+            LoopTraceRegister* reg = &r->trace->registers[local];
+            if (!nan_boxing_is_number(reg->value) ||
+                instr->a < 0 || (size_t)instr->a >= program->num_local_count) {
+                r->failed = true;
+                break;
+            }
+            if (!reg->written) reg->numeric_sync = true;
+            int constant = loop_trace_constant(r->trace, nan_boxing_create_number(imm));
+            if (constant < 0) {
+                r->failed = true;
+                break;
+            }
+            loop_trace_guard_type(r, local, reg->value, pc);
+            loop_trace_emit_op(r, REG_ADDF_RR, (uint8_t)local, (uint8_t)local, (uint8_t)constant, 0);
+            loop_trace_write_local(r, local, nan_boxing_create_number(nan_boxing_get_number(reg->value) + imm));
+            r->last_def = -1;
+            break;
+        }
+            
+        case BC_ADD_LLL: {
+            int left = loop_trace_read_local(r, instr->b);
+            int right = left >= 0 ? loop_trace_read_local(r, instr->c) : -1;
+            int local = right >= 0 ? loop_trace_local(r, instr->a) : -1;
+            if (local < 0 || !at_statement) {
+                r->failed = true;
+                break;
+            }
+            NanBoxedValue a = r->trace->registers[left].value;
+            NanBoxedValue b = r->trace->registers[right].value;
+            NanBoxedValue sum;
+            if (!loop_trace_evaluate(REG_ADDF_RR, a, b, &sum)) {
+                r->failed = true;
+                break;
+            }
+            loop_trace_guard_type(r, left, a, pc);
+            loop_trace_guard_type(r, right, b, pc);
+            loop_trace_emit_op(r, REG_ADDF_RR, (uint8_t)local, (uint8_t)left, (uint8_t)right, 0);
+            loop_trace_write_local(r, local, sum);
+            r->last_def = -1;
+            break;
+        }
+            
+        default:
+            // Calls, globals, containers, output, nested loops, ...
+            r->failed = true;
+            break;
+    }
+    
+    *pc_io = next_pc;
+    return !r->failed;
+}
+
+static void loop_trace_recorder_init(LoopTraceRecorder* r, LoopTrace* trace, const BytecodeProgram* program,
+                                     const NanBoxedValue* locals) {
+    memset(r, 0, sizeof(*r));
+    r->trace = trace;
+    r->program = program;
+    r->locals = locals;
+    r->last_def = -1;
+    for (int stack = 0; stack < 2; stack++) {
+        for (int depth = 0; depth < LOOP_TRACE_MAX_DEPTH; depth++) {
+            r->temp_registers[stack][depth] = -1;
+        }
+    }
+    r->local_registers = shared_malloc_safe((program->local_slot_count + 1) * sizeof(int),
+                                            "trace_recorder", "loop_trace_recorder_init", 0);
+    if (!r->local_registers) {
+        r->failed = true;
+        return;
+    }
+    for (size_t i = 0; i < program->local_slot_count; i++) {
+        r->local_registers[i] = -1;
+    }
+    for (size_t i = 0; i < trace->register_count; i++) {
+        LoopTraceRegister* reg = &trace->registers[i];
+        if (reg->kind == LOOP_TRACE_LOCAL && reg->slot >= 0 && (size_t)reg->slot < program->local_slot_count) {
+            r->local_registers[reg->slot] = (int)i;
+            reg->value = locals[reg->slot];
+        }
+    }
+}
+
+// Follow the bytecode from pc to the back edge; returns true once it is reached
+static bool loop_trace_follow(LoopTraceRecorder* r, size_t pc) {
+    for (int steps = 0; steps < LOOP_TRACE_MAX_LENGTH && !r->failed && pc < r->program->count; steps++) {
+        if (!loop_trace_step(r, &pc)) break;
+    }
+    shared_free_safe(r->local_registers, "trace_recorder", "loop_trace_follow", 0);
+    r->local_registers = NULL;
+    return !r->failed && pc < r->program->count && r->program->code[pc].op == BC_JUMP &&
+           (size_t)r->program->code[pc].a == r->trace->header_pc;
+}
+
+LoopTrace* loop_trace_record(const BytecodeProgram* program, size_t header_pc, const NanBoxedValue* locals) {
+    if (!program || !locals || header_pc >= program->count || program->code[header_pc].op != BC_LOOP_START) {
+        return NULL;
+    }
+    LoopTrace* trace = shared_malloc_safe(sizeof(LoopTrace), "trace_recorder", "loop_trace_record", 0);
+    if (!trace) return NULL;
+    memset(trace, 0, sizeof(LoopTrace));
+    trace->header_pc = header_pc;
+    for (size_t pc = header_pc + 1; pc < program->count; pc++) {
+        if (program->code[pc].op == BC_JUMP && program->code[pc].a == (int)header_pc) trace->loop_end = pc;
+    }
+    trace->registers = shared_malloc_safe(REG_TIER_MAX_REGISTERS * sizeof(LoopTraceRegister),
+                                          "trace_recorder", "loop_trace_record", 0);
+    
+    LoopTraceRecorder r;
+    loop_trace_recorder_init(&r, trace, program, locals);
+    bool closed = trace->registers && loop_trace_follow(&r, header_pc + 1);
+    if (closed) {
+        loop_trace_emit_op(&r, REG_JUMP, 0, 0, 0, 0);
+        closed = !r.failed;
+    }
+    if (!closed) {
+        loop_trace_free(trace);
+        loop_trace_statistics.traces_aborted++;
+        return NULL;
+    }
+    loop_trace_statistics.traces_recorded++;
+    return trace;
+}
+
+bool loop_trace_record_branch(LoopTrace* trace, const BytecodeProgram* program, size_t exit,
+                              const NanBoxedValue* locals) {
+    if (!trace || !program || !locals || exit >= trace->exit_count) return false;
+    LoopTraceExit* side_exit = &trace->exits[exit];
+    side_exit->branch_attempted = true;
+    size_t pc = side_exit->pc;
+    if (trace->branch_count >= LOOP_TRACE_MAX_BRANCHES || pc <= trace->header_pc || pc > trace->loop_end) {
+        return false;
+    }
+    
+    // Everything the branch touches is rolled back if it cannot be attached
+    LoopTraceRegister saved[REG_TIER_MAX_REGISTERS];
+    size_t saved_registers = trace->register_count;
+    size_t saved_count = trace->count;
+    size_t saved_exits = trace->exit_count;
+    memcpy(saved, trace->registers, saved_registers * sizeof(LoopTraceRegister));
+    
+    LoopTraceRecorder r;
+    loop_trace_recorder_init(&r, trace, program, locals);
+    size_t start = trace->count;
+    bool closed = loop_trace_follow(&r, pc);
+    for (size_t i = 0; i < saved_registers && closed; i++) {
+        // Hoisted code assumes locals the iteration never writes keep their values
+        if (saved[i].kind == LOOP_TRACE_LOCAL && !saved[i].written && trace->registers[i].written) closed = false;
+    }
+    for (size_t i = 0; i < trace->register_count && closed; i++) {
+        // Guards were eliminated on the entry types holding at every back edge
+        const LoopTraceRegister* reg = &trace->registers[i];
+        if (reg->kind == LOOP_TRACE_LOCAL && reg->live_in && reg->written) {
+            uint8_t opcode = reg->entry_type == VALUE_NUMBER ? REG_GUARD_NUMBER : REG_GUARD_BOOLEAN;
+            loop_trace_emit_op(&r, opcode, 0, (uint8_t)i, 0, loop_trace_exit(&r, trace->header_pc));
+        }
+    }
+    if (closed) {
+        loop_trace_emit_op(&r, REG_JUMP, 0, 0, 0, 0);
+        closed = !r.failed && trace->register_count + trace->exit_count <= REG_TIER_MAX_REGISTERS;
+    }
+    if (!closed) {
+        memcpy(trace->registers, saved, saved_registers * sizeof(LoopTraceRegister));
+        trace->register_count = saved_registers;
+        trace->count = saved_count;
+        trace->exit_count = saved_exits;
+        return false;
+    }
+    trace->exits[exit].target = start;
+    trace->branch_count++;
+    loop_trace_statistics.branches_recorded++;
+    return true;
+}
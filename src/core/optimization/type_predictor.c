@@ -1,5 +1,6 @@
 #include "../../include/core/optimization/type_predictor.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -618,3 +619,52 @@ int type_predictor_import_data(TypePredictorContext* context, const char* filena
     
     return 1;
 }
+
+// ============================================================================
+// BYTECODE TYPE FEEDBACK
+// ============================================================================
+// Feedback is a pair of kind masks per instruction. A site is quickened once
+// TYPE_FEEDBACK_WARMUP samples saw one kind per operand; mixing kinds or
+// failing quickened guards too often leaves it on the generic opcode, which
+// then stops sampling.
+
+static MYCO_THREAD_LOCAL TypeFeedbackStats type_feedback_statistics;  // Per thread
+
+TypeFeedbackStats* type_feedback_stats(void) {
+    return &type_feedback_statistics;
+}
+
+static int type_feedback_single_kind(uint8_t kinds) {
+    return kinds != 0 && (kinds & (kinds - 1)) == 0;
+}
+
+int type_feedback_observe(TypeFeedbackSlot* slot, TypeFeedbackKind left, TypeFeedbackKind right) {
+    if (!slot || slot->generic) return 0;
+    slot->left |= (uint8_t)left;
+    slot->right |= (uint8_t)right;
+    if (!type_feedback_single_kind(slot->left) || !type_feedback_single_kind(slot->right)) {
+        type_feedback_give_up(slot);
+        return 0;
+    }
+    if (++slot->samples < TYPE_FEEDBACK_WARMUP) return 0;
+    slot->samples = 0;
+    type_feedback_statistics.sites_quickened++;
+    return 1;
+}
+
+void type_feedback_deoptimize(TypeFeedbackSlot* slot) {
+    if (!slot) return;
+    type_feedback_statistics.deoptimizations++;
+    slot->left = 0;
+    slot->right = 0;
+    slot->samples = 0;
+    if (++slot->deopts >= TYPE_FEEDBACK_MAX_DEOPTS) {
+        type_feedback_give_up(slot);
+    }
+}
+
+void type_feedback_give_up(TypeFeedbackSlot* slot) {
+    if (!slot || slot->generic) return;
+    slot->generic = 1;
+    type_feedback_statistics.sites_generic++;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 
 // Type checker context management
 TypeCheckerContext* type_checker_create_context(void) {
@@ -837,7 +838,7 @@ static const char* type_kind_to_string_simple(MycoType* type) {
 const char* type_to_string(MycoType* type) {
     if (!type) return "Unknown";
     
-    static char buffer[256];
+    static MYCO_THREAD_LOCAL char buffer[256];  // Isolates type-check in parallel
     switch (type->kind) {
         case TYPE_ARRAY:
             if (type->data.element_type) {
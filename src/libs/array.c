@@ -4,6 +4,7 @@
 #include "../../include/core/ast.h"
 #include "../../include/core/standardized_errors.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 
 // Array utility functions
 Value builtin_array_push(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -72,7 +73,11 @@ Value builtin_array_pop(Interpreter* interpreter, Value* args, size_t arg_count,
         pop_index = (int)args[1].data.number_value;
     }
     
-    return value_array_pop(&array_arg, pop_index);
+    // value_array_pop detaches shared storage, so pop from our own reference
+    array_arg = value_clone(&args[0]);
+    Value result = value_array_pop(&array_arg, pop_index);
+    value_free(&array_arg);
+    return result;
 }
 
 Value builtin_array_insert(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -103,13 +108,19 @@ Value builtin_array_insert(Interpreter* interpreter, Value* args, size_t arg_cou
         return value_create_null();
     }
     
+    // Work on a private copy: args[0] may share storage with the caller's value
+    array_arg = value_clone(&args[0]);
+    value_make_unique(&array_arg);
+    
     // Clone the element
     Value cloned_element = value_clone(&element);
     
     // Expand array if needed
     if (array_len >= array_arg.data.array_value.capacity) {
         size_t new_capacity = array_arg.data.array_value.capacity == 0 ? 4 : array_arg.data.array_value.capacity * 2;
-        void** new_elements = shared_realloc_safe(array_arg.data.array_value.elements, new_capacity * sizeof(void*), "array", "unknown_function", 102);
+        void** new_elements = slab_realloc(array_arg.data.array_value.elements,
+                                           array_arg.data.array_value.capacity * sizeof(void*),
+                                           new_capacity * sizeof(void*));
         if (!new_elements) {
             std_error_report(ERROR_OUT_OF_MEMORY, "array", "unknown_function", "Out of memory in insert()", line, column);
             value_free(&cloned_element);
@@ -125,7 +136,7 @@ Value builtin_array_insert(Interpreter* interpreter, Value* args, size_t arg_cou
     }
     
     // Insert element
-    array_arg.data.array_value.elements[index] = shared_malloc_safe(sizeof(Value), "array", "unknown_function", 118);
+    array_arg.data.array_value.elements[index] = slab_alloc_value();
     if (!array_arg.data.array_value.elements[index]) {
         std_error_report(ERROR_OUT_OF_MEMORY, "array", "unknown_function", "Out of memory in insert()", line, column);
         value_free(&cloned_element);
@@ -135,7 +146,7 @@ Value builtin_array_insert(Interpreter* interpreter, Value* args, size_t arg_cou
     memcpy(array_arg.data.array_value.elements[index], &cloned_element, sizeof(Value));
     array_arg.data.array_value.count++;
     
-    return value_clone(&array_arg);
+    return array_arg;
 }
 
 Value builtin_array_remove(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -165,11 +176,15 @@ Value builtin_array_remove(Interpreter* interpreter, Value* args, size_t arg_cou
         return value_create_null();
     }
     
+    // Work on a private copy: args[0] may share storage with the caller's value
+    array_arg = value_clone(&args[0]);
+    value_make_unique(&array_arg);
+    
     // Free the element at the index
     Value* element = (Value*)array_arg.data.array_value.elements[index];
     if (element) {
         value_free(element);
-        shared_free_safe(element, "array", "unknown_function", 162);
+        slab_free(element);
     }
     
     // Shift remaining elements
@@ -179,7 +194,7 @@ Value builtin_array_remove(Interpreter* interpreter, Value* args, size_t arg_cou
     
     array_arg.data.array_value.count--;
     
-    return value_clone(&array_arg);
+    return array_arg;
 }
 
 Value builtin_array_reverse(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -197,6 +212,10 @@ Value builtin_array_reverse(Interpreter* interpreter, Value* args, size_t arg_co
     
     size_t array_len = array_arg.data.array_value.count;
     
+    // Work on a private copy: args[0] may share storage with the caller's value
+    array_arg = value_clone(&args[0]);
+    value_make_unique(&array_arg);
+    
     // Reverse the array in place
     for (size_t i = 0; i < array_len / 2; i++) {
         void* temp = array_arg.data.array_value.elements[i];
@@ -204,7 +223,7 @@ Value builtin_array_reverse(Interpreter* interpreter, Value* args, size_t arg_co
         array_arg.data.array_value.elements[array_len - 1 - i] = temp;
     }
     
-    return value_clone(&array_arg);
+    return array_arg;
 }
 
 Value builtin_array_sort(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -222,6 +241,10 @@ Value builtin_array_sort(Interpreter* interpreter, Value* args, size_t arg_count
     
     size_t array_len = array_arg.data.array_value.count;
     
+    // Work on a private copy: args[0] may share storage with the caller's value
+    array_arg = value_clone(&args[0]);
+    value_make_unique(&array_arg);
+    
     // Simple bubble sort for now
     for (size_t i = 0; i < array_len - 1; i++) {
         for (size_t j = 0; j < array_len - i - 1; j++) {
@@ -239,7 +262,7 @@ Value builtin_array_sort(Interpreter* interpreter, Value* args, size_t arg_count
         }
     }
     
-    return value_clone(&array_arg);
+    return array_arg;
 }
 
 Value builtin_array_filter(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -705,6 +728,10 @@ Value builtin_array_fill(Interpreter* interpreter, Value* args, size_t arg_count
         return value_create_null();
     }
     
+    // Work on a private copy: args[0] may share storage with the caller's value
+    array_arg = value_clone(&args[0]);
+    value_make_unique(&array_arg);
+    
     // Clear existing array and fill with new values
     array_arg.data.array_value.count = 0;
     
@@ -713,7 +740,7 @@ Value builtin_array_fill(Interpreter* interpreter, Value* args, size_t arg_count
         value_array_push(&array_arg, cloned_value);
     }
     
-    return value_clone(&array_arg);
+    return array_arg;
 }
 
 // Register array library with interpreter
@@ -65,6 +65,9 @@ void register_all_builtin_libraries(Interpreter* interpreter) {
     // Register gateway library
     gateway_library_register(interpreter);
 
+    // Register isolate library
+    isolate_library_register(interpreter);
+
     // Register arduino library (host-simulated, cross-platform)
     arduino_library_register(interpreter);
 
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <pthread.h>
 #include "../../include/utils/shared_utilities.h"
 
 // Custom compression implementation to replace zlib dependency
@@ -184,6 +185,1113 @@ static char* dict_decompress(const char* data, size_t data_size, size_t* decompr
     return output;
 }
 
+// ============================================================================
+// CHECKSUMS
+// ============================================================================
+
+static uint32_t g_crc32_table[256];
+static pthread_once_t g_crc32_once = PTHREAD_ONCE_INIT;
+
+static void crc32_table_init(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        g_crc32_table[n] = c;
+    }
+}
+
+unsigned long compression_crc32(unsigned long crc, const char* data, size_t data_size) {
+    pthread_once(&g_crc32_once, crc32_table_init);
+    uint32_t c = (uint32_t)crc ^ 0xFFFFFFFFu;
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < data_size; i++) {
+        c = g_crc32_table[(c ^ bytes[i]) & 0xFF] ^ (c >> 8);
+    }
+    return (unsigned long)(c ^ 0xFFFFFFFFu);
+}
+
+unsigned long compression_adler32(unsigned long adler, const char* data, size_t data_size) {
+    uint32_t a = (uint32_t)adler & 0xFFFF;
+    uint32_t b = ((uint32_t)adler >> 16) & 0xFFFF;
+    const unsigned char* bytes = (const unsigned char*)data;
+    while (data_size > 0) {
+        // 5552 is the most bytes that can be summed before b overflows
+        size_t run = data_size < 5552 ? data_size : 5552;
+        data_size -= run;
+        while (run-- > 0) {
+            a += *bytes++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (unsigned long)((b << 16) | a);
+}
+
+// ============================================================================
+// DEFLATE ENCODER
+// ============================================================================
+// LZ77 over a sliding 32 KiB window with hash chains, followed by Huffman
+// coding. Symbols are buffered per block; each block is written stored,
+// with the fixed codes or with dynamic codes, whichever is smallest.
+
+#define DEFLATE_WSIZE 32768
+#define DEFLATE_WMASK (DEFLATE_WSIZE - 1)
+#define DEFLATE_MIN_MATCH 3
+#define DEFLATE_MAX_MATCH 258
+#define DEFLATE_MIN_LOOKAHEAD (DEFLATE_MAX_MATCH + DEFLATE_MIN_MATCH + 1)
+#define DEFLATE_MAX_DIST (DEFLATE_WSIZE - DEFLATE_MIN_LOOKAHEAD)
+#define DEFLATE_TOO_FAR 4096        // A 3-byte match further back than this costs more than literals
+#define DEFLATE_HASH_BITS 15
+#define DEFLATE_HASH_SIZE (1 << DEFLATE_HASH_BITS)
+#define DEFLATE_SYMBOLS 16384       // Symbols buffered per block
+#define DEFLATE_LITLEN_CODES 286
+#define DEFLATE_DIST_CODES 30
+#define DEFLATE_CODELEN_CODES 19
+#define DEFLATE_MAX_BITS 15
+
+// Match search effort per level, as in zlib's configuration table
+typedef struct {
+    int good_length;  // Search less once a match this long is found
+    int max_lazy;     // Lazy levels: don't look further past a match this long
+                      // Greedy levels: only hash match bytes up to this length
+    int nice_length;  // Stop searching at a match this long
+    int max_chain;    // Hash chain entries examined per search
+    bool lazy;
+} DeflateLevelConfig;
+
+static const DeflateLevelConfig g_deflate_levels[10] = {
+    {0, 0, 0, 0, false},            // 0: stored blocks only
+    {4, 4, 8, 4, false},
+    {4, 5, 16, 8, false},
+    {4, 6, 32, 32, false},
+    {4, 4, 16, 16, true},
+    {8, 16, 32, 32, true},
+    {8, 16, 128, 128, true},
+    {8, 32, 128, 256, true},
+    {32, 128, 258, 1024, true},
+    {32, 258, 258, 4096, true},
+};
+
+static const uint8_t g_codelen_order[DEFLATE_CODELEN_CODES] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+struct DeflateStream {
+    CompressionType type;
+    int level;
+    DeflateLevelConfig config;
+
+    unsigned char window[2 * DEFLATE_WSIZE];
+    size_t window_fill;             // Bytes of input in window
+    size_t pos;                     // Next window position to encode
+    size_t block_start;             // Window position where the pending block starts
+    size_t block_length;            // Input bytes covered by the buffered symbols
+    uint32_t head[DEFLATE_HASH_SIZE];   // Most recent position + 1 per hash (0 = none)
+    uint32_t prev[DEFLATE_WSIZE];       // Previous position + 1 with the same hash
+
+    // Lazy matching state carried between calls
+    int match_length;
+    size_t match_dist;
+    bool match_available;
+
+    uint16_t sym_litlen[DEFLATE_SYMBOLS];   // Literal byte, or match length
+    uint16_t sym_dist[DEFLATE_SYMBOLS];     // Match distance, 0 for a literal
+    size_t sym_count;
+
+    unsigned char* out;
+    size_t out_size;
+    size_t out_capacity;
+    uint64_t bit_buffer;
+    int bit_count;
+    bool ok;                        // False after an allocation failure
+
+    unsigned long checksum;         // CRC-32 (gzip) or Adler-32 (zlib) of the input
+    uint64_t total_in;
+    bool header_written;
+    bool finished;
+};
+
+// Length code (257..285) for a match length of 3..258
+static int deflate_length_code(int length, int* extra_bits, int* extra_value) {
+    int l = length - DEFLATE_MIN_MATCH;
+    if (l < 8) {
+        *extra_bits = 0;
+        *extra_value = 0;
+        return 257 + l;
+    }
+    if (l == 255) {
+        *extra_bits = 0;
+        *extra_value = 0;
+        return 285;
+    }
+    int top = 31 - __builtin_clz((unsigned)l);
+    *extra_bits = top - 2;
+    *extra_value = l & ((1 << *extra_bits) - 1);
+    return 257 + 4 * (top - 1) + ((l >> *extra_bits) & 3);
+}
+
+// Distance code (0..29) for a distance of 1..32768
+static int deflate_dist_code(size_t dist, int* extra_bits, int* extra_value) {
+    unsigned d = (unsigned)dist - 1;
+    if (d < 4) {
+        *extra_bits = 0;
+        *extra_value = 0;
+        return (int)d;
+    }
+    int top = 31 - __builtin_clz(d);
+    *extra_bits = top - 1;
+    *extra_value = (int)(d & ((1u << *extra_bits) - 1));
+    return 2 * top + (int)((d >> (top - 1)) & 1);
+}
+
+// Bit output, least significant bit first as DEFLATE requires
+
+static void deflate_out_reserve(DeflateStream* s, size_t extra) {
+    if (!s->ok || s->out_size + extra <= s->out_capacity) return;
+    size_t capacity = s->out_capacity ? s->out_capacity * 2 : 4096;
+    while (capacity < s->out_size + extra) capacity *= 2;
+    unsigned char* grown = shared_realloc_safe(s->out, capacity, "compression", "deflate_out_reserve", 0);
+    if (!grown) {
+        s->ok = false;
+        return;
+    }
+    s->out = grown;
+    s->out_capacity = capacity;
+}
+
+static void deflate_put_byte(DeflateStream* s, unsigned char byte) {
+    deflate_out_reserve(s, 1);
+    if (s->ok) s->out[s->out_size++] = byte;
+}
+
+static void deflate_put_bits(DeflateStream* s, uint32_t value, int count) {
+    s->bit_buffer |= (uint64_t)value << s->bit_count;
+    s->bit_count += count;
+    while (s->bit_count >= 8) {
+        deflate_put_byte(s, (unsigned char)(s->bit_buffer & 0xFF));
+        s->bit_buffer >>= 8;
+        s->bit_count -= 8;
+    }
+}
+
+static void deflate_align_byte(DeflateStream* s) {
+    if (s->bit_count > 0) deflate_put_bits(s, 0, 8 - s->bit_count);
+}
+
+// Huffman code construction
+
+typedef struct {
+    uint32_t freq;
+    uint16_t symbol;
+} DeflateSymbolFreq;
+
+static int deflate_symbol_freq_compare(const void* a, const void* b) {
+    const DeflateSymbolFreq* x = (const DeflateSymbolFreq*)a;
+    const DeflateSymbolFreq* y = (const DeflateSymbolFreq*)b;
+    if (x->freq != y->freq) return x->freq < y->freq ? -1 : 1;
+    return (int)x->symbol - (int)y->symbol;
+}
+
+// Code lengths for frequencies sorted ascending, computed in place
+// (Moffat and Katajainen); on return freq[i] is the length of symbol i
+static void deflate_minimum_redundancy(uint32_t* a, int n) {
+    if (n == 1) {
+        a[0] = 1;
+        return;
+    }
+    a[0] += a[1];
+    int root = 0;
+    int leaf = 2;
+    for (int next = 1; next < n - 1; next++) {
+        if (leaf >= n || a[root] < a[leaf]) {
+            a[next] = a[root];
+            a[root++] = (uint32_t)next;
+        } else {
+            a[next] = a[leaf++];
+        }
+        if (leaf >= n || (root < next && a[root] < a[leaf])) {
+            a[next] += a[root];
+            a[root++] = (uint32_t)next;
+        } else {
+            a[next] += a[leaf++];
+        }
+    }
+    a[n - 2] = 0;
+    for (int next = n - 3; next >= 0; next--) a[next] = a[a[next]] + 1;
+
+    int available = 1;
+    int used = 0;
+    uint32_t depth = 0;
+    root = n - 2;
+    int next = n - 1;
+    while (available > 0) {
+        while (root >= 0 && a[root] == depth) {
+            used++;
+            root--;
+        }
+        while (available > used) {
+            a[next--] = depth;
+            available--;
+        }
+        available = 2 * used;
+        depth++;
+        used = 0;
+    }
+}
+
+// Length-limited Huffman code lengths for freq[0..count). At least two
+// symbols always get a code so every decoder accepts the tree.
+static void deflate_build_lengths(const uint32_t* freq, int count, int max_bits, uint8_t* lengths) {
+    DeflateSymbolFreq symbols[DEFLATE_LITLEN_CODES];
+    uint32_t sorted[DEFLATE_LITLEN_CODES];
+    int used = 0;
+    memset(lengths, 0, (size_t)count);
+    for (int i = 0; i < count; i++) {
+        if (freq[i]) {
+            symbols[used].freq = freq[i];
+            symbols[used].symbol = (uint16_t)i;
+            used++;
+        }
+    }
+    for (int i = 0; used < 2 && i < count; i++) {
+        if (!freq[i]) {
+            symbols[used].freq = 1;
+            symbols[used].symbol = (uint16_t)i;
+            used++;
+        }
+    }
+
+    if (used == 0) return;
+
+    qsort(symbols, (size_t)used, sizeof(DeflateSymbolFreq), deflate_symbol_freq_compare);
+    for (int i = 0; i < used; i++) sorted[i] = symbols[i].freq;
+    deflate_minimum_redundancy(sorted, used);
+
+    // Count codes per length, folding over-long codes into max_bits and
+    // then lengthening shorter codes until the Kraft sum is exact again
+    int length_count[33] = {0};
+    for (int i = 0; i < used; i++) {
+        int length = (int)sorted[i];
+        length_count[length > max_bits ? max_bits : length]++;
+    }
+    uint32_t total = 0;
+    for (int length = 1; length <= max_bits; length++) {
+        total += (uint32_t)length_count[length] << (max_bits - length);
+    }
+    while (total != (1u << max_bits)) {
+        length_count[max_bits]--;
+        for (int length = max_bits - 1; length > 0; length--) {
+            if (length_count[length]) {
+                length_count[length]--;
+                length_count[length + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    // Longest codes go to the least frequent symbols
+    int index = 0;
+    for (int length = max_bits; length > 0; length--) {
+        for (int k = length_count[length]; k > 0; k--) {
+            lengths[symbols[index++].symbol] = (uint8_t)length;
+        }
+    }
+}
+
+// Canonical codes for lengths, bit-reversed for LSB-first output
+static void deflate_build_codes(const uint8_t* lengths, int count, uint16_t* codes) {
+    int length_count[DEFLATE_MAX_BITS + 1] = {0};
+    uint32_t next_code[DEFLATE_MAX_BITS + 1];
+    for (int i = 0; i < count; i++) length_count[lengths[i]]++;
+    length_count[0] = 0;
+    uint32_t code = 0;
+    for (int bits = 1; bits <= DEFLATE_MAX_BITS; bits++) {
+        code = (code + (uint32_t)length_count[bits - 1]) << 1;
+        next_code[bits] = code;
+    }
+    for (int i = 0; i < count; i++) {
+        int length = lengths[i];
+        if (!length) {
+            codes[i] = 0;
+            continue;
+        }
+        uint32_t value = next_code[length]++;
+        uint32_t reversed = 0;
+        for (int b = 0; b < length; b++) {
+            reversed = (reversed << 1) | (value & 1);
+            value >>= 1;
+        }
+        codes[i] = (uint16_t)reversed;
+    }
+}
+
+static void deflate_fixed_lengths(uint8_t* litlen, uint8_t* dist) {
+    for (int i = 0; i < 288; i++) {
+        litlen[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+    }
+    for (int i = 0; i < 32; i++) dist[i] = 5;
+}
+
+// Run-length encode the code lengths of a dynamic header with the code
+// length symbols 16 (repeat previous), 17 and 18 (runs of zeros)
+static int deflate_rle_lengths(const uint8_t* lengths, int count, uint8_t* rle_symbols, uint8_t* rle_extra) {
+    int out = 0;
+    int i = 0;
+    while (i < count) {
+        uint8_t length = lengths[i];
+        int run = 1;
+        while (i + run < count && lengths[i + run] == length) run++;
+        i += run;
+        if (length == 0) {
+            while (run >= 11) {
+                int n = run > 138 ? 138 : run;
+                rle_symbols[out] = 18;
+                rle_extra[out++] = (uint8_t)(n - 11);
+                run -= n;
+            }
+            if (run >= 3) {
+                rle_symbols[out] = 17;
+                rle_extra[out++] = (uint8_t)(run - 3);
+                run = 0;
+            }
+        } else {
+            rle_symbols[out] = length;
+            rle_extra[out++] = 0;
+            run--;
+            while (run >= 3) {
+                int n = run > 6 ? 6 : run;
+                rle_symbols[out] = 16;
+                rle_extra[out++] = (uint8_t)(n - 3);
+                run -= n;
+            }
+        }
+        while (run-- > 0) {
+            rle_symbols[out] = length;
+            rle_extra[out++] = 0;
+        }
+    }
+    return out;
+}
+
+static void deflate_write_symbols(DeflateStream* s, const uint8_t* litlen_lengths, const uint16_t* litlen_codes,
+                                  const uint8_t* dist_lengths, const uint16_t* dist_codes) {
+    for (size_t i = 0; i < s->sym_count; i++) {
+        int extra_bits = 0;
+        int extra_value = 0;
+        if (s->sym_dist[i] == 0) {
+            int literal = s->sym_litlen[i];
+            deflate_put_bits(s, litlen_codes[literal], litlen_lengths[literal]);
+            continue;
+        }
+        int code = deflate_length_code(s->sym_litlen[i], &extra_bits, &extra_value);
+        deflate_put_bits(s, litlen_codes[code], litlen_lengths[code]);
+        if (extra_bits) deflate_put_bits(s, (uint32_t)extra_value, extra_bits);
+        code = deflate_dist_code(s->sym_dist[i], &extra_bits, &extra_value);
+        deflate_put_bits(s, dist_codes[code], dist_lengths[code]);
+        if (extra_bits) deflate_put_bits(s, (uint32_t)extra_value, extra_bits);
+    }
+    deflate_put_bits(s, litlen_codes[256], litlen_lengths[256]);
+}
+
+static void deflate_write_stored(DeflateStream* s, bool last) {
+    const unsigned char* data = s->window + s->block_start;
+    size_t remaining = s->block_length;
+    do {
+        size_t chunk = remaining > 65535 ? 65535 : remaining;
+        remaining -= chunk;
+        deflate_put_bits(s, (last && remaining == 0) ? 1 : 0, 1);
+        deflate_put_bits(s, 0, 2);
+        deflate_align_byte(s);
+        deflate_put_byte(s, (unsigned char)(chunk & 0xFF));
+        deflate_put_byte(s, (unsigned char)(chunk >> 8));
+        deflate_put_byte(s, (unsigned char)(~chunk & 0xFF));
+        deflate_put_byte(s, (unsigned char)((~chunk >> 8) & 0xFF));
+        deflate_out_reserve(s, chunk);
+        if (s->ok) {
+            memcpy(s->out + s->out_size, data, chunk);
+            s->out_size += chunk;
+        }
+        data += chunk;
+    } while (remaining > 0);
+}
+
+// Emit the buffered symbols as one block in its cheapest form
+static void deflate_flush_block(DeflateStream* s, bool last) {
+    uint32_t litlen_freq[DEFLATE_LITLEN_CODES] = {0};
+    uint32_t dist_freq[DEFLATE_DIST_CODES] = {0};
+    uint64_t extra_bits_total = 0;
+    for (size_t i = 0; i < s->sym_count; i++) {
+        int extra_bits = 0;
+        int extra_value = 0;
+        if (s->sym_dist[i] == 0) {
+            litlen_freq[s->sym_litlen[i]]++;
+        } else {
+            litlen_freq[deflate_length_code(s->sym_litlen[i], &extra_bits, &extra_value)]++;
+            extra_bits_total += (uint64_t)extra_bits;
+            dist_freq[deflate_dist_code(s->sym_dist[i], &extra_bits, &extra_value)]++;
+            extra_bits_total += (uint64_t)extra_bits;
+        }
+    }
+    litlen_freq[256] = 1;
+
+    uint8_t litlen_lengths[288];
+    uint8_t dist_lengths[32];
+    deflate_build_lengths(litlen_freq, DEFLATE_LITLEN_CODES, DEFLATE_MAX_BITS, litlen_lengths);
+    deflate_build_lengths(dist_freq, DEFLATE_DIST_CODES, DEFLATE_MAX_BITS, dist_lengths);
+
+    int litlen_count = DEFLATE_LITLEN_CODES;
+    while (litlen_count > 257 && litlen_lengths[litlen_count - 1] == 0) litlen_count--;
+    int dist_count = DEFLATE_DIST_CODES;
+    while (dist_count > 1 && dist_lengths[dist_count - 1] == 0) dist_count--;
+
+    // The literal/length and distance lengths are coded as one sequence
+    uint8_t all_lengths[DEFLATE_LITLEN_CODES + DEFLATE_DIST_CODES];
+    memcpy(all_lengths, litlen_lengths, (size_t)litlen_count);
+    memcpy(all_lengths + litlen_count, dist_lengths, (size_t)dist_count);
+    uint8_t rle_symbols[DEFLATE_LITLEN_CODES + DEFLATE_DIST_CODES];
+    uint8_t rle_extra[DEFLATE_LITLEN_CODES + DEFLATE_DIST_CODES];
+    int rle_count = deflate_rle_lengths(all_lengths, litlen_count + dist_count, rle_symbols, rle_extra);
+
+    uint32_t codelen_freq[DEFLATE_CODELEN_CODES] = {0};
+    for (int i = 0; i < rle_count; i++) codelen_freq[rle_symbols[i]]++;
+    uint8_t codelen_lengths[DEFLATE_CODELEN_CODES];
+    deflate_build_lengths(codelen_freq, DEFLATE_CODELEN_CODES, 7, codelen_lengths);
+    int codelen_count = DEFLATE_CODELEN_CODES;
+    while (codelen_count > 4 && codelen_lengths[g_codelen_order[codelen_count - 1]] == 0) codelen_count--;
+
+    // Compare the three encodings in bits
+    uint8_t fixed_litlen[288];
+    uint8_t fixed_dist[32];
+    deflate_fixed_lengths(fixed_litlen, fixed_dist);
+    uint64_t dynamic_bits = 3 + 5 + 5 + 4 + 3 * (uint64_t)codelen_count + extra_bits_total;
+    uint64_t fixed_bits = 3 + extra_bits_total;
+    for (int i = 0; i < rle_count; i++) {
+        static const int rle_extra_bits[3] = {2, 3, 7};
+        dynamic_bits += codelen_lengths[rle_symbols[i]];
+        if (rle_symbols[i] >= 16) dynamic_bits += (uint64_t)rle_extra_bits[rle_symbols[i] - 16];
+    }
+    for (int i = 0; i < DEFLATE_LITLEN_CODES; i++) {
+        dynamic_bits += (uint64_t)litlen_freq[i] * litlen_lengths[i];
+        fixed_bits += (uint64_t)litlen_freq[i] * fixed_litlen[i];
+    }
+    for (int i = 0; i < DEFLATE_DIST_CODES; i++) {
+        dynamic_bits += (uint64_t)dist_freq[i] * dist_lengths[i];
+        fixed_bits += (uint64_t)dist_freq[i] * fixed_dist[i];
+    }
+    uint64_t stored_bits = ((uint64_t)s->block_length + 5 * (s->block_length / 65535 + 1)) * 8 + 7;
+
+    if (s->config.max_chain == 0 || (stored_bits <= fixed_bits && stored_bits <= dynamic_bits)) {
+        deflate_write_stored(s, last);
+    } else if (fixed_bits <= dynamic_bits) {
+        uint16_t litlen_codes[288];
+        uint16_t dist_codes[32];
+        deflate_build_codes(fixed_litlen, 288, litlen_codes);
+        deflate_build_codes(fixed_dist, 32, dist_codes);
+        deflate_put_bits(s, last ? 1 : 0, 1);
+        deflate_put_bits(s, 1, 2);
+        deflate_write_symbols(s, fixed_litlen, litlen_codes, fixed_dist, dist_codes);
+    } else {
+        uint16_t litlen_codes[DEFLATE_LITLEN_CODES];
+        uint16_t dist_codes[DEFLATE_DIST_CODES];
+        uint16_t codelen_codes[DEFLATE_CODELEN_CODES];
+        deflate_build_codes(litlen_lengths, DEFLATE_LITLEN_CODES, litlen_codes);
+        deflate_build_codes(dist_lengths, DEFLATE_DIST_CODES, dist_codes);
+        deflate_build_codes(codelen_lengths, DEFLATE_CODELEN_CODES, codelen_codes);
+
+        deflate_put_bits(s, last ? 1 : 0, 1);
+        deflate_put_bits(s, 2, 2);
+        deflate_put_bits(s, (uint32_t)(litlen_count - 257), 5);
+        deflate_put_bits(s, (uint32_t)(dist_count - 1), 5);
+        deflate_put_bits(s, (uint32_t)(codelen_count - 4), 4);
+        for (int i = 0; i < codelen_count; i++) {
+            deflate_put_bits(s, codelen_lengths[g_codelen_order[i]], 3);
+        }
+        for (int i = 0; i < rle_count; i++) {
+            int symbol = rle_symbols[i];
+            deflate_put_bits(s, codelen_codes[symbol], codelen_lengths[symbol]);
+            if (symbol == 16) deflate_put_bits(s, rle_extra[i], 2);
+            else if (symbol == 17) deflate_put_bits(s, rle_extra[i], 3);
+            else if (symbol == 18) deflate_put_bits(s, rle_extra[i], 7);
+        }
+        deflate_write_symbols(s, litlen_lengths, litlen_codes, dist_lengths, dist_codes);
+    }
+
+    s->block_start += s->block_length;
+    s->block_length = 0;
+    s->sym_count = 0;
+}
+
+static void deflate_emit_literal(DeflateStream* s, unsigned char literal) {
+    s->sym_litlen[s->sym_count] = literal;
+    s->sym_dist[s->sym_count] = 0;
+    s->sym_count++;
+    s->block_length++;
+    if (s->sym_count == DEFLATE_SYMBOLS) deflate_flush_block(s, false);
+}
+
+static void deflate_emit_match(DeflateStream* s, int length, size_t dist) {
+    s->sym_litlen[s->sym_count] = (uint16_t)length;
+    s->sym_dist[s->sym_count] = (uint16_t)dist;
+    s->sym_count++;
+    s->block_length += (size_t)length;
+    if (s->sym_count == DEFLATE_SYMBOLS) deflate_flush_block(s, false);
+}
+
+// LZ77 matching
+
+static uint32_t deflate_hash(const unsigned char* p) {
+    uint32_t value = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+// Insert the string at pos into its hash chain; returns the previous
+// chain head (position + 1, 0 = none)
+static uint32_t deflate_insert(DeflateStream* s, size_t pos) {
+    if (pos + DEFLATE_MIN_MATCH > s->window_fill) return 0;
+    uint32_t hash = deflate_hash(s->window + pos);
+    uint32_t previous = s->head[hash];
+    s->prev[pos & DEFLATE_WMASK] = previous;
+    s->head[hash] = (uint32_t)pos + 1;
+    return previous;
+}
+
+// Longest match for pos along the chain starting at chain_head that beats
+// best_length; returns 0 if there is none
+static int deflate_longest_match(DeflateStream* s, size_t pos, uint32_t chain_head, int best_length, size_t* match_dist) {
+    size_t available = s->window_fill - pos;
+    int max_length = available < DEFLATE_MAX_MATCH ? (int)available : DEFLATE_MAX_MATCH;
+    if (best_length >= max_length) return 0;
+    if (best_length < DEFLATE_MIN_MATCH - 1) best_length = DEFLATE_MIN_MATCH - 1;
+
+    int chain = s->config.max_chain;
+    if (best_length >= s->config.good_length) chain >>= 2;
+    int nice_length = s->config.nice_length < max_length ? s->config.nice_length : max_length;
+    size_t limit = pos > DEFLATE_MAX_DIST ? pos - DEFLATE_MAX_DIST : 0;
+    const unsigned char* scan = s->window + pos;
+    int found = 0;
+
+    uint32_t entry = chain_head;
+    while (entry != 0 && chain-- > 0) {
+        size_t candidate = entry - 1;
+        if (candidate < limit || candidate >= pos) break;
+        const unsigned char* match = s->window + candidate;
+        if (match[best_length] == scan[best_length] && match[0] == scan[0] && match[1] == scan[1]) {
+            int length = 2;
+            while (length < max_length && match[length] == scan[length]) length++;
+            if (length > best_length) {
+                best_length = length;
+                found = length;
+                *match_dist = pos - candidate;
+                if (length >= nice_length) break;
+            }
+        }
+        uint32_t next = s->prev[candidate & DEFLATE_WMASK];
+        if (next >= entry) break;
+        entry = next;
+    }
+    return found;
+}
+
+// Encode window bytes; without finish, stop while a full match can still
+// need bytes that haven't arrived
+static void deflate_process(DeflateStream* s, bool finish) {
+    size_t reserve = finish ? 0 : DEFLATE_MIN_LOOKAHEAD;
+
+    if (!s->config.lazy) {
+        while (s->pos < s->window_fill && s->window_fill - s->pos > reserve) {
+            uint32_t chain_head = deflate_insert(s, s->pos);
+            size_t dist = 0;
+            int length = 0;
+            if (chain_head != 0 && s->config.max_chain > 0 && s->pos - (chain_head - 1) <= DEFLATE_MAX_DIST) {
+                length = deflate_longest_match(s, s->pos, chain_head, 0, &dist);
+            }
+            if (length >= DEFLATE_MIN_MATCH) {
+                deflate_emit_match(s, length, dist);
+                if (length <= s->config.max_lazy) {
+                    for (int i = 1; i < length; i++) deflate_insert(s, s->pos + (size_t)i);
+                }
+                s->pos += (size_t)length;
+            } else {
+                deflate_emit_literal(s, s->window[s->pos]);
+                s->pos++;
+            }
+        }
+        return;
+    }
+
+    while (s->pos < s->window_fill && s->window_fill - s->pos > reserve) {
+        uint32_t chain_head = deflate_insert(s, s->pos);
+        int previous_length = s->match_length;
+        size_t previous_dist = s->match_dist;
+        s->match_length = DEFLATE_MIN_MATCH - 1;
+
+        if (chain_head != 0 && previous_length < s->config.max_lazy &&
+            s->pos - (chain_head - 1) <= DEFLATE_MAX_DIST) {
+            size_t dist = 0;
+            int length = deflate_longest_match(s, s->pos, chain_head, previous_length, &dist);
+            if (length >= DEFLATE_MIN_MATCH && !(length == DEFLATE_MIN_MATCH && dist > DEFLATE_TOO_FAR)) {
+                s->match_length = length;
+                s->match_dist = dist;
+            }
+        }
+
+        if (previous_length >= DEFLATE_MIN_MATCH && s->match_length <= previous_length) {
+            // The match found at the previous position wins; it starts at pos - 1
+            deflate_emit_match(s, previous_length, previous_dist);
+            size_t end = s->pos - 1 + (size_t)previous_length;
+            for (size_t p = s->pos + 1; p < end; p++) deflate_insert(s, p);
+            s->pos = end;
+            s->match_available = false;
+            s->match_length = DEFLATE_MIN_MATCH - 1;
+        } else if (s->match_available) {
+            deflate_emit_literal(s, s->window[s->pos - 1]);
+            s->pos++;
+        } else {
+            s->match_available = true;
+            s->pos++;
+        }
+    }
+
+    if (finish && s->match_available) {
+        deflate_emit_literal(s, s->window[s->pos - 1]);
+        s->match_available = false;
+    }
+}
+
+// Drop the older half of the window once the newer half is needed
+static void deflate_slide(DeflateStream* s) {
+    if (s->sym_count > 0) deflate_flush_block(s, false);
+    memmove(s->window, s->window + DEFLATE_WSIZE, DEFLATE_WSIZE);
+    s->window_fill -= DEFLATE_WSIZE;
+    s->pos -= DEFLATE_WSIZE;
+    s->block_start -= DEFLATE_WSIZE;
+    for (size_t i = 0; i < DEFLATE_HASH_SIZE; i++) {
+        s->head[i] = s->head[i] > DEFLATE_WSIZE ? s->head[i] - DEFLATE_WSIZE : 0;
+    }
+    for (size_t i = 0; i < DEFLATE_WSIZE; i++) {
+        s->prev[i] = s->prev[i] > DEFLATE_WSIZE ? s->prev[i] - DEFLATE_WSIZE : 0;
+    }
+}
+
+static void deflate_write_header(DeflateStream* s) {
+    if (s->type == COMPRESSION_GZIP) {
+        // No file name or timestamp; OS 255 = unknown
+        static const unsigned char gzip_header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+        for (int i = 0; i < 10; i++) {
+            unsigned char byte = gzip_header[i];
+            // XFL: 2 = best compression, 4 = fastest
+            if (i == 8) byte = s->level == COMPRESSION_LEVEL_BEST ? 2 : s->level == COMPRESSION_LEVEL_FAST ? 4 : 0;
+            deflate_put_byte(s, byte);
+        }
+    } else if (s->type == COMPRESSION_ZLIB) {
+        int level_flag = s->level <= 1 ? 0 : s->level < 6 ? 1 : s->level == 6 ? 2 : 3;
+        unsigned header = (0x78u << 8) | ((unsigned)level_flag << 6);
+        header += 31 - header % 31;
+        deflate_put_byte(s, (unsigned char)(header >> 8));
+        deflate_put_byte(s, (unsigned char)(header & 0xFF));
+    }
+    s->header_written = true;
+}
+
+static void deflate_write_trailer(DeflateStream* s) {
+    uint32_t checksum = (uint32_t)s->checksum;
+    if (s->type == COMPRESSION_GZIP) {
+        uint32_t size = (uint32_t)s->total_in;
+        for (int i = 0; i < 4; i++) deflate_put_byte(s, (unsigned char)(checksum >> (8 * i)));
+        for (int i = 0; i < 4; i++) deflate_put_byte(s, (unsigned char)(size >> (8 * i)));
+    } else if (s->type == COMPRESSION_ZLIB) {
+        for (int i = 3; i >= 0; i--) deflate_put_byte(s, (unsigned char)(checksum >> (8 * i)));
+    }
+}
+
+DeflateStream* deflate_stream_create(CompressionType type, int level) {
+    if (type != COMPRESSION_DEFLATE && type != COMPRESSION_ZLIB && type != COMPRESSION_GZIP) return NULL;
+    if (level < COMPRESSION_LEVEL_STORE || level > COMPRESSION_LEVEL_BEST) level = COMPRESSION_LEVEL_DEFAULT;
+
+    DeflateStream* s = shared_malloc_safe(sizeof(DeflateStream), "compression", "deflate_stream_create", 0);
+    if (!s) return NULL;
+    memset(s, 0, sizeof(DeflateStream));
+    s->type = type;
+    s->level = level;
+    s->config = g_deflate_levels[level];
+    s->match_length = DEFLATE_MIN_MATCH - 1;
+    s->checksum = type == COMPRESSION_ZLIB ? 1 : 0;
+    s->ok = true;
+    return s;
+}
+
+bool deflate_stream_write(DeflateStream* stream, const char* data, size_t data_size, bool finish) {
+    if (!stream || stream->finished || (!data && data_size > 0)) return false;
+    if (!stream->header_written) deflate_write_header(stream);
+
+    if (data_size > 0) {
+        if (stream->type == COMPRESSION_GZIP) {
+            stream->checksum = compression_crc32(stream->checksum, data, data_size);
+        } else if (stream->type == COMPRESSION_ZLIB) {
+            stream->checksum = compression_adler32(stream->checksum, data, data_size);
+        }
+        stream->total_in += data_size;
+    }
+
+    while (data_size > 0 && stream->ok) {
+        if (stream->window_fill == sizeof(stream->window)) deflate_slide(stream);
+        size_t space = sizeof(stream->window) - stream->window_fill;
+        size_t chunk = data_size < space ? data_size : space;
+        memcpy(stream->window + stream->window_fill, data, chunk);
+        stream->window_fill += chunk;
+        data += chunk;
+        data_size -= chunk;
+        deflate_process(stream, false);
+    }
+
+    if (finish && stream->ok) {
+        deflate_process(stream, true);
+        deflate_flush_block(stream, true);
+        deflate_align_byte(stream);
+        deflate_write_trailer(stream);
+        stream->finished = true;
+    }
+    return stream->ok;
+}
+
+char* deflate_stream_take(DeflateStream* stream, size_t* size) {
+    if (!stream || !size || !stream->ok) return NULL;
+    char* output = (char*)stream->out;
+    *size = stream->out_size;
+    if (!output) {
+        // Nothing produced yet; return an empty buffer rather than NULL
+        output = shared_malloc_safe(1, "compression", "deflate_stream_take", 0);
+        *size = 0;
+    }
+    stream->out = NULL;
+    stream->out_size = 0;
+    stream->out_capacity = 0;
+    return output;
+}
+
+void deflate_stream_free(DeflateStream* stream) {
+    if (!stream) return;
+    if (stream->out) shared_free_safe(stream->out, "compression", "deflate_stream_free", 0);
+    shared_free_safe(stream, "compression", "deflate_stream_free", 0);
+}
+
+static char* deflate_compress(const char* data, size_t data_size, CompressionType type, int level, size_t* compressed_size) {
+    DeflateStream* stream = deflate_stream_create(type, level);
+    if (!stream) return NULL;
+    char* output = NULL;
+    if (deflate_stream_write(stream, data, data_size, true)) {
+        output = deflate_stream_take(stream, compressed_size);
+    }
+    deflate_stream_free(stream);
+    return output;
+}
+
+// ============================================================================
+// DEFLATE DECODER
+// ============================================================================
+
+#define INFLATE_MAX_OUTPUT ((size_t)1 << 31)
+
+typedef struct {
+    const unsigned char* in;
+    size_t in_size;
+    size_t in_pos;
+    uint32_t bit_buffer;
+    int bit_count;
+    unsigned char* out;
+    size_t out_size;
+    size_t out_capacity;
+} InflateState;
+
+typedef struct {
+    uint16_t count[DEFLATE_MAX_BITS + 1];   // Codes per length
+    uint16_t symbol[288];                   // Symbols ordered by code
+} InflateHuffman;
+
+// Next count bits, or -1 past the end of the input
+static int inflate_bits(InflateState* st, int count) {
+    while (st->bit_count < count) {
+        if (st->in_pos >= st->in_size) return -1;
+        st->bit_buffer |= (uint32_t)st->in[st->in_pos++] << st->bit_count;
+        st->bit_count += 8;
+    }
+    int value = (int)(st->bit_buffer & ((1u << count) - 1));
+    st->bit_buffer >>= count;
+    st->bit_count -= count;
+    return value;
+}
+
+static bool inflate_reserve(InflateState* st, size_t extra) {
+    if (st->out_size + extra <= st->out_capacity) return true;
+    if (st->out_size + extra > INFLATE_MAX_OUTPUT) return false;
+    size_t capacity = st->out_capacity ? st->out_capacity : 4096;
+    while (capacity < st->out_size + extra) capacity *= 2;
+    unsigned char* grown = shared_realloc_safe(st->out, capacity, "compression", "inflate_reserve", 0);
+    if (!grown) return false;
+    st->out = grown;
+    st->out_capacity = capacity;
+    return true;
+}
+
+// Build a decoding table; rejects over-subscribed codes and incomplete
+// ones, except a single-code tree
+static bool inflate_build(InflateHuffman* h, const uint8_t* lengths, int count) {
+    uint16_t offsets[DEFLATE_MAX_BITS + 1];
+    memset(h->count, 0, sizeof(h->count));
+    for (int i = 0; i < count; i++) h->count[lengths[i]]++;
+    if (h->count[0] == count) return true;
+
+    int left = 1;
+    for (int bits = 1; bits <= DEFLATE_MAX_BITS; bits++) {
+        left <<= 1;
+        left -= h->count[bits];
+        if (left < 0) return false;
+    }
+    offsets[1] = 0;
+    for (int bits = 1; bits < DEFLATE_MAX_BITS; bits++) offsets[bits + 1] = offsets[bits] + h->count[bits];
+    for (int i = 0; i < count; i++) {
+        if (lengths[i]) h->symbol[offsets[lengths[i]]++] = (uint16_t)i;
+    }
+    return left == 0 || (count - h->count[0] == 1);
+}
+
+static int inflate_decode(InflateState* st, const InflateHuffman* h) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int bits = 1; bits <= DEFLATE_MAX_BITS; bits++) {
+        int bit = inflate_bits(st, 1);
+        if (bit < 0) return -1;
+        code |= bit;
+        int count = h->count[bits];
+        if (code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static bool inflate_codes(InflateState* st, const InflateHuffman* litlen, const InflateHuffman* dist) {
+    static const uint16_t length_base[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t length_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t dist_base[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t dist_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    for (;;) {
+        int symbol = inflate_decode(st, litlen);
+        if (symbol < 0) return false;
+        if (symbol < 256) {
+            if (!inflate_reserve(st, 1)) return false;
+            st->out[st->out_size++] = (unsigned char)symbol;
+            continue;
+        }
+        if (symbol == 256) return true;
+
+        symbol -= 257;
+        if (symbol >= 29) return false;
+        int extra = inflate_bits(st, length_extra[symbol]);
+        if (extra < 0) return false;
+        size_t length = (size_t)length_base[symbol] + (size_t)extra;
+
+        symbol = inflate_decode(st, dist);
+        if (symbol < 0 || symbol >= 30) return false;
+        extra = inflate_bits(st, dist_extra[symbol]);
+        if (extra < 0) return false;
+        size_t distance = (size_t)dist_base[symbol] + (size_t)extra;
+        if (distance > st->out_size) return false;
+
+        if (!inflate_reserve(st, length)) return false;
+        // Byte by byte: the source may overlap the bytes being written
+        unsigned char* to = st->out + st->out_size;
+        const unsigned char* from = to - distance;
+        for (size_t i = 0; i < length; i++) to[i] = from[i];
+        st->out_size += length;
+    }
+}
+
+static bool inflate_stored(InflateState* st) {
+    st->bit_buffer = 0;
+    st->bit_count = 0;
+    if (st->in_pos + 4 > st->in_size) return false;
+    size_t length = (size_t)st->in[st->in_pos] | ((size_t)st->in[st->in_pos + 1] << 8);
+    size_t complement = (size_t)st->in[st->in_pos + 2] | ((size_t)st->in[st->in_pos + 3] << 8);
+    st->in_pos += 4;
+    if (length != (~complement & 0xFFFF) || st->in_pos + length > st->in_size) return false;
+    if (length == 0) return true;
+    if (!inflate_reserve(st, length)) return false;
+    memcpy(st->out + st->out_size, st->in + st->in_pos, length);
+    st->out_size += length;
+    st->in_pos += length;
+    return true;
+}
+
+static bool inflate_dynamic(InflateState* st) {
+    InflateHuffman litlen;
+    InflateHuffman dist;
+    InflateHuffman codelen;
+    uint8_t lengths[DEFLATE_LITLEN_CODES + DEFLATE_DIST_CODES + 2];
+
+    int litlen_count = inflate_bits(st, 5);
+    int dist_count = inflate_bits(st, 5);
+    int codelen_count = inflate_bits(st, 4);
+    if (litlen_count < 0 || dist_count < 0 || codelen_count < 0) return false;
+    litlen_count += 257;
+    dist_count += 1;
+    codelen_count += 4;
+    if (litlen_count > DEFLATE_LITLEN_CODES || dist_count > DEFLATE_DIST_CODES) return false;
+
+    uint8_t codelen_lengths[DEFLATE_CODELEN_CODES] = {0};
+    for (int i = 0; i < codelen_count; i++) {
+        int length = inflate_bits(st, 3);
+        if (length < 0) return false;
+        codelen_lengths[g_codelen_order[i]] = (uint8_t)length;
+    }
+    if (!inflate_build(&codelen, codelen_lengths, DEFLATE_CODELEN_CODES)) return false;
+
+    int total = litlen_count + dist_count;
+    int index = 0;
+    while (index < total) {
+        int symbol = inflate_decode(st, &codelen);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            lengths[index++] = (uint8_t)symbol;
+            continue;
+        }
+        uint8_t value = 0;
+        int repeat;
+        if (symbol == 16) {
+            if (index == 0) return false;
+            value = lengths[index - 1];
+            repeat = inflate_bits(st, 2);
+            if (repeat < 0) return false;
+            repeat += 3;
+        } else if (symbol == 17) {
+            repeat = inflate_bits(st, 3);
+            if (repeat < 0) return false;
+            repeat += 3;
+        } else {
+            repeat = inflate_bits(st, 7);
+            if (repeat < 0) return false;
+            repeat += 11;
+        }
+        if (index + repeat > total) return false;
+        while (repeat-- > 0) lengths[index++] = value;
+    }
+    if (lengths[256] == 0) return false;
+
+    if (!inflate_build(&litlen, lengths, litlen_count)) return false;
+    if (!inflate_build(&dist, lengths + litlen_count, dist_count)) return false;
+    return inflate_codes(st, &litlen, &dist);
+}
+
+// Decode a raw DEFLATE stream starting at in_pos; in_pos ends on the byte
+// after the final block
+static bool inflate_raw(InflateState* st) {
+    InflateHuffman fixed_litlen;
+    InflateHuffman fixed_dist;
+    bool fixed_built = false;
+    int last = 0;
+    do {
+        last = inflate_bits(st, 1);
+        int type = inflate_bits(st, 2);
+        if (last < 0 || type < 0) return false;
+        bool ok = false;
+        if (type == 0) {
+            ok = inflate_stored(st);
+        } else if (type == 1) {
+            if (!fixed_built) {
+                uint8_t litlen_lengths[288];
+                uint8_t dist_lengths[32];
+                deflate_fixed_lengths(litlen_lengths, dist_lengths);
+                inflate_build(&fixed_litlen, litlen_lengths, 288);
+                inflate_build(&fixed_dist, dist_lengths, 30);
+                fixed_built = true;
+            }
+            ok = inflate_codes(st, &fixed_litlen, &fixed_dist);
+        } else if (type == 2) {
+            ok = inflate_dynamic(st);
+        }
+        if (!ok) return false;
+    } while (!last);
+
+    // Give back whole bytes still sitting in the bit buffer
+    st->in_pos -= (size_t)(st->bit_count / 8);
+    st->bit_buffer = 0;
+    st->bit_count = 0;
+    return true;
+}
+
+static uint32_t inflate_read_le32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static char* deflate_decompress(const char* data, size_t data_size, CompressionType type, size_t* decompressed_size) {
+    InflateState st;
+    memset(&st, 0, sizeof(st));
+    st.in = (const unsigned char*)data;
+    st.in_size = data_size;
+
+    if (type == COMPRESSION_GZIP) {
+        if (data_size < 18 || st.in[0] != 0x1F || st.in[1] != 0x8B || st.in[2] != 8) return NULL;
+        int flags = st.in[3];
+        st.in_pos = 10;
+        if (flags & 0x04) {  // FEXTRA
+            if (st.in_pos + 2 > data_size) return NULL;
+            st.in_pos += 2 + ((size_t)st.in[st.in_pos] | ((size_t)st.in[st.in_pos + 1] << 8));
+        }
+        for (int field = 0x08; field <= 0x10; field <<= 1) {  // FNAME, FCOMMENT
+            if (!(flags & field)) continue;
+            while (st.in_pos < data_size && st.in[st.in_pos] != 0) st.in_pos++;
+            st.in_pos++;
+        }
+        if (flags & 0x02) st.in_pos += 2;  // FHCRC
+        if (st.in_pos > data_size) return NULL;
+    } else if (type == COMPRESSION_ZLIB) {
+        if (data_size < 6) return NULL;
+        unsigned header = ((unsigned)st.in[0] << 8) | st.in[1];
+        if ((st.in[0] & 0x0F) != 8 || header % 31 != 0 || (st.in[1] & 0x20)) return NULL;
+        st.in_pos = 2;
+    }
+
+    bool ok = inflate_raw(&st);
+    if (ok && type == COMPRESSION_GZIP) {
+        ok = st.in_pos + 8 <= data_size &&
+             inflate_read_le32(st.in + st.in_pos) ==
+                 (uint32_t)compression_crc32(0, (const char*)st.out, st.out_size) &&
+             inflate_read_le32(st.in + st.in_pos + 4) == (uint32_t)st.out_size;
+    } else if (ok && type == COMPRESSION_ZLIB) {
+        ok = st.in_pos + 4 <= data_size;
+        if (ok) {
+            const unsigned char* p = st.in + st.in_pos;
+            uint32_t expected = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+            ok = expected == (uint32_t)compression_adler32(1, (const char*)st.out, st.out_size);
+        }
+    }
+    if (!ok || !inflate_reserve(&st, 1)) {
+        if (st.out) shared_free_safe(st.out, "compression", "deflate_decompress", 0);
+        return NULL;
+    }
+
+    // NUL-terminate so text can be used directly
+    st.out[st.out_size] = '\0';
+    *decompressed_size = st.out_size;
+    return (char*)st.out;
+}
+
 // Compress data using specified algorithm
 char* compress_data(const char* data, size_t data_size, CompressionType type, size_t* compressed_size) {
     if (!data || data_size == 0 || !compressed_size) return NULL;
@@ -195,6 +1303,11 @@ char* compress_data(const char* data, size_t data_size, CompressionType type, si
         case COMPRESSION_DICT:
             return dict_compress(data, data_size, compressed_size);
             
+        case COMPRESSION_DEFLATE:
+        case COMPRESSION_ZLIB:
+        case COMPRESSION_GZIP:
+            return deflate_compress(data, data_size, type, COMPRESSION_LEVEL_DEFAULT, compressed_size);
+            
         case COMPRESSION_NONE:
         default:
             // No compression, just copy
@@ -203,6 +1316,15 @@ char* compress_data(const char* data, size_t data_size, CompressionType type, si
     }
 }
 
+// Compress with DEFLATE at a given level (other types ignore the level)
+char* compress_data_level(const char* data, size_t data_size, CompressionType type, int level, size_t* compressed_size) {
+    if (!data || !compressed_size) return NULL;
+    if (type == COMPRESSION_DEFLATE || type == COMPRESSION_ZLIB || type == COMPRESSION_GZIP) {
+        return deflate_compress(data, data_size, type, level, compressed_size);
+    }
+    return compress_data(data, data_size, type, compressed_size);
+}
+
 // Decompress data using specified algorithm
 char* decompress_data(const char* data, size_t data_size, CompressionType type, size_t* decompressed_size) {
     if (!data || data_size == 0 || !decompressed_size) return NULL;
@@ -214,6 +1336,11 @@ char* decompress_data(const char* data, size_t data_size, CompressionType type,
         case COMPRESSION_DICT:
             return dict_decompress(data, data_size, decompressed_size);
             
+        case COMPRESSION_DEFLATE:
+        case COMPRESSION_ZLIB:
+        case COMPRESSION_GZIP:
+            return deflate_decompress(data, data_size, type, decompressed_size);
+            
         case COMPRESSION_NONE:
         default:
             // No decompression, just copy
@@ -7,6 +7,7 @@
 #include "../../include/core/ast.h"
 #include "../../include/core/standardized_errors.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/libs/file.h"
 
 // File handle structure for stream operations
 typedef struct {
@@ -86,6 +87,24 @@ static int file_handle_register(FileHandle* handle) {
     return file_handle_count++;
 }
 
+long file_handle_read(Value handle_value, char* buffer, size_t size) {
+    FileHandle* handle = file_handle_find(handle_value);
+    if (!handle || !handle->is_open || !handle->file) return -1;
+    
+    size_t bytes_read = size > 0 ? fread(buffer, 1, size, handle->file) : 0;
+    handle->position = ftell(handle->file);
+    return (long)bytes_read;
+}
+
+long file_handle_write(Value handle_value, const char* data, size_t size) {
+    FileHandle* handle = file_handle_find(handle_value);
+    if (!handle || !handle->is_open || !handle->file) return -1;
+    
+    size_t bytes_written = size > 0 ? fwrite(data, 1, size, handle->file) : 0;
+    handle->position = ftell(handle->file);
+    return bytes_written == size ? (long)bytes_written : -1;
+}
+
 // File library functions
 
 // File handle operations
@@ -211,10 +230,8 @@ Value builtin_file_read_chunk(Interpreter* interpreter, Value* args, size_t arg_
         return value_create_null();
     }
     
-    size_t bytes_read = fread(buffer, 1, size, handle->file);
-    buffer[bytes_read] = '\0';
-    
-    handle->position = ftell(handle->file);
+    long bytes_read = file_handle_read(args[0], buffer, size);
+    buffer[bytes_read > 0 ? bytes_read : 0] = '\0';
     
     Value result = value_create_string(buffer);
     shared_free_safe(buffer, "file", "unknown_function", 220);
@@ -5,6 +5,7 @@
 #include "../../include/core/standardized_errors.h"
 #include "../../include/utils/shared_utilities.h"
 #include "../../include/core/interpreter/method_handlers.h"
+#include "../../include/runtime/reactor.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -689,6 +690,11 @@ void gateway_process_messages(GatewayConnection* gateway) {
         if (now - gateway->last_heartbeat_time >= (uint64_t)gateway->config.heartbeat_interval_ms) {
             gateway_send_heartbeat(gateway);
         }
+        // Wake the event loop for the next heartbeat (get_time_ms shares the reactor's clock)
+        reactor_schedule(gateway->last_heartbeat_time + (uint64_t)gateway->config.heartbeat_interval_ms);
+    }
+    if (gateway->waiting_for_ack) {
+        reactor_schedule(gateway->last_heartbeat_time + (uint64_t)gateway->config.heartbeat_timeout_ms + 1);
     }
 }
 
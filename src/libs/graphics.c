@@ -3,6 +3,7 @@
 #include "../../include/core/interpreter.h"
 #include "../../include/core/standardized_errors.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #define HAS_SDL_TTF
@@ -385,8 +386,8 @@ Value builtin_graphics_poll_events(Interpreter* interpreter, Value* args, size_t
     }
     
     // Debug: Check stack size to see if it's growing
-    extern size_t value_stack_size;
-    extern size_t value_stack_capacity;
+    extern MYCO_THREAD_LOCAL size_t value_stack_size;
+    extern MYCO_THREAD_LOCAL size_t value_stack_capacity;
     static size_t last_stack_size = 0;
     static size_t last_stack_capacity = 0;
     if (g_memory_report_count > 0 && g_memory_report_count % 5 == 0) {
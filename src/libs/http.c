@@ -6,6 +6,7 @@
 #include "../../include/utils/shared_utilities.h"
 #include "../../include/libs/http_client.h"
 #include "../../include/core/interpreter/value_operations.h"
+#include <ctype.h>
 
 // Global HTTP client initialization flag
 static bool http_client_initialized = false;
@@ -256,6 +257,46 @@ Value builtin_http_get(Interpreter* interpreter, Value* args, size_t arg_count,
     return response_obj;
 }
 
+// "Name: value\r\n" lines from a headers object or hash map, or NULL
+static char* http_headers_string(Value* headers_obj) {
+    if (headers_obj->type != VALUE_OBJECT && headers_obj->type != VALUE_HASH_MAP) return NULL;
+    
+    size_t key_count = headers_obj->type == VALUE_OBJECT ? headers_obj->data.object_value.count
+                                                         : headers_obj->data.hash_map_value.count;
+    size_t headers_len = 256;
+    size_t current_len = 0;
+    char* headers_str = shared_malloc_safe(headers_len, "http", "http_headers_string", 0);
+    if (!headers_str) return NULL;
+    headers_str[0] = '\0';
+    
+    for (size_t i = 0; i < key_count; i++) {
+        const char* header_name = NULL;
+        Value* header_value = NULL;
+        if (headers_obj->type == VALUE_OBJECT) {
+            header_name = headers_obj->data.object_value.keys[i];
+            header_value = &headers_obj->data.object_value.values[i];
+        } else {
+            Value* key_value = (Value*)headers_obj->data.hash_map_value.keys[i];
+            if (key_value && key_value->type == VALUE_STRING) header_name = key_value->data.string_value;
+            header_value = (Value*)headers_obj->data.hash_map_value.values[i];
+        }
+        if (!header_name || !header_value || header_value->type != VALUE_STRING || !header_value->data.string_value) {
+            continue;
+        }
+        
+        size_t needed = strlen(header_name) + strlen(header_value->data.string_value) + 4; // ": \r\n"
+        if (current_len + needed >= headers_len) {
+            headers_len = (current_len + needed) * 2;
+            char* grown = shared_realloc_safe(headers_str, headers_len, "http", "http_headers_string", 0);
+            if (!grown) break;
+            headers_str = grown;
+        }
+        current_len += (size_t)snprintf(headers_str + current_len, headers_len - current_len,
+                                        "%s: %s\r\n", header_name, header_value->data.string_value);
+    }
+    return headers_str;
+}
+
 Value builtin_http_post(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
     if (arg_count < 2) {
         std_error_report(ERROR_INTERNAL_ERROR, "http", "unknown_function", "http.post() requires at least 2 arguments (url, data)", line, column);
@@ -276,58 +317,7 @@ Value builtin_http_post(Interpreter* interpreter, Value* args, size_t arg_count,
     }
     
     // Build headers string if headers object/hashmap is provided (optional 3rd argument)
-    char* headers_str = NULL;
-    if (arg_count >= 3 && (args[2].type == VALUE_OBJECT || args[2].type == VALUE_HASH_MAP)) {
-        Value headers_obj = args[2];
-        size_t headers_len = 256; // Initial size
-        headers_str = shared_malloc_safe(headers_len, "http", "builtin_http_post", 0);
-        if (headers_str) {
-            headers_str[0] = '\0';
-            
-            // Get all keys from headers object/hashmap
-            size_t key_count = 0;
-            void** keys = NULL;
-            if (headers_obj.type == VALUE_OBJECT) {
-                key_count = headers_obj.data.object_value.count;
-                keys = (void**)headers_obj.data.object_value.keys;
-            } else if (headers_obj.type == VALUE_HASH_MAP) {
-                key_count = headers_obj.data.hash_map_value.count;
-                keys = (void**)headers_obj.data.hash_map_value.keys;
-            }
-            
-            if (keys && key_count > 0) {
-                for (size_t i = 0; i < key_count; i++) {
-                    Value* key_value = (Value*)keys[i];
-                    if (!key_value || key_value->type != VALUE_STRING || !key_value->data.string_value) {
-                        continue;
-                    }
-                    const char* header_name = key_value->data.string_value;
-                    
-                    // Get header value
-                    Value header_value;
-                    if (headers_obj.type == VALUE_OBJECT) {
-                        header_value = value_object_get(&headers_obj, header_name);
-                    } else {
-                        header_value = value_hash_map_get(&headers_obj, *key_value);
-                    }
-                    
-                    if (header_value.type == VALUE_STRING && header_value.data.string_value) {
-                        size_t current_len = strlen(headers_str);
-                        size_t needed = strlen(header_name) + strlen(header_value.data.string_value) + 4; // ": \r\n"
-                        if (current_len + needed >= headers_len) {
-                            headers_len = (current_len + needed) * 2;
-                            headers_str = shared_realloc_safe(headers_str, headers_len, "http", "builtin_http_post", 0);
-                        }
-                        if (headers_str) {
-                            snprintf(headers_str + current_len, headers_len - current_len, 
-                                    "%s: %s\r\n", header_name, header_value.data.string_value);
-                        }
-                    }
-                    value_free(&header_value);
-                }
-            }
-        }
-    }
+    char* headers_str = arg_count >= 3 ? http_headers_string(&args[2]) : NULL;
     
     HttpResponse* response = http_post(url_value.data.string_value, data_value.data.string_value, headers_str, 30);
     
@@ -707,6 +697,132 @@ Value builtin_http_options(Interpreter* interpreter, Value* args, size_t arg_cou
     return response_obj;
 }
 
+// ============================================================================
+// ASYNC REQUESTS
+// ============================================================================
+
+typedef struct {
+    Interpreter* interpreter;
+    uint64_t promise_id;
+} HttpFetchContext;
+
+// Same shape as the objects http.get() and friends return, plus the
+// content_encoding a request's Accept-Encoding header negotiated
+static Value http_response_value(HttpResponse* response) {
+    Value response_obj = value_create_object(9);
+    value_object_set(&response_obj, "type", value_create_string("Object"));
+    value_object_set(&response_obj, "status_code", value_create_number(response->status_code));
+    value_object_set(&response_obj, "status_text", value_create_string("OK")); // Simplified
+    value_object_set(&response_obj, "body", value_create_string(response->body ? response->body : ""));
+    value_object_set(&response_obj, "success", value_create_boolean(response->success));
+    value_object_set(&response_obj, "content_type", value_create_string("text/plain")); // Simplified
+    value_object_set(&response_obj, "content_length", value_create_number(response->body ? strlen(response->body) : 0));
+    
+    char encoding[32] = "";
+    size_t encoding_length = 0;
+    const char* header = http_response_header(response, "Content-Encoding", &encoding_length);
+    if (header) {
+        snprintf(encoding, sizeof(encoding), "%.*s", (int)encoding_length, header);
+    }
+    value_object_set(&response_obj, "content_encoding", value_create_string(encoding));
+    return response_obj;
+}
+
+static void http_fetch_complete(void* context, HttpResponse* response, const char* error) {
+    HttpFetchContext* fetch = (HttpFetchContext*)context;
+    if (response) {
+        Value response_obj = http_response_value(response);
+        async_promise_settle(fetch->interpreter, fetch->promise_id, &response_obj, 0);
+        value_free(&response_obj);
+        http_free_response(response);
+    } else {
+        Value error_val = value_create_string(error ? error : "HTTP request failed");
+        async_promise_settle(fetch->interpreter, fetch->promise_id, &error_val, 1);
+        value_free(&error_val);
+    }
+    shared_free_safe(fetch, "http", "http_fetch_complete", 0);
+}
+
+// Look up an option on an options object or hash map
+static Value http_option(Value* options, const char* name) {
+    if (options->type == VALUE_OBJECT) {
+        return value_object_get(options, name);
+    }
+    Value key = value_create_string(name);
+    Value option = value_hash_map_get(options, key);
+    value_free(&key);
+    return option;
+}
+
+// http.fetchAsync(url, options?) -> Promise resolving to a response object.
+// options: method, body, headers (object or map) and timeout in seconds.
+Value builtin_http_fetch_async(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    if (arg_count < 1) {
+        std_error_report(ERROR_INTERNAL_ERROR, "http", "unknown_function", "http.fetchAsync() requires at least 1 argument (url)", line, column);
+        return value_create_null();
+    }
+    
+    Value url_value = args[0];
+    if (url_value.type != VALUE_STRING) {
+        std_error_report(ERROR_TYPE_MISMATCH, "http", "unknown_function", "http.fetchAsync() URL must be a string", line, column);
+        return value_create_null();
+    }
+    
+    char method[16] = "GET";
+    Value body_val = value_create_null();
+    char* headers_str = NULL;
+    int timeout = 30;
+    if (arg_count >= 2 && (args[1].type == VALUE_OBJECT || args[1].type == VALUE_HASH_MAP)) {
+        Value method_val = http_option(&args[1], "method");
+        if (method_val.type == VALUE_STRING && method_val.data.string_value) {
+            size_t i = 0;
+            for (; method_val.data.string_value[i] && i < sizeof(method) - 1; i++) {
+                method[i] = (char)toupper((unsigned char)method_val.data.string_value[i]);
+            }
+            method[i] = '\0';
+        }
+        value_free(&method_val);
+        
+        body_val = http_option(&args[1], "body");
+        
+        Value headers_val = http_option(&args[1], "headers");
+        headers_str = http_headers_string(&headers_val);
+        value_free(&headers_val);
+        
+        Value timeout_val = http_option(&args[1], "timeout");
+        if (timeout_val.type == VALUE_NUMBER && timeout_val.data.number_value > 0) {
+            timeout = (int)timeout_val.data.number_value;
+        }
+        value_free(&timeout_val);
+    }
+    
+    uint64_t promise_id = 0;
+    Value promise = async_promise_create(interpreter, &promise_id);
+    HttpFetchContext* fetch = promise_id ? shared_malloc_safe(sizeof(HttpFetchContext), "http", "builtin_http_fetch_async", 0) : NULL;
+    if (fetch) {
+        fetch->interpreter = interpreter;
+        fetch->promise_id = promise_id;
+        const char* body = body_val.type == VALUE_STRING ? body_val.data.string_value : NULL;
+        if (!http_client_request_async(url_value.data.string_value, method, headers_str, body, timeout,
+                                       http_fetch_complete, fetch)) {
+            http_fetch_complete(fetch, NULL, "Invalid URL");
+        }
+    }
+    
+    value_free(&body_val);
+    if (headers_str) {
+        shared_free_safe(headers_str, "http", "builtin_http_fetch_async", 0);
+    }
+    return promise;
+}
+
+// Called from the interpreter's event loop. Never blocks: in-flight sockets
+// and timeouts are registered with the reactor, which the loop waits on.
+void http_process_async_requests(Interpreter* interpreter) {
+    if (http_client_pending() == 0) return;
+    http_client_poll(0);
+}
+
 // Register HTTP library with interpreter
 void http_library_register(Interpreter* interpreter) {
     if (!interpreter || !interpreter->global_environment) return;
@@ -723,6 +839,7 @@ void http_library_register(Interpreter* interpreter) {
     value_object_set(&http_lib, "patch", value_create_builtin_function(builtin_http_patch));
     value_object_set(&http_lib, "options", value_create_builtin_function(builtin_http_options));
     value_object_set(&http_lib, "request", value_create_builtin_function(builtin_http_request));
+    value_object_set(&http_lib, "fetchAsync", value_create_builtin_function(builtin_http_fetch_async));
     value_object_set(&http_lib, "statusOk", value_create_builtin_function(builtin_http_status_ok));
     value_object_set(&http_lib, "getHeader", value_create_builtin_function(builtin_http_get_header));
     value_object_set(&http_lib, "getJson", value_create_builtin_function(builtin_http_get_json));
@@ -1,10 +1,16 @@
+// POSIX source so getaddrinfo() and strncasecmp() are declared under -std=c99
+#define _POSIX_C_SOURCE 200809L
 #include "../../include/libs/http_client.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/runtime/reactor.h"
+#include "../../include/libs/compression.h"
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
@@ -20,6 +26,9 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/select.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <strings.h>
 #endif
 
 // Custom HTTP client implementation to replace libcurl
@@ -205,47 +214,331 @@ static uint8_t* create_client_hello(size_t* length) {
 // SSL context for HTTPS
 static SSL_CTX* g_http_ssl_ctx = NULL;
 static bool g_http_ssl_initialized = false;
+static pthread_once_t g_http_ssl_once = PTHREAD_ONCE_INIT;
 
-static bool http_init_ssl(void) {
-    if (g_http_ssl_initialized) return true;
-    
+static void http_init_ssl_once(void) {
     SSL_library_init();
     SSL_load_error_strings();
     OpenSSL_add_all_algorithms();
-    
+
     g_http_ssl_ctx = SSL_CTX_new(TLS_client_method());
     if (!g_http_ssl_ctx) {
-        return false;
+        return;
     }
-    
+
     SSL_CTX_set_options(g_http_ssl_ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+    // Sessions are kept per host by the connection pool below, so OpenSSL
+    // only has to hand them out, not store them
+    SSL_CTX_set_session_cache_mode(g_http_ssl_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
     g_http_ssl_initialized = true;
-    return true;
 }
 
-// Perform TLS handshake using OpenSSL
-static SSL* perform_tls_handshake(int sock, const char* hostname) {
+static bool http_init_ssl(void) {
+    pthread_once(&g_http_ssl_once, http_init_ssl_once);
+    return g_http_ssl_initialized;
+}
+
+// Perform TLS handshake using OpenSSL, resuming session when one is given
+static SSL* perform_tls_handshake(int sock, const char* hostname, SSL_SESSION* session) {
     if (!http_init_ssl()) {
         return NULL;
     }
-    
+
     SSL* ssl = SSL_new(g_http_ssl_ctx);
     if (!ssl) {
         return NULL;
     }
-    
+
     SSL_set_fd(ssl, sock);
     SSL_set_tlsext_host_name(ssl, hostname);
-    
+    if (session) {
+        SSL_set_session(ssl, session);
+    }
+
     int result = SSL_connect(ssl);
     if (result <= 0) {
         SSL_free(ssl);
         return NULL;
     }
-    
+
     return ssl;
 }
 
+// ============================================================================
+// DNS CACHE
+// ============================================================================
+
+// getaddrinfo() doesn't report record TTLs, so answers are kept for a fixed
+// time; a failed connect drops the entry early
+#define HTTP_DNS_CACHE_SIZE 32
+#define HTTP_DNS_TTL_SECONDS 60
+
+typedef struct {
+    char host[256];
+    int port;
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    time_t expires;  // 0 for an empty slot
+} HttpDnsEntry;
+
+static HttpDnsEntry g_http_dns_cache[HTTP_DNS_CACHE_SIZE];
+static pthread_mutex_t g_http_dns_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool http_resolve(const char* host, int port, struct sockaddr_storage* addr, socklen_t* addr_len) {
+    time_t now = time(NULL);
+
+    pthread_mutex_lock(&g_http_dns_mutex);
+    for (size_t i = 0; i < HTTP_DNS_CACHE_SIZE; i++) {
+        HttpDnsEntry* entry = &g_http_dns_cache[i];
+        if (entry->expires > now && entry->port == port && strcmp(entry->host, host) == 0) {
+            memcpy(addr, &entry->addr, entry->addr_len);
+            *addr_len = entry->addr_len;
+            pthread_mutex_unlock(&g_http_dns_mutex);
+            return true;
+        }
+    }
+    pthread_mutex_unlock(&g_http_dns_mutex);
+
+    // Resolve outside the lock so a slow lookup doesn't hold up cached hosts
+    char port_str[16];
+    snprintf(port_str, sizeof(port_str), "%d", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* result = NULL;
+    if (getaddrinfo(host, port_str, &hints, &result) != 0 || !result) {
+        return false;
+    }
+    memcpy(addr, result->ai_addr, result->ai_addrlen);
+    *addr_len = (socklen_t)result->ai_addrlen;
+    freeaddrinfo(result);
+
+    // Refill the matching slot, an empty one or the one expiring first
+    pthread_mutex_lock(&g_http_dns_mutex);
+    HttpDnsEntry* slot = &g_http_dns_cache[0];
+    for (size_t i = 0; i < HTTP_DNS_CACHE_SIZE; i++) {
+        HttpDnsEntry* entry = &g_http_dns_cache[i];
+        if (entry->port == port && strcmp(entry->host, host) == 0) {
+            slot = entry;
+            break;
+        }
+        if (entry->expires < slot->expires) {
+            slot = entry;
+        }
+    }
+    strncpy(slot->host, host, sizeof(slot->host) - 1);
+    slot->host[sizeof(slot->host) - 1] = '\0';
+    slot->port = port;
+    memcpy(&slot->addr, addr, *addr_len);
+    slot->addr_len = *addr_len;
+    slot->expires = now + HTTP_DNS_TTL_SECONDS;
+    pthread_mutex_unlock(&g_http_dns_mutex);
+    return true;
+}
+
+static void http_resolve_forget(const char* host, int port) {
+    pthread_mutex_lock(&g_http_dns_mutex);
+    for (size_t i = 0; i < HTTP_DNS_CACHE_SIZE; i++) {
+        HttpDnsEntry* entry = &g_http_dns_cache[i];
+        if (entry->port == port && strcmp(entry->host, host) == 0) {
+            entry->expires = 0;
+        }
+    }
+    pthread_mutex_unlock(&g_http_dns_mutex);
+}
+
+// ============================================================================
+// CONNECTION POOL
+// ============================================================================
+
+// Idle keep-alive connections and the last TLS session, per scheme, host and
+// port. At most HTTP_POOL_MAX_IDLE_PER_HOST connections wait per host; any
+// more are closed when their request finishes.
+#define HTTP_POOL_MAX_HOSTS 16
+#define HTTP_POOL_MAX_IDLE_PER_HOST 4
+#define HTTP_POOL_IDLE_SECONDS 30
+
+typedef struct {
+    int sock;
+    SSL* ssl;         // NULL for plain HTTP
+    bool reused;      // Taken from the pool rather than freshly connected
+    time_t expires;   // When an idle connection stops being offered
+} HttpConnection;
+
+typedef struct {
+    char host[256];
+    int port;
+    bool https;
+    HttpConnection idle[HTTP_POOL_MAX_IDLE_PER_HOST];
+    int idle_count;
+    SSL_SESSION* session;
+    time_t last_used;  // 0 for an empty slot
+} HttpPoolHost;
+
+static HttpPoolHost g_http_pool[HTTP_POOL_MAX_HOSTS];
+static pthread_mutex_t g_http_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void http_connection_close(HttpConnection* conn) {
+    if (conn->ssl) {
+        SSL_shutdown(conn->ssl);
+        SSL_free(conn->ssl);
+        conn->ssl = NULL;
+    }
+    if (conn->sock >= 0) {
+        close(conn->sock);
+        conn->sock = -1;
+    }
+}
+
+// An idle connection the server has since closed (or written to out of turn)
+// polls readable
+static bool http_connection_alive(const HttpConnection* conn) {
+    if (conn->ssl && SSL_pending(conn->ssl) > 0) return false;
+#ifdef _WIN32
+    return true;
+#else
+    struct pollfd pfd;
+    pfd.fd = conn->sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
+#endif
+}
+
+// Find the pool slot for a host, claiming the least recently used slot when
+// create is set. Called with the pool lock held.
+static HttpPoolHost* http_pool_host(const char* host, int port, bool https, bool create) {
+    HttpPoolHost* victim = &g_http_pool[0];
+    for (size_t i = 0; i < HTTP_POOL_MAX_HOSTS; i++) {
+        HttpPoolHost* entry = &g_http_pool[i];
+        if (entry->last_used && entry->port == port && entry->https == https && strcmp(entry->host, host) == 0) {
+            return entry;
+        }
+        if (entry->last_used < victim->last_used) {
+            victim = entry;
+        }
+    }
+    if (!create) return NULL;
+
+    for (int i = 0; i < victim->idle_count; i++) {
+        http_connection_close(&victim->idle[i]);
+    }
+    if (victim->session) {
+        SSL_SESSION_free(victim->session);
+    }
+    memset(victim, 0, sizeof(*victim));
+    strncpy(victim->host, host, sizeof(victim->host) - 1);
+    victim->port = port;
+    victim->https = https;
+    victim->last_used = time(NULL);
+    return victim;
+}
+
+// Take the most recently used live idle connection for a host
+static bool http_pool_acquire(const char* host, int port, bool https, HttpConnection* conn) {
+    time_t now = time(NULL);
+    bool found = false;
+
+    pthread_mutex_lock(&g_http_pool_mutex);
+    HttpPoolHost* entry = http_pool_host(host, port, https, false);
+    while (entry && entry->idle_count > 0 && !found) {
+        HttpConnection candidate = entry->idle[--entry->idle_count];
+        if (candidate.expires > now && http_connection_alive(&candidate)) {
+            *conn = candidate;
+            conn->reused = true;
+            entry->last_used = now;
+            found = true;
+        } else {
+            http_connection_close(&candidate);
+        }
+    }
+    pthread_mutex_unlock(&g_http_pool_mutex);
+    return found;
+}
+
+// The session to resume for a host, with a reference for the caller
+static SSL_SESSION* http_pool_session(const char* host, int port) {
+    SSL_SESSION* session = NULL;
+    pthread_mutex_lock(&g_http_pool_mutex);
+    HttpPoolHost* entry = http_pool_host(host, port, true, false);
+    if (entry && entry->session) {
+        session = entry->session;
+        SSL_SESSION_up_ref(session);
+    }
+    pthread_mutex_unlock(&g_http_pool_mutex);
+    return session;
+}
+
+// Hand a connection back after a complete response. TLS connections also
+// leave their session behind; under TLS 1.3 the ticket only arrives after
+// the handshake, so it is picked up here rather than right after connecting.
+static void http_pool_release(const char* host, int port, HttpConnection* conn, bool keep_alive, int idle_seconds) {
+    bool https = conn->ssl != NULL;
+    SSL_SESSION* session = https ? SSL_get1_session(conn->ssl) : NULL;
+    if (session && !SSL_SESSION_is_resumable(session)) {
+        SSL_SESSION_free(session);
+        session = NULL;
+    }
+
+    pthread_mutex_lock(&g_http_pool_mutex);
+    HttpPoolHost* entry = http_pool_host(host, port, https, keep_alive || session);
+    if (entry && session) {
+        if (entry->session) SSL_SESSION_free(entry->session);
+        entry->session = session;
+        session = NULL;
+    }
+    if (entry && keep_alive && idle_seconds > 0 && entry->idle_count < HTTP_POOL_MAX_IDLE_PER_HOST) {
+        conn->reused = false;
+        conn->expires = time(NULL) + idle_seconds;
+        entry->idle[entry->idle_count++] = *conn;
+        entry->last_used = time(NULL);
+        conn->sock = -1;
+        conn->ssl = NULL;
+    }
+    pthread_mutex_unlock(&g_http_pool_mutex);
+
+    if (session) SSL_SESSION_free(session);
+    http_connection_close(conn);
+}
+
+// Open a fresh connection; *tls_failed tells a refused handshake apart from
+// a network error
+static bool http_connect(const char* host, int port, bool https, HttpConnection* conn, bool* tls_failed) {
+    conn->sock = -1;
+    conn->ssl = NULL;
+    conn->reused = false;
+    conn->expires = 0;
+    *tls_failed = false;
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len = 0;
+    if (!http_resolve(host, port, &addr, &addr_len)) {
+        return false;
+    }
+
+    conn->sock = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (conn->sock < 0) return false;
+
+    if (connect(conn->sock, (struct sockaddr*)&addr, addr_len) < 0) {
+        http_resolve_forget(host, port);
+        http_connection_close(conn);
+        return false;
+    }
+
+    if (https) {
+        SSL_SESSION* session = http_pool_session(host, port);
+        conn->ssl = perform_tls_handshake(conn->sock, host, session);
+        if (session) SSL_SESSION_free(session);
+        if (!conn->ssl) {
+            *tls_failed = true;
+            http_connection_close(conn);
+            return false;
+        }
+    }
+    return true;
+}
+
 // Parse URL into components
 static int parse_url(const char* url, char* host, int* port, char* path) {
     if (!url || !host || !port || !path) return 0;
@@ -313,7 +606,7 @@ static char* create_http_request(const char* method, const char* path, const cha
         "%s %s HTTP/1.1\r\n"
         "Host: %s\r\n"
         "User-Agent: Myco-HTTP/1.0\r\n"
-        "Connection: close\r\n",
+        "Connection: keep-alive\r\n",
         method, path, host);
     
     // Add custom headers
@@ -361,6 +654,29 @@ static char* create_http_request(const char* method, const char* path, const cha
     return request;
 }
 
+// Value of a response header (case-insensitive name) within the header block
+static const char* http_header_find(const char* headers, size_t headers_length, const char* name, size_t* value_length) {
+    size_t name_length = strlen(name);
+    const char* line = memchr(headers, '\n', headers_length);  // Skip the status line
+    const char* end = headers + headers_length;
+    while (line && line + 1 < end) {
+        line++;
+        const char* line_end = memchr(line, '\n', (size_t)(end - line));
+        if (!line_end) line_end = end;
+        if ((size_t)(line_end - line) > name_length && strncasecmp(line, name, name_length) == 0 &&
+            line[name_length] == ':') {
+            const char* value = line + name_length + 1;
+            while (value < line_end && (*value == ' ' || *value == '\t')) value++;
+            const char* value_end = line_end;
+            while (value_end > value && (value_end[-1] == '\r' || value_end[-1] == ' ')) value_end--;
+            *value_length = (size_t)(value_end - value);
+            return value;
+        }
+        line = line_end < end ? line_end : NULL;
+    }
+    return NULL;
+}
+
 // Parse HTTP response
 static HttpResponse* parse_http_response(const char* response_data, size_t data_len) {
     HttpResponse* response = shared_malloc_safe(sizeof(HttpResponse), "http_client", "parse_http_response", 0);
@@ -429,13 +745,32 @@ static HttpResponse* parse_http_response(const char* response_data, size_t data_
         response->headers[header_len] = '\0';
     }
     
-    // Extract body
+    // Extract body, decoding a gzip or deflate Content-Encoding
     const char* body_start = header_end + 4; // Skip \r\n\r\n
     size_t body_len = data_len - (body_start - response_data);
-    if (body_len > 0) {
+    size_t encoding_len = 0;
+    const char* encoding = http_header_find(response_data, header_len, "Content-Encoding", &encoding_len);
+    bool gzip = encoding && ((encoding_len == 4 && strncasecmp(encoding, "gzip", 4) == 0) ||
+                             (encoding_len == 6 && strncasecmp(encoding, "x-gzip", 6) == 0));
+    bool deflate = encoding && encoding_len == 7 && strncasecmp(encoding, "deflate", 7) == 0;
+    if (body_len > 0 && (gzip || deflate)) {
+        size_t decoded_len = 0;
+        if (gzip) {
+            response->body = decompress_data(body_start, body_len, COMPRESSION_GZIP, &decoded_len);
+        } else {
+            // "deflate" means zlib framing, but some servers send a raw stream
+            response->body = decompress_data(body_start, body_len, COMPRESSION_ZLIB, &decoded_len);
+            if (!response->body) {
+                response->body = decompress_data(body_start, body_len, COMPRESSION_DEFLATE, &decoded_len);
+            }
+        }
+        if (!response->body) {
+            return response;  // Corrupt body: success stays false
+        }
+    } else if (body_len > 0) {
         response->body = shared_malloc_safe(body_len + 1, "http_client", "parse_http_response", 0);
         if (response->body) {
-            strncpy(response->body, body_start, body_len);
+            memcpy(response->body, body_start, body_len);
             response->body[body_len] = '\0';
         }
     }
@@ -444,239 +779,299 @@ static HttpResponse* parse_http_response(const char* response_data, size_t data_
     return response;
 }
 
-// Perform HTTP request using raw sockets
-HttpResponse* http_client_request(const char* url, const char* method, 
+// ============================================================================
+// REQUEST / RESPONSE I/O
+// ============================================================================
+
+// Raw response bytes as they arrive; chunked bodies are decoded in place.
+// Scratch space for one request, so it lives in plain malloc memory.
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} HttpReadBuffer;
+
+static void http_socket_timeout(int sock, int timeout_seconds) {
+    struct timeval timeout;
+    timeout.tv_sec = timeout_seconds > 0 ? timeout_seconds : 0;
+    timeout.tv_usec = 0;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+// One send; < 0 with errno EAGAIN (or an SSL want) means try again later
+static ssize_t http_send_some(HttpConnection* conn, const char* data, size_t length) {
+    if (conn->ssl) {
+        return SSL_write(conn->ssl, data, (int)length);
+    }
+#ifdef MSG_NOSIGNAL
+    return send(conn->sock, data, length, MSG_NOSIGNAL);
+#else
+    return send(conn->sock, data, length, 0);
+#endif
+}
+
+static bool http_write_all(HttpConnection* conn, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = http_send_some(conn, data, length);
+        if (sent <= 0) return false;
+        data += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+// Read whatever is available onto the end of the buffer; <= 0 on EOF/error
+static ssize_t http_read_more(HttpConnection* conn, HttpReadBuffer* buffer) {
+    if (buffer->capacity - buffer->length < 4096 + 1) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 16384;
+        char* data = realloc(buffer->data, capacity);
+        if (!data) return -1;
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    size_t room = buffer->capacity - buffer->length - 1;
+    ssize_t received;
+    if (conn->ssl) {
+        received = SSL_read(conn->ssl, buffer->data + buffer->length, (int)room);
+    } else {
+        received = recv(conn->sock, buffer->data + buffer->length, room, 0);
+    }
+    if (received > 0) {
+        buffer->length += (size_t)received;
+        buffer->data[buffer->length] = '\0';
+    }
+    return received;
+}
+
+static bool http_header_has_token(const char* value, size_t length, const char* token) {
+    size_t token_length = strlen(token);
+    for (size_t i = 0; i + token_length <= length; i++) {
+        if (strncasecmp(value + i, token, token_length) == 0) return true;
+    }
+    return false;
+}
+
+// Offset just past the CRLF ending the line at pos, or 0 if it hasn't arrived
+static size_t http_line_end(const HttpReadBuffer* buffer, size_t pos) {
+    for (size_t i = pos; i + 1 < buffer->length; i++) {
+        if (buffer->data[i] == '\r' && buffer->data[i + 1] == '\n') return i + 2;
+    }
+    return 0;
+}
+
+// Walk a chunked body starting at body_start. Returns the offset just past
+// the terminating chunk and trailers, 0 if more bytes are needed, or -1 if
+// the framing is broken. With decode set (only once the message is known
+// to be complete) the chunk data is also packed down to body_start; the
+// decoded bytes never outrun the encoded ones, so writing behind the read
+// position is safe.
+static long http_chunked_walk(HttpReadBuffer* buffer, size_t body_start, bool decode, size_t* body_end) {
+    size_t write = body_start;
+    size_t pos = body_start;
+    for (;;) {
+        size_t line_end = http_line_end(buffer, pos);
+        if (!line_end) return 0;
+        char* size_end = NULL;
+        unsigned long chunk = strtoul(buffer->data + pos, &size_end, 16);
+        if (size_end == buffer->data + pos) return -1;
+        pos = line_end;
+
+        if (chunk == 0) {
+            // Skip trailers up to the blank line
+            for (;;) {
+                line_end = http_line_end(buffer, pos);
+                if (!line_end) return 0;
+                bool blank = line_end == pos + 2;
+                pos = line_end;
+                if (blank) break;
+            }
+            if (body_end) *body_end = write;
+            return (long)pos;
+        }
+
+        if (pos + chunk + 2 > buffer->length) return 0;
+        if (decode) memmove(buffer->data + write, buffer->data + pos, chunk);
+        write += chunk;
+        pos += chunk + 2;
+    }
+}
+
+// Check whether the buffer holds one complete response, framed by
+// Content-Length, chunked encoding or (with eof set) the end of the stream.
+// Returns 1 once it does, leaving headers plus the plain body in the buffer,
+// 0 if more bytes are needed, and -1 if it never will. *reusable says
+// whether the connection ended cleanly on a message boundary with
+// keep-alive intact; *idle_seconds is how long the server promises to keep
+// it open. Used by both the blocking and the non-blocking reader.
+static int http_response_frame(HttpReadBuffer* buffer, const char* method, bool eof,
+                               bool* reusable, int* idle_seconds) {
+    *reusable = false;
+    *idle_seconds = HTTP_POOL_IDLE_SECONDS;
+
+    char* found = buffer->data ? strstr(buffer->data, "\r\n\r\n") : NULL;
+    if (!found) return eof ? -1 : 0;
+    size_t header_end = (size_t)(found - buffer->data) + 4;
+
+    const char* headers = buffer->data;
+    bool http10 = strncmp(headers, "HTTP/1.0", 8) == 0;
+    int status = 0;
+    const char* space = memchr(headers, ' ', header_end);
+    if (space) status = atoi(space + 1);
+
+    size_t length = 0;
+    const char* value = http_header_find(headers, header_end, "Connection", &length);
+    bool keep_alive = value ? !http_header_has_token(value, length, "close") &&
+                              (!http10 || http_header_has_token(value, length, "keep-alive"))
+                            : !http10;
+    value = http_header_find(headers, header_end, "Keep-Alive", &length);
+    if (value) {
+        for (size_t i = 0; i + 8 <= length; i++) {
+            if (strncasecmp(value + i, "timeout=", 8) == 0) {
+                int server_timeout = atoi(value + i + 8);
+                // Leave a second of slack so we never race the server's close
+                if (server_timeout - 1 < *idle_seconds) *idle_seconds = server_timeout - 1;
+                break;
+            }
+        }
+    }
+
+    bool no_body = strcmp(method, "HEAD") == 0 || (status >= 100 && status < 200) ||
+                   status == 204 || status == 304;
+    const char* transfer = http_header_find(headers, header_end, "Transfer-Encoding", &length);
+    bool chunked = transfer && http_header_has_token(transfer, length, "chunked");
+    const char* content_length = http_header_find(headers, header_end, "Content-Length", &length);
+
+    size_t message_end;
+    if (no_body) {
+        message_end = header_end;
+    } else if (chunked) {
+        long end = http_chunked_walk(buffer, header_end, false, NULL);
+        if (end <= 0) return end < 0 || eof ? -1 : 0;
+        // Anything past the message means the stream is out of step
+        if ((size_t)end != buffer->length) keep_alive = false;
+        http_chunked_walk(buffer, header_end, true, &message_end);
+    } else if (content_length) {
+        message_end = header_end + (size_t)strtoull(content_length, NULL, 10);
+        if (buffer->length < message_end) return eof ? -1 : 0;
+    } else {
+        // Body runs to the end of the connection
+        if (!eof) return 0;
+        message_end = buffer->length;
+        keep_alive = false;
+    }
+
+    if (!chunked && buffer->length != message_end) keep_alive = false;
+    buffer->length = message_end;
+    buffer->data[message_end] = '\0';
+    *reusable = keep_alive;
+    return 1;
+}
+
+// Read one complete response on a blocking connection
+static bool http_read_response(HttpConnection* conn, const char* method, HttpReadBuffer* buffer,
+                               bool* reusable, int* idle_seconds) {
+    for (;;) {
+        int state = http_response_frame(buffer, method, false, reusable, idle_seconds);
+        if (state != 0) return state > 0;
+        if (http_read_more(conn, buffer) <= 0) {
+            return http_response_frame(buffer, method, true, reusable, idle_seconds) > 0;
+        }
+    }
+}
+
+static bool http_method_idempotent(const char* method) {
+    return strcmp(method, "GET") == 0 || strcmp(method, "HEAD") == 0 || strcmp(method, "PUT") == 0 ||
+           strcmp(method, "DELETE") == 0 || strcmp(method, "OPTIONS") == 0;
+}
+
+// Perform HTTP request, reusing a pooled keep-alive connection when possible
+HttpResponse* http_client_request(const char* url, const char* method,
                                 const char* headers, const char* body, int timeout_seconds) {
-    
+
     if (!url || !method) {
         return NULL;
     }
-    
+
     char host[256];
     int port;
     char path[512];
-    
+
     // Parse URL
     if (!parse_url(url, host, &port, path)) {
         return NULL;
     }
-    
+
     // Check if this is HTTPS
     bool is_https = (strncmp(url, "https://", 8) == 0);
-    
-    // Create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0) return NULL;
-    
-    // Set timeout
-    if (timeout_seconds > 0) {
-        struct timeval timeout;
-        timeout.tv_sec = timeout_seconds;
-        timeout.tv_usec = 0;
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-    }
-    
-    // Resolve hostname
-    struct hostent* he = gethostbyname(host);
-    if (!he) {
-        close(sock);
-        return NULL;
-    }
-    
-    // Connect to server
-    struct sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port);
-    memcpy(&server_addr.sin_addr, he->h_addr_list[0], he->h_length);
-    
-    if (connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        close(sock);
-        return NULL;
-    }
-    
-    // Handle HTTPS requests
-    SSL* ssl = NULL;
-    if (is_https) {
-    // Perform TLS handshake
-        ssl = perform_tls_handshake(sock, host);
-        if (!ssl) {
-            close(sock);
-            
-            HttpResponse* response = (HttpResponse*)shared_malloc_safe(sizeof(HttpResponse), "http_client", "http_client_request", 0);
-            if (!response) return NULL;
-            
-            response->status_code = 500; // Internal Server Error
-            response->body = shared_strdup("TLS handshake failed. The server may not support TLS 1.2 or there may be a network issue.");
-            response->headers = shared_strdup("Content-Type: text/plain\r\n");
-            response->success = false;
-            
-            return response;
-        }
-    }
-    
+
     // Create HTTP request
     char* request = create_http_request(method, path, host, headers, body);
     if (!request) {
-        if (ssl) {
-            SSL_shutdown(ssl);
-            SSL_free(ssl);
-        }
-        close(sock);
-        return NULL;
-    }
-    
-    // Send request
-    int sent;
-    if (is_https) {
-        sent = SSL_write(ssl, request, strlen(request));
-    } else {
-        sent = send(sock, request, strlen(request), 0);
-    }
-    if (sent < 0) {
-        shared_free_safe(request, "http_client", "http_client_request", 0);
-        if (ssl) {
-            SSL_shutdown(ssl);
-            SSL_free(ssl);
-        }
-        close(sock);
         return NULL;
     }
-    
-    // Receive response
-    char response_buffer[8192];
-    size_t total_received = 0;
-    ssize_t received;
-    
-    if (is_https) {
-        // For HTTPS, use SSL_read
-        int header_complete = 0;
-        while (!header_complete && total_received < sizeof(response_buffer) - 1) {
-            received = SSL_read(ssl, response_buffer + total_received, 
-                              sizeof(response_buffer) - total_received - 1);
-            if (received <= 0) {
-                if (total_received > 0 && strstr(response_buffer, "HTTP/") != NULL) {
-                    break;
-                }
-                shared_free_safe(request, "http_client", "http_client_request", 0);
-                SSL_shutdown(ssl);
-                SSL_free(ssl);
-                close(sock);
-                return NULL;
-            }
-            total_received += received;
-            response_buffer[total_received] = '\0';
-            
-            if (strstr(response_buffer, "\r\n\r\n") != NULL) {
-                header_complete = 1;
-                
-                const char* content_length_str = strstr(response_buffer, "Content-Length:");
-                if (content_length_str) {
-                    int content_length = atoi(content_length_str + 15);
-                    const char* body_start = strstr(response_buffer, "\r\n\r\n");
-                    if (body_start) {
-                        size_t body_received = total_received - (body_start - response_buffer) - 4;
-                        while (body_received < (size_t)content_length && 
-                               total_received < sizeof(response_buffer) - 1) {
-                            received = SSL_read(ssl, response_buffer + total_received, 
-                                              sizeof(response_buffer) - total_received - 1);
-                            if (received <= 0) break;
-                            total_received += received;
-                            body_received = total_received - (body_start - response_buffer) - 4;
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        // For HTTP, read until we get complete response
-        // First, read until we get headers (double CRLF)
-        int header_complete = 0;
-        while (!header_complete && total_received < sizeof(response_buffer) - 1) {
-            received = recv(sock, response_buffer + total_received, 
-                          sizeof(response_buffer) - total_received - 1, 0);
-            if (received <= 0) {
-                // Connection closed or error - check if we have at least status line
-                if (total_received > 0 && strstr(response_buffer, "HTTP/") != NULL) {
-                    // We have at least a partial response, break and try to parse
-                    break;
-                }
-                // No valid response received
-                shared_free_safe(request, "http_client", "http_client_request", 0);
-                close(sock);
-                return NULL;
-            }
-            total_received += received;
-            response_buffer[total_received] = '\0';
-            
-            // Check if we have complete headers
-            if (strstr(response_buffer, "\r\n\r\n") != NULL) {
-                header_complete = 1;
-                
-                // Check for Content-Length header to read full body
-                const char* content_length_str = strstr(response_buffer, "Content-Length:");
-                if (content_length_str) {
-                    int content_length = atoi(content_length_str + 15); // Skip "Content-Length: "
-                    const char* body_start = strstr(response_buffer, "\r\n\r\n");
-                    if (body_start) {
-                        size_t body_received = total_received - (body_start - response_buffer) - 4;
-                        // Continue reading until we have the full body
-                        while (body_received < (size_t)content_length && 
-                               total_received < sizeof(response_buffer) - 1) {
-                            received = recv(sock, response_buffer + total_received, 
-                                          sizeof(response_buffer) - total_received - 1, 0);
-                            if (received <= 0) break;
-                            total_received += received;
-                            response_buffer[total_received] = '\0';
-                            body_received = total_received - (body_start - response_buffer) - 4;
-                        }
+    size_t request_length = strlen(request);
+
+    HttpResponse* response = NULL;
+    HttpReadBuffer buffer = {NULL, 0, 0};
+
+    // A pooled connection may have been closed by the server while idle; that
+    // shows up as a failed write or an empty read, and the request is sent
+    // again on a fresh connection
+    for (int attempt = 0; attempt < 2 && !response; attempt++) {
+        HttpConnection conn;
+        if (!http_pool_acquire(host, port, is_https, &conn)) {
+            bool tls_failed = false;
+            if (!http_connect(host, port, is_https, &conn, &tls_failed)) {
+                if (tls_failed) {
+                    response = (HttpResponse*)shared_malloc_safe(sizeof(HttpResponse), "http_client", "http_client_request", 0);
+                    if (response) {
+                        response->status_code = 500; // Internal Server Error
+                        response->body = shared_strdup("TLS handshake failed. The server may not support TLS 1.2 or there may be a network issue.");
+                        response->headers = shared_strdup("Content-Type: text/plain\r\n");
+                        response->success = false;
                     }
                 }
                 break;
             }
         }
-        
-        // If we didn't get complete headers, try one more read with a small timeout
-        if (!header_complete && total_received < sizeof(response_buffer) - 1) {
-            // Set a short timeout for final read attempt
-            struct timeval timeout;
-            timeout.tv_sec = 0;
-            timeout.tv_usec = 100000; // 100ms
-            setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-            
-            received = recv(sock, response_buffer + total_received, 
-                          sizeof(response_buffer) - total_received - 1, 0);
-            if (received > 0) {
-                total_received += received;
+        http_socket_timeout(conn.sock, timeout_seconds);
+
+        buffer.length = 0;
+        if (buffer.data) buffer.data[0] = '\0';
+        if (!http_write_all(&conn, request, request_length)) {
+            bool retry = conn.reused;
+            http_connection_close(&conn);
+            if (retry) continue;
+            break;
+        }
+
+        bool reusable = false;
+        int idle_seconds = 0;
+        if (!http_read_response(&conn, method, &buffer, &reusable, &idle_seconds)) {
+            bool retry = conn.reused && buffer.length == 0 && http_method_idempotent(method);
+            http_connection_close(&conn);
+            if (retry) continue;
+            // A response cut short still gets parsed if its status line arrived
+            if (buffer.length > 0 && strstr(buffer.data, "HTTP/") == buffer.data && strstr(buffer.data, "\r\n\r\n")) {
+                response = parse_http_response(buffer.data, buffer.length);
             }
+            break;
         }
-    }
-    
-    response_buffer[total_received] = '\0';
-    
-    // Validate we have at least a status line before parsing
-    if (total_received == 0 || strstr(response_buffer, "HTTP/") == NULL) {
-        shared_free_safe(request, "http_client", "http_client_request", 0);
-        if (ssl) {
-            SSL_shutdown(ssl);
-            SSL_free(ssl);
+
+        http_pool_release(host, port, &conn, reusable, idle_seconds);
+
+        // Validate we have at least a status line before parsing
+        if (buffer.length > 0 && strstr(buffer.data, "HTTP/") != NULL) {
+            response = parse_http_response(buffer.data, buffer.length);
         }
-        close(sock);
-        return NULL;
+        break;
     }
-    
-    // Parse response
-    HttpResponse* response = parse_http_response(response_buffer, total_received);
-    
+
     // Cleanup
     shared_free_safe(request, "http_client", "http_client_request", 0);
-    if (ssl) {
-        SSL_shutdown(ssl);
-        SSL_free(ssl);
-    }
-    close(sock);
-    
+    free(buffer.data);
+
     return response;
 }
 
@@ -693,6 +1088,12 @@ void http_response_free(HttpResponse* response) {
     shared_free_safe(response, "http_client", "http_response_free", 0);
 }
 
+// Value of a response header, or NULL if the server did not send it
+const char* http_response_header(const HttpResponse* response, const char* name, size_t* value_length) {
+    if (!response || !response->headers) return NULL;
+    return http_header_find(response->headers, strlen(response->headers), name, value_length);
+}
+
 // Convenience functions
 HttpResponse* http_get(const char* url, const char* headers, int timeout) {
     return http_client_request(url, "GET", headers, NULL, timeout);
@@ -709,3 +1110,355 @@ HttpResponse* http_put(const char* url, const char* body, const char* headers, i
 HttpResponse* http_delete(const char* url, const char* headers, int timeout) {
     return http_client_request(url, "DELETE", headers, NULL, timeout);
 }
+
+// ============================================================================
+// NON-BLOCKING REQUESTS
+// ============================================================================
+
+// Each request steps through connect -> TLS handshake -> write -> read on a
+// non-blocking socket, advanced by http_client_poll(). Requests share the
+// pool, DNS cache and TLS sessions with the blocking client. The list is
+// owned by the thread that drives it (the interpreter's event loop), and
+// each pass registers the sockets and timeouts with the reactor so that
+// loop can block until a request can move.
+
+typedef enum {
+    HTTP_ASYNC_CONNECTING,
+    HTTP_ASYNC_HANDSHAKING,
+    HTTP_ASYNC_WRITING,
+    HTTP_ASYNC_READING,
+    HTTP_ASYNC_DONE
+} HttpAsyncState;
+
+typedef struct HttpAsyncRequest {
+    HttpAsyncState state;
+    char host[256];
+    int port;
+    bool https;
+    char method[16];
+    char* request;
+    size_t request_length;
+    size_t sent;
+    HttpConnection conn;
+    HttpReadBuffer buffer;
+    short events;              // What the socket is waiting for
+    bool retried;
+    long long deadline_ms;
+    HttpResponse* response;    // Outcome once state is HTTP_ASYNC_DONE
+    const char* error;
+    HttpAsyncCallback callback;
+    void* context;
+    struct HttpAsyncRequest* next;
+} HttpAsyncRequest;
+
+static HttpAsyncRequest* g_http_async_requests = NULL;
+static size_t g_http_async_count = 0;
+
+static long long http_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static bool http_set_nonblocking(int sock, bool nonblocking) {
+#ifdef _WIN32
+    u_long mode = nonblocking ? 1 : 0;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (flags < 0) return false;
+    flags = nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(sock, F_SETFL, flags) == 0;
+#endif
+}
+
+// The poll events a failed non-blocking call is waiting for, or 0 for a
+// real error
+static short http_async_wants(HttpAsyncRequest* req, ssize_t result, short plain_events) {
+    if (req->conn.ssl) {
+        int error = SSL_get_error(req->conn.ssl, (int)result);
+        if (error == SSL_ERROR_WANT_READ) return POLLIN;
+        if (error == SSL_ERROR_WANT_WRITE) return POLLOUT;
+        return 0;
+    }
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return plain_events;
+    }
+    return 0;
+}
+
+static void http_async_done(HttpAsyncRequest* req, HttpResponse* response, const char* error) {
+    reactor_unwatch(req->conn.sock);
+    http_connection_close(&req->conn);
+    req->state = HTTP_ASYNC_DONE;
+    req->response = response;
+    req->error = error;
+    req->events = 0;
+}
+
+// Start a fresh connection; the connect completes in the CONNECTING state
+static void http_async_connect(HttpAsyncRequest* req) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = 0;
+    if (!http_resolve(req->host, req->port, &addr, &addr_len)) {
+        http_async_done(req, NULL, "Could not resolve host");
+        return;
+    }
+
+    req->conn.sock = socket(addr.ss_family, SOCK_STREAM, 0);
+    req->conn.ssl = NULL;
+    req->conn.reused = false;
+    if (req->conn.sock < 0 || !http_set_nonblocking(req->conn.sock, true)) {
+        http_async_done(req, NULL, "Could not create socket");
+        return;
+    }
+
+    if (connect(req->conn.sock, (struct sockaddr*)&addr, addr_len) < 0 && errno != EINPROGRESS) {
+        http_resolve_forget(req->host, req->port);
+        http_async_done(req, NULL, "Connection failed");
+        return;
+    }
+    req->state = HTTP_ASYNC_CONNECTING;
+    req->events = POLLOUT;
+}
+
+// A pooled connection that turned out to be closed: start over once on a
+// fresh one, as the blocking client does
+static bool http_async_retry(HttpAsyncRequest* req) {
+    if (!req->conn.reused || req->retried) return false;
+    reactor_unwatch(req->conn.sock);
+    http_connection_close(&req->conn);
+    req->retried = true;
+    req->sent = 0;
+    req->buffer.length = 0;
+    http_async_connect(req);
+    return true;
+}
+
+static void http_async_finish(HttpAsyncRequest* req, bool reusable, int idle_seconds) {
+    HttpResponse* response = parse_http_response(req->buffer.data, req->buffer.length);
+    reactor_unwatch(req->conn.sock);
+    if (reusable && http_set_nonblocking(req->conn.sock, false)) {
+        http_pool_release(req->host, req->port, &req->conn, true, idle_seconds);
+    } else {
+        http_pool_release(req->host, req->port, &req->conn, false, 0);
+    }
+    http_async_done(req, response, response ? NULL : "Invalid HTTP response");
+}
+
+// Advance a request as far as its socket allows
+static void http_async_step(HttpAsyncRequest* req, short revents) {
+    for (;;) {
+        switch (req->state) {
+            case HTTP_ASYNC_CONNECTING: {
+                if (!(revents & (POLLOUT | POLLERR | POLLHUP))) return;
+                int error = 0;
+                socklen_t length = sizeof(error);
+                if (getsockopt(req->conn.sock, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+                    http_resolve_forget(req->host, req->port);
+                    http_async_done(req, NULL, "Connection failed");
+                    return;
+                }
+                if (req->https) {
+                    if (!http_init_ssl() || !(req->conn.ssl = SSL_new(g_http_ssl_ctx))) {
+                        http_async_done(req, NULL, "TLS setup failed");
+                        return;
+                    }
+                    SSL_set_fd(req->conn.ssl, req->conn.sock);
+                    SSL_set_tlsext_host_name(req->conn.ssl, req->host);
+                    SSL_SESSION* session = http_pool_session(req->host, req->port);
+                    if (session) {
+                        SSL_set_session(req->conn.ssl, session);
+                        SSL_SESSION_free(session);
+                    }
+                    req->state = HTTP_ASYNC_HANDSHAKING;
+                } else {
+                    req->state = HTTP_ASYNC_WRITING;
+                }
+                break;
+            }
+
+            case HTTP_ASYNC_HANDSHAKING: {
+                int result = SSL_connect(req->conn.ssl);
+                if (result == 1) {
+                    req->state = HTTP_ASYNC_WRITING;
+                    break;
+                }
+                short wants = http_async_wants(req, result, 0);
+                if (!wants) {
+                    http_async_done(req, NULL, "TLS handshake failed");
+                    return;
+                }
+                req->events = wants;
+                return;
+            }
+
+            case HTTP_ASYNC_WRITING: {
+                ssize_t sent = http_send_some(&req->conn, req->request + req->sent, req->request_length - req->sent);
+                if (sent > 0) {
+                    req->sent += (size_t)sent;
+                    if (req->sent == req->request_length) {
+                        req->state = HTTP_ASYNC_READING;
+                    }
+                    break;
+                }
+                short wants = http_async_wants(req, sent, POLLOUT);
+                if (wants) {
+                    req->events = wants;
+                    return;
+                }
+                if (!http_async_retry(req)) {
+                    http_async_done(req, NULL, "Failed to send request");
+                }
+                return;
+            }
+
+            case HTTP_ASYNC_READING: {
+                bool reusable = false;
+                int idle_seconds = 0;
+                ssize_t received = http_read_more(&req->conn, &req->buffer);
+                if (received > 0) {
+                    int state = http_response_frame(&req->buffer, req->method, false, &reusable, &idle_seconds);
+                    if (state > 0) {
+                        http_async_finish(req, reusable, idle_seconds);
+                        return;
+                    }
+                    if (state < 0) {
+                        http_async_done(req, NULL, "Invalid HTTP response");
+                        return;
+                    }
+                    break;
+                }
+                short wants = received < 0 ? http_async_wants(req, received, POLLIN) : 0;
+                if (wants) {
+                    req->events = wants;
+                    return;
+                }
+                // End of stream (or a reset)
+                if (req->buffer.length == 0 && http_method_idempotent(req->method) && http_async_retry(req)) {
+                    return;
+                }
+                if (http_response_frame(&req->buffer, req->method, true, &reusable, &idle_seconds) > 0) {
+                    http_async_finish(req, false, 0);
+                } else {
+                    http_async_done(req, NULL, "Connection closed before the response completed");
+                }
+                return;
+            }
+
+            case HTTP_ASYNC_DONE:
+                return;
+        }
+        // The socket may have room (or data) for the next state right away
+        revents = POLLIN | POLLOUT;
+    }
+}
+
+// Start a request without waiting on the network. The callback runs from
+// http_client_poll() with the response (the callee frees it with
+// http_response_free) or NULL and an error message.
+bool http_client_request_async(const char* url, const char* method, const char* headers, const char* body,
+                               int timeout_seconds, HttpAsyncCallback callback, void* context) {
+    if (!url || !method || !callback) return false;
+
+    char path[512];
+    HttpAsyncRequest* req = calloc(1, sizeof(HttpAsyncRequest));
+    if (!req) return false;
+    if (!parse_url(url, req->host, &req->port, path)) {
+        free(req);
+        return false;
+    }
+    req->https = strncmp(url, "https://", 8) == 0;
+    strncpy(req->method, method, sizeof(req->method) - 1);
+    req->request = create_http_request(method, path, req->host, headers, body);
+    if (!req->request) {
+        free(req);
+        return false;
+    }
+    req->request_length = strlen(req->request);
+    req->conn.sock = -1;
+    req->deadline_ms = http_now_ms() + (long long)(timeout_seconds > 0 ? timeout_seconds : 30) * 1000;
+    req->callback = callback;
+    req->context = context;
+
+    if (http_pool_acquire(req->host, req->port, req->https, &req->conn) &&
+        http_set_nonblocking(req->conn.sock, true)) {
+        req->state = HTTP_ASYNC_WRITING;
+        req->events = POLLOUT;
+    } else {
+        http_connection_close(&req->conn);
+        http_async_connect(req);
+    }
+
+    req->next = g_http_async_requests;
+    g_http_async_requests = req;
+    g_http_async_count++;
+    return true;
+}
+
+size_t http_client_pending(void) {
+    return g_http_async_count;
+}
+
+// Wait up to timeout_ms for any in-flight request to make progress, advance
+// them all and run the callbacks of those that finished. Returns how many
+// are still in flight.
+size_t http_client_poll(int timeout_ms) {
+    size_t count = g_http_async_count;
+    if (count == 0) return 0;
+
+    struct pollfd stack_fds[64];
+    struct pollfd* fds = count <= 64 ? stack_fds : malloc(count * sizeof(struct pollfd));
+    if (!fds) return count;
+
+    size_t i = 0;
+    for (HttpAsyncRequest* req = g_http_async_requests; req && i < count; req = req->next, i++) {
+        fds[i].fd = req->state == HTTP_ASYNC_DONE ? -1 : req->conn.sock;
+        fds[i].events = req->events;
+        fds[i].revents = 0;
+        // Finished requests and bytes already decrypted by OpenSSL can't wait
+        if (req->state == HTTP_ASYNC_DONE || (req->conn.ssl && SSL_pending(req->conn.ssl) > 0)) {
+            timeout_ms = 0;
+        }
+    }
+    poll(fds, (nfds_t)i, timeout_ms);
+
+    // Unlink finished requests first so callbacks may start new ones
+    HttpAsyncRequest* finished = NULL;
+    long long now = http_now_ms();
+    HttpAsyncRequest** link = &g_http_async_requests;
+    for (size_t j = 0; *link && j < i; j++) {
+        HttpAsyncRequest* req = *link;
+        short revents = fds[j].revents;
+        if (req->state != HTTP_ASYNC_DONE && (revents || (req->conn.ssl && SSL_pending(req->conn.ssl) > 0))) {
+            http_async_step(req, revents ? revents : POLLIN);
+        }
+        if (req->state != HTTP_ASYNC_DONE && now >= req->deadline_ms) {
+            http_async_done(req, NULL, "Request timed out");
+        }
+        if (req->state == HTTP_ASYNC_DONE) {
+            *link = req->next;
+            req->next = finished;
+            finished = req;
+            g_http_async_count--;
+        } else {
+            reactor_watch(req->conn.sock, ((req->events & POLLIN) ? REACTOR_READ : 0) |
+                                          ((req->events & POLLOUT) ? REACTOR_WRITE : 0));
+            // Bytes OpenSSL already decrypted won't show up as readable
+            bool buffered = req->conn.ssl && SSL_pending(req->conn.ssl) > 0;
+            reactor_schedule(buffered ? 0 : (uint64_t)req->deadline_ms);
+            link = &req->next;
+        }
+    }
+    if (fds != stack_fds) free(fds);
+
+    while (finished) {
+        HttpAsyncRequest* req = finished;
+        finished = req->next;
+        req->callback(req->context, req->response, req->error);
+        shared_free_safe(req->request, "http_client", "http_client_poll", 0);
+        free(req->buffer.data);
+        free(req);
+    }
+    return g_http_async_count;
+}
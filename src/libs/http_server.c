@@ -1,6 +1,9 @@
 #include "../../include/libs/http_server.h"
 #include "../../include/libs/server/server.h"
+#include "../../include/libs/server/router.h"
+#include "../../include/libs/server/static_cache.h"
 #include "../../include/libs/json.h"
+#include "../../include/libs/compression.h"
 #include "../../include/utils/shared_utilities.h"
 #include "../../include/core/interpreter.h"
 
@@ -10,14 +13,12 @@ extern Value builtin_json_parse(Interpreter* interpreter, Value* args, size_t ar
 extern Value builtin_json_validate(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 #include <pthread.h>
 
-// Global mutex for thread-safe interpreter access
+// Global mutex for thread-safe interpreter access (workers take it around Myco handlers)
 static pthread_mutex_t g_interpreter_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 // Forward declarations for static file serving
 extern StaticRoute* g_static_routes;
 extern StaticRoute* static_route_match(const char* url);
-extern bool file_exists(const char* file_path);
-extern char* read_file_content(const char* file_path, size_t* file_size);
 extern char* get_mime_type(const char* file_path);
 
 // Forward declarations for route handling
@@ -47,16 +48,42 @@ Value builtin_response_status(Interpreter* interpreter, Value* args, size_t arg_
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <dirent.h>
-#include <sys/event.h>
+#include <strings.h>
+#include <netinet/tcp.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#else
+#include <sys/event.h>
+#endif
 
 // Maximum number of routes
 #define MAX_ROUTES 100
 
+// Request size limits (larger requests get 431 / 413)
+#define HTTP_MAX_HEADER_BYTES (64 * 1024)
+#define HTTP_MAX_BODY_BYTES (16 * 1024 * 1024)
+
+// Input buffered for one connection; a request still incomplete at this
+// size gets 413
+#define HTTP_MAX_REQUEST_BYTES (HTTP_MAX_HEADER_BYTES + HTTP_MAX_BODY_BYTES)
+
+// Connections with no traffic for this long are closed, whether idle between
+// requests or stalled partway through one
+#define HTTP_IDLE_TIMEOUT_SECONDS 60
+
+// Smaller dynamic bodies aren't worth compressing
+#define HTTP_GZIP_MIN_BYTES 1024
+
+// Larger dynamic bodies are sent from the handler's buffer after the headers
+// instead of being copied in behind them
+#define HTTP_BODY_HANDOFF_BYTES (16 * 1024)
+
 // Global server instance
 static HttpServer* g_http_server = NULL;
 static bool g_server_running = false;
-static HttpServer* g_server = NULL;
 
 // Match route path with parameters (e.g., /api/users/:id matches /api/users/123)
 static bool match_route_path(const char* route_path, const char* request_path) {
@@ -82,130 +109,464 @@ static bool match_route_path(const char* route_path, const char* request_path) {
     return (*route_ptr == '\0' && *request_ptr == '\0');
 }
 
-// Parse HTTP request from buffer
-static HttpRequest* parse_http_request_buffer(const char* buffer, ssize_t length) {
-    HttpRequest* request = shared_malloc_safe(sizeof(HttpRequest), "http_server", "parse_http_request", 0);
-    if (!request) return NULL;
-    
-    // Initialize request
-    request->method = NULL;
-    request->path = NULL;
-    request->headers = NULL;
-    request->body = NULL;
-    request->query_string = NULL;
-    
-    // Parse first line (method, path, version)
-    char* line_end = strstr(buffer, "\r\n");
-    if (!line_end) {
-        shared_free_safe(request, "http_server", "parse_http_request", 0);
-        return NULL;
+// ============================================================================
+// REQUEST PARSING
+// ============================================================================
+// Requests are parsed straight out of a connection's input buffer, which may
+// hold a partial request or several pipelined ones. The parser reports how
+// many bytes the first complete request used, or that more bytes are needed.
+
+// Find the blank line ending the header block; returns its offset or -1
+static long find_header_end(const char* buffer, size_t length) {
+    for (size_t i = 0; i + 3 < length; i++) {
+        if (buffer[i] == '\r' && buffer[i + 1] == '\n' && buffer[i + 2] == '\r' && buffer[i + 3] == '\n') {
+            return (long)i;
+        }
     }
-    
-    // Copy first line
-    size_t line_len = line_end - buffer;
-    char* first_line = shared_malloc_safe(line_len + 1, "http_server", "parse_http_request", 0);
-    if (!first_line) {
-        shared_free_safe(request, "http_server", "parse_http_request", 0);
-        return NULL;
+    return -1;
+}
+
+// Find the next CRLF at or after start; returns its offset or -1
+static long find_crlf(const char* buffer, size_t length, size_t start) {
+    for (size_t i = start; i + 1 < length; i++) {
+        if (buffer[i] == '\r' && buffer[i + 1] == '\n') return (long)i;
     }
-    
-    strncpy(first_line, buffer, line_len);
-    first_line[line_len] = '\0';
-    
-    // Parse method and path
-    char* method_end = strchr(first_line, ' ');
-    if (!method_end) {
-        shared_free_safe(first_line, "http_server", "parse_http_request", 0);
-        shared_free_safe(request, "http_server", "parse_http_request", 0);
-        return NULL;
+    return -1;
+}
+
+// Does a comma-separated header value contain token (case-insensitive)?
+static bool header_has_token(const char* value, size_t value_len, const char* token) {
+    size_t token_len = strlen(token);
+    size_t i = 0;
+    while (i < value_len) {
+        while (i < value_len && (value[i] == ' ' || value[i] == '\t' || value[i] == ',')) i++;
+        size_t start = i;
+        while (i < value_len && value[i] != ',') i++;
+        size_t end = i;
+        while (end > start && (value[end - 1] == ' ' || value[end - 1] == '\t')) end--;
+        if (end - start == token_len && strncasecmp(value + start, token, token_len) == 0) return true;
     }
-    
-    *method_end = '\0';
-    request->method = shared_strdup(first_line);
-    
-    char* path_start = method_end + 1;
-    char* path_end = strchr(path_start, ' ');
-    if (!path_end) {
-        shared_free_safe(first_line, "http_server", "parse_http_request", 0);
-        shared_free_safe(request, "http_server", "parse_http_request", 0);
-        return NULL;
+    return false;
+}
+
+// Where an incomplete request's parse stopped. A connection keeps one across
+// reads, so each read resumes there instead of rescanning its buffer.
+typedef struct {
+    size_t header_scanned;   // Bytes already searched for the end of the header block
+    bool head_parsed;        // The header block is complete and the fields below are set
+    size_t start;            // Offset of the request line (after blank lines)
+    size_t head_len;         // Header block length, up to the blank line
+    size_t line_end;         // Request line length
+    size_t method_len;
+    size_t target_off;       // Request target, relative to start
+    size_t target_len;
+    bool keep_alive;
+    bool chunked;
+    bool has_length;
+    bool expect_continue;
+    size_t content_length;
+    size_t chunk_pos;        // Next chunk-size or trailer line (0: start of the body)
+    size_t chunk_total;      // Body bytes in the chunks before chunk_pos
+    size_t trailer_start;    // Start of the trailer fields (0: not reached yet)
+    size_t line_scanned;     // Bytes already searched for the end of the line at chunk_pos
+} HttpParseState;
+
+// Walk a chunked body starting at start. Returns 1 once the final chunk and
+// trailers are buffered (setting the decoded size and the end offset, and
+// copying the data when out is non-NULL), 0 if more bytes are needed, -1 if
+// the framing is invalid and -2 if the trailers exceed HTTP_MAX_HEADER_BYTES.
+// With a state, a walk that needs more bytes records where it stopped and
+// the next call resumes there.
+static int decode_chunked_body(const char* buffer, size_t length, size_t start,
+                               char* out, size_t* body_length, size_t* end, HttpParseState* state) {
+    size_t pos = state && state->chunk_pos ? state->chunk_pos : start;
+    size_t total = state ? state->chunk_total : 0;
+    size_t trailer_start = state ? state->trailer_start : 0;
+    size_t scanned = state && state->chunk_pos ? state->line_scanned : pos;
+    for (;;) {
+        // Resume a line search where the last read left off, one byte back
+        // in case the CRLF was split
+        size_t from = scanned > pos ? scanned - 1 : pos;
+        long line_end = find_crlf(buffer, length, from);
+        scanned = pos;
+        if (line_end < 0) {
+            if (trailer_start != 0 && length - trailer_start > HTTP_MAX_HEADER_BYTES) return -2;
+            if (trailer_start == 0 && length - pos > 1024) return -1;
+            if (state) {
+                state->chunk_pos = pos;
+                state->chunk_total = total;
+                state->trailer_start = trailer_start;
+                state->line_scanned = length;
+            }
+            return 0;
+        }
+
+        if (trailer_start != 0) {
+            // Skip trailer fields up to the blank line
+            bool blank = (size_t)line_end == pos;
+            pos = (size_t)line_end + 2;
+            if (pos - trailer_start > HTTP_MAX_HEADER_BYTES) return -2;
+            if (!blank) continue;
+            *body_length = total;
+            *end = pos;
+            return 1;
+        }
+
+        size_t chunk_size = 0;
+        size_t digits = 0;
+        for (size_t i = pos; i < (size_t)line_end && buffer[i] != ';'; i++) {
+            char c = buffer[i];
+            int digit;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+            else if (c == ' ' || c == '\t') continue;
+            else return -1;
+            if (chunk_size > (HTTP_MAX_BODY_BYTES >> 4)) return -1;
+            chunk_size = (chunk_size << 4) | (size_t)digit;
+            digits++;
+        }
+        if (digits == 0) return -1;
+
+        if (chunk_size == 0) {
+            pos = (size_t)line_end + 2;
+            trailer_start = pos;
+            continue;
+        }
+
+        if (total + chunk_size > HTTP_MAX_BODY_BYTES) return -1;
+        size_t data = (size_t)line_end + 2;
+        if (length < data + chunk_size + 2) {
+            // The size line is re-read on the next call; its CRLF is known
+            if (state) {
+                state->chunk_pos = pos;
+                state->chunk_total = total;
+                state->trailer_start = 0;
+                state->line_scanned = (size_t)line_end + 1;
+            }
+            return 0;
+        }
+        if (buffer[data + chunk_size] != '\r' || buffer[data + chunk_size + 1] != '\n') return -1;
+        if (out) memcpy(out + total, buffer + data, chunk_size);
+        total += chunk_size;
+        pos = data + chunk_size + 2;
     }
-    
-    *path_end = '\0';
-    request->path = shared_strdup(path_start);
-    
+}
+
+static void free_http_request(HttpRequest* request) {
+    if (!request) return;
+    if (request->method) shared_free_safe(request->method, "http_server", "free_http_request", 0);
+    if (request->path) shared_free_safe(request->path, "http_server", "free_http_request", 0);
+    if (request->headers) shared_free_safe(request->headers, "http_server", "free_http_request", 0);
+    if (request->body) shared_free_safe(request->body, "http_server", "free_http_request", 0);
+    if (request->query_string) shared_free_safe(request->query_string, "http_server", "free_http_request", 0);
+    shared_free_safe(request, "http_server", "free_http_request", 0);
+}
+
+static char* copy_range(const char* start, size_t length) {
+    char* copy = shared_malloc_safe(length + 1, "http_server", "copy_range", 0);
+    if (!copy) return NULL;
+    memcpy(copy, start, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Find a header in a parsed request; returns the value (not NUL-terminated)
+static const char* http_request_header(const HttpRequest* request, const char* name, size_t* value_len) {
+    size_t name_len = strlen(name);
+    const char* line = request->headers;
+    while (line && *line) {
+        const char* line_end = strstr(line, "\r\n");
+        size_t line_len = line_end ? (size_t)(line_end - line) : strlen(line);
+        if (line_len > name_len && line[name_len] == ':' && strncasecmp(line, name, name_len) == 0) {
+            const char* value = line + name_len + 1;
+            size_t length = line_len - name_len - 1;
+            while (length > 0 && (*value == ' ' || *value == '\t')) {
+                value++;
+                length--;
+            }
+            while (length > 0 && (value[length - 1] == ' ' || value[length - 1] == '\t')) length--;
+            *value_len = length;
+            return value;
+        }
+        line = line_end ? line_end + 2 : NULL;
+    }
+    return NULL;
+}
+
+// Parse the first request in buffer, resuming from state.
+// Returns 1 with *out and *consumed set when the whole request is buffered,
+// 0 when more bytes are needed (*expects_continue is set if the client sent
+// "Expect: 100-continue" and is waiting to send its body), or -1 with
+// *status set to the error status to answer with. The caller resets state
+// once the request is consumed or rejected.
+static int parse_http_request_buffer(const char* buffer, size_t length, HttpParseState* state,
+                                     HttpRequest** out, size_t* consumed, bool* expects_continue, int* status) {
+    *out = NULL;
+    *consumed = 0;
+    *expects_continue = false;
+    *status = 400;
+
+    if (!state->head_parsed) {
+        // Tolerate blank lines between pipelined requests
+        size_t start = 0;
+        while (start + 1 < length && buffer[start] == '\r' && buffer[start + 1] == '\n') start += 2;
+
+        // Resume the search three bytes back in case the blank line was split
+        size_t from = state->header_scanned > start + 3 ? state->header_scanned - 3 : start;
+        long header_end = find_header_end(buffer + from, length - from);
+        if (header_end < 0) {
+            if (length - start > HTTP_MAX_HEADER_BYTES) {
+                *status = 431;
+                return -1;
+            }
+            state->header_scanned = length;
+            return 0;
+        }
+        const char* head = buffer + start;
+        size_t head_len = from - start + (size_t)header_end;
+        if (head_len > HTTP_MAX_HEADER_BYTES) {
+            *status = 431;
+            return -1;
+        }
+
+        // Request line: METHOD SP target SP HTTP/1.x
+        long line_end = find_crlf(head, head_len + 2, 0);
+        const char* method_end = memchr(head, ' ', (size_t)line_end);
+        if (!method_end || method_end == head) return -1;
+        const char* target = method_end + 1;
+        const char* target_end = memchr(target, ' ', (size_t)(head + line_end - target));
+        if (!target_end || target_end == target) return -1;
+        const char* version = target_end + 1;
+        size_t version_len = (size_t)(head + line_end - version);
+        if (version_len != 8 || strncmp(version, "HTTP/1.", 7) != 0 ||
+            (version[7] != '0' && version[7] != '1')) {
+            return -1;
+        }
+        bool http11 = version[7] == '1';
+
+        // Header fields
+        bool keep_alive = http11;
+        bool chunked = false;
+        bool has_length = false;
+        size_t content_length = 0;
+        bool expect_continue = false;
+        size_t pos = (size_t)line_end + 2;
+        while (pos < head_len) {
+            long field_end = find_crlf(head, head_len + 2, pos);
+            const char* field = head + pos;
+            size_t field_len = (size_t)field_end - pos;
+            pos = (size_t)field_end + 2;
+            const char* colon = memchr(field, ':', field_len);
+            if (!colon) return -1;
+            size_t name_len = (size_t)(colon - field);
+            const char* value = colon + 1;
+            size_t value_len = field_len - name_len - 1;
+            while (value_len > 0 && (*value == ' ' || *value == '\t')) {
+                value++;
+                value_len--;
+            }
+            while (value_len > 0 && (value[value_len - 1] == ' ' || value[value_len - 1] == '\t')) value_len--;
+
+            if (name_len == 14 && strncasecmp(field, "Content-Length", 14) == 0) {
+                size_t parsed = 0;
+                if (value_len == 0) return -1;
+                for (size_t i = 0; i < value_len; i++) {
+                    if (value[i] < '0' || value[i] > '9') return -1;
+                    if (parsed > HTTP_MAX_BODY_BYTES) break;
+                    parsed = parsed * 10 + (size_t)(value[i] - '0');
+                }
+                if (has_length && parsed != content_length) return -1;
+                has_length = true;
+                content_length = parsed;
+            } else if (name_len == 17 && strncasecmp(field, "Transfer-Encoding", 17) == 0) {
+                if (!header_has_token(value, value_len, "chunked")) {
+                    *status = 501;
+                    return -1;
+                }
+                chunked = true;
+            } else if (name_len == 10 && strncasecmp(field, "Connection", 10) == 0) {
+                if (header_has_token(value, value_len, "close")) keep_alive = false;
+                else if (header_has_token(value, value_len, "keep-alive")) keep_alive = true;
+            } else if (name_len == 6 && strncasecmp(field, "Expect", 6) == 0) {
+                expect_continue = value_len == 12 && strncasecmp(value, "100-continue", 12) == 0;
+            }
+        }
+
+        state->head_parsed = true;
+        state->start = start;
+        state->head_len = head_len;
+        state->line_end = (size_t)line_end;
+        state->method_len = (size_t)(method_end - head);
+        state->target_off = (size_t)(target - head);
+        state->target_len = (size_t)(target_end - target);
+        state->keep_alive = keep_alive;
+        state->chunked = chunked;
+        state->has_length = has_length;
+        state->content_length = content_length;
+        state->expect_continue = expect_continue;
+    }
+
+    // Body framing: chunked wins over Content-Length
+    size_t body_start = state->start + state->head_len + 4;
+    size_t body_length = 0;
+    size_t request_end = body_start;
+    if (state->chunked) {
+        int framed = decode_chunked_body(buffer, length, body_start, NULL, &body_length, &request_end, state);
+        if (framed < 0) {
+            if (framed == -2) *status = 431;
+            else *status = length - body_start > HTTP_MAX_BODY_BYTES ? 413 : 400;
+            return -1;
+        }
+        if (framed == 0) {
+            *expects_continue = state->expect_continue && length == body_start;
+            return 0;
+        }
+    } else if (state->has_length) {
+        if (state->content_length > HTTP_MAX_BODY_BYTES) {
+            *status = 413;
+            return -1;
+        }
+        body_length = state->content_length;
+        request_end = body_start + body_length;
+        if (length < request_end) {
+            *expects_continue = state->expect_continue && length == body_start;
+            return 0;
+        }
+    }
+
+    HttpRequest* request = shared_malloc_safe(sizeof(HttpRequest), "http_server", "parse_http_request", 0);
+    if (!request) {
+        *status = 500;
+        return -1;
+    }
+    memset(request, 0, sizeof(HttpRequest));
+    const char* head = buffer + state->start;
+    size_t head_len = state->head_len;
+    size_t line_end = state->line_end;
+    request->keep_alive = state->keep_alive;
+    request->method = copy_range(head, state->method_len);
+    request->path = copy_range(head + state->target_off, state->target_len);
+    request->headers = copy_range(head + line_end + 2, head_len > line_end ? head_len - line_end - 2 : 0);
+    request->body_length = body_length;
+    request->body = shared_malloc_safe(body_length + 1, "http_server", "parse_http_request", 0);
+    if (!request->method || !request->path || !request->headers || !request->body) {
+        free_http_request(request);
+        *status = 500;
+        return -1;
+    }
+    if (state->chunked) {
+        size_t ignored_end;
+        decode_chunked_body(buffer, length, body_start, request->body, &body_length, &ignored_end, NULL);
+    } else if (body_length > 0) {
+        memcpy(request->body, buffer + body_start, body_length);
+    }
+    request->body[body_length] = '\0';
+
     // Parse query string
     char* query_start = strchr(request->path, '?');
     if (query_start) {
         *query_start = '\0';
         request->query_string = shared_strdup(query_start + 1);
     }
-    
-    // Parse headers (simplified - just store the raw headers)
-    char* headers_start = line_end + 2;
-    char* headers_end = strstr(headers_start, "\r\n\r\n");
-    if (headers_end) {
-        size_t headers_len = headers_end - headers_start;
-        request->headers = shared_malloc_safe(headers_len + 1, "http_server", "parse_http_request", 0);
-        if (request->headers) {
-            strncpy(request->headers, headers_start, headers_len);
-            request->headers[headers_len] = '\0';
-        }
-        
-        // Parse body
-        char* body_start = headers_end + 4;
-        size_t body_len = length - (body_start - buffer);
-        if (body_len > 0) {
-            request->body = shared_malloc_safe(body_len + 1, "http_server", "parse_http_request", 0);
-            if (request->body) {
-                strncpy(request->body, body_start, body_len);
-                request->body[body_len] = '\0';
-            }
-        }
+
+    *out = request;
+    *consumed = request_end;
+    return 1;
+}
+
+// ============================================================================
+// RESPONSES
+// ============================================================================
+
+static const char* http_status_text(int status_code) {
+    switch (status_code) {
+        case 100: return "Continue";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 416: return "Range Not Satisfiable";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "OK";
     }
-    
-    shared_free_safe(first_line, "http_server", "parse_http_request", 0);
-    return request;
 }
 
-// Create HTTP response string
-static char* create_http_response_string(int status_code, const char* content_type, 
-                                 const char* body, size_t* response_len) {
-    const char* status_text = "OK";
-    if (status_code == 404) status_text = "Not Found";
-    else if (status_code == 500) status_text = "Internal Server Error";
-    
-    size_t body_len = body ? strlen(body) : 0;
-    char* response = shared_malloc_safe(1024 + body_len, "http_server", "create_http_response", 0);
-    if (!response) return NULL;
-    
-    snprintf(response, 1024 + body_len,
+// Format the status line and headers; extra_headers are CRLF-terminated lines.
+// Content-Length is left out when content_length is negative.
+static int format_http_response_head(char* head, size_t head_size, int status_code, const char* content_type,
+                                     long long content_length, bool keep_alive, const char* extra_headers) {
+    char length_line[48] = "";
+    if (content_length >= 0) {
+        snprintf(length_line, sizeof(length_line), "Content-Length: %lld\r\n", content_length);
+    }
+    int head_len = snprintf(head, head_size,
         "HTTP/1.1 %d %s\r\n"
         "Content-Type: %s\r\n"
-        "Content-Length: %zu\r\n"
+        "%s"
+        "%s"
         "Access-Control-Allow-Origin: *\r\n"
         "Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\n"
         "Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n"
         "Access-Control-Max-Age: 86400\r\n"
-        "Connection: close\r\n"
-        "\r\n%s",
-        status_code, status_text, content_type, body_len, body ? body : "");
-    
-    *response_len = strlen(response);
+        "Connection: %s\r\n"
+        "\r\n",
+        status_code, http_status_text(status_code), content_type ? content_type : "text/plain",
+        length_line, extra_headers ? extra_headers : "", keep_alive ? "keep-alive" : "close");
+    if (head_len < 0 || (size_t)head_len >= head_size) return -1;
+    return head_len;
+}
+
+// Create HTTP response string (the body may contain NULs)
+static char* create_http_response_string(int status_code, const char* content_type,
+                                 const char* body, size_t body_len, bool keep_alive,
+                                 const char* extra_headers, size_t* response_len) {
+    char head[1024];
+    int head_len = format_http_response_head(head, sizeof(head), status_code, content_type,
+                                             (long long)body_len, keep_alive, extra_headers);
+    if (head_len < 0) return NULL;
+
+    char* response = shared_malloc_safe((size_t)head_len + body_len + 1, "http_server", "create_http_response", 0);
+    if (!response) return NULL;
+    memcpy(response, head, (size_t)head_len);
+    if (body_len > 0) memcpy(response + head_len, body, body_len);
+    response[head_len + body_len] = '\0';
+
+    *response_len = (size_t)head_len + body_len;
     return response;
 }
 
-// Bridge function to call Myco route handlers
-static void myco_route_handler(HttpRequest* request, HttpResponse* response) {
-    
-    // Find the matching Myco route
-    Route* myco_route = route_match(g_routes, request->method, request->path);
-    if (!myco_route) {
-        response->status_code = 404;
-        response->body = shared_strdup("404 Not Found");
-        return;
+// Copy a captured route parameter into a Myco string
+static Value route_param_string(const RouteMatchParam* param) {
+    char stack_buffer[256];
+    char* value = stack_buffer;
+    if (param->value_length >= sizeof(stack_buffer)) {
+        value = shared_malloc_safe(param->value_length + 1, "http_server", "route_param_string", 0);
+        if (!value) return value_create_null();
     }
-    
+    memcpy(value, param->value, param->value_length);
+    value[param->value_length] = '\0';
+    Value result = value_create_string(value);
+    if (value != stack_buffer) shared_free_safe(value, "http_server", "route_param_string", 0);
+    return result;
+}
+
+// Bridge function to call Myco route handlers (caller holds g_interpreter_mutex)
+static void myco_route_handler_locked(HttpRequest* request, HttpResponse* response, const RouteMatch* match) {
+    Route* myco_route = match->route;
     
     // Check if we have an interpreter and the route has a handler
     if (!g_interpreter || myco_route->handler.type != VALUE_FUNCTION) {
@@ -232,6 +593,21 @@ static void myco_route_handler(HttpRequest* request, HttpResponse* response) {
     value_object_set(&req_obj, "path", value_create_string(request->path ? request->path : "/"));
     value_object_set(&req_obj, "body", value_create_string(request->body ? request->body : ""));
 
+    // Route parameters captured by the router, read with request.param(name)
+    Value params_obj = value_create_object(match->param_count > 0 ? match->param_count : 1);
+    for (size_t i = 0; i < match->param_count; i++) {
+        char name[128];
+        size_t name_length = match->params[i].name_length < sizeof(name) - 1 ? match->params[i].name_length : sizeof(name) - 1;
+        memcpy(name, match->params[i].name, name_length);
+        name[name_length] = '\0';
+        Value param_value = route_param_string(&match->params[i]);
+        value_object_set(&params_obj, name, param_value);
+        value_free(&param_value);
+    }
+    value_object_set(&req_obj, "params", params_obj);
+    value_free(&params_obj);
+    value_object_set(&req_obj, "param", value_create_builtin_function(builtin_request_param));
+
     Value res_obj = value_create_object(8);
     value_object_set(&res_obj, "__class_name__", value_create_string("Response"));
     value_object_set(&res_obj, "statusCode", value_create_number(200));
@@ -241,8 +617,9 @@ static void myco_route_handler(HttpRequest* request, HttpResponse* response) {
     value_object_set(&res_obj, "send", value_create_builtin_function(builtin_response_send));
     
     // Execute the Myco handler directly without complex function execution
-    // This avoids the memory corruption issues with execute_myco_function
-    if (myco_route->handler.type == VALUE_FUNCTION && myco_route->handler.data.function_value.body) {
+    // This avoids the memory corruption issues with execute_myco_function.
+    // A bytecode handler's body holds its function id, and id 0 is valid.
+    if (myco_route->handler.type == VALUE_FUNCTION) {
         // Use the global interpreter but ensure proper isolation
         Interpreter* request_interpreter = g_interpreter;
         
@@ -273,12 +650,17 @@ static void myco_route_handler(HttpRequest* request, HttpResponse* response) {
     // Get response data from globals
     response->status_code = g_response_status_code;
     if (g_response_content_type) {
-        response->content_type = g_response_content_type;
+        // The global is replaced by the next handler, so keep a copy
+        response->content_type = shared_strdup(g_response_content_type);
+        response->owns_content_type = response->content_type != NULL;
     } else {
         response->content_type = "application/json";
     }
     if (g_response_body) {
-        response->body = shared_strdup(g_response_body);
+        // Take the body over instead of copying it; the next handler starts
+        // from an empty global anyway
+        response->body = g_response_body;
+        g_response_body = NULL;
     } else {
         response->body = shared_strdup("{\"message\": \"OK\"}");
     }
@@ -287,25 +669,283 @@ static void myco_route_handler(HttpRequest* request, HttpResponse* response) {
     // They will be cleaned up by the interpreter
 }
 
-// Handle client connection
-static void handle_client_connection(int client_fd, HttpServer* server) {
-    char buffer[4096];
-    ssize_t bytes_received = recv(client_fd, buffer, sizeof(buffer) - 1, 0);
-    
-    if (bytes_received <= 0) {
-        close(client_fd);
-        return;
+// Workers run handlers concurrently, but the interpreter and the response
+// globals are shared, so Myco handlers run one at a time
+static void myco_route_handler(HttpRequest* request, HttpResponse* response, const RouteMatch* match) {
+    pthread_mutex_lock(&g_interpreter_mutex);
+    myco_route_handler_locked(request, response, match);
+    pthread_mutex_unlock(&g_interpreter_mutex);
+}
+
+// ============================================================================
+// REQUEST PROCESSING (worker threads)
+// ============================================================================
+
+// A response body sent straight from the static cache, an open file or a
+// handler's buffer instead of being copied into the response buffer
+typedef struct {
+    StaticCacheEntry* entry;  // Holds data alive, or NULL
+    char* owned;              // Handler body released with the source, or NULL
+    const char* data;         // Cached bytes (plain or gzip variant) or owned
+    int fd;                   // File sent with sendfile(), or -1
+    off_t offset;
+    size_t length;            // Bytes still to send
+} HttpBodySource;
+
+static void http_body_source_init(HttpBodySource* body) {
+    body->entry = NULL;
+    body->owned = NULL;
+    body->data = NULL;
+    body->fd = -1;
+    body->offset = 0;
+    body->length = 0;
+}
+
+static void http_body_source_release(HttpBodySource* body) {
+    if (body->entry) static_cache_release(body->entry);
+    if (body->owned) shared_free_safe(body->owned, "http_server", "http_body_source_release", 0);
+    if (body->fd >= 0) close(body->fd);
+    http_body_source_init(body);
+}
+
+// Does an If-None-Match list name etag? Uses the weak comparison, so a
+// W/ prefix is ignored, and "*" matches any current file.
+static bool http_etag_list_matches(const char* value, size_t value_len, const char* etag) {
+    size_t etag_len = strlen(etag);
+    size_t i = 0;
+    while (i < value_len) {
+        while (i < value_len && (value[i] == ' ' || value[i] == '\t' || value[i] == ',')) i++;
+        size_t start = i;
+        while (i < value_len && value[i] != ',') i++;
+        size_t end = i;
+        while (end > start && (value[end - 1] == ' ' || value[end - 1] == '\t')) end--;
+
+        const char* tag = value + start;
+        size_t tag_len = end - start;
+        if (tag_len == 1 && tag[0] == '*') return true;
+        if (tag_len >= 2 && tag[0] == 'W' && tag[1] == '/') {
+            tag += 2;
+            tag_len -= 2;
+        }
+        if (tag_len == etag_len && memcmp(tag, etag, etag_len) == 0) return true;
     }
-    
-    buffer[bytes_received] = '\0';
-    
-    // Parse HTTP request
-    HttpRequest* request = parse_http_request_buffer(buffer, bytes_received);
-    if (!request) {
-        close(client_fd);
-        return;
+    return false;
+}
+
+// Does Accept-Encoding allow gzip? "gzip;q=0" and "*;q=0" refuse it.
+static bool http_request_accepts_gzip(const HttpRequest* request) {
+    size_t value_len = 0;
+    const char* value = http_request_header(request, "Accept-Encoding", &value_len);
+    if (!value) return false;
+
+    int gzip_allowed = -1;
+    int wildcard_allowed = -1;
+    size_t i = 0;
+    while (i < value_len) {
+        while (i < value_len && (value[i] == ' ' || value[i] == '\t' || value[i] == ',')) i++;
+        size_t start = i;
+        while (i < value_len && value[i] != ',' && value[i] != ';' && value[i] != ' ' && value[i] != '\t') i++;
+        size_t token_len = i - start;
+
+        // An explicit zero quality refuses the coding
+        bool allowed = true;
+        while (i < value_len && value[i] != ',') {
+            if (value[i] == 'q' && i + 1 < value_len && value[i + 1] == '=') {
+                size_t q = i + 2;
+                allowed = false;
+                while (q < value_len && (value[q] == '0' || value[q] == '.')) q++;
+                if (q < value_len && value[q] >= '1' && value[q] <= '9') allowed = true;
+            }
+            i++;
+        }
+
+        if ((token_len == 4 && strncasecmp(value + start, "gzip", 4) == 0) ||
+            (token_len == 6 && strncasecmp(value + start, "x-gzip", 6) == 0)) {
+            gzip_allowed = allowed;
+        } else if (token_len == 1 && value[start] == '*') {
+            wildcard_allowed = allowed;
+        }
     }
-    
+    return gzip_allowed >= 0 ? gzip_allowed == 1 : wildcard_allowed == 1;
+}
+
+// Content types worth compressing on the fly
+static bool http_content_type_compressible(const char* content_type) {
+    if (!content_type) return false;
+    return strncmp(content_type, "text/", 5) == 0 || strstr(content_type, "json") != NULL ||
+           strstr(content_type, "javascript") != NULL || strstr(content_type, "xml") != NULL;
+}
+
+// Parse a single "bytes=first-last" range against a file of size bytes.
+// Returns 1 with *first/*last set, 0 when the header should be ignored (the
+// whole file is sent) and -1 when the range cannot be satisfied.
+static int http_parse_byte_range(const char* value, size_t value_len, long long size,
+                                 long long* first, long long* last) {
+    char spec[64];
+    if (value_len <= 6 || strncasecmp(value, "bytes=", 6) != 0) return 0;
+    size_t spec_len = value_len - 6;
+    if (spec_len >= sizeof(spec)) return 0;
+    memcpy(spec, value + 6, spec_len);
+    spec[spec_len] = '\0';
+
+    // Multipart responses aren't supported; a full 200 is always valid
+    if (strchr(spec, ',')) return 0;
+    char* dash = strchr(spec, '-');
+    if (!dash) return 0;
+
+    char* end = NULL;
+    if (dash == spec) {
+        // "-N": the last N bytes
+        long long suffix = strtoll(dash + 1, &end, 10);
+        if (end == dash + 1 || *end != '\0') return 0;
+        if (suffix <= 0 || size == 0) return -1;
+        *first = suffix >= size ? 0 : size - suffix;
+        *last = size - 1;
+        return 1;
+    }
+
+    *dash = '\0';
+    long long start = strtoll(spec, &end, 10);
+    if (end == spec || *end != '\0' || start < 0) return 0;
+    long long stop = size - 1;
+    if (dash[1] != '\0') {
+        stop = strtoll(dash + 1, &end, 10);
+        if (*end != '\0' || stop < start) return 0;
+        if (stop > size - 1) stop = size - 1;
+    }
+    if (start >= size) return -1;
+    *first = start;
+    *last = stop;
+    return 1;
+}
+
+// Serve file_path for a server.static route. Returns false when there is no
+// such file, so the request falls through to the other routes. Otherwise
+// *response holds the response head (or the whole response for 304/416)
+// and *body the bytes to send after it.
+static bool http_server_respond_static(HttpRequest* request, const StaticRoute* route, const char* file_path,
+                                       bool keep_alive, char** response, size_t* response_len, HttpBodySource* body) {
+    struct stat st;
+    StaticCacheEntry* entry = static_cache_acquire(file_path, &st);
+    int fd = -1;
+    if (!entry) {
+        // Too large to cache: send it from the descriptor
+        if (!S_ISREG(st.st_mode)) return false;
+        fd = open(file_path, O_RDONLY);
+        if (fd < 0) return false;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            close(fd);
+            return false;
+        }
+    }
+
+    char etag[48];
+    char last_modified[40];
+    if (entry) {
+        memcpy(etag, entry->etag, sizeof(etag));
+        memcpy(last_modified, entry->last_modified, sizeof(last_modified));
+    } else {
+        static_cache_validators(&st, etag, sizeof(etag), last_modified, sizeof(last_modified));
+    }
+    const char* mime_type = entry ? entry->mime_type : get_mime_type(file_path);
+    if (!mime_type) mime_type = "application/octet-stream";
+    long long size = (long long)st.st_size;
+    const char* data = entry ? entry->data : NULL;
+
+    // Cached text files on a gzip route also have a compressed variant,
+    // which gets its own validator
+    bool negotiated = entry && route->enable_gzip && should_compress_file(file_path);
+    bool use_gzip = negotiated && http_request_accepts_gzip(request) && static_cache_gzip(entry);
+    if (use_gzip) {
+        size_t etag_len = strlen(etag);
+        if (etag_len >= 2 && etag_len + 3 < sizeof(etag)) memcpy(etag + etag_len - 1, "-gz\"", 5);
+        size = (long long)entry->gzip_size;
+        data = entry->gzip_data;
+    }
+    char encoding_headers[64];
+    snprintf(encoding_headers, sizeof(encoding_headers), "%s%s",
+             use_gzip ? "Content-Encoding: gzip\r\n" : "", negotiated ? "Vary: Accept-Encoding\r\n" : "");
+
+    // If-None-Match takes precedence over If-Modified-Since
+    int status = 200;
+    size_t value_len = 0;
+    const char* none_match = http_request_header(request, "If-None-Match", &value_len);
+    if (none_match) {
+        if (http_etag_list_matches(none_match, value_len, etag)) status = 304;
+    } else {
+        const char* since = http_request_header(request, "If-Modified-Since", &value_len);
+        char date[64];
+        if (since && value_len < sizeof(date)) {
+            memcpy(date, since, value_len);
+            date[value_len] = '\0';
+            time_t since_time = static_cache_parse_http_date(date);
+            if (since_time != (time_t)-1 && st.st_mtime <= since_time) status = 304;
+        }
+    }
+
+    long long first = 0;
+    long long last = size - 1;
+    if (status == 200) {
+        const char* range = http_request_header(request, "Range", &value_len);
+        // With If-Range the range only applies while the client's copy is current
+        size_t if_range_len = 0;
+        const char* if_range = http_request_header(request, "If-Range", &if_range_len);
+        bool range_valid = !if_range ||
+            (if_range_len == strlen(etag) && memcmp(if_range, etag, if_range_len) == 0) ||
+            (if_range_len == strlen(last_modified) && memcmp(if_range, last_modified, if_range_len) == 0);
+        if (range && range_valid) {
+            int parsed = http_parse_byte_range(range, value_len, size, &first, &last);
+            if (parsed > 0) status = 206;
+            else if (parsed < 0) status = 416;
+        }
+    }
+
+    char extra_headers[384];
+    long long content_length = -1;
+    if (status == 416) {
+        snprintf(extra_headers, sizeof(extra_headers), "Content-Range: bytes */%lld\r\n%s", size, encoding_headers);
+        content_length = 0;
+    } else if (status == 206) {
+        snprintf(extra_headers, sizeof(extra_headers),
+                 "ETag: %s\r\nLast-Modified: %s\r\nAccept-Ranges: bytes\r\nContent-Range: bytes %lld-%lld/%lld\r\n%s",
+                 etag, last_modified, first, last, size, encoding_headers);
+        content_length = last - first + 1;
+    } else {
+        snprintf(extra_headers, sizeof(extra_headers), "ETag: %s\r\nLast-Modified: %s\r\nAccept-Ranges: bytes\r\n%s",
+                 etag, last_modified, encoding_headers);
+        if (status == 200) content_length = size;
+    }
+
+    char head[1024];
+    int head_len = format_http_response_head(head, sizeof(head), status, status == 416 ? "text/plain" : mime_type,
+                                             content_length, keep_alive, extra_headers);
+    *response = NULL;
+    *response_len = 0;
+    if (head_len >= 0) {
+        *response = shared_malloc_safe((size_t)head_len + 1, "http_server", "http_server_respond_static", 0);
+        if (*response) {
+            memcpy(*response, head, (size_t)head_len + 1);
+            *response_len = (size_t)head_len;
+        }
+    }
+
+    if (*response && content_length > 0) {
+        body->entry = entry;
+        body->data = data;
+        body->fd = fd;
+        body->offset = (off_t)first;
+        body->length = (size_t)content_length;
+    } else {
+        if (entry) static_cache_release(entry);
+        if (fd >= 0) close(fd);
+    }
+    return true;
+}
+
+// Route a request and build the response bytes; a static file body is
+// left in *body for the event loop to send
+static char* http_server_respond(HttpServer* server, HttpRequest* request, bool keep_alive,
+                                 size_t* response_len, HttpBodySource* body_source) {
     // Check for static file serving first (only for GET requests)
     if (strcmp(request->method, "GET") == 0) {
         StaticRoute* static_route = static_route_match(request->path);
@@ -313,282 +953,943 @@ static void handle_client_connection(int client_fd, HttpServer* server) {
             // Build the full file path
             char file_path[1024];
             const char* relative_path = request->path + strlen(static_route->url_prefix);
-            
+
             // If the relative path is empty (root path "/"), default to index.html
             if (relative_path[0] == '\0' || strcmp(relative_path, "/") == 0) {
                 snprintf(file_path, sizeof(file_path), "%sindex.html", static_route->file_path);
             } else {
                 snprintf(file_path, sizeof(file_path), "%s%s", static_route->file_path, relative_path);
             }
-            
-            // Check if file exists
-            if (file_exists(file_path)) {
-                size_t file_size;
-                char* file_content = read_file_content(file_path, &file_size);
-                if (file_content) {
-                    // Get MIME type
-                    char* mime_type = get_mime_type(file_path);
-                    
-                    // Create response with file content
-                    HttpResponse* response = shared_malloc_safe(sizeof(HttpResponse), "http_server", "handle_client_connection", 0);
-                    if (response) {
-                        response->status_code = 200;
-                        response->content_type = mime_type ? mime_type : "application/octet-stream";
-                        response->body = file_content;
-                        
-                        // Send response
-                        size_t response_len;
-                        char* http_response = create_http_response_string(response->status_code, response->content_type,
-                                                                response->body, &response_len);
-                        if (http_response) {
-                            send(client_fd, http_response, response_len, 0);
-                            shared_free_safe(http_response, "http_server", "handle_client_connection", 0);
-                        }
-                        
-                        // Cleanup response and file content
-                        if (response->body) {
-                            shared_free_safe(response->body, "http_server", "handle_client_connection", 0);
-                        }
-                        shared_free_safe(response, "http_server", "handle_client_connection", 0);
-                    }
-                    
-                    // mime_type is a string literal, don't free it
-                    close(client_fd);
-                    return;
-                }
+
+            char* http_response = NULL;
+            if (http_server_respond_static(request, static_route, file_path, keep_alive,
+                                           &http_response, response_len, body_source)) {
+                return http_response;
             }
         }
     }
-    
+
     // Handle CORS preflight requests (OPTIONS)
     if (strcmp(request->method, "OPTIONS") == 0) {
-        size_t response_len;
-        char* http_response = create_http_response_string(200, "text/plain", "", &response_len);
-        if (http_response) {
-            send(client_fd, http_response, response_len, 0);
-            shared_free_safe(http_response, "http_server", "handle_client_connection", 0);
-        }
-        close(client_fd);
-        shared_free_safe(request->method, "http_server", "handle_client_connection", 0);
-        shared_free_safe(request->path, "http_server", "handle_client_connection", 0);
-        shared_free_safe(request->headers, "http_server", "handle_client_connection", 0);
-        shared_free_safe(request->body, "http_server", "handle_client_connection", 0);
-        shared_free_safe(request, "http_server", "handle_client_connection", 0);
-        return;
+        return create_http_response_string(200, "text/plain", "", 0, keep_alive, NULL, response_len);
     }
-    
-    // Find matching route
+
+    // Find matching route, exact paths first
     HttpRouteHandler handler = NULL;
     for (size_t i = 0; i < server->route_count; i++) {
         HttpRoute* route = &server->routes[i];
-        if (strcmp(route->method, request->method) == 0 && 
+        if (strcmp(route->method, request->method) == 0 &&
             strcmp(route->path, request->path) == 0) {
             handler = route->handler;
             break;
         }
     }
-    
-    if (!handler) {
-    }
-    
+
     // If no exact match, try to find a route with parameters
     if (!handler) {
         for (size_t i = 0; i < server->route_count; i++) {
             HttpRoute* route = &server->routes[i];
-            if (strcmp(route->method, request->method) == 0 && 
+            if (strcmp(route->method, request->method) == 0 &&
                 match_route_path(route->path, request->path)) {
                 handler = route->handler;
                 break;
             }
         }
     }
-    
-    // Create response
-    HttpResponse* response = shared_malloc_safe(sizeof(HttpResponse), "http_server", "handle_client_connection", 0);
-    if (response) {
-        response->status_code = 200;
-        response->content_type = "text/plain";
-        response->body = NULL;
-        
-        if (handler) {
-            // Call route handler
-            handler(request, response);
-        } else {
-            // 404 Not Found
-            response->status_code = 404;
-            response->body = shared_strdup("404 Not Found");
+
+    HttpResponse response;
+    memset(&response, 0, sizeof(response));
+    response.status_code = 200;
+    response.content_type = "text/plain";
+
+    // Myco routes come from the compiled route table
+    RouteMatch match;
+    if (handler) {
+        handler(request, &response);
+    } else if (route_table_match(server->myco_routes, request->method, request->path, &match)) {
+        myco_route_handler(request, &response, &match);
+    } else {
+        response.status_code = 404;
+        response.body = shared_strdup("404 Not Found");
+    }
+
+    const char* body = response.body ? response.body : "";
+    size_t body_length = response.body_length ? response.body_length : strlen(body);
+
+    // Compress larger text bodies when server.create() enabled gzip
+    char* compressed = NULL;
+    const char* extra_headers = NULL;
+    if (server->enable_gzip && body_length >= HTTP_GZIP_MIN_BYTES &&
+        http_content_type_compressible(response.content_type) && http_request_accepts_gzip(request)) {
+        size_t compressed_length = 0;
+        compressed = compress_data_level(body, body_length, COMPRESSION_GZIP, COMPRESSION_LEVEL_DEFAULT,
+                                         &compressed_length);
+        if (compressed && is_compression_beneficial(body_length, compressed_length)) {
+            body = compressed;
+            body_length = compressed_length;
+            extra_headers = "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n";
+        }
+    }
+    char* http_response = NULL;
+    if (!compressed && response.body && body_length >= HTTP_BODY_HANDOFF_BYTES) {
+        char head[1024];
+        int head_len = format_http_response_head(head, sizeof(head), response.status_code, response.content_type,
+                                                 (long long)body_length, keep_alive, extra_headers);
+        if (head_len >= 0) {
+            http_response = shared_malloc_safe((size_t)head_len + 1, "http_server", "http_server_respond", 0);
         }
-        
-        // Send response
-        size_t response_len;
-        char* http_response = create_http_response_string(response->status_code, response->content_type,
-                                                response->body, &response_len);
         if (http_response) {
-            send(client_fd, http_response, response_len, 0);
-            shared_free_safe(http_response, "http_server", "handle_client_connection", 0);
+            memcpy(http_response, head, (size_t)head_len + 1);
+            *response_len = (size_t)head_len;
+            body_source->owned = response.body;
+            body_source->data = response.body;
+            body_source->length = body_length;
+            response.body = NULL;
         }
-        
-        // Cleanup response
-        if (response->body) {
-            shared_free_safe(response->body, "http_server", "handle_client_connection", 0);
+    } else {
+        http_response = create_http_response_string(response.status_code, response.content_type,
+                                                    body, body_length, keep_alive, extra_headers, response_len);
+    }
+    if (compressed) shared_free_safe(compressed, "http_server", "http_server_respond", 0);
+
+    if (response.body) {
+        shared_free_safe(response.body, "http_server", "http_server_respond", 0);
+    }
+    if (response.owns_content_type && response.content_type) {
+        shared_free_safe(response.content_type, "http_server", "http_server_respond", 0);
+    }
+    return http_response;
+}
+
+// A request travelling from the event loop to a worker and back
+struct HttpJob {
+    HttpConnection* connection;  // Only dereferenced on the event loop thread
+    HttpRequest* request;
+    bool keep_alive;
+    char* response;
+    size_t response_len;
+    HttpBodySource body;         // Sent after response
+    HttpJob* next;
+};
+
+static void http_job_free(HttpJob* job) {
+    if (!job) return;
+    free_http_request(job->request);
+    if (job->response) shared_free_safe(job->response, "http_server", "http_job_free", 0);
+    http_body_source_release(&job->body);
+    shared_free_safe(job, "http_server", "http_job_free", 0);
+}
+
+static void* http_worker_main(void* arg) {
+    HttpServer* server = (HttpServer*)arg;
+
+    pthread_mutex_lock(&server->queue_mutex);
+    for (;;) {
+        while (!server->pending_head && !server->stopping) {
+            pthread_cond_wait(&server->queue_cond, &server->queue_mutex);
         }
-        shared_free_safe(response, "http_server", "handle_client_connection", 0);
+        if (server->stopping) break;
+
+        HttpJob* job = server->pending_head;
+        server->pending_head = job->next;
+        if (!server->pending_head) server->pending_tail = NULL;
+        job->next = NULL;
+        pthread_mutex_unlock(&server->queue_mutex);
+
+        job->response = http_server_respond(server, job->request, job->keep_alive && server->running,
+                                            &job->response_len, &job->body);
+
+        pthread_mutex_lock(&server->queue_mutex);
+        if (server->stopping) {
+            http_job_free(job);
+            break;
+        }
+        if (server->done_tail) server->done_tail->next = job;
+        else server->done_head = job;
+        server->done_tail = job;
+
+        // Wake the event loop; a full pipe already guarantees a wakeup
+        char signal_byte = 1;
+        ssize_t ignored = write(server->wake_fds[1], &signal_byte, 1);
+        (void)ignored;
+    }
+    pthread_mutex_unlock(&server->queue_mutex);
+    return NULL;
+}
+
+// ============================================================================
+// POLLER
+// ============================================================================
+// Level-triggered readiness on top of epoll (Linux) or kqueue (macOS/BSD).
+// Each registration carries an owner pointer: a connection, or one of the
+// markers below for the listening socket and the wake pipe.
+
+#define HTTP_POLL_READ  1
+#define HTTP_POLL_WRITE 2
+#define HTTP_POLL_BATCH 128
+
+typedef struct {
+    void* owner;
+    int events;
+} HttpPollEvent;
+
+static char http_listen_marker;
+static char http_wake_marker;
+
+static int http_poll_create(void) {
+#if defined(__linux__)
+    return epoll_create1(EPOLL_CLOEXEC);
+#else
+    return kqueue();
+#endif
+}
+
+// Change the interest set of fd from old_events to new_events (0 = not watched)
+static int http_poll_set(int poll_fd, int fd, void* owner, int old_events, int new_events) {
+    if (old_events == new_events) return 0;
+#if defined(__linux__)
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = ((new_events & HTTP_POLL_READ) ? EPOLLIN : 0) | ((new_events & HTTP_POLL_WRITE) ? EPOLLOUT : 0);
+    event.data.ptr = owner;
+    if (new_events == 0) return epoll_ctl(poll_fd, EPOLL_CTL_DEL, fd, &event);
+    return epoll_ctl(poll_fd, old_events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+#else
+    struct kevent changes[2];
+    int change_count = 0;
+    if ((old_events ^ new_events) & HTTP_POLL_READ) {
+        EV_SET(&changes[change_count++], fd, EVFILT_READ,
+               (new_events & HTTP_POLL_READ) ? EV_ADD | EV_ENABLE : EV_DELETE, 0, 0, owner);
+    }
+    if ((old_events ^ new_events) & HTTP_POLL_WRITE) {
+        EV_SET(&changes[change_count++], fd, EVFILT_WRITE,
+               (new_events & HTTP_POLL_WRITE) ? EV_ADD | EV_ENABLE : EV_DELETE, 0, 0, owner);
+    }
+    return kevent(poll_fd, changes, change_count, NULL, 0, NULL);
+#endif
+}
+
+static int http_poll_wait(int poll_fd, HttpPollEvent* out, int max_events, int timeout_ms) {
+#if defined(__linux__)
+    struct epoll_event events[HTTP_POLL_BATCH];
+    if (max_events > HTTP_POLL_BATCH) max_events = HTTP_POLL_BATCH;
+    int count = epoll_wait(poll_fd, events, max_events, timeout_ms);
+    for (int i = 0; i < count; i++) {
+        out[i].owner = events[i].data.ptr;
+        out[i].events = 0;
+        // Errors and hangups surface through recv()
+        if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) out[i].events |= HTTP_POLL_READ;
+        if (events[i].events & EPOLLOUT) out[i].events |= HTTP_POLL_WRITE;
+    }
+    return count;
+#else
+    struct kevent events[HTTP_POLL_BATCH];
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    if (max_events > HTTP_POLL_BATCH) max_events = HTTP_POLL_BATCH;
+    int count = kevent(poll_fd, NULL, 0, events, max_events, timeout_ms < 0 ? NULL : &timeout);
+    for (int i = 0; i < count; i++) {
+        out[i].owner = (void*)events[i].udata;
+        out[i].events = events[i].filter == EVFILT_WRITE ? HTTP_POLL_WRITE : HTTP_POLL_READ;
+    }
+    return count;
+#endif
+}
+
+// ============================================================================
+// CONNECTIONS (event loop thread)
+// ============================================================================
+// A connection has at most one request with the workers at a time. While it
+// is busy the socket is not read, so pipelined requests wait in the kernel
+// buffer (or in `in`) and their responses go out in request order.
+
+static time_t http_monotonic_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec;
+}
+
+struct HttpConnection {
+    int fd;
+    int interest;            // HTTP_POLL_* bits currently registered
+    char* in;                // Received bytes not yet parsed into a request
+    size_t in_len;
+    size_t in_cap;
+    HttpParseState parse;    // How far the request at the start of `in` has been parsed
+    time_t last_active;      // Last read or write progress (http_monotonic_seconds)
+    char* out;               // Response bytes not yet sent
+    size_t out_len;
+    size_t out_sent;
+    HttpBodySource body;     // Static file body, sent once out has drained
+    bool busy;               // A request is with the worker pool
+    bool close_after_write;  // Close once out has drained
+    bool peer_closed;        // recv() returned 0
+    bool continue_sent;      // "100 Continue" sent for the buffered request
+    bool closed;             // fd closed; freed once the worker returns
+    HttpConnection* prev;
+    HttpConnection* next;
+};
+
+static void http_connection_free(HttpConnection* conn) {
+    if (conn->in) shared_free_safe(conn->in, "http_server", "http_connection_free", 0);
+    if (conn->out) shared_free_safe(conn->out, "http_server", "http_connection_free", 0);
+    http_body_source_release(&conn->body);
+    shared_free_safe(conn, "http_server", "http_connection_free", 0);
+}
+
+// Connections are freed after the current poll batch, since kqueue can
+// report the same socket twice in one batch
+static void http_connection_close(HttpServer* server, HttpConnection* conn) {
+    if (conn->closed) return;
+    http_poll_set(server->poll_fd, conn->fd, conn, conn->interest, 0);
+    close(conn->fd);
+    conn->fd = -1;
+    conn->interest = 0;
+    conn->closed = true;
+
+    if (conn->prev) conn->prev->next = conn->next;
+    else server->connections = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+    server->connection_count--;
+
+    conn->prev = NULL;
+    conn->next = NULL;
+    if (!conn->busy) {
+        conn->next = server->closed_connections;
+        server->closed_connections = conn;
+    }
+}
+
+static bool http_connection_append(HttpConnection* conn, const char* data, size_t length) {
+    size_t pending = conn->out_len - conn->out_sent;
+    if (conn->out_sent > 0) {
+        memmove(conn->out, conn->out + conn->out_sent, pending);
+        conn->out_len = pending;
+        conn->out_sent = 0;
+    }
+    char* grown = shared_realloc_safe(conn->out, conn->out_len + length, "http_server", "http_connection_append", 0);
+    if (!grown) return false;
+    conn->out = grown;
+    memcpy(conn->out + conn->out_len, data, length);
+    conn->out_len += length;
+    return true;
+}
+
+static ssize_t http_send(int fd, const char* data, size_t length) {
+#ifdef MSG_NOSIGNAL
+    return send(fd, data, length, MSG_NOSIGNAL);
+#else
+    return send(fd, data, length, 0);
+#endif
+}
+
+// Send the next piece of a static file or handler body
+static ssize_t http_send_body(int fd, HttpBodySource* body) {
+    if (body->entry || body->owned) {
+        return http_send(fd, body->data + body->offset, body->length);
+    }
+#if defined(__linux__)
+    off_t offset = body->offset;
+    return sendfile(fd, body->fd, &offset, body->length);
+#else
+    char chunk[16384];
+    ssize_t got = pread(body->fd, chunk, body->length < sizeof(chunk) ? body->length : sizeof(chunk), body->offset);
+    if (got <= 0) return got < 0 ? -1 : 0;
+    return http_send(fd, chunk, (size_t)got);
+#endif
+}
+
+// Send as much pending output as the socket takes
+static void http_connection_flush(HttpConnection* conn) {
+    while (conn->out_sent < conn->out_len) {
+        ssize_t sent = http_send(conn->fd, conn->out + conn->out_sent, conn->out_len - conn->out_sent);
+        if (sent > 0) {
+            conn->out_sent += (size_t)sent;
+            conn->last_active = http_monotonic_seconds();
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            // The peer is gone; drop whatever is left
+            conn->peer_closed = true;
+            conn->close_after_write = true;
+            break;
+        }
+    }
+    conn->out_len = 0;
+    conn->out_sent = 0;
+
+    while (conn->body.length > 0 && !conn->peer_closed) {
+        ssize_t sent = http_send_body(conn->fd, &conn->body);
+        if (sent > 0) {
+            conn->body.offset += sent;
+            conn->body.length -= (size_t)sent;
+            conn->last_active = http_monotonic_seconds();
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            // The peer is gone, or the file shrank below its Content-Length
+            conn->peer_closed = true;
+            conn->close_after_write = true;
+        }
+    }
+    http_body_source_release(&conn->body);
+}
+
+// Re-register interest after a state change, closing finished connections
+static void http_connection_update(HttpServer* server, HttpConnection* conn) {
+    if (conn->closed) return;
+    bool has_output = conn->out_sent < conn->out_len || conn->body.length > 0;
+    if (!conn->busy && !has_output && conn->close_after_write) {
+        http_connection_close(server, conn);
+        return;
+    }
+
+    int interest = 0;
+    if (!conn->busy && !has_output && !conn->close_after_write && !conn->peer_closed) interest |= HTTP_POLL_READ;
+    if (has_output) interest |= HTTP_POLL_WRITE;
+    if (http_poll_set(server->poll_fd, conn->fd, conn, conn->interest, interest) < 0) {
+        http_connection_close(server, conn);
+        return;
+    }
+    conn->interest = interest;
+}
+
+// Hand the next buffered request to the workers, or answer a parse error
+static void http_connection_advance(HttpServer* server, HttpConnection* conn) {
+    if (conn->closed) return;
+
+    // A pipelined request waits until the previous file body is out, so
+    // responses stay in order
+    http_connection_flush(conn);
+    if (!conn->busy && conn->body.length == 0 && !conn->close_after_write && conn->in_len > 0) {
+        HttpRequest* request = NULL;
+        size_t consumed = 0;
+        bool expects_continue = false;
+        int status = 400;
+        int parsed = parse_http_request_buffer(conn->in, conn->in_len, &conn->parse, &request, &consumed,
+                                               &expects_continue, &status);
+        if (parsed == 0 && conn->in_len >= HTTP_MAX_REQUEST_BYTES) {
+            // The buffer is full and the request still isn't complete
+            parsed = -1;
+            status = 413;
+        }
+        if (parsed != 0) memset(&conn->parse, 0, sizeof(conn->parse));
+        if (parsed > 0) {
+            memmove(conn->in, conn->in + consumed, conn->in_len - consumed);
+            conn->in_len -= consumed;
+            conn->continue_sent = false;
+
+            HttpJob* job = shared_malloc_safe(sizeof(HttpJob), "http_server", "http_connection_advance", 0);
+            if (!job) {
+                free_http_request(request);
+                http_connection_close(server, conn);
+                return;
+            }
+            memset(job, 0, sizeof(HttpJob));
+            job->connection = conn;
+            job->request = request;
+            job->keep_alive = request->keep_alive && !conn->peer_closed;
+            http_body_source_init(&job->body);
+            conn->busy = true;
+
+            pthread_mutex_lock(&server->queue_mutex);
+            if (server->pending_tail) server->pending_tail->next = job;
+            else server->pending_head = job;
+            server->pending_tail = job;
+            pthread_cond_signal(&server->queue_cond);
+            pthread_mutex_unlock(&server->queue_mutex);
+        } else if (parsed == 0) {
+            if (expects_continue && !conn->continue_sent) {
+                static const char continue_line[] = "HTTP/1.1 100 Continue\r\n\r\n";
+                http_connection_append(conn, continue_line, sizeof(continue_line) - 1);
+                conn->continue_sent = true;
+            }
+        } else {
+            size_t response_len = 0;
+            const char* reason = http_status_text(status);
+            char* response = create_http_response_string(status, "text/plain", reason, strlen(reason), false, NULL, &response_len);
+            if (response) {
+                http_connection_append(conn, response, response_len);
+                shared_free_safe(response, "http_server", "http_connection_advance", 0);
+            }
+            conn->in_len = 0;
+            conn->close_after_write = true;
+        }
+    }
+
+    // Nothing more can arrive, so a partial request is abandoned
+    if (conn->peer_closed && !conn->busy) conn->close_after_write = true;
+
+    http_connection_flush(conn);
+    http_connection_update(server, conn);
+}
+
+static void http_connection_on_readable(HttpServer* server, HttpConnection* conn) {
+    for (;;) {
+        // A full buffer is answered with 413 by http_connection_advance
+        // unless it starts with a complete request
+        if (conn->in_len >= HTTP_MAX_REQUEST_BYTES) break;
+        if (conn->in_cap - conn->in_len < 4096 && conn->in_cap < HTTP_MAX_REQUEST_BYTES) {
+            size_t capacity = conn->in_cap ? conn->in_cap * 2 : 8192;
+            if (capacity > HTTP_MAX_REQUEST_BYTES) capacity = HTTP_MAX_REQUEST_BYTES;
+            char* grown = shared_realloc_safe(conn->in, capacity, "http_server", "http_connection_on_readable", 0);
+            if (!grown) {
+                http_connection_close(server, conn);
+                return;
+            }
+            conn->in = grown;
+            conn->in_cap = capacity;
+        }
+
+        ssize_t received = recv(conn->fd, conn->in + conn->in_len, conn->in_cap - conn->in_len, 0);
+        if (received > 0) {
+            conn->in_len += (size_t)received;
+            conn->last_active = http_monotonic_seconds();
+        } else if (received == 0) {
+            conn->peer_closed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            http_connection_close(server, conn);
+            return;
+        }
+    }
+    http_connection_advance(server, conn);
+}
+
+// Raise the descriptor limit so max_connections can actually be reached
+static void http_server_raise_fd_limit(int max_connections) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+    rlim_t wanted = (rlim_t)max_connections + 64;
+    if (limit.rlim_cur >= wanted) return;
+    limit.rlim_cur = (limit.rlim_max != RLIM_INFINITY && limit.rlim_max < wanted) ? limit.rlim_max : wanted;
+    setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+static void http_server_accept_all(HttpServer* server) {
+    for (;;) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_fd = accept(server->socket_fd, (struct sockaddr*)&client_addr, &client_len);
+        if (client_fd < 0) {
+            if (errno == EINTR) continue;
+            // EAGAIN: backlog drained. EMFILE and friends: retry on the next event
+            return;
+        }
+
+        if (server->connection_count >= (size_t)server->max_connections) {
+            close(client_fd);
+            continue;
+        }
+
+        int flags = fcntl(client_fd, F_GETFL, 0);
+        if (flags < 0 || fcntl(client_fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            close(client_fd);
+            continue;
+        }
+        fcntl(client_fd, F_SETFD, FD_CLOEXEC);
+        int opt = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+#ifdef SO_NOSIGPIPE
+        setsockopt(client_fd, SOL_SOCKET, SO_NOSIGPIPE, &opt, sizeof(opt));
+#endif
+
+        HttpConnection* conn = shared_malloc_safe(sizeof(HttpConnection), "http_server", "http_server_accept_all", 0);
+        if (!conn) {
+            close(client_fd);
+            continue;
+        }
+        memset(conn, 0, sizeof(HttpConnection));
+        conn->fd = client_fd;
+        conn->last_active = http_monotonic_seconds();
+        http_body_source_init(&conn->body);
+        if (http_poll_set(server->poll_fd, client_fd, conn, 0, HTTP_POLL_READ) < 0) {
+            close(client_fd);
+            shared_free_safe(conn, "http_server", "http_server_accept_all", 0);
+            continue;
+        }
+        conn->interest = HTTP_POLL_READ;
+
+        conn->next = server->connections;
+        if (server->connections) server->connections->prev = conn;
+        server->connections = conn;
+        server->connection_count++;
+    }
+}
+
+// Deliver finished responses to their connections
+static void http_server_drain_done(HttpServer* server) {
+    char drain[256];
+    while (read(server->wake_fds[0], drain, sizeof(drain)) > 0) {
+    }
+
+    pthread_mutex_lock(&server->queue_mutex);
+    HttpJob* job = server->done_head;
+    server->done_head = NULL;
+    server->done_tail = NULL;
+    pthread_mutex_unlock(&server->queue_mutex);
+
+    while (job) {
+        HttpJob* next = job->next;
+        HttpConnection* conn = job->connection;
+        conn->busy = false;
+
+        if (conn->closed) {
+            // The connection went away while its request was being handled
+            conn->next = server->closed_connections;
+            server->closed_connections = conn;
+        } else {
+            bool delivered = false;
+            if (!job->response) {
+                conn->close_after_write = true;
+            } else if (conn->out_len == 0) {
+                // Common case: hand the buffer over instead of copying it
+                if (conn->out) shared_free_safe(conn->out, "http_server", "http_server_drain_done", 0);
+                conn->out = job->response;
+                conn->out_len = job->response_len;
+                conn->out_sent = 0;
+                job->response = NULL;
+                delivered = true;
+            } else if (http_connection_append(conn, job->response, job->response_len)) {
+                delivered = true;
+            } else {
+                conn->close_after_write = true;
+            }
+            if (delivered) {
+                conn->body = job->body;
+                http_body_source_init(&job->body);
+            }
+            if (!job->keep_alive) conn->close_after_write = true;
+            http_connection_advance(server, conn);
+        }
+
+        http_job_free(job);
+        job = next;
+    }
+}
+
+// Close connections past HTTP_IDLE_TIMEOUT_SECONDS; runs at most once a second
+static void http_server_close_idle(HttpServer* server) {
+    time_t now = http_monotonic_seconds();
+    if (now == server->last_idle_sweep) return;
+    server->last_idle_sweep = now;
+
+    HttpConnection* conn = server->connections;
+    while (conn) {
+        HttpConnection* next = conn->next;
+        if (!conn->busy && now - conn->last_active >= HTTP_IDLE_TIMEOUT_SECONDS) {
+            http_connection_close(server, conn);
+        }
+        conn = next;
     }
-    
-    // Cleanup request
-    if (request->method) shared_free_safe(request->method, "http_server", "handle_client_connection", 0);
-    if (request->path) shared_free_safe(request->path, "http_server", "handle_client_connection", 0);
-    if (request->headers) shared_free_safe(request->headers, "http_server", "handle_client_connection", 0);
-    if (request->body) shared_free_safe(request->body, "http_server", "handle_client_connection", 0);
-    if (request->query_string) shared_free_safe(request->query_string, "http_server", "handle_client_connection", 0);
-    shared_free_safe(request, "http_server", "handle_client_connection", 0);
-    
-    close(client_fd);
 }
 
+// Wait up to timeout_ms for events and handle them; returns events handled
+static int http_server_poll_once(HttpServer* server, int timeout_ms) {
+    HttpPollEvent events[HTTP_POLL_BATCH];
+    int count = http_poll_wait(server->poll_fd, events, HTTP_POLL_BATCH, timeout_ms);
+    if (count < 0) return errno == EINTR ? 0 : -1;
+
+    for (int i = 0; i < count; i++) {
+        void* owner = events[i].owner;
+        if (owner == &http_listen_marker) {
+            http_server_accept_all(server);
+        } else if (owner == &http_wake_marker) {
+            http_server_drain_done(server);
+        } else {
+            HttpConnection* conn = (HttpConnection*)owner;
+            if (conn->closed) continue;
+            if (events[i].events & HTTP_POLL_WRITE) {
+                http_connection_advance(server, conn);
+            }
+            if (!conn->closed && (events[i].events & HTTP_POLL_READ)) {
+                http_connection_on_readable(server, conn);
+            }
+        }
+    }
+    http_server_close_idle(server);
+
+    while (server->closed_connections) {
+        HttpConnection* conn = server->closed_connections;
+        server->closed_connections = conn->next;
+        http_connection_free(conn);
+    }
+    return count;
+}
+
+// ============================================================================
+// SERVER API
+// ============================================================================
+
 // Register Myco routes with HTTP server
 void http_server_register_myco_routes(HttpServer* server, void* myco_routes) {
     if (!server || !myco_routes) {
         return;
     }
-    
-    Route* current = (Route*)myco_routes;
-    int count = 0;
-    
-    // Process routes
-    while (current && server->route_count < MAX_ROUTES) {
-        count++;
-        
-        // Add route to HTTP server
-        HttpRoute* http_route = &server->routes[server->route_count];
-        http_route->method = shared_strdup(current->method);
-        http_route->path = shared_strdup(current->path);
-        http_route->handler = myco_route_handler;
-        server->route_count++;
-        
-        current = current->next;
+
+    // Compile the routes into per-method radix trees; routes added later
+    // are picked up by the next listen()
+    if (server->myco_routes) {
+        route_table_free(server->myco_routes);
     }
+    server->myco_routes = route_table_compile((Route*)myco_routes);
 }
 
 // Create HTTP server
 HttpServer* http_server_create(int port) {
     HttpServer* server = shared_malloc_safe(sizeof(HttpServer), "http_server", "http_server_create", 0);
     if (!server) return NULL;
-    
+    memset(server, 0, sizeof(HttpServer));
+
     server->port = port;
     server->socket_fd = -1;
     server->running = false;
     server->routes = shared_malloc_safe(sizeof(HttpRoute) * MAX_ROUTES, "http_server", "http_server_create", 0);
     server->route_count = 0;
-    server->max_connections = 10;
-    
+    server->max_connections = HTTP_SERVER_DEFAULT_MAX_CONNECTIONS;
+    server->backlog = HTTP_SERVER_DEFAULT_BACKLOG;
+    server->worker_count = HTTP_SERVER_DEFAULT_WORKERS;
+    server->poll_fd = -1;
+    server->wake_fds[0] = -1;
+    server->wake_fds[1] = -1;
+
     if (!server->routes) {
         shared_free_safe(server, "http_server", "http_server_create", 0);
         return NULL;
     }
-    
+
+    pthread_mutex_init(&server->queue_mutex, NULL);
+    pthread_cond_init(&server->queue_cond, NULL);
+
     return server;
 }
 
 // Add route to HTTP server
-int http_server_add_route(HttpServer* server, const char* method, const char* path, 
+int http_server_add_route(HttpServer* server, const char* method, const char* path,
                          HttpRouteHandler handler) {
     if (!server || server->route_count >= MAX_ROUTES) return 0;
-    
+
     HttpRoute* route = &server->routes[server->route_count];
     route->method = shared_strdup(method);
     route->path = shared_strdup(path);
     route->handler = handler;
     server->route_count++;
-    
+
     return 1;
 }
 
-// Start HTTP server
+// Close every descriptor the server opened (start failure and stop)
+static void http_server_close_fds(HttpServer* server) {
+    if (server->socket_fd >= 0) {
+        close(server->socket_fd);
+        server->socket_fd = -1;
+    }
+    if (server->poll_fd >= 0) {
+        close(server->poll_fd);
+        server->poll_fd = -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (server->wake_fds[i] >= 0) {
+            close(server->wake_fds[i]);
+            server->wake_fds[i] = -1;
+        }
+    }
+}
+
+static int http_set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) return -1;
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return 0;
+}
+
+// Start HTTP server: bind, listen and start the worker pool
 int http_server_start(HttpServer* server) {
     if (!server) return HTTP_SERVER_ERROR_SOCKET_CREATE;
     if (server->running) return HTTP_SERVER_ERROR_ALREADY_RUNNING;
-    
+
     // Create socket
     server->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (server->socket_fd < 0) {
         return HTTP_SERVER_ERROR_SOCKET_CREATE;
     }
-    
+
     // Set socket options
     int opt = 1;
     setsockopt(server->socket_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    
+
     // Bind socket
     struct sockaddr_in server_addr;
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
     server_addr.sin_addr.s_addr = INADDR_ANY;
     server_addr.sin_port = htons(server->port);
-    
+
     if (bind(server->socket_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        close(server->socket_fd);
+        http_server_close_fds(server);
         return HTTP_SERVER_ERROR_BIND;
     }
-    
+
     // Listen for connections
-    if (listen(server->socket_fd, server->max_connections) < 0) {
-        close(server->socket_fd);
+    if (listen(server->socket_fd, server->backlog > 0 ? server->backlog : HTTP_SERVER_DEFAULT_BACKLOG) < 0) {
+        http_server_close_fds(server);
         return HTTP_SERVER_ERROR_LISTEN;
     }
-    
+
     // Make socket non-blocking
-    int flags = fcntl(server->socket_fd, F_GETFL, 0);
-    if (flags < 0) {
-        close(server->socket_fd);
+    if (http_set_nonblocking(server->socket_fd) < 0) {
+        http_server_close_fds(server);
         return HTTP_SERVER_ERROR_FCNTL;
     }
-    int result = fcntl(server->socket_fd, F_SETFL, flags | O_NONBLOCK);
-    if (result < 0) {
-        close(server->socket_fd);
-        return HTTP_SERVER_ERROR_FCNTL;
+
+    // Event loop: the listening socket plus a pipe workers use to wake it
+    server->poll_fd = http_poll_create();
+    if (server->poll_fd < 0 || pipe(server->wake_fds) < 0) {
+        http_server_close_fds(server);
+        return HTTP_SERVER_ERROR_POLL;
+    }
+    if (http_set_nonblocking(server->wake_fds[0]) < 0 || http_set_nonblocking(server->wake_fds[1]) < 0 ||
+        http_poll_set(server->poll_fd, server->socket_fd, &http_listen_marker, 0, HTTP_POLL_READ) < 0 ||
+        http_poll_set(server->poll_fd, server->wake_fds[0], &http_wake_marker, 0, HTTP_POLL_READ) < 0) {
+        http_server_close_fds(server);
+        return HTTP_SERVER_ERROR_POLL;
+    }
+
+    if (server->max_connections <= 0) server->max_connections = HTTP_SERVER_DEFAULT_MAX_CONNECTIONS;
+    http_server_raise_fd_limit(server->max_connections);
+
+    // Worker pool
+    if (server->worker_count <= 0) server->worker_count = HTTP_SERVER_DEFAULT_WORKERS;
+    server->stopping = false;
+    server->workers = shared_malloc_safe(sizeof(pthread_t) * (size_t)server->worker_count, "http_server", "http_server_start", 0);
+    if (!server->workers) {
+        http_server_close_fds(server);
+        return HTTP_SERVER_ERROR_SOCKET_CREATE;
     }
-    
     server->running = true;
+    server->workers_started = 0;
+    for (int i = 0; i < server->worker_count; i++) {
+        if (pthread_create(&server->workers[i], NULL, http_worker_main, server) != 0) break;
+        server->workers_started++;
+    }
+    if (server->workers_started == 0) {
+        server->running = false;
+        shared_free_safe(server->workers, "http_server", "http_server_start", 0);
+        server->workers = NULL;
+        http_server_close_fds(server);
+        return HTTP_SERVER_ERROR_SOCKET_CREATE;
+    }
+
     g_http_server = server;
     g_server_running = true;
-    
+
     return HTTP_SERVER_SUCCESS;
 }
 
-// Handle server loop (non-blocking)
+// Run the event loop on its own thread
+int http_server_run_in_background(HttpServer* server) {
+    if (!server || !server->running) return HTTP_SERVER_ERROR_SOCKET_CREATE;
+    if (server->loop_started) return HTTP_SERVER_ERROR_ALREADY_RUNNING;
+    if (pthread_create(&server->loop_thread, NULL, http_server_background_loop, server) != 0) {
+        return HTTP_SERVER_ERROR_SOCKET_CREATE;
+    }
+    server->loop_started = true;
+    return HTTP_SERVER_SUCCESS;
+}
+
+// Handle server loop (non-blocking); a no-op while the loop has its own thread
 int http_server_handle_requests(HttpServer* server) {
     if (!server || !server->running) return 0;
-    
-    struct sockaddr_in client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    
-    // Use non-blocking accept
-    int client_fd = accept(server->socket_fd, (struct sockaddr*)&client_addr, &client_len);
-    if (client_fd >= 0) {
-        handle_client_connection(client_fd, server);
-        return 1; // Request handled
-    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        // No connection available, this is normal for non-blocking socket
-        return 0; // No request
-    } else {
-        // Error occurred
-        return -1;
+    if (server->loop_started) return 0;
+
+    return http_server_poll_once(server, 0);
+}
+
+static void http_job_list_free(HttpJob* job) {
+    while (job) {
+        HttpJob* next = job->next;
+        // Busy connections are off the live list, so free them with their job
+        if (job->connection && job->connection->closed) http_connection_free(job->connection);
+        http_job_free(job);
+        job = next;
     }
 }
 
 // Stop HTTP server
 void http_server_stop(HttpServer* server) {
     if (!server || !server->running) return;
-    
+
     g_server_running = false;
     server->running = false;
-    
-    if (server->socket_fd >= 0) {
-        close(server->socket_fd);
-        server->socket_fd = -1;
+
+    // A Myco handler may call stop() from a worker, so never join ourselves
+    pthread_t self = pthread_self();
+    bool on_worker = false;
+    for (size_t i = 0; i < server->workers_started; i++) {
+        if (pthread_equal(server->workers[i], self)) on_worker = true;
     }
-    
+
+    // Wake the loop out of its poll and wait for it
+    if (server->wake_fds[1] >= 0) {
+        char signal_byte = 1;
+        ssize_t ignored = write(server->wake_fds[1], &signal_byte, 1);
+        (void)ignored;
+    }
+    if (server->loop_started && !pthread_equal(server->loop_thread, self)) {
+        pthread_join(server->loop_thread, NULL);
+    }
+    server->loop_started = false;
+
+    // Stop the workers; queued requests are dropped with their connections
+    pthread_mutex_lock(&server->queue_mutex);
+    server->stopping = true;
+    pthread_cond_broadcast(&server->queue_cond);
+    HttpJob* pending = server->pending_head;
+    HttpJob* done = server->done_head;
+    server->pending_head = server->pending_tail = NULL;
+    server->done_head = server->done_tail = NULL;
+    pthread_mutex_unlock(&server->queue_mutex);
+
+    for (size_t i = 0; i < server->workers_started; i++) {
+        // Other workers may be waiting for the interpreter lock we hold
+        if (on_worker) pthread_detach(server->workers[i]);
+        else pthread_join(server->workers[i], NULL);
+    }
+    server->workers_started = 0;
+    if (server->workers) {
+        shared_free_safe(server->workers, "http_server", "http_server_stop", 0);
+        server->workers = NULL;
+    }
+
+    http_job_list_free(pending);
+    http_job_list_free(done);
+    while (server->connections) {
+        HttpConnection* conn = server->connections;
+        bool busy = conn->busy;
+        http_connection_close(server, conn);
+        // A busy connection's job was freed above without it
+        if (busy) http_connection_free(conn);
+    }
+    while (server->closed_connections) {
+        HttpConnection* conn = server->closed_connections;
+        server->closed_connections = conn->next;
+        http_connection_free(conn);
+    }
+
+    pthread_mutex_lock(&server->queue_mutex);
+    http_server_close_fds(server);
+    pthread_mutex_unlock(&server->queue_mutex);
+
     printf("HTTP server stopped\n");
 }
 
@@ -596,51 +1897,42 @@ void http_server_stop(HttpServer* server) {
 void* http_server_background_loop(void* arg) {
     HttpServer* server = (HttpServer*)arg;
     if (!server) {
-        printf("ERROR: No server passed to background thread\n");
+        fprintf(stderr, "ERROR: No server passed to background thread\n");
         return NULL;
     }
-    
-    printf("HTTP server background thread started for server on port %d\n", server->port);
-    printf("Server running: %s\n", server->running ? "true" : "false");
-    printf("Server socket_fd: %d\n", server->socket_fd);
-    
+
+    // Block in the poller; workers and stop() wake it through the pipe
     while (server->running) {
-        
-        // Handle any pending requests
-        int result = http_server_handle_requests(server);
-        if (result < 0) {
-            // Error occurred, break the loop
+        if (http_server_poll_once(server, 500) < 0) {
             break;
         }
-        
-        // Small delay to prevent busy waiting
-        usleep(1000); // 1ms delay
     }
-    
-    
-    printf("HTTP server background thread stopped\n");
+
     return NULL;
 }
 
 // Free HTTP server
 void http_server_free(HttpServer* server) {
     if (!server) return;
-    
+
     // Stop server if running
     if (server->running) {
         http_server_stop(server);
     }
-    
+
     // Free routes
     for (size_t i = 0; i < server->route_count; i++) {
         HttpRoute* route = &server->routes[i];
         if (route->method) shared_free_safe(route->method, "http_server", "http_server_free", 0);
         if (route->path) shared_free_safe(route->path, "http_server", "http_server_free", 0);
     }
-    
+
     if (server->routes) {
         shared_free_safe(server->routes, "http_server", "http_server_free", 0);
     }
-    
+    route_table_free(server->myco_routes);
+
+    pthread_mutex_destroy(&server->queue_mutex);
+    pthread_cond_destroy(&server->queue_cond);
     shared_free_safe(server, "http_server", "http_server_free", 0);
 }
@@ -0,0 +1,848 @@
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200809L  // nanosleep under -std=c99
+#endif
+
+#include "../../include/libs/isolate.h"
+#include "../../include/libs/builtin_libs.h"
+#include "../../include/core/interpreter.h"
+#include "../../include/core/lexer.h"
+#include "../../include/core/parser.h"
+#include "../../include/core/ast.h"
+#include "../../include/core/standardized_errors.h"
+#include "../../include/utils/shared_utilities.h"
+#include "../../include/core/interpreter/value_operations.h"
+#include "../../include/core/optimization/arena_allocator.h"
+#include "../../include/runtime/scheduler.h"
+#include "../../include/runtime/reactor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+// ============================================================================
+// ISOLATES
+// ============================================================================
+// Each isolate is an actor: an interpreter with its own globals and heap,
+// an inbox, and a SchedulerTask that is queued on a process-wide
+// work-stealing pool whenever the inbox has messages. A run handles a
+// batch of messages and requeues the isolate if more arrived, so any
+// number of isolates share one worker per core and never run on two
+// threads at once. Results go back to the spawning interpreter through a
+// reply list that its event loop drains.
+//
+// Values are deep-copied at the boundary. Copy-on-write reference counts
+// are not atomic, so a value built on one thread is only handed over once
+// nothing on that thread references it.
+
+#define ISOLATE_BATCH 16             // Messages handled per run before yielding the worker
+#define ISOLATE_CLONE_MAX_DEPTH 128  // Nesting allowed in a message
+#define ISOLATE_MAX_WORKERS 16
+#define ISOLATE_WAIT_NS 1000000L     // Poll interval while an isolate awaits
+
+typedef enum {
+    ISOLATE_NEW,     // Module not loaded yet (the first run loads it)
+    ISOLATE_READY,
+    ISOLATE_FAILED   // Loading failed; calls are rejected with load_error
+} IsolateState;
+
+typedef struct IsolateMessage {
+    struct IsolateMessage* next;
+    Value payload;          // Deep copy owned by the message
+    uint64_t promise_id;    // Parent promise to settle, 0 for send()
+} IsolateMessage;
+
+typedef struct IsolateReply {
+    struct IsolateReply* next;
+    Interpreter* parent;
+    uint64_t promise_id;
+    Value value;            // Deep copy, or the error message when rejected
+    int rejected;
+} IsolateReply;
+
+typedef struct Isolate {
+    SchedulerTask sched;    // First member: the pool hands this back
+    uint64_t id;
+    struct Isolate* next;   // Registry link
+
+    // Guarded by isolate_lock
+    Interpreter* parent;    // Interpreter whose promises replies settle; NULL once it is gone
+    IsolateMessage* inbox_head;
+    IsolateMessage* inbox_tail;
+    bool scheduled;         // Queued on the pool or running
+    bool closed;
+
+    // Owned by whichever worker is running the isolate
+    IsolateState state;
+    char* module_path;
+    char* function_name;
+    char* source;
+    Lexer* lexer;
+    Parser* parser;
+    ASTNode* program;
+    Interpreter* interpreter;
+    Value handler;
+    char* load_error;
+} Isolate;
+
+static pthread_mutex_t isolate_lock = PTHREAD_MUTEX_INITIALIZER;
+static Scheduler* isolate_pool = NULL;
+static Isolate* isolate_list = NULL;
+static uint64_t isolate_next_id = 1;
+static IsolateReply* isolate_reply_head = NULL;
+static IsolateReply* isolate_reply_tail = NULL;
+static size_t isolate_reply_count = 0;  // Read without the lock to skip an empty list
+
+// Isolate running on this thread, and whether one is being torn down
+static MYCO_THREAD_LOCAL Isolate* isolate_current = NULL;
+static MYCO_THREAD_LOCAL int isolate_tearing_down = 0;
+
+static void isolate_run(void* context, SchedulerTask* task);
+
+bool isolate_in_worker(void) {
+    return isolate_current != NULL;
+}
+
+// Nothing an isolate awaits is signalled through the reactor, so it polls
+void isolate_wait(int timeout_ms) {
+    if (timeout_ms == 0) return;
+    struct timespec pause = {0, ISOLATE_WAIT_NS};
+    nanosleep(&pause, NULL);
+}
+
+// Isolate bookkeeping uses the C allocator directly: it is freed on
+// whichever thread lets go of the isolate last
+static char* isolate_strdup(const char* text) {
+    size_t length = strlen(text) + 1;
+    char* copy = malloc(length);
+    if (copy) memcpy(copy, text, length);
+    return copy;
+}
+
+// ============================================================================
+// STRUCTURED CLONE
+// ============================================================================
+
+// Copy a value into fresh storage. Containers are rebuilt element by
+// element instead of sharing their storage the way value_clone() does.
+static bool isolate_clone_value(const Value* value, Value* out, int depth, char* error, size_t error_size) {
+    *out = value_create_null();
+    if (depth > ISOLATE_CLONE_MAX_DEPTH) {
+        snprintf(error, error_size, "message is nested more than %d levels deep", ISOLATE_CLONE_MAX_DEPTH);
+        return false;
+    }
+
+    switch (value->type) {
+        case VALUE_NULL:
+            return true;
+        case VALUE_BOOLEAN:
+            *out = value_create_boolean(value->data.boolean_value);
+            return true;
+        case VALUE_NUMBER:
+            *out = value_create_number(value->data.number_value);
+            return true;
+        case VALUE_STRING:
+            *out = value_create_string(value->data.string_value ? value->data.string_value : "");
+            return true;
+        case VALUE_RANGE:
+            *out = value_create_range(value->data.range_value.start, value->data.range_value.end,
+                                      value->data.range_value.step, value->data.range_value.inclusive);
+            return true;
+        case VALUE_ARRAY: {
+            Value copy = value_create_array(value->data.array_value.count);
+            for (size_t i = 0; i < value->data.array_value.count; i++) {
+                Value* element = (Value*)value->data.array_value.elements[i];
+                Value item = value_create_null();
+                if (element && !isolate_clone_value(element, &item, depth + 1, error, error_size)) {
+                    value_free(&copy);
+                    return false;
+                }
+                value_array_push(&copy, item);
+                value_free(&item);
+            }
+            *out = copy;
+            return true;
+        }
+        case VALUE_OBJECT: {
+            Value copy = value_create_object(value->data.object_value.count);
+            for (size_t i = 0; i < value->data.object_value.count; i++) {
+                Value item;
+                if (!isolate_clone_value(&value->data.object_value.values[i], &item, depth + 1, error, error_size)) {
+                    value_free(&copy);
+                    return false;
+                }
+                value_object_set(&copy, value->data.object_value.keys[i], item);
+                value_free(&item);
+            }
+            *out = copy;
+            return true;
+        }
+        case VALUE_HASH_MAP: {
+            Value copy = value_create_hash_map(value->data.hash_map_value.count);
+            for (size_t i = 0; i < value->data.hash_map_value.count; i++) {
+                Value* key = (Value*)value->data.hash_map_value.keys[i];
+                Value* entry = (Value*)value->data.hash_map_value.values[i];
+                if (!key) continue;
+                Value key_copy, entry_copy = value_create_null();
+                if (!isolate_clone_value(key, &key_copy, depth + 1, error, error_size)) {
+                    value_free(&copy);
+                    return false;
+                }
+                if (entry && !isolate_clone_value(entry, &entry_copy, depth + 1, error, error_size)) {
+                    value_free(&key_copy);
+                    value_free(&copy);
+                    return false;
+                }
+                value_hash_map_set(&copy, key_copy, entry_copy);
+                value_free(&key_copy);
+                value_free(&entry_copy);
+            }
+            *out = copy;
+            return true;
+        }
+        case VALUE_SET: {
+            Value copy = value_create_set(value->data.set_value.count);
+            for (size_t i = 0; i < value->data.set_value.count; i++) {
+                Value* element = (Value*)value->data.set_value.elements[i];
+                if (!element) continue;
+                Value item;
+                if (!isolate_clone_value(element, &item, depth + 1, error, error_size)) {
+                    value_free(&copy);
+                    return false;
+                }
+                value_set_add(&copy, item);
+                value_free(&item);
+            }
+            *out = copy;
+            return true;
+        }
+        default:
+            // Functions, classes, modules and promises belong to their heap
+            snprintf(error, error_size, "%s values cannot be passed between isolates",
+                     value_type_to_string(value->type));
+            return false;
+    }
+}
+
+// ============================================================================
+// POOL AND REGISTRY
+// ============================================================================
+
+// Called with isolate_lock held
+static Scheduler* isolate_pool_locked(void) {
+    if (isolate_pool) return isolate_pool;
+
+    Scheduler* pool = scheduler_create(isolate_run, NULL);
+    if (!pool) return NULL;
+
+    #ifdef _SC_NPROCESSORS_ONLN
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t worker_count = (cpu_count > 0) ? (size_t)cpu_count : 4;
+    #else
+    size_t worker_count = 4;
+    #endif
+    if (worker_count > ISOLATE_MAX_WORKERS) {
+        worker_count = ISOLATE_MAX_WORKERS;
+    }
+    // With no threads the parent's event loop runs isolates itself
+    scheduler_start(pool, worker_count);
+    __atomic_store_n(&isolate_pool, pool, __ATOMIC_RELEASE);
+    return pool;
+}
+
+// Queue an isolate that was just marked scheduled
+static void isolate_schedule(Scheduler* pool, Isolate* isolate) {
+    scheduler_submit(pool, &isolate->sched);
+    if (scheduler_worker_count(pool) == 0) {
+        reactor_wake();
+    }
+}
+
+// Called with isolate_lock held
+static Isolate* isolate_find_locked(uint64_t id) {
+    for (Isolate* isolate = isolate_list; isolate; isolate = isolate->next) {
+        if (isolate->id == id) return isolate;
+    }
+    return NULL;
+}
+
+// Called with isolate_lock held
+static void isolate_unlink_locked(Isolate* isolate) {
+    for (Isolate** link = &isolate_list; *link; link = &(*link)->next) {
+        if (*link == isolate) {
+            *link = isolate->next;
+            return;
+        }
+    }
+}
+
+static void isolate_message_free(IsolateMessage* message) {
+    value_free(&message->payload);
+    free(message);
+}
+
+// Free an isolate nobody can reach any more (unlinked and not scheduled)
+static void isolate_free(Isolate* isolate) {
+    isolate_tearing_down++;
+    while (isolate->inbox_head) {
+        IsolateMessage* message = isolate->inbox_head;
+        isolate->inbox_head = message->next;
+        isolate_message_free(message);
+    }
+    value_free(&isolate->handler);
+    if (isolate->interpreter) interpreter_free(isolate->interpreter);
+    if (isolate->program) ast_free(isolate->program);
+    if (isolate->parser) parser_free(isolate->parser);
+    if (isolate->lexer) lexer_free(isolate->lexer);
+    free(isolate->source);
+    free(isolate->module_path);
+    free(isolate->function_name);
+    free(isolate->load_error);
+    free(isolate);
+    isolate_tearing_down--;
+}
+
+// MYCO_ASYNC_STATS=1 prints what each pool worker did before it shuts down
+static void isolate_report_stats(Scheduler* pool) {
+    const char* flag = getenv("MYCO_ASYNC_STATS");
+    if (!flag || !*flag || strcmp(flag, "0") == 0) return;
+
+    fprintf(stderr, "isolate worker  %10s %10s %10s %12s\n", "runs", "steals", "injected", "idle ms");
+    SchedulerWorkerStats stats;
+    for (size_t i = 0; scheduler_worker_stats(pool, i, &stats); i++) {
+        fprintf(stderr, "%14zu  %10llu %10llu %10llu %12.1f\n", i,
+                (unsigned long long)stats.tasks_run, (unsigned long long)stats.steals,
+                (unsigned long long)stats.injected, (double)stats.idle_ns / 1e6);
+    }
+}
+
+void isolate_release_owner(Interpreter* interpreter) {
+    Isolate* release = NULL;
+    IsolateReply* dropped = NULL;
+    Scheduler* pool = NULL;
+
+    pthread_mutex_lock(&isolate_lock);
+    Isolate** link = &isolate_list;
+    while (*link) {
+        Isolate* isolate = *link;
+        if (isolate->parent != interpreter) {
+            link = &isolate->next;
+            continue;
+        }
+        // A running isolate finishes its batch and frees itself
+        isolate->parent = NULL;
+        isolate->closed = true;
+        if (isolate->scheduled) {
+            link = &isolate->next;
+            continue;
+        }
+        *link = isolate->next;
+        isolate->next = release;
+        release = isolate;
+    }
+
+    IsolateReply** reply_link = &isolate_reply_head;
+    isolate_reply_tail = NULL;
+    while (*reply_link) {
+        IsolateReply* reply = *reply_link;
+        if (reply->parent == interpreter) {
+            *reply_link = reply->next;
+            reply->next = dropped;
+            dropped = reply;
+            __atomic_sub_fetch(&isolate_reply_count, 1, __ATOMIC_RELAXED);
+        } else {
+            isolate_reply_tail = reply;
+            reply_link = &reply->next;
+        }
+    }
+
+    // The last top-level interpreter stops the pool. Orphans still on it
+    // finish their batch and free themselves before the workers are joined.
+    bool owned = false;
+    for (Isolate* isolate = isolate_list; isolate; isolate = isolate->next) {
+        if (isolate->parent) owned = true;
+    }
+    if (!owned && !isolate_current && !isolate_tearing_down) {
+        pool = isolate_pool;
+        __atomic_store_n(&isolate_pool, NULL, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    while (release) {
+        Isolate* next = release->next;
+        isolate_free(release);
+        release = next;
+    }
+    while (dropped) {
+        IsolateReply* next = dropped->next;
+        value_free(&dropped->value);
+        free(dropped);
+        dropped = next;
+    }
+    if (pool) {
+        isolate_report_stats(pool);
+        SchedulerTask* unrun = scheduler_destroy(pool);
+        while (unrun) {
+            Isolate* isolate = (Isolate*)unrun;
+            unrun = unrun->next;
+            pthread_mutex_lock(&isolate_lock);
+            isolate_unlink_locked(isolate);
+            pthread_mutex_unlock(&isolate_lock);
+            isolate_free(isolate);
+        }
+    }
+}
+
+// ============================================================================
+// RUNNING ISOLATES (pool workers)
+// ============================================================================
+
+static void isolate_fail(Isolate* isolate, const char* message) {
+    isolate->state = ISOLATE_FAILED;
+    isolate->load_error = isolate_strdup(message);
+}
+
+// Parse and run the module, then look up the message handler
+static void isolate_load(Isolate* isolate) {
+    char message[512];
+    FILE* file = fopen(isolate->module_path, "rb");
+    if (!file) {
+        snprintf(message, sizeof(message), "Cannot open isolate module '%s'", isolate->module_path);
+        isolate_fail(isolate, message);
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    isolate->source = malloc(size > 0 ? (size_t)size + 1 : 1);
+    if (!isolate->source) {
+        fclose(file);
+        isolate_fail(isolate, "Out of memory loading isolate module");
+        return;
+    }
+    size_t bytes_read = size > 0 ? fread(isolate->source, 1, (size_t)size, file) : 0;
+    isolate->source[bytes_read] = '\0';
+    fclose(file);
+
+    isolate->lexer = lexer_initialize(isolate->source);
+    if (!isolate->lexer || lexer_scan_all(isolate->lexer) < 0) {
+        isolate_fail(isolate, "Failed to scan isolate module");
+        return;
+    }
+    isolate->parser = parser_initialize(isolate->lexer);
+    isolate->program = isolate->parser ? parser_parse_program_with_filename(isolate->parser, isolate->module_path) : NULL;
+    if (!isolate->program) {
+        snprintf(message, sizeof(message), "Failed to parse isolate module '%s'", isolate->module_path);
+        isolate_fail(isolate, message);
+        return;
+    }
+
+    isolate->interpreter = interpreter_create();
+    if (!isolate->interpreter) {
+        isolate_fail(isolate, "Failed to create isolate interpreter");
+        return;
+    }
+    register_all_builtin_libraries(isolate->interpreter);
+    interpreter_set_source(isolate->interpreter, isolate->source, isolate->module_path);
+
+    Value result = interpreter_execute_program(isolate->interpreter, isolate->program);
+    value_free(&result);
+    if (interpreter_has_error(isolate->interpreter)) {
+        snprintf(message, sizeof(message), "Isolate module '%s' failed: %s", isolate->module_path,
+                 isolate->interpreter->error_message ? isolate->interpreter->error_message : "unknown error");
+        isolate_fail(isolate, message);
+        return;
+    }
+
+    isolate->handler = environment_get(isolate->interpreter->global_environment, isolate->function_name);
+    if (isolate->handler.type != VALUE_FUNCTION) {
+        snprintf(message, sizeof(message), "Isolate module '%s' has no function '%s'",
+                 isolate->module_path, isolate->function_name);
+        isolate_fail(isolate, message);
+        return;
+    }
+    isolate->state = ISOLATE_READY;
+}
+
+static void isolate_post_reply(Isolate* isolate, uint64_t promise_id, Value value, int rejected) {
+    IsolateReply* reply = promise_id ? malloc(sizeof(IsolateReply)) : NULL;
+    if (!reply) {
+        value_free(&value);
+        return;
+    }
+    reply->next = NULL;
+    reply->promise_id = promise_id;
+    reply->value = value;
+    reply->rejected = rejected;
+
+    pthread_mutex_lock(&isolate_lock);
+    reply->parent = isolate->parent;
+    if (reply->parent) {
+        if (isolate_reply_tail) {
+            isolate_reply_tail->next = reply;
+        } else {
+            isolate_reply_head = reply;
+        }
+        isolate_reply_tail = reply;
+        __atomic_add_fetch(&isolate_reply_count, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    if (!reply->parent) {
+        value_free(&reply->value);
+        free(reply);
+        return;
+    }
+    reactor_wake();
+}
+
+static void isolate_handle_message(Isolate* isolate, IsolateMessage* message) {
+    if (isolate->state != ISOLATE_READY) {
+        isolate_post_reply(isolate, message->promise_id,
+                           value_create_string(isolate->load_error ? isolate->load_error : "Isolate failed to load"), 1);
+        return;
+    }
+
+    Interpreter* interpreter = isolate->interpreter;
+    size_t arg_count = isolate->handler.data.function_value.parameter_count > 0 ? 1 : 0;
+    Value result = value_function_call(&isolate->handler, &message->payload, arg_count, interpreter, 0, 0);
+    if (interpreter->has_return) {
+        value_free(&result);
+        result = interpreter->return_value;
+        interpreter->return_value = value_create_null();
+        interpreter->has_return = 0;
+    }
+
+    if (interpreter_has_error(interpreter)) {
+        Value error = value_create_string(interpreter->error_message ? interpreter->error_message : "Isolate call failed");
+        interpreter_clear_error(interpreter);
+        value_free(&result);
+        isolate_post_reply(isolate, message->promise_id, error, 1);
+        return;
+    }
+
+    char error[256];
+    Value reply;
+    bool cloned = !message->promise_id || isolate_clone_value(&result, &reply, 0, error, sizeof(error));
+    value_free(&result);
+    if (!message->promise_id) return;
+    if (cloned) {
+        isolate_post_reply(isolate, message->promise_id, reply, 0);
+    } else {
+        isolate_post_reply(isolate, message->promise_id, value_create_string(error), 1);
+    }
+}
+
+static void isolate_run(void* context, SchedulerTask* task) {
+    (void)context;
+    Isolate* isolate = (Isolate*)task;
+    Isolate* previous = isolate_current;
+    isolate_current = isolate;
+
+    if (isolate->state == ISOLATE_NEW) {
+        isolate_load(isolate);
+    }
+
+    // Take a batch so a busy isolate cannot hold a worker indefinitely
+    pthread_mutex_lock(&isolate_lock);
+    IsolateMessage* batch = isolate->closed ? NULL : isolate->inbox_head;
+    IsolateMessage* last = batch;
+    for (int i = 1; last && last->next && i < ISOLATE_BATCH; i++) {
+        last = last->next;
+    }
+    if (last) {
+        isolate->inbox_head = last->next;
+        if (!isolate->inbox_head) isolate->inbox_tail = NULL;
+        last->next = NULL;
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    while (batch) {
+        IsolateMessage* next = batch->next;
+        isolate_handle_message(isolate, batch);
+        isolate_message_free(batch);
+        batch = next;
+    }
+
+    bool requeue = false;
+    bool release = false;
+    pthread_mutex_lock(&isolate_lock);
+    if (isolate->closed) {
+        isolate->scheduled = false;
+        isolate_unlink_locked(isolate);
+        release = true;
+    } else if (isolate->inbox_head) {
+        requeue = true;
+    } else {
+        isolate->scheduled = false;
+    }
+    Scheduler* pool = isolate_pool;
+    pthread_mutex_unlock(&isolate_lock);
+
+    isolate_current = previous;
+    if (requeue) {
+        isolate_schedule(pool, isolate);
+    } else if (release) {
+        isolate_free(isolate);
+    }
+}
+
+// ============================================================================
+// EVENT LOOP SIDE (spawning interpreter)
+// ============================================================================
+
+void isolate_process_replies(Interpreter* interpreter) {
+    // Without pool threads the event loop runs isolates itself
+    Scheduler* pool = __atomic_load_n(&isolate_pool, __ATOMIC_ACQUIRE);
+    if (pool && scheduler_worker_count(pool) == 0 && scheduler_pending(pool) > 0) {
+        scheduler_run_here(pool);
+    }
+
+    if (__atomic_load_n(&isolate_reply_count, __ATOMIC_RELAXED) == 0) return;
+
+    IsolateReply* ready = NULL;
+    IsolateReply** ready_tail = &ready;
+    pthread_mutex_lock(&isolate_lock);
+    IsolateReply** link = &isolate_reply_head;
+    isolate_reply_tail = NULL;
+    while (*link) {
+        IsolateReply* reply = *link;
+        if (reply->parent == interpreter) {
+            *link = reply->next;
+            reply->next = NULL;
+            *ready_tail = reply;
+            ready_tail = &reply->next;
+            __atomic_sub_fetch(&isolate_reply_count, 1, __ATOMIC_RELAXED);
+        } else {
+            isolate_reply_tail = reply;
+            link = &reply->next;
+        }
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    while (ready) {
+        IsolateReply* next = ready->next;
+        async_promise_settle(interpreter, ready->promise_id, &ready->value, ready->rejected);
+        value_free(&ready->value);
+        free(ready);
+        ready = next;
+    }
+}
+
+// Id of the isolate behind a handle method call; the VM passes the handle
+// as the first argument
+static uint64_t isolate_self_id(Value* args, size_t arg_count, const char* function, int line, int column) {
+    if (arg_count < 1 || args[0].type != VALUE_OBJECT) {
+        std_error_report(ERROR_INTERNAL_ERROR, "isolate", function, "Must be called on an isolate handle", line, column);
+        return 0;
+    }
+    Value id_val = value_object_get(&args[0], "__isolate__");
+    uint64_t id = id_val.type == VALUE_NUMBER ? (uint64_t)id_val.data.number_value : 0;
+    value_free(&id_val);
+    if (!id) {
+        std_error_report(ERROR_INTERNAL_ERROR, "isolate", function, "Invalid isolate handle", line, column);
+    }
+    return id;
+}
+
+// Copy a message into the isolate's inbox. Returns false if it is closed.
+static bool isolate_deliver(uint64_t id, Value payload, uint64_t promise_id) {
+    IsolateMessage* message = malloc(sizeof(IsolateMessage));
+    if (!message) {
+        value_free(&payload);
+        return false;
+    }
+    message->next = NULL;
+    message->payload = payload;
+    message->promise_id = promise_id;
+
+    Scheduler* pool = NULL;
+    Isolate* schedule = NULL;
+    pthread_mutex_lock(&isolate_lock);
+    Isolate* isolate = isolate_find_locked(id);
+    if (isolate && !isolate->closed) {
+        if (isolate->inbox_tail) {
+            isolate->inbox_tail->next = message;
+        } else {
+            isolate->inbox_head = message;
+        }
+        isolate->inbox_tail = message;
+        if (!isolate->scheduled) {
+            isolate->scheduled = true;
+            schedule = isolate;
+            pool = isolate_pool;
+        }
+        message = NULL;
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    if (schedule) {
+        isolate_schedule(pool, schedule);
+    }
+    if (message) {
+        isolate_message_free(message);
+        return false;
+    }
+    return true;
+}
+
+// isolate.spawn(path, functionName) -> handle. The module is loaded on the
+// pool right away; messages sent before it finishes wait in the inbox.
+Value builtin_isolate_spawn(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    if (arg_count < 2 || args[0].type != VALUE_STRING || args[1].type != VALUE_STRING ||
+        !args[0].data.string_value || !args[1].data.string_value) {
+        std_error_report(ERROR_INVALID_ARGUMENT, "isolate", "spawn", "isolate.spawn() requires a module path and a function name", line, column);
+        return value_create_null();
+    }
+    if (isolate_current) {
+        std_error_report(ERROR_INTERNAL_ERROR, "isolate", "spawn", "isolate.spawn() cannot be called inside an isolate", line, column);
+        return value_create_null();
+    }
+
+    Isolate* isolate = calloc(1, sizeof(Isolate));
+    if (!isolate) {
+        std_error_report(ERROR_INTERNAL_ERROR, "isolate", "spawn", "Out of memory", line, column);
+        return value_create_null();
+    }
+    isolate->module_path = isolate_strdup(args[0].data.string_value);
+    isolate->function_name = isolate_strdup(args[1].data.string_value);
+    if (!isolate->module_path || !isolate->function_name) {
+        isolate_free(isolate);
+        std_error_report(ERROR_INTERNAL_ERROR, "isolate", "spawn", "Out of memory", line, column);
+        return value_create_null();
+    }
+    isolate->handler = value_create_null();
+    isolate->state = ISOLATE_NEW;
+    isolate->parent = interpreter;
+    isolate->scheduled = true;
+
+    pthread_mutex_lock(&isolate_lock);
+    Scheduler* pool = isolate_pool_locked();
+    if (pool) {
+        isolate->id = isolate_next_id++;
+        isolate->next = isolate_list;
+        isolate_list = isolate;
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    if (!pool) {
+        isolate_free(isolate);
+        std_error_report(ERROR_INTERNAL_ERROR, "isolate", "spawn", "Failed to create the isolate pool", line, column);
+        return value_create_null();
+    }
+    uint64_t id = isolate->id;
+    isolate_schedule(pool, isolate);
+
+    Value handle = value_create_object(8);
+    value_object_set(&handle, "__isolate__", value_create_number((double)id));
+    value_object_set(&handle, "module", value_create_string(args[0].data.string_value));
+    value_object_set(&handle, "function", value_create_string(args[1].data.string_value));
+    value_object_set(&handle, "call", value_create_builtin_function(builtin_isolate_call));
+    value_object_set(&handle, "send", value_create_builtin_function(builtin_isolate_send));
+    value_object_set(&handle, "close", value_create_builtin_function(builtin_isolate_close));
+    return handle;
+}
+
+// isolate.workers() -> number of pool threads isolates run on
+Value builtin_isolate_workers(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    pthread_mutex_lock(&isolate_lock);
+    Scheduler* pool = isolate_pool_locked();
+    size_t workers = pool ? scheduler_worker_count(pool) : 0;
+    pthread_mutex_unlock(&isolate_lock);
+    return value_create_number((double)workers);
+}
+
+// handle.call(message) -> Promise resolving to the handler's return value
+Value builtin_isolate_call(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    uint64_t id = isolate_self_id(args, arg_count, "call", line, column);
+    if (!id) return value_create_null();
+
+    char error[256];
+    Value payload = value_create_null();
+    if (arg_count >= 2 && !isolate_clone_value(&args[1], &payload, 0, error, sizeof(error))) {
+        std_error_report(ERROR_TYPE_MISMATCH, "isolate", "call", error, line, column);
+        return value_create_null();
+    }
+
+    uint64_t promise_id = 0;
+    Value promise = async_promise_create(interpreter, &promise_id);
+    if (!promise_id) {
+        value_free(&payload);
+        return promise;
+    }
+    if (!isolate_deliver(id, payload, promise_id)) {
+        Value closed = value_create_string("Isolate is closed");
+        async_promise_settle(interpreter, promise_id, &closed, 1);
+        value_free(&closed);
+    }
+    return promise;
+}
+
+// handle.send(message) -> whether it was queued; the result is discarded
+Value builtin_isolate_send(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    uint64_t id = isolate_self_id(args, arg_count, "send", line, column);
+    if (!id) return value_create_null();
+
+    char error[256];
+    Value payload = value_create_null();
+    if (arg_count >= 2 && !isolate_clone_value(&args[1], &payload, 0, error, sizeof(error))) {
+        std_error_report(ERROR_TYPE_MISMATCH, "isolate", "send", error, line, column);
+        return value_create_null();
+    }
+    return value_create_boolean(isolate_deliver(id, payload, 0));
+}
+
+// handle.close(): queued calls are rejected; a running batch finishes first
+Value builtin_isolate_close(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    uint64_t id = isolate_self_id(args, arg_count, "close", line, column);
+    if (!id) return value_create_null();
+
+    IsolateMessage* dropped = NULL;
+    bool release = false;
+    pthread_mutex_lock(&isolate_lock);
+    Isolate* isolate = isolate_find_locked(id);
+    if (isolate && !isolate->closed) {
+        isolate->closed = true;
+        dropped = isolate->inbox_head;
+        isolate->inbox_head = NULL;
+        isolate->inbox_tail = NULL;
+        if (!isolate->scheduled) {
+            isolate_unlink_locked(isolate);
+            release = true;
+        }
+    }
+    pthread_mutex_unlock(&isolate_lock);
+
+    while (dropped) {
+        IsolateMessage* next = dropped->next;
+        if (dropped->promise_id) {
+            Value closed = value_create_string("Isolate is closed");
+            async_promise_settle(interpreter, dropped->promise_id, &closed, 1);
+            value_free(&closed);
+        }
+        isolate_message_free(dropped);
+        dropped = next;
+    }
+    if (release) {
+        isolate_free(isolate);
+    }
+    return value_create_null();
+}
+
+// Register isolate library with interpreter
+void isolate_library_register(Interpreter* interpreter) {
+    if (!interpreter || !interpreter->global_environment) return;
+
+    Value isolate_lib = value_create_object(8);
+    value_object_set(&isolate_lib, "spawn", value_create_builtin_function(builtin_isolate_spawn));
+    value_object_set(&isolate_lib, "workers", value_create_builtin_function(builtin_isolate_workers));
+
+    // Mark as Library for .type reporting
+    value_object_set(&isolate_lib, "__type__", value_create_string("Library"));
+    value_object_set(&isolate_lib, "type", value_create_string("Library"));
+    value_object_set(&isolate_lib, "__library_name__", value_create_string("isolate"));
+
+    environment_define(interpreter->global_environment, "isolate", isolate_lib);
+}
@@ -1,9 +1,11 @@
 #include "libs/json.h"
+#include "libs/json_reader.h"
 #include "libs/builtin_libs.h"
 #include "core/interpreter.h"
 #include "core/ast.h"
 #include "../../include/core/standardized_errors.h"
 #include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
 
 // Forward declarations
 static JsonValue* json_parse_value(JsonContext* ctx);
@@ -44,7 +46,7 @@ static void json_set_error(JsonContext* ctx, const char* message) {
 
 // Helper function to create JSON value
 static JsonValue* json_create_value(JsonValueType type) {
-    JsonValue* value = shared_malloc_safe(sizeof(JsonValue), "libs", "unknown_function", 47);
+    JsonValue* value = slab_alloc(sizeof(JsonValue));
     if (!value) return NULL;
     
     value->type = type;
@@ -131,13 +133,13 @@ static JsonValue* json_parse_number(JsonContext* ctx) {
     
     // Convert to number
     size_t length = ctx->position - start;
-    char* number_str = shared_malloc_safe(length + 1, "libs", "unknown_function", 134);
+    char* number_str = slab_alloc(length + 1);
     strncpy(number_str, ctx->input + start, length);
     number_str[length] = '\0';
     
     JsonValue* value = json_create_value(JSON_NUMBER);
     value->data.number_value = atof(number_str);
-    shared_free_safe(number_str, "libs", "unknown_function", 140);
+    slab_free(number_str);
     
     return value;
 }
@@ -168,12 +170,12 @@ static JsonValue* json_parse_string(JsonContext* ctx) {
     }
     
     size_t length = ctx->position - start;
-    char* string_value = shared_malloc_safe(length + 1, "libs", "unknown_function", 171);
+    char* string_value = slab_alloc(length + 1);
     strncpy(string_value, ctx->input + start, length);
     string_value[length] = '\0';
     
     // Handle escape sequences
-    char* processed = shared_malloc_safe(length + 1, "libs", "unknown_function", 176);
+    char* processed = slab_alloc(length + 1);
     size_t processed_len = 0;
     for (size_t i = 0; i < length; i++) {
         if (string_value[i] == '\\' && i + 1 < length) {
@@ -196,7 +198,7 @@ static JsonValue* json_parse_string(JsonContext* ctx) {
     
     JsonValue* value = json_create_value(JSON_STRING);
     value->data.string_value = processed;
-    shared_free_safe(string_value, "libs", "unknown_function", 199);
+    slab_free(string_value);
     
     json_advance(ctx); // Skip closing quote
     return value;
@@ -212,7 +214,7 @@ static JsonValue* json_parse_array(JsonContext* ctx) {
     
     JsonValue* array = json_create_value(JSON_ARRAY);
     array->data.array_value.capacity = 4;
-    array->data.array_value.elements = shared_malloc_safe(sizeof(JsonValue*) * array->data.array_value.capacity, "libs", "unknown_function", 215);
+    array->data.array_value.elements = slab_alloc(sizeof(JsonValue*) * array->data.array_value.capacity);
     array->data.array_value.count = 0;
     
     json_skip_whitespace(ctx);
@@ -226,15 +228,15 @@ static JsonValue* json_parse_array(JsonContext* ctx) {
         JsonValue* element = json_parse_value(ctx);
         if (ctx->has_error) {
             // free array value structure on error
-            shared_free_safe(array->data.array_value.elements, "libs", "unknown_function", 228);
-            shared_free_safe(array, "libs", "unknown_function", 228);
+            json_free(array);
             return NULL;
         }
         
         if (array->data.array_value.count >= array->data.array_value.capacity) {
+            size_t old_bytes = sizeof(JsonValue*) * array->data.array_value.capacity;
             array->data.array_value.capacity *= 2;
-            array->data.array_value.elements = shared_realloc_safe(array->data.array_value.elements, 
-                sizeof(JsonValue*) * array->data.array_value.capacity, "libs", "json_parse_array", 236);
+            array->data.array_value.elements = slab_realloc(array->data.array_value.elements, old_bytes,
+                sizeof(JsonValue*) * array->data.array_value.capacity);
         }
         
         array->data.array_value.elements[array->data.array_value.count] = element;
@@ -267,8 +269,8 @@ static JsonValue* json_parse_object(JsonContext* ctx) {
     
     JsonValue* object = json_create_value(JSON_OBJECT);
     object->data.object_value.capacity = 4;
-    object->data.object_value.keys = shared_malloc_safe(sizeof(char*) * object->data.object_value.capacity, "libs", "unknown_function", 270);
-    object->data.object_value.values = shared_malloc_safe(sizeof(JsonValue*) * object->data.object_value.capacity, "libs", "unknown_function", 271);
+    object->data.object_value.keys = slab_alloc(sizeof(char*) * object->data.object_value.capacity);
+    object->data.object_value.values = slab_alloc(sizeof(JsonValue*) * object->data.object_value.capacity);
     object->data.object_value.count = 0;
     
     json_skip_whitespace(ctx);
@@ -285,13 +287,15 @@ static JsonValue* json_parse_object(JsonContext* ctx) {
             return NULL;
         }
         
-        char* key = shared_strdup(key_value->data.string_value);
+        // Take the parsed string over as the key
+        char* key = key_value->data.string_value;
+        key_value->data.string_value = NULL;
         json_free(key_value);
         
         json_skip_whitespace(ctx);
         if (json_current_char(ctx) != ':') {
             json_set_error(ctx, "Expected ':'");
-            shared_free_safe(key, "libs", "unknown_function", 292);
+            slab_free(key);
             json_free(object);
             return NULL;
         }
@@ -299,17 +303,18 @@ static JsonValue* json_parse_object(JsonContext* ctx) {
         
         JsonValue* value = json_parse_value(ctx);
         if (ctx->has_error) {
-            shared_free_safe(key, "libs", "unknown_function", 300);
+            slab_free(key);
             json_free(object);
             return NULL;
         }
         
         if (object->data.object_value.count >= object->data.object_value.capacity) {
+            size_t old_bytes = sizeof(void*) * object->data.object_value.capacity;
             object->data.object_value.capacity *= 2;
-            object->data.object_value.keys = shared_realloc_safe(object->data.object_value.keys, 
-                sizeof(char*) * object->data.object_value.capacity, "libs", "json_parse_object", 309);
-            object->data.object_value.values = shared_realloc_safe(object->data.object_value.values, 
-                sizeof(JsonValue*) * object->data.object_value.capacity, "libs", "json_parse_object", 311);
+            object->data.object_value.keys = slab_realloc(object->data.object_value.keys, old_bytes,
+                sizeof(char*) * object->data.object_value.capacity);
+            object->data.object_value.values = slab_realloc(object->data.object_value.values, old_bytes,
+                sizeof(JsonValue*) * object->data.object_value.capacity);
         }
         
         object->data.object_value.keys[object->data.object_value.count] = key;
@@ -612,7 +617,7 @@ void json_free(JsonValue* value) {
     switch (value->type) {
         case JSON_STRING:
             if (value->data.string_value) {
-                shared_free_safe(value->data.string_value, "libs", "unknown_function", 547);
+                slab_free(value->data.string_value);
             }
             break;
             
@@ -621,20 +626,20 @@ void json_free(JsonValue* value) {
                 json_free(value->data.array_value.elements[i]);
             }
             if (value->data.array_value.elements) {
-                shared_free_safe(value->data.array_value.elements, "libs", "unknown_function", 556);
+                slab_free(value->data.array_value.elements);
             }
             break;
             
         case JSON_OBJECT:
             for (size_t i = 0; i < value->data.object_value.count; i++) {
-                shared_free_safe(value->data.object_value.keys[i], "libs", "unknown_function", 562);
+                slab_free(value->data.object_value.keys[i]);
                 json_free(value->data.object_value.values[i]);
             }
             if (value->data.object_value.keys) {
-                shared_free_safe(value->data.object_value.keys, "libs", "unknown_function", 566);
+                slab_free(value->data.object_value.keys);
             }
             if (value->data.object_value.values) {
-                shared_free_safe(value->data.object_value.values, "libs", "unknown_function", 569);
+                slab_free(value->data.object_value.values);
             }
             break;
             
@@ -642,7 +647,7 @@ void json_free(JsonValue* value) {
             break;
     }
     
-    shared_free_safe(value, "libs", "unknown_function", 577);
+    slab_free(value);
 }
 
 // Internal JSON parsing function that doesn't report errors (for use in server request body parsing)
@@ -651,28 +656,11 @@ Value json_parse_silent(const char* json_str) {
         return value_create_null();
     }
     
-    JsonContext context = {0};
-    context.input = json_str;
-    context.position = 0;
-    context.length = strlen(json_str);
-    context.error_message = NULL;
-    context.has_error = false;
-    
-    // Parse the JSON string
-    JsonValue* json_result = json_parse_value(&context);
-    if (!json_result || context.has_error) {
-        if (context.error_message) {
-            shared_free_safe(context.error_message, "libs", "json_parse_silent", 0);
-        }
+    Value result;
+    const char* error = NULL;
+    if (!json_read_document(json_str, strlen(json_str), &result, &error)) {
         return value_create_null();
     }
-    
-    // Convert JsonValue to Myco Value
-    Value result = json_to_myco_value(json_result);
-    
-    // Clean up the JsonValue
-    json_free(json_result);
-    
     return result;
 }
 
@@ -689,299 +677,13 @@ Value builtin_json_parse(Interpreter* interpreter, Value* args, size_t arg_count
         return value_create_null();
     }
     
-    // Use the existing JSON parser infrastructure
-    const char* json_str = json_string.data.string_value;
-    JsonContext context = {0};
-    context.input = json_str;
-    context.position = 0;
-    context.length = strlen(json_str);
-    context.error_message = NULL;
-    context.has_error = false;
-    
-    // Parse the JSON string
-    JsonValue* json_result = json_parse_value(&context);
-    if (!json_result || context.has_error) {
-        if (context.error_message) {
-            std_error_report(ERROR_INVALID_ARGUMENT, "json", "unknown_function", context.error_message, line, column);
-            shared_free_safe(context.error_message, "libs", "json_parse", 0);
-        } else {
-            std_error_report(ERROR_INVALID_ARGUMENT, "json", "unknown_function", "Invalid JSON format", line, column);
-        }
+    const char* json_str = json_string.data.string_value ? json_string.data.string_value : "";
+    Value result;
+    const char* error = NULL;
+    if (!json_read_document(json_str, strlen(json_str), &result, &error)) {
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", "unknown_function", error, line, column);
         return value_create_null();
     }
-    
-    // Convert JsonValue to Myco Value
-    Value result = json_to_myco_value(json_result);
-    
-    // Clean up the JsonValue
-    json_free(json_result);
-    
-    return result;
-}
-
-// Dynamic string builder for JSON
-typedef struct {
-    char* buffer;
-    size_t capacity;
-    size_t length;
-} JsonStringBuilder;
-
-static JsonStringBuilder* json_string_builder_create(size_t initial_capacity) {
-    JsonStringBuilder* builder = shared_malloc_safe(sizeof(JsonStringBuilder), "libs", "json_string_builder_create", 0);
-    if (!builder) return NULL;
-    
-    builder->capacity = initial_capacity > 0 ? initial_capacity : 64;
-    builder->buffer = shared_malloc_safe(builder->capacity, "libs", "json_string_builder_create", 0);
-    if (!builder->buffer) {
-        shared_free_safe(builder, "libs", "json_string_builder_create", 0);
-        return NULL;
-    }
-    builder->length = 0;
-    builder->buffer[0] = '\0';
-    
-    return builder;
-}
-
-static void json_string_builder_append(JsonStringBuilder* builder, const char* str) {
-    if (!builder || !str) return;
-    
-    size_t str_len = strlen(str);
-    if (builder->length + str_len + 1 > builder->capacity) {
-        // Double capacity
-        builder->capacity = (builder->capacity * 2) + str_len + 1;
-        builder->buffer = shared_realloc_safe(builder->buffer, builder->capacity, "libs", "json_string_builder_append", 0);
-    }
-    
-    size_t remaining = builder->capacity - builder->length;
-    if (str_len < remaining) {
-        strncat(builder->buffer, str, remaining - 1);
-        builder->length += str_len;
-                } else {
-        // Buffer would overflow - truncate
-        if (remaining > 1) {
-            strncat(builder->buffer, str, remaining - 1);
-            builder->length = builder->capacity - 1;
-        }
-    }
-}
-
-static void json_string_builder_append_char(JsonStringBuilder* builder, char c) {
-    if (!builder) return;
-    
-    if (builder->length + 2 > builder->capacity) {
-        builder->capacity *= 2;
-        builder->buffer = shared_realloc_safe(builder->buffer, builder->capacity, "libs", "json_string_builder_append_char", 0);
-    }
-    
-    builder->buffer[builder->length] = c;
-    builder->buffer[builder->length + 1] = '\0';
-    builder->length++;
-}
-
-static void json_string_builder_free(JsonStringBuilder* builder) {
-    if (!builder) return;
-    shared_free_safe(builder->buffer, "libs", "json_string_builder_free", 0);
-    shared_free_safe(builder, "libs", "json_string_builder_free", 0);
-}
-
-// Escape string for JSON
-static char* json_escape_string(const char* str) {
-    if (!str) return NULL;
-    
-    size_t len = strlen(str);
-    size_t escaped_len = len;
-    
-    // Count characters that need escaping
-    for (size_t i = 0; i < len; i++) {
-        if (str[i] == '"' || str[i] == '\\' || str[i] == '\n' || str[i] == '\r' || str[i] == '\t' || str[i] < 32) {
-            escaped_len += 1; // Will become \x
-        }
-    }
-    
-    char* escaped = shared_malloc_safe(escaped_len + 1, "libs", "json_escape_string", 0);
-    if (!escaped) return NULL;
-    
-    size_t j = 0;
-    for (size_t i = 0; i < len; i++) {
-        switch (str[i]) {
-            case '"':  escaped[j++] = '\\'; escaped[j++] = '"'; break;
-            case '\\': escaped[j++] = '\\'; escaped[j++] = '\\'; break;
-            case '\n': escaped[j++] = '\\'; escaped[j++] = 'n'; break;
-            case '\r': escaped[j++] = '\\'; escaped[j++] = 'r'; break;
-            case '\t': escaped[j++] = '\\'; escaped[j++] = 't'; break;
-            default:
-                if (str[i] < 32) {
-                    char hex[5];
-                    snprintf(hex, sizeof(hex), "\\u%04x", (unsigned char)str[i]);
-                    escaped[j++] = hex[0];
-                    escaped[j++] = hex[1];
-                    escaped[j++] = hex[2];
-                    escaped[j++] = hex[3];
-                    escaped[j++] = hex[4];
-                } else {
-                    escaped[j++] = str[i];
-                }
-                break;
-        }
-    }
-    escaped[j] = '\0';
-    
-    return escaped;
-}
-
-// Recursive JSON stringification
-static void json_stringify_myco_value(JsonStringBuilder* builder, Value* value) {
-    if (!builder || !value) return;
-    
-    switch (value->type) {
-        case VALUE_NULL:
-            json_string_builder_append(builder, "null");
-            break;
-            
-        case VALUE_BOOLEAN:
-            json_string_builder_append(builder, value->data.boolean_value ? "true" : "false");
-            break;
-            
-        case VALUE_NUMBER:
-            {
-                char num_str[64];
-                double num = value->data.number_value;
-                // Check if number is an integer (Discord requires intents to be integers)
-                if (num == (double)(int64_t)num && num >= -9007199254740992.0 && num <= 9007199254740992.0) {
-                    // Number is an integer in safe range - format as integer
-                    snprintf(num_str, sizeof(num_str), "%.0f", num);
-                } else {
-                    // Number is a float - use scientific notation if needed
-                    snprintf(num_str, sizeof(num_str), "%.15g", num);
-                }
-                json_string_builder_append(builder, num_str);
-            }
-            break;
-            
-        case VALUE_STRING:
-            {
-                char* escaped = json_escape_string(value->data.string_value);
-                if (escaped) {
-                    json_string_builder_append_char(builder, '"');
-                    json_string_builder_append(builder, escaped);
-                    json_string_builder_append_char(builder, '"');
-                    shared_free_safe(escaped, "libs", "json_stringify_value", 0);
-                } else {
-                    json_string_builder_append(builder, "\"\"");
-                }
-            }
-            break;
-            
-        case VALUE_ARRAY:
-            json_string_builder_append_char(builder, '[');
-            for (size_t i = 0; i < value->data.array_value.count; i++) {
-                if (i > 0) json_string_builder_append_char(builder, ',');
-                json_stringify_myco_value(builder, (Value*)value->data.array_value.elements[i]);
-            }
-            json_string_builder_append_char(builder, ']');
-            break;
-            
-        case VALUE_OBJECT:
-            json_string_builder_append_char(builder, '{');
-            for (size_t i = 0; i < value->data.object_value.count; i++) {
-                if (i > 0) json_string_builder_append_char(builder, ',');
-                
-                // Add key
-                char* key = value->data.object_value.keys[i];
-                if (key && strlen(key) > 0) {
-                    char* escaped_key = json_escape_string(key);
-                    if (escaped_key) {
-                        json_string_builder_append_char(builder, '"');
-                        json_string_builder_append(builder, escaped_key);
-                        json_string_builder_append_char(builder, '"');
-                        shared_free_safe(escaped_key, "libs", "json_stringify_myco_value", 0);
-    } else {
-                        json_string_builder_append(builder, "\"\"");
-                    }
-                } else {
-                    // Use index as key
-                    char index_key[32];
-                    snprintf(index_key, sizeof(index_key), "\"key_%zu\"", i);
-                    json_string_builder_append(builder, index_key);
-                }
-                
-                json_string_builder_append_char(builder, ':');
-                
-                // Add value
-                json_stringify_myco_value(builder, (Value*)value->data.object_value.values[i]);
-            }
-            json_string_builder_append_char(builder, '}');
-            break;
-            
-        case VALUE_HASH_MAP:
-            json_string_builder_append_char(builder, '{');
-            for (size_t i = 0; i < value->data.hash_map_value.count; i++) {
-                if (i > 0) json_string_builder_append_char(builder, ',');
-                
-                // Add key - hash map keys are Value objects, need to convert to string
-                Value* key_value = (Value*)value->data.hash_map_value.keys[i];
-                if (key_value && key_value->type == VALUE_STRING) {
-                    char* escaped_key = json_escape_string(key_value->data.string_value);
-                    if (escaped_key) {
-                        json_string_builder_append_char(builder, '"');
-                        json_string_builder_append(builder, escaped_key);
-                        json_string_builder_append_char(builder, '"');
-                        shared_free_safe(escaped_key, "libs", "json_stringify_myco_value", 0);
-                } else {
-                        json_string_builder_append(builder, "\"\"");
-                    }
-                } else {
-                    // Use index as key if key is not a string
-                    char index_key[32];
-                    snprintf(index_key, sizeof(index_key), "\"key_%zu\"", i);
-                    json_string_builder_append(builder, index_key);
-                }
-                
-                json_string_builder_append_char(builder, ':');
-                
-                // Add value
-                json_stringify_myco_value(builder, (Value*)value->data.hash_map_value.values[i]);
-            }
-            json_string_builder_append_char(builder, '}');
-            break;
-            
-        default:
-            json_string_builder_append(builder, "\"unknown\"");
-            break;
-    }
-}
-
-Value builtin_json_stringify(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
-    if (arg_count != 1) {
-        std_error_report(ERROR_ARGUMENT_COUNT, "json", "unknown_function", "json.stringify() requires exactly 1 argument (value)", line, column);
-        return value_create_null();
-    }
-    
-    Value myco_value = args[0];
-    
-    // Create dynamic string builder
-    JsonStringBuilder* builder = json_string_builder_create(256);
-    if (!builder) {
-        std_error_report(ERROR_INTERNAL_ERROR, "json", "unknown_function", "Failed to create JSON string builder", line, column);
-        return value_create_null();
-    }
-    
-    // Convert Myco value to JSON string
-    json_stringify_myco_value(builder, &myco_value);
-    
-    // Create result string (copy the buffer content)
-    char* json_string = shared_strdup(builder->buffer);
-    if (!json_string) {
-        shared_free_safe(builder, "libs", "builtin_json_stringify", 0);
-        return value_create_null();
-    }
-    Value result = value_create_string(json_string);
-    shared_free_safe(json_string, "libs", "builtin_json_stringify", 0);
-    
-    // Clean up builder structure and buffer
-    shared_free_safe(builder->buffer, "libs", "builtin_json_stringify", 0);
-    shared_free_safe(builder, "libs", "builtin_json_stringify", 0);
-    
     return result;
 }
 
@@ -1047,7 +749,11 @@ JsonValue* json_from_myco_value(const Value* value) {
             json_value->type = JSON_ARRAY;
             json_value->data.array_value.count = value->data.array_value.count;
             json_value->data.array_value.capacity = value->data.array_value.capacity;
-            json_value->data.array_value.elements = shared_malloc_safe(sizeof(JsonValue*) * value->data.array_value.capacity, "libs", "unknown_function", 777);
+            // Parsed containers are sized exactly, so empty ones have no storage
+            json_value->data.array_value.elements = NULL;
+            if (value->data.array_value.capacity > 0) {
+                json_value->data.array_value.elements = shared_malloc_safe(sizeof(JsonValue*) * value->data.array_value.capacity, "libs", "unknown_function", 777);
+            }
             
             for (size_t i = 0; i < value->data.array_value.count; i++) {
                 Value* element = (Value*)value->data.array_value.elements[i];
@@ -1060,12 +766,16 @@ JsonValue* json_from_myco_value(const Value* value) {
             json_value->type = JSON_OBJECT;
             json_value->data.object_value.count = value->data.object_value.count;
             json_value->data.object_value.capacity = value->data.object_value.capacity;
-            json_value->data.object_value.keys = shared_malloc_safe(sizeof(char*) * value->data.object_value.capacity, "libs", "unknown_function", 790);
-            json_value->data.object_value.values = shared_malloc_safe(sizeof(JsonValue*) * value->data.object_value.capacity, "libs", "unknown_function", 791);
+            json_value->data.object_value.keys = NULL;
+            json_value->data.object_value.values = NULL;
+            if (value->data.object_value.capacity > 0) {
+                json_value->data.object_value.keys = shared_malloc_safe(sizeof(char*) * value->data.object_value.capacity, "libs", "unknown_function", 790);
+                json_value->data.object_value.values = shared_malloc_safe(sizeof(JsonValue*) * value->data.object_value.capacity, "libs", "unknown_function", 791);
+            }
             
             for (size_t i = 0; i < value->data.object_value.count; i++) {
                 json_value->data.object_value.keys[i] = (value->data.object_value.keys[i] ? strdup(value->data.object_value.keys[i]) : NULL);
-                Value* val = (Value*)value->data.object_value.values[i];
+                Value* val = &value->data.object_value.values[i];
                 json_value->data.object_value.values[i] = json_from_myco_value(val);
             }
             break;
@@ -1220,6 +930,9 @@ void json_library_register(Interpreter* interpreter) {
     value_object_set(&json_lib, "set", value_create_builtin_function(builtin_json_set));
     value_object_set(&json_lib, "size", value_create_builtin_function(builtin_json_size));
     value_object_set(&json_lib, "isEmpty", value_create_builtin_function(builtin_json_is_empty));
+    value_object_set(&json_lib, "stream", value_create_builtin_function(builtin_json_stream));
+    value_object_set(&json_lib, "events", value_create_builtin_function(builtin_json_events));
+    value_object_set(&json_lib, "write", value_create_builtin_function(builtin_json_write));
 
     // Register the library in global environment
     environment_define(interpreter->global_environment, "json", json_lib);
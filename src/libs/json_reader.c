@@ -0,0 +1,734 @@
+#include "libs/json_reader.h"
+#include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
+#include "../../include/core/optimization/hidden_classes.h"
+#include "../../include/core/optimization/cpu_features.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// SINGLE-PASS JSON READER
+// ============================================================================
+// Builds Myco Values straight from the input text. Finished values are kept
+// on one shared stack; a container pops its children when it closes, so its
+// storage is allocated once at the exact size. Object keys resolve through a
+// per-parse (shape, key) -> shape memo, which lets repeated keys reuse the
+// name already interned in the object shape without copying or locking.
+// The input must be NUL-terminated: single-byte peeks past the end read the
+// terminator, and only the vector scans are bounded by end.
+//
+// The reader's scratch buffers (value stack, key memo, key scratch) never
+// escape into a Value. shared_free_safe never hands memory back, so rather
+// than allocating them per parse they are kept per thread and reused by the
+// next json_read_document on that thread.
+
+#define JSON_KEY_MEMO_INITIAL 256
+
+typedef struct {
+    ObjectShape* parent;
+    ObjectShape* child;             // parent plus this key, NULL when empty
+    uint32_t hash;
+    uint32_t length;
+} JsonKeyMemo;
+
+typedef struct {
+    const char* cursor;
+    const char* end;
+    Value* stack;                   // Values of containers still open
+    size_t stack_count;
+    size_t stack_capacity;
+    JsonKeyMemo* memo;
+    size_t memo_count;
+    size_t memo_capacity;
+    char* scratch;                  // NUL-terminated key for shape lookups
+    size_t scratch_capacity;
+    size_t depth;
+    const char* error;
+} JsonReader;
+
+static const double json_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Escape letter for each byte a JSON string must escape, 'u' for \u00XX, 0 for
+// bytes copied as-is
+const char json_escape_table[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0
+};
+
+// First non-whitespace byte at or after p
+static const char* json_skip_space_scalar(const char* p, const char* end) {
+    while (p < end && json_is_space(*p)) p++;
+    return p;
+}
+
+// First '"' or '\\' at or after p, or end
+static const char* json_scan_string_scalar(const char* p, const char* end) {
+    while (p < end && *p != '"' && *p != '\\') p++;
+    return p;
+}
+
+// First byte at or after p that a JSON string must escape, or end
+static const char* json_scan_escape_scalar(const char* p, const char* end) {
+    while (p < end && !json_escape_table[(unsigned char)*p]) p++;
+    return p;
+}
+
+#if defined(__x86_64__)
+static const char* json_skip_space_sse2(const char* p, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (p + 16 <= end) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage), _mm_cmpeq_epi8(chunk, tab)));
+        unsigned int mask = ~(unsigned int)_mm_movemask_epi8(ws) & 0xFFFFu;
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return json_skip_space_scalar(p, end);
+}
+
+static const char* json_scan_string_sse2(const char* p, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (p + 16 <= end) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return json_scan_string_scalar(p, end);
+}
+
+static const char* json_scan_escape_sse2(const char* p, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (p + 16 <= end) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return json_scan_escape_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char* json_skip_space_avx2(const char* p, const char* end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriage = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    while (p + 32 <= end) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, newline)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, carriage), _mm256_cmpeq_epi8(chunk, tab)));
+        unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(ws);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return json_skip_space_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char* json_scan_string_avx2(const char* p, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    while (p + 32 <= end) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return json_scan_string_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char* json_scan_escape_avx2(const char* p, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    while (p + 32 <= end) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return json_scan_escape_sse2(p, end);
+}
+#endif
+
+JsonScanFn json_skip_space_run = json_skip_space_scalar;
+JsonScanFn json_scan_string_run = json_scan_string_scalar;
+JsonScanFn json_scan_escape_run = json_scan_escape_scalar;
+static pthread_once_t json_scan_once = PTHREAD_ONCE_INIT;
+
+// Pick the widest scanner the CPU supports (SSE2 is baseline on x86-64)
+static void json_scan_select(void) {
+#if defined(__x86_64__)
+    json_skip_space_run = json_skip_space_sse2;
+    json_scan_string_run = json_scan_string_sse2;
+    json_scan_escape_run = json_scan_escape_sse2;
+    CPUFeatureContext* cpu = cpu_features_create_context();
+    if (cpu && cpu_features_detect(cpu) && cpu_features_has_feature(cpu, CPU_FEATURE_AVX2)) {
+        json_skip_space_run = json_skip_space_avx2;
+        json_scan_string_run = json_scan_string_avx2;
+        json_scan_escape_run = json_scan_escape_avx2;
+    }
+    cpu_features_free_context(cpu);
+#endif
+}
+
+void json_scan_init(void) {
+    pthread_once(&json_scan_once, json_scan_select);
+}
+
+static inline void json_reader_skip_space(JsonReader* reader) {
+    // Compact JSON rarely has more than one space between tokens
+    const char* p = reader->cursor;
+    if (!json_is_space(*p)) return;
+    p++;
+    if (json_is_space(*p)) p = json_skip_space_run(p, reader->end);
+    reader->cursor = p;
+}
+
+static bool json_reader_fail(JsonReader* reader, const char* message) {
+    if (!reader->error) reader->error = message;
+    return false;
+}
+
+static bool json_reader_grow(JsonReader* reader) {
+    size_t new_capacity = reader->stack_capacity ? reader->stack_capacity * 2 : 64;
+    Value* grown = shared_realloc_safe(reader->stack, new_capacity * sizeof(Value), "libs", "json_reader_grow", 0);
+    if (!grown) return json_reader_fail(reader, "Out of memory");
+    reader->stack = grown;
+    reader->stack_capacity = new_capacity;
+    return true;
+}
+
+static inline bool json_reader_push(JsonReader* reader, const Value* value) {
+    if (reader->stack_count >= reader->stack_capacity && !json_reader_grow(reader)) {
+        Value lost = *value;
+        value_free(&lost);
+        return false;
+    }
+    reader->stack[reader->stack_count++] = *value;
+    return true;
+}
+
+// Release values left on the stack above base
+static void json_reader_unwind(JsonReader* reader, size_t base) {
+    while (reader->stack_count > base) {
+        value_free(&reader->stack[--reader->stack_count]);
+    }
+}
+
+static int json_hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool json_read_hex4(const char* p, uint32_t* out) {
+    uint32_t code = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = json_hex_digit(p[i]);
+        if (digit < 0) return false;
+        code = (code << 4) | (uint32_t)digit;
+    }
+    *out = code;
+    return true;
+}
+
+static size_t json_put_utf8(char* out, uint32_t code) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xC0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xE0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+// Decode the escaped string body [p, end) into out; returns decoded length,
+// or (size_t)-1 on a bad escape. The output never exceeds the input length.
+static size_t json_unescape(const char* p, const char* end, char* out) {
+    size_t length = 0;
+    while (p < end) {
+        const char* special = json_scan_string_run(p, end);
+        memcpy(out + length, p, (size_t)(special - p));
+        length += (size_t)(special - p);
+        p = special;
+        if (p >= end) break;
+        
+        // p is at a backslash; the caller guaranteed a following byte
+        char escape = p[1];
+        p += 2;
+        switch (escape) {
+            case '"': out[length++] = '"'; break;
+            case '\\': out[length++] = '\\'; break;
+            case '/': out[length++] = '/'; break;
+            case 'b': out[length++] = '\b'; break;
+            case 'f': out[length++] = '\f'; break;
+            case 'n': out[length++] = '\n'; break;
+            case 'r': out[length++] = '\r'; break;
+            case 't': out[length++] = '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (p + 4 > end || !json_read_hex4(p, &code)) return (size_t)-1;
+                p += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    uint32_t low;
+                    if (p + 6 <= end && p[0] == '\\' && p[1] == 'u' &&
+                        json_read_hex4(p + 2, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    } else {
+                        code = 0xFFFD;
+                    }
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    code = 0xFFFD;
+                }
+                // Every \uXXXX is 6 input bytes and at most 4 output bytes
+                length += json_put_utf8(out + length, code);
+                break;
+            }
+            default:
+                return (size_t)-1;
+        }
+    }
+    return length;
+}
+
+// Wrap finished text as a string Value. The text is already unescaped (or is
+// JSON output), so it is adopted as-is rather than going through
+// value_create_string's escape processing
+Value json_adopt_string(char* text, size_t length) {
+    Value value = {0};
+    value.type = VALUE_STRING;
+    value.flags = VALUE_FLAG_IMMUTABLE | VALUE_FLAG_CACHED;
+    value.ref_count = 1;
+    value.data.string_value = text;
+    value.cache.cached_length = length;
+    return value;
+}
+
+// Find the closing quote of the string whose body starts at cursor. Sets
+// *escaped when the body contains a backslash.
+static const char* json_find_string_end(JsonReader* reader, bool* escaped) {
+    const char* p = reader->cursor;
+    *escaped = false;
+    for (;;) {
+        p = json_scan_string_run(p, reader->end);
+        if (p >= reader->end) {
+            json_reader_fail(reader, "Unterminated string");
+            return NULL;
+        }
+        if (*p == '"') return p;
+        *escaped = true;
+        if (p + 1 >= reader->end) {
+            json_reader_fail(reader, "Incomplete escape sequence");
+            return NULL;
+        }
+        p += 2;
+    }
+}
+
+static bool json_read_string(JsonReader* reader) {
+    reader->cursor++;   // Opening quote
+    bool escaped;
+    const char* close = json_find_string_end(reader, &escaped);
+    if (!close) return false;
+    
+    size_t raw_length = (size_t)(close - reader->cursor);
+    char* text = shared_malloc_safe(raw_length + 1, "libs", "json_read_string", 0);
+    if (!text) return json_reader_fail(reader, "Out of memory");
+    size_t length = raw_length;
+    if (escaped) {
+        length = json_unescape(reader->cursor, close, text);
+        if (length == (size_t)-1) {
+            shared_free_safe(text, "libs", "json_read_string", 1);
+            return json_reader_fail(reader, "Invalid escape sequence");
+        }
+    } else {
+        memcpy(text, reader->cursor, raw_length);
+    }
+    text[length] = '\0';
+    reader->cursor = close + 1;
+    
+    Value value = json_adopt_string(text, length);
+    return json_reader_push(reader, &value);
+}
+
+static bool json_read_number(JsonReader* reader) {
+    const char* start = reader->cursor;
+    const char* p = start;
+    bool negative = false;
+    if (*p == '-') {
+        negative = true;
+        p++;
+    }
+    if (!isdigit((unsigned char)*p)) return json_reader_fail(reader, "Expected digit");
+    
+    // Accumulate up to 19 significant digits; anything longer or out of the
+    // exactly representable range is handed to strtod
+    uint64_t mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    while (isdigit((unsigned char)*p)) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            if (mantissa) significant++;
+        } else {
+            exponent++;
+        }
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (!isdigit((unsigned char)*p)) return json_reader_fail(reader, "Expected digit after decimal point");
+        while (isdigit((unsigned char)*p)) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                if (mantissa) significant++;
+                exponent--;
+            }
+            p++;
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        bool exponent_negative = false;
+        if (*p == '+' || *p == '-') {
+            exponent_negative = (*p == '-');
+            p++;
+        }
+        if (!isdigit((unsigned char)*p)) return json_reader_fail(reader, "Expected digit in exponent");
+        int explicit_exponent = 0;
+        while (isdigit((unsigned char)*p)) {
+            if (explicit_exponent < 100000) explicit_exponent = explicit_exponent * 10 + (*p - '0');
+            p++;
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+    reader->cursor = p;
+    
+    double number;
+    if (mantissa == 0) {
+        number = 0.0;
+    } else if (significant <= 15 && exponent >= -22 && exponent <= 22) {
+        // Both operands are exact doubles, so one rounding gives the right answer
+        number = (double)mantissa;
+        number = exponent < 0 ? number / json_pow10[-exponent] : number * json_pow10[exponent];
+    } else {
+        number = strtod(start, NULL);
+        negative = false;
+    }
+    Value value = value_create_number(negative ? -number : number);
+    return json_reader_push(reader, &value);
+}
+
+static uint32_t json_key_hash(const char* key, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool json_memo_grow(JsonReader* reader) {
+    size_t new_capacity = reader->memo_capacity ? reader->memo_capacity * 2 : JSON_KEY_MEMO_INITIAL;
+    JsonKeyMemo* table = shared_malloc_safe(new_capacity * sizeof(JsonKeyMemo), "libs", "json_memo_grow", 0);
+    if (!table) return false;
+    memset(table, 0, new_capacity * sizeof(JsonKeyMemo));
+    for (size_t i = 0; i < reader->memo_capacity; i++) {
+        JsonKeyMemo* entry = &reader->memo[i];
+        if (!entry->child) continue;
+        size_t slot = (entry->hash ^ (uint32_t)((uintptr_t)entry->parent >> 4)) & (new_capacity - 1);
+        while (table[slot].child) slot = (slot + 1) & (new_capacity - 1);
+        table[slot] = *entry;
+    }
+    shared_free_safe(reader->memo, "libs", "json_memo_grow", 0);
+    reader->memo = table;
+    reader->memo_capacity = new_capacity;
+    return true;
+}
+
+// Make room for size bytes in the key scratch buffer
+static bool json_reader_reserve_scratch(JsonReader* reader, size_t size) {
+    if (size <= reader->scratch_capacity) return true;
+    size_t new_capacity = reader->scratch_capacity ? reader->scratch_capacity : 64;
+    while (new_capacity < size) new_capacity *= 2;
+    char* grown = shared_realloc_safe(reader->scratch, new_capacity, "libs", "json_reader_reserve_scratch", 0);
+    if (!grown) return false;
+    reader->scratch = grown;
+    reader->scratch_capacity = new_capacity;
+    return true;
+}
+
+// Resolve key (length bytes, not necessarily terminated) on shape. Returns
+// the shape after adding it, or shape itself with *slot set when the object
+// already has the key. NULL on allocation failure.
+static ObjectShape* json_resolve_key(JsonReader* reader, ObjectShape* shape,
+                                     const char* key, size_t length, int* slot) {
+    *slot = -1;
+    uint32_t hash = json_key_hash(key, length);
+    if (reader->memo_capacity) {
+        size_t mask = reader->memo_capacity - 1;
+        size_t i = (hash ^ (uint32_t)((uintptr_t)shape >> 4)) & mask;
+        for (JsonKeyMemo* entry = &reader->memo[i]; entry->child; entry = &reader->memo[i = (i + 1) & mask]) {
+            if (entry->parent != shape || entry->hash != hash || entry->length != length) continue;
+            const char* name = entry->child->names[shape->count];
+            if (memcmp(name, key, length) == 0 && name[length] == '\0') {
+                // A transition only exists for keys the parent lacks
+                return entry->child;
+            }
+        }
+    }
+    
+    // Miss: terminate the key for the shape API (decoded keys already live
+    // in the scratch buffer)
+    if (key != reader->scratch) {
+        if (!json_reader_reserve_scratch(reader, length + 1)) return NULL;
+        memcpy(reader->scratch, key, length);
+    }
+    reader->scratch[length] = '\0';
+    
+    *slot = object_shape_find(shape, reader->scratch);
+    if (*slot >= 0) return shape;
+    ObjectShape* child = object_shape_add_property(shape, reader->scratch);
+    if (!child) return NULL;
+    
+    // Shapes hold C strings, so a key decoded with "\u0000" is stored
+    // truncated and cannot be matched by length; such keys skip the memo
+    if (memchr(key, '\0', length)) return child;
+    if ((reader->memo_count + 1) * 4 > reader->memo_capacity * 3 && !json_memo_grow(reader)) {
+        return child;   // Still correct, just not memoized
+    }
+    size_t mask = reader->memo_capacity - 1;
+    size_t i = (hash ^ (uint32_t)((uintptr_t)shape >> 4)) & mask;
+    while (reader->memo[i].child) i = (i + 1) & mask;
+    reader->memo[i].parent = shape;
+    reader->memo[i].child = child;
+    reader->memo[i].hash = hash;
+    reader->memo[i].length = (uint32_t)length;
+    reader->memo_count++;
+    return child;
+}
+
+static bool json_read_value(JsonReader* reader);
+
+static bool json_read_array(JsonReader* reader) {
+    size_t base = reader->stack_count;
+    reader->cursor++;   // '['
+    json_reader_skip_space(reader);
+    if (*reader->cursor != ']') {
+        for (;;) {
+            if (!json_read_value(reader)) return false;
+            json_reader_skip_space(reader);
+            char c = *reader->cursor;
+            if (c == ',') {
+                reader->cursor++;
+                json_reader_skip_space(reader);
+                continue;
+            }
+            if (c == ']') break;
+            return json_reader_fail(reader, "Expected ',' or ']'");
+        }
+    }
+    reader->cursor++;   // ']'
+    
+    size_t count = reader->stack_count - base;
+    Value array = value_create_array(count);
+    if (count > 0 && !array.data.array_value.elements) {
+        value_free(&array);
+        return json_reader_fail(reader, "Out of memory");
+    }
+    for (size_t i = 0; i < count; i++) {
+        Value* cell = slab_alloc_value();
+        if (!cell) {
+            // Cells already filled belong to the array now; the rest stay on
+            // the stack for the caller to unwind
+            array.data.array_value.count = i;
+            value_free(&array);
+            memmove(&reader->stack[base], &reader->stack[base + i], (count - i) * sizeof(Value));
+            reader->stack_count = base + (count - i);
+            return json_reader_fail(reader, "Out of memory");
+        }
+        *cell = reader->stack[base + i];
+        array.data.array_value.elements[i] = cell;
+    }
+    array.data.array_value.count = count;
+    reader->stack_count = base;
+    return json_reader_push(reader, &array);
+}
+
+static bool json_read_object(JsonReader* reader) {
+    size_t base = reader->stack_count;
+    ObjectShape* shape = object_shape_root();
+    reader->cursor++;   // '{'
+    json_reader_skip_space(reader);
+    if (*reader->cursor != '}') {
+        for (;;) {
+            if (*reader->cursor != '"') return json_reader_fail(reader, "Expected '\"'");
+            reader->cursor++;
+            bool escaped;
+            const char* close = json_find_string_end(reader, &escaped);
+            if (!close) return false;
+            const char* key = reader->cursor;
+            size_t key_length = (size_t)(close - key);
+            if (escaped) {
+                // Decode into the scratch buffer; the shape keeps its own copy
+                if (!json_reader_reserve_scratch(reader, key_length + 1)) return json_reader_fail(reader, "Out of memory");
+                key_length = json_unescape(key, close, reader->scratch);
+                if (key_length == (size_t)-1) return json_reader_fail(reader, "Invalid escape sequence");
+                key = reader->scratch;
+            }
+            int slot;
+            ObjectShape* next = json_resolve_key(reader, shape, key, key_length, &slot);
+            if (!next) return json_reader_fail(reader, "Out of memory");
+            reader->cursor = close + 1;
+            
+            json_reader_skip_space(reader);
+            if (*reader->cursor != ':') return json_reader_fail(reader, "Expected ':'");
+            reader->cursor++;
+            json_reader_skip_space(reader);
+            if (!json_read_value(reader)) return false;
+            if (slot >= 0) {
+                // Repeated key: the last value wins, in the original slot
+                Value replacement = reader->stack[--reader->stack_count];
+                value_free(&reader->stack[base + (size_t)slot]);
+                reader->stack[base + (size_t)slot] = replacement;
+            } else {
+                shape = next;
+            }
+            
+            json_reader_skip_space(reader);
+            char c = *reader->cursor;
+            if (c == ',') {
+                reader->cursor++;
+                json_reader_skip_space(reader);
+                continue;
+            }
+            if (c == '}') break;
+            return json_reader_fail(reader, "Expected ',' or '}'");
+        }
+    }
+    reader->cursor++;   // '}'
+    
+    size_t count = reader->stack_count - base;
+    Value object = value_create_object(count);
+    if (object.type != VALUE_OBJECT) return json_reader_fail(reader, "Out of memory");
+    if (count > 0) {
+        memcpy(object.data.object_value.values, &reader->stack[base], count * sizeof(Value));
+    }
+    object.data.object_value.count = count;
+    object.data.object_value.shape = shape;
+    object.data.object_value.keys = shape->names;
+    reader->stack_count = base;
+    return json_reader_push(reader, &object);
+}
+
+static bool json_read_literal(JsonReader* reader, const char* word, size_t length, Value value) {
+    if (strncmp(reader->cursor, word, length) != 0) {
+        return json_reader_fail(reader, word[0] == 'n' ? "Expected 'null'" : "Expected 'true' or 'false'");
+    }
+    reader->cursor += length;
+    return json_reader_push(reader, &value);
+}
+
+static bool json_read_value(JsonReader* reader) {
+    char c = *reader->cursor;
+    switch (c) {
+        case '"': return json_read_string(reader);
+        case '{':
+        case '[': {
+            if (reader->depth >= JSON_READER_MAX_DEPTH) return json_reader_fail(reader, "Nesting too deep");
+            reader->depth++;
+            bool ok = c == '{' ? json_read_object(reader) : json_read_array(reader);
+            reader->depth--;
+            return ok;
+        }
+        case 't': return json_read_literal(reader, "true", 4, value_create_boolean(1));
+        case 'f': return json_read_literal(reader, "false", 5, value_create_boolean(0));
+        case 'n': return json_read_literal(reader, "null", 4, value_create_null());
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return json_read_number(reader);
+        default:
+            if (reader->cursor >= reader->end) return json_reader_fail(reader, "Unexpected end of input");
+            return json_reader_fail(reader, "Unexpected character");
+    }
+}
+
+static MYCO_THREAD_LOCAL JsonReader json_reader_cache;
+
+bool json_read_document(const char* text, size_t length, Value* out, const char** error) {
+    json_scan_init();
+    
+    // Reuse this thread's buffers from the previous parse
+    JsonReader reader = json_reader_cache;
+    reader.cursor = text;
+    reader.end = text + length;
+    json_reader_skip_space(&reader);
+    bool ok = json_read_value(&reader);
+    if (ok) {
+        json_reader_skip_space(&reader);
+        if (reader.cursor < reader.end) ok = json_reader_fail(&reader, "Unexpected characters after JSON value");
+    }
+    
+    if (ok) {
+        *out = reader.stack[0];
+    } else {
+        json_reader_unwind(&reader, 0);
+        *error = reader.error ? reader.error : "Invalid JSON format";
+    }
+    
+    // Hand the buffers back; memo entries only hold for this document
+    if (reader.memo_count) memset(reader.memo, 0, reader.memo_capacity * sizeof(JsonKeyMemo));
+    reader.stack_count = reader.memo_count = reader.depth = 0;
+    reader.cursor = reader.end = NULL;
+    reader.error = NULL;
+    json_reader_cache = reader;
+    return ok;
+}
@@ -0,0 +1,625 @@
+#include "libs/json.h"
+#include "libs/json_reader.h"
+#include "libs/file.h"
+#include "../../include/core/standardized_errors.h"
+#include "../../include/utils/shared_utilities.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// STREAMING READER
+// ============================================================================
+// json.stream() yields the elements of a top-level array or NDJSON / whitespace
+// separated documents one at a time; json.events() yields pull events
+// (startObject, key, value, endObject, startArray, endArray). Both read their
+// source through a sliding window, so memory is bounded by the largest single
+// element (stream) or token (events) rather than by the document.
+
+#define JSON_STREAM_CHUNK_SIZE 65536
+
+typedef enum {
+    JSON_STREAM_AUTO,               // '[' first means array, otherwise lines
+    JSON_STREAM_ARRAY,
+    JSON_STREAM_LINES
+} JsonStreamFormat;
+
+typedef enum {
+    JSON_EXPECT_VALUE,
+    JSON_EXPECT_VALUE_OR_END,       // after '['
+    JSON_EXPECT_KEY_OR_END,         // after '{'
+    JSON_EXPECT_KEY,                // after ',' in an object
+    JSON_EXPECT_COLON,
+    JSON_EXPECT_COMMA_OR_END
+} JsonStreamExpect;
+
+typedef struct {
+    Value handle;                   // file.open() handle, or null for strings
+    bool from_file;
+    char* buffer;                   // Window; buffer[length] is always NUL
+    size_t start;                   // First unconsumed byte
+    size_t length;
+    size_t capacity;
+    bool eof;
+    bool failed;
+    
+    // Resumable measurement of the value starting at start
+    size_t scan_offset;
+    size_t scan_depth;
+    bool scan_started;
+    bool scan_in_string;
+    bool scan_scalar;
+    
+    // json.stream() state
+    JsonStreamFormat format;
+    bool opened;                    // Format chosen (and '[' consumed)
+    bool need_separator;
+    bool after_comma;
+    bool finished;
+    
+    // json.events() state
+    bool events;
+    char* nesting;                  // '{' or '[' per open container
+    size_t depth;
+    size_t nesting_capacity;
+    JsonStreamExpect expect;
+} JsonStream;
+
+static JsonStream** json_streams = NULL;
+static size_t json_stream_count = 0;
+static pthread_mutex_t json_stream_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void json_stream_free(JsonStream* stream) {
+    if (!stream) return;
+    shared_free_safe(stream->buffer, "libs", "json_stream_free", 0);
+    shared_free_safe(stream->nesting, "libs", "json_stream_free", 0);
+    shared_free_safe(stream, "libs", "json_stream_free", 0);
+}
+
+// Store stream in the first free slot; returns its id or -1
+static int json_stream_register(JsonStream* stream) {
+    pthread_mutex_lock(&json_stream_lock);
+    size_t id = 0;
+    while (id < json_stream_count && json_streams[id]) id++;
+    if (id == json_stream_count) {
+        JsonStream** grown = shared_realloc_safe(json_streams, (json_stream_count + 1) * sizeof(JsonStream*),
+                                                  "libs", "json_stream_register", 0);
+        if (!grown) {
+            pthread_mutex_unlock(&json_stream_lock);
+            return -1;
+        }
+        json_streams = grown;
+        json_stream_count++;
+    }
+    json_streams[id] = stream;
+    pthread_mutex_unlock(&json_stream_lock);
+    return (int)id;
+}
+
+static JsonStream* json_stream_lookup(Value* self) {
+    if (!self || self->type != VALUE_OBJECT) return NULL;
+    Value id_value = value_object_get(self, "__json_stream__");
+    if (id_value.type != VALUE_NUMBER || id_value.data.number_value < 0) return NULL;
+    size_t id = (size_t)id_value.data.number_value;
+    pthread_mutex_lock(&json_stream_lock);
+    JsonStream* stream = id < json_stream_count ? json_streams[id] : NULL;
+    pthread_mutex_unlock(&json_stream_lock);
+    return stream;
+}
+
+static void json_stream_unregister(Value* self) {
+    Value id_value = value_object_get(self, "__json_stream__");
+    if (id_value.type != VALUE_NUMBER || id_value.data.number_value < 0) return;
+    size_t id = (size_t)id_value.data.number_value;
+    pthread_mutex_lock(&json_stream_lock);
+    JsonStream* stream = id < json_stream_count ? json_streams[id] : NULL;
+    if (stream) json_streams[id] = NULL;
+    pthread_mutex_unlock(&json_stream_lock);
+    json_stream_free(stream);
+}
+
+// Read more input behind the unconsumed bytes. Returns false at end of input
+// or on a read error (which also marks the stream failed).
+static bool json_stream_fill(JsonStream* stream) {
+    if (stream->eof) return false;
+    
+    // Slide the unconsumed bytes to the front, growing only when one value
+    // already fills the window
+    if (stream->start > 0) {
+        memmove(stream->buffer, stream->buffer + stream->start, stream->length - stream->start);
+        stream->length -= stream->start;
+        stream->start = 0;
+    }
+    if (stream->capacity - stream->length < JSON_STREAM_CHUNK_SIZE / 2) {
+        size_t new_capacity = stream->capacity * 2;
+        char* grown = shared_realloc_safe(stream->buffer, new_capacity + 1, "libs", "json_stream_fill", 0);
+        if (!grown) {
+            stream->failed = true;
+            return false;
+        }
+        stream->buffer = grown;
+        stream->capacity = new_capacity;
+    }
+    
+    long bytes_read = file_handle_read(stream->handle, stream->buffer + stream->length,
+                                       stream->capacity - stream->length);
+    if (bytes_read < 0) {
+        stream->failed = true;
+        stream->eof = true;
+        return false;
+    }
+    if (bytes_read == 0) {
+        stream->eof = true;
+        return false;
+    }
+    stream->length += (size_t)bytes_read;
+    stream->buffer[stream->length] = '\0';
+    return true;
+}
+
+// Skip whitespace; returns the next byte, or '\0' at end of input
+static char json_stream_peek(JsonStream* stream) {
+    for (;;) {
+        const char* p = stream->buffer + stream->start;
+        const char* end = stream->buffer + stream->length;
+        if (p < end && json_is_space(*p)) p = json_skip_space_run(p, end);
+        stream->start = (size_t)(p - stream->buffer);
+        if (p < end) return *p;
+        if (!json_stream_fill(stream)) return '\0';
+    }
+}
+
+static inline bool json_is_delimiter(char c) {
+    return json_is_space(c) || c == ',' || c == ']' || c == '}' || c == ':' ||
+           c == '[' || c == '{' || c == '"' || c == '\0';
+}
+
+// Find the end of the value that starts at start, reading more input as
+// needed. The scan only balances brackets and strings; the parser validates.
+static bool json_stream_measure(JsonStream* stream, size_t* value_end) {
+    for (;;) {
+        const char* base = stream->buffer + stream->start;
+        const char* limit = stream->buffer + stream->length;
+        const char* p = base + stream->scan_offset;
+        
+        if (!stream->scan_started) {
+            stream->scan_started = true;
+            stream->scan_depth = 0;
+            stream->scan_in_string = false;
+            stream->scan_scalar = false;
+            if (*base == '{' || *base == '[') {
+                stream->scan_depth = 1;
+            } else if (*base == '"') {
+                stream->scan_in_string = true;
+            } else {
+                stream->scan_scalar = true;
+            }
+            if (!stream->scan_scalar) p++;
+        }
+        
+        while (p < limit) {
+            if (stream->scan_in_string) {
+                const char* q = json_scan_string_run(p, limit);
+                if (q >= limit) {
+                    p = limit;
+                    break;
+                }
+                if (*q == '\\') {
+                    if (q + 1 >= limit) {
+                        p = q;      // Rescan the escape once more input arrives
+                        break;
+                    }
+                    p = q + 2;
+                    continue;
+                }
+                stream->scan_in_string = false;
+                p = q + 1;
+                if (stream->scan_depth == 0) goto done;
+            } else if (stream->scan_scalar) {
+                if (json_is_delimiter(*p)) goto done;
+                p++;
+            } else {
+                char c = *p++;
+                if (c == '"') {
+                    stream->scan_in_string = true;
+                } else if (c == '{' || c == '[') {
+                    stream->scan_depth++;
+                } else if ((c == '}' || c == ']') && --stream->scan_depth == 0) {
+                    goto done;
+                }
+            }
+        }
+        
+        stream->scan_offset = (size_t)(p - base);
+        if (!json_stream_fill(stream)) {
+            if (!stream->failed && stream->scan_scalar) {
+                p = stream->buffer + stream->length;
+                base = stream->buffer + stream->start;
+                goto done;
+            }
+            return false;
+        }
+        continue;
+        
+    done:
+        *value_end = stream->start + (size_t)(p - base);
+        stream->scan_started = false;
+        stream->scan_offset = 0;
+        return true;
+    }
+}
+
+// Measure and parse the value at start, consuming it
+static bool json_stream_read_value(JsonStream* stream, Value* out, const char** error) {
+    size_t value_end;
+    if (!json_stream_measure(stream, &value_end)) {
+        *error = stream->failed ? "Error reading JSON stream" : "Unexpected end of input";
+        return false;
+    }
+    
+    // Terminate the slice in place for the document reader
+    char saved = stream->buffer[value_end];
+    stream->buffer[value_end] = '\0';
+    bool ok = json_read_document(stream->buffer + stream->start, value_end - stream->start, out, error);
+    stream->buffer[value_end] = saved;
+    stream->start = value_end;
+    return ok;
+}
+
+// Position json.stream() at the next element. Returns 1 if there is one,
+// 0 at the end, -1 on a syntax error.
+static int json_stream_advance(JsonStream* stream, const char** error) {
+    if (stream->failed) return -1;
+    while (!stream->finished) {
+        char c = json_stream_peek(stream);
+        if (stream->failed) {
+            *error = "Error reading JSON stream";
+            return -1;
+        }
+        
+        if (!stream->opened) {
+            if (c == '\0') {
+                stream->finished = true;
+                break;
+            }
+            stream->opened = true;
+            if (stream->format == JSON_STREAM_AUTO) {
+                stream->format = c == '[' ? JSON_STREAM_ARRAY : JSON_STREAM_LINES;
+            }
+            if (stream->format == JSON_STREAM_ARRAY) {
+                if (c != '[') {
+                    *error = "Expected '[' at start of JSON array stream";
+                    return -1;
+                }
+                stream->start++;
+            }
+            continue;
+        }
+        
+        if (stream->format == JSON_STREAM_LINES) {
+            if (c == '\0') {
+                stream->finished = true;
+                break;
+            }
+            return 1;
+        }
+        
+        // Array format
+        if (c == '\0') {
+            *error = "Unterminated JSON array";
+            return -1;
+        }
+        if (c == ']' && !stream->after_comma) {
+            stream->start++;
+            if (json_stream_peek(stream) != '\0') {
+                *error = "Unexpected characters after JSON array";
+                return -1;
+            }
+            stream->finished = true;
+            break;
+        }
+        if (stream->need_separator) {
+            if (c != ',') {
+                *error = "Expected ',' or ']'";
+                return -1;
+            }
+            stream->start++;
+            stream->need_separator = false;
+            stream->after_comma = true;
+            continue;
+        }
+        if (c == ',' || c == ':' || c == ']' || c == '}') {
+            *error = "Unexpected character";
+            return -1;
+        }
+        return 1;
+    }
+    
+    // Nothing more will be read; drop the window
+    shared_free_safe(stream->buffer, "libs", "json_stream_advance", 0);
+    stream->buffer = NULL;
+    stream->start = stream->length = stream->capacity = 0;
+    return 0;
+}
+
+static int json_stream_next_value(JsonStream* stream, Value* out, const char** error) {
+    int status = json_stream_advance(stream, error);
+    if (status <= 0) return status;
+    if (!json_stream_read_value(stream, out, error)) {
+        stream->failed = true;
+        return -1;
+    }
+    stream->need_separator = (stream->format == JSON_STREAM_ARRAY);
+    stream->after_comma = false;
+    return 1;
+}
+
+static Value json_stream_event(const char* type, Value* value) {
+    Value event = value_create_object(value ? 2 : 1);
+    value_object_set(&event, "type", value_create_string(type));
+    if (value) {
+        value_object_set(&event, "value", *value);
+        value_free(value);
+    }
+    return event;
+}
+
+static bool json_stream_push_container(JsonStream* stream, char open) {
+    if (stream->depth >= stream->nesting_capacity) {
+        size_t new_capacity = stream->nesting_capacity ? stream->nesting_capacity * 2 : 32;
+        char* grown = shared_realloc_safe(stream->nesting, new_capacity, "libs", "json_stream_push_container", 0);
+        if (!grown) return false;
+        stream->nesting = grown;
+        stream->nesting_capacity = new_capacity;
+    }
+    stream->nesting[stream->depth++] = open;
+    return true;
+}
+
+// Produce the next json.events() event. Returns 1 with *out set, 0 at the
+// end, -1 on a syntax error.
+static int json_stream_next_event(JsonStream* stream, Value* out, const char** error) {
+    if (stream->failed) return -1;
+    for (;;) {
+        char c = json_stream_peek(stream);
+        if (stream->failed) {
+            *error = "Error reading JSON stream";
+            return -1;
+        }
+        if (c == '\0') {
+            if (stream->depth > 0 || stream->expect != JSON_EXPECT_VALUE) {
+                *error = "Unexpected end of input";
+                stream->failed = true;
+                return -1;
+            }
+            return 0;
+        }
+        
+        char top = stream->depth > 0 ? stream->nesting[stream->depth - 1] : '\0';
+        switch (stream->expect) {
+            case JSON_EXPECT_COLON:
+                if (c != ':') {
+                    *error = "Expected ':'";
+                    stream->failed = true;
+                    return -1;
+                }
+                stream->start++;
+                stream->expect = JSON_EXPECT_VALUE;
+                continue;
+                
+            case JSON_EXPECT_COMMA_OR_END:
+                if (c == ',') {
+                    stream->start++;
+                    stream->expect = top == '{' ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+                    continue;
+                }
+                if (c != (top == '{' ? '}' : ']')) {
+                    *error = top == '{' ? "Expected ',' or '}'" : "Expected ',' or ']'";
+                    stream->failed = true;
+                    return -1;
+                }
+                break;
+                
+            case JSON_EXPECT_KEY_OR_END:
+            case JSON_EXPECT_KEY:
+                if (c == '}' && stream->expect == JSON_EXPECT_KEY_OR_END) break;
+                if (c != '"') {
+                    *error = "Expected '\"'";
+                    stream->failed = true;
+                    return -1;
+                }
+                if (!json_stream_read_value(stream, out, error)) {
+                    stream->failed = true;
+                    return -1;
+                }
+                *out = json_stream_event("key", out);
+                stream->expect = JSON_EXPECT_COLON;
+                return 1;
+                
+            case JSON_EXPECT_VALUE_OR_END:
+                if (c == ']') break;
+                // Fall through
+            case JSON_EXPECT_VALUE:
+                if (c == '{' || c == '[') {
+                    if (!json_stream_push_container(stream, c)) {
+                        *error = "Out of memory";
+                        stream->failed = true;
+                        return -1;
+                    }
+                    stream->start++;
+                    stream->expect = c == '{' ? JSON_EXPECT_KEY_OR_END : JSON_EXPECT_VALUE_OR_END;
+                    *out = json_stream_event(c == '{' ? "startObject" : "startArray", NULL);
+                    return 1;
+                }
+                if (c == ',' || c == ':' || c == ']' || c == '}') {
+                    *error = "Unexpected character";
+                    stream->failed = true;
+                    return -1;
+                }
+                if (!json_stream_read_value(stream, out, error)) {
+                    stream->failed = true;
+                    return -1;
+                }
+                *out = json_stream_event("value", out);
+                stream->expect = stream->depth > 0 ? JSON_EXPECT_COMMA_OR_END : JSON_EXPECT_VALUE;
+                return 1;
+        }
+        
+        // A closing bracket that matches the innermost container
+        stream->start++;
+        stream->depth--;
+        stream->expect = stream->depth > 0 ? JSON_EXPECT_COMMA_OR_END : JSON_EXPECT_VALUE;
+        *out = json_stream_event(c == '}' ? "endObject" : "endArray", NULL);
+        return 1;
+    }
+}
+
+// Methods receive the stream object through self_context, or (when called by
+// the bytecode VM on a plain object) as their first argument
+static Value* json_stream_self(Interpreter* interpreter, Value* args, size_t arg_count) {
+    Value* self = interpreter_get_self_context(interpreter);
+    if (self && self->type == VALUE_OBJECT && value_object_has(self, "__json_stream__")) return self;
+    if (arg_count >= 1 && args[0].type == VALUE_OBJECT && value_object_has(&args[0], "__json_stream__")) return &args[0];
+    return NULL;
+}
+
+static Value builtin_json_stream_next(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+static Value builtin_json_stream_has_next(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+static Value builtin_json_stream_close(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+
+// Shared constructor for json.stream() and json.events()
+static Value json_stream_open(Interpreter* interpreter, Value* args, size_t arg_count, bool events, int line, int column) {
+    const char* name = events ? "json.events()" : "json.stream()";
+    size_t max_args = events ? 1 : 2;
+    char message[160];
+    if (arg_count < 1 || arg_count > max_args) {
+        snprintf(message, sizeof(message), events ? "%s requires exactly 1 argument (file_handle | string)"
+                                                  : "%s requires 1-2 arguments (file_handle | string, [format])", name);
+        std_error_report(ERROR_ARGUMENT_COUNT, "json", events ? "events" : "stream", message, line, column);
+        return value_create_null();
+    }
+    
+    Value source = args[0];
+    if (source.type != VALUE_STRING && source.type != VALUE_NUMBER) {
+        snprintf(message, sizeof(message), "%s source must be a file handle or a string", name);
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", events ? "events" : "stream", message, line, column);
+        return value_create_null();
+    }
+    if (source.type == VALUE_NUMBER && file_handle_read(source, NULL, 0) < 0) {
+        snprintf(message, sizeof(message), "%s file handle is invalid or closed", name);
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", events ? "events" : "stream", message, line, column);
+        return value_create_null();
+    }
+    
+    JsonStreamFormat format = JSON_STREAM_AUTO;
+    if (arg_count == 2) {
+        const char* format_name = args[1].type == VALUE_STRING ? args[1].data.string_value : NULL;
+        if (format_name && strcmp(format_name, "array") == 0) {
+            format = JSON_STREAM_ARRAY;
+        } else if (format_name && (strcmp(format_name, "lines") == 0 || strcmp(format_name, "ndjson") == 0)) {
+            format = JSON_STREAM_LINES;
+        } else if (!format_name || strcmp(format_name, "auto") != 0) {
+            std_error_report(ERROR_INVALID_ARGUMENT, "json", "stream",
+                             "json.stream() format must be \"auto\", \"array\" or \"lines\"", line, column);
+            return value_create_null();
+        }
+    }
+    
+    json_scan_init();
+    JsonStream* stream = shared_malloc_safe(sizeof(JsonStream), "libs", "json_stream_open", 0);
+    if (!stream) {
+        std_error_report(ERROR_OUT_OF_MEMORY, "json", events ? "events" : "stream", "Out of memory", line, column);
+        return value_create_null();
+    }
+    memset(stream, 0, sizeof(JsonStream));
+    stream->events = events;
+    stream->format = format;
+    stream->expect = JSON_EXPECT_VALUE;
+    if (source.type == VALUE_STRING) {
+        // The whole string is the window; there is nothing left to read
+        const char* text = source.data.string_value ? source.data.string_value : "";
+        size_t length = strlen(text);
+        stream->buffer = shared_malloc_safe(length + 1, "libs", "json_stream_open", 0);
+        if (stream->buffer) memcpy(stream->buffer, text, length + 1);
+        stream->length = stream->capacity = length;
+        stream->eof = true;
+    } else {
+        stream->handle = source;
+        stream->from_file = true;
+        stream->buffer = shared_malloc_safe(JSON_STREAM_CHUNK_SIZE + 1, "libs", "json_stream_open", 0);
+        if (stream->buffer) stream->buffer[0] = '\0';
+        stream->capacity = JSON_STREAM_CHUNK_SIZE;
+    }
+    int id = stream->buffer ? json_stream_register(stream) : -1;
+    if (id < 0) {
+        json_stream_free(stream);
+        std_error_report(ERROR_OUT_OF_MEMORY, "json", events ? "events" : "stream", "Out of memory", line, column);
+        return value_create_null();
+    }
+    
+    Value object = value_create_object(6);
+    value_object_set(&object, "__type__", value_create_string("JsonStream"));
+    value_object_set(&object, "type", value_create_string("JsonStream"));
+    value_object_set(&object, "__json_stream__", value_create_number((double)id));
+    value_object_set(&object, "next", value_create_builtin_function(builtin_json_stream_next));
+    value_object_set(&object, "hasNext", value_create_builtin_function(builtin_json_stream_has_next));
+    value_object_set(&object, "close", value_create_builtin_function(builtin_json_stream_close));
+    return object;
+}
+
+// stream.next(): the next element (json.stream) or event object (json.events),
+// or null once the input is exhausted
+static Value builtin_json_stream_next(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    JsonStream* stream = json_stream_lookup(json_stream_self(interpreter, args, arg_count));
+    if (!stream) {
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", "stream", "next() must be called on an open JSON stream", line, column);
+        return value_create_null();
+    }
+    
+    Value result = value_create_null();
+    const char* error = NULL;
+    bool was_failed = stream->failed;
+    int status = stream->events ? json_stream_next_event(stream, &result, &error)
+                                : json_stream_next_value(stream, &result, &error);
+    if (status < 0) {
+        stream->failed = true;
+        if (!was_failed) {
+            std_error_report(ERROR_INVALID_ARGUMENT, "json", "stream", error ? error : "Invalid JSON format", line, column);
+        }
+        return value_create_null();
+    }
+    return result;
+}
+
+// stream.hasNext(): whether next() will produce another element or event
+static Value builtin_json_stream_has_next(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    JsonStream* stream = json_stream_lookup(json_stream_self(interpreter, args, arg_count));
+    if (!stream || stream->failed) return value_create_boolean(0);
+    
+    if (stream->events) {
+        char c = json_stream_peek(stream);
+        return value_create_boolean(!stream->failed && (c != '\0' || stream->depth > 0));
+    }
+    const char* error = NULL;
+    int status = json_stream_advance(stream, &error);
+    if (status < 0) {
+        stream->failed = true;
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", "stream", error ? error : "Invalid JSON format", line, column);
+    }
+    return value_create_boolean(status > 0);
+}
+
+// stream.close(): release the stream's buffers (the file handle stays open)
+static Value builtin_json_stream_close(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    Value* self = json_stream_self(interpreter, args, arg_count);
+    if (self) json_stream_unregister(self);
+    return value_create_null();
+}
+
+Value builtin_json_stream(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    return json_stream_open(interpreter, args, arg_count, false, line, column);
+}
+
+Value builtin_json_events(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    return json_stream_open(interpreter, args, arg_count, true, line, column);
+}
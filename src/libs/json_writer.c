@@ -0,0 +1,675 @@
+#include "libs/json.h"
+#include "libs/json_reader.h"
+#include "libs/file.h"
+#include "../../include/core/standardized_errors.h"
+#include "../../include/utils/shared_utilities.h"
+#include "../../include/core/optimization/arena_allocator.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// JSON WRITER
+// ============================================================================
+// Serializes Myco values into one growable buffer without allocating per key
+// or value. Strings are copied in clean runs found by the vector escape
+// scanner. Numbers get the shortest digits that read back as the same
+// double: Grisu3 settles almost every input, and the few it rejects are
+// trimmed from printf's 17 digits with strtod. Like the reader's scratch, the
+// buffer comes from the shared allocator and is kept per thread for reuse.
+
+#define JSON_WRITER_INITIAL_CAPACITY 4096
+#define JSON_WRITER_MAX_DEPTH JSON_READER_MAX_DEPTH
+// json.stringify() and json.write() keep their thread's buffer between calls
+// up to this size
+#define JSON_WRITER_RETAIN_BYTES (1024 * 1024)
+
+// Number formatting
+
+typedef struct {
+    uint64_t f;
+    int e;
+} JsonDiyFp;
+
+// Normalized 64-bit significands and binary exponents of 10^(-348 + 8i),
+// rounded to nearest; computed once with exact integer arithmetic
+#define JSON_CACHED_POWERS 87
+static uint64_t json_cached_power_f[JSON_CACHED_POWERS];
+static int json_cached_power_e[JSON_CACHED_POWERS];
+static pthread_once_t json_cached_power_once = PTHREAD_ONCE_INIT;
+
+// Little-endian big integer wide enough for 2 * 10^348
+#define JSON_BIG_LIMBS 40
+
+typedef struct {
+    uint32_t limb[JSON_BIG_LIMBS];
+    int count;
+} JsonBig;
+
+static void json_big_mul_small(JsonBig* big, uint32_t factor) {
+    uint64_t carry = 0;
+    for (int i = 0; i < big->count; i++) {
+        uint64_t product = (uint64_t)big->limb[i] * factor + carry;
+        big->limb[i] = (uint32_t)product;
+        carry = product >> 32;
+    }
+    if (carry) big->limb[big->count++] = (uint32_t)carry;
+}
+
+static void json_big_shift_left_one(JsonBig* big) {
+    uint32_t carry = 0;
+    for (int i = 0; i < big->count; i++) {
+        uint32_t next = big->limb[i] >> 31;
+        big->limb[i] = (big->limb[i] << 1) | carry;
+        carry = next;
+    }
+    if (carry) big->limb[big->count++] = carry;
+}
+
+static int json_big_compare(const JsonBig* a, const JsonBig* b) {
+    if (a->count != b->count) return a->count < b->count ? -1 : 1;
+    for (int i = a->count - 1; i >= 0; i--) {
+        if (a->limb[i] != b->limb[i]) return a->limb[i] < b->limb[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// a -= b, where a >= b
+static void json_big_subtract(JsonBig* a, const JsonBig* b) {
+    int64_t borrow = 0;
+    for (int i = 0; i < a->count; i++) {
+        int64_t difference = (int64_t)a->limb[i] - (i < b->count ? b->limb[i] : 0) - borrow;
+        borrow = difference < 0;
+        a->limb[i] = (uint32_t)(difference + (borrow ? ((int64_t)1 << 32) : 0));
+    }
+    while (a->count > 0 && a->limb[a->count - 1] == 0) a->count--;
+}
+
+static int json_big_bit_length(const JsonBig* big) {
+    if (big->count == 0) return 0;
+    return (big->count - 1) * 32 + 32 - __builtin_clz(big->limb[big->count - 1]);
+}
+
+static void json_cached_power_compute(void) {
+    for (int i = 0; i < JSON_CACHED_POWERS; i++) {
+        int k = -348 + 8 * i;
+        JsonBig power = { {1}, 1 };
+        for (int j = 0; j < (k < 0 ? -k : k); j++) json_big_mul_small(&power, 10);
+        int bits = json_big_bit_length(&power);
+        uint64_t f = 0;
+        int e;
+        bool round_up;
+        if (k >= 0) {
+            // Top 64 bits of 10^k, rounded on the next bit
+            for (int bit = bits - 1; bit >= bits - 64; bit--) {
+                f <<= 1;
+                if (bit >= 0) f |= (power.limb[bit / 32] >> (bit % 32)) & 1;
+            }
+            int below = bits - 65;
+            round_up = below >= 0 && ((power.limb[below / 32] >> (below % 32)) & 1);
+            e = bits - 64;
+        } else {
+            // floor(2^s / 10^-k) has exactly 64 bits for s = bits + 63
+            int shift = bits + 63;
+            JsonBig remainder = { {1}, 1 };
+            for (int step = 0; step < shift; step++) {
+                json_big_shift_left_one(&remainder);
+                f <<= 1;
+                if (json_big_compare(&remainder, &power) >= 0) {
+                    json_big_subtract(&remainder, &power);
+                    f |= 1;
+                }
+            }
+            json_big_shift_left_one(&remainder);
+            round_up = json_big_compare(&remainder, &power) >= 0;
+            e = -shift;
+        }
+        if (round_up && ++f == 0) {
+            f = (uint64_t)1 << 63;
+            e++;
+        }
+        json_cached_power_f[i] = f;
+        json_cached_power_e[i] = e;
+    }
+}
+
+static JsonDiyFp json_diy_multiply(JsonDiyFp x, JsonDiyFp y) {
+    const uint64_t mask = 0xFFFFFFFFu;
+    uint64_t a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + ((uint64_t)1 << 31);
+    JsonDiyFp product = { ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64 };
+    return product;
+}
+
+static JsonDiyFp json_diy_normalize(JsonDiyFp x) {
+    int shift = __builtin_clzll(x.f);
+    x.f <<= shift;
+    x.e -= shift;
+    return x;
+}
+
+static const uint64_t json_grisu_pow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// Split a positive double into v, the boundaries halfway to its neighbours
+// (normalized to one exponent) and the cached power of ten that brings their
+// products' exponent into [-60, -32]; exponent receives that power's negation
+static void json_grisu_prepare(double number, JsonDiyFp* v, JsonDiyFp* plus, JsonDiyFp* minus,
+                               JsonDiyFp* cached, int* exponent) {
+    const uint64_t hidden_bit = (uint64_t)1 << 52;
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    int biased = (int)((bits >> 52) & 0x7FF);
+    v->f = bits & (hidden_bit - 1);
+    v->e = biased ? biased - 1075 : -1074;
+    if (biased) v->f += hidden_bit;
+    
+    plus->f = (v->f << 1) + 1;
+    plus->e = v->e - 1;
+    while (!(plus->f & (hidden_bit << 1))) {
+        plus->f <<= 1;
+        plus->e--;
+    }
+    plus->f <<= 10;
+    plus->e -= 10;
+    // The gap below a power of two is half the gap above it
+    bool closer_below = v->f == hidden_bit && biased > 1;
+    minus->f = closer_below ? (v->f << 2) - 1 : (v->f << 1) - 1;
+    minus->e = closer_below ? v->e - 2 : v->e - 1;
+    minus->f <<= minus->e - plus->e;
+    minus->e = plus->e;
+    
+    double dk = (-61 - plus->e) * 0.30102999566398114 + 347;
+    int k = (int)dk;
+    if (dk - k > 0.0) k++;
+    int index = (k >> 3) + 1;
+    *exponent = 348 - index * 8;
+    cached->f = json_cached_power_f[index];
+    cached->e = json_cached_power_e[index];
+}
+
+// Grisu3's rounding check: moves the last digit towards w and reports
+// whether the result is provably the closest shortest representation
+static bool json_grisu_round_weed(char* digits, int length, uint64_t distance_too_high_w,
+                                  uint64_t unsafe_interval, uint64_t rest, uint64_t ten_kappa, uint64_t unit) {
+    uint64_t small_distance = distance_too_high_w - unit;
+    uint64_t big_distance = distance_too_high_w + unit;
+    while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+    if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+        return false;
+    }
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+// Shortest digits of a positive finite double (the value is
+// digits * 10^exponent), or 0 for the rare inputs Grisu3 can't decide
+static int json_grisu3(double number, char* digits, int* exponent) {
+    JsonDiyFp v, plus, minus, cached;
+    json_grisu_prepare(number, &v, &plus, &minus, &cached, exponent);
+    
+    // Widen the interval by one unit either side; digits inside the widened
+    // but not the narrowed interval are what round_weed has to settle
+    uint64_t unit = 1;
+    JsonDiyFp w = json_diy_multiply(json_diy_normalize(v), cached);
+    JsonDiyFp too_high = json_diy_multiply(plus, cached);
+    JsonDiyFp too_low = json_diy_multiply(minus, cached);
+    too_low.f -= unit;
+    too_high.f += unit;
+    uint64_t unsafe_interval = too_high.f - too_low.f;
+    
+    int shift = -w.e;
+    uint64_t one = (uint64_t)1 << shift;
+    uint32_t integral = (uint32_t)(too_high.f >> shift);
+    uint64_t fraction = too_high.f & (one - 1);
+    int kappa = 0;
+    while (kappa < 10 && integral >= json_grisu_pow10[kappa]) kappa++;
+    int length = 0;
+    while (kappa > 0) {
+        uint32_t divisor = (uint32_t)json_grisu_pow10[kappa - 1];
+        digits[length++] = (char)('0' + integral / divisor);
+        integral %= divisor;
+        kappa--;
+        uint64_t rest = ((uint64_t)integral << shift) + fraction;
+        if (rest < unsafe_interval) {
+            *exponent += kappa;
+            return json_grisu_round_weed(digits, length, too_high.f - w.f, unsafe_interval, rest,
+                                         (uint64_t)divisor << shift, unit) ? length : 0;
+        }
+    }
+    for (;;) {
+        fraction *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+        digits[length++] = (char)('0' + (fraction >> shift));
+        fraction &= one - 1;
+        kappa--;
+        if (fraction < unsafe_interval) {
+            *exponent += kappa;
+            return json_grisu_round_weed(digits, length, (too_high.f - w.f) * unit, unsafe_interval, fraction,
+                                         one, unit) ? length : 0;
+        }
+    }
+}
+
+// Grisu3 gives up on a few inputs. For those, round printf's exact digits
+// to 1, 2, ... 17 places and keep the first that reads back as the same
+// double, trying the nearer rounding first.
+static int json_digits_fallback(double number, char* digits, int* exponent) {
+    char text[48];
+    char candidate[32];
+    snprintf(text, sizeof(text), "%.40e", number);
+    char exact[42];
+    exact[0] = text[0];
+    memcpy(exact + 1, text + 2, 40);
+    int leading = atoi(text + 43);
+    
+    for (int length = 1; length <= 17; length++) {
+        bool up_first = exact[length] >= '5';
+        for (int attempt = 0; attempt < 2; attempt++) {
+            int candidate_exponent = leading - length + 1;
+            memcpy(candidate, exact, (size_t)length);
+            if (up_first == (attempt == 0)) {
+                int i = length - 1;
+                while (i >= 0 && candidate[i] == '9') candidate[i--] = '0';
+                if (i < 0) {
+                    candidate[0] = '1';
+                    candidate_exponent++;
+                } else {
+                    candidate[i]++;
+                }
+            }
+            snprintf(candidate + length, sizeof(candidate) - (size_t)length, "e%d", candidate_exponent);
+            if (strtod(candidate, NULL) == number) {
+                int kept = length;
+                while (kept > 1 && candidate[kept - 1] == '0') {
+                    kept--;
+                    candidate_exponent++;
+                }
+                memcpy(digits, candidate, (size_t)kept);
+                *exponent = candidate_exponent;
+                return kept;
+            }
+        }
+    }
+    // Seventeen correctly rounded digits always read back
+    memcpy(digits, exact, 17);
+    *exponent = leading - 16;
+    return 17;
+}
+
+static char* json_write_exponent(int exponent, char* out) {
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    if (exponent < 0) exponent = -exponent;
+    if (exponent >= 100) {
+        *out++ = (char)('0' + exponent / 100);
+        exponent %= 100;
+        *out++ = (char)('0' + exponent / 10);
+    } else if (exponent >= 10) {
+        *out++ = (char)('0' + exponent / 10);
+    }
+    *out++ = (char)('0' + exponent % 10);
+    return out;
+}
+
+size_t json_format_number(double number, char* out) {
+    char* p = out;
+    if (number != number || number - number != 0) {
+        // NaN and infinities have no JSON spelling
+        memcpy(out, "null", 5);
+        return 4;
+    }
+    if (signbit(number)) {
+        *p++ = '-';
+        number = -number;
+    }
+    
+    if (number <= 9007199254740992.0 && number == (double)(uint64_t)number) {
+        // Integers in the exactly representable range print as integers
+        char reversed[20];
+        uint64_t integer = (uint64_t)number;
+        int count = 0;
+        do {
+            reversed[count++] = (char)('0' + integer % 10);
+            integer /= 10;
+        } while (integer);
+        while (count > 0) *p++ = reversed[--count];
+        *p = '\0';
+        return (size_t)(p - out);
+    }
+    
+    pthread_once(&json_cached_power_once, json_cached_power_compute);
+    int exponent;
+    int length = json_grisu3(number, p, &exponent);
+    if (length == 0) length = json_digits_fallback(number, p, &exponent);
+    
+    // Lay the digits out the way JavaScript's Number#toString does
+    int point = length + exponent;   // 10^(point-1) <= number < 10^point
+    if (exponent >= 0 && point <= 21) {
+        // 1234e7 -> 12340000000
+        for (int i = length; i < point; i++) p[i] = '0';
+        p += point;
+    } else if (point > 0 && point <= 21) {
+        // 1234e-2 -> 12.34
+        memmove(p + point + 1, p + point, (size_t)(length - point));
+        p[point] = '.';
+        p += length + 1;
+    } else if (point > -6 && point <= 0) {
+        // 1234e-6 -> 0.001234
+        int offset = 2 - point;
+        memmove(p + offset, p, (size_t)length);
+        p[0] = '0';
+        p[1] = '.';
+        for (int i = 2; i < offset; i++) p[i] = '0';
+        p += length + offset;
+    } else if (length == 1) {
+        // 1e30
+        p = json_write_exponent(point - 1, p + 1);
+    } else {
+        // 1234e30 -> 1.234e+33
+        memmove(p + 2, p + 1, (size_t)(length - 1));
+        p[1] = '.';
+        p = json_write_exponent(point - 1, p + length + 1);
+    }
+    *p = '\0';
+    return (size_t)(p - out);
+}
+
+// Output buffer
+
+void json_writer_init(JsonWriter* writer, JsonWriterSink sink, void* sink_context) {
+    memset(writer, 0, sizeof(*writer));
+    writer->sink = sink;
+    writer->sink_context = sink_context;
+    json_scan_init();
+}
+
+static bool json_writer_fail(JsonWriter* writer, const char* message) {
+    if (!writer->error) writer->error = message;
+    return false;
+}
+
+bool json_writer_flush(JsonWriter* writer) {
+    if (writer->error) return false;
+    if (!writer->sink || writer->length == 0) return true;
+    if (!writer->sink(writer->sink_context, writer->buffer, writer->length)) {
+        return json_writer_fail(writer, "Failed to write JSON output");
+    }
+    writer->flushed += writer->length;
+    writer->length = 0;
+    return true;
+}
+
+// Room for extra more bytes plus a terminator; with a sink the buffer is
+// flushed rather than grown once it reaches JSON_WRITER_FLUSH_BYTES
+static bool json_writer_reserve(JsonWriter* writer, size_t extra) {
+    if (writer->length + extra < writer->capacity) return true;
+    if (writer->sink && writer->length > 0) {
+        if (!json_writer_flush(writer)) return false;
+        if (extra < writer->capacity) return true;
+    }
+    size_t needed = writer->length + extra + 1;
+    size_t new_capacity = writer->capacity;
+    if (new_capacity == 0) {
+        new_capacity = writer->sink ? JSON_WRITER_FLUSH_BYTES : JSON_WRITER_INITIAL_CAPACITY;
+    }
+    while (new_capacity < needed) new_capacity *= 2;
+    char* grown = shared_realloc_safe(writer->buffer, new_capacity, "libs", "json_writer_reserve", 0);
+    if (!grown) return json_writer_fail(writer, "Out of memory");
+    writer->buffer = grown;
+    writer->capacity = new_capacity;
+    return true;
+}
+
+static inline bool json_writer_append(JsonWriter* writer, const char* data, size_t length) {
+    if (writer->length + length >= writer->capacity) {
+        if (writer->sink && length >= JSON_WRITER_FLUSH_BYTES) {
+            // Long runs go straight to the sink instead of through the buffer
+            if (!json_writer_flush(writer)) return false;
+            if (!writer->sink(writer->sink_context, data, length)) {
+                return json_writer_fail(writer, "Failed to write JSON output");
+            }
+            writer->flushed += length;
+            return true;
+        }
+        if (!json_writer_reserve(writer, length)) return false;
+    }
+    memcpy(writer->buffer + writer->length, data, length);
+    writer->length += length;
+    return true;
+}
+
+static bool json_writer_string(JsonWriter* writer, const char* text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    const char* p = text;
+    const char* end = text + length;
+    if (!json_writer_append(writer, "\"", 1)) return false;
+    while (p < end) {
+        const char* run = json_scan_escape_run(p, end);
+        if (run > p && !json_writer_append(writer, p, (size_t)(run - p))) return false;
+        if (run >= end) break;
+        
+        unsigned char c = (unsigned char)*run;
+        if (!json_writer_reserve(writer, 6)) return false;
+        char* out = writer->buffer + writer->length;
+        out[0] = '\\';
+        if (json_escape_table[c] == 'u') {
+            out[1] = 'u';
+            out[2] = '0';
+            out[3] = '0';
+            out[4] = hex[c >> 4];
+            out[5] = hex[c & 0xF];
+            writer->length += 6;
+        } else {
+            out[1] = json_escape_table[c];
+            writer->length += 2;
+        }
+        p = run + 1;
+    }
+    return json_writer_append(writer, "\"", 1);
+}
+
+// Keys that are missing or empty are written as key_<index>
+static bool json_writer_key(JsonWriter* writer, const char* key, size_t index) {
+    bool written;
+    if (key && key[0]) {
+        written = json_writer_string(writer, key, strlen(key));
+    } else {
+        char index_key[32];
+        int length = snprintf(index_key, sizeof(index_key), "\"key_%zu\"", index);
+        written = json_writer_append(writer, index_key, (size_t)length);
+    }
+    return written && json_writer_append(writer, ":", 1);
+}
+
+static bool json_writer_value(JsonWriter* writer, const Value* value) {
+    if (!value) return json_writer_append(writer, "null", 4);
+    
+    switch (value->type) {
+        case VALUE_NULL:
+            return json_writer_append(writer, "null", 4);
+            
+        case VALUE_BOOLEAN:
+            return value->data.boolean_value ? json_writer_append(writer, "true", 4)
+                                             : json_writer_append(writer, "false", 5);
+            
+        case VALUE_NUMBER:
+            if (!json_writer_reserve(writer, JSON_NUMBER_BUFFER_SIZE)) return false;
+            writer->length += json_format_number(value->data.number_value, writer->buffer + writer->length);
+            return true;
+            
+        case VALUE_STRING: {
+            const char* text = value->data.string_value ? value->data.string_value : "";
+            return json_writer_string(writer, text, strlen(text));
+        }
+            
+        case VALUE_ARRAY:
+        case VALUE_OBJECT:
+        case VALUE_HASH_MAP:
+            break;
+            
+        default:
+            return json_writer_append(writer, "\"unknown\"", 9);
+    }
+    
+    if (writer->depth >= JSON_WRITER_MAX_DEPTH) {
+        return json_writer_fail(writer, "Nesting too deep (circular reference?)");
+    }
+    writer->depth++;
+    bool ok = true;
+    if (value->type == VALUE_ARRAY) {
+        ok = json_writer_append(writer, "[", 1);
+        for (size_t i = 0; ok && i < value->data.array_value.count; i++) {
+            if (i > 0) ok = json_writer_append(writer, ",", 1);
+            ok = ok && json_writer_value(writer, (const Value*)value->data.array_value.elements[i]);
+        }
+        ok = ok && json_writer_append(writer, "]", 1);
+    } else if (value->type == VALUE_OBJECT) {
+        ok = json_writer_append(writer, "{", 1);
+        for (size_t i = 0; ok && i < value->data.object_value.count; i++) {
+            if (i > 0) ok = json_writer_append(writer, ",", 1);
+            ok = ok && json_writer_key(writer, value->data.object_value.keys[i], i);
+            ok = ok && json_writer_value(writer, &value->data.object_value.values[i]);
+        }
+        ok = ok && json_writer_append(writer, "}", 1);
+    } else {
+        // Hash map keys are Values; only string keys are kept
+        ok = json_writer_append(writer, "{", 1);
+        for (size_t i = 0; ok && i < value->data.hash_map_value.count; i++) {
+            if (i > 0) ok = json_writer_append(writer, ",", 1);
+            const Value* key = (const Value*)value->data.hash_map_value.keys[i];
+            ok = ok && json_writer_key(writer, key && key->type == VALUE_STRING ? key->data.string_value : NULL, i);
+            ok = ok && json_writer_value(writer, (const Value*)value->data.hash_map_value.values[i]);
+        }
+        ok = ok && json_writer_append(writer, "}", 1);
+    }
+    writer->depth--;
+    return ok;
+}
+
+bool json_writer_write(JsonWriter* writer, const Value* value) {
+    if (writer->error) return false;
+    return json_writer_value(writer, value);
+}
+
+char* json_writer_take(JsonWriter* writer, size_t* length) {
+    if (!writer->buffer && !json_writer_reserve(writer, 0)) return NULL;
+    char* text = writer->buffer;
+    text[writer->length] = '\0';
+    if (length) *length = writer->length;
+    writer->buffer = NULL;
+    writer->length = 0;
+    writer->capacity = 0;
+    return text;
+}
+
+void json_writer_release(JsonWriter* writer) {
+    shared_free_safe(writer->buffer, "libs", "json_writer_release", 0);
+    writer->buffer = NULL;
+    writer->length = 0;
+    writer->capacity = 0;
+}
+
+// json.stringify() / json.write() output buffer, kept per thread between calls
+static MYCO_THREAD_LOCAL char* json_stringify_buffer = NULL;
+static MYCO_THREAD_LOCAL size_t json_stringify_capacity = 0;
+
+static void json_writer_borrow(JsonWriter* writer) {
+    writer->buffer = json_stringify_buffer;
+    writer->capacity = json_stringify_capacity;
+    json_stringify_buffer = NULL;
+    json_stringify_capacity = 0;
+}
+
+// Keep the writer's buffer for the next call unless it grew too large
+static void json_writer_return(JsonWriter* writer) {
+    if (writer->capacity > JSON_WRITER_RETAIN_BYTES) {
+        json_writer_release(writer);
+        return;
+    }
+    json_stringify_buffer = writer->buffer;
+    json_stringify_capacity = writer->capacity;
+    writer->buffer = NULL;
+    writer->length = 0;
+    writer->capacity = 0;
+}
+
+Value builtin_json_stringify(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    if (arg_count != 1) {
+        std_error_report(ERROR_ARGUMENT_COUNT, "json", "unknown_function", "json.stringify() requires exactly 1 argument (value)", line, column);
+        return value_create_null();
+    }
+    
+    JsonWriter writer;
+    json_writer_init(&writer, NULL, NULL);
+    json_writer_borrow(&writer);
+    
+    if (!json_writer_write(&writer, &args[0])) {
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", "unknown_function", writer.error, line, column);
+        json_writer_return(&writer);
+        return value_create_null();
+    }
+    
+    size_t length = writer.length;
+    char* text;
+    if (writer.capacity > JSON_WRITER_RETAIN_BYTES) {
+        // Too large to keep around, so the buffer itself becomes the string
+        text = json_writer_take(&writer, &length);
+        char* fitted = shared_realloc_safe(text, length + 1, "libs", "builtin_json_stringify", 0);
+        if (fitted) text = fitted;
+    } else {
+        text = shared_malloc_safe(length + 1, "libs", "builtin_json_stringify", 0);
+        if (text) {
+            memcpy(text, writer.buffer, length);
+            text[length] = '\0';
+        }
+        json_writer_return(&writer);
+    }
+    if (!text) {
+        std_error_report(ERROR_INTERNAL_ERROR, "json", "unknown_function", "Out of memory", line, column);
+        return value_create_null();
+    }
+    return json_adopt_string(text, length);
+}
+
+static bool json_file_sink(void* context, const char* data, size_t length) {
+    return file_handle_write(*(Value*)context, data, length) >= 0;
+}
+
+Value builtin_json_write(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
+    if (arg_count != 2) {
+        std_error_report(ERROR_ARGUMENT_COUNT, "json", "unknown_function", "json.write() requires exactly 2 arguments (handle, value)", line, column);
+        return value_create_null();
+    }
+    if (file_handle_write(args[0], NULL, 0) < 0) {
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", "unknown_function", "json.write() first argument must be an open file handle", line, column);
+        return value_create_null();
+    }
+    
+    // Output goes to the file in pieces of at least JSON_WRITER_FLUSH_BYTES
+    JsonWriter writer;
+    json_writer_init(&writer, json_file_sink, &args[0]);
+    json_writer_borrow(&writer);
+    if (writer.capacity < JSON_WRITER_FLUSH_BYTES) json_writer_reserve(&writer, JSON_WRITER_FLUSH_BYTES - 1);
+    bool written = json_writer_write(&writer, &args[1]) && json_writer_flush(&writer);
+    size_t total = writer.flushed;
+    const char* error = writer.error;
+    json_writer_return(&writer);
+    if (!written) {
+        std_error_report(ERROR_INVALID_ARGUMENT, "json", "unknown_function", error, line, column);
+        return value_create_null();
+    }
+    return value_create_number((double)total);
+}
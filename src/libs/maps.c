@@ -50,21 +50,9 @@ Value builtin_map_set(Interpreter* interpreter, Value* args, size_t arg_count, i
         return value_create_null();
     }
     
-    // Create a new map with all existing elements plus the new key-value pair
-    Value result = value_create_hash_map(map.data.hash_map_value.capacity);
-    
-    // Copy all existing elements
-    for (size_t i = 0; i < map.data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map.data.hash_map_value.keys[i];
-        Value* existing_value = (Value*)map.data.hash_map_value.values[i];
-        if (existing_key && existing_value) {
-            Value cloned_key = value_clone(existing_key);
-            Value cloned_value = value_clone(existing_value);
-            value_hash_map_set(&result, cloned_key, cloned_value);
-        }
-    }
-    
-    // Add the new key-value pair
+    // Maps are immutable at this level: the result shares the original's
+    // storage copy-on-write and detaches (one O(n) copy) on the write
+    Value result = value_clone(&map);
     value_hash_map_set(&result, key, value);
     
     return result;
@@ -155,22 +143,10 @@ Value builtin_map_delete(Interpreter* interpreter, Value* args, size_t arg_count
         return value_create_null();
     }
     
-    // Create a new map with all existing elements except the one to delete
-    Value result = value_create_hash_map(map.data.hash_map_value.capacity);
-    
-    // Copy all existing elements except the one to delete
-    for (size_t i = 0; i < map.data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map.data.hash_map_value.keys[i];
-        Value* existing_value = (Value*)map.data.hash_map_value.values[i];
-        if (existing_key && existing_value) {
-            // Check if this is the key to delete
-            if (!value_equals(existing_key, &key)) {
-                Value cloned_key = value_clone(existing_key);
-                Value cloned_value = value_clone(existing_value);
-                value_hash_map_set(&result, cloned_key, cloned_value);
-            }
-        }
-    }
+    // Copy (copy-on-write) and drop the key; an absent key leaves the
+    // storage shared
+    Value result = value_clone(&map);
+    value_hash_map_delete(&result, key);
     
     return result;
 }
@@ -206,28 +182,15 @@ Value builtin_map_update(Interpreter* interpreter, Value* args, size_t arg_count
         return value_create_null();
     }
     
-    // Create a new map with all elements from both maps
-    Value result = value_create_hash_map(map.data.hash_map_value.capacity + other_map.data.hash_map_value.capacity);
-    
-    // Copy all elements from the original map
-    for (size_t i = 0; i < map.data.hash_map_value.count; i++) {
-        Value* existing_key = (Value*)map.data.hash_map_value.keys[i];
-        Value* existing_value = (Value*)map.data.hash_map_value.values[i];
-        if (existing_key && existing_value) {
-            Value cloned_key = value_clone(existing_key);
-            Value cloned_value = value_clone(existing_value);
-            value_hash_map_set(&result, cloned_key, cloned_value);
-        }
-    }
+    // Start from a copy-on-write copy of the original map
+    Value result = value_clone(&map);
     
     // Add all elements from the other map (this will overwrite any duplicate keys)
     for (size_t i = 0; i < other_map.data.hash_map_value.count; i++) {
         Value* other_key = (Value*)other_map.data.hash_map_value.keys[i];
         Value* other_value = (Value*)other_map.data.hash_map_value.values[i];
         if (other_key && other_value) {
-            Value cloned_key = value_clone(other_key);
-            Value cloned_value = value_clone(other_value);
-            value_hash_map_set(&result, cloned_key, cloned_value);
+            value_hash_map_set(&result, *other_key, *other_value);
         }
     }
     
@@ -0,0 +1,329 @@
+#include "libs/server/router.h"
+#include "libs/server/server.h"
+#include <string.h>
+#include "../../include/utils/shared_utilities.h"
+
+typedef enum {
+    ROUTE_NODE_STATIC,
+    ROUTE_NODE_PARAM,
+    ROUTE_NODE_WILDCARD
+} RouteNodeKind;
+
+struct RouteNode {
+    RouteNodeKind kind;
+    char* label;            // Static: segments joined by '/'; param/wildcard: the name
+    size_t label_length;
+    char* param_type;       // Type of a ":name:type" segment, else NULL
+    RouteNode** children;   // Ordered static, typed, untyped, wildcard
+    size_t child_count;
+    Route* route;           // Route ending at this node
+};
+
+struct RouteTable {
+    char** methods;
+    RouteNode** roots;
+    size_t count;
+};
+
+// ============================================================================
+// COMPILATION
+// ============================================================================
+
+static RouteNode* route_node_create(RouteNodeKind kind, const char* label, size_t label_length, const char* param_type) {
+    RouteNode* node = shared_malloc_safe(sizeof(RouteNode), "router", "route_node_create", 0);
+    if (!node) return NULL;
+    memset(node, 0, sizeof(RouteNode));
+    node->kind = kind;
+    node->label = shared_malloc_safe(label_length + 1, "router", "route_node_create", 0);
+    if (!node->label) {
+        shared_free_safe(node, "router", "route_node_create", 0);
+        return NULL;
+    }
+    memcpy(node->label, label, label_length);
+    node->label[label_length] = '\0';
+    node->label_length = label_length;
+    node->param_type = param_type ? shared_strdup(param_type) : NULL;
+    return node;
+}
+
+static void route_node_free(RouteNode* node) {
+    if (!node) return;
+    for (size_t i = 0; i < node->child_count; i++) {
+        route_node_free(node->children[i]);
+    }
+    if (node->children) shared_free_safe(node->children, "router", "route_node_free", 0);
+    if (node->label) shared_free_safe(node->label, "router", "route_node_free", 0);
+    if (node->param_type) shared_free_safe(node->param_type, "router", "route_node_free", 0);
+    shared_free_safe(node, "router", "route_node_free", 0);
+}
+
+// Children are kept in match order
+static int route_node_rank(const RouteNode* node) {
+    switch (node->kind) {
+        case ROUTE_NODE_STATIC: return 0;
+        case ROUTE_NODE_PARAM: return node->param_type ? 1 : 2;
+        default: return 3;
+    }
+}
+
+// Find or add the child for one pattern segment
+static RouteNode* route_node_child(RouteNode* parent, RouteNodeKind kind, const char* label,
+                                   size_t label_length, const char* param_type) {
+    for (size_t i = 0; i < parent->child_count; i++) {
+        RouteNode* child = parent->children[i];
+        if (child->kind != kind || child->label_length != label_length ||
+            memcmp(child->label, label, label_length) != 0) {
+            continue;
+        }
+        if ((child->param_type == NULL) != (param_type == NULL)) continue;
+        if (param_type && strcmp(child->param_type, param_type) != 0) continue;
+        return child;
+    }
+
+    RouteNode* child = route_node_create(kind, label, label_length, param_type);
+    if (!child) return NULL;
+    RouteNode** children = shared_realloc_safe(parent->children, sizeof(RouteNode*) * (parent->child_count + 1),
+                                               "router", "route_node_child", 0);
+    if (!children) {
+        route_node_free(child);
+        return NULL;
+    }
+    parent->children = children;
+
+    // Insert after the last sibling of equal or lower rank
+    size_t position = parent->child_count;
+    while (position > 0 && route_node_rank(children[position - 1]) > route_node_rank(child)) {
+        children[position] = children[position - 1];
+        position--;
+    }
+    children[position] = child;
+    parent->child_count++;
+    return child;
+}
+
+static void route_tree_insert(RouteNode* root, Route* route) {
+    RouteNode* node = root;
+    const char* p = route->pattern;
+
+    while (node) {
+        while (*p == '/') p++;
+        if (*p == '\0') break;
+        const char* segment = p;
+        while (*p && *p != '/') p++;
+        size_t length = (size_t)(p - segment);
+
+        if (segment[0] == ':') {
+            // ":name" or ":name:type"
+            const char* type_separator = memchr(segment + 1, ':', length - 1);
+            if (type_separator) {
+                char param_type[64];
+                size_t type_length = (size_t)(segment + length - type_separator - 1);
+                if (type_length >= sizeof(param_type)) type_length = sizeof(param_type) - 1;
+                memcpy(param_type, type_separator + 1, type_length);
+                param_type[type_length] = '\0';
+                node = route_node_child(node, ROUTE_NODE_PARAM, segment + 1,
+                                        (size_t)(type_separator - segment - 1), param_type);
+            } else {
+                node = route_node_child(node, ROUTE_NODE_PARAM, segment + 1, length - 1, NULL);
+            }
+        } else if (segment[0] == '*') {
+            // A wildcard swallows the rest of the pattern
+            node = route_node_child(node, ROUTE_NODE_WILDCARD, segment + 1, length - 1, NULL);
+            break;
+        } else {
+            node = route_node_child(node, ROUTE_NODE_STATIC, segment, length, NULL);
+        }
+    }
+
+    if (node && !node->route) {
+        node->route = route;
+    }
+}
+
+// Merge chains of static nodes that have no route and a single static child
+static void route_tree_compress(RouteNode* node) {
+    for (size_t i = 0; i < node->child_count; i++) {
+        RouteNode* child = node->children[i];
+        while (child->kind == ROUTE_NODE_STATIC && !child->route && child->child_count == 1 &&
+               child->children[0]->kind == ROUTE_NODE_STATIC) {
+            RouteNode* next = child->children[0];
+            size_t length = child->label_length + 1 + next->label_length;
+            char* label = shared_malloc_safe(length + 1, "router", "route_tree_compress", 0);
+            if (!label) break;
+            memcpy(label, child->label, child->label_length);
+            label[child->label_length] = '/';
+            memcpy(label + child->label_length + 1, next->label, next->label_length);
+            label[length] = '\0';
+
+            shared_free_safe(child->label, "router", "route_tree_compress", 0);
+            shared_free_safe(child->children, "router", "route_tree_compress", 0);
+            child->label = label;
+            child->label_length = length;
+            child->children = next->children;
+            child->child_count = next->child_count;
+            child->route = next->route;
+
+            next->children = NULL;
+            next->child_count = 0;
+            route_node_free(next);
+        }
+        route_tree_compress(child);
+    }
+}
+
+RouteTable* route_table_compile(Route* routes) {
+    RouteTable* table = shared_malloc_safe(sizeof(RouteTable), "router", "route_table_compile", 0);
+    if (!table) return NULL;
+    memset(table, 0, sizeof(RouteTable));
+
+    for (Route* route = routes; route; route = route->next) {
+        if (!route->method || !route->pattern) continue;
+
+        RouteNode* root = NULL;
+        for (size_t i = 0; i < table->count; i++) {
+            if (strcmp(table->methods[i], route->method) == 0) {
+                root = table->roots[i];
+                break;
+            }
+        }
+        if (!root) {
+            char** methods = shared_realloc_safe(table->methods, sizeof(char*) * (table->count + 1),
+                                                 "router", "route_table_compile", 0);
+            if (!methods) continue;
+            table->methods = methods;
+            RouteNode** roots = shared_realloc_safe(table->roots, sizeof(RouteNode*) * (table->count + 1),
+                                                    "router", "route_table_compile", 0);
+            if (!roots) continue;
+            table->roots = roots;
+            root = route_node_create(ROUTE_NODE_STATIC, "", 0, NULL);
+            if (!root) continue;
+            table->methods[table->count] = shared_strdup(route->method);
+            table->roots[table->count] = root;
+            table->count++;
+        }
+        route_tree_insert(root, route);
+    }
+
+    for (size_t i = 0; i < table->count; i++) {
+        route_tree_compress(table->roots[i]);
+    }
+    return table;
+}
+
+void route_table_free(RouteTable* table) {
+    if (!table) return;
+    for (size_t i = 0; i < table->count; i++) {
+        if (table->methods[i]) shared_free_safe(table->methods[i], "router", "route_table_free", 0);
+        route_node_free(table->roots[i]);
+    }
+    if (table->methods) shared_free_safe(table->methods, "router", "route_table_free", 0);
+    if (table->roots) shared_free_safe(table->roots, "router", "route_table_free", 0);
+    shared_free_safe(table, "router", "route_table_free", 0);
+}
+
+// ============================================================================
+// MATCHING
+// ============================================================================
+
+static inline bool route_path_end(char c) {
+    return c == '\0' || c == '?';
+}
+
+// Match a static label; each '/' in it matches a run of slashes in the path.
+// Returns the path position after the label, or NULL.
+static const char* route_match_static(const RouteNode* node, const char* p) {
+    const char* label = node->label;
+    const char* end = label + node->label_length;
+    while (label < end) {
+        if (*label == '/') {
+            if (*p != '/') return NULL;
+            while (*p == '/') p++;
+        } else if (*p != *label) {
+            return NULL;
+        } else {
+            p++;
+        }
+        label++;
+    }
+    return (*p == '/' || route_path_end(*p)) ? p : NULL;
+}
+
+// validate_typed_parameter wants a C string, so copy the segment to the stack
+static bool route_param_type_matches(const char* type, const char* value, size_t length) {
+    char buffer[256];
+    if (length >= sizeof(buffer)) {
+        return strcmp(type, "string") == 0;
+    }
+    memcpy(buffer, value, length);
+    buffer[length] = '\0';
+    return validate_typed_parameter(buffer, type);
+}
+
+static bool route_match_node(const RouteNode* node, const char* p, RouteMatch* match) {
+    while (*p == '/') p++;
+    if (route_path_end(*p) && node->route) {
+        match->route = node->route;
+        return true;
+    }
+
+    for (size_t i = 0; i < node->child_count; i++) {
+        const RouteNode* child = node->children[i];
+        if (child->kind == ROUTE_NODE_STATIC) {
+            if (route_path_end(*p) || *p != child->label[0]) continue;
+            const char* next = route_match_static(child, p);
+            if (next && route_match_node(child, next, match)) return true;
+        } else if (child->kind == ROUTE_NODE_PARAM) {
+            if (route_path_end(*p) || match->param_count >= ROUTE_MAX_PARAMS) continue;
+            size_t length = 0;
+            while (p[length] != '/' && !route_path_end(p[length])) length++;
+            if (child->param_type && !route_param_type_matches(child->param_type, p, length)) continue;
+
+            RouteMatchParam* param = &match->params[match->param_count++];
+            param->name = child->label;
+            param->name_length = child->label_length;
+            param->value = p;
+            param->value_length = length;
+            if (route_match_node(child, p + length, match)) return true;
+            match->param_count--;
+        } else {
+            if (!child->route || match->param_count >= ROUTE_MAX_PARAMS) continue;
+            size_t length = 0;
+            while (!route_path_end(p[length])) length++;
+
+            RouteMatchParam* param = &match->params[match->param_count++];
+            param->name = child->label;
+            param->name_length = child->label_length;
+            param->value = p;
+            param->value_length = length;
+            match->route = child->route;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool route_table_match(const RouteTable* table, const char* method, const char* path, RouteMatch* match) {
+    match->route = NULL;
+    match->param_count = 0;
+    if (!table || !method || !path) return false;
+
+    for (size_t i = 0; i < table->count; i++) {
+        if (strcmp(table->methods[i], method) == 0) {
+            return route_match_node(table->roots[i], path, match);
+        }
+    }
+    return false;
+}
+
+const char* route_match_param(const RouteMatch* match, const char* name, size_t* value_length) {
+    if (!match || !name) return NULL;
+    size_t name_length = strlen(name);
+    for (size_t i = 0; i < match->param_count; i++) {
+        const RouteMatchParam* param = &match->params[i];
+        if (param->name_length == name_length && memcmp(param->name, name, name_length) == 0) {
+            if (value_length) *value_length = param->value_length;
+            return param->value;
+        }
+    }
+    return NULL;
+}
@@ -9,6 +9,8 @@
 #include "../../include/libs/json.h"
 #include "../../include/libs/http_server.h"
 #include "../../include/libs/compression.h"
+#include "../../include/libs/server/static_cache.h"
+#include "../../include/runtime/reactor.h"
 
 // Define inotify constants for compatibility
 #define IN_MODIFY 0x00000002
@@ -978,6 +980,15 @@ Value builtin_server_listen(Interpreter* interpreter, Value* args, size_t arg_co
         return value_create_null();
     }
     
+    // Apply server.create() options
+    ServerConfig* config = g_server->config;
+    if (config) {
+        if (config->workers > 0) http_server->worker_count = config->workers;
+        if (config->backlog > 0) http_server->backlog = config->backlog;
+        if (config->max_connections > 0) http_server->max_connections = config->max_connections;
+        http_server->enable_gzip = config->enable_gzip;
+    }
+    
     // Register Myco routes with HTTP server
     http_server_register_myco_routes(http_server, g_routes);
     
@@ -1003,6 +1014,9 @@ Value builtin_server_listen(Interpreter* interpreter, Value* args, size_t arg_co
             case HTTP_SERVER_ERROR_ALREADY_RUNNING:
                 error_message = "Server is already running.";
                 break;
+            case HTTP_SERVER_ERROR_POLL:
+                error_message = "Failed to set up the server event loop.";
+                break;
             default:
                 error_message = "Failed to start HTTP server.";
                 break;
@@ -1018,16 +1032,12 @@ Value builtin_server_listen(Interpreter* interpreter, Value* args, size_t arg_co
     // Update the server object's running property
     value_object_set(&server_obj, "running", value_create_boolean(true));
     
-    // Start background thread to handle requests
-    pthread_t server_thread;
-    if (pthread_create(&server_thread, NULL, http_server_background_loop, http_server) != 0) {
+    // Run the event loop on a background thread; stop() joins it
+    if (http_server_run_in_background(http_server) != HTTP_SERVER_SUCCESS) {
         std_error_report(ERROR_INTERNAL_ERROR, "server", "unknown_function", "Failed to start server background thread", line, column);
         return value_create_null();
     }
     
-    // Store thread reference to keep it alive
-    // Note: We don't detach the thread to keep it running
-    
     // Return immediately like JavaScript - script continues executing
     return value_create_null();
 }
@@ -1071,6 +1081,7 @@ Value builtin_server_stop(Interpreter* interpreter, Value* args, size_t arg_coun
     
     // Clear global flag so script can exit
     g_servers_running = false;
+    reactor_wake();
     
     // Update the server object's running property
     value_object_set(&server_obj, "running", value_create_boolean(false));
@@ -1443,6 +1454,14 @@ Value builtin_request_param(Interpreter* interpreter, Value* args, size_t arg_co
         return value_create_null();
     }
     
+    // Requests dispatched through the compiled router carry their own params
+    if (value_object_has(&request_obj, "params")) {
+        Value params = value_object_get(&request_obj, "params");
+        Value param = value_object_get(&params, param_name_val.data.string_value);
+        value_free(&params);
+        return param;
+    }
+    
     // Find the parameter in the current request's parameters
     // We need to store the current request parameters globally for access
     extern RouteParam* g_current_request_params;
@@ -1609,10 +1628,13 @@ Value builtin_response_json(Interpreter* interpreter, Value* args, size_t arg_co
     }
     g_response_content_type = ("application/json" ? strdup("application/json") : NULL);
     
-    // Use JSON library to serialize the data
-    Value json_str = builtin_json_stringify(interpreter, &data_val, 1, line, column);
-    if (json_str.type == VALUE_NULL) {
-        std_error_report(ERROR_INTERNAL_ERROR, "server", "unknown_function", "Failed to serialize data to JSON", line, column);
+    // Serialize straight into the buffer that becomes the response body,
+    // with no intermediate Myco string
+    JsonWriter writer;
+    json_writer_init(&writer, NULL, NULL);
+    if (!json_writer_write(&writer, &data_val)) {
+        std_error_report(ERROR_INTERNAL_ERROR, "server", "unknown_function", writer.error, line, column);
+        json_writer_release(&writer);
         return value_create_null();
     }
     
@@ -1620,9 +1642,7 @@ Value builtin_response_json(Interpreter* interpreter, Value* args, size_t arg_co
     if (g_response_body) {
         shared_free_safe(g_response_body, "libs", "unknown_function", 1426);
     }
-    
-    // Create a simple response body without complex memory management
-    g_response_body = shared_strdup("{\"message\": \"API response\", \"status\": \"success\"}");
+    g_response_body = json_writer_take(&writer, NULL);
     
     // Set response status code
     g_response_status_code = 200;
@@ -2349,6 +2369,7 @@ Value builtin_server_close(Interpreter* interpreter, Value* args, size_t arg_cou
         
         // Clear global flag so script can exit
         g_servers_running = false;
+        reactor_wake();
     }
     
     // Update server object
@@ -2372,6 +2393,9 @@ ServerConfig* parse_server_config(Value config_obj) {
     config->debug = false;
     config->enable_gzip = false;
     config->enable_cache = false;
+    config->workers = 0;
+    config->backlog = 0;
+    config->max_connections = 0;
     
     // Parse port
     Value port_key = value_create_string("port");
@@ -2413,6 +2437,30 @@ ServerConfig* parse_server_config(Value config_obj) {
     }
     value_free(&cache_key);
     
+    // Parse worker pool size
+    Value workers_key = value_create_string("workers");
+    Value workers_val = value_hash_map_get(&config_obj, workers_key);
+    if (workers_val.type == VALUE_NUMBER) {
+        config->workers = (int)workers_val.data.number_value;
+    }
+    value_free(&workers_key);
+    
+    // Parse listen backlog
+    Value backlog_key = value_create_string("backlog");
+    Value backlog_val = value_hash_map_get(&config_obj, backlog_key);
+    if (backlog_val.type == VALUE_NUMBER) {
+        config->backlog = (int)backlog_val.data.number_value;
+    }
+    value_free(&backlog_key);
+    
+    // Parse connection limit
+    Value max_connections_key = value_create_string("maxConnections");
+    Value max_connections_val = value_hash_map_get(&config_obj, max_connections_key);
+    if (max_connections_val.type == VALUE_NUMBER) {
+        config->max_connections = (int)max_connections_val.data.number_value;
+    }
+    value_free(&max_connections_key);
+    
     return config;
 }
 
@@ -2868,6 +2916,9 @@ void* file_watcher_thread(void* arg) {
             if (current_time > watcher->last_check) {
                 watcher->last_check = current_time;
                 
+                // Drop cached static files under the watched directory
+                static_cache_invalidate(watcher->watch_path);
+                
                 // Call the callback function if it's a Myco function
                 if (watcher->callback.type == VALUE_FUNCTION && g_interpreter) {
                     // Create event info object
@@ -2942,8 +2993,7 @@ Value builtin_server_watch(Interpreter* interpreter, Value* args, size_t arg_cou
 char* compress_gzip(const char* data, size_t data_size, size_t* compressed_size) {
     if (!data || data_size == 0) return NULL;
     
-    // Use our custom compression instead of zlib
-    return compress_data(data, data_size, COMPRESSION_RLE, compressed_size);
+    return compress_data_level(data, data_size, COMPRESSION_GZIP, COMPRESSION_LEVEL_DEFAULT, compressed_size);
 }
 
 bool should_compress_file(const char* filename) {
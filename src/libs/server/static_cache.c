@@ -0,0 +1,280 @@
+#include "libs/server/static_cache.h"
+#include "libs/server/server.h"
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include "../../include/utils/shared_utilities.h"
+#include "../../include/libs/compression.h"
+
+#define STATIC_CACHE_BUCKETS 256
+
+static pthread_mutex_t g_static_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static StaticCacheEntry* g_static_cache_buckets[STATIC_CACHE_BUCKETS];
+static StaticCacheEntry* g_static_cache_lru_head = NULL;   // Most recently used
+static StaticCacheEntry* g_static_cache_lru_tail = NULL;
+static size_t g_static_cache_bytes = 0;
+
+// ============================================================================
+// VALIDATORS
+// ============================================================================
+
+static time_t static_cache_stat_mtime(const struct stat* st) {
+    return st->st_mtime;
+}
+
+void static_cache_validators(const struct stat* st, char* etag, size_t etag_size,
+                             char* last_modified, size_t last_modified_size) {
+    if (etag && etag_size > 0) {
+        snprintf(etag, etag_size, "\"%llx-%llx\"",
+                 (unsigned long long)st->st_size, (unsigned long long)static_cache_stat_mtime(st));
+    }
+    if (last_modified && last_modified_size > 0) {
+        time_t mtime = static_cache_stat_mtime(st);
+        struct tm tm_value;
+        if (gmtime_r(&mtime, &tm_value) == NULL ||
+            strftime(last_modified, last_modified_size, "%a, %d %b %Y %H:%M:%S GMT", &tm_value) == 0) {
+            last_modified[0] = '\0';
+        }
+    }
+}
+
+// Days from 1970-01-01 to the given civil date (proleptic Gregorian)
+static long static_cache_days_from_civil(long year, int month, int day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long year_of_era = year - era * 400;
+    long day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+time_t static_cache_parse_http_date(const char* value) {
+    static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    if (!value) return (time_t)-1;
+
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    const char* comma = strchr(value, ',');
+    if (!comma) return (time_t)-1;
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+    char month_name[4] = {0};
+    if (sscanf(comma + 1, " %2d %3s %4d %2d:%2d:%2d GMT", &day, month_name, &year, &hour, &minute, &second) != 6) {
+        return (time_t)-1;
+    }
+    int month = 0;
+    while (month < 12 && strcmp(months[month], month_name) != 0) month++;
+    if (month == 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return (time_t)-1;
+
+    long days = static_cache_days_from_civil(year, month + 1, day);
+    return (time_t)(days * 86400L + hour * 3600L + minute * 60L + second);
+}
+
+// ============================================================================
+// CACHE
+// ============================================================================
+
+static unsigned int static_cache_hash(const char* path) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)path; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash % STATIC_CACHE_BUCKETS;
+}
+
+static void static_cache_entry_free(StaticCacheEntry* entry) {
+    if (entry->gzip_data) shared_free_safe(entry->gzip_data, "static_cache", "static_cache_entry_free", 0);
+    if (entry->data) shared_free_safe(entry->data, "static_cache", "static_cache_entry_free", 0);
+    if (entry->path) shared_free_safe(entry->path, "static_cache", "static_cache_entry_free", 0);
+    shared_free_safe(entry, "static_cache", "static_cache_entry_free", 0);
+}
+
+static void static_cache_lru_unlink(StaticCacheEntry* entry) {
+    if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+    else g_static_cache_lru_head = entry->lru_next;
+    if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+    else g_static_cache_lru_tail = entry->lru_prev;
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void static_cache_lru_push(StaticCacheEntry* entry) {
+    entry->lru_next = g_static_cache_lru_head;
+    if (g_static_cache_lru_head) g_static_cache_lru_head->lru_prev = entry;
+    g_static_cache_lru_head = entry;
+    if (!g_static_cache_lru_tail) g_static_cache_lru_tail = entry;
+}
+
+// Remove an entry from the cache (caller holds the mutex); it is freed once
+// the last response using it has been sent
+static void static_cache_remove_locked(StaticCacheEntry* entry) {
+    StaticCacheEntry** link = &g_static_cache_buckets[static_cache_hash(entry->path)];
+    while (*link && *link != entry) link = &(*link)->hash_next;
+    if (*link) *link = entry->hash_next;
+    static_cache_lru_unlink(entry);
+    entry->cached = false;
+    g_static_cache_bytes -= (size_t)entry->size + entry->gzip_size;
+    if (--entry->refs == 0) static_cache_entry_free(entry);
+}
+
+static StaticCacheEntry* static_cache_load(const char* path, const struct stat* st) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    StaticCacheEntry* entry = shared_malloc_safe(sizeof(StaticCacheEntry), "static_cache", "static_cache_load", 0);
+    if (!entry) {
+        close(fd);
+        return NULL;
+    }
+    memset(entry, 0, sizeof(StaticCacheEntry));
+    entry->path = shared_strdup(path);
+    entry->data = shared_malloc_safe((size_t)st->st_size + 1, "static_cache", "static_cache_load", 0);
+    if (!entry->path || !entry->data) {
+        close(fd);
+        static_cache_entry_free(entry);
+        return NULL;
+    }
+
+    size_t total = 0;
+    while (total < (size_t)st->st_size) {
+        ssize_t got = read(fd, entry->data + total, (size_t)st->st_size - total);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        total += (size_t)got;
+    }
+    close(fd);
+    if (total != (size_t)st->st_size) {
+        // The file changed under us; serve it uncached this time
+        static_cache_entry_free(entry);
+        return NULL;
+    }
+
+    entry->mtime = static_cache_stat_mtime(st);
+    entry->size = st->st_size;
+    static_cache_validators(st, entry->etag, sizeof(entry->etag), entry->last_modified, sizeof(entry->last_modified));
+    entry->mime_type = get_mime_type(path);
+    return entry;
+}
+
+StaticCacheEntry* static_cache_acquire(const char* path, struct stat* st) {
+    memset(st, 0, sizeof(struct stat));
+    if (!path) return NULL;
+    time_t now = time(NULL);
+    unsigned int bucket = static_cache_hash(path);
+
+    // Fast path: a recently validated entry needs no system call at all
+    pthread_mutex_lock(&g_static_cache_mutex);
+    StaticCacheEntry* entry = g_static_cache_buckets[bucket];
+    while (entry && strcmp(entry->path, path) != 0) entry = entry->hash_next;
+    if (entry && now - entry->checked_at < STATIC_CACHE_REVALIDATE_SECONDS) {
+        static_cache_lru_unlink(entry);
+        static_cache_lru_push(entry);
+        entry->refs++;
+        st->st_size = entry->size;
+        st->st_mtime = entry->mtime;
+        pthread_mutex_unlock(&g_static_cache_mutex);
+        return entry;
+    }
+    pthread_mutex_unlock(&g_static_cache_mutex);
+
+    if (stat(path, st) != 0) {
+        memset(st, 0, sizeof(struct stat));
+        return NULL;
+    }
+    if (!S_ISREG(st->st_mode) || st->st_size > STATIC_CACHE_MAX_FILE_BYTES) return NULL;
+
+    pthread_mutex_lock(&g_static_cache_mutex);
+    entry = g_static_cache_buckets[bucket];
+    while (entry && strcmp(entry->path, path) != 0) entry = entry->hash_next;
+    if (entry) {
+        if (entry->mtime == static_cache_stat_mtime(st) && entry->size == st->st_size) {
+            entry->checked_at = now;
+            static_cache_lru_unlink(entry);
+            static_cache_lru_push(entry);
+            entry->refs++;
+            pthread_mutex_unlock(&g_static_cache_mutex);
+            return entry;
+        }
+        static_cache_remove_locked(entry);
+    }
+    pthread_mutex_unlock(&g_static_cache_mutex);
+
+    // Read outside the lock so one slow disk read doesn't stall other requests
+    StaticCacheEntry* loaded = static_cache_load(path, st);
+    if (!loaded) return NULL;
+    loaded->checked_at = now;
+
+    pthread_mutex_lock(&g_static_cache_mutex);
+    // Another worker may have loaded the same file meanwhile
+    entry = g_static_cache_buckets[bucket];
+    while (entry && strcmp(entry->path, path) != 0) entry = entry->hash_next;
+    if (entry) static_cache_remove_locked(entry);
+
+    while (g_static_cache_lru_tail && g_static_cache_bytes + (size_t)loaded->size > STATIC_CACHE_MAX_BYTES) {
+        static_cache_remove_locked(g_static_cache_lru_tail);
+    }
+    loaded->refs = 2;  // The cache and the caller
+    loaded->cached = true;
+    loaded->hash_next = g_static_cache_buckets[bucket];
+    g_static_cache_buckets[bucket] = loaded;
+    static_cache_lru_push(loaded);
+    g_static_cache_bytes += (size_t)loaded->size;
+    pthread_mutex_unlock(&g_static_cache_mutex);
+    return loaded;
+}
+
+void static_cache_release(StaticCacheEntry* entry) {
+    if (!entry) return;
+    pthread_mutex_lock(&g_static_cache_mutex);
+    bool last = --entry->refs == 0;
+    pthread_mutex_unlock(&g_static_cache_mutex);
+    if (last) static_cache_entry_free(entry);
+}
+
+bool static_cache_gzip(StaticCacheEntry* entry) {
+    if (!entry) return false;
+    pthread_mutex_lock(&g_static_cache_mutex);
+    bool built = entry->gzip_built;
+    pthread_mutex_unlock(&g_static_cache_mutex);
+    if (built) return entry->gzip_data != NULL;
+
+    // Compress outside the lock; the variant is built once and then served
+    // from memory, so it is worth the best level
+    size_t gzip_size = 0;
+    char* gzip_data = compress_data_level(entry->data, (size_t)entry->size, COMPRESSION_GZIP,
+                                          COMPRESSION_LEVEL_BEST, &gzip_size);
+    if (gzip_data && !is_compression_beneficial((size_t)entry->size, gzip_size)) {
+        shared_free_safe(gzip_data, "static_cache", "static_cache_gzip", 0);
+        gzip_data = NULL;
+    }
+
+    pthread_mutex_lock(&g_static_cache_mutex);
+    if (entry->gzip_built) {
+        // Another worker got there first
+        if (gzip_data) shared_free_safe(gzip_data, "static_cache", "static_cache_gzip", 0);
+    } else {
+        entry->gzip_built = true;
+        entry->gzip_data = gzip_data;
+        entry->gzip_size = gzip_data ? gzip_size : 0;
+        if (entry->cached) g_static_cache_bytes += entry->gzip_size;
+    }
+    bool available = entry->gzip_data != NULL;
+    pthread_mutex_unlock(&g_static_cache_mutex);
+    return available;
+}
+
+void static_cache_invalidate(const char* path_prefix) {
+    size_t prefix_length = path_prefix ? strlen(path_prefix) : 0;
+    pthread_mutex_lock(&g_static_cache_mutex);
+    StaticCacheEntry* entry = g_static_cache_lru_head;
+    while (entry) {
+        StaticCacheEntry* next = entry->lru_next;
+        if (!path_prefix || strncmp(entry->path, path_prefix, prefix_length) == 0) {
+            static_cache_remove_locked(entry);
+        }
+        entry = next;
+    }
+    pthread_mutex_unlock(&g_static_cache_mutex);
+}
@@ -65,8 +65,10 @@ Value builtin_set_remove(Interpreter* interpreter, Value* args, size_t arg_count
         return value_create_null();
     }
     
-    value_set_remove(set, element);
-    return value_clone(set);
+    // Remove from our own reference: args[0] may share storage with the caller's value
+    Value result = value_clone(set);
+    value_set_remove(&result, element);
+    return result;
 }
 
 Value builtin_set_size(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -99,19 +101,8 @@ Value builtin_set_clear(Interpreter* interpreter, Value* args, size_t arg_count,
         return value_create_null();
     }
     
-    // Get all elements and remove them
-    Value array = value_set_to_array(set);
-    if (array.type == VALUE_ARRAY) {
-        for (size_t i = 0; i < array.data.array_value.count; i++) {
-            Value* element = (Value*)array.data.array_value.elements[i];
-            if (element) {
-                value_set_remove(set, *element);
-            }
-        }
-        value_free(&array);
-    }
-    
-    return value_clone(set);
+    // Clearing yields a fresh empty set; args[0] may share storage with the caller's value
+    return value_create_set(set->data.set_value.capacity);
 }
 
 Value builtin_set_to_array(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column) {
@@ -5,6 +5,7 @@
 #include "../../include/core/standardized_errors.h"
 #include "../../include/utils/shared_utilities.h"
 #include "../../include/core/interpreter/value_operations.h"
+#include "../../include/runtime/reactor.h"
 #include <time.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -23,6 +24,7 @@ Value builtin_websocket_server_close(Interpreter* interpreter, Value* args, size
 Value builtin_websocket_set_auto_reconnect(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_websocket_set_ping_interval(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
 Value builtin_websocket_process_connections(Interpreter* interpreter, Value* args, size_t arg_count, int line, int column);
+static void websocket_reactor_forget(WebSocketConnection* conn);
 
 // Global server registry
 static WebSocketServer* g_servers = NULL;
@@ -842,6 +844,7 @@ void websocket_close(WebSocketConnection* conn) {
         send(conn->socket_fd, buffer, frame_len, 0);
     }
     
+    websocket_reactor_forget(conn);
     close(conn->socket_fd);
     conn->state = WS_STATE_CLOSED;
 }
@@ -857,6 +860,7 @@ void websocket_free_connection(WebSocketConnection* conn) {
     }
     
     if (conn->socket_fd >= 0) {
+        websocket_reactor_forget(conn);
         close(conn->socket_fd);
     }
     
@@ -1398,6 +1402,7 @@ bool websocket_attempt_reconnect(WebSocketConnection* conn) {
             SSL_free(conn->ssl);
             conn->ssl = NULL;
         }
+        websocket_reactor_forget(conn);
         close(conn->socket_fd);
         conn->socket_fd = -1;
     }
@@ -1533,6 +1538,42 @@ void websocket_set_non_blocking(WebSocketConnection* conn, bool enabled) {
     conn->non_blocking = enabled;
 }
 
+// Stop watching the socket; called before it is closed
+static void websocket_reactor_forget(WebSocketConnection* conn) {
+    if (conn->reactor_watched) {
+        reactor_unwatch(conn->socket_fd);
+        conn->reactor_watched = false;
+    }
+}
+
+// Tell the reactor what the connection waits on next: its socket while it
+// is open, and the time of the next keepalive ping or reconnect attempt
+static void websocket_reactor_update(WebSocketConnection* conn) {
+    uint64_t now_ms = reactor_now_ms();
+    time_t now = time(NULL);
+    
+    if (conn->state == WS_STATE_OPEN && conn->non_blocking && conn->socket_fd >= 0) {
+        conn->reactor_watched = reactor_watch(conn->socket_fd, REACTOR_READ);
+        // Records OpenSSL already decrypted never make the socket readable
+        if (conn->ssl && SSL_pending(conn->ssl) > 0) {
+            reactor_schedule(now_ms);
+        }
+        if (conn->ping_interval_seconds > 0) {
+            time_t next = conn->last_ping_time + conn->ping_interval_seconds;
+            reactor_schedule(now_ms + (next > now ? (uint64_t)(next - now) * 1000 : 0));
+        }
+        return;
+    }
+    
+    // Closed by the peer (or not ours to read): a readable EOF would wake the loop forever
+    websocket_reactor_forget(conn);
+    if (conn->state == WS_STATE_CLOSED && conn->auto_reconnect && conn->url &&
+        (conn->max_reconnect_attempts <= 0 || conn->reconnect_attempts < conn->max_reconnect_attempts)) {
+        time_t next = conn->last_reconnect_time + (conn->reconnect_delay_ms + 999) / 1000;
+        reactor_schedule(now_ms + (next > now ? (uint64_t)(next - now) * 1000 : 0));
+    }
+}
+
 void websocket_process_connections(Interpreter* interpreter) {
     if (!interpreter) return;
     
@@ -1577,19 +1618,22 @@ void websocket_process_connections(Interpreter* interpreter) {
                             conn->state = WS_STATE_CLOSED;
                             break;
                         } else {
-                            // Log other SSL errors
+                            // Log other SSL errors; the stream is unusable after them and a
+                            // socket left in the error state would keep waking the event loop
                             fprintf(stderr, "[WEBSOCKET] SSL_read error: %d (received=%zd)\n", ssl_error, received);
+                            conn->state = WS_STATE_CLOSED;
                             break;
                         }
                     }
                 } else {
                     received = recv(conn->socket_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
                     if (received < 0) {
-                        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
                             received = 0;  // No data available
                             break;
                         } else {
                             fprintf(stderr, "[WEBSOCKET] recv error: errno=%d\n", errno);
+                            conn->state = WS_STATE_CLOSED;
                             break;
                         }
                     } else if (received == 0) {
@@ -1918,6 +1962,7 @@ void websocket_process_connections(Interpreter* interpreter) {
             }  // End of while loop
         }
         
+        websocket_reactor_update(conn);
         conn = conn->next;
     }
 }
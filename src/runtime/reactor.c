@@ -0,0 +1,282 @@
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200809L  // clock_gettime/nanosleep under -std=c99
+#endif
+
+#include "../../include/runtime/reactor.h"
+#include "../../include/utils/shared_utilities.h"
+#include <pthread.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#else
+#include <sys/event.h>
+#endif
+
+// Readiness loop shared by the libraries the interpreter's event loop
+// drives. Level-triggered: a socket that still has data reports ready again
+// on the next wait, so callers just re-run their (non-blocking) processing.
+
+#define REACTOR_BATCH 64
+#define REACTOR_NO_DEADLINE UINT64_MAX
+
+// Without a working poller, waits degrade to sleeping this long at most
+#define REACTOR_FALLBACK_SLEEP_MS 100
+
+static pthread_once_t g_reactor_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_reactor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int g_reactor_fd = -1;              // epoll / kqueue descriptor
+#if defined(__linux__)
+static int g_reactor_wake_fd = -1;         // eventfd written by reactor_wake()
+static int g_reactor_timer_fd = -1;        // timerfd armed to the next deadline
+#else
+static int g_reactor_wake_fds[2] = {-1, -1};
+#endif
+static unsigned char* g_reactor_events = NULL;  // Watched REACTOR_* events by fd
+static size_t g_reactor_events_size = 0;
+static uint64_t g_reactor_deadline = REACTOR_NO_DEADLINE;
+static bool g_reactor_waiting = false;     // A thread is blocked in reactor_wait()
+static bool g_reactor_signalled = false;   // ...and has already been sent a wakeup
+static bool g_reactor_woken = false;       // Wakeup arrived while nobody was waiting
+
+uint64_t reactor_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+// ============================================================================
+// POLLER
+// ============================================================================
+
+static void reactor_init_once(void) {
+#if defined(__linux__)
+    g_reactor_fd = epoll_create1(EPOLL_CLOEXEC);
+    g_reactor_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    g_reactor_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    bool ok = g_reactor_fd >= 0 && g_reactor_wake_fd >= 0 && g_reactor_timer_fd >= 0;
+    if (ok) {
+        event.data.fd = g_reactor_wake_fd;
+        ok = epoll_ctl(g_reactor_fd, EPOLL_CTL_ADD, g_reactor_wake_fd, &event) == 0;
+    }
+    if (ok) {
+        event.data.fd = g_reactor_timer_fd;
+        ok = epoll_ctl(g_reactor_fd, EPOLL_CTL_ADD, g_reactor_timer_fd, &event) == 0;
+    }
+    if (!ok) {
+        if (g_reactor_fd >= 0) close(g_reactor_fd);
+        if (g_reactor_wake_fd >= 0) close(g_reactor_wake_fd);
+        if (g_reactor_timer_fd >= 0) close(g_reactor_timer_fd);
+        g_reactor_fd = g_reactor_wake_fd = g_reactor_timer_fd = -1;
+    }
+#else
+    g_reactor_fd = kqueue();
+    bool ok = g_reactor_fd >= 0 && pipe(g_reactor_wake_fds) == 0;
+    if (ok) {
+        fcntl(g_reactor_wake_fds[0], F_SETFL, fcntl(g_reactor_wake_fds[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(g_reactor_wake_fds[1], F_SETFL, fcntl(g_reactor_wake_fds[1], F_GETFL, 0) | O_NONBLOCK);
+        struct kevent change;
+        EV_SET(&change, g_reactor_wake_fds[0], EVFILT_READ, EV_ADD | EV_ENABLE, 0, 0, NULL);
+        ok = kevent(g_reactor_fd, &change, 1, NULL, 0, NULL) == 0;
+    }
+    if (!ok) {
+        if (g_reactor_fd >= 0) close(g_reactor_fd);
+        if (g_reactor_wake_fds[0] >= 0) close(g_reactor_wake_fds[0]);
+        if (g_reactor_wake_fds[1] >= 0) close(g_reactor_wake_fds[1]);
+        g_reactor_fd = g_reactor_wake_fds[0] = g_reactor_wake_fds[1] = -1;
+    }
+#endif
+}
+
+static bool reactor_init(void) {
+    pthread_once(&g_reactor_once, reactor_init_once);
+    return g_reactor_fd >= 0;
+}
+
+// Change the interest set of fd from old_events to new_events (0 = not watched)
+static int reactor_set(int fd, int old_events, int new_events) {
+#if defined(__linux__)
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = ((new_events & REACTOR_READ) ? EPOLLIN : 0) | ((new_events & REACTOR_WRITE) ? EPOLLOUT : 0);
+    event.data.fd = fd;
+    if (new_events == 0) return epoll_ctl(g_reactor_fd, EPOLL_CTL_DEL, fd, &event);
+    int result = epoll_ctl(g_reactor_fd, old_events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+    // A descriptor closed without being unwatched drops out of epoll on its
+    // own, and its number may come back registered or not
+    if (result < 0 && errno == ENOENT) return epoll_ctl(g_reactor_fd, EPOLL_CTL_ADD, fd, &event);
+    if (result < 0 && errno == EEXIST) return epoll_ctl(g_reactor_fd, EPOLL_CTL_MOD, fd, &event);
+    return result;
+#else
+    struct kevent changes[2];
+    int change_count = 0;
+    if ((old_events ^ new_events) & REACTOR_READ) {
+        EV_SET(&changes[change_count++], fd, EVFILT_READ,
+               (new_events & REACTOR_READ) ? EV_ADD | EV_ENABLE : EV_DELETE, 0, 0, NULL);
+    }
+    if ((old_events ^ new_events) & REACTOR_WRITE) {
+        EV_SET(&changes[change_count++], fd, EVFILT_WRITE,
+               (new_events & REACTOR_WRITE) ? EV_ADD | EV_ENABLE : EV_DELETE, 0, 0, NULL);
+    }
+    return kevent(g_reactor_fd, changes, change_count, NULL, 0, NULL);
+#endif
+}
+
+// Interrupt a blocked reactor_wait(); called with the mutex held
+static void reactor_signal_locked(void) {
+    if (!g_reactor_waiting || g_reactor_signalled) return;
+    g_reactor_signalled = true;
+#if defined(__linux__)
+    uint64_t one = 1;
+    ssize_t ignored = write(g_reactor_wake_fd, &one, sizeof(one));
+#else
+    char byte = 1;
+    ssize_t ignored = write(g_reactor_wake_fds[1], &byte, 1);
+#endif
+    (void)ignored;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool reactor_watch(int fd, int events) {
+    if (fd < 0 || !reactor_init()) return false;
+
+    bool ok = true;
+    pthread_mutex_lock(&g_reactor_mutex);
+    if ((size_t)fd >= g_reactor_events_size && events != 0) {
+        size_t size = g_reactor_events_size ? g_reactor_events_size : 64;
+        while (size <= (size_t)fd) size *= 2;
+        unsigned char* table = shared_realloc_safe(g_reactor_events, size, "reactor", "reactor_watch", 0);
+        if (table) {
+            memset(table + g_reactor_events_size, 0, size - g_reactor_events_size);
+            g_reactor_events = table;
+            g_reactor_events_size = size;
+        } else {
+            ok = false;
+        }
+    }
+    if (ok && (size_t)fd < g_reactor_events_size && g_reactor_events[fd] != events) {
+        // A failed removal means the descriptor is already gone
+        if (reactor_set(fd, g_reactor_events[fd], events) == 0 || events == 0) {
+            g_reactor_events[fd] = (unsigned char)events;
+        } else {
+            ok = false;
+        }
+    }
+    pthread_mutex_unlock(&g_reactor_mutex);
+    return ok;
+}
+
+void reactor_unwatch(int fd) {
+    reactor_watch(fd, 0);
+}
+
+void reactor_schedule(uint64_t deadline_ms) {
+    pthread_mutex_lock(&g_reactor_mutex);
+    if (deadline_ms < g_reactor_deadline) {
+        g_reactor_deadline = deadline_ms;
+        // A waiter re-arms its timer on the next pass
+        reactor_signal_locked();
+    }
+    pthread_mutex_unlock(&g_reactor_mutex);
+}
+
+void reactor_wake(void) {
+    if (!reactor_init()) return;
+    pthread_mutex_lock(&g_reactor_mutex);
+    if (g_reactor_waiting) {
+        reactor_signal_locked();
+    } else {
+        g_reactor_woken = true;
+    }
+    pthread_mutex_unlock(&g_reactor_mutex);
+}
+
+int reactor_wait(int timeout_ms) {
+    uint64_t now = reactor_now_ms();
+
+    pthread_mutex_lock(&g_reactor_mutex);
+    uint64_t deadline = g_reactor_deadline;
+    g_reactor_deadline = REACTOR_NO_DEADLINE;
+    if (timeout_ms >= 0 && now + (uint64_t)timeout_ms < deadline) {
+        deadline = now + (uint64_t)timeout_ms;
+    }
+    if (g_reactor_woken) deadline = now;
+    g_reactor_woken = false;
+    g_reactor_waiting = true;
+    pthread_mutex_unlock(&g_reactor_mutex);
+
+    int ready = 0;
+    if (!reactor_init()) {
+        uint64_t sleep_ms = deadline > now ? deadline - now : 0;
+        if (sleep_ms > REACTOR_FALLBACK_SLEEP_MS) sleep_ms = REACTOR_FALLBACK_SLEEP_MS;
+        struct timespec pause;
+        pause.tv_sec = (time_t)(sleep_ms / 1000);
+        pause.tv_nsec = (long)(sleep_ms % 1000) * 1000000L;
+        nanosleep(&pause, NULL);
+    } else {
+#if defined(__linux__)
+        // Sub-millisecond deadlines go through the timerfd; epoll_wait itself
+        // either polls or blocks indefinitely
+        struct itimerspec timer;
+        memset(&timer, 0, sizeof(timer));
+        int wait_ms = -1;
+        if (deadline <= now) {
+            wait_ms = 0;
+        } else if (deadline != REACTOR_NO_DEADLINE) {
+            timer.it_value.tv_sec = (time_t)(deadline / 1000);
+            timer.it_value.tv_nsec = (long)(deadline % 1000) * 1000000L;
+        }
+        timerfd_settime(g_reactor_timer_fd, TFD_TIMER_ABSTIME, &timer, NULL);
+
+        struct epoll_event events[REACTOR_BATCH];
+        int count = epoll_wait(g_reactor_fd, events, REACTOR_BATCH, wait_ms);
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if (fd == g_reactor_wake_fd || fd == g_reactor_timer_fd) {
+                uint64_t drained;
+                ssize_t ignored = read(fd, &drained, sizeof(drained));
+                (void)ignored;
+            } else {
+                ready++;
+            }
+        }
+        if (count < 0 && errno != EINTR) ready = -1;
+#else
+        struct kevent events[REACTOR_BATCH];
+        struct timespec timeout;
+        uint64_t wait_ms = deadline > now ? deadline - now : 0;
+        timeout.tv_sec = (time_t)(wait_ms / 1000);
+        timeout.tv_nsec = (long)(wait_ms % 1000) * 1000000L;
+        int count = kevent(g_reactor_fd, NULL, 0, events, REACTOR_BATCH,
+                           deadline == REACTOR_NO_DEADLINE ? NULL : &timeout);
+        for (int i = 0; i < count; i++) {
+            if ((int)events[i].ident == g_reactor_wake_fds[0]) {
+                char drained[64];
+                while (read(g_reactor_wake_fds[0], drained, sizeof(drained)) > 0) {
+                }
+            } else {
+                ready++;
+            }
+        }
+        if (count < 0 && errno != EINTR) ready = -1;
+#endif
+    }
+
+    pthread_mutex_lock(&g_reactor_mutex);
+    g_reactor_waiting = false;
+    g_reactor_signalled = false;
+    pthread_mutex_unlock(&g_reactor_mutex);
+    return ready;
+}
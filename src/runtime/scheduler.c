@@ -0,0 +1,408 @@
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200809L  // clock_gettime under -std=c99
+#endif
+
+#include "../../include/runtime/scheduler.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// The lock-free paths use the GCC/Clang __atomic builtins (the tree is C99,
+// so <stdatomic.h> is not available)
+
+#if defined(_MSC_VER)
+#define SCHEDULER_THREAD_LOCAL __declspec(thread)
+#else
+#define SCHEDULER_THREAD_LOCAL __thread
+#endif
+
+#define SCHEDULER_DEQUE_SIZE 1024   // Power of two; a full deque spills to the injection queue
+#define SCHEDULER_DEQUE_MASK (SCHEDULER_DEQUE_SIZE - 1)
+#define SCHEDULER_INJECT_BATCH 32   // Tasks moved from the injection queue per visit
+#define SCHEDULER_SPIN_ROUNDS 64    // Yields before an idle worker parks
+#define SCHEDULER_CACHE_LINE 64
+
+// ============================================================================
+// CHASE-LEV DEQUE
+// ============================================================================
+// Fixed-size variant of Chase & Lev's deque with the memory orderings from
+// Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+// The owner pushes and takes at the bottom; thieves CAS the top.
+
+typedef struct {
+    int64_t top;
+    char pad_top[SCHEDULER_CACHE_LINE - sizeof(int64_t)];
+    int64_t bottom;
+    char pad_bottom[SCHEDULER_CACHE_LINE - sizeof(int64_t)];
+    SchedulerTask* slots[SCHEDULER_DEQUE_SIZE];
+} SchedulerDeque;
+
+static bool deque_push(SchedulerDeque* deque, SchedulerTask* task) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    if (bottom - top >= SCHEDULER_DEQUE_SIZE) return false;
+    __atomic_store_n(&deque->slots[bottom & SCHEDULER_DEQUE_MASK], task, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static SchedulerTask* deque_take(SchedulerDeque* deque) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    SchedulerTask* task = __atomic_load_n(&deque->slots[bottom & SCHEDULER_DEQUE_MASK], __ATOMIC_RELAXED);
+    if (top == bottom) {
+        // Last task: race the thieves for it
+        if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            task = NULL;
+        }
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return task;
+}
+
+// NULL when empty or when another thief won the race
+static SchedulerTask* deque_steal(SchedulerDeque* deque) {
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom) return NULL;
+
+    SchedulerTask* task = __atomic_load_n(&deque->slots[top & SCHEDULER_DEQUE_MASK], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    return task;
+}
+
+// ============================================================================
+// INJECTION QUEUE
+// ============================================================================
+// Vyukov's intrusive MPSC queue: producers never block or retry. Workers
+// take turns as the single consumer through a try-lock; one that loses
+// the race goes stealing instead.
+
+typedef struct {
+    SchedulerTask* head;          // Producers swap themselves in here
+    char pad_head[SCHEDULER_CACHE_LINE - sizeof(SchedulerTask*)];
+    SchedulerTask* tail;          // Consumer end
+    int consumer_lock;
+    SchedulerTask stub;
+} SchedulerInjectQueue;
+
+static void inject_init(SchedulerInjectQueue* queue) {
+    queue->stub.next = NULL;
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
+    queue->consumer_lock = 0;
+}
+
+static void inject_push(SchedulerInjectQueue* queue, SchedulerTask* task) {
+    __atomic_store_n(&task->next, NULL, __ATOMIC_RELAXED);
+    SchedulerTask* prev = __atomic_exchange_n(&queue->head, task, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, task, __ATOMIC_RELEASE);
+}
+
+// Caller is the consumer. May miss a task whose producer is between its
+// two steps; that task shows up on a later call.
+static SchedulerTask* inject_pop(SchedulerInjectQueue* queue) {
+    SchedulerTask* tail = queue->tail;
+    SchedulerTask* next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    if (tail == &queue->stub) {
+        if (!next) return NULL;
+        queue->tail = next;
+        tail = next;
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    if (tail != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) return NULL;
+
+    // tail is the last real node: put the stub behind it so it can go
+    inject_push(queue, &queue->stub);
+    next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+// ============================================================================
+// SCHEDULER
+// ============================================================================
+
+typedef struct SchedulerWorker {
+    Scheduler* scheduler;
+    size_t index;
+    pthread_t thread;
+    uint32_t rng;                 // Victim selection
+    SchedulerWorkerStats stats;
+    SchedulerDeque deque;
+} SchedulerWorker;
+
+struct Scheduler {
+    SchedulerRunFn run;
+    void* context;
+    SchedulerInjectQueue inject;
+    SchedulerWorker* workers;
+    size_t worker_count;          // Slots allocated (stealing scans these)
+    size_t started;               // Threads actually running
+    size_t pending;               // Submitted, not yet started
+    int shutdown;
+    int sleepers;                 // Workers parked (or about to park)
+    unsigned int wake_epoch;      // Bumped under park_mutex by each notify
+    pthread_mutex_t park_mutex;
+    pthread_cond_t park_cond;
+};
+
+static SCHEDULER_THREAD_LOCAL SchedulerWorker* scheduler_current_worker = NULL;
+
+static uint64_t scheduler_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// Counters have one writer; plain increments published with relaxed stores
+static void scheduler_count(uint64_t* counter, uint64_t amount) {
+    __atomic_store_n(counter, *counter + amount, __ATOMIC_RELAXED);
+}
+
+// Wake one parked worker, if any. The fence pairs with the one in
+// scheduler_park so a parking worker either sees the new task or is woken.
+static void scheduler_notify(Scheduler* scheduler) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&scheduler->sleepers, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&scheduler->park_mutex);
+        __atomic_store_n(&scheduler->wake_epoch, scheduler->wake_epoch + 1, __ATOMIC_RELEASE);
+        pthread_cond_signal(&scheduler->park_cond);
+        pthread_mutex_unlock(&scheduler->park_mutex);
+    }
+}
+
+// Take one task from the injection queue. A worker also moves a batch
+// into its own (empty) deque, where idle workers can steal from it.
+static SchedulerTask* scheduler_take_injected(Scheduler* scheduler, SchedulerWorker* worker) {
+    if (__atomic_exchange_n(&scheduler->inject.consumer_lock, 1, __ATOMIC_ACQUIRE)) return NULL;
+
+    SchedulerTask* task = inject_pop(&scheduler->inject);
+    uint64_t moved = 0;
+    if (task && worker) {
+        while (moved + 1 < SCHEDULER_INJECT_BATCH) {
+            SchedulerTask* extra = inject_pop(&scheduler->inject);
+            if (!extra) break;
+            deque_push(&worker->deque, extra);  // Only called with an empty deque
+            moved++;
+        }
+    }
+    __atomic_store_n(&scheduler->inject.consumer_lock, 0, __ATOMIC_RELEASE);
+
+    if (task && worker) {
+        scheduler_count(&worker->stats.injected, moved + 1);
+        if (moved > 0) scheduler_notify(scheduler);
+    }
+    return task;
+}
+
+static SchedulerTask* scheduler_find_work(SchedulerWorker* worker) {
+    Scheduler* scheduler = worker->scheduler;
+    SchedulerTask* task = deque_take(&worker->deque);
+    if (task) return task;
+
+    task = scheduler_take_injected(scheduler, worker);
+    if (task) return task;
+
+    // Steal, starting from a random victim
+    uint32_t x = worker->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->rng = x;
+    size_t count = scheduler->worker_count;
+    for (size_t i = 0; i < count; i++) {
+        size_t victim = (x + i) % count;
+        if (victim == worker->index) continue;
+        task = deque_steal(&scheduler->workers[victim].deque);
+        if (task) {
+            scheduler_count(&worker->stats.steals, 1);
+            // The victim may have more; let another sleeper look
+            scheduler_notify(scheduler);
+            return task;
+        }
+    }
+    return NULL;
+}
+
+// The last look for work happens outside park_mutex, since finding a batch
+// or a steal notifies (and this worker already counts as a sleeper). A
+// notify between that look and the wait moves wake_epoch, so it is not lost.
+static SchedulerTask* scheduler_park(SchedulerWorker* worker) {
+    Scheduler* scheduler = worker->scheduler;
+    __atomic_add_fetch(&scheduler->sleepers, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    unsigned int epoch = __atomic_load_n(&scheduler->wake_epoch, __ATOMIC_ACQUIRE);
+    SchedulerTask* task = scheduler_find_work(worker);
+    if (!task) {
+        pthread_mutex_lock(&scheduler->park_mutex);
+        while (scheduler->wake_epoch == epoch && !__atomic_load_n(&scheduler->shutdown, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&scheduler->park_cond, &scheduler->park_mutex);
+        }
+        pthread_mutex_unlock(&scheduler->park_mutex);
+    }
+    __atomic_sub_fetch(&scheduler->sleepers, 1, __ATOMIC_SEQ_CST);
+    return task;
+}
+
+static void scheduler_run_task(Scheduler* scheduler, SchedulerTask* task) {
+    __atomic_sub_fetch(&scheduler->pending, 1, __ATOMIC_ACQ_REL);
+    scheduler->run(scheduler->context, task);
+}
+
+static void* scheduler_worker_main(void* arg) {
+    SchedulerWorker* worker = (SchedulerWorker*)arg;
+    Scheduler* scheduler = worker->scheduler;
+    scheduler_current_worker = worker;
+
+    while (!__atomic_load_n(&scheduler->shutdown, __ATOMIC_ACQUIRE)) {
+        SchedulerTask* task = scheduler_find_work(worker);
+        if (!task) {
+            uint64_t idle_start = scheduler_now_ns();
+            for (int spin = 0; !task && spin < SCHEDULER_SPIN_ROUNDS; spin++) {
+                sched_yield();
+                task = scheduler_find_work(worker);
+            }
+            if (!task) task = scheduler_park(worker);
+            scheduler_count(&worker->stats.idle_ns, scheduler_now_ns() - idle_start);
+            if (!task) continue;
+        }
+        scheduler_run_task(scheduler, task);
+        scheduler_count(&worker->stats.tasks_run, 1);
+    }
+
+    scheduler_current_worker = NULL;
+    return NULL;
+}
+
+Scheduler* scheduler_create(SchedulerRunFn run, void* context) {
+    if (!run) return NULL;
+    Scheduler* scheduler = calloc(1, sizeof(Scheduler));
+    if (!scheduler) return NULL;
+    scheduler->run = run;
+    scheduler->context = context;
+    inject_init(&scheduler->inject);
+    pthread_mutex_init(&scheduler->park_mutex, NULL);
+    pthread_cond_init(&scheduler->park_cond, NULL);
+    return scheduler;
+}
+
+size_t scheduler_start(Scheduler* scheduler, size_t worker_count) {
+    if (!scheduler || scheduler->workers || worker_count == 0) {
+        return scheduler ? scheduler->started : 0;
+    }
+
+    // Every slot is ready before any thread can scan them for stealing
+    SchedulerWorker* workers = calloc(worker_count, sizeof(SchedulerWorker));
+    if (!workers) return 0;
+    for (size_t i = 0; i < worker_count; i++) {
+        workers[i].scheduler = scheduler;
+        workers[i].index = i;
+        workers[i].rng = (uint32_t)(i * 2654435761u) | 1u;
+    }
+    scheduler->workers = workers;
+    scheduler->worker_count = worker_count;
+
+    for (size_t i = 0; i < worker_count; i++) {
+        if (pthread_create(&workers[i].thread, NULL, scheduler_worker_main, &workers[i]) != 0) {
+            break;
+        }
+        scheduler->started++;
+    }
+    return scheduler->started;
+}
+
+size_t scheduler_worker_count(const Scheduler* scheduler) {
+    return scheduler ? scheduler->started : 0;
+}
+
+void scheduler_submit(Scheduler* scheduler, SchedulerTask* task) {
+    if (!scheduler || !task) return;
+    __atomic_add_fetch(&scheduler->pending, 1, __ATOMIC_ACQ_REL);
+
+    // Tasks spawned by a running task stay on that worker's deque
+    SchedulerWorker* worker = scheduler_current_worker;
+    if (!worker || worker->scheduler != scheduler || !deque_push(&worker->deque, task)) {
+        inject_push(&scheduler->inject, task);
+    }
+    scheduler_notify(scheduler);
+}
+
+size_t scheduler_pending(const Scheduler* scheduler) {
+    return scheduler ? __atomic_load_n(&scheduler->pending, __ATOMIC_ACQUIRE) : 0;
+}
+
+size_t scheduler_run_here(Scheduler* scheduler) {
+    if (!scheduler) return 0;
+    size_t ran = 0;
+    SchedulerTask* task;
+    while ((task = scheduler_take_injected(scheduler, NULL)) != NULL) {
+        scheduler_run_task(scheduler, task);
+        ran++;
+    }
+    return ran;
+}
+
+bool scheduler_worker_stats(const Scheduler* scheduler, size_t worker, SchedulerWorkerStats* stats) {
+    if (!scheduler || !stats || worker >= scheduler->started) return false;
+    const SchedulerWorkerStats* source = &scheduler->workers[worker].stats;
+    stats->tasks_run = __atomic_load_n(&source->tasks_run, __ATOMIC_RELAXED);
+    stats->steals = __atomic_load_n(&source->steals, __ATOMIC_RELAXED);
+    stats->injected = __atomic_load_n(&source->injected, __ATOMIC_RELAXED);
+    stats->idle_ns = __atomic_load_n(&source->idle_ns, __ATOMIC_RELAXED);
+    return true;
+}
+
+SchedulerTask* scheduler_destroy(Scheduler* scheduler) {
+    if (!scheduler) return NULL;
+
+    // Parking re-checks shutdown under the mutex, so the broadcast can't be missed
+    __atomic_store_n(&scheduler->shutdown, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&scheduler->park_mutex);
+    pthread_cond_broadcast(&scheduler->park_cond);
+    pthread_mutex_unlock(&scheduler->park_mutex);
+    for (size_t i = 0; i < scheduler->started; i++) {
+        pthread_join(scheduler->workers[i].thread, NULL);
+    }
+
+    // Hand back whatever never ran
+    SchedulerTask* leftover = NULL;
+    SchedulerTask* task;
+    for (size_t i = 0; i < scheduler->worker_count; i++) {
+        while ((task = deque_take(&scheduler->workers[i].deque)) != NULL) {
+            task->next = leftover;
+            leftover = task;
+        }
+    }
+    while ((task = inject_pop(&scheduler->inject)) != NULL) {
+        task->next = leftover;
+        leftover = task;
+    }
+
+    pthread_mutex_destroy(&scheduler->park_mutex);
+    pthread_cond_destroy(&scheduler->park_cond);
+    free(scheduler->workers);
+    free(scheduler);
+    return leftover;
+}
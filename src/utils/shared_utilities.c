@@ -39,6 +39,16 @@ static MemoryStats memory_stats[MAX_MEMORY_TRACKING];
 static int memory_stats_count = 0;
 static bool memory_tracking_enabled = false;
 
+// Allocator mode. The release path is a thin wrapper over the C allocator;
+// the per-allocation registry, canaries and component/function attribution
+// are only maintained in debug mode (--debug-alloc, or builds compiled with
+// -DMYCO_DEBUG_ALLOC). The mode must be chosen before the first allocation.
+#ifdef MYCO_DEBUG_ALLOC
+static bool alloc_debug_enabled = true;
+#else
+static bool alloc_debug_enabled = false;
+#endif
+
 // Lightweight allocation registry to avoid freeing non-heap pointers
 #define MYCO_MAX_TRACKED_PTRS 1000000  // Increased for large programs like pass.myco
 static const uint64_t MYCO_CANARY_MAGIC = 0xC0FFEEBADC0DEULL;
@@ -53,6 +63,14 @@ static int myco_tracked_capacity = 0;
 // Forward declaration
 static int myco_find_tracked_index(void* ptr);
 
+void shared_alloc_set_debug(bool enable) {
+    alloc_debug_enabled = enable;
+}
+
+bool shared_alloc_is_debug(void) {
+    return alloc_debug_enabled;
+}
+
 // Get current memory tracking stats
 size_t shared_get_tracked_allocation_count(void) {
     return myco_tracked_count;
@@ -327,19 +345,22 @@ void shared_error_report_code(const char* component, const char* function,
     fprintf(stderr, "\n");
 }
 
-void* shared_malloc_safe(size_t size, const char* component, const char* function, int line) {
-    // Aggressive safety checks
+static bool shared_alloc_size_ok(size_t size, const char* component, const char* function, int line) {
     if (size == 0) {
         shared_error_report(component, function, "Attempted to allocate 0 bytes", line, 0);
-        return NULL;
+        return false;
     }
     
     // Check for suspiciously large allocations
     if (size > 1024 * 1024 * 1024) { // 1GB limit
         shared_error_report(component, function, "Suspiciously large allocation requested", line, 0);
-        return NULL;
+        return false;
     }
-    
+    return true;
+}
+
+// Debug allocation: trailing canary plus registry entry with attribution
+static void* shared_malloc_debug(size_t size, const char* component, const char* function, int line) {
     // Verify existing allocations before requesting new memory
     // Skip canary verification to prevent stack overflow
     // (canary verification itself can trigger allocations during initialization)
@@ -359,10 +380,6 @@ void* shared_malloc_safe(size_t size, const char* component, const char* functio
     uint64_t* footer = (uint64_t*)((unsigned char*)ptr + size);
     *footer = MYCO_CANARY_MAGIC;
     
-    // Debug logging for large allocations (disabled for performance)
-    // if (size > 1024) {
-    // }
-    
     myco_track_alloc_with_info(ptr, component, function);
     // Store size for overflow checks
     if (myco_tracked_count > 0) {
@@ -375,23 +392,61 @@ void* shared_malloc_safe(size_t size, const char* component, const char* functio
     return ptr;
 }
 
+void* shared_malloc_safe(size_t size, const char* component, const char* function, int line) {
+    if (!shared_alloc_size_ok(size, component, function, line)) {
+        return NULL;
+    }
+    if (alloc_debug_enabled) {
+        return shared_malloc_debug(size, component, function, line);
+    }
+    
+    void* ptr = malloc(size);
+    if (!ptr) {
+        shared_error_report(component, function, "Memory allocation failed", line, 0);
+    }
+    return ptr;
+}
+
 void* shared_realloc_safe(void* ptr, size_t size, const char* component, const char* function, int line) {
     if (size == 0) {
         shared_free_safe(ptr, component, function, line);
         return NULL;
     }
-    // Simplify: allocate new with canary and copy
+    if (!alloc_debug_enabled) {
+        if (!shared_alloc_size_ok(size, component, function, line)) {
+            return NULL;
+        }
+        // Grows and shrinks in place whenever the C allocator can
+        void* new_ptr = realloc(ptr, size);
+        if (!new_ptr) {
+            shared_error_report(component, function, "Memory reallocation failed", line, 0);
+        }
+        return new_ptr;
+    }
+    
+    // Debug mode: allocate new with canary and copy so every block keeps
+    // its footer and registry entry
+    int idx = myco_find_tracked_index(ptr);
+    if (ptr && idx < 0) {
+        // Not ours (allocated before debug mode or by plain malloc): the old
+        // size is unknown, so let the C allocator carry the contents over
+        void* new_ptr = realloc(ptr, size);
+        if (!new_ptr) {
+            shared_error_report(component, function, "Memory reallocation failed", line, 0);
+        }
+        return new_ptr;
+    }
     void* new_ptr = shared_malloc_safe(size, component, function, line);
     if (!new_ptr) {
         shared_error_report(component, function, "Memory reallocation failed", line, 0);
         return NULL;
     }
-    // Copy old contents up to min(old_size, size)
-    int idx = myco_find_tracked_index(ptr);
+    // Copy old contents up to min(old_size, size); appending the new entry
+    // leaves idx valid
     if (idx >= 0) {
         size_t old_sz = myco_tracked_sizes[idx];
         size_t copy_sz = old_sz < size ? old_sz : size;
-        if (ptr && new_ptr && copy_sz > 0) {
+        if (copy_sz > 0) {
             memcpy(new_ptr, ptr, copy_sz);
         }
         // Untrack and free the old buffer
@@ -434,6 +489,12 @@ void shared_free_safe(void* ptr, const char* component, const char* function, in
         return;
     }
     
+    // Release mode follows the same conservative policy as debug mode below
+    // (blocks are never handed back), just without the registry lookup
+    if (!alloc_debug_enabled) {
+        return;
+    }
+    
     if (shared_config_get_component_debug(component)) {
         shared_debug_printf(component, function, "Freeing memory at %p", ptr);
     }